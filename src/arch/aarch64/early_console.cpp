@@ -45,3 +45,17 @@ extern "C" auto etl_putchar(int c) -> void {
     pl011_uart->PutChar(c);
   }
 }
+
+/**
+ * @brief 早期控制台整块输出
+ * @param buf 数据缓冲区
+ * @param len 字节数
+ */
+extern "C" auto console_write(const char* buf, size_t len) -> void {
+  if (!pl011_uart) {
+    return;
+  }
+  for (size_t i = 0; i < len; ++i) {
+    pl011_uart->PutChar(buf[i]);
+  }
+}
@@ -0,0 +1,90 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include <cpu_io.h>
+
+#include <cstdint>
+
+#include "arch.h"
+
+namespace {
+
+/// CPACR_EL1.FPEN 位域偏移
+static constexpr uint64_t kCpacrFpenShift = 20;
+/// FPEN = 0b11: EL0 与 EL1 访问 FP/SIMD 均不陷入
+static constexpr uint64_t kCpacrFpenNoTrap = 0b11ULL << kCpacrFpenShift;
+
+}  // namespace
+
+auto FpuInit() -> void {
+  uint64_t cpacr;
+  __asm__ volatile("mrs %0, cpacr_el1" : "=r"(cpacr));
+  cpacr |= kCpacrFpenNoTrap;
+  __asm__ volatile("msr cpacr_el1, %0\n\tisb" : : "r"(cpacr) : "memory");
+}
+
+// TrapContext 在每次陷入时已保存/恢复 q0-q31，用户态浮点状态随内核栈
+// 保存，不需要惰性切换
+auto FpuEnable() -> void {}
+
+auto FpuDisable() -> void {}
+
+// 内核使用 -mgeneral-regs-only 编译，编译器不会分配 FP/SIMD 寄存器，
+// 因此内联汇编不声明 q 寄存器的破坏
+auto FpuSave(FpuState* state) -> void {
+  __asm__ volatile(
+      "stp q0, q1, [%0, #0]\n\t"
+      "stp q2, q3, [%0, #32]\n\t"
+      "stp q4, q5, [%0, #64]\n\t"
+      "stp q6, q7, [%0, #96]\n\t"
+      "stp q8, q9, [%0, #128]\n\t"
+      "stp q10, q11, [%0, #160]\n\t"
+      "stp q12, q13, [%0, #192]\n\t"
+      "stp q14, q15, [%0, #224]\n\t"
+      "stp q16, q17, [%0, #256]\n\t"
+      "stp q18, q19, [%0, #288]\n\t"
+      "stp q20, q21, [%0, #320]\n\t"
+      "stp q22, q23, [%0, #352]\n\t"
+      "stp q24, q25, [%0, #384]\n\t"
+      "stp q26, q27, [%0, #416]\n\t"
+      "stp q28, q29, [%0, #448]\n\t"
+      "stp q30, q31, [%0, #480]\n\t"
+      "mrs x9, fpsr\n\t"
+      "mrs x10, fpcr\n\t"
+      "stp x9, x10, [%0, #512]"
+      :
+      : "r"(state->data.data())
+      : "x9", "x10", "memory");
+}
+
+auto FpuRestore(const FpuState* state) -> void {
+  __asm__ volatile(
+      "ldp q0, q1, [%0, #0]\n\t"
+      "ldp q2, q3, [%0, #32]\n\t"
+      "ldp q4, q5, [%0, #64]\n\t"
+      "ldp q6, q7, [%0, #96]\n\t"
+      "ldp q8, q9, [%0, #128]\n\t"
+      "ldp q10, q11, [%0, #160]\n\t"
+      "ldp q12, q13, [%0, #192]\n\t"
+      "ldp q14, q15, [%0, #224]\n\t"
+      "ldp q16, q17, [%0, #256]\n\t"
+      "ldp q18, q19, [%0, #288]\n\t"
+      "ldp q20, q21, [%0, #320]\n\t"
+      "ldp q22, q23, [%0, #352]\n\t"
+      "ldp q24, q25, [%0, #384]\n\t"
+      "ldp q26, q27, [%0, #416]\n\t"
+      "ldp q28, q29, [%0, #448]\n\t"
+      "ldp q30, q31, [%0, #480]\n\t"
+      "ldp x9, x10, [%0, #512]\n\t"
+      "msr fpsr, x9\n\t"
+      "msr fpcr, x10"
+      :
+      : "r"(state->data.data())
+      : "x9", "x10", "memory");
+}
+
+auto FpuInitState(FpuState* state) -> void {
+  // 寄存器清零，fpcr 为 0 表示就近舍入且不产生浮点异常陷入
+  *state = {};
+}
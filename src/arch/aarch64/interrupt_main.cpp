@@ -13,6 +13,8 @@
 #include "kstd_cstdio"
 #include "pl011/pl011_driver.hpp"
 #include "pl011_singleton.h"
+#include "task_manager.hpp"
+#include "user_access.hpp"
 
 using InterruptDelegate = InterruptBase::InterruptDelegate;
 namespace {
@@ -81,6 +83,17 @@ extern "C" auto error_current_el_sp0_handler(cpu_io::TrapContext* context)
 /// 同步异常处理 - Current EL with SPx
 extern "C" auto sync_current_el_spx_handler(cpu_io::TrapContext* context)
     -> void {
+  // 内核访问用户内存时缺页 (同级数据异常)，跳转到修复代码返回错误
+  static constexpr uint64_t kEsrEcShift = 26;
+  static constexpr uint64_t kEsrEcMask = 0x3F;
+  static constexpr uint64_t kEcDataAbortSameEl = 0x25;
+  if (((context->esr_el1 >> kEsrEcShift) & kEsrEcMask) == kEcDataAbortSameEl) {
+    auto fixup = SearchExceptionTable(context->elr_el1);
+    if (fixup != 0) {
+      context->elr_el1 = fixup;
+      return;
+    }
+  }
   HandleException("Sync Exception at Current EL with SPx", context, 4);
 }
 
@@ -172,6 +185,22 @@ auto uart_handler(uint64_t cause, cpu_io::TrapContext*) -> uint64_t {
   return cause;
 }
 
+/**
+ * @brief IPI (SGI 0) 中断处理函数
+ * @param cause 中断号
+ * @return 中断号
+ */
+auto ipi_handler(uint64_t cause, cpu_io::TrapContext*) -> uint64_t {
+  klog::Debug("Core {} received IPI", cpu_io::GetCurrentCoreId());
+  // 迁出被修改亲和性的任务
+  TaskManagerSingleton::instance().HandleMigrateIpi();
+  return cause;
+}
+
+auto SendIpi(uint64_t target_cpu_mask) -> Expected<void> {
+  return InterruptSingleton::instance().SendIpi(target_cpu_mask);
+}
+
 auto InterruptInit(int, const char**) -> void {
   InterruptSingleton::create();
 
@@ -192,16 +221,28 @@ auto InterruptInit(int, const char**) -> void {
         return std::unexpected(err);
       });
 
+  // SGI 0 用于 IPI
+  InterruptSingleton::instance().RegisterInterruptFunc(
+      Gic::kSgiBase, InterruptDelegate::create<ipi_handler>());
+
+  FpuInit();
+
   cpu_io::EnableInterrupt();
 
   klog::Info("Hello InterruptInit");
 }
 
+auto DeviceInterruptInit() -> void {
+  // virtio-blk/virtio-net 中断尚未接入，块设备请求与网络接收通过轮询完成
+}
+
 auto InterruptInitSMP(int, const char**) -> void {
   cpu_io::VBAR_EL1::Write(reinterpret_cast<uint64_t>(vector_table));
 
   InterruptSingleton::instance().SetUp();
 
+  FpuInit();
+
   cpu_io::EnableInterrupt();
 
   klog::Info("Hello InterruptInitSMP");
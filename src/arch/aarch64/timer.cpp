@@ -67,3 +67,20 @@ auto TimerInit() -> void {
   cpu_io::CNTV_CTL_EL0::ENABLE::Set();
   cpu_io::CNTV_CTL_EL0::IMASK::Clear();
 }
+
+auto ReadTimestamp() -> uint64_t {
+  uint64_t count = 0;
+  __asm__ volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(count)::"memory");
+  return count;
+}
+
+auto VdsoArchInit(size_t core_id) -> void {
+  // CNTKCTL_EL1.EL0VCTEN: 允许 EL0 读取 CNTVCT_EL0
+  static constexpr uint64_t kEl0Vcten = 1ULL << 1;
+  uint64_t cntkctl = 0;
+  __asm__ volatile("mrs %0, cntkctl_el1" : "=r"(cntkctl));
+  __asm__ volatile("msr cntkctl_el1, %0" ::"r"(cntkctl | kEl0Vcten));
+  // TPIDRRO_EL0 对 EL0 只读，存放核心 ID
+  __asm__ volatile("msr tpidrro_el0, %0" ::"r"(static_cast<uint64_t>(core_id)));
+  __asm__ volatile("isb" ::: "memory");
+}
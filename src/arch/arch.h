@@ -7,9 +7,12 @@
 #include <cpu_io.h>
 #include <sys/cdefs.h>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 
+#include "expected.hpp"
+
 // 在 switch.S 中定义
 extern "C" auto switch_to(cpu_io::CalleeSavedContext* prev,
                           cpu_io::CalleeSavedContext* next) -> void;
@@ -20,9 +23,22 @@ extern "C" auto kernel_thread_entry() -> void;
 // 在 switch.S 中定义
 extern "C" auto trap_return(void*) -> void;
 
+// 在 schedule.cpp 中定义，新任务首次运行时由 kernel_thread_entry 调用
+extern "C" auto finish_task_switch() -> void;
+
 // 在 interrupt.S 中定义
 extern "C" auto trap_entry() -> void;
 
+/**
+ * @brief 在内核与用户内存之间拷贝，访存缺页时经异常修复表返回
+ * @param dst 目的地址
+ * @param src 源地址
+ * @param len 字节数
+ * @return size_t 未拷贝的字节数，缺页时非 0
+ * @note 在 user_copy.S 中定义，应通过 CopyFromUser/CopyToUser 使用
+ */
+extern "C" auto copy_user(void* dst, const void* src, size_t len) -> size_t;
+
 /**
  * @brief 体系结构相关初始化
  * @param argc 在不同体系结构有不同含义，同 _start
@@ -63,6 +79,20 @@ auto InterruptInit(int argc, const char** argv) -> void;
  * @post 从核的中断控制器已初始化
  */
 auto InterruptInitSMP(int argc, const char** argv) -> void;
+/**
+ * @brief 注册已探测设备的中断
+ * @pre InterruptInit 与 DeviceInit 已完成
+ * @post 设备中断处理函数已注册，未接入中断的设备继续轮询
+ */
+auto DeviceInterruptInit() -> void;
+/**
+ * @brief 向目标核心发送核间中断
+ * @param target_cpu_mask 目标核心掩码 (bit i 对应核心 i)
+ * @return Expected<void> 当前架构不支持或发送失败时返回错误
+ * @pre InterruptInit 已完成
+ */
+[[nodiscard]] auto SendIpi(uint64_t target_cpu_mask) -> Expected<void>;
+
 /**
  * @brief 初始化定时器
  * @pre InterruptInit 已完成
@@ -75,6 +105,21 @@ auto TimerInit() -> void;
  * @post 从核的定时器中断已启用
  */
 auto TimerInitSMP() -> void;
+/**
+ * @brief 读取当前核心单调递增的硬件计数器
+ * @return uint64_t 计数值，频率取决于架构 (x86_64: TSC，
+ * riscv64: time CSR，aarch64: CNTVCT_EL0)，仅用于比较同一核心上的耗时
+ */
+[[nodiscard]] auto ReadTimestamp() -> uint64_t;
+
+/**
+ * @brief 允许用户态读取硬件计数器与当前核心 ID (供 vDSO 使用)
+ * @param core_id 当前核心 ID
+ * @post x86_64: TSC_AUX 为核心 ID，用户态通过 rdtscp 获取；
+ * aarch64: 开放 CNTVCT_EL0，TPIDRRO_EL0 为核心 ID；
+ * riscv64: 开放 time CSR，没有用户可读的核心 ID 寄存器
+ */
+auto VdsoArchInit(size_t core_id) -> void;
 
 /**
  * @brief 初始化内核线程的任务上下文（重载1）
@@ -101,6 +146,63 @@ auto InitTaskContext(cpu_io::CalleeSavedContext* task_context,
                      cpu_io::TrapContext* trap_context_ptr, uint64_t stack_top)
     -> void;
 
+/// FPU/SIMD 状态保存区大小，取各架构的最大值
+/// x86_64: FXSAVE 区域 512 字节
+/// aarch64: q0-q31 (512 字节) + fpsr/fpcr (16 字节)
+/// riscv64: f0-f31 (256 字节) + fcsr (8 字节)
+inline constexpr size_t kFpuStateSize = 528;
+
+/**
+ * @brief FPU/SIMD 寄存器保存区
+ * @note FXSAVE/FXRSTOR 要求 16 字节对齐
+ */
+struct alignas(16) FpuState {
+  std::array<uint8_t, kFpuStateSize> data{};
+};
+
+/**
+ * @brief 初始化当前核心的 FPU/SIMD 单元
+ * @pre 中断控制器已初始化
+ * @post FPU 可用，x86_64 上首次使用会触发 #NM 以便惰性恢复
+ * @note 惰性切换只在 x86_64 上实现。aarch64/riscv64 的 TrapContext
+ *       （由 cpu_io 定义）每次陷入都保存全部浮点寄存器，FPU 始终启用；
+ *       riscv64 内核以硬浮点 ABI 编译，不能关闭 sstatus.FS。
+ *       riscv64 不管理向量状态，sstatus.VS 保持 Off，向量指令陷入
+ */
+auto FpuInit() -> void;
+
+/**
+ * @brief 允许使用 FPU/SIMD 指令，不再触发陷入
+ * @note 仅 x86_64 有效，aarch64/riscv64 上为空操作
+ */
+auto FpuEnable() -> void;
+
+/**
+ * @brief 禁止使用 FPU/SIMD 指令，下一次使用时陷入内核
+ * @note 仅 x86_64 有效，aarch64/riscv64 上为空操作，见 FpuInit
+ */
+auto FpuDisable() -> void;
+
+/**
+ * @brief 保存当前 FPU/SIMD 寄存器
+ * @param state 保存区
+ * @pre FPU 已启用
+ */
+auto FpuSave(FpuState* state) -> void;
+
+/**
+ * @brief 从保存区恢复 FPU/SIMD 寄存器
+ * @param state 保存区
+ * @pre FPU 已启用
+ */
+auto FpuRestore(const FpuState* state) -> void;
+
+/**
+ * @brief 将保存区设置为 FPU/SIMD 的初始状态 (寄存器清零，控制字为默认值)
+ * @param state 保存区
+ */
+auto FpuInitState(FpuState* state) -> void;
+
 /// 最多回溯 128 层调用栈
 static constexpr size_t kMaxFrameCount = 128;
 
@@ -4,5 +4,22 @@
 
 #include <opensbi_interface.h>
 
+#include <cstddef>
+#include <cstdint>
+
 /// 早期控制台输出单字符，通过 SBI 调用实现
 extern "C" auto etl_putchar(int c) -> void { sbi_debug_console_write_byte(c); }
+
+/// 整块输出，通过一次 SBI DBCN 调用写出整个缓冲区
+extern "C" auto console_write(const char* buf, size_t len) -> void {
+  // 内核恒等映射，虚拟地址即物理地址
+  auto addr = reinterpret_cast<uintptr_t>(buf);
+  auto ret = sbi_debug_console_write(len, addr, 0);
+  if (ret.error == 0) {
+    return;
+  }
+  // 固件不支持 DBCN 整块输出时逐字节输出
+  for (size_t i = 0; i < len; ++i) {
+    sbi_debug_console_write_byte(buf[i]);
+  }
+}
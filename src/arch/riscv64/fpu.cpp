@@ -0,0 +1,122 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include <cpu_io.h>
+
+#include <cstdint>
+
+#include "arch.h"
+
+namespace {
+
+/// sstatus.FS = Initial，允许 S 模式与 U 模式使用浮点指令
+static constexpr uint64_t kSstatusFsInitial = 1ULL << 13;
+/// sstatus.VS 位域，Off 时向量指令触发非法指令异常
+static constexpr uint64_t kSstatusVsMask = 0b11ULL << 9;
+
+}  // namespace
+
+auto FpuInit() -> void {
+  __asm__ volatile("csrs sstatus, %0" : : "r"(kSstatusFsInitial) : "memory");
+  // 向量寄存器不在 TrapContext 与 FpuState 中，保持 VS = Off，
+  // 避免任务之间泄漏或破坏向量状态
+  __asm__ volatile("csrc sstatus, %0" : : "r"(kSstatusVsMask) : "memory");
+}
+
+// TrapContext 在每次陷入时已保存/恢复 f0-f31 与 fcsr，用户态浮点状态随内核栈
+// 保存。内核以硬浮点 ABI 编译，可能使用浮点寄存器，不能关闭 FS 做惰性切换
+auto FpuEnable() -> void {}
+
+auto FpuDisable() -> void {}
+
+// 内核代码不使用浮点寄存器 (switch_to 会保存 fs0-fs11)，
+// 因此内联汇编不声明 f 寄存器的破坏
+auto FpuSave(FpuState* state) -> void {
+  uint64_t fcsr;
+  __asm__ volatile(
+      "fsd f0, 0(%1)\n\t"
+      "fsd f1, 8(%1)\n\t"
+      "fsd f2, 16(%1)\n\t"
+      "fsd f3, 24(%1)\n\t"
+      "fsd f4, 32(%1)\n\t"
+      "fsd f5, 40(%1)\n\t"
+      "fsd f6, 48(%1)\n\t"
+      "fsd f7, 56(%1)\n\t"
+      "fsd f8, 64(%1)\n\t"
+      "fsd f9, 72(%1)\n\t"
+      "fsd f10, 80(%1)\n\t"
+      "fsd f11, 88(%1)\n\t"
+      "fsd f12, 96(%1)\n\t"
+      "fsd f13, 104(%1)\n\t"
+      "fsd f14, 112(%1)\n\t"
+      "fsd f15, 120(%1)\n\t"
+      "fsd f16, 128(%1)\n\t"
+      "fsd f17, 136(%1)\n\t"
+      "fsd f18, 144(%1)\n\t"
+      "fsd f19, 152(%1)\n\t"
+      "fsd f20, 160(%1)\n\t"
+      "fsd f21, 168(%1)\n\t"
+      "fsd f22, 176(%1)\n\t"
+      "fsd f23, 184(%1)\n\t"
+      "fsd f24, 192(%1)\n\t"
+      "fsd f25, 200(%1)\n\t"
+      "fsd f26, 208(%1)\n\t"
+      "fsd f27, 216(%1)\n\t"
+      "fsd f28, 224(%1)\n\t"
+      "fsd f29, 232(%1)\n\t"
+      "fsd f30, 240(%1)\n\t"
+      "fsd f31, 248(%1)\n\t"
+      "frcsr %0\n\t"
+      "sd %0, 256(%1)"
+      : "=&r"(fcsr)
+      : "r"(state->data.data())
+      : "memory");
+}
+
+auto FpuRestore(const FpuState* state) -> void {
+  uint64_t fcsr;
+  __asm__ volatile(
+      "ld %0, 256(%1)\n\t"
+      "fscsr %0\n\t"
+      "fld f0, 0(%1)\n\t"
+      "fld f1, 8(%1)\n\t"
+      "fld f2, 16(%1)\n\t"
+      "fld f3, 24(%1)\n\t"
+      "fld f4, 32(%1)\n\t"
+      "fld f5, 40(%1)\n\t"
+      "fld f6, 48(%1)\n\t"
+      "fld f7, 56(%1)\n\t"
+      "fld f8, 64(%1)\n\t"
+      "fld f9, 72(%1)\n\t"
+      "fld f10, 80(%1)\n\t"
+      "fld f11, 88(%1)\n\t"
+      "fld f12, 96(%1)\n\t"
+      "fld f13, 104(%1)\n\t"
+      "fld f14, 112(%1)\n\t"
+      "fld f15, 120(%1)\n\t"
+      "fld f16, 128(%1)\n\t"
+      "fld f17, 136(%1)\n\t"
+      "fld f18, 144(%1)\n\t"
+      "fld f19, 152(%1)\n\t"
+      "fld f20, 160(%1)\n\t"
+      "fld f21, 168(%1)\n\t"
+      "fld f22, 176(%1)\n\t"
+      "fld f23, 184(%1)\n\t"
+      "fld f24, 192(%1)\n\t"
+      "fld f25, 200(%1)\n\t"
+      "fld f26, 208(%1)\n\t"
+      "fld f27, 216(%1)\n\t"
+      "fld f28, 224(%1)\n\t"
+      "fld f29, 232(%1)\n\t"
+      "fld f30, 240(%1)\n\t"
+      "fld f31, 248(%1)"
+      : "=&r"(fcsr)
+      : "r"(state->data.data())
+      : "memory");
+}
+
+auto FpuInitState(FpuState* state) -> void {
+  // 寄存器清零，fcsr 为 0 表示就近舍入且没有累积异常
+  *state = {};
+}
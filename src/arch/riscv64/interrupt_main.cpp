@@ -15,6 +15,7 @@
 #include "ns16550a/ns16550a.hpp"
 #include "syscall.hpp"
 #include "task_manager.hpp"
+#include "user_access.hpp"
 #include "virtio/virtio_driver.hpp"
 #include "virtual_memory.hpp"
 
@@ -52,6 +53,17 @@ auto EbreakHandler(uint64_t exception_code, cpu_io::TrapContext* context)
 
 auto PageFaultHandler(uint64_t exception_code, cpu_io::TrapContext* context)
     -> uint64_t {
+  // 内核在 copy_user 中访问用户内存时缺页，跳转到修复代码返回错误。
+  // 只处理 S 模式 (sstatus.SPP = 1) 的缺页，用户态的 pc 不能命中修复表
+  static constexpr uint64_t kSstatusSpp = 1ULL << 8;
+  if ((context->sstatus & kSstatusSpp) != 0) {
+    auto fixup = SearchExceptionTable(context->sepc);
+    if (fixup != 0) {
+      context->sepc = fixup;
+      return 0;
+    }
+  }
+
   auto addr = cpu_io::Stval::Read();
   klog::Err("PageFault: {}({:#x}), addr: {:#x}",
             cpu_io::ScauseInfo::kExceptionNames[exception_code], exception_code,
@@ -77,6 +89,8 @@ auto IpiHandler(uint64_t /*cause*/, cpu_io::TrapContext* /*context*/)
   // 清软中断 pending 位
   cpu_io::Sip::Ssip::Clear();
   klog::Debug("Core {} received IPI", cpu_io::GetCurrentCoreId());
+  // 迁出被修改亲和性的任务
+  TaskManagerSingleton::instance().HandleMigrateIpi();
   return 0;
 }
 
@@ -93,12 +107,14 @@ auto SerialIrqHandler(uint64_t /*cause*/, cpu_io::TrapContext* /*context*/)
 // VirtIO-blk 外部中断处理
 auto VirtioBlkIrqHandler(uint64_t /*cause*/, cpu_io::TrapContext* /*context*/)
     -> uint64_t {
-  VirtioDriverSingleton::instance().HandleInterrupt(
-      [](void* /*token*/, ErrorCode status) {
-        if (status != ErrorCode::kSuccess) {
-          klog::Err("VirtIO blk IO error: {}", static_cast<int>(status));
-        }
-      });
+  VirtioDriverSingleton::instance().HandleBlkCompletions();
+  return 0;
+}
+
+// VirtIO-net 外部中断处理：只唤醒接收轮询任务
+auto VirtioNetIrqHandler(uint64_t /*cause*/, cpu_io::TrapContext* /*context*/)
+    -> uint64_t {
+  VirtioDriverSingleton::instance().HandleNetInterrupt();
   return 0;
 }
 
@@ -152,6 +168,10 @@ extern "C" auto HandleTrap(cpu_io::TrapContext* context)
   return context;
 }
 
+auto SendIpi(uint64_t target_cpu_mask) -> Expected<void> {
+  return InterruptSingleton::instance().SendIpi(target_cpu_mask);
+}
+
 auto InterruptInit(int, const char**) -> void {
   InterruptSingleton::create();
 
@@ -171,6 +191,9 @@ auto InterruptInit(int, const char**) -> void {
     klog::Err("Failed to set trap vector");
   }
 
+  // trap_entry 会保存浮点寄存器，开启中断前需要启用 FPU
+  FpuInit();
+
   // 开启 Supervisor 中断
   cpu_io::Sstatus::Sie::Set();
 
@@ -191,14 +214,22 @@ auto InterruptInit(int, const char**) -> void {
         return std::unexpected(err);
       });
 
-  // 通过统一接口注册 virtio-blk 外部中断
-  auto& blk_driver = VirtioDriverSingleton::instance();
-  auto blk_irq = blk_driver.GetIrq();
+  klog::Info("Hello InterruptInit");
+}
+
+auto DeviceInterruptInit() -> void {
+  // 通过统一接口注册 virtio-blk/virtio-net 外部中断，中断号在设备探测后才可用
+  auto& virtio_driver = VirtioDriverSingleton::instance();
+  auto blk_irq = virtio_driver.GetIrq();
   if (blk_irq != 0) {
     InterruptSingleton::instance()
         .RegisterExternalInterrupt(
             blk_irq, cpu_io::GetCurrentCoreId(), 1,
             InterruptDelegate::create<VirtioBlkIrqHandler>())
+        .and_then([&virtio_driver]() -> Expected<void> {
+          virtio_driver.EnableBlkIrq();
+          return {};
+        })
         .or_else([blk_irq](Error err) -> Expected<void> {
           klog::Err("Failed to register virtio-blk IRQ {}: {}", blk_irq,
                     err.message());
@@ -206,7 +237,22 @@ auto InterruptInit(int, const char**) -> void {
         });
   }
 
-  klog::Info("Hello InterruptInit");
+  auto net_irq = virtio_driver.GetNetIrq();
+  if (net_irq != 0) {
+    InterruptSingleton::instance()
+        .RegisterExternalInterrupt(
+            net_irq, cpu_io::GetCurrentCoreId(), 1,
+            InterruptDelegate::create<VirtioNetIrqHandler>())
+        .and_then([&virtio_driver]() -> Expected<void> {
+          virtio_driver.EnableNetIrq();
+          return {};
+        })
+        .or_else([net_irq](Error err) -> Expected<void> {
+          klog::Err("Failed to register virtio-net IRQ {}: {}", net_irq,
+                    err.message());
+          return std::unexpected(err);
+        });
+  }
 }
 
 auto InterruptInitSMP(int, const char**) -> void {
@@ -217,6 +263,9 @@ auto InterruptInitSMP(int, const char**) -> void {
     klog::Err("Failed to set trap vector");
   }
 
+  // trap_entry 会保存浮点寄存器，开启中断前需要启用 FPU
+  FpuInit();
+
   // 开启 Supervisor 中断
   cpu_io::Sstatus::Sie::Set();
 
@@ -46,3 +46,11 @@ auto TimerInit() -> void {
   // 设置初次时钟中断时间
   sbi_set_timer(interval);
 }
+
+auto ReadTimestamp() -> uint64_t { return cpu_io::Time::Read(); }
+
+auto VdsoArchInit(size_t /*core_id*/) -> void {
+  // scounteren.TM: 允许 U 模式读取 time CSR
+  static constexpr uint64_t kScounterenTm = 1ULL << 1;
+  __asm__ volatile("csrs scounteren, %0" ::"r"(kScounterenTm) : "memory");
+}
@@ -28,3 +28,12 @@ extern "C" auto etl_putchar(int c) -> void {
     serial->Write(c);
   }
 }
+
+extern "C" auto console_write(const char* buf, size_t len) -> void {
+  if (!serial) {
+    return;
+  }
+  for (size_t i = 0; i < len; ++i) {
+    serial->Write(buf[i]);
+  }
+}
@@ -0,0 +1,80 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include <cpu_io.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "arch.h"
+
+namespace {
+
+/// CR0.MP: 配合 TS 使 WAIT/FWAIT 也触发 #NM
+static constexpr uint64_t kCr0Mp = 1ULL << 1;
+/// CR0.EM: 置位时 x87 指令触发 #UD
+static constexpr uint64_t kCr0Em = 1ULL << 2;
+/// CR0.TS: 置位时 FPU/SSE 指令触发 #NM
+static constexpr uint64_t kCr0Ts = 1ULL << 3;
+/// CR4.OSFXSR: 启用 FXSAVE/FXRSTOR 与 SSE 指令
+static constexpr uint64_t kCr4Osfxsr = 1ULL << 9;
+/// CR4.OSXMMEXCPT: 启用 SIMD 浮点异常 (#XM)
+static constexpr uint64_t kCr4Osxmmexcpt = 1ULL << 10;
+
+/// FXSAVE 区域中 FCW 的偏移
+static constexpr size_t kFxsaveFcwOffset = 0;
+/// FXSAVE 区域中 MXCSR 的偏移
+static constexpr size_t kFxsaveMxcsrOffset = 24;
+/// FNINIT 后的 x87 控制字 (屏蔽所有异常，64 位精度)
+static constexpr uint16_t kDefaultFcw = 0x037F;
+/// 复位后的 MXCSR (屏蔽所有 SIMD 浮点异常)
+static constexpr uint32_t kDefaultMxcsr = 0x1F80;
+
+auto ReadCr0() -> uint64_t {
+  uint64_t value;
+  __asm__ volatile("mov %%cr0, %0" : "=r"(value));
+  return value;
+}
+
+auto WriteCr0(uint64_t value) -> void {
+  __asm__ volatile("mov %0, %%cr0" : : "r"(value) : "memory");
+}
+
+auto ReadCr4() -> uint64_t {
+  uint64_t value;
+  __asm__ volatile("mov %%cr4, %0" : "=r"(value));
+  return value;
+}
+
+auto WriteCr4(uint64_t value) -> void {
+  __asm__ volatile("mov %0, %%cr4" : : "r"(value) : "memory");
+}
+
+}  // namespace
+
+auto FpuInit() -> void {
+  WriteCr4(ReadCr4() | kCr4Osfxsr | kCr4Osxmmexcpt);
+  // 首次使用时触发 #NM，由 TaskManager::HandleFpuTrap 恢复任务的状态
+  WriteCr0((ReadCr0() & ~kCr0Em) | kCr0Mp | kCr0Ts);
+}
+
+auto FpuEnable() -> void { __asm__ volatile("clts" : : : "memory"); }
+
+auto FpuDisable() -> void { WriteCr0(ReadCr0() | kCr0Ts); }
+
+auto FpuSave(FpuState* state) -> void {
+  __asm__ volatile("fxsave64 %0" : "=m"(*state) : : "memory");
+}
+
+auto FpuRestore(const FpuState* state) -> void {
+  __asm__ volatile("fxrstor64 %0" : : "m"(*state) : "memory");
+}
+
+auto FpuInitState(FpuState* state) -> void {
+  *state = {};
+  std::memcpy(state->data.data() + kFxsaveFcwOffset, &kDefaultFcw,
+              sizeof(kDefaultFcw));
+  std::memcpy(state->data.data() + kFxsaveMxcsrOffset, &kDefaultMxcsr,
+              sizeof(kDefaultMxcsr));
+}
@@ -10,6 +10,7 @@
 #include "kernel.h"
 #include "kernel_log.hpp"
 #include "kstd_cstdio"
+#include "task_manager.hpp"
 
 namespace {
 using InterruptDelegate = InterruptBase::InterruptDelegate;
@@ -77,8 +78,28 @@ auto KeyboardHandler(uint64_t cause, cpu_io::TrapContext* context) -> uint64_t {
   return 0;
 }
 
+/// #NM (Device Not Available) 异常向量号
+static constexpr uint8_t kDeviceNotAvailableVector{7};
+
+/**
+ * @brief #NM 异常处理函数，CR0.TS 置位时使用 FPU/SSE 指令触发
+ * @param cause 中断原因
+ * @param context 中断上下文
+ * @return uint64_t 返回值
+ */
+auto DeviceNotAvailableHandler(uint64_t cause, cpu_io::TrapContext*)
+    -> uint64_t {
+  // 惰性恢复当前任务的 FPU 状态
+  TaskManagerSingleton::instance().HandleFpuTrap();
+  return cause;
+}
+
 }  // namespace
 
+auto SendIpi(uint64_t target_cpu_mask) -> Expected<void> {
+  return InterruptSingleton::instance().SendIpi(target_cpu_mask);
+}
+
 auto InterruptInit(int, const char**) -> void {
   InterruptSingleton::create();
 
@@ -96,6 +117,12 @@ auto InterruptInit(int, const char**) -> void {
 
   InterruptSingleton::instance().SetUpIdtr();
 
+  // 注册 #NM 处理函数并初始化 FPU，用于惰性切换 FPU 状态
+  InterruptSingleton::instance().RegisterInterruptFunc(
+      kDeviceNotAvailableVector,
+      InterruptDelegate::create<DeviceNotAvailableHandler>());
+  FpuInit();
+
   // 注册 APIC Timer 中断处理函数（Local APIC 内部中断，不走 IO APIC）
   InterruptSingleton::instance().RegisterInterruptFunc(
       kApicTimerVector, InterruptDelegate::create<ApicTimerHandler>());
@@ -120,8 +147,13 @@ auto InterruptInit(int, const char**) -> void {
   klog::Info("Hello InterruptInit");
 }
 
+auto DeviceInterruptInit() -> void {
+  // virtio-blk/virtio-net 中断尚未接入，块设备请求与网络接收通过轮询完成
+}
+
 auto InterruptInitSMP(int, const char**) -> void {
   InterruptSingleton::instance().SetUpIdtr();
+  FpuInit();
 
   // 初始化当前 AP 核的 Local APIC
   InterruptSingleton::instance().apic().InitCurrentCpuLocalApic().or_else(
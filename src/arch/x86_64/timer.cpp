@@ -11,3 +11,18 @@
 auto TimerInitSMP() -> void {}
 
 auto TimerInit() -> void {}
+
+auto ReadTimestamp() -> uint64_t {
+  uint32_t low = 0;
+  uint32_t high = 0;
+  __asm__ volatile("rdtsc" : "=a"(low), "=d"(high));
+  return (static_cast<uint64_t>(high) << 32) | low;
+}
+
+auto VdsoArchInit(size_t core_id) -> void {
+  // rdtscp 在 ecx 中返回 TSC_AUX，用户态据此获取核心 ID
+  static constexpr uint32_t kMsrTscAux = 0xC0000103;
+  __asm__ volatile("wrmsr" ::"c"(kMsrTscAux),
+                   "a"(static_cast<uint32_t>(core_id)), "d"(0U)
+                   : "memory");
+}
@@ -57,3 +57,11 @@ auto DeviceInit() -> void {
 
   klog::Info("DeviceInit: complete");
 }
+
+auto DeviceStartTasks() -> void {
+  auto& virtio_driver = VirtioDriverSingleton::instance();
+  if (auto r = virtio_driver.StartNetPoll(); !r) {
+    klog::Err("DeviceStartTasks: virtio-net poll task failed: {}",
+              r.error().message());
+  }
+}
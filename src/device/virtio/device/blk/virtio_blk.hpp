@@ -6,9 +6,12 @@
 
 #include <cpu_io.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <type_traits>
 #include <utility>
 
@@ -19,6 +22,7 @@
 #include "virtio/device/blk/virtio_blk_defs.h"
 #include "virtio/device/device_initializer.hpp"
 #include "virtio/transport/mmio.hpp"
+#include "virtio/virt_queue/packed.hpp"
 #include "virtio/virt_queue/split.hpp"
 
 namespace virtio::blk {
@@ -31,17 +35,18 @@ namespace virtio::blk {
  *
  * 该类封装了 VirtIO 块设备的完整生命周期：
  * - 传输层的创建和管理（通过 TransportT 模板参数泛化）
- * - Virtqueue 的创建和管理（通过 VirtqueueT 模板参数泛化）
+ * - Virtqueue 的创建和管理（通过 VirtqueueT 模板参数泛化），协商了
+ *   VIRTIO_BLK_F_MQ 时每个队列拥有独立的请求槽池，可由不同核心并发使用
  * - 设备初始化序列（特性协商、队列配置、设备激活）
  * - 异步 IO 接口（Enqueue/Kick/HandleInterrupt 回调模型）
- * - 同步读写便捷方法（基于异步接口实现）
+ * - 按请求大小统计完成延迟，可选的混合轮询（先轮询、后等待中断）
  *
- * 用户只需提供 MMIO 基地址和 DMA 缓冲区，
- * 即可通过 Read() / Write() 或异步接口进行块设备操作。
+ * 用户只需提供 MMIO 基地址和 DMA 缓冲区，即可通过异步接口进行块设备
+ * 操作；需要等待完成的调用者经 VirtioBlkVfsAdapter 睡眠等待中断唤醒。
  *
  * @tparam TransportT 传输层类型（默认 MmioTransport）
- * @tparam VirtqueueT Virtqueue 类型（默认 SplitVirtqueue）
- * @tparam VirtqueueT Virtqueue 模板（默认 SplitVirtqueue）
+ * @tparam VirtqueueT Virtqueue 类型（SplitVirtqueue 或 PackedVirtqueue，
+ *         默认 SplitVirtqueue）
  * @see virtio-v1.2#5.2 Block Device
  * @see 架构文档 §3
  */
@@ -52,12 +57,28 @@ class VirtioBlk {
   /// 异步 IO 回调中使用的用户自定义上下文指针类型
   using UserData = void*;
 
-  /// 每个设备的最大并发(in-flight)请求数
+  /// 读取单调递增时间戳的函数类型
+  using TimestampFunc = auto (*)() -> uint64_t;
+
+  /// 每个队列的最大并发(in-flight)请求数
   static constexpr uint16_t kMaxInflight = 64;
 
+  /// 最大队列数
+  static constexpr uint16_t kMaxQueues = 8;
+
   /// 每个 Scatter-Gather 请求的最大 IoVec 数量（含请求头和状态字节）
   static constexpr size_t kMaxSgElements = 18;
 
+  /**
+   * @brief 使用间接描述符时每个请求的最大 IoVec 数量（每个请求槽一张表）
+   *
+   * 间接表内嵌在请求槽的 DMA 内存中，因此是固定上限而不是按设备的
+   * seg_max + 2 分配：64 项让每个槽占 1 KiB，每个队列 kMaxInflight 个槽。
+   * 设备的 seg_max 更大时单个请求最多携带 62 个数据段，超出部分由
+   * 上层（VirtioBlkVfsAdapter）拆成多个请求。
+   */
+  static constexpr size_t kMaxIndirectDescs = 64;
+
   /**
    * @brief 获取多队列所需的总 DMA 内存大小
    *
@@ -71,10 +92,7 @@ class VirtioBlk {
   [[nodiscard]] static constexpr auto GetRequiredVqMemSize(uint16_t queue_count,
                                                            uint32_t queue_size)
       -> std::pair<size_t, size_t> {
-    // 始终按 event_idx=true 分配，因为特性协商在分配之后
-    size_t per_queue =
-        VirtqueueT::CalcSize(static_cast<uint16_t>(queue_size), true);
-    return {per_queue * queue_count, 4096};
+    return {PerQueueVqMemSize(queue_size) * queue_count, kQueueAlign};
   }
 
   /**
@@ -92,11 +110,13 @@ class VirtioBlk {
   /**
    * @brief 计算 RequestSlot DMA 内存所需字节数
    *
+   * @param queue_count 请求的队列数量
    * @return pair.first = 总字节数，pair.second = 对齐要求（字节）
    */
-  [[nodiscard]] static constexpr auto GetRequiredSlotMemSize()
-      -> std::pair<size_t, size_t> {
-    return {sizeof(RequestSlot) * kMaxInflight, alignof(RequestSlot)};
+  [[nodiscard]] static constexpr auto GetRequiredSlotMemSize(
+      uint16_t queue_count = 1) -> std::pair<size_t, size_t> {
+    return {sizeof(RequestSlot) * kMaxInflight * queue_count,
+            alignof(RequestSlot)};
   }
 
   /**
@@ -109,11 +129,13 @@ class VirtioBlk {
    *
    * @param mmio_base MMIO 设备基地址
    * @param vq_dma 预分配的 Virtqueue DMA 内存区域
-   *        （页对齐，已清零，大小 >= GetRequiredVqMemSize()）
+   *        （页对齐，已清零，大小 >= GetRequiredVqMemSize(queue_count)）
    * @param slot_dma 预分配的 RequestSlot DMA 内存区域
-   *        （大小 >= GetRequiredSlotMemSize()）
+   *        （大小 >= GetRequiredSlotMemSize(queue_count)）
    * @param virt_to_phys 虚拟地址到物理地址转换函数（默认恒等映射）
-   * @param queue_count 期望的队列数量（当前仅支持 1）
+   * @param queue_count 期望的队列数量，大于 1 时协商 VIRTIO_BLK_F_MQ，
+   *        实际数量不超过设备的 num_queues 和 kMaxQueues，见
+   *        GetQueueCount()
    * @param queue_size 每个队列的描述符数量（2 的幂，默认 128）
    * @param driver_features 额外的驱动特性位（VERSION_1 自动包含）
    * @return 成功返回 VirtioBlk 实例，失败返回错误
@@ -127,8 +149,6 @@ class VirtioBlk {
     if (queue_count == 0) {
       return std::unexpected(Error{ErrorCode::kInvalidArgument});
     }
-    if (queue_count > 1) {
-    }
 
     // 1. 创建传输层
     TransportT transport(mmio_base);
@@ -141,7 +161,13 @@ class VirtioBlk {
 
     uint64_t wanted_features =
         static_cast<uint64_t>(ReservedFeature::kVersion1) |
-        static_cast<uint64_t>(ReservedFeature::kEventIdx) | driver_features;
+        static_cast<uint64_t>(ReservedFeature::kEventIdx) |
+        static_cast<uint64_t>(ReservedFeature::kIndirectDesc) |
+        static_cast<uint64_t>(BlkFeatureBit::kFlush) |
+        VirtqueueT::kRingFeatures | driver_features;
+    if (queue_count > 1) {
+      wanted_features |= static_cast<uint64_t>(BlkFeatureBit::kMq);
+    }
     auto negotiated_result = initializer.Init(wanted_features);
     if (!negotiated_result) {
       return std::unexpected(negotiated_result.error());
@@ -151,33 +177,62 @@ class VirtioBlk {
     if ((negotiated & static_cast<uint64_t>(ReservedFeature::kVersion1)) == 0) {
       return std::unexpected(Error{ErrorCode::kFeatureNegotiationFailed});
     }
+    // 队列布局由 VirtqueueT 决定，设备必须支持
+    constexpr auto kRingPacked =
+        static_cast<uint64_t>(ReservedFeature::kRingPacked);
+    if ((negotiated & kRingPacked) !=
+        (VirtqueueT::kRingFeatures & kRingPacked)) {
+      return std::unexpected(Error{ErrorCode::kFeatureNegotiationFailed});
+    }
 
     // 根据协商结果决定是否启用 Event Index
     bool event_idx =
         (negotiated & static_cast<uint64_t>(ReservedFeature::kEventIdx)) != 0;
-    if (event_idx) {
+
+    // 协商了 MQ 时由设备给出可用的队列数
+    uint16_t queues = 1;
+    if (queue_count > 1 &&
+        (negotiated & static_cast<uint64_t>(BlkFeatureBit::kMq)) != 0) {
+      uint16_t num_queues = transport.ReadConfigU16(
+          static_cast<uint32_t>(BlkConfigOffset::kNumQueues));
+      queues = std::max<uint16_t>(
+          1, std::min({queue_count, num_queues, kMaxQueues}));
     }
-    // 3. 创建 Virtqueue
-    VirtqueueT vq(vq_dma, static_cast<uint16_t>(queue_size), event_idx);
-    if (!vq.IsValid()) {
+    if (slot_dma.size < GetRequiredSlotMemSize(queues).first) {
       return std::unexpected(Error{ErrorCode::kInvalidArgument});
     }
 
-    // 4. 配置队列
-    const uint32_t queue_idx = 0;
-    auto setup_result = initializer.SetupQueue(
-        queue_idx, vq.DescPhys(), vq.AvailPhys(), vq.UsedPhys(), vq.Size());
-    if (!setup_result) {
-      return std::unexpected(setup_result.error());
+    // 3. 创建并配置 Virtqueue
+    // 队列按页对齐排列，每个队列只需 CalcDmaSize() 字节
+    size_t per_queue = PerQueueVqMemSize(queue_size);
+    std::array<std::optional<VirtqueueT>, kMaxQueues> vqs;
+    for (uint16_t i = 0; i < queues; ++i) {
+      auto region = vq_dma.SubRegion(
+          i * per_queue, CalcDmaSize(static_cast<uint16_t>(queue_size)));
+      if (!region) {
+        return std::unexpected(region.error());
+      }
+      auto& vq = EmplaceVirtqueue(vqs[i], *region,
+                                  static_cast<uint16_t>(queue_size), event_idx,
+                                  negotiated);
+      if (!vq.IsValid()) {
+        return std::unexpected(Error{ErrorCode::kInvalidArgument});
+      }
+
+      auto setup_result = initializer.SetupQueue(
+          i, vq.DescPhys(), vq.AvailPhys(), vq.UsedPhys(), vq.Size());
+      if (!setup_result) {
+        return std::unexpected(setup_result.error());
+      }
     }
 
-    // 5. 激活设备
+    // 4. 激活设备
     auto activate_result = initializer.Activate();
     if (!activate_result) {
       return std::unexpected(activate_result.error());
     }
 
-    return VirtioBlk(std::move(transport), std::move(vq), negotiated, slot_dma,
+    return VirtioBlk(std::move(transport), vqs, queues, negotiated, slot_dma,
                      virt_to_phys);
   }
 
@@ -189,7 +244,7 @@ class VirtioBlk {
    * 构建 virtio-blk 请求描述符链（header + data buffers + status），
    * 提交到 Available Ring，但不通知设备。调用者需随后调用 Kick() 通知。
    *
-   * @param queue_index 队列索引（当前仅支持 0）
+   * @param queue_index 队列索引（小于 GetQueueCount()）
    * @param sector 起始扇区号（以 512 字节为单位）
    * @param buffers 数据缓冲区 IoVec 数组（物理地址 + 长度）
    * @param buffer_count buffers 数组中的元素数量
@@ -213,7 +268,7 @@ class VirtioBlk {
    * 针对 Write 操作，数据缓冲区的描述符 flag 为设备只读（无
    * VRING_DESC_F_WRITE）。
    *
-   * @param queue_index 队列索引（当前仅支持 0）
+   * @param queue_index 队列索引（小于 GetQueueCount()）
    * @param sector 起始扇区号（以 512 字节为单位）
    * @param buffers 数据缓冲区 IoVec 数组（物理地址 + 长度）
    * @param buffer_count buffers 数组中的元素数量
@@ -228,46 +283,60 @@ class VirtioBlk {
                      token);
   }
 
+  /**
+   * @brief 异步提交缓存刷新请求（仅入队描述符，不触发硬件通知）
+   *
+   * 设备完成该请求时，此前已完成的写请求均已落到持久介质。请求只有
+   * 请求头与状态字节两个描述符。
+   *
+   * @param queue_index 队列索引（小于 GetQueueCount()）
+   * @param token 用户自定义上下文指针，在 HandleInterrupt 回调时原样传回
+   * @return 成功或失败；未协商 VIRTIO_BLK_F_FLUSH 时返回 kNotSupported
+   * @see virtio-v1.2#5.2.6.2 Driver Requirements: Device Operation
+   */
+  [[nodiscard]] auto EnqueueFlush(uint16_t queue_index,
+                                  UserData token = nullptr) -> Expected<void> {
+    if (!HasFlush()) {
+      return std::unexpected(Error{ErrorCode::kNotSupported});
+    }
+    return DoEnqueue(ReqType::kFlush, queue_index, 0, nullptr, 0, token);
+  }
+
+  /**
+   * @brief 设备是否有需要刷新的写缓存 (协商了 VIRTIO_BLK_F_FLUSH)
+   * @return 未协商时设备为直写，写请求完成即已持久化
+   */
+  [[nodiscard]] auto HasFlush() const -> bool {
+    return (negotiated_features_ &
+            static_cast<uint64_t>(BlkFeatureBit::kFlush)) != 0;
+  }
+
   /**
    * @brief 批量触发硬件通知
    *
    * 通知设备 Available Ring 中有新的待处理请求。
    * 调用者应在 EnqueueRead/EnqueueWrite 后调用此方法。
    *
-   * @param queue_index 队列索引（当前仅支持 0）
+   * @param queue_index 队列索引（小于 GetQueueCount()）
    * @see virtio-v1.2#2.7.13 Supplying Buffers to The Device
    */
   auto Kick(uint16_t queue_index) -> void {
-    if (queue_index != 0) {
+    if (queue_index >= queue_count_) {
       return;
     }
-    // 写屏障：确保 Available Ring 更新对设备可见
-    cpu_io::Wmb();
-
-    if (vq_.EventIdxEnabled()) {
-      auto* avail_event_ptr = vq_.UsedAvailEvent();
-      if (avail_event_ptr != nullptr) {
-        uint16_t avail_event = *avail_event_ptr;
-        uint16_t new_idx = vq_.AvailIdx();
-        if (VringNeedEvent(avail_event, new_idx, old_avail_idx_)) {
-          transport_.NotifyQueue(queue_index);
-        } else {
-          stats_.kicks_elided++;
-        }
-        old_avail_idx_ = new_idx;
-      } else {
-        transport_.NotifyQueue(queue_index);
-      }
-    } else {
+    auto& queue = *queues_[queue_index];
+    if (queue.vq.KickPrepare()) {
       transport_.NotifyQueue(queue_index);
+    } else {
+      queue.stats.kicks_elided++;
     }
   }
 
   /**
    * @brief 中断处理（带完成回调）
    *
-   * 在 ISR 或轮询循环中调用。确认设备中断，遍历 Used Ring 中已完成的请求，
-   * 对每个请求调用 on_complete 回调，释放描述符链和请求槽。
+   * 在 ISR 或轮询循环中调用。确认设备中断，遍历所有队列 Used Ring 中
+   * 已完成的请求，对每个请求调用 on_complete 回调，释放描述符链和请求槽。
    *
    * @tparam CompletionCallback 签名要求：void(UserData token, ErrorCode status)
    *         - token: 提交时传入的用户上下文指针
@@ -277,78 +346,234 @@ class VirtioBlk {
    */
   template <typename CompletionCallback>
   auto HandleInterrupt(CompletionCallback&& on_complete) -> void {
-    // 确认中断
+    AckInterrupt();
+    for (uint16_t i = 0; i < queue_count_; ++i) {
+      ProcessQueue(i, on_complete);
+    }
+  }
+
+  /**
+   * @brief 确认设备中断
+   *
+   * 多队列时调用者可先确认中断，再分别持有各队列的锁调用 ProcessQueue()。
+   *
+   * @note 此方法可在中断上下文中安全调用（ISR-safe）
+   * @see virtio-v1.2#4.2.2 MMIO Device Register Layout (InterruptACK)
+   */
+  auto AckInterrupt() -> void {
     uint32_t isr_status = transport_.GetInterruptStatus();
     if (isr_status != 0) {
       transport_.AckInterrupt(isr_status);
     }
-    stats_.interrupts_handled++;
+    interrupts_handled_.fetch_add(1, std::memory_order_relaxed);
+  }
 
-    ProcessCompletions(static_cast<CompletionCallback&&>(on_complete));
-    UpdateUsedEvent();
+  /**
+   * @brief 处理一个队列中已完成的请求
+   *
+   * 不确认设备中断。不同队列可由不同核心并发处理，同一队列的入队与
+   * 处理需由调用者互斥。
+   *
+   * @tparam CompletionCallback 同 HandleInterrupt
+   * @param queue_index 队列索引（小于 GetQueueCount()）
+   * @param on_complete 完成回调函数
+   */
+  template <typename CompletionCallback>
+  auto ProcessQueue(uint16_t queue_index, CompletionCallback&& on_complete)
+      -> void {
+    if (queue_index >= queue_count_) {
+      return;
+    }
+    auto& queue = *queues_[queue_index];
+    ProcessCompletions(queue, static_cast<CompletionCallback&&>(on_complete));
+    UpdateUsedEvent(queue);
   }
 
   /**
-   * @brief 中断处理（简化版，无回调）
+   * @brief 获取实际使用的队列数量
    *
-   * 仅确认设备中断并设置完成标志，供同步轮询使用。
-   * 不处理 Used Ring 和描述符回收。
+   * @return 队列数，未协商 VIRTIO_BLK_F_MQ 时为 1
+   */
+  [[nodiscard]] auto GetQueueCount() const -> uint16_t { return queue_count_; }
+
+  /**
+   * @brief 获取空闲请求槽数量
    *
-   * @note 此方法可在中断上下文中安全调用（ISR-safe）
-   * @see virtio-v1.2#2.3 Notifications
+   * @param queue_index 队列索引
+   * @return 该队列还可同时提交的请求数
    */
-  auto HandleInterrupt() -> void {
-    uint32_t status = transport_.GetInterruptStatus();
-    if (status != 0) {
-      transport_.AckInterrupt(status);
+  [[nodiscard]] auto GetFreeSlotCount(uint16_t queue_index = 0) const
+      -> uint16_t {
+    return static_cast<uint16_t>(
+        kMaxInflight - __builtin_popcountll(queues_[queue_index]->slot_bitmap));
+  }
+
+  /**
+   * @brief 获取空闲描述符数量
+   *
+   * @param queue_index 队列索引
+   * @return 该队列中未被占用的描述符数
+   */
+  [[nodiscard]] auto GetFreeDescCount(uint16_t queue_index = 0) const
+      -> uint16_t {
+    return queues_[queue_index]->vq.NumFree();
+  }
+
+  /**
+   * @brief 将缓冲区的虚拟地址转换为 DMA 地址
+   *
+   * @param virt 虚拟地址
+   * @return 创建设备时提供的转换函数的结果
+   */
+  [[nodiscard]] auto VirtToPhys(uintptr_t virt) const -> uintptr_t {
+    return virt_to_phys_(virt);
+  }
+
+  /**
+   * @brief 获取单个请求可携带的最大 IoVec 数量
+   *
+   * 协商了 VIRTIO_F_INDIRECT_DESC 时请求的 IoVec 写入请求槽中的间接表，
+   * 只占用一个环描述符，上限为 kMaxIndirectDescs 与队列大小中的较小者
+   * （规范要求间接表项数不超过队列大小）；否则为 kMaxSgElements。
+   *
+   * @return IoVec 数量上限（含请求头和状态字节）
+   */
+  [[nodiscard]] auto GetMaxSgElements() const -> size_t {
+    if (!IndirectEnabled()) {
+      return kMaxSgElements;
     }
-    stats_.interrupts_handled++;
-    request_completed_ = true;
-    cpu_io::Wmb();
+    return std::min<size_t>(kMaxIndirectDescs, queues_[0]->vq.Size());
+  }
+
+  /**
+   * @brief 获取一个请求占用的环描述符数量
+   *
+   * @param buffer_count 数据缓冲区数量
+   * @return 使用间接描述符时为 1，否则为 buffer_count + 2
+   */
+  [[nodiscard]] auto GetRequiredDescCount(size_t buffer_count) const
+      -> size_t {
+    return IndirectEnabled() ? 1 : buffer_count + 2;
   }
 
-  // ======== 同步便捷方法 ========
+  // ======== 混合轮询 ========
 
   /**
-   * @brief 同步读取一个扇区
+   * @brief 设置时间戳来源，开始统计请求完成延迟
    *
-   * 基于异步接口实现：EnqueueRead → Kick → 轮询 HandleInterrupt → 返回。
+   * @param timestamp 时间戳函数，为 nullptr 时停止统计
+   */
+  auto SetTimestampSource(TimestampFunc timestamp) -> void {
+    timestamp_ = timestamp;
+  }
+
+  /**
+   * @brief 读取当前时间戳
    *
-   * @param sector 起始扇区号（以 512 字节为单位）
-   * @param data 数据缓冲区（至少 kSectorSize 字节，必须位于 DMA 可访问内存）
-   * @return 成功或失败
-   * @note 缓冲区在函数返回前不得释放或修改
-   * @see virtio-v1.2#5.2.6 Device Operation
+   * @return 时间戳来源的当前值，未设置时返回 0
    */
-  [[nodiscard]] auto Read(uint64_t sector, uint8_t* data) -> Expected<void> {
-    if (data == nullptr) {
-      return std::unexpected(Error{ErrorCode::kInvalidArgument});
+  [[nodiscard]] auto GetTimestamp() const -> uint64_t {
+    return (timestamp_ != nullptr) ? timestamp_() : 0;
+  }
+
+  /**
+   * @brief 开启或关闭混合轮询
+   *
+   * 开启后同步等待者在睡眠前先轮询 Used Ring，轮询时长为在途请求所在
+   * 大小档位的平均完成时间的一部分，超时后再等待中断。小请求的设备
+   * 处理时间往往短于中断投递加上下文切换，轮询可降低其延迟。
+   *
+   * @param enable 是否开启
+   * @pre 已通过 SetTimestampSource() 设置时间戳来源
+   */
+  auto SetHybridPoll(bool enable) -> void { hybrid_poll_ = enable; }
+
+  /**
+   * @brief 是否处于混合轮询模式
+   */
+  [[nodiscard]] auto IsHybridPollEnabled() const -> bool {
+    return hybrid_poll_ && timestamp_ != nullptr;
+  }
+
+  /**
+   * @brief 计算本次轮询的截止时间
+   *
+   * 每个在途请求的预计截止时间为其提交时间加上所在档位的平均完成时间
+   * 乘以轮询比例，取队列中所有在途请求的最大值。轮询比例由 EndPoll()
+   * 根据轮询结果自适应调整。
+   *
+   * @param queue_index 队列索引
+   * @return 截止时间戳；未开启混合轮询或在途请求均无延迟样本时返回 0
+   */
+  [[nodiscard]] auto GetPollDeadline(uint16_t queue_index) const -> uint64_t {
+    if (!IsHybridPollEnabled() || queue_index >= queue_count_) {
+      return 0;
     }
-    IoVec data_iov{virt_to_phys_(reinterpret_cast<uintptr_t>(data)),
-                   kSectorSize};
-    return SubmitSyncRequest(ReqType::kIn, sector, &data_iov, 1);
+    const auto& queue = *queues_[queue_index];
+    uint64_t deadline = 0;
+    uint64_t used = queue.slot_bitmap;
+    while (used != 0) {
+      auto i = static_cast<uint16_t>(__builtin_ctzll(used));
+      const auto& slot = queue.slots[i];
+      const auto& latency = queue.stats.latency[LatencyBucket(slot.bytes)];
+      if (latency.count != 0) {
+        uint64_t budget = latency.mean * queue.poll_eighths / 8;
+        deadline = std::max(deadline, slot.submit_time + budget);
+      }
+      used &= used - 1;
+    }
+    return deadline;
   }
 
   /**
-   * @brief 同步写入一个扇区
+   * @brief 开始轮询，抑制设备的完成中断
    *
-   * 基于异步接口实现：EnqueueWrite → Kick → 轮询 HandleInterrupt → 返回。
+   * 协商了 EVENT_IDX 时把 used_event 设到半个索引空间之外，否则设置
+   * NO_INTERRUPT 标志。可嵌套调用，须与 EndPoll() 成对使用。
    *
-   * @param sector 起始扇区号（以 512 字节为单位）
-   * @param data 数据缓冲区（至少 kSectorSize 字节，必须位于 DMA 可访问内存）
-   * @return 成功或失败
-   * @note 如果设备协商了 VIRTIO_BLK_F_RO，写请求将返回错误
-   * @see virtio-v1.2#5.2.6 Device Operation
+   * @param queue_index 队列索引（小于 GetQueueCount()）
    */
-  [[nodiscard]] auto Write(uint64_t sector, const uint8_t* data)
-      -> Expected<void> {
-    if (data == nullptr) {
-      return std::unexpected(Error{ErrorCode::kInvalidArgument});
+  auto BeginPoll(uint16_t queue_index) -> void {
+    auto& queue = *queues_[queue_index];
+    if (queue.pollers++ == 0) {
+      UpdateUsedEvent(queue);
     }
-    IoVec data_iov{
-        virt_to_phys_(reinterpret_cast<uintptr_t>(const_cast<uint8_t*>(data))),
-        kSectorSize};
-    return SubmitSyncRequest(ReqType::kOut, sector, &data_iov, 1);
+  }
+
+  /**
+   * @brief 结束轮询，恢复完成中断并调整轮询比例
+   *
+   * 轮询成功时比例减 1/8，超时时加 3/8，使约四分之三的轮询在截止前
+   * 完成，比例限制在 [kMinPollEighths, kMaxPollEighths] 之间。
+   *
+   * @param queue_index 队列索引（小于 GetQueueCount()）
+   * @param hit 轮询期间等待的请求是否已全部完成
+   * @note 恢复中断前已完成的请求不会再触发中断，调用者需随后处理
+   *       Used Ring
+   */
+  auto EndPoll(uint16_t queue_index, bool hit) -> void {
+    auto& queue = *queues_[queue_index];
+    if (hit) {
+      queue.stats.poll_hits++;
+      queue.poll_eighths = std::max(kMinPollEighths, queue.poll_eighths - 1);
+    } else {
+      queue.stats.poll_misses++;
+      queue.poll_eighths = std::min(kMaxPollEighths, queue.poll_eighths + 3);
+    }
+    if (--queue.pollers == 0) {
+      UpdateUsedEvent(queue);
+    }
+  }
+
+  /**
+   * @brief 队列的 Used Ring 中是否有未处理的完成项
+   *
+   * @param queue_index 队列索引（小于 GetQueueCount()）
+   * @note 可在不持有驱动锁时调用以探测完成，结果仅作提示
+   */
+  [[nodiscard]] auto HasUsed(uint16_t queue_index) const -> bool {
+    cpu_io::Rmb();
+    return queues_[queue_index]->vq.HasUsed();
   }
 
   // ======== 配置与监控 ========
@@ -468,41 +693,73 @@ class VirtioBlk {
   /**
    * @brief 获取性能监控统计数据
    *
+   * 汇总所有队列的统计；延迟的平均值按各队列的请求数加权。
+   *
    * @return 当前统计数据的快照
    * @see 架构文档 §3
    */
-  [[nodiscard]] auto GetStats() const -> VirtioStats { return stats_; }
+  [[nodiscard]] auto GetStats() const -> VirtioStats {
+    VirtioStats total{};
+    total.interrupts_handled =
+        interrupts_handled_.load(std::memory_order_relaxed);
+    for (uint16_t i = 0; i < queue_count_; ++i) {
+      const auto& stats = queues_[i]->stats;
+      total.bytes_transferred += stats.bytes_transferred;
+      total.kicks_elided += stats.kicks_elided;
+      total.queue_full_errors += stats.queue_full_errors;
+      total.poll_hits += stats.poll_hits;
+      total.poll_misses += stats.poll_misses;
+      for (size_t b = 0; b < kLatencyBuckets; ++b) {
+        const auto& from = stats.latency[b];
+        auto& to = total.latency[b];
+        if (from.count == 0) {
+          continue;
+        }
+        to.mean = (to.mean * to.count + from.mean * from.count) /
+                  (to.count + from.count);
+        to.count += from.count;
+        to.total += from.total;
+        to.max = std::max(to.max, from.max);
+      }
+    }
+    return total;
+  }
 
   /// @name 移动/拷贝控制
   /// @{
   VirtioBlk(VirtioBlk&& other) noexcept
       : transport_(std::move(other.transport_)),
-        vq_(std::move(other.vq_)),
+        queues_(std::move(other.queues_)),
+        queue_count_(other.queue_count_),
         negotiated_features_(other.negotiated_features_),
         slot_dma_(other.slot_dma_),
-        slots_(other.slots_),
         virt_to_phys_(other.virt_to_phys_),
-        stats_(other.stats_),
-        slot_bitmap_(other.slot_bitmap_),
-        old_avail_idx_(other.old_avail_idx_),
-        request_completed_(other.request_completed_) {
-    other.slots_ = nullptr;
-    other.slot_bitmap_ = 0;
+        interrupts_handled_(
+            other.interrupts_handled_.load(std::memory_order_relaxed)),
+        timestamp_(other.timestamp_),
+        hybrid_poll_(other.hybrid_poll_) {
+    for (auto& queue : other.queues_) {
+      queue.reset();
+    }
+    other.queue_count_ = 0;
   }
   auto operator=(VirtioBlk&& other) noexcept -> VirtioBlk& {
     if (this != &other) {
       transport_ = std::move(other.transport_);
-      vq_ = std::move(other.vq_);
+      queues_ = std::move(other.queues_);
+      queue_count_ = other.queue_count_;
       negotiated_features_ = other.negotiated_features_;
       slot_dma_ = other.slot_dma_;
-      slots_ = other.slots_;
       virt_to_phys_ = other.virt_to_phys_;
-      stats_ = other.stats_;
-      slot_bitmap_ = other.slot_bitmap_;
-      old_avail_idx_ = other.old_avail_idx_;
-      request_completed_ = other.request_completed_;
-      other.slots_ = nullptr;
-      other.slot_bitmap_ = 0;
+      interrupts_handled_.store(
+          other.interrupts_handled_.load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+      timestamp_ = other.timestamp_;
+      hybrid_poll_ = other.hybrid_poll_;
+      for (auto& queue : other.queues_) {
+        queue.reset();
+      }
+      other.queue_count_ = 0;
     }
     return *this;
   }
@@ -512,12 +769,21 @@ class VirtioBlk {
   /// @}
 
  private:
+  /// 每个队列的 DMA 内存按页对齐，保证描述符表的对齐要求
+  static constexpr size_t kQueueAlign = 4096;
+  /// 轮询比例（以 1/8 为单位）的初值、下限与上限
+  static constexpr uint32_t kInitPollEighths = 4;
+  static constexpr uint32_t kMinPollEighths = 1;
+  static constexpr uint32_t kMaxPollEighths = 16;
+
   /**
    * @brief 异步请求上下文槽
    *
    * 每个 in-flight 请求占用一个槽，存储请求头（DMA可访问）、
-   * 状态字节（设备回写）、用户 token 和描述符链头索引。
-   * 槽的占用状态由 slot_bitmap_ 管理。
+   * 状态字节（设备回写）、用户 token、描述符链头索引、统计延迟所需的
+   * 提交时间和数据长度，以及协商了 VIRTIO_F_INDIRECT_DESC 时使用的
+   * 间接描述符表。
+   * 槽的占用状态由所属队列的 slot_bitmap 管理。
    */
   struct RequestSlot {
     /// 请求头（DMA 可访问，设备只读）
@@ -528,37 +794,107 @@ class VirtioBlk {
     UserData token;
     /// 描述符链头索引（用于在 Used Ring 中匹配）
     uint16_t desc_head;
+    /// 数据长度（字节），决定延迟统计的档位
+    uint32_t bytes;
+    /// 入队时的时间戳
+    uint64_t submit_time;
+    /// 间接描述符表（DMA 可访问，设备只读）
+    alignas(16) std::array<typename VirtqueueT::Desc, kMaxIndirectDescs>
+        indirect;
+  };
+
+  /**
+   * @brief 一个 Virtqueue 及其请求槽池
+   *
+   * 队列之间不共享可变状态，调用者只需按队列互斥。
+   */
+  struct Queue {
+    /// Virtqueue 实例
+    VirtqueueT vq;
+    /// 请求槽数组（位于 slot_dma_ 内存中）
+    RequestSlot* slots;
+    /// 请求槽数组的物理地址
+    uint64_t slots_phys;
+    /// 请求槽占用位图（bit i = 1 表示 slots[i] 被占用）
+    uint64_t slot_bitmap{0};
+    /// 轮询时长占平均完成时间的比例（以 1/8 为单位）
+    uint32_t poll_eighths{kInitPollEighths};
+    /// 正在轮询的等待者数量，非 0 时抑制完成中断
+    uint32_t pollers{0};
+    /// 本队列的统计数据
+    VirtioStats stats{};
+
+    Queue(VirtqueueT&& virtqueue, RequestSlot* slot_array, uint64_t phys)
+        : vq(std::move(virtqueue)), slots(slot_array), slots_phys(phys) {}
   };
 
+  /**
+   * @brief 计算单个队列占用的 Virtqueue DMA 内存
+   *
+   * @param queue_size 队列大小
+   * @return 按 kQueueAlign 对齐的字节数
+   */
+  [[nodiscard]] static constexpr auto PerQueueVqMemSize(uint32_t queue_size)
+      -> size_t {
+    // 始终按 event_idx=true 分配，因为特性协商在分配之后
+    size_t size = VirtqueueT::CalcSize(static_cast<uint16_t>(queue_size), true);
+    return (size + kQueueAlign - 1) & ~(kQueueAlign - 1);
+  }
+
+  /**
+   * @brief 在 slot 中构造 Virtqueue
+   *
+   * PackedVirtqueue 额外需要知道是否协商了 VIRTIO_F_IN_ORDER。
+   */
+  static auto EmplaceVirtqueue(std::optional<VirtqueueT>& slot,
+                               const DmaRegion& region, uint16_t queue_size,
+                               bool event_idx,
+                               [[maybe_unused]] uint64_t negotiated)
+      -> VirtqueueT& {
+    constexpr auto kInOrder = static_cast<uint64_t>(ReservedFeature::kInOrder);
+    if constexpr ((VirtqueueT::kRingFeatures & kInOrder) != 0) {
+      return slot.emplace(region, queue_size, event_idx,
+                          (negotiated & kInOrder) != 0);
+    } else {
+      return slot.emplace(region, queue_size, event_idx);
+    }
+  }
+
   /**
    * @brief 私有构造函数
    *
-   * 只能通过 Create() 静态工厂方法创建实例。
+   * 只能通过 Create() 静态工厂方法创建实例。第 i 个队列使用 slot_dma
+   * 中第 i 组 kMaxInflight 个请求槽。
    */
-  VirtioBlk(TransportT transport, VirtqueueT vq, uint64_t features,
-            const DmaRegion& slot_dma, VirtToPhysFunc v2p)
+  VirtioBlk(TransportT transport,
+            std::array<std::optional<VirtqueueT>, kMaxQueues>& vqs,
+            uint16_t queue_count, uint64_t features, const DmaRegion& slot_dma,
+            VirtToPhysFunc v2p)
       : transport_(std::move(transport)),
-        vq_(std::move(vq)),
+        queue_count_(queue_count),
         negotiated_features_(features),
         slot_dma_(slot_dma),
-        slots_(reinterpret_cast<RequestSlot*>(slot_dma.Data())),
-        virt_to_phys_(v2p),
-        stats_{},
-        slot_bitmap_(0),
-        old_avail_idx_(0),
-        request_completed_(false) {}
+        virt_to_phys_(v2p) {
+    auto* slots = reinterpret_cast<RequestSlot*>(slot_dma.Data());
+    for (uint16_t i = 0; i < queue_count; ++i) {
+      size_t first = static_cast<size_t>(i) * kMaxInflight;
+      queues_[i].emplace(std::move(*vqs[i]), slots + first,
+                         slot_dma.phys + first * sizeof(RequestSlot));
+    }
+  }
 
   /**
    * @brief 异步入队请求的内部实现
    *
    * 分配请求槽，填充请求头，构建 Scatter-Gather 描述符链，提交到 Available
-   * Ring。
+   * Ring。协商了 VIRTIO_F_INDIRECT_DESC 时描述符写入请求槽的间接表，
+   * 环上只占用一个描述符。
    *
-   * @param type 请求类型（kIn/kOut）
+   * @param type 请求类型（kIn/kOut/kFlush）
    * @param queue_index 队列索引
    * @param sector 起始扇区号
    * @param buffers 数据缓冲区 IoVec 数组
-   * @param buffer_count 缓冲区数量
+   * @param buffer_count 缓冲区数量（kFlush 为 0）
    * @param token 用户上下文指针
    * @return 成功或失败
    */
@@ -566,59 +902,68 @@ class VirtioBlk {
                                uint64_t sector, const IoVec* buffers,
                                size_t buffer_count, UserData token)
       -> Expected<void> {
-    if (queue_index != 0) {
+    if (queue_index >= queue_count_) {
       return std::unexpected(Error{ErrorCode::kInvalidArgument});
     }
+    auto& queue = *queues_[queue_index];
 
-    if (buffer_count + 2 > kMaxSgElements) {
+    if (buffer_count + 2 > GetMaxSgElements()) {
       return std::unexpected(Error{ErrorCode::kInvalidArgument});
     }
 
-    auto slot_result = AllocRequestSlot();
+    auto slot_result = AllocRequestSlot(queue);
     if (!slot_result) {
-      stats_.queue_full_errors++;
+      queue.stats.queue_full_errors++;
       return std::unexpected(slot_result.error());
     }
     uint16_t slot_idx = *slot_result;
-    auto& slot = slots_[slot_idx];
+    auto& slot = queue.slots[slot_idx];
 
     slot.header.type = static_cast<uint32_t>(type);
     slot.header.reserved = 0;
     slot.header.sector = sector;
     slot.status = 0xFF;  // sentinel：设备完成后会覆写
     slot.token = token;
+    slot.bytes = 0;
+    for (size_t i = 0; i < buffer_count; ++i) {
+      slot.bytes += static_cast<uint32_t>(buffers[i].len);
+    }
+    slot.submit_time = GetTimestamp();
 
-    std::array<IoVec, kMaxSgElements> readable_iovs{};
-    std::array<IoVec, kMaxSgElements> writable_iovs{};
-    size_t readable_count = 0;
-    size_t writable_count = 0;
+    // 描述符顺序：请求头、数据、状态字节；前 readable_count 个设备只读
+    std::array<IoVec, kMaxIndirectDescs> iovs{};
+    size_t iov_count = 0;
 
     auto slot_base_phys =
-        slot_dma_.phys + static_cast<size_t>(slot_idx) * sizeof(RequestSlot);
-    readable_iovs[readable_count++] = {
-        slot_base_phys + offsetof(RequestSlot, header), sizeof(BlkReqHeader)};
-
-    if (type == ReqType::kIn) {
-      for (size_t i = 0; i < buffer_count; ++i) {
-        writable_iovs[writable_count++] = buffers[i];
-      }
-    } else {
-      for (size_t i = 0; i < buffer_count; ++i) {
-        readable_iovs[readable_count++] = buffers[i];
-      }
+        queue.slots_phys + static_cast<size_t>(slot_idx) * sizeof(RequestSlot);
+    iovs[iov_count++] = {slot_base_phys + offsetof(RequestSlot, header),
+                         sizeof(BlkReqHeader)};
+    for (size_t i = 0; i < buffer_count; ++i) {
+      iovs[iov_count++] = buffers[i];
     }
+    size_t readable_count = (type == ReqType::kIn) ? 1 : iov_count;
 
     // 状态字节始终为 device-writable
-    writable_iovs[writable_count++] = {
-        slot_base_phys + offsetof(RequestSlot, status), sizeof(uint8_t)};
+    iovs[iov_count++] = {slot_base_phys + offsetof(RequestSlot, status),
+                         sizeof(uint8_t)};
+
+    const IoVec* writable = iovs.data() + readable_count;
+    size_t writable_count = iov_count - readable_count;
+    DmaRegion table{.virt = slot.indirect.data(),
+                    .phys = slot_base_phys + offsetof(RequestSlot, indirect),
+                    .size = sizeof(slot.indirect)};
 
     cpu_io::Wmb();
 
-    auto chain_result = vq_.SubmitChain(readable_iovs.data(), readable_count,
-                                        writable_iovs.data(), writable_count);
+    auto chain_result =
+        IndirectEnabled()
+            ? queue.vq.SubmitIndirect(iovs.data(), readable_count, writable,
+                                      writable_count, table)
+            : queue.vq.SubmitChain(iovs.data(), readable_count, writable,
+                                   writable_count);
     if (!chain_result) {
-      FreeRequestSlot(slot_idx);
-      stats_.queue_full_errors++;
+      FreeRequestSlot(queue, slot_idx);
+      queue.stats.queue_full_errors++;
       return std::unexpected(chain_result.error());
     }
 
@@ -633,18 +978,22 @@ class VirtioBlk {
    * 遍历 Used Ring，对每个已完成的请求：
    * 1. 查找对应的请求槽
    * 2. 读取设备返回的状态字节
-   * 3. 调用回调函数
-   * 4. 释放描述符链和请求槽
+   * 3. 设置了时间戳来源时记录完成延迟
+   * 4. 调用回调函数
+   * 5. 释放描述符链和请求槽
    *
    * @tparam CompletionCallback void(UserData token, ErrorCode status)
+   * @param queue 要处理的队列
    * @param on_complete 完成回调
    */
   template <typename CompletionCallback>
-  auto ProcessCompletions(CompletionCallback&& on_complete) -> void {
+  auto ProcessCompletions(Queue& queue, CompletionCallback&& on_complete)
+      -> void {
     cpu_io::Rmb();
 
-    while (vq_.HasUsed()) {
-      auto elem_result = vq_.PopUsed();
+    uint64_t now = GetTimestamp();
+    while (queue.vq.HasUsed()) {
+      auto elem_result = queue.vq.PopUsed();
       if (!elem_result) {
         break;
       }
@@ -652,31 +1001,80 @@ class VirtioBlk {
       auto elem = *elem_result;
       auto head = static_cast<uint16_t>(elem.id);
 
-      uint16_t slot_idx = FindSlotByDescHead(head);
+      uint16_t slot_idx = FindSlotByDescHead(queue, head);
       if (slot_idx < kMaxInflight) {
-        auto& slot = slots_[slot_idx];
+        auto& slot = queue.slots[slot_idx];
 
         cpu_io::Rmb();
 
+        // 刷新请求的耗时取决于设备缓存中的数据量，不计入读写延迟统计
+        if (timestamp_ != nullptr &&
+            slot.header.type != static_cast<uint32_t>(ReqType::kFlush)) {
+          RecordLatency(queue.stats, slot, now);
+        }
         ErrorCode ec = MapBlkStatus(slot.status);
         on_complete(slot.token, ec);
-        stats_.bytes_transferred += elem.len;
-        FreeRequestSlot(slot_idx);
+        queue.stats.bytes_transferred += elem.len;
+        FreeRequestSlot(queue, slot_idx);
       }
 
-      (void)vq_.FreeChain(head);
+      (void)queue.vq.FreeChain(head);
     }
   }
 
+  /**
+   * @brief 是否协商了 VIRTIO_F_INDIRECT_DESC
+   */
+  [[nodiscard]] auto IndirectEnabled() const -> bool {
+    return (negotiated_features_ &
+            static_cast<uint64_t>(ReservedFeature::kIndirectDesc)) != 0;
+  }
+
+  /**
+   * @brief 计算数据长度对应的延迟统计档位
+   *
+   * @param bytes 请求的数据长度（字节）
+   * @return 档位索引：512B 及以下为 0，每翻一倍加 1，至 kLatencyBuckets - 1
+   */
+  [[nodiscard]] static auto LatencyBucket(uint32_t bytes) -> size_t {
+    size_t bucket = 0;
+    for (uint64_t size = kSectorSize;
+         size < bytes && bucket + 1 < kLatencyBuckets; size <<= 1) {
+      ++bucket;
+    }
+    return bucket;
+  }
+
+  /**
+   * @brief 记录一个已完成请求的延迟
+   *
+   * @param queue_stats 请求所属队列的统计数据
+   * @param slot 已完成请求的槽
+   * @param now 处理完成项时的时间戳
+   */
+  static auto RecordLatency(VirtioStats& queue_stats, const RequestSlot& slot,
+                            uint64_t now) -> void {
+    uint64_t latency = now - slot.submit_time;
+    auto& stats = queue_stats.latency[LatencyBucket(slot.bytes)];
+    stats.mean = (stats.count == 0)
+                     ? latency
+                     : stats.mean - stats.mean / 8 + latency / 8;
+    stats.count++;
+    stats.total += latency;
+    stats.max = std::max(stats.max, latency);
+  }
+
   /**
    * @brief 从请求槽池中分配一个空闲槽（O(1) 位图算法）
    *
-   * 使用 __builtin_ctzll 找到 slot_bitmap_ 中最低的 0 位。
+   * 使用 __builtin_ctzll 找到 slot_bitmap 中最低的 0 位。
    *
+   * @param queue 分配槽的队列
    * @return 成功返回槽索引，失败返回错误
    */
-  [[nodiscard]] auto AllocRequestSlot() -> Expected<uint16_t> {
-    uint64_t free_bits = ~slot_bitmap_;
+  [[nodiscard]] static auto AllocRequestSlot(Queue& queue)
+      -> Expected<uint16_t> {
+    uint64_t free_bits = ~queue.slot_bitmap;
     if (free_bits == 0) {
       return std::unexpected(Error{ErrorCode::kNoFreeDescriptors});
     }
@@ -684,32 +1082,36 @@ class VirtioBlk {
     if (idx >= kMaxInflight) {
       return std::unexpected(Error{ErrorCode::kNoFreeDescriptors});
     }
-    slot_bitmap_ |= (uint64_t{1} << idx);
+    queue.slot_bitmap |= (uint64_t{1} << idx);
     return idx;
   }
 
   /**
    * @brief 释放请求槽
    *
+   * @param queue 槽所属的队列
    * @param idx 槽索引
    */
-  auto FreeRequestSlot(uint16_t idx) -> void {
+  static auto FreeRequestSlot(Queue& queue, uint16_t idx) -> void {
     if (idx < kMaxInflight) {
-      slot_bitmap_ &= ~(uint64_t{1} << idx);
+      queue.slot_bitmap &= ~(uint64_t{1} << idx);
     }
   }
 
   /**
    * @brief 根据描述符链头索引查找请求槽
    *
+   * @param queue 查找的队列
    * @param desc_head 描述符链头索引
    * @return 匹配的槽索引，未找到则返回 kMaxInflight
    */
-  [[nodiscard]] auto FindSlotByDescHead(uint16_t desc_head) const -> uint16_t {
-    uint64_t used = slot_bitmap_;
+  [[nodiscard]] static auto FindSlotByDescHead(const Queue& queue,
+                                                uint16_t desc_head)
+      -> uint16_t {
+    uint64_t used = queue.slot_bitmap;
     while (used != 0) {
       auto i = static_cast<uint16_t>(__builtin_ctzll(used));
-      if (slots_[i].desc_head == desc_head) {
+      if (queue.slots[i].desc_head == desc_head) {
         return i;
       }
       used &= used - 1;  // clear lowest set bit
@@ -737,113 +1139,38 @@ class VirtioBlk {
   }
 
   /**
-   * @brief 判断是否需要发送通知（处理 wrap-around）
-   *
-   * 基于 virtio 规范中的 vring_need_event 算法：检查 event_idx
-   * 是否落在 (old, new] 区间内（含 uint16_t 回绕处理）。
-   *
-   * @param event_idx 设备/驱动期望的通知阈值
-   * @param new_idx 当前索引
-   * @param old_idx 上次通知时的索引
-   * @return true 表示需要发送通知
-   * @see virtio-v1.2#2.7.10 Available Buffer Notification Suppression
-   */
-  [[nodiscard]] static auto VringNeedEvent(uint16_t event_idx, uint16_t new_idx,
-                                           uint16_t old_idx) -> bool {
-    return static_cast<uint16_t>(new_idx - event_idx - 1) <
-           static_cast<uint16_t>(new_idx - old_idx);
-  }
-
-  /**
-   * @brief 更新 avail->used_event 字段
+   * @brief 更新已用缓冲区通知设置
    *
-   * 在处理完 Used Ring 后调用，告知设备下次在此索引之后再发送中断。
-   * 仅在协商了 VIRTIO_F_EVENT_IDX 时生效。
+   * 在处理完已用缓冲区后调用，告知设备下一个完成时发送中断；
+   * 有任务在轮询时改为抑制中断。
    *
+   * @param queue 要更新的队列
    * @see virtio-v1.2#2.7.10 Available Buffer Notification Suppression
+   * @see virtio-v1.2#2.8.10 Event Suppression Structure Format
    */
-  auto UpdateUsedEvent() -> void {
-    if (vq_.EventIdxEnabled()) {
-      auto* used_event_ptr = vq_.AvailUsedEvent();
-      if (used_event_ptr != nullptr) {
-        *used_event_ptr = vq_.LastUsedIdx();
-        cpu_io::Wmb();
-      }
-    }
+  static auto UpdateUsedEvent(Queue& queue) -> void {
+    queue.vq.SetUsedNotify(queue.pollers == 0);
+    cpu_io::Wmb();
   }
 
-  /**
-   * @brief 同步提交请求的内部实现
-   *
-   * Read()/Write() 的共享实现：入队 → Kick → 轮询等待 → 处理完成 → 返回。
-   * 轮询上限固定为 100000000 次迭代。
-   *
-   * @param type 请求类型（kIn/kOut）
-   * @param sector 起始扇区号
-   * @param buffers 数据缓冲区 IoVec 数组
-   * @param buffer_count 缓冲区数量
-   * @return 成功或失败
-   */
-  [[nodiscard]] auto SubmitSyncRequest(ReqType type, uint64_t sector,
-                                       const IoVec* buffers,
-                                       size_t buffer_count) -> Expected<void> {
-    auto enq = DoEnqueue(type, 0, sector, buffers, buffer_count, nullptr);
-    if (!enq) {
-      return std::unexpected(enq.error());
-    }
-
-    Kick(0);
-
-    uint32_t spin_limit = 100000000U;
-
-    for (uint32_t i = 0; i < spin_limit; ++i) {
-      cpu_io::Rmb();
-      if (vq_.HasUsed()) {
-        break;
-      }
-    }
-
-    if (!vq_.HasUsed()) {
-      klog::Warn("Sync request timeout: sector={}", sector);
-      return std::unexpected(Error{ErrorCode::kTimeout});
-    }
-
-    ErrorCode result = ErrorCode::kSuccess;
-    bool done = false;
-    ProcessCompletions([&done, &result](UserData, ErrorCode status) {
-      done = true;
-      result = status;
-    });
-    UpdateUsedEvent();
-
-    if (!done) {
-      return std::unexpected(Error{ErrorCode::kTimeout});
-    }
-    if (result != ErrorCode::kSuccess) {
-      return std::unexpected(Error{result});
-    }
-    return {};
-  }
   /// 传输层实例
   TransportT transport_;
-  /// Virtqueue 实例（当前支持单队列）
-  VirtqueueT vq_;
+  /// 各队列的 Virtqueue 与请求槽池，前 queue_count_ 个有效
+  std::array<std::optional<Queue>, kMaxQueues> queues_;
+  /// 实际使用的队列数量
+  uint16_t queue_count_{0};
   /// 协商后的特性位掩码
   uint64_t negotiated_features_;
-  /// DMA region backing the request slot pool
+  /// DMA region backing the request slot pools of all queues
   DmaRegion slot_dma_;
-  /// Pointer to request slot array (lives in slot_dma_ memory)
-  RequestSlot* slots_{nullptr};
   /// Address translation callback
   VirtToPhysFunc virt_to_phys_{IdentityVirtToPhys};
-  /// 性能统计数据
-  VirtioStats stats_;
-  /// 请求槽占用位图（bit i = 1 表示 slots_[i] 被占用）
-  uint64_t slot_bitmap_{};
-  /// 上次 Kick 时的 avail idx（用于 Event Index 通知抑制）
-  uint16_t old_avail_idx_;
-  /// 请求完成标志（由简化版 HandleInterrupt 在中断上下文中设置）
-  volatile bool request_completed_;
+  /// 已处理的中断次数（设备级，不属于任何队列）
+  std::atomic<uint64_t> interrupts_handled_{0};
+  /// 时间戳来源，为 nullptr 时不统计延迟
+  TimestampFunc timestamp_{nullptr};
+  /// 是否开启混合轮询
+  bool hybrid_poll_{false};
 };
 
 }  // namespace virtio::blk
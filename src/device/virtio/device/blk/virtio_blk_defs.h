@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 
@@ -277,6 +278,24 @@ static constexpr size_t kSectorSize = 512;
 /// @note 如果字符串长度为 20 字节，则没有 NUL 终止符
 static constexpr size_t kDeviceIdMaxLen = 20;
 
+/// 延迟统计按请求大小划分的档位数：512B、1K、…、32K、64K 及以上
+static constexpr size_t kLatencyBuckets = 8;
+
+/**
+ * @brief 一个大小档位的请求完成延迟统计
+ * @note 时间以时间戳来源的计数为单位，未设置时间戳来源时不统计
+ */
+struct LatencyStats {
+  /// 已完成的请求数
+  uint64_t count{0};
+  /// 延迟总和
+  uint64_t total{0};
+  /// 最大延迟
+  uint64_t max{0};
+  /// 延迟的指数滑动平均（新样本权重 1/8），用于估计轮询时长
+  uint64_t mean{0};
+};
+
 /**
  * @brief VirtIO 设备性能监控统计数据
  */
@@ -289,6 +308,12 @@ struct VirtioStats {
   uint64_t interrupts_handled{0};
   /// 队列满导致入队失败的次数
   uint64_t queue_full_errors{0};
+  /// 混合轮询期间等待的请求全部完成的次数
+  uint64_t poll_hits{0};
+  /// 混合轮询超时、转为等待中断的次数
+  uint64_t poll_misses{0};
+  /// 按请求大小分档的完成延迟
+  std::array<LatencyStats, kLatencyBuckets> latency{};
 };
 
 }  // namespace virtio::blk
@@ -4,49 +4,106 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 
 #include "block_device.hpp"
 #include "expected.hpp"
+#include "spinlock.hpp"
 #include "virtio/device/blk/virtio_blk.hpp"
 
 namespace virtio::blk {
 
 /**
- * @brief Adapts VirtioBlk<> to vfs::BlockDevice.
+ * @brief Adapts a VirtioBlk device to vfs::BlockDevice.
  *
- * Wraps a VirtioBlk instance and forwards ReadSectors/WriteSectors
- * to the underlying VirtIO block device.
+ * Implements the asynchronous driver interface: every dispatch unit handed
+ * over by the block layer becomes one descriptor chain per contiguous run
+ * of sectors, and completions are reaped by HandleCompletions() from the
+ * IRQ handler or while polling. ReadSectors/WriteSectors are built on the
+ * same path; once the IRQ is enabled the caller sleeps until the handler
+ * completes the request, before that it polls. In the device's hybrid poll
+ * mode the caller first spins on the used ring for a while before sleeping.
+ * With several virtqueues each core submits to its own queue under that
+ * queue's lock, so cores do not contend.
+ *
+ * @tparam DeviceT VirtioBlk instantiation, split or packed virtqueues.
  */
+template <typename DeviceT = VirtioBlk<>>
 class VirtioBlkVfsAdapter final : public vfs::BlockDevice {
  public:
-  using VirtioBlkType = VirtioBlk<>;
+  using VirtioBlkType = DeviceT;
 
   explicit VirtioBlkVfsAdapter(VirtioBlkType* dev, uint32_t index = 0)
-      : dev_(dev), index_(index) {}
+      : dev_(dev),
+        index_(index),
+        max_segments_(dev->GetMaxSgElements() - 2) {
+    // Honour the device's per-request segment limits when negotiated.
+    auto config = dev_->ReadConfig();
+    uint64_t features = dev_->GetNegotiatedFeatures();
+    if ((features & static_cast<uint64_t>(BlkFeatureBit::kSegMax)) != 0 &&
+        config.seg_max != 0 && config.seg_max < max_segments_) {
+      max_segments_ = config.seg_max;
+    }
+    if ((features & static_cast<uint64_t>(BlkFeatureBit::kSizeMax)) != 0 &&
+        config.size_max >= kSectorSize) {
+      max_segment_size_ = config.size_max;
+    }
+  }
 
+  /**
+   * @brief Reads @p count sectors starting at @p lba.
+   *
+   * Each contiguous run is issued as one scatter-gather request; runs are
+   * split only at the device's seg_max/size_max limits.
+   */
   auto ReadSectors(uint64_t lba, uint32_t count, void* buf)
       -> Expected<size_t> override {
-    auto* ptr = static_cast<uint8_t*>(buf);
-    for (uint32_t i = 0; i < count; ++i) {
-      auto result = dev_->Read(lba + i, ptr + i * kSectorSize);
-      if (!result) {
-        return std::unexpected(Error(result.error().code));
-      }
-    }
-    return static_cast<size_t>(count) * kSectorSize;
+    return Transfer(vfs::BlockOp::kRead, lba, count, buf);
   }
 
+  /// @brief Writes @p count sectors starting at @p lba, see ReadSectors.
   auto WriteSectors(uint64_t lba, uint32_t count, const void* buf)
       -> Expected<size_t> override {
-    const auto* ptr = static_cast<const uint8_t*>(buf);
-    for (uint32_t i = 0; i < count; ++i) {
-      auto result = dev_->Write(lba + i, ptr + i * kSectorSize);
-      if (!result) {
-        return std::unexpected(Error(result.error().code));
+    return Transfer(vfs::BlockOp::kWrite, lba, count, const_cast<void*>(buf));
+  }
+
+  /**
+   * @brief Makes every completed write durable.
+   *
+   * Sends VIRTIO_BLK_T_FLUSH on the current core's virtqueue and waits for
+   * it like ReadSectors. Without VIRTIO_BLK_F_FLUSH the device has no
+   * volatile write cache and there is nothing to do.
+   */
+  auto Flush() -> Expected<void> override {
+    if (!dev_->HasFlush()) {
+      return {};
+    }
+    vfs::BlockWaiter waiter;
+    vfs::BlockRequest request{
+        .op = vfs::BlockOp::kWrite,
+        .end_io = vfs::BlockWaiter::EndIo,
+        .private_data = &waiter,
+    };
+    waiter.Add();
+    while (true) {
+      auto result = QueueFlush(&request);
+      if (result) {
+        break;
+      }
+      if (result.error().code != ErrorCode::kNoFreeDescriptors) {
+        return std::unexpected(result.error());
       }
+      HandleCompletions();
     }
-    return static_cast<size_t>(count) * kSectorSize;
+    ErrorCode status = waiter.Wait(this);
+    if (status != ErrorCode::kSuccess) {
+      return std::unexpected(Error(status));
+    }
+    return {};
   }
 
   [[nodiscard]] auto GetSectorSize() const -> uint32_t override {
@@ -63,10 +120,434 @@ class VirtioBlkVfsAdapter final : public vfs::BlockDevice {
     return (index_ < kNames.size()) ? kNames[index_] : "virtio-blk?";
   }
 
+  [[nodiscard]] auto GetQueueDepth() const -> uint32_t override {
+    return static_cast<uint32_t>(VirtioBlkType::kMaxInflight) *
+           dev_->GetQueueCount();
+  }
+
+  [[nodiscard]] auto GetHwQueueCount() const -> uint32_t override {
+    return dev_->GetQueueCount();
+  }
+
+  /**
+   * @brief Enqueues a dispatch unit on the virtqueue named by its hw_queue
+   *        without notifying the device.
+   *
+   * Chains that do not fit are enqueued later by HandleCompletions();
+   * kNoFreeDescriptors is returned only when not even the first chain
+   * fits or another unit is still waiting for room on that queue.
+   */
+  auto QueueRequest(vfs::BlockRequest* request) -> Expected<void> override {
+    if (request == nullptr) {
+      return std::unexpected(Error(ErrorCode::kInvalidArgument));
+    }
+    auto queue =
+        static_cast<uint16_t>(request->hw_queue % dev_->GetQueueCount());
+    LockGuard<SpinLock> guard(queues_[queue].lock);
+    return QueueRequestLocked(queue, request);
+  }
+
+  /**
+   * @brief Notifies every virtqueue that received requests since its last
+   *        notification.
+   *
+   * The submitter may have migrated since QueueRequest(), so the queues
+   * are found by their flag rather than by the current core.
+   */
+  auto CommitRequests() -> void override {
+    for (uint16_t i = 0; i < dev_->GetQueueCount(); ++i) {
+      auto& state = queues_[i];
+      if (!state.unkicked.load(std::memory_order_relaxed)) {
+        continue;
+      }
+      LockGuard<SpinLock> guard(state.lock);
+      KickLocked(i);
+    }
+  }
+
+  auto PollRequests() -> void override { HandleCompletions(); }
+
+  [[nodiscard]] auto HasCompletionIrq() const -> bool override {
+    return irq_enabled_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Spins on the used ring before the caller goes to sleep.
+   *
+   * Only in hybrid poll mode: the completion interrupt is suppressed while
+   * the caller polls until @p done fires or the deadline estimated from
+   * recent completion times of the in-flight request sizes passes.
+   */
+  auto PollBeforeSleep(const Completion& done) -> void override {
+    // The waiter's requests went to this core's queue unless it migrated,
+    // in which case polling merely misses and the caller sleeps.
+    uint16_t queue = CurrentQueue();
+    auto& state = queues_[queue];
+    uint64_t deadline = 0;
+    {
+      LockGuard<SpinLock> guard(state.lock);
+      deadline = dev_->GetPollDeadline(queue);
+      if (deadline == 0) {
+        return;
+      }
+      dev_->BeginPoll(queue);
+    }
+    while (!done.IsDone() && dev_->GetTimestamp() < deadline) {
+      if (dev_->HasUsed(queue)) {
+        ReapQueue(queue);
+      } else {
+        cpu_io::Pause();
+      }
+    }
+    {
+      LockGuard<SpinLock> guard(state.lock);
+      dev_->EndPoll(queue, done.IsDone());
+    }
+    // Completions posted while suppressed will not raise the interrupt.
+    ReapQueue(queue);
+  }
+
+  /**
+   * @brief Marks completions as reported by the device interrupt.
+   *
+   * Called once the IRQ handler that invokes HandleCompletions() has been
+   * registered; from then on synchronous waiters sleep instead of polling.
+   */
+  auto EnableCompletionIrq() -> void {
+    irq_enabled_.store(true, std::memory_order_release);
+  }
+
+  /**
+   * @brief Reaps completed chains on every virtqueue and ends finished
+   *        dispatch units.
+   *
+   * Safe to call from the IRQ handler and from polling loops. The device
+   * raises one interrupt for all of its queues, so each queue is reaped
+   * under its own lock in turn.
+   */
+  auto HandleCompletions() -> void {
+    dev_->AckInterrupt();
+    for (uint16_t i = 0; i < dev_->GetQueueCount(); ++i) {
+      ReapQueue(i);
+    }
+  }
+
  private:
   static constexpr uint32_t kSectorSize = 512;
+  static constexpr size_t kPageSize = 4096;
+  /// Data segments per request: header and status take two descriptors.
+  /// Bounded by the per-slot indirect table, not by the device's seg_max;
+  /// larger transfers are split into several requests.
+  static constexpr size_t kMaxDataSegments =
+      VirtioBlkType::kMaxIndirectDescs - 2;
+  /// Largest unit submitted by ReadSectors/WriteSectors at once.
+  static constexpr uint32_t kMaxSyncSectors = 2048;
+
+  using SegmentArray = std::array<IoVec, kMaxDataSegments>;
+
+  /// @brief Per-virtqueue submission state.
+  struct QueueState {
+    /// Unit still waiting for room for some of its chains.
+    vfs::BlockRequest* partial{nullptr};
+    /// Chains were enqueued since the device was last notified.
+    std::atomic<bool> unkicked{false};
+    /// Serialises the virtqueue between cores and the IRQ handler.
+    SpinLock lock{"virtio_blk"};
+  };
+
+  /// @brief Virtqueue used by the calling core.
+  [[nodiscard]] auto CurrentQueue() const -> uint16_t {
+    return static_cast<uint16_t>(cpu_io::GetCurrentCoreId() %
+                                 dev_->GetQueueCount());
+  }
+
+  auto KickLocked(uint16_t queue) -> void {
+    dev_->Kick(queue);
+    queues_[queue].unkicked.store(false, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Reaps one virtqueue and ends its finished dispatch units.
+   *
+   * Chains of a partially enqueued unit are continued as slots free up.
+   * Units are ended after the queue lock is dropped so the block layer may
+   * dispatch more requests from the completion path.
+   */
+  auto ReapQueue(uint16_t queue) -> void {
+    auto& state = queues_[queue];
+    std::array<vfs::BlockRequest*, VirtioBlkType::kMaxInflight + 1> done{};
+    size_t done_count = 0;
+    {
+      LockGuard<SpinLock> guard(state.lock);
+      dev_->ProcessQueue(queue, [&state, &done, &done_count](
+                                    void* token, ErrorCode status) {
+        auto* request = static_cast<vfs::BlockRequest*>(token);
+        if (request == nullptr) {
+          return;
+        }
+        if (status != ErrorCode::kSuccess &&
+            request->driver_status == ErrorCode::kSuccess) {
+          request->driver_status = status;
+        }
+        if (--request->driver_pending == 0 && request != state.partial) {
+          done[done_count++] = request;
+        }
+      });
+
+      if (state.partial != nullptr) {
+        vfs::BlockRequest* request = state.partial;
+        bool finished = EnqueueChainsLocked(queue, request);
+        if (request->driver_pending > 0) {
+          KickLocked(queue);
+        }
+        if (finished) {
+          state.partial = nullptr;
+          if (request->driver_pending == 0) {
+            done[done_count++] = request;
+          }
+        }
+      }
+    }
+    for (size_t i = 0; i < done_count; ++i) {
+      vfs::EndRequest(done[i], done[i]->driver_status);
+    }
+  }
+
+  /**
+   * @brief Appends segments for the longest prefix of @p bytes that fits.
+   *
+   * The buffer is split at page boundaries and physically adjacent pieces are
+   * merged again, so the list stays valid for non-identity mappings.
+   *
+   * @return Number of bytes covered.
+   */
+  auto AppendSegments(uint8_t* ptr, size_t bytes, SegmentArray& iovs,
+                      size_t& iov_count) const -> size_t {
+    size_t covered = 0;
+    while (covered < bytes) {
+      auto virt = reinterpret_cast<uintptr_t>(ptr + covered);
+      size_t len = std::min(bytes - covered, kPageSize - (virt % kPageSize));
+      uintptr_t phys = dev_->VirtToPhys(virt);
+
+      IoVec* last = iov_count > 0 ? &iovs[iov_count - 1] : nullptr;
+      if (last != nullptr && last->phys_addr + last->len == phys &&
+          last->len < max_segment_size_) {
+        len = std::min(len, max_segment_size_ - last->len);
+        last->len += len;
+      } else if (iov_count < max_segments_) {
+        len = std::min(len, max_segment_size_);
+        iovs[iov_count++] = {phys, len};
+      } else {
+        break;
+      }
+      covered += len;
+    }
+    return covered;
+  }
+
+  /// @brief Removes @p bytes from the tail of the segment list.
+  static auto TrimSegments(SegmentArray& iovs, size_t& iov_count, size_t bytes)
+      -> void {
+    while (bytes > 0 && iov_count > 0) {
+      IoVec& last = iovs[iov_count - 1];
+      size_t trim = std::min(bytes, last.len);
+      last.len -= trim;
+      bytes -= trim;
+      if (last.len == 0) {
+        --iov_count;
+      }
+    }
+  }
+
+  /**
+   * @brief Splits a dispatch unit into device requests.
+   *
+   * Calls @p fn(sector, iovs, iov_count) for each request; a request ends
+   * when the segment limits are reached and always covers whole sectors.
+   *
+   * @return false if @p fn fails or a single sector does not fit.
+   */
+  template <typename Fn>
+  auto ForEachChain(vfs::BlockRequest* head, Fn&& fn) const -> bool {
+    SegmentArray iovs{};
+    size_t iov_count = 0;
+    uint64_t chain_sector = head->sector;
+    size_t chain_bytes = 0;
+    for (vfs::BlockRequest* r = head; r != nullptr; r = r->merge_next) {
+      auto* ptr = static_cast<uint8_t*>(r->buffer);
+      size_t bytes = static_cast<size_t>(r->sector_count) * kSectorSize;
+      size_t offset = 0;
+      while (offset < bytes) {
+        size_t covered =
+            AppendSegments(ptr + offset, bytes - offset, iovs, iov_count);
+        offset += covered;
+        chain_bytes += covered;
+        if (offset == bytes) {
+          break;
+        }
+        // Segments exhausted: end the chain on a sector boundary.
+        size_t excess = chain_bytes % kSectorSize;
+        TrimSegments(iovs, iov_count, excess);
+        chain_bytes -= excess;
+        offset -= excess;
+        if (chain_bytes == 0 || !fn(chain_sector, iovs.data(), iov_count)) {
+          return false;
+        }
+        chain_sector += chain_bytes / kSectorSize;
+        chain_bytes = 0;
+        iov_count = 0;
+      }
+    }
+    return iov_count == 0 || fn(chain_sector, iovs.data(), iov_count);
+  }
+
+  /**
+   * @brief Enqueues the chains of @p request not yet handed to the device.
+   *
+   * Chains are enumerated from the start of the unit and the first
+   * driver_queued of them are skipped, so a unit can be continued after a
+   * partial enqueue.
+   *
+   * @return true when nothing is left to enqueue, either because every
+   *         chain was enqueued or because an error was recorded in
+   *         driver_status; false when the device ran out of room.
+   */
+  auto EnqueueChainsLocked(uint16_t queue, vfs::BlockRequest* request)
+      -> bool {
+    bool write = request->op == vfs::BlockOp::kWrite;
+    uint32_t index = 0;
+    bool full = false;
+    bool ok = ForEachChain(request, [&](uint64_t sector, const IoVec* iovs,
+                                        size_t n) {
+      if (index++ < request->driver_queued) {
+        return true;
+      }
+      if (dev_->GetFreeSlotCount(queue) == 0 ||
+          dev_->GetFreeDescCount(queue) < dev_->GetRequiredDescCount(n)) {
+        full = true;
+        return false;
+      }
+      auto result = write ? dev_->EnqueueWrite(queue, sector, iovs, n, request)
+                          : dev_->EnqueueRead(queue, sector, iovs, n, request);
+      if (!result) {
+        request->driver_status = result.error().code;
+        return false;
+      }
+      queues_[queue].unkicked.store(true, std::memory_order_relaxed);
+      ++request->driver_queued;
+      ++request->driver_pending;
+      return true;
+    });
+    if (!ok && !full && request->driver_status == ErrorCode::kSuccess) {
+      // A single sector does not fit in the allowed segments.
+      request->driver_status = ErrorCode::kInvalidArgument;
+    }
+    return !full;
+  }
+
+  auto QueueRequestLocked(uint16_t queue, vfs::BlockRequest* request)
+      -> Expected<void> {
+    if (request == nullptr || request->buffer == nullptr) {
+      return std::unexpected(Error(ErrorCode::kInvalidArgument));
+    }
+    auto& state = queues_[queue];
+    // Only one unit may wait for room; later units wait in the block layer.
+    if (state.partial != nullptr) {
+      return std::unexpected(Error(ErrorCode::kNoFreeDescriptors));
+    }
+
+    request->driver_queued = 0;
+    request->driver_pending = 0;
+    request->driver_status = ErrorCode::kSuccess;
+    bool finished = EnqueueChainsLocked(queue, request);
+    if (request->driver_pending == 0) {
+      if (request->driver_status != ErrorCode::kSuccess) {
+        return std::unexpected(Error(request->driver_status));
+      }
+      return std::unexpected(Error(ErrorCode::kNoFreeDescriptors));
+    }
+    if (!finished) {
+      state.partial = request;
+    }
+    // A unit that failed part-way completes with the recorded error.
+    return {};
+  }
+
+  /**
+   * @brief Enqueues and kicks a flush carrying @p request as its token.
+   *
+   * Like QueueRequest(), the remaining room of a queue belongs to a unit
+   * that is partially enqueued there, so the flush waits behind it.
+   */
+  auto QueueFlush(vfs::BlockRequest* request) -> Expected<void> {
+    uint16_t queue = CurrentQueue();
+    auto& state = queues_[queue];
+    LockGuard<SpinLock> guard(state.lock);
+    if (state.partial != nullptr || dev_->GetFreeSlotCount(queue) == 0 ||
+        dev_->GetFreeDescCount(queue) < dev_->GetRequiredDescCount(0)) {
+      return std::unexpected(Error(ErrorCode::kNoFreeDescriptors));
+    }
+    request->driver_queued = 1;
+    request->driver_pending = 1;
+    request->driver_status = ErrorCode::kSuccess;
+    auto result = dev_->EnqueueFlush(queue, request);
+    if (!result) {
+      return std::unexpected(result.error());
+    }
+    KickLocked(queue);
+    return {};
+  }
+
+  auto Transfer(vfs::BlockOp op, uint64_t lba, uint32_t count, void* buf)
+      -> Expected<size_t> {
+    if (buf == nullptr) {
+      return std::unexpected(Error(ErrorCode::kInvalidArgument));
+    }
+    auto* ptr = static_cast<uint8_t*>(buf);
+    uint32_t done = 0;
+    while (done < count) {
+      vfs::BlockWaiter waiter;
+      vfs::BlockRequest request{
+          .op = op,
+          .sector = lba + done,
+          .sector_count = std::min(count - done, kMaxSyncSectors),
+          .buffer = ptr + static_cast<size_t>(done) * kSectorSize,
+          .end_io = vfs::BlockWaiter::EndIo,
+          .private_data = &waiter,
+          .hw_queue = CurrentQueue(),
+      };
+      waiter.Add();
+      while (true) {
+        auto result = QueueRequest(&request);
+        if (result) {
+          break;
+        }
+        if (result.error().code != ErrorCode::kNoFreeDescriptors) {
+          return std::unexpected(result.error());
+        }
+        // Wait for in-flight requests to make room.
+        HandleCompletions();
+      }
+      CommitRequests();
+      ErrorCode status = waiter.Wait(this);
+      if (status != ErrorCode::kSuccess) {
+        return std::unexpected(Error(status));
+      }
+      done += request.sector_count;
+    }
+    return static_cast<size_t>(count) * kSectorSize;
+  }
+
   VirtioBlkType* dev_;
   uint32_t index_{0};
+  /// Data segments allowed per request (descriptor limit and seg_max).
+  size_t max_segments_{kMaxDataSegments};
+  /// Bytes allowed per segment (size_max).
+  size_t max_segment_size_{SIZE_MAX};
+  /// Whether completions raise an interrupt that reaps them.
+  std::atomic<bool> irq_enabled_{false};
+  /// Submission state of each virtqueue, see VirtioBlk::GetQueueCount().
+  std::array<QueueState, VirtioBlkType::kMaxQueues> queues_{};
 };
 
 }  // namespace virtio::blk
@@ -1,5 +0,0 @@
-/**
- * @copyright Copyright The SimpleKernel Contributors
- */
-
-#pragma once
@@ -0,0 +1,975 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+#include <cpu_io.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "expected.hpp"
+#include "io_buffer.hpp"
+#include "virtio/defs.h"
+#include "virtio/device/device_initializer.hpp"
+#include "virtio/device/net/virtio_net_defs.h"
+#include "virtio/transport/mmio.hpp"
+#include "virtio/virt_queue/packed.hpp"
+#include "virtio/virt_queue/split.hpp"
+
+namespace virtio::net {
+
+/**
+ * @brief Virtio 网络设备驱动
+ *
+ * virtio 网络设备是一个虚拟以太网卡，使用一个接收队列和一个发送队列。
+ *
+ * 该类与 VirtioBlk 共用传输层和 Virtqueue 模板：
+ * - 接收：创建时从 DMA 缓冲池取出 queue_size 个 kRxBufferSize 字节的缓冲区
+ *   全部提交给设备。协商了 VIRTIO_NET_F_MRG_RXBUF 时一个报文可跨越多个
+ *   缓冲区。报文以零拷贝方式交给回调，处理完一批后统一重新提交
+ * - 中断与轮询：HandleInterrupt() 只确认中断并关闭接收中断，报文由
+ *   PollRx() 按预算批量处理；收空后重新开启中断（NAPI 模型）
+ * - 发送：Transmit() 只入队，FlushTx() 批量通知设备。发送完成中断默认
+ *   关闭，已发送的报文由 ReclaimTx() 在下次发送前或队列满时回收
+ * - 卸载：按设备提供的特性协商发送/接收校验和与 TSO，遵守特性间依赖
+ *
+ * @tparam TransportT 传输层类型（默认 MmioTransport）
+ * @tparam VirtqueueT Virtqueue 类型（SplitVirtqueue 或 PackedVirtqueue，
+ *         默认 SplitVirtqueue）
+ * @see virtio-v1.2#5.1 Network Device
+ */
+template <typename TransportT = MmioTransport,
+          typename VirtqueueT = SplitVirtqueue>
+class VirtioNet {
+ public:
+  /// 发送回调中使用的用户自定义上下文指针类型
+  using UserData = void*;
+
+  /// 接收队列索引
+  static constexpr uint16_t kRxQueue = 0;
+  /// 发送队列索引
+  static constexpr uint16_t kTxQueue = 1;
+
+  /// 队列大小上限，决定接收缓冲区映射表的大小
+  static constexpr uint32_t kMaxQueueSize = 256;
+
+  /// 最大在途发送报文数
+  static constexpr uint16_t kMaxTxInflight = 64;
+
+  /// 每个发送报文的最大 IoVec 数量（含报文头）
+  static constexpr size_t kMaxTxSgElements = 18;
+
+  /**
+   * @brief 获取两个 Virtqueue 所需的总 DMA 内存大小
+   *
+   * @param queue_size 每个队列的描述符数量（必须为 2 的幂）
+   * @return pair.first = 总字节数，pair.second = 对齐要求（字节）
+   */
+  [[nodiscard]] static constexpr auto GetRequiredVqMemSize(uint32_t queue_size)
+      -> std::pair<size_t, size_t> {
+    return {PerQueueVqMemSize(queue_size) * 2, kQueueAlign};
+  }
+
+  /**
+   * @brief 获取接收缓冲池与发送槽所需的 DMA 内存大小
+   *
+   * 前 queue_size 个 kRxBufferSize 字节为接收缓冲区，其后为发送槽。
+   *
+   * @param queue_size 每个队列的描述符数量
+   * @return pair.first = 总字节数，pair.second = 对齐要求（字节）
+   */
+  [[nodiscard]] static constexpr auto GetRequiredBufMemSize(
+      uint32_t queue_size) -> std::pair<size_t, size_t> {
+    return {kRxBufferSize * queue_size + sizeof(TxSlot) * kMaxTxInflight,
+            kQueueAlign};
+  }
+
+  /**
+   * @brief 创建并初始化网络设备
+   *
+   * 内部自动完成：
+   * 1. Transport 初始化和验证
+   * 2. 按设备提供的特性选择卸载特性（见 SelectFeatures()）
+   * 3. VirtIO 设备初始化序列（重置、特性协商、队列配置、设备激活）
+   * 4. 提交全部接收缓冲区并通知设备
+   *
+   * @param mmio_base MMIO 设备基地址
+   * @param vq_dma 预分配的 Virtqueue DMA 内存区域
+   *        （页对齐，已清零，大小 >= GetRequiredVqMemSize(queue_size)）
+   * @param buf_dma 预分配的接收缓冲池与发送槽 DMA 内存区域
+   *        （页对齐，大小 >= GetRequiredBufMemSize(queue_size)）
+   * @param virt_to_phys 虚拟地址到物理地址转换函数（默认恒等映射）
+   * @param queue_size 每个队列的描述符数量（2 的幂，不超过 kMaxQueueSize）
+   * @param driver_features 额外的驱动特性位，同样受设备特性和依赖约束
+   * @return 成功返回 VirtioNet 实例，失败返回错误
+   * @see virtio-v1.2#5.1.5 Device Initialization
+   */
+  [[nodiscard]] static auto Create(
+      uint64_t mmio_base, const DmaRegion& vq_dma, const DmaRegion& buf_dma,
+      VirtToPhysFunc virt_to_phys = IdentityVirtToPhys,
+      uint32_t queue_size = 128, uint64_t driver_features = 0)
+      -> Expected<VirtioNet> {
+    if (queue_size == 0 || queue_size > kMaxQueueSize ||
+        buf_dma.size < GetRequiredBufMemSize(queue_size).first) {
+      return std::unexpected(Error{ErrorCode::kInvalidArgument});
+    }
+
+    // 1. 创建传输层
+    TransportT transport(mmio_base);
+    if (!transport.IsValid()) {
+      return std::unexpected(Error{ErrorCode::kTransportNotInitialized});
+    }
+
+    // 2. 设备初始化序列
+    DeviceInitializer<TransportT> initializer(transport);
+
+    // 接收报文的长度依赖每个缓冲区，不使用 VIRTIO_F_IN_ORDER 的批量完成
+    constexpr auto kInOrder = static_cast<uint64_t>(ReservedFeature::kInOrder);
+    uint64_t wanted_features =
+        static_cast<uint64_t>(ReservedFeature::kVersion1) |
+        static_cast<uint64_t>(ReservedFeature::kEventIdx) |
+        static_cast<uint64_t>(ReservedFeature::kIndirectDesc) |
+        (VirtqueueT::kRingFeatures & ~kInOrder) |
+        SelectFeatures(transport.GetDeviceFeatures(),
+                       kOffloadFeatures | driver_features);
+    auto negotiated_result = initializer.Init(wanted_features);
+    if (!negotiated_result) {
+      return std::unexpected(negotiated_result.error());
+    }
+    uint64_t negotiated = *negotiated_result;
+
+    if ((negotiated & static_cast<uint64_t>(ReservedFeature::kVersion1)) == 0) {
+      return std::unexpected(Error{ErrorCode::kFeatureNegotiationFailed});
+    }
+    // 队列布局由 VirtqueueT 决定，设备必须支持
+    constexpr auto kRingPacked =
+        static_cast<uint64_t>(ReservedFeature::kRingPacked);
+    if ((negotiated & kRingPacked) !=
+        (VirtqueueT::kRingFeatures & kRingPacked)) {
+      return std::unexpected(Error{ErrorCode::kFeatureNegotiationFailed});
+    }
+
+    bool event_idx =
+        (negotiated & static_cast<uint64_t>(ReservedFeature::kEventIdx)) != 0;
+
+    // 3. 创建并配置接收队列和发送队列
+    size_t per_queue = PerQueueVqMemSize(queue_size);
+    std::array<std::optional<VirtqueueT>, 2> vqs;
+    for (uint16_t i = 0; i < 2; ++i) {
+      auto region = vq_dma.SubRegion(
+          i * per_queue, VirtqueueT::CalcSize(
+                             static_cast<uint16_t>(queue_size), true));
+      if (!region) {
+        return std::unexpected(region.error());
+      }
+      auto& vq =
+          vqs[i].emplace(*region, static_cast<uint16_t>(queue_size), event_idx);
+      if (!vq.IsValid()) {
+        return std::unexpected(Error{ErrorCode::kInvalidArgument});
+      }
+
+      auto setup_result = initializer.SetupQueue(
+          i, vq.DescPhys(), vq.AvailPhys(), vq.UsedPhys(), vq.Size());
+      if (!setup_result) {
+        return std::unexpected(setup_result.error());
+      }
+    }
+
+    // 4. 激活设备
+    auto activate_result = initializer.Activate();
+    if (!activate_result) {
+      return std::unexpected(activate_result.error());
+    }
+
+    // 5. 提交接收缓冲区，设备激活后才能通知
+    Expected<VirtioNet> net{VirtioNet(std::move(transport), vqs, queue_size,
+                                      negotiated, buf_dma, virt_to_phys)};
+    net->RefillRx();
+    return net;
+  }
+
+  // ======== 接收 (HandleInterrupt/PollRx) ========
+
+  /**
+   * @brief 中断处理
+   *
+   * 确认设备中断，关闭接收队列的完成中断并标记需要轮询。报文不在中断
+   * 上下文中处理，由调用者随后调用 PollRx()；轮询期间新到达的报文不会
+   * 再触发中断。
+   *
+   * @return true 表示需要调用 PollRx()
+   * @note 与 PollRx() 操作同一队列，需由调用者互斥
+   * @see virtio-v1.2#2.7.7 Used Buffer Notification Suppression
+   */
+  auto HandleInterrupt() -> bool {
+    AckInterrupt();
+    if (!rx_scheduled_) {
+      rx_vq_.SetUsedNotify(false);
+      cpu_io::Wmb();
+      rx_scheduled_ = true;
+    }
+    return rx_scheduled_;
+  }
+
+  /**
+   * @brief 确认设备中断
+   *
+   * @note 此方法可在中断上下文中安全调用（ISR-safe）
+   * @see virtio-v1.2#4.2.2 MMIO Device Register Layout (InterruptACK)
+   */
+  auto AckInterrupt() -> void {
+    uint32_t isr_status = transport_.GetInterruptStatus();
+    if (isr_status != 0) {
+      transport_.AckInterrupt(isr_status);
+    }
+    interrupts_handled_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 是否有中断调度、尚未完成的接收轮询
+   */
+  [[nodiscard]] auto IsRxScheduled() const -> bool { return rx_scheduled_; }
+
+  /**
+   * @brief 批量处理已接收的报文
+   *
+   * 最多处理 budget 个报文，对每个报文调用 on_packet，然后把用过的缓冲区
+   * 一次性重新提交给设备。预算未用尽说明接收队列已空：重新开启接收中断
+   * 并再检查一次，开启前到达的报文会被继续处理，不会丢失唤醒。
+   * 预算用尽时中断保持关闭，调用者应继续轮询。
+   *
+   * @tparam PacketCallback 签名要求：void(const RxPacket& packet)
+   * @param budget 本次最多处理的报文数
+   * @param on_packet 接收回调，报文数据仅在回调期间有效
+   * @return 处理的报文数（含丢弃的格式错误报文）
+   * @see virtio-v1.2#5.1.6.4 Processing of Incoming Packets
+   */
+  template <typename PacketCallback>
+  auto PollRx(size_t budget, PacketCallback&& on_packet) -> size_t {
+    stats_.rx_polls++;
+    size_t done = 0;
+    while (true) {
+      while (done < budget && ReceiveOne(on_packet)) {
+        ++done;
+      }
+      RefillRx();
+      if (done >= budget) {
+        break;
+      }
+
+      rx_scheduled_ = false;
+      rx_vq_.SetUsedNotify(true);
+      // 全屏障：开启中断先于再次检查 Used Ring
+      cpu_io::Mb();
+      stats_.rx_rearms++;
+      if (!rx_vq_.HasUsed()) {
+        break;
+      }
+      // 开启中断前到达的报文不会再触发中断，继续轮询
+      rx_vq_.SetUsedNotify(false);
+      rx_scheduled_ = true;
+      stats_.rx_rearm_races++;
+    }
+    return done;
+  }
+
+  // ======== 发送 (Transmit/FlushTx/ReclaimTx) ========
+
+  /**
+   * @brief 提交一个待发送的报文（仅入队，不通知设备）
+   *
+   * 报文头位于发送槽中，与 frags 组成一个请求。协商了
+   * VIRTIO_F_INDIRECT_DESC 时只占用一个环描述符。
+   *
+   * @param frags 以太网帧的分段（物理地址 + 长度），在 ReclaimTx() 回收
+   *        之前不得修改
+   * @param frag_count 分段数量（不超过 kMaxTxSgElements - 1）
+   * @param offload 校验和/分段卸载请求，nullptr 表示不卸载；所需特性
+   *        未协商时返回 kNotSupported
+   * @param token 用户自定义上下文指针，在 ReclaimTx 回调时原样传回
+   * @return 成功或失败；队列满时返回 kNoFreeDescriptors，并临时开启
+   *         发送完成中断，以便等待者在有空间时被唤醒
+   * @see virtio-v1.2#5.1.6.2 Packet Transmission
+   */
+  [[nodiscard]] auto Transmit(const IoVec* frags, size_t frag_count,
+                              const NetHdr* offload = nullptr,
+                              UserData token = nullptr) -> Expected<void> {
+    if (frags == nullptr || frag_count == 0 ||
+        frag_count + 1 > kMaxTxSgElements) {
+      return std::unexpected(Error{ErrorCode::kInvalidArgument});
+    }
+    size_t bytes = 0;
+    for (size_t i = 0; i < frag_count; ++i) {
+      bytes += frags[i].len;
+    }
+    auto offload_result = CheckOffload(offload, bytes);
+    if (!offload_result) {
+      return std::unexpected(offload_result.error());
+    }
+
+    if (tx_vq_.NumFree() < GetTxDescCount(frag_count)) {
+      return TxRingFull();
+    }
+    auto slot_result = AllocTxSlot();
+    if (!slot_result) {
+      return TxRingFull();
+    }
+    uint16_t slot_idx = *slot_result;
+    auto& slot = tx_slots_[slot_idx];
+
+    slot.header = (offload != nullptr) ? *offload : NetHdr{};
+    slot.header.num_buffers = 0;
+    slot.token = token;
+    slot.bytes = static_cast<uint32_t>(bytes);
+
+    std::array<IoVec, kMaxTxSgElements> iovs{};
+    auto slot_phys =
+        tx_slots_phys_ + static_cast<size_t>(slot_idx) * sizeof(TxSlot);
+    iovs[0] = {slot_phys + offsetof(TxSlot, header), sizeof(NetHdr)};
+    for (size_t i = 0; i < frag_count; ++i) {
+      iovs[i + 1] = frags[i];
+    }
+    DmaRegion table{.virt = slot.indirect.data(),
+                    .phys = slot_phys + offsetof(TxSlot, indirect),
+                    .size = sizeof(slot.indirect)};
+
+    cpu_io::Wmb();
+
+    auto chain_result =
+        IndirectEnabled()
+            ? tx_vq_.SubmitIndirect(iovs.data(), frag_count + 1, nullptr, 0,
+                                    table)
+            : tx_vq_.SubmitChain(iovs.data(), frag_count + 1, nullptr, 0);
+    if (!chain_result) {
+      FreeTxSlot(slot_idx);
+      return TxRingFull();
+    }
+    slot.desc_head = *chain_result;
+    return {};
+  }
+
+  /**
+   * @brief 批量通知设备发送已入队的报文
+   *
+   * @see virtio-v1.2#2.7.13 Supplying Buffers to The Device
+   */
+  auto FlushTx() -> void { Kick(tx_vq_, kTxQueue); }
+
+  /**
+   * @brief 回收设备已发送的报文
+   *
+   * 发送完成中断默认关闭，调用者在发送前或 Transmit() 返回队列满时
+   * 调用此方法；队列满时开启的完成中断在此关闭。
+   *
+   * @tparam SentCallback 签名要求：void(UserData token)
+   * @param on_sent 每个已发送报文调用一次，之后其分段可被复用
+   * @return 回收的报文数
+   * @see virtio-v1.2#5.1.6.2.2 Driver Requirements: Packet Transmission
+   */
+  template <typename SentCallback>
+  auto ReclaimTx(SentCallback&& on_sent) -> size_t {
+    cpu_io::Rmb();
+    size_t reclaimed = 0;
+    while (tx_vq_.HasUsed()) {
+      auto elem_result = tx_vq_.PopUsed();
+      if (!elem_result) {
+        break;
+      }
+      auto head = static_cast<uint16_t>(elem_result->id);
+      uint16_t slot_idx = FindTxSlotByDescHead(head);
+      if (slot_idx < kMaxTxInflight) {
+        auto& slot = tx_slots_[slot_idx];
+        stats_.tx_packets++;
+        stats_.tx_bytes += slot.bytes;
+        on_sent(slot.token);
+        FreeTxSlot(slot_idx);
+      }
+      (void)tx_vq_.FreeChain(head);
+      ++reclaimed;
+    }
+    if (reclaimed != 0 && tx_notify_armed_) {
+      tx_vq_.SetUsedNotify(false);
+      tx_notify_armed_ = false;
+    }
+    return reclaimed;
+  }
+
+  /**
+   * @brief 回收设备已发送的报文（无回调）
+   *
+   * @return 回收的报文数
+   */
+  auto ReclaimTx() -> size_t {
+    return ReclaimTx([](UserData) {});
+  }
+
+  /**
+   * @brief 获取空闲发送槽数量
+   */
+  [[nodiscard]] auto GetFreeTxSlotCount() const -> uint16_t {
+    return static_cast<uint16_t>(kMaxTxInflight -
+                                 __builtin_popcountll(tx_bitmap_));
+  }
+
+  /**
+   * @brief 将缓冲区的虚拟地址转换为 DMA 地址
+   *
+   * @param virt 虚拟地址
+   * @return 创建设备时提供的转换函数的结果
+   */
+  [[nodiscard]] auto VirtToPhys(uintptr_t virt) const -> uintptr_t {
+    return virt_to_phys_(virt);
+  }
+
+  // ======== 配置与监控 ========
+
+  /**
+   * @brief 读取网络设备配置空间
+   *
+   * 未协商对应特性的字段为 0。
+   *
+   * @return 网络设备配置结构
+   * @see virtio-v1.2#5.1.4 Device configuration layout
+   */
+  [[nodiscard]] auto ReadConfig() const -> NetConfig {
+    NetConfig config{};
+
+    if (HasFeature(NetFeatureBit::kMac)) {
+      for (size_t i = 0; i < config.mac.size(); ++i) {
+        config.mac[i] = transport_.ReadConfigU8(
+            static_cast<uint32_t>(NetConfigOffset::kMac) +
+            static_cast<uint32_t>(i));
+      }
+    }
+    if (HasFeature(NetFeatureBit::kStatus)) {
+      config.status = transport_.ReadConfigU16(
+          static_cast<uint32_t>(NetConfigOffset::kStatus));
+    }
+    if (HasFeature(NetFeatureBit::kMq)) {
+      config.max_virtqueue_pairs = transport_.ReadConfigU16(
+          static_cast<uint32_t>(NetConfigOffset::kMaxVirtqueuePairs));
+    }
+    if (HasFeature(NetFeatureBit::kMtu)) {
+      config.mtu = transport_.ReadConfigU16(
+          static_cast<uint32_t>(NetConfigOffset::kMtu));
+    }
+
+    return config;
+  }
+
+  /**
+   * @brief 链路是否已连接
+   *
+   * @return 未协商 VIRTIO_NET_F_STATUS 时视为始终连接
+   * @see virtio-v1.2#5.1.4.2 Driver Requirements: Device configuration layout
+   */
+  [[nodiscard]] auto IsLinkUp() const -> bool {
+    if (!HasFeature(NetFeatureBit::kStatus)) {
+      return true;
+    }
+    return (transport_.ReadConfigU16(
+                static_cast<uint32_t>(NetConfigOffset::kStatus)) &
+            kNetStatusLinkUp) != 0;
+  }
+
+  /**
+   * @brief 是否协商了指定的网络设备特性
+   */
+  [[nodiscard]] auto HasFeature(NetFeatureBit bit) const -> bool {
+    return (negotiated_features_ & static_cast<uint64_t>(bit)) != 0;
+  }
+
+  /**
+   * @brief 获取协商后的特性位
+   *
+   * @return 设备和驱动程序都支持的特性位掩码
+   */
+  [[nodiscard]] auto GetNegotiatedFeatures() const -> uint64_t {
+    return negotiated_features_;
+  }
+
+  /**
+   * @brief 获取统计数据
+   *
+   * @return 当前统计数据的快照
+   */
+  [[nodiscard]] auto GetStats() const -> NetStats {
+    NetStats stats = stats_;
+    stats.interrupts_handled =
+        interrupts_handled_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+  /// @name 移动/拷贝控制
+  /// @{
+  VirtioNet(VirtioNet&& other) noexcept
+      : transport_(std::move(other.transport_)),
+        rx_vq_(std::move(other.rx_vq_)),
+        tx_vq_(std::move(other.tx_vq_)),
+        negotiated_features_(other.negotiated_features_),
+        virt_to_phys_(other.virt_to_phys_),
+        rx_buffers_(other.rx_buffers_),
+        rx_buffers_phys_(other.rx_buffers_phys_),
+        rx_buf_of_id_(other.rx_buf_of_id_),
+        rx_free_(other.rx_free_),
+        rx_free_count_(other.rx_free_count_),
+        rx_scheduled_(other.rx_scheduled_),
+        tx_slots_(other.tx_slots_),
+        tx_slots_phys_(other.tx_slots_phys_),
+        tx_bitmap_(other.tx_bitmap_),
+        tx_notify_armed_(other.tx_notify_armed_),
+        stats_(other.stats_),
+        interrupts_handled_(
+            other.interrupts_handled_.load(std::memory_order_relaxed)) {
+    other.rx_free_count_ = 0;
+    other.tx_bitmap_ = 0;
+  }
+  auto operator=(VirtioNet&& other) noexcept -> VirtioNet& {
+    if (this != &other) {
+      transport_ = std::move(other.transport_);
+      rx_vq_ = std::move(other.rx_vq_);
+      tx_vq_ = std::move(other.tx_vq_);
+      negotiated_features_ = other.negotiated_features_;
+      virt_to_phys_ = other.virt_to_phys_;
+      rx_buffers_ = other.rx_buffers_;
+      rx_buffers_phys_ = other.rx_buffers_phys_;
+      rx_buf_of_id_ = other.rx_buf_of_id_;
+      rx_free_ = other.rx_free_;
+      rx_free_count_ = other.rx_free_count_;
+      rx_scheduled_ = other.rx_scheduled_;
+      tx_slots_ = other.tx_slots_;
+      tx_slots_phys_ = other.tx_slots_phys_;
+      tx_bitmap_ = other.tx_bitmap_;
+      tx_notify_armed_ = other.tx_notify_armed_;
+      stats_ = other.stats_;
+      interrupts_handled_.store(
+          other.interrupts_handled_.load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+      other.rx_free_count_ = 0;
+      other.tx_bitmap_ = 0;
+    }
+    return *this;
+  }
+  VirtioNet(const VirtioNet&) = delete;
+  auto operator=(const VirtioNet&) -> VirtioNet& = delete;
+  ~VirtioNet() = default;
+  /// @}
+
+ private:
+  /// 每个队列的 DMA 内存按页对齐，保证描述符表的对齐要求
+  static constexpr size_t kQueueAlign = 4096;
+
+  /// 驱动希望使用的卸载与配置特性，实际协商结果见 SelectFeatures()
+  static constexpr uint64_t kOffloadFeatures =
+      static_cast<uint64_t>(NetFeatureBit::kCsum) |
+      static_cast<uint64_t>(NetFeatureBit::kGuestCsum) |
+      static_cast<uint64_t>(NetFeatureBit::kMac) |
+      static_cast<uint64_t>(NetFeatureBit::kStatus) |
+      static_cast<uint64_t>(NetFeatureBit::kMrgRxbuf) |
+      static_cast<uint64_t>(NetFeatureBit::kHostTso4) |
+      static_cast<uint64_t>(NetFeatureBit::kHostTso6) |
+      static_cast<uint64_t>(NetFeatureBit::kGuestTso4) |
+      static_cast<uint64_t>(NetFeatureBit::kGuestTso6);
+
+  /**
+   * @brief 发送槽
+   *
+   * 每个在途发送报文占用一个槽，存储报文头（DMA 可访问）、用户 token、
+   * 描述符链头索引、报文长度，以及协商了 VIRTIO_F_INDIRECT_DESC 时使用
+   * 的间接描述符表。槽的占用状态由 tx_bitmap_ 管理。
+   */
+  struct TxSlot {
+    /// 报文头（DMA 可访问，设备只读）
+    alignas(16) NetHdr header;
+    /// 用户自定义上下文指针
+    UserData token;
+    /// 描述符链头索引（用于在 Used Ring 中匹配）
+    uint16_t desc_head;
+    /// 报文长度（字节，不含报文头）
+    uint32_t bytes;
+    /// 间接描述符表（DMA 可访问，设备只读）
+    alignas(16) std::array<typename VirtqueueT::Desc, kMaxTxSgElements>
+        indirect;
+  };
+
+  /**
+   * @brief 计算单个队列占用的 Virtqueue DMA 内存
+   *
+   * @param queue_size 队列大小
+   * @return 按 kQueueAlign 对齐的字节数
+   */
+  [[nodiscard]] static constexpr auto PerQueueVqMemSize(uint32_t queue_size)
+      -> size_t {
+    // 始终按 event_idx=true 分配，因为特性协商在分配之后
+    size_t size = VirtqueueT::CalcSize(static_cast<uint16_t>(queue_size), true);
+    return (size + kQueueAlign - 1) & ~(kQueueAlign - 1);
+  }
+
+  /**
+   * @brief 按设备提供的特性和特性间依赖选择网络特性
+   *
+   * - HOST_TSO4/6 依赖 CSUM
+   * - GUEST_TSO4/6 依赖 GUEST_CSUM，且接收 64K 报文需要 MRG_RXBUF
+   *   （接收缓冲区只有 kRxBufferSize 字节）
+   *
+   * @param offered 设备提供的特性位
+   * @param wanted 驱动希望使用的特性位
+   * @return 可以安全请求的特性位
+   * @see virtio-v1.2#5.1.3.1 Feature bit requirements
+   */
+  [[nodiscard]] static constexpr auto SelectFeatures(uint64_t offered,
+                                                     uint64_t wanted)
+      -> uint64_t {
+    constexpr auto kHostTso = static_cast<uint64_t>(NetFeatureBit::kHostTso4) |
+                              static_cast<uint64_t>(NetFeatureBit::kHostTso6) |
+                              static_cast<uint64_t>(NetFeatureBit::kHostEcn);
+    constexpr auto kGuestTso =
+        static_cast<uint64_t>(NetFeatureBit::kGuestTso4) |
+        static_cast<uint64_t>(NetFeatureBit::kGuestTso6) |
+        static_cast<uint64_t>(NetFeatureBit::kGuestEcn);
+    constexpr auto kGuestTsoDeps =
+        static_cast<uint64_t>(NetFeatureBit::kGuestCsum) |
+        static_cast<uint64_t>(NetFeatureBit::kMrgRxbuf);
+
+    uint64_t features = offered & wanted;
+    if ((features & static_cast<uint64_t>(NetFeatureBit::kCsum)) == 0) {
+      features &= ~kHostTso;
+    }
+    if ((features & kGuestTsoDeps) != kGuestTsoDeps) {
+      features &= ~kGuestTso;
+    }
+    return features;
+  }
+
+  /**
+   * @brief 私有构造函数
+   *
+   * 只能通过 Create() 静态工厂方法创建实例。buf_dma 的前 queue_size 个
+   * kRxBufferSize 字节为接收缓冲区，其后为 kMaxTxInflight 个发送槽。
+   * 发送完成中断在此关闭。
+   */
+  VirtioNet(TransportT transport, std::array<std::optional<VirtqueueT>, 2>& vqs,
+            uint32_t queue_size, uint64_t features, const DmaRegion& buf_dma,
+            VirtToPhysFunc v2p)
+      : transport_(std::move(transport)),
+        rx_vq_(std::move(*vqs[kRxQueue])),
+        tx_vq_(std::move(*vqs[kTxQueue])),
+        negotiated_features_(features),
+        virt_to_phys_(v2p),
+        rx_buffers_(buf_dma.Data()),
+        rx_buffers_phys_(buf_dma.phys),
+        tx_slots_(reinterpret_cast<TxSlot*>(buf_dma.Data() +
+                                            kRxBufferSize * queue_size)),
+        tx_slots_phys_(buf_dma.phys + kRxBufferSize * queue_size) {
+    for (uint32_t i = 0; i < queue_size; ++i) {
+      rx_free_[rx_free_count_++] = static_cast<uint16_t>(i);
+    }
+    tx_vq_.SetUsedNotify(false);
+    cpu_io::Wmb();
+  }
+
+  /**
+   * @brief 通知设备队列中有新的缓冲区
+   *
+   * @param vq 队列
+   * @param queue_index 队列索引
+   */
+  auto Kick(VirtqueueT& vq, uint16_t queue_index) -> void {
+    if (vq.KickPrepare()) {
+      transport_.NotifyQueue(queue_index);
+    } else {
+      stats_.kicks_elided++;
+    }
+  }
+
+  /**
+   * @brief 接收一个报文
+   *
+   * 从 Used Ring 取出报文的第一个缓冲区，协商了 VIRTIO_NET_F_MRG_RXBUF
+   * 时按报文头中的 num_buffers 继续取出其余缓冲区。取出的缓冲区都放入
+   * 待提交列表。长度不合法或缓冲区缺失的报文被丢弃。
+   *
+   * @tparam PacketCallback void(const RxPacket& packet)
+   * @param on_packet 接收回调
+   * @return false 表示接收队列中没有报文
+   * @see virtio-v1.2#5.1.6.4.2 Driver Requirements: Processing of Incoming
+   *      Packets
+   */
+  template <typename PacketCallback>
+  auto ReceiveOne(PacketCallback& on_packet) -> bool {
+    cpu_io::Rmb();
+    auto first = rx_vq_.PopUsed();
+    if (!first) {
+      return false;
+    }
+
+    RxPacket packet;
+    packet.header = nullptr;
+    packet.segment_count = 0;
+    packet.length = 0;
+    const uint8_t* data = TakeRxBuffer(first->id);
+    bool valid = data != nullptr && first->len >= sizeof(NetHdr) &&
+                 first->len <= kRxBufferSize;
+    uint16_t num_buffers = 1;
+    if (valid) {
+      packet.header = reinterpret_cast<const NetHdr*>(data);
+      packet.segments[0] = {data + sizeof(NetHdr),
+                            first->len - static_cast<uint32_t>(sizeof(NetHdr))};
+      packet.segment_count = 1;
+      packet.length = packet.segments[0].len;
+      if (HasFeature(NetFeatureBit::kMrgRxbuf)) {
+        num_buffers = packet.header->num_buffers;
+      }
+    }
+
+    for (uint16_t i = 1; i < num_buffers; ++i) {
+      cpu_io::Rmb();
+      auto next = rx_vq_.PopUsed();
+      if (!next) {
+        // 设备尚未提交报文的其余缓冲区
+        valid = false;
+        break;
+      }
+      data = TakeRxBuffer(next->id);
+      if (data == nullptr || next->len > kRxBufferSize ||
+          packet.segment_count >= kMaxRxSegments) {
+        valid = false;
+        continue;
+      }
+      packet.segments[packet.segment_count++] = {data, next->len};
+      packet.length += next->len;
+    }
+
+    if (!valid || num_buffers == 0) {
+      stats_.rx_dropped++;
+      return true;
+    }
+    stats_.rx_packets++;
+    stats_.rx_bytes += packet.length;
+    on_packet(static_cast<const RxPacket&>(packet));
+    return true;
+  }
+
+  /**
+   * @brief 回收设备用过的接收缓冲区
+   *
+   * 释放描述符并把缓冲区放入待提交列表，缓冲区内容在下次 RefillRx()
+   * 之前保持有效。
+   *
+   * @param id Used Ring 中的描述符链头索引或缓冲区 ID
+   * @return 缓冲区的 CPU 地址，id 不合法时返回 nullptr
+   */
+  auto TakeRxBuffer(uint32_t id) -> const uint8_t* {
+    if (id >= kMaxQueueSize) {
+      return nullptr;
+    }
+    (void)rx_vq_.FreeChain(static_cast<uint16_t>(id));
+    uint16_t buf = rx_buf_of_id_[id];
+    rx_free_[rx_free_count_++] = buf;
+    return rx_buffers_ + static_cast<size_t>(buf) * kRxBufferSize;
+  }
+
+  /**
+   * @brief 把待提交列表中的接收缓冲区提交给设备
+   *
+   * 每个缓冲区占用一个设备可写描述符，提交后统一通知一次设备。
+   *
+   * @see virtio-v1.2#5.1.6.3 Setting Up Receive Buffers
+   */
+  auto RefillRx() -> void {
+    bool posted = false;
+    while (rx_free_count_ > 0) {
+      uint16_t buf = rx_free_[rx_free_count_ - 1];
+      IoVec iov{rx_buffers_phys_ + static_cast<size_t>(buf) * kRxBufferSize,
+                kRxBufferSize};
+      auto id = rx_vq_.SubmitChain(nullptr, 0, &iov, 1);
+      if (!id) {
+        break;
+      }
+      rx_buf_of_id_[*id] = buf;
+      --rx_free_count_;
+      posted = true;
+    }
+    if (posted) {
+      Kick(rx_vq_, kRxQueue);
+    }
+  }
+
+  /**
+   * @brief 检查卸载请求是否合法且所需特性已协商
+   *
+   * @param offload 卸载请求，nullptr 表示不卸载
+   * @param bytes 帧长度（字节）
+   * @return 成功或失败
+   * @see virtio-v1.2#5.1.6.2.1 Driver Requirements: Packet Transmission
+   */
+  [[nodiscard]] auto CheckOffload(const NetHdr* offload, size_t bytes) const
+      -> Expected<void> {
+    if (offload == nullptr) {
+      if (bytes > kMaxFrameSize) {
+        return std::unexpected(Error{ErrorCode::kInvalidArgument});
+      }
+      return {};
+    }
+
+    bool needs_csum =
+        (offload->flags & std::to_underlying(NetHdrFlags::kNeedsCsum)) != 0;
+    if (needs_csum) {
+      if (!HasFeature(NetFeatureBit::kCsum)) {
+        return std::unexpected(Error{ErrorCode::kNotSupported});
+      }
+      if (static_cast<size_t>(offload->csum_start) + offload->csum_offset +
+              sizeof(uint16_t) >
+          bytes) {
+        return std::unexpected(Error{ErrorCode::kInvalidArgument});
+      }
+    }
+
+    auto gso = static_cast<uint8_t>(offload->gso_type &
+                                    ~std::to_underlying(NetGsoType::kEcn));
+    if (gso == std::to_underlying(NetGsoType::kNone)) {
+      if (bytes > kMaxFrameSize) {
+        return std::unexpected(Error{ErrorCode::kInvalidArgument});
+      }
+      return {};
+    }
+
+    bool ecn = (offload->gso_type & std::to_underlying(NetGsoType::kEcn)) != 0;
+    bool supported =
+        (gso == std::to_underlying(NetGsoType::kTcpv4) &&
+         HasFeature(NetFeatureBit::kHostTso4)) ||
+        (gso == std::to_underlying(NetGsoType::kTcpv6) &&
+         HasFeature(NetFeatureBit::kHostTso6));
+    if (!supported || (ecn && !HasFeature(NetFeatureBit::kHostEcn))) {
+      return std::unexpected(Error{ErrorCode::kNotSupported});
+    }
+    // 分段卸载要求同时请求校验和卸载
+    if (!needs_csum || offload->gso_size == 0 || offload->hdr_len == 0 ||
+        bytes > kMaxGsoPacketSize) {
+      return std::unexpected(Error{ErrorCode::kInvalidArgument});
+    }
+    return {};
+  }
+
+  /**
+   * @brief 发送队列满：开启发送完成中断并返回错误
+   */
+  auto TxRingFull() -> Expected<void> {
+    stats_.tx_ring_full++;
+    if (!tx_notify_armed_) {
+      tx_vq_.SetUsedNotify(true);
+      cpu_io::Mb();
+      tx_notify_armed_ = true;
+    }
+    return std::unexpected(Error{ErrorCode::kNoFreeDescriptors});
+  }
+
+  /**
+   * @brief 一个发送报文占用的环描述符数量
+   *
+   * @param frag_count 帧的分段数量
+   * @return 使用间接描述符时为 1，否则为 frag_count + 1
+   */
+  [[nodiscard]] auto GetTxDescCount(size_t frag_count) const -> size_t {
+    return IndirectEnabled() ? 1 : frag_count + 1;
+  }
+
+  /**
+   * @brief 是否协商了 VIRTIO_F_INDIRECT_DESC
+   */
+  [[nodiscard]] auto IndirectEnabled() const -> bool {
+    return (negotiated_features_ &
+            static_cast<uint64_t>(ReservedFeature::kIndirectDesc)) != 0;
+  }
+
+  /**
+   * @brief 分配一个空闲发送槽（O(1) 位图算法）
+   *
+   * @return 成功返回槽索引，失败返回错误
+   */
+  [[nodiscard]] auto AllocTxSlot() -> Expected<uint16_t> {
+    uint64_t free_bits = ~tx_bitmap_;
+    if (free_bits == 0) {
+      return std::unexpected(Error{ErrorCode::kNoFreeDescriptors});
+    }
+    auto idx = static_cast<uint16_t>(__builtin_ctzll(free_bits));
+    if (idx >= kMaxTxInflight) {
+      return std::unexpected(Error{ErrorCode::kNoFreeDescriptors});
+    }
+    tx_bitmap_ |= (uint64_t{1} << idx);
+    return idx;
+  }
+
+  /**
+   * @brief 释放发送槽
+   *
+   * @param idx 槽索引
+   */
+  auto FreeTxSlot(uint16_t idx) -> void {
+    if (idx < kMaxTxInflight) {
+      tx_bitmap_ &= ~(uint64_t{1} << idx);
+    }
+  }
+
+  /**
+   * @brief 根据描述符链头索引查找发送槽
+   *
+   * @param desc_head 描述符链头索引
+   * @return 匹配的槽索引，未找到则返回 kMaxTxInflight
+   */
+  [[nodiscard]] auto FindTxSlotByDescHead(uint16_t desc_head) const
+      -> uint16_t {
+    uint64_t used = tx_bitmap_;
+    while (used != 0) {
+      auto i = static_cast<uint16_t>(__builtin_ctzll(used));
+      if (tx_slots_[i].desc_head == desc_head) {
+        return i;
+      }
+      used &= used - 1;
+    }
+    return kMaxTxInflight;
+  }
+
+  /// 传输层实例
+  TransportT transport_;
+  /// 接收队列
+  VirtqueueT rx_vq_;
+  /// 发送队列
+  VirtqueueT tx_vq_;
+  /// 协商后的特性位掩码
+  uint64_t negotiated_features_;
+  /// 地址转换回调
+  VirtToPhysFunc virt_to_phys_{IdentityVirtToPhys};
+  /// 接收缓冲池（位于 buf_dma 起始处）
+  uint8_t* rx_buffers_;
+  /// 接收缓冲池的物理地址
+  uint64_t rx_buffers_phys_;
+  /// 已提交的接收缓冲区：描述符链头索引（或缓冲区 ID）到缓冲区编号
+  std::array<uint16_t, kMaxQueueSize> rx_buf_of_id_{};
+  /// 待重新提交的接收缓冲区编号
+  std::array<uint16_t, kMaxQueueSize> rx_free_{};
+  /// rx_free_ 中的有效数量
+  size_t rx_free_count_{0};
+  /// 接收中断已关闭、等待 PollRx() 处理
+  bool rx_scheduled_{false};
+  /// 发送槽数组（位于 buf_dma 中接收缓冲池之后）
+  TxSlot* tx_slots_;
+  /// 发送槽数组的物理地址
+  uint64_t tx_slots_phys_;
+  /// 发送槽占用位图（bit i = 1 表示 tx_slots_[i] 被占用）
+  uint64_t tx_bitmap_{0};
+  /// 发送队列满时临时开启了发送完成中断
+  bool tx_notify_armed_{false};
+  /// 统计数据
+  NetStats stats_{};
+  /// 已处理的中断次数
+  std::atomic<uint64_t> interrupts_handled_{0};
+};
+
+}  // namespace virtio::net
@@ -0,0 +1,212 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace virtio::net {
+
+/**
+ * @brief 网络设备特性位定义
+ * @see virtio-v1.2#5.1.3 Feature bits
+ *
+ * 卸载类特性之间存在依赖：HOST_TSO* 依赖 CSUM，GUEST_TSO* 依赖
+ * GUEST_CSUM，驱动不得单独接受被依赖位缺失的特性。
+ * @see virtio-v1.2#5.1.3.1 Feature bit requirements
+ */
+enum class NetFeatureBit : uint64_t {
+  /// 设备可处理部分校验和的报文，即支持发送校验和卸载 (VIRTIO_NET_F_CSUM)
+  kCsum = 1ULL << 0,
+  /// 驱动可处理部分校验和的报文，即支持接收校验和卸载
+  /// (VIRTIO_NET_F_GUEST_CSUM)
+  kGuestCsum = 1ULL << 1,
+  /// 设备配置空间中 mtu 字段有效 (VIRTIO_NET_F_MTU)
+  kMtu = 1ULL << 3,
+  /// 设备配置空间中 mac 字段有效 (VIRTIO_NET_F_MAC)
+  kMac = 1ULL << 5,
+  /// 驱动可接收 TSOv4 报文 (VIRTIO_NET_F_GUEST_TSO4)
+  kGuestTso4 = 1ULL << 7,
+  /// 驱动可接收 TSOv6 报文 (VIRTIO_NET_F_GUEST_TSO6)
+  kGuestTso6 = 1ULL << 8,
+  /// 驱动可接收带 ECN 的 TSO 报文 (VIRTIO_NET_F_GUEST_ECN)
+  kGuestEcn = 1ULL << 9,
+  /// 设备可接收 TSOv4 报文，即支持发送分段卸载 (VIRTIO_NET_F_HOST_TSO4)
+  kHostTso4 = 1ULL << 11,
+  /// 设备可接收 TSOv6 报文 (VIRTIO_NET_F_HOST_TSO6)
+  kHostTso6 = 1ULL << 12,
+  /// 设备可接收带 ECN 的 TSO 报文 (VIRTIO_NET_F_HOST_ECN)
+  kHostEcn = 1ULL << 13,
+  /// 驱动可将一个报文合并到多个接收缓冲区 (VIRTIO_NET_F_MRG_RXBUF)
+  kMrgRxbuf = 1ULL << 15,
+  /// 设备配置空间中 status 字段有效 (VIRTIO_NET_F_STATUS)
+  kStatus = 1ULL << 16,
+  /// 存在控制队列 (VIRTIO_NET_F_CTRL_VQ)
+  kCtrlVq = 1ULL << 17,
+  /// 设备支持多队列与自动接收导向 (VIRTIO_NET_F_MQ)
+  kMq = 1ULL << 22,
+};
+
+/**
+ * @brief 网络设备配置空间字段偏移
+ * @see virtio-v1.2#5.1.4 Device configuration layout
+ */
+enum class NetConfigOffset : uint32_t {
+  /// MAC 地址，6 字节（如果 VIRTIO_NET_F_MAC 被协商）
+  kMac = 0,
+  /// 链路状态（如果 VIRTIO_NET_F_STATUS 被协商）
+  kStatus = 6,
+  /// 最大队列对数（如果 VIRTIO_NET_F_MQ 被协商）
+  kMaxVirtqueuePairs = 8,
+  /// 最大 MTU（如果 VIRTIO_NET_F_MTU 被协商）
+  kMtu = 10,
+};
+
+/**
+ * @brief 网络设备配置空间布局
+ * @see virtio-v1.2#5.1.4 Device configuration layout
+ */
+struct NetConfig {
+  /// MAC 地址
+  std::array<uint8_t, 6> mac;
+  /// 链路状态，bit 0 为 VIRTIO_NET_S_LINK_UP
+  uint16_t status;
+  /// 最大队列对数
+  uint16_t max_virtqueue_pairs;
+  /// 最大 MTU
+  uint16_t mtu;
+};
+
+/// 配置空间 status 字段：链路已连接 (VIRTIO_NET_S_LINK_UP)
+static constexpr uint16_t kNetStatusLinkUp = 1;
+
+/**
+ * @brief virtio-net 报文头
+ * @see virtio-v1.2#5.1.6 Device Operation
+ *
+ * 每个收发的报文前都有此头部。协商了 VERSION_1 后 num_buffers
+ * 字段始终存在，头部固定为 12 字节；发送时 num_buffers 必须为 0。
+ */
+struct [[gnu::packed]] NetHdr {
+  /// 标志位，见 NetHdrFlags
+  uint8_t flags;
+  /// 分段卸载类型，见 NetGsoType
+  uint8_t gso_type;
+  /// 以太网、IP 与传输层头部的总长度
+  uint16_t hdr_len;
+  /// 分段后每个报文的最大负载长度
+  uint16_t gso_size;
+  /// 从此偏移处开始计算校验和
+  uint16_t csum_start;
+  /// 校验和字段相对 csum_start 的偏移
+  uint16_t csum_offset;
+  /// 接收时报文占用的缓冲区数量（如果 VIRTIO_NET_F_MRG_RXBUF 被协商）
+  uint16_t num_buffers;
+};
+
+/**
+ * @brief 报文头标志位
+ * @see virtio-v1.2#5.1.6 Device Operation
+ */
+enum class NetHdrFlags : uint8_t {
+  /// 校验和需要从 csum_start 开始计算并写入 csum_offset 处
+  /// (VIRTIO_NET_HDR_F_NEEDS_CSUM)
+  kNeedsCsum = 1,
+  /// 设备已校验报文的校验和 (VIRTIO_NET_HDR_F_DATA_VALID)
+  kDataValid = 2,
+};
+
+/**
+ * @brief 分段卸载类型
+ * @see virtio-v1.2#5.1.6 Device Operation
+ */
+enum class NetGsoType : uint8_t {
+  /// 不分段 (VIRTIO_NET_HDR_GSO_NONE)
+  kNone = 0,
+  /// TCPv4 分段 (VIRTIO_NET_HDR_GSO_TCPV4)
+  kTcpv4 = 1,
+  /// UDP 分片 (VIRTIO_NET_HDR_GSO_UDP)
+  kUdp = 3,
+  /// TCPv6 分段 (VIRTIO_NET_HDR_GSO_TCPV6)
+  kTcpv6 = 4,
+  /// 与上述类型组合，表示报文带 ECN (VIRTIO_NET_HDR_GSO_ECN)
+  kEcn = 0x80,
+};
+
+/// 不带 VLAN 标签的以太网头长度（字节）
+static constexpr size_t kEthHeaderSize = 14;
+
+/// 不分段时的最大以太网帧长度（1500 MTU + 以太网头 + VLAN 标签）
+static constexpr size_t kMaxFrameSize = 1500 + kEthHeaderSize + 4;
+
+/// 分段卸载时的最大报文长度（64K IP 报文 + 以太网头 + VLAN 标签）
+static constexpr size_t kMaxGsoPacketSize = 65535 + kEthHeaderSize + 4;
+
+/// 每个接收缓冲区的大小（字节），不合并时可容纳报文头与一个完整的帧
+static constexpr size_t kRxBufferSize = 2048;
+
+/// 一个接收报文最多占用的缓冲区数量（合并接收时按最大 GSO 报文计算）
+static constexpr size_t kMaxRxSegments =
+    (sizeof(NetHdr) + kMaxGsoPacketSize + kRxBufferSize - 1) / kRxBufferSize;
+
+/**
+ * @brief 接收报文的一段数据
+ *
+ * 指向预先提交给设备的接收缓冲区，仅在接收回调期间有效。
+ */
+struct RxSegment {
+  /// 数据起始地址（CPU 可访问）
+  const uint8_t* data;
+  /// 数据长度（字节）
+  uint32_t len;
+};
+
+/**
+ * @brief 一个接收到的报文
+ *
+ * 零拷贝：各段直接指向 DMA 接收缓冲区，回调返回后缓冲区重新提交给
+ * 设备，调用者需要保留的数据须在回调中复制。
+ */
+struct RxPacket {
+  /// 设备写入的报文头，可检查 DATA_VALID/NEEDS_CSUM 与 GSO 信息
+  const NetHdr* header;
+  /// 报文数据（不含报文头），按顺序拼接即为完整的帧
+  std::array<RxSegment, kMaxRxSegments> segments;
+  /// segments 中的有效段数
+  size_t segment_count;
+  /// 帧的总长度（字节，不含报文头）
+  size_t length;
+};
+
+/**
+ * @brief virtio-net 统计数据
+ */
+struct NetStats {
+  /// 已接收的报文数
+  uint64_t rx_packets{0};
+  /// 已接收的字节数（不含报文头）
+  uint64_t rx_bytes{0};
+  /// 格式错误或缓冲区缺失而丢弃的接收报文数
+  uint64_t rx_dropped{0};
+  /// 由中断调度的接收轮询次数
+  uint64_t rx_polls{0};
+  /// 轮询结束后重新开启接收中断的次数
+  uint64_t rx_rearms{0};
+  /// 重新开启中断时发现新报文、继续轮询的次数
+  uint64_t rx_rearm_races{0};
+  /// 已发送（设备已回收）的报文数
+  uint64_t tx_packets{0};
+  /// 已发送的字节数（不含报文头）
+  uint64_t tx_bytes{0};
+  /// 发送队列满导致提交失败的次数
+  uint64_t tx_ring_full{0};
+  /// 借助 Event Index 省略的 Kick 次数
+  uint64_t kicks_elided{0};
+  /// 已处理的中断次数
+  uint64_t interrupts_handled{0};
+};
+
+}  // namespace virtio::net
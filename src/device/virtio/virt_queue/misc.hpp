@@ -33,6 +33,25 @@ namespace virtio {
   return value != 0 && (value & (value - 1)) == 0;
 }
 
+/**
+ * @brief 判断是否需要发送通知（处理 wrap-around）
+ *
+ * 基于 virtio 规范中的 vring_need_event 算法：检查 event_idx
+ * 是否落在 (old, new] 区间内（含 uint16_t 回绕处理）。
+ *
+ * @param event_idx 设备/驱动期望的通知阈值
+ * @param new_idx 当前索引
+ * @param old_idx 上次通知时的索引
+ * @return true 表示需要发送通知
+ * @see virtio-v1.2#2.7.10 Available Buffer Notification Suppression
+ */
+[[nodiscard]] constexpr auto VringNeedEvent(uint16_t event_idx,
+                                            uint16_t new_idx, uint16_t old_idx)
+    -> bool {
+  return static_cast<uint16_t>(new_idx - event_idx - 1) <
+         static_cast<uint16_t>(new_idx - old_idx);
+}
+
 /**
  * @brief Scatter-Gather IO 物理内存向量
  *
@@ -0,0 +1,685 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+#include <utility>
+
+#include "expected.hpp"
+#include "io_buffer.hpp"
+#include "virtio/defs.h"
+#include "virtio/virt_queue/misc.hpp"
+#include "virtio/virt_queue/virtqueue_base.hpp"
+
+namespace virtio {
+
+/**
+ * @brief Packed Virtqueue 管理类
+ *
+ * 实现 VIRTIO 1.1 引入的 packed virtqueue：驱动和设备共用一个描述符环，
+ * 通过描述符中的 AVAIL/USED 标志位与各自的回绕计数器交接所有权，
+ * 设备把已用描述符写回原位置。与 SplitVirtqueue 相比，一次请求只访问
+ * 连续的描述符，不再分别读写 Available Ring 和 Used Ring。
+ *
+ * 提供与 SplitVirtqueue 相同的链式接口（SubmitChain/SubmitIndirect/
+ * HasUsed/PopUsed/FreeChain），返回的是缓冲区 ID 而非描述符索引。
+ * 协商了 VIRTIO_F_IN_ORDER 时设备可以只为一批缓冲区写回最后一个
+ * 已用描述符，PopUsed 按提交顺序逐个返回整批缓冲区。
+ *
+ * 内存布局（在 DMA 缓冲区中连续排列）：
+ * ```
+ * [Descriptor Ring]           aligned to 16
+ * [Driver Event Suppression]  aligned to 4
+ * [Device Event Suppression]  aligned to 4
+ * [Buffer State]              仅驱动使用，设备不访问
+ * ```
+ *
+ * @warning 非线程安全：调用者必须使用外部同步机制。
+ *
+ * @see cpu_io::Wmb/Rmb for barrier semantics
+ * @see virtio-v1.2#2.8 Packed Virtqueues
+ */
+class PackedVirtqueue final : public VirtqueueBase {
+ public:
+  /// 使用此布局时需要协商的特性位，VIRTIO_F_IN_ORDER 为可选
+  static constexpr uint64_t kRingFeatures =
+      static_cast<uint64_t>(ReservedFeature::kRingPacked) |
+      static_cast<uint64_t>(ReservedFeature::kInOrder);
+
+  /// 队列大小上限（ring 索引只有 15 位）
+  static constexpr uint16_t kMaxSize = 0x8000;
+
+  /**
+   * @brief Descriptor Flags
+   * @see virtio-v1.2#2.8.1 Driver and Device Ring Wrap Counters
+   */
+  enum class DescFlags : uint16_t {
+    /// 标记缓冲区通过下一个描述符继续
+    kDescFNext = 1,
+    /// 标记缓冲区为设备只写(否则为设备只读)
+    kDescFWrite = 2,
+    /// 标记缓冲区包含描述符列表(间接描述符)
+    kDescFIndirect = 4,
+    /// 驱动写入：等于驱动回绕计数器时表示描述符可用
+    kDescFAvail = 1 << 7,
+    /// 设备写入：与 AVAIL 相等且等于回绕计数器时表示描述符已用
+    kDescFUsed = 1 << 15,
+  };
+
+  /**
+   * @brief Event Suppression Flags
+   * @see virtio-v1.2#2.8.10 Event Suppression Structure Format
+   */
+  enum class EventFlags : uint16_t {
+    /// 允许通知
+    kEnable = 0,
+    /// 禁止通知
+    kDisable = 1,
+    /// 仅在处理到 off_wrap 指定的描述符时通知（需要 VIRTIO_F_EVENT_IDX）
+    kDesc = 2,
+  };
+
+  /**
+   * @brief Packed 描述符
+   *
+   * 驱动提交时填写 addr/len/id/flags；设备用完后在同一位置写回
+   * 缓冲区 ID 和写入的字节数。
+   *
+   * @note 16 字节对齐
+   * @see virtio-v1.2#2.8.13 Packed Virtqueue Layout
+   */
+  struct [[gnu::packed]] Desc {
+    /// Descriptor Ring 对齐要求(字节)
+    static constexpr size_t kAlign = 16;
+    /// 缓冲区的客户机物理地址 (little-endian)
+    uint64_t addr;
+    /// 缓冲区长度；已用描述符中为设备写入的字节数 (little-endian)
+    uint32_t len;
+    /// 缓冲区 ID (little-endian)
+    uint16_t id;
+    /// 标志位: DescFlags (little-endian)
+    uint16_t flags;
+  };
+
+  /**
+   * @brief Event Suppression 结构
+   *
+   * Driver Area 中的结构由驱动写入，控制设备发送的已用缓冲区通知；
+   * Device Area 中的结构由设备写入，控制驱动发送的可用缓冲区通知。
+   *
+   * @note 4 字节对齐
+   * @see virtio-v1.2#2.8.10 Event Suppression Structure Format
+   */
+  struct [[gnu::packed]] EventSuppress {
+    /// Event Suppression 结构对齐要求(字节)
+    static constexpr size_t kAlign = 4;
+    /// bit 0-14: 描述符环偏移，bit 15: 回绕计数器 (little-endian)
+    uint16_t off_wrap;
+    /// 标志位: EventFlags (little-endian)
+    uint16_t flags;
+  };
+
+  /**
+   * @brief 已完成的缓冲区
+   *
+   * 与 SplitVirtqueue::UsedElem 字段一致，id 为缓冲区 ID。
+   */
+  struct UsedElem {
+    /// 缓冲区 ID
+    uint32_t id;
+    /// 设备写入缓冲区的总字节数
+    uint32_t len;
+  };
+
+  /**
+   * @brief 计算给定队列大小所需的 DMA 内存字节数
+   *
+   * @param queue_size 队列大小（1 ~ kMaxSize）
+   * @param event_idx 是否启用 VIRTIO_F_EVENT_IDX 特性（packed 布局中
+   *        Event Suppression 结构始终存在，不影响大小）
+   * @return 所需的 DMA 内存字节数
+   * @see virtio-v1.2#2.8.13 Packed Virtqueue Layout
+   */
+  [[nodiscard]] static constexpr auto CalcSize(
+      uint16_t queue_size, [[maybe_unused]] bool event_idx = true) -> size_t {
+    return StateOffset(queue_size) + sizeof(BufferState) * queue_size;
+  }
+
+  /**
+   * @brief 从预分配的 DMA 缓冲区构造 PackedVirtqueue
+   *
+   * @param dma DMA 区域描述符（必须已清零，大小 >= CalcSize()）
+   * @param queue_size 队列大小（1 ~ kMaxSize）
+   * @param event_idx 是否启用 VIRTIO_F_EVENT_IDX 特性
+   * @param in_order 是否协商了 VIRTIO_F_IN_ORDER
+   * @see virtio-v1.2#2.8
+   */
+  PackedVirtqueue(const DmaRegion& dma, uint16_t queue_size, bool event_idx,
+                  bool in_order = false)
+      : queue_size_(queue_size),
+        phys_base_(dma.phys),
+        event_idx_enabled_(event_idx),
+        in_order_(in_order) {
+    if (!dma.IsValid() || queue_size == 0 || queue_size > kMaxSize ||
+        dma.size < CalcSize(queue_size, event_idx)) {
+      return;
+    }
+
+    auto* base = dma.Data();
+    desc_ = reinterpret_cast<volatile Desc*>(base);
+    driver_event_ = reinterpret_cast<volatile EventSuppress*>(
+        base + DriverEventOffset(queue_size));
+    device_event_ = reinterpret_cast<volatile EventSuppress*>(
+        base + DeviceEventOffset(queue_size));
+    state_ = reinterpret_cast<BufferState*>(base + StateOffset(queue_size));
+
+    // 缓冲区 ID 空闲链表
+    for (uint16_t i = 0; i < queue_size; ++i) {
+      state_[i].num = 0;
+      state_[i].next = static_cast<uint16_t>(i + 1);
+      state_[i].next_submitted = kNoId;
+    }
+    state_[queue_size - 1].next = kNoId;
+    free_id_ = 0;
+    num_free_ = queue_size;
+
+    is_valid_ = true;
+  }
+
+  /**
+   * @brief 检查 virtqueue 是否成功初始化
+   */
+  [[nodiscard]] auto IsValid() const -> bool { return is_valid_; }
+
+  /**
+   * @brief 检查是否有已完成的缓冲区
+   *
+   * 下一个待回收位置的 AVAIL 与 USED 标志位相等且等于驱动的
+   * Used 回绕计数器时，该描述符已被设备写回。
+   *
+   * @return true 表示有已完成的缓冲区可用，false 表示没有
+   * @see virtio-v1.2#2.8.14 Receiving Used Buffers From The Device
+   */
+  [[nodiscard]] auto HasUsed() const -> bool {
+    if (batch_last_ != kNoId) {
+      return true;
+    }
+    uint16_t flags = desc_[last_used_idx_].flags;
+    bool avail = (flags & std::to_underlying(DescFlags::kDescFAvail)) != 0;
+    bool used = (flags & std::to_underlying(DescFlags::kDescFUsed)) != 0;
+    return avail == used && used == used_wrap_counter_;
+  }
+
+  /**
+   * @brief 弹出一个已完成的缓冲区
+   *
+   * 协商了 VIRTIO_F_IN_ORDER 时，一个已用描述符代表提交顺序中截至其
+   * 缓冲区 ID 的整批缓冲区，批内先完成的缓冲区 len 为 0。
+   *
+   * @return 成功返回 UsedElem{id, len}；
+   *         无可用元素时返回 ErrorCode::kNoUsedBuffers
+   *
+   * @warning 非线程安全
+   * @see virtio-v1.2#2.8.14 Receiving Used Buffers From The Device
+   * @see virtio-v1.2#2.8.9 In-order use of descriptors
+   */
+  [[nodiscard]] auto PopUsed() -> Expected<UsedElem> {
+    if (!HasUsed()) {
+      return std::unexpected(Error{ErrorCode::kNoUsedBuffers});
+    }
+
+    if (in_order_) {
+      if (batch_last_ == kNoId) {
+        // 读屏障：标志位之后再读取 id/len
+        cpu_io::Rmb();
+        batch_last_ = desc_[last_used_idx_].id;
+        batch_len_ = desc_[last_used_idx_].len;
+      }
+      // 按提交顺序取出最早的在途缓冲区
+      uint16_t id = in_order_head_;
+      if (id >= queue_size_ || state_[id].num == 0) {
+        batch_last_ = kNoId;
+        return std::unexpected(Error{ErrorCode::kInvalidDescriptor});
+      }
+      in_order_head_ = state_[id].next_submitted;
+      AdvanceUsed(state_[id].num);
+      if (id != batch_last_) {
+        return UsedElem{id, 0};
+      }
+      batch_last_ = kNoId;
+      return UsedElem{id, batch_len_};
+    }
+
+    // 读屏障：标志位之后再读取 id/len
+    cpu_io::Rmb();
+    uint16_t id = desc_[last_used_idx_].id;
+    uint32_t len = desc_[last_used_idx_].len;
+    if (id >= queue_size_ || state_[id].num == 0) {
+      return std::unexpected(Error{ErrorCode::kInvalidDescriptor});
+    }
+    AdvanceUsed(state_[id].num);
+    return UsedElem{id, len};
+  }
+
+  /**
+   * @brief 提交 Scatter-Gather 描述符链
+   *
+   * 按顺序把 readable（设备只读）和 writable（设备可写）缓冲区写入
+   * 连续的环位置，最后写入链头的标志位，使整条链一次对设备可见。
+   *
+   * @param readable 设备只读缓冲区数组（如请求头、写入数据）
+   * @param readable_count readable 数组中的元素数量
+   * @param writable 设备可写缓冲区数组（如读取数据、状态字节）
+   * @param writable_count writable 数组中的元素数量
+   * @return 成功返回缓冲区 ID（可用作 token）；失败返回错误
+   *
+   * @pre readable_count + writable_count > 0
+   * @pre readable_count + writable_count <= NumFree()
+   * @post 描述符链已对设备可见，调用者仍需通知设备
+   *
+   * @warning 非线程安全
+   * @see virtio-v1.2#2.8.21 Supplying Buffers to The Device
+   */
+  [[nodiscard]] auto SubmitChain(const IoVec* readable, size_t readable_count,
+                                 const IoVec* writable, size_t writable_count)
+      -> Expected<uint16_t> {
+    size_t total = readable_count + writable_count;
+    if (total == 0) {
+      return std::unexpected(Error{ErrorCode::kInvalidArgument});
+    }
+    if (total > num_free_ || free_id_ == kNoId) {
+      return std::unexpected(Error{ErrorCode::kNoFreeDescriptors});
+    }
+
+    uint16_t id = free_id_;
+    free_id_ = state_[id].next;
+
+    uint16_t head = next_avail_idx_;
+    uint16_t head_flags = 0;
+    uint16_t idx = head;
+    bool wrap = avail_wrap_counter_;
+    for (size_t i = 0; i < total; ++i) {
+      bool is_write = i >= readable_count;
+      const IoVec& iov = is_write ? writable[i - readable_count] : readable[i];
+      uint16_t flags = AvailUsedFlags(wrap);
+      if (i + 1 < total) {
+        flags |= std::to_underlying(DescFlags::kDescFNext);
+      }
+      if (is_write) {
+        flags |= std::to_underlying(DescFlags::kDescFWrite);
+      }
+
+      desc_[idx].addr = iov.phys_addr;
+      desc_[idx].len = static_cast<uint32_t>(iov.len);
+      desc_[idx].id = id;
+      if (i == 0) {
+        head_flags = flags;
+      } else {
+        desc_[idx].flags = flags;
+      }
+
+      if (++idx == queue_size_) {
+        idx = 0;
+        wrap = !wrap;
+      }
+    }
+
+    next_avail_idx_ = idx;
+    avail_wrap_counter_ = wrap;
+    Publish(id, head, head_flags, static_cast<uint16_t>(total));
+
+    return id;
+  }
+
+  /**
+   * @brief 通过间接描述符表提交 Scatter-Gather 请求
+   *
+   * 将 readable/writable 缓冲区按顺序写入调用者提供的间接描述符表，
+   * 环上只写入一个带 kDescFIndirect 标志、指向该表的描述符。
+   * 表项按顺序排列，不使用 kDescFNext。
+   *
+   * @param readable 设备只读缓冲区数组
+   * @param readable_count readable 数组中的元素数量
+   * @param writable 设备可写缓冲区数组
+   * @param writable_count writable 数组中的元素数量
+   * @param table 间接描述符表所在的 DMA 区域（16 字节对齐）
+   * @return 成功返回缓冲区 ID（可用作 token）；失败返回错误
+   *
+   * @pre 已协商 VIRTIO_F_INDIRECT_DESC
+   * @pre readable_count + writable_count 不超过 table 可容纳的描述符数
+   * @post 表在 FreeChain() 之前不得修改
+   *
+   * @warning 非线程安全
+   * @see virtio-v1.2#2.8.19 Indirect Flag: Scatter-Gather Support
+   */
+  [[nodiscard]] auto SubmitIndirect(const IoVec* readable,
+                                    size_t readable_count,
+                                    const IoVec* writable,
+                                    size_t writable_count,
+                                    const DmaRegion& table)
+      -> Expected<uint16_t> {
+    size_t total = readable_count + writable_count;
+    if (total == 0 || total * sizeof(Desc) > table.size) {
+      return std::unexpected(Error{ErrorCode::kInvalidArgument});
+    }
+    if (num_free_ == 0 || free_id_ == kNoId) {
+      return std::unexpected(Error{ErrorCode::kNoFreeDescriptors});
+    }
+
+    uint16_t id = free_id_;
+    free_id_ = state_[id].next;
+
+    auto* entries = reinterpret_cast<volatile Desc*>(table.Data());
+    for (size_t i = 0; i < total; ++i) {
+      bool is_write = i >= readable_count;
+      const IoVec& iov = is_write ? writable[i - readable_count] : readable[i];
+      entries[i].addr = iov.phys_addr;
+      entries[i].len = static_cast<uint32_t>(iov.len);
+      entries[i].id = 0;
+      entries[i].flags =
+          is_write ? std::to_underlying(DescFlags::kDescFWrite) : 0;
+    }
+
+    uint16_t head = next_avail_idx_;
+    desc_[head].addr = table.phys;
+    desc_[head].len = static_cast<uint32_t>(total * sizeof(Desc));
+    desc_[head].id = id;
+    uint16_t head_flags = AvailUsedFlags(avail_wrap_counter_) |
+                          std::to_underlying(DescFlags::kDescFIndirect);
+    if (++next_avail_idx_ == queue_size_) {
+      next_avail_idx_ = 0;
+      avail_wrap_counter_ = !avail_wrap_counter_;
+    }
+    Publish(id, head, head_flags, 1);
+
+    return id;
+  }
+
+  /**
+   * @brief 释放缓冲区占用的描述符和 ID
+   *
+   * @param id PopUsed() 返回的缓冲区 ID
+   * @return 成功或失败（如 id 无效）
+   *
+   * @warning 非线程安全
+   */
+  auto FreeChain(uint16_t id) -> Expected<void> {
+    if (id >= queue_size_ || state_[id].num == 0) {
+      return std::unexpected(Error{ErrorCode::kInvalidDescriptor});
+    }
+    num_free_ += state_[id].num;
+    state_[id].num = 0;
+    state_[id].next = free_id_;
+    free_id_ = id;
+    return {};
+  }
+
+  /**
+   * @brief 判断提交后是否需要通知设备
+   *
+   * 根据设备写入的 Device Event Suppression 结构决定：DISABLE 时不通知，
+   * DESC 时仅当本次提交越过设备指定的位置才通知。
+   *
+   * @return true 表示需要调用 Transport::NotifyQueue()
+   * @see virtio-v1.2#2.8.22 Notifying The Device
+   */
+  [[nodiscard]] auto KickPrepare() -> bool {
+    // 全屏障：描述符写入先于读取设备的 Event Suppression 结构
+    cpu_io::Mb();
+
+    auto new_idx = next_avail_idx_;
+    auto old_idx = static_cast<uint16_t>(new_idx - num_added_);
+    num_added_ = 0;
+
+    uint16_t flags = device_event_->flags;
+    if (flags != std::to_underlying(EventFlags::kDesc)) {
+      return flags != std::to_underlying(EventFlags::kDisable);
+    }
+    uint16_t off_wrap = device_event_->off_wrap;
+    auto event_idx = static_cast<uint16_t>(off_wrap & kOffMask);
+    bool wrap = (off_wrap & kWrapBit) != 0;
+    if (wrap != avail_wrap_counter_) {
+      event_idx = static_cast<uint16_t>(event_idx - queue_size_);
+    }
+    return VringNeedEvent(event_idx, new_idx, old_idx);
+  }
+
+  /**
+   * @brief 开启或抑制设备的已用缓冲区通知
+   *
+   * 开启时，协商了 VIRTIO_F_EVENT_IDX 则请求设备写回下一个待回收位置
+   * 时通知，否则允许所有通知；抑制时设置 DISABLE。
+   *
+   * @param enable false 表示请求设备不发送中断
+   * @see virtio-v1.2#2.8.10 Event Suppression Structure Format
+   */
+  auto SetUsedNotify(bool enable) -> void {
+    if (!enable) {
+      driver_event_->flags = std::to_underlying(EventFlags::kDisable);
+    } else if (event_idx_enabled_) {
+      driver_event_->off_wrap = static_cast<uint16_t>(
+          last_used_idx_ | (used_wrap_counter_ ? kWrapBit : 0));
+      cpu_io::Wmb();
+      driver_event_->flags = std::to_underlying(EventFlags::kDesc);
+    } else {
+      driver_event_->flags = std::to_underlying(EventFlags::kEnable);
+    }
+  }
+
+  /**
+   * @brief 获取描述符环的物理地址
+   * @see virtio-v1.2#2.8.13
+   */
+  [[nodiscard]] auto DescPhys() const -> uint64_t { return phys_base_; }
+
+  /**
+   * @brief 获取 Driver Area（Driver Event Suppression）的物理地址
+   *
+   * 与 SplitVirtqueue::AvailPhys() 写入同一组传输层寄存器。
+   */
+  [[nodiscard]] auto AvailPhys() const -> uint64_t {
+    return phys_base_ + DriverEventOffset(queue_size_);
+  }
+
+  /**
+   * @brief 获取 Device Area（Device Event Suppression）的物理地址
+   *
+   * 与 SplitVirtqueue::UsedPhys() 写入同一组传输层寄存器。
+   */
+  [[nodiscard]] auto UsedPhys() const -> uint64_t {
+    return phys_base_ + DeviceEventOffset(queue_size_);
+  }
+
+  /**
+   * @brief 获取队列大小
+   */
+  [[nodiscard]] auto Size() const -> uint16_t { return queue_size_; }
+
+  /**
+   * @brief 获取当前空闲描述符数量
+   */
+  [[nodiscard]] auto NumFree() const -> uint16_t { return num_free_; }
+
+  /**
+   * @brief 检查是否启用了 VIRTIO_F_EVENT_IDX 特性
+   */
+  [[nodiscard]] auto EventIdxEnabled() const -> bool {
+    return event_idx_enabled_;
+  }
+
+  /**
+   * @brief 检查是否按 VIRTIO_F_IN_ORDER 回收缓冲区
+   */
+  [[nodiscard]] auto InOrder() const -> bool { return in_order_; }
+
+  /// @name 构造/析构函数
+  /// @{
+  PackedVirtqueue(const PackedVirtqueue&) = delete;
+  auto operator=(const PackedVirtqueue&) -> PackedVirtqueue& = delete;
+  auto operator=(PackedVirtqueue&&) -> PackedVirtqueue& = delete;
+  PackedVirtqueue(PackedVirtqueue&& other) noexcept
+      : VirtqueueBase(std::move(other)),
+        desc_(other.desc_),
+        driver_event_(other.driver_event_),
+        device_event_(other.device_event_),
+        state_(other.state_),
+        queue_size_(other.queue_size_),
+        next_avail_idx_(other.next_avail_idx_),
+        last_used_idx_(other.last_used_idx_),
+        num_free_(other.num_free_),
+        num_added_(other.num_added_),
+        free_id_(other.free_id_),
+        in_order_head_(other.in_order_head_),
+        in_order_tail_(other.in_order_tail_),
+        batch_last_(other.batch_last_),
+        batch_len_(other.batch_len_),
+        phys_base_(other.phys_base_),
+        avail_wrap_counter_(other.avail_wrap_counter_),
+        used_wrap_counter_(other.used_wrap_counter_),
+        event_idx_enabled_(other.event_idx_enabled_),
+        in_order_(other.in_order_),
+        is_valid_(other.is_valid_) {
+    other.is_valid_ = false;
+    other.desc_ = nullptr;
+    other.driver_event_ = nullptr;
+    other.device_event_ = nullptr;
+    other.state_ = nullptr;
+  }
+  ~PackedVirtqueue() = default;
+  /// @}
+
+ private:
+  /**
+   * @brief 每个缓冲区 ID 的驱动私有状态
+   *
+   * 位于 DMA 缓冲区末尾，设备不访问。
+   */
+  struct BufferState {
+    /// 缓冲区占用的描述符数，0 表示 ID 空闲
+    uint16_t num;
+    /// 空闲 ID 链表中的下一个 ID
+    uint16_t next;
+    /// 提交顺序链表中的下一个 ID（仅 VIRTIO_F_IN_ORDER）
+    uint16_t next_submitted;
+  };
+
+  /// 无效缓冲区 ID
+  static constexpr uint16_t kNoId = 0xFFFF;
+  /// off_wrap 中的回绕计数器位
+  static constexpr uint16_t kWrapBit = 0x8000;
+  /// off_wrap 中的偏移掩码
+  static constexpr uint16_t kOffMask = 0x7FFF;
+
+  [[nodiscard]] static constexpr auto DriverEventOffset(uint16_t queue_size)
+      -> size_t {
+    return AlignUp(sizeof(Desc) * queue_size, EventSuppress::kAlign);
+  }
+
+  [[nodiscard]] static constexpr auto DeviceEventOffset(uint16_t queue_size)
+      -> size_t {
+    return DriverEventOffset(queue_size) + sizeof(EventSuppress);
+  }
+
+  [[nodiscard]] static constexpr auto StateOffset(uint16_t queue_size)
+      -> size_t {
+    return AlignUp(DeviceEventOffset(queue_size) + sizeof(EventSuppress),
+                   alignof(BufferState));
+  }
+
+  /**
+   * @brief 按回绕计数器生成可用描述符的 AVAIL/USED 标志位
+   *
+   * AVAIL 等于回绕计数器，USED 与其相反。
+   */
+  [[nodiscard]] static auto AvailUsedFlags(bool wrap) -> uint16_t {
+    return wrap ? std::to_underlying(DescFlags::kDescFAvail)
+                : std::to_underlying(DescFlags::kDescFUsed);
+  }
+
+  /**
+   * @brief 记录缓冲区状态并把链头交给设备
+   *
+   * @param id 缓冲区 ID
+   * @param head 链头所在的环位置
+   * @param head_flags 链头的标志位
+   * @param num 缓冲区占用的环描述符数
+   */
+  auto Publish(uint16_t id, uint16_t head, uint16_t head_flags, uint16_t num)
+      -> void {
+    state_[id].num = num;
+    if (in_order_) {
+      // 追加到提交顺序链表尾部
+      state_[id].next_submitted = kNoId;
+      if (in_order_head_ == kNoId) {
+        in_order_head_ = id;
+      } else {
+        state_[in_order_tail_].next_submitted = id;
+      }
+      in_order_tail_ = id;
+    }
+    num_free_ -= num;
+    num_added_ += num;
+
+    // 写屏障：其余描述符写入在链头标志位之前对设备可见
+    cpu_io::Wmb();
+    desc_[head].flags = head_flags;
+  }
+
+  /**
+   * @brief 跳过一个已用缓冲区占用的环位置
+   *
+   * @param num 缓冲区占用的描述符数
+   */
+  auto AdvanceUsed(uint16_t num) -> void {
+    last_used_idx_ = static_cast<uint16_t>(last_used_idx_ + num);
+    if (last_used_idx_ >= queue_size_) {
+      last_used_idx_ = static_cast<uint16_t>(last_used_idx_ - queue_size_);
+      used_wrap_counter_ = !used_wrap_counter_;
+    }
+  }
+
+  /// 描述符环指针（指向 DMA 内存）
+  volatile Desc* desc_ = nullptr;
+  /// Driver Event Suppression 指针（驱动写，设备读）
+  volatile EventSuppress* driver_event_ = nullptr;
+  /// Device Event Suppression 指针（设备写，驱动读）
+  volatile EventSuppress* device_event_ = nullptr;
+  /// 缓冲区状态数组（queue_size 项）
+  BufferState* state_ = nullptr;
+
+  /// 队列大小（描述符数量）
+  uint16_t queue_size_{0};
+  /// 下一个提交位置
+  uint16_t next_avail_idx_{0};
+  /// 下一个待回收位置
+  uint16_t last_used_idx_{0};
+  /// 空闲描述符数量
+  uint16_t num_free_{0};
+  /// 上次 KickPrepare() 之后提交的描述符数
+  uint16_t num_added_{0};
+  /// 空闲缓冲区 ID 链表头
+  uint16_t free_id_{kNoId};
+  /// 提交顺序链表头尾，即最早和最晚提交的在途 ID（仅 VIRTIO_F_IN_ORDER）
+  uint16_t in_order_head_{kNoId};
+  uint16_t in_order_tail_{kNoId};
+  /// 正在逐个返回的批次中最后一个缓冲区 ID（仅 VIRTIO_F_IN_ORDER）
+  uint16_t batch_last_{kNoId};
+  /// 批次的已用描述符中的 len
+  uint32_t batch_len_{0};
+
+  /// DMA 内存物理基地址（客户机物理地址）
+  uint64_t phys_base_{0};
+  /// 驱动回绕计数器，初值为 1
+  bool avail_wrap_counter_{true};
+  /// 已用描述符的回绕计数器，初值为 1
+  bool used_wrap_counter_{true};
+  /// 是否启用 VIRTIO_F_EVENT_IDX 特性
+  bool event_idx_enabled_{false};
+  /// 是否协商了 VIRTIO_F_IN_ORDER
+  bool in_order_{false};
+  /// 初始化是否成功
+  bool is_valid_{false};
+};
+
+}  // namespace virtio
@@ -37,6 +37,9 @@ namespace virtio {
  */
 class SplitVirtqueue final : public VirtqueueBase {
  public:
+  /// 使用此布局时需要协商的特性位
+  static constexpr uint64_t kRingFeatures = 0;
+
   /**
    * @brief Descriptor Flags
    * @see virtio-v1.2#2.7.5 The Virtqueue Descriptor Table
@@ -512,6 +515,74 @@ class SplitVirtqueue final : public VirtqueueBase {
     return head;
   }
 
+  /**
+   * @brief 通过间接描述符表提交 Scatter-Gather 请求
+   *
+   * 将 readable/writable 缓冲区按 SubmitChain 的顺序写入调用者提供的
+   * 间接描述符表，再用一个带 kDescFIndirect 标志的描述符指向该表，
+   * 无论缓冲区多少都只占用一个环描述符。
+   *
+   * @param readable 设备只读缓冲区数组
+   * @param readable_count readable 数组中的元素数量
+   * @param writable 设备可写缓冲区数组
+   * @param writable_count writable 数组中的元素数量
+   * @param table 间接描述符表所在的 DMA 区域（16 字节对齐）
+   * @return 成功返回描述符索引（可用作 token）；失败返回错误
+   *
+   * @pre 已协商 VIRTIO_F_INDIRECT_DESC
+   * @pre readable_count + writable_count 不超过 table 可容纳的描述符数
+   *      和队列大小
+   * @post 表在 FreeChain() 之前不得修改
+   *
+   * @warning 非线程安全
+   * @see virtio-v1.2#2.7.5.3 Indirect Descriptors
+   */
+  [[nodiscard]] auto SubmitIndirect(const IoVec* readable,
+                                    size_t readable_count,
+                                    const IoVec* writable,
+                                    size_t writable_count,
+                                    const DmaRegion& table)
+      -> Expected<uint16_t> {
+    size_t total = readable_count + writable_count;
+    if (total == 0 || total > queue_size_ ||
+        total * sizeof(Desc) > table.size) {
+      return std::unexpected(Error{ErrorCode::kInvalidArgument});
+    }
+    auto head_result = AllocDesc();
+    if (!head_result) {
+      return std::unexpected(head_result.error());
+    }
+    uint16_t head = *head_result;
+
+    auto* entries = reinterpret_cast<volatile Desc*>(table.Data());
+    for (size_t i = 0; i < total; ++i) {
+      bool is_write = i >= readable_count;
+      const IoVec& iov = is_write ? writable[i - readable_count] : readable[i];
+      uint16_t flags = 0;
+      if (i + 1 < total) {
+        flags |= std::to_underlying(DescFlags::kDescFNext);
+      }
+      if (is_write) {
+        flags |= std::to_underlying(DescFlags::kDescFWrite);
+      }
+      entries[i].addr = iov.phys_addr;
+      entries[i].len = static_cast<uint32_t>(iov.len);
+      entries[i].flags = flags;
+      entries[i].next = static_cast<uint16_t>(i + 1);
+    }
+
+    desc_[head].addr = table.phys;
+    desc_[head].len = static_cast<uint32_t>(total * sizeof(Desc));
+    desc_[head].flags = std::to_underlying(DescFlags::kDescFIndirect);
+
+    // 写屏障：确保间接表和描述符写入在 Available Ring 更新之前对设备可见
+    cpu_io::Wmb();
+
+    Submit(head);
+
+    return head;
+  }
+
   /**
    * @brief 释放整条描述符链
    *
@@ -624,6 +695,66 @@ class SplitVirtqueue final : public VirtqueueBase {
     return event_idx_enabled_;
   }
 
+  /**
+   * @brief 设置或清除 Available Ring 的 NO_INTERRUPT 标志
+   *
+   * 未启用 EVENT_IDX 时用于抑制设备的完成中断；启用后设备忽略此标志，
+   * 应改写 used_event 字段。
+   *
+   * @param suppress true 表示请求设备不发送中断
+   * @see virtio-v1.2#2.7.7 Used Buffer Notification Suppression
+   */
+  auto SetNoInterrupt(bool suppress) -> void {
+    auto flag = std::to_underlying(AvailFlags::kAvailFNoInterrupt);
+    avail_->flags = suppress ? static_cast<uint16_t>(avail_->flags | flag)
+                             : static_cast<uint16_t>(avail_->flags & ~flag);
+  }
+
+  /**
+   * @brief 判断提交后是否需要通知设备
+   *
+   * 协商了 VIRTIO_F_EVENT_IDX 时，仅当上次调用以来提交的请求越过
+   * avail_event 才通知；否则遵循 Used Ring 的 NO_NOTIFY 标志。
+   *
+   * @return true 表示需要调用 Transport::NotifyQueue()
+   * @see virtio-v1.2#2.7.10 Available Buffer Notification Suppression
+   */
+  [[nodiscard]] auto KickPrepare() -> bool {
+    // 全屏障：avail idx 写入先于读取设备的通知抑制字段
+    cpu_io::Mb();
+
+    uint16_t new_idx = avail_->idx;
+    uint16_t old_idx = kick_avail_idx_;
+    kick_avail_idx_ = new_idx;
+
+    if (event_idx_enabled_) {
+      return VringNeedEvent(*used_->avail_event(queue_size_), new_idx,
+                            old_idx);
+    }
+    return (used_->flags & std::to_underlying(UsedFlags::kUsedFNoNotify)) ==
+           0;
+  }
+
+  /**
+   * @brief 开启或抑制设备的已用缓冲区通知
+   *
+   * 协商了 VIRTIO_F_EVENT_IDX 时改写 used_event：开启时设为
+   * LastUsedIdx()，抑制时设到 kUsedEventFar 之外；否则切换
+   * NO_INTERRUPT 标志。
+   *
+   * @param enable false 表示请求设备不发送中断
+   * @see virtio-v1.2#2.7.7 Used Buffer Notification Suppression
+   */
+  auto SetUsedNotify(bool enable) -> void {
+    if (event_idx_enabled_) {
+      *avail_->used_event(queue_size_) =
+          enable ? last_used_idx_
+                 : static_cast<uint16_t>(last_used_idx_ + kUsedEventFar);
+    } else {
+      SetNoInterrupt(!enable);
+    }
+  }
+
   /**
    * @brief 获取当前 Available Ring 索引
    */
@@ -648,6 +779,7 @@ class SplitVirtqueue final : public VirtqueueBase {
         free_head_(other.free_head_),
         num_free_(other.num_free_),
         last_used_idx_(other.last_used_idx_),
+        kick_avail_idx_(other.kick_avail_idx_),
         phys_base_(other.phys_base_),
         desc_offset_(other.desc_offset_),
         avail_offset_(other.avail_offset_),
@@ -663,6 +795,9 @@ class SplitVirtqueue final : public VirtqueueBase {
   /// @}
 
  private:
+  /// 抑制通知时 used_event 相对 LastUsedIdx 的偏移，设备在此之前不发送中断
+  static constexpr uint16_t kUsedEventFar = 0x8000;
+
   /// 描述符表指针（指向 DMA 内存）
   volatile Desc* desc_ = nullptr;
   /// Available Ring 指针（指向 DMA 内存）
@@ -678,6 +813,8 @@ class SplitVirtqueue final : public VirtqueueBase {
   uint16_t num_free_{0};
   /// 上次处理到的 Used Ring 索引（用于 PopUsed）
   uint16_t last_used_idx_{0};
+  /// 上次 KickPrepare() 时的 avail idx（用于 Event Index 通知抑制）
+  uint16_t kick_avail_idx_{0};
 
   /// DMA 内存物理基地址（客户机物理地址）
   uint64_t phys_base_{0};
@@ -21,20 +21,26 @@ namespace virtio {
  * 派生类的具体实现，零虚表开销，无需传统 CRTP 的 static_cast。
  *
  * 派生类应提供以下方法（隐式接口）：
+ * - kRingFeatures：使用该布局需要协商的特性位
+ * - CalcSize(uint16_t queue_size, bool event_idx) -> size_t
  * - IsValid() const -> bool
  * - Size() const -> uint16_t
  * - NumFree() const -> uint16_t
- * - AllocDesc() -> Expected<uint16_t>
- * - FreeDesc(uint16_t) -> Expected<void>
- * - Submit(uint16_t head) -> void
  * - HasUsed() const -> bool
  * - PopUsed() -> Expected<UsedElem>
  * - SubmitChain(const IoVec*, size_t, const IoVec*, size_t)
  *     -> Expected<uint16_t>
+ * - SubmitIndirect(const IoVec*, size_t, const IoVec*, size_t,
+ *     const DmaRegion& table) -> Expected<uint16_t>
  * - FreeChain(uint16_t head) -> Expected<void>
+ * - KickPrepare() -> bool
+ * - SetUsedNotify(bool enable) -> void
+ * - EventIdxEnabled() const -> bool
  * - DescPhys() const -> uint64_t
- * - AvailPhys() const -> uint64_t
- * - UsedPhys() const -> uint64_t
+ * - AvailPhys() const -> uint64_t（Driver Area）
+ * - UsedPhys() const -> uint64_t（Device Area）
+ *
+ * SplitVirtqueue 另外提供 AllocDesc/FreeDesc/Submit 等单描述符接口。
  *
  * @see cpu_io::Wmb/Rmb for barrier semantics
  * @see virtio-v1.2#2.7 / #2.8
@@ -6,17 +6,221 @@
 
 #include <etl/io_port.h>
 
+#include <algorithm>
 #include <utility>
 
+#include "arch.h"
+#include "basic_info.hpp"
 #include "expected.hpp"
 #include "io_buffer.hpp"
+#include "kernel_config.hpp"
 #include "kernel_log.hpp"
+#include "kstd_memory"
+#include "task_control_block.hpp"
+#include "task_manager.hpp"
 #include "virtio/transport/mmio.hpp"
 
 auto VirtioDriver::MatchStatic([[maybe_unused]] DeviceNode& node) -> bool {
   return node.mmio_base != 0 && node.mmio_size != 0;
 }
 
+auto VirtioDriver::GetBlkQueueCount() -> uint16_t {
+  if (!BasicInfoSingleton::is_valid()) {
+    return kDefaultQueueCount;
+  }
+  return static_cast<uint16_t>(
+      std::clamp<size_t>(BasicInfoSingleton::instance().core_count,
+                         kDefaultQueueCount, SplitBlk::kMaxQueues));
+}
+
+template <typename BlkT>
+auto VirtioDriver::ProbeBlk(DeviceNode& node, uint64_t base) -> Expected<void> {
+  if (blk_device_count_ >= kMaxBlkDevices) {
+    klog::Warn("VirtioDriver: blk device pool full, device at {:#x} skipped",
+               base);
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  }
+  const size_t idx = blk_device_count_;
+
+  // 每个核心一个队列，设备支持的数量在 Create() 中协商
+  const auto queue_count = GetBlkQueueCount();
+  const size_t dma_size = std::max(
+      kMinDmaBufferSize,
+      BlkT::GetRequiredVqMemSize(queue_count, kDefaultQueueSize).first);
+
+  // 分配 DMA buffer
+  dma_buffers_[idx] = kstd::make_unique<IoBuffer>(dma_size);
+  if (!dma_buffers_[idx] || !dma_buffers_[idx]->IsValid() ||
+      dma_buffers_[idx]->GetBuffer().size() < dma_size) {
+    klog::Err("VirtioDriver: failed to allocate DMA buffer at {:#x}", base);
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  }
+
+  // Allocate slot DMA buffer
+  auto [slot_size, slot_align] = BlkT::GetRequiredSlotMemSize(queue_count);
+  slot_buffers_[idx] = kstd::make_unique<IoBuffer>(slot_size);
+  if (!slot_buffers_[idx] || !slot_buffers_[idx]->IsValid()) {
+    klog::Err("VirtioDriver: failed to allocate slot DMA buffer at {:#x}",
+              base);
+    dma_buffers_[idx].reset();
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  }
+
+  uint64_t extra_features =
+      static_cast<uint64_t>(virtio::blk::BlkFeatureBit::kSegMax) |
+      static_cast<uint64_t>(virtio::blk::BlkFeatureBit::kSizeMax) |
+      static_cast<uint64_t>(virtio::blk::BlkFeatureBit::kBlkSize) |
+      static_cast<uint64_t>(virtio::blk::BlkFeatureBit::kFlush) |
+      static_cast<uint64_t>(virtio::blk::BlkFeatureBit::kGeometry);
+
+  auto vq_dma = dma_buffers_[idx]->ToDmaRegion();
+  auto slot_dma = slot_buffers_[idx]->ToDmaRegion();
+
+  auto result =
+      BlkT::Create(base, vq_dma, slot_dma, IdentityVirtToPhys, queue_count,
+                   kDefaultQueueSize, extra_features);
+  if (!result.has_value()) {
+    klog::Err("VirtioDriver: VirtioBlk Create failed at {:#x}", base);
+    dma_buffers_[idx].reset();
+    slot_buffers_[idx].reset();
+    return std::unexpected(Error(result.error().code));
+  }
+
+  auto& device = blk_devices_[idx].template emplace<BlkT>(std::move(*result));
+  // 统计请求完成延迟；混合轮询按内核配置开启
+  device.SetTimestampSource(ReadTimestamp);
+  device.SetHybridPoll(kernel::config::kVirtioBlkHybridPoll);
+  node.type = DeviceType::kBlock;
+  irqs_[idx] = node.irq;
+
+  // Register adapter in pool and expose via DeviceNode.
+  if (blk_adapter_count_ < kMaxBlkDevices) {
+    const auto adapter_idx = static_cast<uint32_t>(blk_adapter_count_);
+    node.block_device =
+        &blk_adapters_[blk_adapter_count_]
+             .template emplace<virtio::blk::VirtioBlkVfsAdapter<BlkT>>(
+                 &device, adapter_idx);
+    ++blk_adapter_count_;
+  } else {
+    klog::Warn("VirtioDriver: blk adapter pool full, device at {:#x} skipped",
+               base);
+  }
+
+  ++blk_device_count_;
+  klog::Info(
+      "VirtioDriver: block device at {:#x}, capacity={} sectors, "
+      "queues={}, irq={}",
+      base, device.GetCapacity(), device.GetQueueCount(), irqs_[idx]);
+  return {};
+}
+
+auto VirtioDriver::ProbeNet(DeviceNode& node, uint64_t base) -> Expected<void> {
+  if (net_device_count_ >= kMaxNetDevices) {
+    klog::Warn("VirtioDriver: net device pool full, device at {:#x} skipped",
+               base);
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  }
+  const size_t idx = net_device_count_;
+
+  const size_t vq_size = std::max(
+      kMinDmaBufferSize,
+      NetDevice::GetRequiredVqMemSize(kDefaultQueueSize).first);
+  net_vq_buffers_[idx] = kstd::make_unique<IoBuffer>(vq_size);
+  if (!net_vq_buffers_[idx] || !net_vq_buffers_[idx]->IsValid() ||
+      net_vq_buffers_[idx]->GetBuffer().size() < vq_size) {
+    klog::Err("VirtioDriver: failed to allocate DMA buffer at {:#x}", base);
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  }
+
+  // 接收缓冲池与发送槽
+  auto [buf_size, buf_align] =
+      NetDevice::GetRequiredBufMemSize(kDefaultQueueSize);
+  net_rx_buffers_[idx] = kstd::make_unique<IoBuffer>(buf_size, buf_align);
+  if (!net_rx_buffers_[idx] || !net_rx_buffers_[idx]->IsValid()) {
+    klog::Err("VirtioDriver: failed to allocate rx buffer pool at {:#x}",
+              base);
+    net_vq_buffers_[idx].reset();
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  }
+
+  auto result = NetDevice::Create(
+      base, net_vq_buffers_[idx]->ToDmaRegion(),
+      net_rx_buffers_[idx]->ToDmaRegion(), IdentityVirtToPhys,
+      kDefaultQueueSize);
+  if (!result.has_value()) {
+    klog::Err("VirtioDriver: VirtioNet Create failed at {:#x}", base);
+    net_vq_buffers_[idx].reset();
+    net_rx_buffers_[idx].reset();
+    return std::unexpected(Error(result.error().code));
+  }
+
+  auto& device = net_devices_[idx].emplace(std::move(*result));
+  node.type = DeviceType::kNet;
+  net_irqs_[idx] = node.irq;
+  ++net_device_count_;
+
+  auto mac = device.ReadConfig().mac;
+  klog::Info(
+      "VirtioDriver: net device at {:#x}, "
+      "mac={:02x}:{:02x}:{:02x}:{:02x}:{:02x}:{:02x}, features={:#x}, "
+      "irq={}",
+      base, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
+      device.GetNegotiatedFeatures(), net_irqs_[idx]);
+  return {};
+}
+
+auto VirtioDriver::PollNet() -> bool {
+  bool more = false;
+  for (size_t i = 0; i < net_device_count_; ++i) {
+    WithNetDevice(i, [this, i, &more](NetDevice& device) {
+      size_t done =
+          device.PollRx(kNetPollBudget, [this, i](const auto& packet) {
+            if (net_rx_handler_ != nullptr) {
+              net_rx_handler_(i, packet, net_rx_arg_);
+            }
+          });
+      more = more || done >= kNetPollBudget;
+    });
+  }
+  return more;
+}
+
+auto VirtioDriver::NetPollMain(void* arg) -> void {
+  auto* driver = static_cast<VirtioDriver*>(arg);
+  auto& task_manager = TaskManagerSingleton::instance();
+  while (true) {
+    if (!driver->net_irq_enabled_.load(std::memory_order_acquire) ||
+        !driver->net_rx_ready_.Wait().has_value()) {
+      task_manager.Sleep(kNetPollIntervalMs);
+    }
+    // 先清除唤醒再轮询：之后到达的中断会再次唤醒，不会丢失
+    driver->net_rx_ready_.Reset();
+    // 预算用尽时接收中断保持关闭，让出 CPU 后继续轮询
+    while (driver->PollNet()) {
+      task_manager.Schedule();
+    }
+  }
+}
+
+auto VirtioDriver::StartNetPoll() -> Expected<void> {
+  if (net_device_count_ == 0 ||
+      net_poll_started_.exchange(true, std::memory_order_acq_rel)) {
+    return {};
+  }
+  auto poller =
+      kstd::make_unique<TaskControlBlock>("NetPoll", 10, NetPollMain, this);
+  if (!poller) {
+    net_poll_started_.store(false, std::memory_order_release);
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  }
+  TaskManagerSingleton::instance().AddTask(poller.release());
+  klog::Info("VirtioDriver: net rx poll task started ({})",
+             net_irq_enabled_.load(std::memory_order_acquire)
+                 ? "interrupt driven"
+                 : "polling");
+  return {};
+}
+
 auto VirtioDriver::Probe(DeviceNode& node) -> Expected<void> {
   if (node.mmio_size == 0) {
     klog::Err("VirtioDriver: FDT reg property missing size for node '{}'",
@@ -41,78 +245,19 @@ auto VirtioDriver::Probe(DeviceNode& node) -> Expected<void> {
 
   switch (device_id) {
     case DeviceId::kBlock: {
-      if (blk_device_count_ >= kMaxBlkDevices) {
-        klog::Warn(
-            "VirtioDriver: blk device pool full, device at {:#x} skipped",
-            ctx->base);
-        return std::unexpected(Error(ErrorCode::kOutOfMemory));
-      }
-      const size_t idx = blk_device_count_;
-
-      // 分配 DMA buffer
-      dma_buffers_[idx] = kstd::make_unique<IoBuffer>(kMinDmaBufferSize);
-      if (!dma_buffers_[idx] || !dma_buffers_[idx]->IsValid() ||
-          dma_buffers_[idx]->GetBuffer().size() < kMinDmaBufferSize) {
-        klog::Err("VirtioDriver: failed to allocate DMA buffer at {:#x}",
-                  ctx->base);
-        return std::unexpected(Error(ErrorCode::kOutOfMemory));
-      }
-
-      // Allocate slot DMA buffer
-      auto [slot_size, slot_align] =
-          virtio::blk::VirtioBlk<>::GetRequiredSlotMemSize();
-      slot_buffers_[idx] = kstd::make_unique<IoBuffer>(slot_size);
-      if (!slot_buffers_[idx] || !slot_buffers_[idx]->IsValid()) {
-        klog::Err("VirtioDriver: failed to allocate slot DMA buffer at {:#x}",
-                  ctx->base);
-        dma_buffers_[idx].reset();
-        return std::unexpected(Error(ErrorCode::kOutOfMemory));
-      }
-
-      uint64_t extra_features =
-          static_cast<uint64_t>(virtio::blk::BlkFeatureBit::kSegMax) |
-          static_cast<uint64_t>(virtio::blk::BlkFeatureBit::kSizeMax) |
-          static_cast<uint64_t>(virtio::blk::BlkFeatureBit::kBlkSize) |
-          static_cast<uint64_t>(virtio::blk::BlkFeatureBit::kFlush) |
-          static_cast<uint64_t>(virtio::blk::BlkFeatureBit::kGeometry);
-
-      auto vq_dma = dma_buffers_[idx]->ToDmaRegion();
-      auto slot_dma = slot_buffers_[idx]->ToDmaRegion();
-
-      auto result = virtio::blk::VirtioBlk<>::Create(
-          ctx->base, vq_dma, slot_dma, IdentityVirtToPhys, kDefaultQueueCount,
-          kDefaultQueueSize, extra_features);
-      if (!result.has_value()) {
-        klog::Err("VirtioDriver: VirtioBlk Create failed at {:#x}", ctx->base);
-        dma_buffers_[idx].reset();
-        slot_buffers_[idx].reset();
-        return std::unexpected(Error(result.error().code));
-      }
-
-      blk_devices_[idx].emplace(std::move(*result));
-      node.type = DeviceType::kBlock;
-      irqs_[idx] = node.irq;
-
-      // Register adapter in pool and expose via DeviceNode.
-      if (blk_adapter_count_ < kMaxBlkDevices) {
-        const auto adapter_idx = static_cast<uint32_t>(blk_adapter_count_);
-        blk_adapters_[blk_adapter_count_].emplace(&blk_devices_[idx].value(),
-                                                  adapter_idx);
-        node.block_device = &blk_adapters_[blk_adapter_count_].value();
-        ++blk_adapter_count_;
-      } else {
-        klog::Warn(
-            "VirtioDriver: blk adapter pool full, device at {:#x} skipped",
-            ctx->base);
-      }
-
-      ++blk_device_count_;
-      klog::Info(
-          "VirtioDriver: block device at {:#x}, capacity={} sectors, irq={}",
-          ctx->base, blk_devices_[idx].value().GetCapacity(), irqs_[idx]);
-      return {};
+      // 设备提供 VIRTIO_F_RING_PACKED 时使用 packed virtqueue
+      virtio::MmioTransport transport(ctx->base);
+      bool packed =
+          kernel::config::kVirtioBlkPackedRing &&
+          (transport.GetDeviceFeatures() &
+           static_cast<uint64_t>(virtio::ReservedFeature::kRingPacked)) != 0;
+      return packed ? ProbeBlk<PackedBlk>(node, ctx->base)
+                    : ProbeBlk<SplitBlk>(node, ctx->base);
     }
 
+    case DeviceId::kNet:
+      return ProbeNet(node, ctx->base);
+
     default:
       return std::unexpected(Error(ErrorCode::kNotSupported));
   }
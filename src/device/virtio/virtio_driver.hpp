@@ -9,9 +9,12 @@
 #include <etl/span.h>
 
 #include <array>
+#include <atomic>
 #include <optional>
+#include <type_traits>
 #include <variant>
 
+#include "completion.hpp"
 #include "device_manager.hpp"
 #include "device_node.hpp"
 #include "driver_registry.hpp"
@@ -19,8 +22,10 @@
 #include "io_buffer.hpp"
 #include "kernel_log.hpp"
 #include "kstd_memory"
+#include "spinlock.hpp"
 #include "virtio/device/blk/virtio_blk.hpp"
 #include "virtio/device/blk/virtio_blk_vfs_adapter.hpp"
+#include "virtio/device/net/virtio_net.hpp"
 
 /**
  * @brief 统一 VirtIO 驱动
@@ -41,10 +46,37 @@ class VirtioDriver {
     kInput = 18,
   };
 
-  static constexpr uint32_t kDefaultQueueCount = 1;
+  /// 使用 split virtqueue 的块设备
+  using SplitBlk =
+      virtio::blk::VirtioBlk<virtio::MmioTransport, virtio::SplitVirtqueue>;
+  /// 使用 packed virtqueue 的块设备，设备提供 VIRTIO_F_RING_PACKED 时选用
+  using PackedBlk =
+      virtio::blk::VirtioBlk<virtio::MmioTransport, virtio::PackedVirtqueue>;
+
+  /// 网络设备，接收报文的长度依赖逐个完成项，固定使用 split virtqueue
+  using NetDevice =
+      virtio::net::VirtioNet<virtio::MmioTransport, virtio::SplitVirtqueue>;
+
+  /// 核心数未知时的 virtio-blk 队列数量
+  static constexpr uint16_t kDefaultQueueCount = 1;
   static constexpr uint32_t kDefaultQueueSize = 128;
   static constexpr size_t kMinDmaBufferSize = 32768;
 
+  /// 接收轮询任务每轮处理的报文预算
+  static constexpr size_t kNetPollBudget = 64;
+  /// 网络中断未接入时接收轮询任务的轮询间隔（毫秒）
+  static constexpr uint64_t kNetPollIntervalMs = 10;
+
+  /**
+   * @brief 接收回调
+   *
+   * 在接收轮询任务中持有网络设备锁（关中断）调用，不可休眠；
+   * 报文数据仅在回调期间有效。
+   */
+  using NetRxHandler = void (*)(size_t index,
+                                const virtio::net::RxPacket& packet,
+                                void* arg);
+
   /**
    * @brief 返回驱动注册入口
    *
@@ -89,32 +121,155 @@ class VirtioDriver {
 
   auto Remove([[maybe_unused]] DeviceNode& node) -> Expected<void> {
     for (size_t i = 0; i < blk_device_count_; ++i) {
-      blk_devices_[i].reset();
+      blk_devices_[i].emplace<std::monostate>();
       dma_buffers_[i].reset();
       slot_buffers_[i].reset();
     }
     blk_device_count_ = 0;
     blk_adapter_count_ = 0;
+    for (size_t i = 0; i < net_device_count_; ++i) {
+      net_devices_[i].reset();
+      net_vq_buffers_[i].reset();
+      net_rx_buffers_[i].reset();
+    }
+    net_device_count_ = 0;
     return {};
   }
 
-  [[nodiscard]] auto GetBlkDevice() -> virtio::blk::VirtioBlk<>* {
-    return (blk_device_count_ > 0 && blk_devices_[0].has_value())
-               ? &blk_devices_[0].value()
-               : nullptr;
+  /**
+   * @brief 获取第一个块设备
+   *
+   * @tparam BlkT SplitBlk 或 PackedBlk
+   * @return 设备使用 BlkT 对应的队列布局时返回设备指针，否则返回 nullptr
+   */
+  template <typename BlkT = SplitBlk>
+  [[nodiscard]] auto GetBlkDevice() -> BlkT* {
+    return blk_device_count_ > 0 ? std::get_if<BlkT>(&blk_devices_[0])
+                                 : nullptr;
   }
 
   [[nodiscard]] auto GetIrq() const -> uint32_t {
     return blk_device_count_ > 0 ? irqs_[0] : 0;
   }
 
+  /**
+   * @brief 获取网络设备
+   *
+   * @param index 设备序号
+   * @return 设备指针，不存在时返回 nullptr
+   * @note 接收与发送需与中断处理互斥，应通过 WithNetDevice() 访问
+   */
+  [[nodiscard]] auto GetNetDevice(size_t index = 0) -> NetDevice* {
+    return index < net_device_count_ ? &*net_devices_[index] : nullptr;
+  }
+
+  [[nodiscard]] auto GetNetIrq() const -> uint32_t {
+    return net_device_count_ > 0 ? net_irqs_[0] : 0;
+  }
+
+  /**
+   * @brief 持有网络设备锁（关中断）调用 func
+   *
+   * @tparam Func void(NetDevice& device)
+   * @param index 设备序号
+   * @param func 访问设备的函数
+   * @return 设备不存在时返回 false
+   */
+  template <typename Func>
+  auto WithNetDevice(size_t index, Func&& func) -> bool {
+    if (index >= net_device_count_) {
+      return false;
+    }
+    LockGuard<SpinLock> guard(net_lock_);
+    func(*net_devices_[index]);
+    return true;
+  }
+
+  /**
+   * @brief 确认网络设备中断并唤醒接收轮询任务
+   *
+   * 在 virtio-net 中断处理中调用。NetDevice::HandleInterrupt() 关闭接收
+   * 中断，报文由接收轮询任务在中断上下文之外处理，处理完后重新开启。
+   */
+  auto HandleNetInterrupt() -> void {
+    bool scheduled = false;
+    {
+      LockGuard<SpinLock> guard(net_lock_);
+      for (size_t i = 0; i < net_device_count_; ++i) {
+        scheduled = net_devices_[i]->HandleInterrupt() || scheduled;
+      }
+    }
+    if (scheduled) {
+      net_rx_ready_.Complete();
+    }
+  }
+
+  /**
+   * @brief 网络设备的中断已注册，接收轮询任务改为等待中断唤醒
+   */
+  auto EnableNetIrq() -> void {
+    net_irq_enabled_.store(true, std::memory_order_release);
+  }
+
+  /**
+   * @brief 设置接收回调
+   *
+   * @param handler 接收回调，为 nullptr 时丢弃收到的报文
+   * @param arg 传给回调的参数
+   */
+  auto SetNetRxHandler(NetRxHandler handler, void* arg) -> void {
+    LockGuard<SpinLock> guard(net_lock_);
+    net_rx_handler_ = handler;
+    net_rx_arg_ = arg;
+  }
+
+  /**
+   * @brief 启动网络设备的接收轮询任务（NAPI）
+   *
+   * 任务等待中断唤醒（中断未接入时定期醒来），对每个设备调用
+   * NetDevice::PollRx()。预算用尽时接收中断保持关闭，任务让出 CPU 后
+   * 继续轮询；预算未用尽时 PollRx() 已重新开启接收中断，任务再次等待。
+   *
+   * @return Expected<void> 没有网络设备时不启动；已启动时直接返回
+   * @pre 任务管理器已初始化
+   */
+  auto StartNetPoll() -> Expected<void>;
+
+  /**
+   * @brief 对每个网络设备执行一轮接收轮询
+   *
+   * @return true 表示有设备用尽了预算，应继续轮询
+   */
+  auto PollNet() -> bool;
+
+  /**
+   * @brief 处理所有块设备已完成的请求，结束对应的块请求
+   *
+   * 在 virtio-blk 中断处理中调用。
+   */
+  auto HandleBlkCompletions() -> void {
+    for (size_t i = 0; i < blk_adapter_count_; ++i) {
+      VisitBlk(blk_adapters_[i],
+               [](auto& adapter) { adapter.HandleCompletions(); });
+    }
+  }
+
+  /**
+   * @brief 块设备的完成中断已注册，同步读写改为睡眠等待中断
+   */
+  auto EnableBlkIrq() -> void {
+    for (size_t i = 0; i < blk_adapter_count_; ++i) {
+      VisitBlk(blk_adapters_[i],
+               [](auto& adapter) { adapter.EnableCompletionIrq(); });
+    }
+  }
+
   template <typename CompletionCallback>
   auto HandleInterrupt(CompletionCallback&& on_complete) -> void {
     for (size_t i = 0; i < blk_device_count_; ++i) {
-      if (blk_devices_[i].has_value()) {
-        blk_devices_[i].value().HandleInterrupt(
-            static_cast<CompletionCallback&&>(on_complete));
-      }
+      VisitBlk(blk_devices_[i], [&on_complete](auto& device) {
+        device.HandleInterrupt(on_complete);
+      });
     }
   }
 
@@ -124,18 +279,85 @@ class VirtioDriver {
   };
 
   static constexpr size_t kMaxBlkDevices = 4;
+  static constexpr size_t kMaxNetDevices = 2;
+
+  /// 块设备槽，按协商的队列布局保存对应的设备类型
+  using BlkDeviceSlot = std::variant<std::monostate, SplitBlk, PackedBlk>;
+  /// 块设备适配器槽，与 BlkDeviceSlot 的类型一一对应
+  using BlkAdapterSlot =
+      std::variant<std::monostate, virtio::blk::VirtioBlkVfsAdapter<SplitBlk>,
+                   virtio::blk::VirtioBlkVfsAdapter<PackedBlk>>;
 
-  std::array<std::optional<virtio::blk::VirtioBlk<>>, kMaxBlkDevices>
-      blk_devices_;
+  /**
+   * @brief 对非空槽中的设备或适配器调用 func
+   */
+  template <typename Slot, typename Func>
+  static auto VisitBlk(Slot& slot, Func&& func) -> void {
+    std::visit(
+        [&func](auto& alt) {
+          if constexpr (!std::is_same_v<std::remove_cvref_t<decltype(alt)>,
+                                        std::monostate>) {
+            func(alt);
+          }
+        },
+        slot);
+  }
+
+  /**
+   * @brief 创建 BlkT 类型的块设备并注册适配器
+   *
+   * @tparam BlkT SplitBlk 或 PackedBlk
+   * @param node 设备节点
+   * @param base MMIO 基地址
+   */
+  template <typename BlkT>
+  auto ProbeBlk(DeviceNode& node, uint64_t base) -> Expected<void>;
+
+  /**
+   * @brief 创建网络设备
+   *
+   * @param node 设备节点
+   * @param base MMIO 基地址
+   */
+  auto ProbeNet(DeviceNode& node, uint64_t base) -> Expected<void>;
+
+  /**
+   * @brief 接收轮询任务入口
+   *
+   * @param arg VirtioDriver*
+   */
+  static auto NetPollMain(void* arg) -> void;
+
+  /**
+   * @brief 期望的 virtio-blk 队列数量：每个核心一个，不超过 kMaxQueues
+   */
+  [[nodiscard]] static auto GetBlkQueueCount() -> uint16_t;
+
+  std::array<BlkDeviceSlot, kMaxBlkDevices> blk_devices_;
   std::array<etl::unique_ptr<IoBuffer>, kMaxBlkDevices> dma_buffers_;
   std::array<etl::unique_ptr<IoBuffer>, kMaxBlkDevices> slot_buffers_;
   std::array<uint32_t, kMaxBlkDevices> irqs_{};
   size_t blk_device_count_{0};
 
   // Static adapter pool — one slot per probed blk device (kernel lifetime).
-  std::array<std::optional<virtio::blk::VirtioBlkVfsAdapter>, kMaxBlkDevices>
-      blk_adapters_;
+  std::array<BlkAdapterSlot, kMaxBlkDevices> blk_adapters_;
   size_t blk_adapter_count_{0};
+
+  std::array<std::optional<NetDevice>, kMaxNetDevices> net_devices_;
+  std::array<etl::unique_ptr<IoBuffer>, kMaxNetDevices> net_vq_buffers_;
+  std::array<etl::unique_ptr<IoBuffer>, kMaxNetDevices> net_rx_buffers_;
+  std::array<uint32_t, kMaxNetDevices> net_irqs_{};
+  size_t net_device_count_{0};
+  /// 串行化网络设备的中断处理与收发，同时保护接收回调
+  SpinLock net_lock_{"virtio_net"};
+  NetRxHandler net_rx_handler_{nullptr};
+  void* net_rx_arg_{nullptr};
+  /// 中断调度了接收轮询，唤醒接收轮询任务
+  Completion net_rx_ready_{"virtio_net_rx"};
+  /// 中断已注册，接收轮询任务等待中断唤醒
+  std::atomic<bool> net_irq_enabled_{false};
+  /// 接收轮询任务已启动
+  std::atomic<bool> net_poll_started_{false};
 };
 
 using VirtioDriverSingleton = etl::singleton<VirtioDriver>;
@@ -8,8 +8,18 @@
 #include <diskio.h>
 // clang-format on
 
+#include <array>
+
 #include "fatfs.hpp"
 #include "kernel_log.hpp"
+#include "rw_mutex.hpp"
+
+namespace {
+
+/// 每卷一个互斥锁，最后一个供 FF_FS_LOCK 的系统锁使用
+std::array<RwMutex, FF_VOLUMES + 1> volume_locks;
+
+}  // namespace
 
 extern "C" {
 
@@ -130,4 +140,45 @@ auto disk_ioctl(BYTE pdrv, BYTE cmd, void* buff) -> DRESULT {
       return RES_PARERR;
   }
 }
+
+/**
+ * @brief 创建卷互斥锁。
+ *
+ * @note 锁是静态分配的，无需创建。
+ * @param vol 卷号（FF_VOLUMES 表示系统锁）。
+ * @return int 始终返回 1（成功）。
+ */
+auto ff_mutex_create(int vol) -> int {
+  (void)vol;
+  return 1;
+}
+
+/**
+ * @brief 删除卷互斥锁。
+ *
+ * @param vol 卷号。
+ */
+auto ff_mutex_delete(int vol) -> void { (void)vol; }
+
+/**
+ * @brief 获取卷互斥锁。
+ *
+ * @note 使用可休眠的锁，磁盘 I/O 期间其它任务不会空转；
+ *       调度器启动前退化为自旋等待。
+ * @param vol 卷号。
+ * @return int 始终返回 1（成功）。
+ */
+auto ff_mutex_take(int vol) -> int {
+  volume_locks[static_cast<size_t>(vol)].WriteLock();
+  return 1;
+}
+
+/**
+ * @brief 释放卷互斥锁。
+ *
+ * @param vol 卷号。
+ */
+auto ff_mutex_give(int vol) -> void {
+  volume_locks[static_cast<size_t>(vol)].WriteUnlock();
+}
 }
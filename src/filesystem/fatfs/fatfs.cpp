@@ -6,6 +6,8 @@
 
 #include <ff.h>
 
+#include <algorithm>
+
 #include "kernel_log.hpp"
 #include "kstd_cstring"
 #include "vfs.hpp"
@@ -158,6 +160,14 @@ auto FatFsFileSystem::Unmount() -> Expected<void> {
   }
   char path[4] = {static_cast<char>('0' + volume_id_), ':', '/', '\0'};
   FRESULT fr = f_mount(nullptr, path, 0);
+  // 块设备可能缓存了未写回的数据
+  auto* dev = GetBlockDevice(volume_id_);
+  if (dev != nullptr) {
+    auto flush_result = dev->Flush();
+    if (!flush_result.has_value() && fr == FR_OK) {
+      fr = FR_DISK_ERR;
+    }
+  }
   SetBlockDevice(volume_id_, nullptr);
   mounted_ = false;
   root_inode_ = nullptr;
@@ -202,12 +212,42 @@ auto FatFsFileSystem::FreeInode(vfs::Inode* inode) -> Expected<void> {
   return {};
 }
 
+auto FatFsFileSystem::ReleaseInode(vfs::Inode* inode) -> void {
+  auto* fi = static_cast<FatInode*>(inode->fs_private);
+  // 根 inode 随 Unmount 释放
+  if (fi == nullptr || inode == root_inode_) {
+    return;
+  }
+  // 没有 dentry 引用时也没有打开的 File，句柄应已在 Close 中关闭；
+  // 此处持有自旋锁，不能调用可能访问磁盘的 f_close
+  if (fi->fil != nullptr || fi->dir != nullptr) {
+    klog::Warn("FatFsFileSystem: release inode '{}' with open handle",
+               fi->path.data());
+    return;
+  }
+  FreeFatInode(fi);
+}
+
 auto FatFsFileSystem::GetFileOps() -> vfs::FileOps* { return &file_ops_; }
 
+auto FatFsFileSystem::UsesPageCache() const -> bool { return true; }
+
 auto FatFsFileSystem::AllocateFatInode() -> FatInode* {
+  LockGuard<SpinLock> guard(pool_lock_);
   for (auto& fi : inodes_) {
     if (!fi.in_use) {
-      fi = FatInode{};
+      // vfs::Inode 含锁，不可整体赋值，逐字段重置
+      fi.inode.ino = 0;
+      fi.inode.type = vfs::FileType::kUnknown;
+      fi.inode.size = 0;
+      fi.inode.permissions = 0644;
+      fi.inode.link_count = 1;
+      fi.inode.fs_private = nullptr;
+      fi.inode.fs = nullptr;
+      fi.inode.ops = nullptr;
+      fi.path = {};
+      fi.fil = nullptr;
+      fi.dir = nullptr;
       fi.in_use = true;
       return &fi;
     }
@@ -216,12 +256,14 @@ auto FatFsFileSystem::AllocateFatInode() -> FatInode* {
 }
 
 auto FatFsFileSystem::FreeFatInode(FatInode* fi) -> void {
+  LockGuard<SpinLock> guard(pool_lock_);
   if (fi != nullptr) {
     fi->in_use = false;
   }
 }
 
 auto FatFsFileSystem::AllocateFil() -> FIL* {
+  LockGuard<SpinLock> guard(pool_lock_);
   for (auto& fh : fil_pool_) {
     if (!fh.in_use) {
       fh = FatFileHandle{};
@@ -233,6 +275,7 @@ auto FatFsFileSystem::AllocateFil() -> FIL* {
 }
 
 auto FatFsFileSystem::FreeFil(FIL* fil) -> void {
+  LockGuard<SpinLock> guard(pool_lock_);
   for (auto& fh : fil_pool_) {
     if (&fh.fil == fil) {
       fh.in_use = false;
@@ -242,6 +285,7 @@ auto FatFsFileSystem::FreeFil(FIL* fil) -> void {
 }
 
 auto FatFsFileSystem::AllocateDir() -> DIR* {
+  LockGuard<SpinLock> guard(pool_lock_);
   for (auto& dh : dir_pool_) {
     if (!dh.in_use) {
       dh = FatDirHandle{};
@@ -253,6 +297,7 @@ auto FatFsFileSystem::AllocateDir() -> DIR* {
 }
 
 auto FatFsFileSystem::FreeDir(DIR* dir) -> void {
+  LockGuard<SpinLock> guard(pool_lock_);
   for (auto& dh : dir_pool_) {
     if (&dh.dir == dir) {
       dh.in_use = false;
@@ -393,39 +438,148 @@ auto FatFsFileSystem::FatFsInodeOps::Rmdir(vfs::Inode* dir, const char* name)
   return Unlink(dir, name);
 }
 
-auto FatFsFileSystem::FatFsFileOps::Read(vfs::File* file, void* buf,
-                                         size_t count) -> Expected<size_t> {
+auto FatFsFileSystem::FatFsFileOps::ReadAt(vfs::File* file, void* buf,
+                                           size_t count, uint64_t offset)
+    -> Expected<size_t> {
   auto* fi = static_cast<FatInode*>(file->inode->fs_private);
   if (fi->fil == nullptr) {
     return std::unexpected(Error{ErrorCode::kFsInvalidFd});
   }
+  // FIL 按 inode 共享，各 File 的偏移量由 VFS 维护，每次访问前重新定位
+  WriteLockGuard fil_guard(fi->fil_lock);
+  // 可写打开时 f_lseek 越过文件末尾会扩展文件
+  if (offset >= static_cast<uint64_t>(f_size(fi->fil))) {
+    return static_cast<size_t>(0);
+  }
+  FRESULT fr = FR_OK;
+  if (static_cast<uint64_t>(f_tell(fi->fil)) != offset) {
+    fr = f_lseek(fi->fil, static_cast<FSIZE_t>(offset));
+  }
   UINT bytes_read = 0;
-  FRESULT fr = f_read(fi->fil, buf, static_cast<UINT>(count), &bytes_read);
+  if (fr == FR_OK) {
+    fr = f_read(fi->fil, buf, static_cast<UINT>(count), &bytes_read);
+  }
   if (fr != FR_OK) {
-    klog::Err("FatFsFileOps::Read: f_read failed ({})", static_cast<int>(fr));
+    klog::Err("FatFsFileOps::ReadAt: read at {} failed ({})", offset,
+              static_cast<int>(fr));
     return std::unexpected(Error{FresultToErrorCode(fr)});
   }
-  file->offset += bytes_read;
   return static_cast<size_t>(bytes_read);
 }
 
-auto FatFsFileSystem::FatFsFileOps::Write(vfs::File* file, const void* buf,
-                                          size_t count) -> Expected<size_t> {
+auto FatFsFileSystem::FatFsFileOps::WriteAt(vfs::File* file, const void* buf,
+                                            size_t count, uint64_t offset)
+    -> Expected<size_t> {
   auto* fi = static_cast<FatInode*>(file->inode->fs_private);
   if (fi->fil == nullptr) {
     return std::unexpected(Error{ErrorCode::kFsInvalidFd});
   }
+  WriteLockGuard fil_guard(fi->fil_lock);
+  FRESULT fr = FR_OK;
+  if (static_cast<uint64_t>(f_tell(fi->fil)) != offset) {
+    fr = f_lseek(fi->fil, static_cast<FSIZE_t>(offset));
+  }
   UINT bytes_written = 0;
-  FRESULT fr = f_write(fi->fil, buf, static_cast<UINT>(count), &bytes_written);
+  if (fr == FR_OK) {
+    fr = f_write(fi->fil, buf, static_cast<UINT>(count), &bytes_written);
+  }
   if (fr != FR_OK) {
-    klog::Err("FatFsFileOps::Write: f_write failed ({})", static_cast<int>(fr));
+    klog::Err("FatFsFileOps::WriteAt: write at {} failed ({})", offset,
+              static_cast<int>(fr));
     return std::unexpected(Error{FresultToErrorCode(fr)});
   }
-  file->offset += bytes_written;
   file->inode->size = static_cast<uint64_t>(f_size(fi->fil));
   return static_cast<size_t>(bytes_written);
 }
 
+auto FatFsFileSystem::FatFsFileOps::Read(vfs::File* file, void* buf,
+                                         size_t count) -> Expected<size_t> {
+  auto result = ReadAt(file, buf, count, file->offset);
+  if (result.has_value()) {
+    file->offset += result.value();
+  }
+  return result;
+}
+
+auto FatFsFileSystem::FatFsFileOps::Write(vfs::File* file, const void* buf,
+                                          size_t count) -> Expected<size_t> {
+  auto result = WriteAt(file, buf, count, file->offset);
+  if (result.has_value()) {
+    file->offset += result.value();
+  }
+  return result;
+}
+
+auto FatFsFileSystem::FatFsFileOps::PRead(vfs::File* file, void* buf,
+                                          size_t count, uint64_t offset)
+    -> Expected<size_t> {
+  return ReadAt(file, buf, count, offset);
+}
+
+auto FatFsFileSystem::FatFsFileOps::PWrite(vfs::File* file, const void* buf,
+                                           size_t count, uint64_t offset)
+    -> Expected<size_t> {
+  return WriteAt(file, buf, count, offset);
+}
+
+auto FatFsFileSystem::FatFsFileOps::ReadPage(vfs::File* file, void* buf,
+                                             size_t count, uint64_t offset)
+    -> Expected<size_t> {
+  return ReadAt(file, buf, count, offset);
+}
+
+auto FatFsFileSystem::FatFsFileOps::MapExtent(vfs::File* file,
+                                              uint64_t offset, uint64_t count)
+    -> Expected<vfs::BlockExtent> {
+  auto* fi = static_cast<FatInode*>(file->inode->fs_private);
+  if (fi->fil == nullptr) {
+    return std::unexpected(Error{ErrorCode::kFsInvalidFd});
+  }
+  WriteLockGuard fil_guard(fi->fil_lock);
+  const auto size = static_cast<uint64_t>(f_size(fi->fil));
+  if (count == 0 || offset >= size || offset % FF_MAX_SS != 0) {
+    return std::unexpected(Error{ErrorCode::kInvalidArgument});
+  }
+  const uint64_t end = std::min(offset + count, size);
+  FATFS* volume = fi->fil->obj.fs;
+  const uint64_t cluster_bytes =
+      static_cast<uint64_t>(volume->csize) * FF_MAX_SS;
+
+  // 部分写入的扇区留在 FIL 缓冲区中，写出后设备上的数据才是最新的
+  FRESULT fr = f_sync(fi->fil);
+  // 定位到簇边界时 FatFS 停在前一簇，定位到 pos + 1 使 clust 为 pos 所在的簇
+  if (fr == FR_OK) {
+    fr = f_lseek(fi->fil, static_cast<FSIZE_t>(offset + 1));
+  }
+  const DWORD first = fi->fil->clust;
+  DWORD last = first;
+  uint64_t mapped = (offset / cluster_bytes + 1) * cluster_bytes;
+  while (fr == FR_OK && mapped < end) {
+    fr = f_lseek(fi->fil, static_cast<FSIZE_t>(mapped + 1));
+    if (fr != FR_OK || fi->fil->clust != last + 1) {
+      break;
+    }
+    ++last;
+    mapped += cluster_bytes;
+  }
+  if (fr == FR_OK && first < 2) {
+    fr = FR_INT_ERR;
+  }
+  if (fr != FR_OK) {
+    klog::Err("FatFsFileOps::MapExtent: map at {} failed ({})", offset,
+              static_cast<int>(fr));
+    return std::unexpected(Error{FresultToErrorCode(fr)});
+  }
+
+  return vfs::BlockExtent{
+      .device = GetBlockDevice(fs_->volume_id_),
+      .sector = static_cast<uint64_t>(volume->database) +
+                static_cast<uint64_t>(first - 2) * volume->csize +
+                (offset % cluster_bytes) / FF_MAX_SS,
+      .bytes = std::min(mapped, end) - offset,
+  };
+}
+
 auto FatFsFileSystem::FatFsFileOps::Seek(vfs::File* file, int64_t offset,
                                          vfs::SeekWhence whence)
     -> Expected<uint64_t> {
@@ -433,26 +587,38 @@ auto FatFsFileSystem::FatFsFileOps::Seek(vfs::File* file, int64_t offset,
   if (fi->fil == nullptr) {
     return std::unexpected(Error{ErrorCode::kFsInvalidFd});
   }
-  FSIZE_t new_pos = 0;
+  // 只记录偏移量，下一次读写时再定位共享的 FIL
+  int64_t base = 0;
   switch (whence) {
     case vfs::SeekWhence::kSet:
-      new_pos = static_cast<FSIZE_t>(offset);
       break;
     case vfs::SeekWhence::kCur:
-      new_pos =
-          static_cast<FSIZE_t>(static_cast<int64_t>(f_tell(fi->fil)) + offset);
+      base = static_cast<int64_t>(file->offset);
       break;
     case vfs::SeekWhence::kEnd:
-      new_pos =
-          static_cast<FSIZE_t>(static_cast<int64_t>(f_size(fi->fil)) + offset);
+      // 调用者持有 inode 的共享锁，写入者不会同时改变文件大小
+      base = static_cast<int64_t>(f_size(fi->fil));
       break;
   }
-  FRESULT fr = f_lseek(fi->fil, new_pos);
-  if (fr != FR_OK) {
-    return std::unexpected(Error{FresultToErrorCode(fr)});
+  if (offset < -base) {
+    return std::unexpected(Error{ErrorCode::kInvalidArgument});
+  }
+  file->offset = static_cast<uint64_t>(base + offset);
+  return file->offset;
+}
+
+auto FatFsFileSystem::FatFsFileOps::Open(vfs::File* file) -> Expected<void> {
+  if (file->inode->type != vfs::FileType::kRegular) {
+    return {};
   }
-  file->offset = static_cast<uint64_t>(new_pos);
-  return static_cast<uint64_t>(new_pos);
+  auto result = fs_->OpenFil(file->inode, file->flags);
+  if (!result.has_value()) {
+    return result;
+  }
+  // FA_CREATE_ALWAYS 可能截断了文件
+  auto* fi = static_cast<FatInode*>(file->inode->fs_private);
+  file->inode->size = static_cast<uint64_t>(f_size(fi->fil));
+  return {};
 }
 
 auto FatFsFileSystem::FatFsFileOps::Close(vfs::File* file) -> Expected<void> {
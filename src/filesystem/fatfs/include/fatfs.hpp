@@ -11,6 +11,7 @@
 
 #include "block_device.hpp"
 #include "filesystem.hpp"
+#include "spinlock.hpp"
 #include "vfs.hpp"
 
 namespace fatfs {
@@ -95,11 +96,25 @@ class FatFsFileSystem : public vfs::FileSystem {
    */
   auto FreeInode(vfs::Inode* inode) -> Expected<void> override;
 
+  /**
+   * @brief 引用 inode 的 dentry 被释放时归还其 inode 池槽位
+   * @param inode 由 Lookup/Create 分配的 inode
+   * @note FatFS 没有稳定的 inode 编号，每次 Lookup 都分配新槽位，
+   *       不归还时 dcache 反复回收与查找会耗尽 inode 池
+   */
+  auto ReleaseInode(vfs::Inode* inode) -> void override;
+
   /**
    * @brief 返回本文件系统的 FileOps 实例
    */
   [[nodiscard]] auto GetFileOps() -> vfs::FileOps* override;
 
+  /**
+   * @brief FatFS 位于块设备上，文件数据经 VFS 页缓存读取
+   * @return true
+   */
+  [[nodiscard]] auto UsesPageCache() const -> bool override;
+
   /**
    * @brief 为 inode 打开底层 FatFS FIL 对象
    * @param inode      要打开的 inode（不能为 nullptr，类型必须为 kRegular）
@@ -216,6 +231,57 @@ class FatFsFileSystem : public vfs::FileSystem {
     auto Seek(vfs::File* file, int64_t offset, vfs::SeekWhence whence)
         -> Expected<uint64_t> override;
 
+    /**
+     * @brief 从指定位置读取数据，不改变文件偏移量
+     * @param file   文件对象
+     * @param buf    读取缓冲区
+     * @param count  请求读取的字节数
+     * @param offset 读取位置
+     * @return Expected<size_t> 实际读取字节数或错误
+     */
+    auto PRead(vfs::File* file, void* buf, size_t count, uint64_t offset)
+        -> Expected<size_t> override;
+
+    /**
+     * @brief 向指定位置写入数据，不改变文件偏移量
+     * @param file   文件对象
+     * @param buf    写入数据缓冲区
+     * @param count  请求写入的字节数
+     * @param offset 写入位置
+     * @return Expected<size_t> 实际写入字节数或错误
+     */
+    auto PWrite(vfs::File* file, const void* buf, size_t count,
+                uint64_t offset) -> Expected<size_t> override;
+
+    /**
+     * @brief 为页缓存读取连续的数据，f_read 会读满或读到文件末尾
+     * @param file   文件对象
+     * @param buf    页缓冲区
+     * @param count  读取字节数
+     * @param offset 起始位置
+     * @return Expected<size_t> 实际读取字节数或错误
+     */
+    auto ReadPage(vfs::File* file, void* buf, size_t count, uint64_t offset)
+        -> Expected<size_t> override;
+
+    /**
+     * @brief 沿簇链找出从 offset 开始物理连续的一段，供页缓存异步预读
+     * @param file   文件对象
+     * @param offset 起始位置，按扇区对齐
+     * @param count  希望映射的字节数
+     * @return Expected<vfs::BlockExtent> 位于已注册块设备上的连续扇区
+     * @note 先以 f_sync 写出 FIL 缓冲区中的数据，设备读取才能看到
+     */
+    auto MapExtent(vfs::File* file, uint64_t offset, uint64_t count)
+        -> Expected<vfs::BlockExtent> override;
+
+    /**
+     * @brief 打开普通文件时打开底层 FIL 对象
+     * @param file 文件对象
+     * @return Expected<void> 成功或错误
+     */
+    auto Open(vfs::File* file) -> Expected<void> override;
+
     /**
      * @brief 关闭文件，释放底层 FIL 对象
      * @param file 文件对象
@@ -235,6 +301,28 @@ class FatFsFileSystem : public vfs::FileSystem {
 
    private:
     FatFsFileSystem* fs_;
+
+    /**
+     * @brief 在 offset 处读取，Read/PRead/ReadPage 共用
+     * @param file   文件对象
+     * @param buf    读取缓冲区
+     * @param count  请求读取的字节数
+     * @param offset 读取位置
+     * @return Expected<size_t> 实际读取字节数或错误
+     */
+    auto ReadAt(vfs::File* file, void* buf, size_t count, uint64_t offset)
+        -> Expected<size_t>;
+
+    /**
+     * @brief 在 offset 处写入并更新 inode 大小，Write/PWrite 共用
+     * @param file   文件对象
+     * @param buf    写入数据缓冲区
+     * @param count  请求写入的字节数
+     * @param offset 写入位置
+     * @return Expected<size_t> 实际写入字节数或错误
+     */
+    auto WriteAt(vfs::File* file, const void* buf, size_t count,
+                 uint64_t offset) -> Expected<size_t>;
   };
 
   friend class FatFsInodeOps;
@@ -257,6 +345,8 @@ class FatFsFileSystem : public vfs::FileSystem {
     std::array<char, kPathBufSize> path{};
     /// FIL 对象（普通文件打开时使用）；目录或未使用时为 nullptr
     FIL* fil = nullptr;
+    /// 同一 inode 的所有 File 共享 fil 的读写位置，定位与读写须连续完成
+    RwMutex fil_lock{"fatfs_fil"};
     /// 该槽位是否在使用
     bool in_use = false;
     /// DIR 对象（目录迭代状态）；未迭代时为 nullptr
@@ -281,6 +371,9 @@ class FatFsFileSystem : public vfs::FileSystem {
 
   std::array<FatDirHandle, kMaxOpenDirs> dir_pool_;
 
+  /// 保护 inode、FIL 与 DIR 对象池，卷内操作由 FatFS 的卷锁串行化
+  SpinLock pool_lock_{"fatfs_pool"};
+
   /// inode 操作单例
   FatFsInodeOps inode_ops_;
   /// 文件操作单例
@@ -49,5 +49,5 @@
 #define FF_FS_CRTIME 0
 #define FF_FS_NOFSINFO 0
 #define FF_FS_LOCK 0
-#define FF_FS_REENTRANT 0
+#define FF_FS_REENTRANT 1
 #define FF_FS_TIMEOUT 1000
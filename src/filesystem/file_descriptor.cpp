@@ -5,6 +5,7 @@
 #include "file_descriptor.hpp"
 
 #include "kernel_log.hpp"
+#include "kstd_memory"
 
 namespace filesystem {
 
@@ -83,6 +84,19 @@ auto FileDescriptorTable::Get(int fd) -> vfs::File* {
   return table_[fd];
 }
 
+auto FileDescriptorTable::Acquire(int fd) -> vfs::File* {
+  if (fd < 0 || fd >= kMaxFd) {
+    return nullptr;
+  }
+
+  LockGuard guard(lock_);
+  vfs::File* file = table_[fd];
+  if (file != nullptr) {
+    file->ref_count.fetch_add(1, std::memory_order_relaxed);
+  }
+  return file;
+}
+
 auto FileDescriptorTable::Free(int fd) -> Expected<void> {
   if (fd < 0 || fd >= kMaxFd) {
     return std::unexpected(Error(ErrorCode::kFsInvalidFd));
@@ -120,6 +134,7 @@ auto FileDescriptorTable::Dup(int old_fd, int new_fd) -> Expected<int> {
     }
 
     table_[new_fd] = file;
+    file->ref_count.fetch_add(1, std::memory_order_relaxed);
     ++open_count_;
     return new_fd;
   }
@@ -129,6 +144,7 @@ auto FileDescriptorTable::Dup(int old_fd, int new_fd) -> Expected<int> {
     for (int fd = kStderrFd + 1; fd < kMaxFd; ++fd) {
       if (table_[fd] == nullptr) {
         table_[fd] = file;
+        file->ref_count.fetch_add(1, std::memory_order_relaxed);
         ++open_count_;
         return fd;
       }
@@ -153,6 +169,64 @@ auto FileDescriptorTable::CloseAll() -> Expected<void> {
   return {};
 }
 
+auto FileDescriptorTable::Close(int fd) -> Expected<void> {
+  if (fd < 0 || fd >= kMaxFd) {
+    return std::unexpected(Error(ErrorCode::kFsInvalidFd));
+  }
+
+  vfs::File* file = nullptr;
+  {
+    LockGuard guard(lock_);
+    file = table_[fd];
+    if (file == nullptr) {
+      return std::unexpected(Error(ErrorCode::kFsInvalidFd));
+    }
+    table_[fd] = nullptr;
+    --open_count_;
+  }
+
+  // vfs::Close 会获取 VFS 锁，不能在持有表锁时调用
+  return vfs::Close(file);
+}
+
+auto FileDescriptorTable::CloseFiles() -> void {
+  for (int fd = 0; fd < kMaxFd; ++fd) {
+    if (Get(fd) == nullptr) {
+      continue;
+    }
+    Close(fd).or_else([fd](auto&& err) {
+      klog::Warn("Failed to close fd {}: {}", fd, err.message());
+      return Expected<void>{};
+    });
+  }
+}
+
+auto FileDescriptorTable::Clone() -> Expected<FileDescriptorTable*> {
+  auto table = kstd::make_unique<FileDescriptorTable>();
+  if (!table) {
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  }
+
+  LockGuard guard(lock_);
+  for (int fd = 0; fd < kMaxFd; ++fd) {
+    if (table_[fd] != nullptr) {
+      table_[fd]->ref_count.fetch_add(1, std::memory_order_relaxed);
+      table->table_[fd] = table_[fd];
+    }
+  }
+  table->open_count_ = open_count_;
+
+  return table.release();
+}
+
+auto FileDescriptorTable::Ref() -> void {
+  users_.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto FileDescriptorTable::Unref() -> bool {
+  return users_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+}
+
 auto FileDescriptorTable::SetupStandardFiles(vfs::File* stdin_file,
                                              vfs::File* stdout_file,
                                              vfs::File* stderr_file)
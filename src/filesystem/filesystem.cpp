@@ -2,17 +2,41 @@
  * @copyright Copyright The SimpleKernel Contributors
  */
 
+#include "block_queue.hpp"
+#include "buffer_cache.hpp"
 #include "device_manager.hpp"
 #include "device_node.hpp"
 #include "fatfs.hpp"
 #include "kernel_log.hpp"
+#include "kstd_memory"
 #include "mount.hpp"
 #include "ramfs.hpp"
+#include "task_control_block.hpp"
+#include "task_manager.hpp"
 #include "vfs.hpp"
 
 /// @brief FatFS 逻辑驱动器号（对应 rootfs.img）
 static constexpr uint8_t kRootFsDriveId = 0;
 
+/// @brief FatFS 所在块设备的写回缓存，FileSystemStartTasks 为其启动冲刷任务
+static vfs::BufferCache* root_buffer_cache = nullptr;
+
+/**
+ * @brief 块缓存冲刷任务
+ * @param arg vfs::BufferCache*
+ */
+static auto BufferFlusherMain(void* arg) -> void {
+  auto* cache = static_cast<vfs::BufferCache*>(arg);
+  while (true) {
+    TaskManagerSingleton::instance().Sleep(vfs::BufferCache::kFlushIntervalMs);
+    auto result = cache->Tick();
+    if (!result.has_value()) {
+      klog::Err("BufferFlusher: {} write back failed: {}", cache->GetName(),
+                result.error().message());
+    }
+  }
+}
+
 /// @brief 文件系统子系统初始化入口
 auto FileSystemInit() -> void {
   // 初始化 VFS
@@ -38,13 +62,20 @@ auto FileSystemInit() -> void {
       DeviceType::kBlock, blk_nodes, 4);
 
   if (blk_count > 0 && blk_nodes[0]->block_device != nullptr) {
-    auto* blk = blk_nodes[0]->block_device;
+    // FatFS 经写回缓存与块请求队列访问块设备
+    static vfs::BlockQueue block_queue(blk_nodes[0]->block_device);
+    static vfs::BufferCache buffer_cache(&block_queue);
+    root_buffer_cache = &buffer_cache;
+    auto* blk = &buffer_cache;
     static fatfs::FatFsFileSystem fat_fs(kRootFsDriveId);
     auto fat_mount = fat_fs.Mount(blk);
     if (!fat_mount.has_value()) {
       klog::Err("FileSystemInit: FatFsFileSystem::Mount failed: {}",
                 fat_mount.error().message());
     } else {
+      // 挂载点必须是已存在的目录，已存在时忽略错误
+      (void)vfs::MkDir("/mnt");
+      (void)vfs::MkDir("/mnt/fat");
       auto vfs_mount = vfs::GetMountTable().Mount("/mnt/fat", &fat_fs, blk);
       if (!vfs_mount.has_value()) {
         klog::Err("FileSystemInit: vfs mount at /mnt/fat failed: {}",
@@ -58,3 +89,18 @@ auto FileSystemInit() -> void {
 
   klog::Info("FileSystemInit: complete");
 }
+
+auto FileSystemStartTasks() -> void {
+  if (root_buffer_cache == nullptr) {
+    return;
+  }
+  auto flusher = kstd::make_unique<TaskControlBlock>(
+      "BufferFlusher", 10, BufferFlusherMain, root_buffer_cache);
+  if (!flusher) {
+    klog::Err("FileSystemStartTasks: failed to create buffer flusher");
+    return;
+  }
+  TaskManagerSingleton::instance().AddTask(flusher.release());
+  klog::Info("FileSystemStartTasks: buffer flusher started for {}",
+             root_buffer_cache->GetName());
+}
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
@@ -56,6 +57,15 @@ class FileDescriptorTable {
    */
   [[nodiscard]] auto Get(int fd) -> vfs::File*;
 
+  /**
+   * @brief 获取 fd 对应的 File 对象并增加其引用计数
+   * @param fd 文件描述符
+   * @return vfs::File* 指针，无效 fd 返回 nullptr
+   * @note 使用完毕后调用 vfs::Close 释放，期间其它共享者关闭该 fd
+   *       也不会销毁 File
+   */
+  [[nodiscard]] auto Acquire(int fd) -> vfs::File*;
+
   /**
    * @brief 释放 fd
    * @param fd 要释放的文件描述符
@@ -89,6 +99,38 @@ class FileDescriptorTable {
                                         vfs::File* stdout_file,
                                         vfs::File* stderr_file)
       -> Expected<void>;
+  /**
+   * @brief 关闭 fd 并释放其对 File 的引用
+   * @param fd 要关闭的文件描述符
+   * @return Expected<void> 成功或错误
+   * @note 与 Free 不同，会调用 vfs::Close，最后一个引用释放时 File 被销毁
+   */
+  [[nodiscard]] auto Close(int fd) -> Expected<void>;
+
+  /**
+   * @brief 关闭所有文件描述符并释放其对 File 的引用
+   * @note 用于最后一个共享者退出时，CloseAll 则只清空表项
+   */
+  auto CloseFiles() -> void;
+
+  /**
+   * @brief 复制出一张新表（用于不带 kFiles 的 clone/fork）
+   * @return Expected<FileDescriptorTable*> 新表，由调用者负责释放
+   * @post 新表与原表的同号 fd 指向同一个 File，共享文件偏移量
+   */
+  [[nodiscard]] auto Clone() -> Expected<FileDescriptorTable*>;
+
+  /**
+   * @brief 增加共享该表的任务数（用于带 kFiles 的 clone）
+   */
+  auto Ref() -> void;
+
+  /**
+   * @brief 减少共享该表的任务数
+   * @return bool 最后一个共享者释放时返回 true，调用者负责关闭文件并释放表
+   */
+  [[nodiscard]] auto Unref() -> bool;
+
   /**
    * @brief 获取已打开文件描述符数量
    * @return int 已打开 fd 数量
@@ -98,6 +140,8 @@ class FileDescriptorTable {
  private:
   std::array<vfs::File*, kMaxFd> table_;
   int open_count_{0};
+  /// 共享该表的任务数
+  std::atomic<uint32_t> users_{1};
   SpinLock lock_{"fd_table"};
 };
 
@@ -4,7 +4,15 @@
 
 #pragma once
 
+#include <cpu_io.h>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
 #include "filesystem.hpp"
+#include "spinlock.hpp"
 #include "vfs.hpp"
 
 namespace ramfs {
@@ -87,6 +95,21 @@ class RamFs : public vfs::FileSystem {
    */
   [[nodiscard]] auto GetFileOps() -> vfs::FileOps*;
 
+  /**
+   * @brief 截断普通文件，释放新长度之后的页
+   * @param inode 普通文件 inode
+   * @param size 新长度，大于当前长度时扩展为空洞
+   * @return Expected<void> 成功或错误
+   * @pre 调用者持有 inode 的写锁
+   */
+  auto Truncate(vfs::Inode* inode, uint64_t size) -> Expected<void>;
+
+  /**
+   * @brief 获取文件数据占用的页数（含基数树的内部节点）
+   * @return size_t 页数
+   */
+  [[nodiscard]] auto GetUsedPages() const -> size_t;
+
   /// @brief Inode 操作实现类
   class RamFsInodeOps : public vfs::InodeOps {
    public:
@@ -112,8 +135,13 @@ class RamFs : public vfs::FileSystem {
         -> Expected<size_t> override;
     auto Write(vfs::File* file, const void* buf, size_t count)
         -> Expected<size_t> override;
+    auto PRead(vfs::File* file, void* buf, size_t count, uint64_t offset)
+        -> Expected<size_t> override;
+    auto PWrite(vfs::File* file, const void* buf, size_t count,
+                uint64_t offset) -> Expected<size_t> override;
     auto Seek(vfs::File* file, int64_t offset, vfs::SeekWhence whence)
         -> Expected<uint64_t> override;
+    auto Open(vfs::File* file) -> Expected<void> override;
     auto Close(vfs::File* file) -> Expected<void> override;
     auto ReadDir(vfs::File* file, vfs::DirEntry* dirent, size_t count)
         -> Expected<size_t> override;
@@ -126,36 +154,92 @@ class RamFs : public vfs::FileSystem {
   friend class RamFsFileOps;
 
  private:
+  /// 页大小
+  static constexpr size_t kPageSize = cpu_io::virtual_memory::kPageSize;
+  /// 基数树每个节点的槽位数（一个节点占一页）
+  static constexpr size_t kPageSlots = kPageSize / sizeof(void*);
+  /// 每级基数树消耗的页号位数
+  static constexpr size_t kSlotShift = std::countr_zero(kPageSlots);
+  /// 基数树的最大高度，足以覆盖 64 位文件偏移
+  static constexpr uint32_t kMaxPageHeight =
+      (64 - std::countr_zero(kPageSize) + kSlotShift - 1) / kSlotShift;
+
+  /// @brief 页基数树的内部节点
+  struct PageNode {
+    std::array<void*, kPageSlots> slots;
+  };
+
+  /// @brief 目录项，由所在目录的散列表索引
+  struct RamDirEntry {
+    /// 同一散列桶中的下一项
+    RamDirEntry* hash_next;
+    /// 文件名（堆分配，以 '\0' 结尾）
+    char* name;
+    /// 文件名长度
+    size_t name_len;
+    /// 文件名散列值
+    uint32_t hash;
+    /// 在目录槽位表中的下标，作为 readdir 的稳定位置
+    uint32_t slot;
+    vfs::Inode* inode;
+  };
+
+  /// @brief 目录槽位，空闲槽位串成链表供后续插入复用
+  struct DirSlot {
+    /// 占用该槽位的目录项，空闲时为 nullptr
+    RamDirEntry* entry;
+    /// 下一个空闲槽位
+    uint32_t next_free;
+  };
+
   /// @brief ramfs 内部 inode 数据
   struct RamInode {
     vfs::Inode inode;
-    /// 文件数据（普通文件）或子项列表（目录）
-    void* data;
-    /// 数据缓冲区容量
-    size_t capacity;
+    /// 目录项散列桶（仅目录），桶数为 2 的幂
+    RamDirEntry** buckets;
+    /// 散列桶数量（仅目录）
+    uint32_t bucket_count;
+    /// 槽位表（仅目录），目录项在其生命周期内不改变槽位
+    DirSlot* slots;
+    /// 槽位表容量（仅目录）
+    uint32_t slot_capacity;
+    /// 已使用过的槽位数，之后的槽位从未使用（仅目录）
+    uint32_t slot_used;
+    /// 空闲槽位链表头（仅目录）
+    uint32_t free_slot;
+    /// 文件数据页基数树的根（仅普通文件），高度为 0 时直接指向数据页
+    void* page_root;
+    /// 基数树高度，可寻址 kPageSlots^page_height 页
+    uint32_t page_height;
+    /// 打开的 File 数，与 link_count 都为 0 时释放 inode
+    uint32_t open_count;
     /// 子项数量（仅目录）
     size_t child_count;
     /// 空闲链表指针
     RamInode* next_free;
   };
 
-  /// @brief 目录项结构（存储在目录的 data 中）
-  struct RamDirEntry {
-    char name[256];
-    vfs::Inode* inode;
-  };
-
+  /// 静态 inode 表大小
   static constexpr size_t kMaxInodes = 1024;
-  /// 初始文件容量
-  static constexpr size_t kInitialCapacity = 256;
+  /// 每个堆上 inode 块包含的 inode 数
+  static constexpr size_t kInodesPerChunk = 256;
+
+  /// @brief 静态 inode 表用尽后从堆上分配的 inode 块
+  struct InodeChunk {
+    InodeChunk* next;
+    std::array<RamInode, kInodesPerChunk> inodes;
+  };
 
-  // Static pool constants — zero heap allocation
-  /// File data pool: 1 MB for regular file content
-  static constexpr size_t kFileDataPoolSize = 1024UL * 1024UL;
-  /// Dir data pool: 256 KB for directory entry arrays
-  static constexpr size_t kDirDataPoolSize = 256UL * 1024UL;
+  /// 空闲槽位链表结束标记
+  static constexpr uint32_t kNoSlot = UINT32_MAX;
+  /// 目录的初始散列桶与槽位数量
+  static constexpr uint32_t kInitialDirSize = 16;
+  /// 文件名最大长度
+  static constexpr size_t kMaxNameLen = 255;
 
   RamInode inodes_[kMaxInodes];
+  /// 堆上分配的 inode 块链表，卸载时释放
+  InodeChunk* inode_chunks_{nullptr};
   /// 空闲 inode 链表头
   RamInode* free_list_{nullptr};
   /// 根目录 inode
@@ -165,11 +249,10 @@ class RamFs : public vfs::FileSystem {
   /// 是否已挂载
   bool mounted_{false};
 
-  // Static pools (bump allocator, reset on Unmount)
-  alignas(16) uint8_t file_data_pool_[kFileDataPoolSize];
-  size_t file_data_pool_used_{0};
-  alignas(alignof(RamDirEntry)) uint8_t dir_data_pool_[kDirDataPoolSize];
-  size_t dir_data_pool_used_{0};
+  /// 文件数据占用的页数
+  std::atomic<size_t> used_pages_{0};
+  /// 保护 inode 空闲链表，目录与文件内容由 VFS 的 inode 锁保护
+  SpinLock alloc_lock_{"ramfs_alloc"};
 
   // 操作实例
   RamFsInodeOps inode_ops_;
@@ -181,11 +264,25 @@ class RamFs : public vfs::FileSystem {
       -> Expected<void>;
   auto RemoveFromDirectory(RamInode* dir, const char* name) -> Expected<void>;
   auto IsDirectoryEmpty(RamInode* dir) -> bool;
-  auto ExpandFile(RamInode* inode, size_t new_size) -> Expected<void>;
-  /// Bump-allocate @p size bytes from the file data pool.
-  auto AllocateFileData(size_t size) -> void*;
-  /// Bump-allocate space for @p count RamDirEntry from the dir pool.
-  auto AllocateDirEntries(size_t count) -> RamDirEntry*;
+  /// 散列表负载过高时加倍桶数并重新散列
+  auto GrowBuckets(RamInode* dir) -> Expected<void>;
+  /// 从空闲链表或槽位表末尾取一个槽位，必要时加倍槽位表
+  auto AllocateSlot(RamInode* dir) -> Expected<uint32_t>;
+  /// 减少链接计数（@p unlink 为 true）或打开计数，两者都为 0 时释放 inode
+  auto ReleaseInode(RamInode* inode, bool unlink) -> void;
+  /// 释放 inode 的数据页或目录索引
+  auto ReleaseContents(RamInode* inode) -> void;
+  /// 分配一个清零的页
+  auto AllocatePage() -> void*;
+  /// 释放 AllocatePage 分配的页
+  auto FreePage(void* page) -> void;
+  /// 查找文件的第 @p index 页，空洞返回 nullptr
+  auto FindPage(RamInode* inode, uint64_t index) -> uint8_t*;
+  /// 查找文件的第 @p index 页，不存在时分配（必要时增加树高）
+  auto GetOrCreatePage(RamInode* inode, uint64_t index) -> Expected<uint8_t*>;
+  /// 释放子树中页号不小于 @p start 的页，子树变空时释放节点
+  auto TrimPages(void*& slot, uint32_t level, uint64_t base, uint64_t start)
+      -> void;
 };
 
 }  // namespace ramfs
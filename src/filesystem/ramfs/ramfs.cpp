@@ -6,22 +6,45 @@
 
 #include "kernel_log.hpp"
 #include "kstd_cstring"
+#include "kstd_memory"
+#include "sk_stdlib.h"
 #include "vfs.hpp"
 
 namespace ramfs {
 
 using namespace vfs;
 
+namespace {
+
+/// FNV-1a 参数
+constexpr uint32_t kFnvOffsetBasis = 2166136261U;
+constexpr uint32_t kFnvPrime = 16777619U;
+
+/**
+ * @brief 计算文件名的散列值
+ * @param name 文件名
+ * @param len 文件名长度
+ * @return uint32_t 散列值
+ */
+auto HashName(const char* name, size_t len) -> uint32_t {
+  uint32_t hash = kFnvOffsetBasis;
+  for (size_t i = 0; i < len; ++i) {
+    hash ^= static_cast<uint8_t>(name[i]);
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+}  // namespace
+
 RamFs::RamFs()
     : inodes_{},
+      inode_chunks_(nullptr),
       free_list_(nullptr),
       root_inode_(nullptr),
       used_inodes_(0),
       mounted_(false),
-      file_data_pool_{},
-      file_data_pool_used_(0),
-      dir_data_pool_{},
-      dir_data_pool_used_(0),
+      used_pages_(0),
       inode_ops_(this),
       file_ops_(this) {}
 
@@ -60,12 +83,7 @@ auto RamFs::Mount(BlockDevice* device) -> Expected<Inode*> {
   root_inode_ = root_result.value();
   root_inode_->type = FileType::kDirectory;
   root_inode_->permissions = 0755;
-
-  // 初始化根目录数据
-  RamInode* ram_root = static_cast<RamInode*>(root_inode_->fs_private);
-  ram_root->data = nullptr;
-  ram_root->capacity = 0;
-  ram_root->child_count = 0;
+  root_inode_->link_count = 1;
 
   used_inodes_ = 1;
   mounted_ = true;
@@ -81,21 +99,24 @@ auto RamFs::Unmount() -> Expected<void> {
 
   klog::Info("RamFs: unmounting...");
 
-  // Clear all inode data pointers (data lives in static pools)
-  for (size_t i = 0; i < kMaxInodes; ++i) {
-    if (inodes_[i].inode.type != FileType::kUnknown &&
-        inodes_[i].data != nullptr) {
-      inodes_[i].data = nullptr;
+  // 释放文件数据页与目录索引
+  for (auto& ram_inode : inodes_) {
+    ReleaseContents(&ram_inode);
+  }
+  while (inode_chunks_ != nullptr) {
+    InodeChunk* next = inode_chunks_->next;
+    for (auto& ram_inode : inode_chunks_->inodes) {
+      ReleaseContents(&ram_inode);
     }
+    delete inode_chunks_;
+    inode_chunks_ = next;
   }
 
-  // 重置状态并释放静态池
+  // 重置状态
   free_list_ = nullptr;
   root_inode_ = nullptr;
   used_inodes_ = 0;
   mounted_ = false;
-  file_data_pool_used_ = 0;
-  dir_data_pool_used_ = 0;
 
   klog::Info("RamFs: unmounted");
   return {};
@@ -107,8 +128,19 @@ auto RamFs::Sync() -> Expected<void> {
 }
 
 auto RamFs::AllocateInode() -> Expected<Inode*> {
+  LockGuard<SpinLock> guard(alloc_lock_);
   if (free_list_ == nullptr) {
-    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+    // 静态 inode 表用尽，从堆上扩充
+    auto chunk = kstd::make_unique<InodeChunk>();
+    if (!chunk) {
+      return std::unexpected(Error(ErrorCode::kOutOfMemory));
+    }
+    chunk->next = inode_chunks_;
+    inode_chunks_ = chunk.release();
+    for (auto& ram_inode : inode_chunks_->inodes) {
+      ram_inode.next_free = free_list_;
+      free_list_ = &ram_inode;
+    }
   }
 
   RamInode* ram_inode = free_list_;
@@ -119,13 +151,21 @@ auto RamFs::AllocateInode() -> Expected<Inode*> {
   ram_inode->inode.type = FileType::kUnknown;
   ram_inode->inode.size = 0;
   ram_inode->inode.permissions = 0644;
-  ram_inode->inode.link_count = 1;
+  // 加入目录时增加
+  ram_inode->inode.link_count = 0;
   ram_inode->inode.fs_private = ram_inode;
   ram_inode->inode.fs = this;
   ram_inode->inode.ops = &inode_ops_;
 
-  ram_inode->data = nullptr;
-  ram_inode->capacity = 0;
+  ram_inode->buckets = nullptr;
+  ram_inode->bucket_count = 0;
+  ram_inode->slots = nullptr;
+  ram_inode->slot_capacity = 0;
+  ram_inode->slot_used = 0;
+  ram_inode->free_slot = kNoSlot;
+  ram_inode->page_root = nullptr;
+  ram_inode->page_height = 0;
+  ram_inode->open_count = 0;
   ram_inode->child_count = 0;
   ram_inode->next_free = nullptr;
 
@@ -140,10 +180,10 @@ auto RamFs::FreeInode(Inode* inode) -> Expected<void> {
 
   RamInode* ram_inode = static_cast<RamInode*>(inode->fs_private);
 
-  // Data lives in static pools; just clear the pointer (no individual reclaim)
-  if (ram_inode->data != nullptr) {
-    ram_inode->data = nullptr;
-  }
+  // 释放文件数据页与目录索引
+  ReleaseContents(ram_inode);
+
+  LockGuard<SpinLock> guard(alloc_lock_);
 
   // 重置 inode
   ram_inode->inode.type = FileType::kUnknown;
@@ -151,9 +191,6 @@ auto RamFs::FreeInode(Inode* inode) -> Expected<void> {
   ram_inode->inode.fs_private = nullptr;
   ram_inode->inode.ops = nullptr;
 
-  ram_inode->capacity = 0;
-  ram_inode->child_count = 0;
-
   // 加入空闲链表
   ram_inode->next_free = free_list_;
   free_list_ = ram_inode;
@@ -166,6 +203,42 @@ auto RamFs::GetRootInode() const -> Inode* { return root_inode_; }
 
 auto RamFs::GetFileOps() -> FileOps* { return &file_ops_; }
 
+auto RamFs::Truncate(Inode* inode, uint64_t size) -> Expected<void> {
+  if (inode == nullptr) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  if (inode->type != FileType::kRegular) {
+    return std::unexpected(Error(ErrorCode::kFsIsADirectory));
+  }
+
+  RamInode* ram_inode = static_cast<RamInode*>(inode->fs_private);
+  if (size < inode->size) {
+    // 释放完全位于新长度之后的页
+    uint64_t first_free = (size + kPageSize - 1) / kPageSize;
+    TrimPages(ram_inode->page_root, ram_inode->page_height, 0, first_free);
+    if (ram_inode->page_root == nullptr) {
+      ram_inode->page_height = 0;
+    }
+
+    // 清零最后一页的尾部，保证文件末尾之后的字节读出为 0
+    size_t tail = size % kPageSize;
+    if (tail != 0) {
+      uint8_t* page = FindPage(ram_inode, size / kPageSize);
+      if (page != nullptr) {
+        memset(page + tail, 0, kPageSize - tail);
+      }
+    }
+  }
+
+  inode->size = size;
+  return {};
+}
+
+auto RamFs::GetUsedPages() const -> size_t {
+  return used_pages_.load(std::memory_order_relaxed);
+}
+
 // InodeOps 实现
 
 auto RamFs::RamFsInodeOps::Lookup(Inode* dir, const char* name)
@@ -236,16 +309,14 @@ auto RamFs::RamFsInodeOps::Unlink(Inode* dir, const char* name)
   }
 
   // 从目录中移除
+  Inode* target = entry->inode;
   auto remove_result = fs_->RemoveFromDirectory(ram_dir, name);
   if (!remove_result.has_value()) {
     return remove_result;
   }
 
-  // 如果链接计数为 0，释放 inode
-  if (entry->inode != nullptr && entry->inode->link_count == 0) {
-    fs_->FreeInode(entry->inode);
-  }
-
+  // 仍被打开时延迟到最后一次关闭再释放 inode 与数据页
+  fs_->ReleaseInode(static_cast<RamInode*>(target->fs_private), true);
   return {};
 }
 
@@ -287,10 +358,7 @@ auto RamFs::RamFsInodeOps::Rmdir(Inode* dir, const char* name)
   }
 
   // 释放 inode
-  if (entry->inode->link_count == 0) {
-    fs_->FreeInode(entry->inode);
-  }
-
+  fs_->ReleaseInode(target, true);
   return {};
 }
 
@@ -298,6 +366,32 @@ auto RamFs::RamFsInodeOps::Rmdir(Inode* dir, const char* name)
 
 auto RamFs::RamFsFileOps::Read(File* file, void* buf, size_t count)
     -> Expected<size_t> {
+  if (file == nullptr) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  auto result = PRead(file, buf, count, file->offset);
+  if (result.has_value()) {
+    file->offset += result.value();
+  }
+  return result;
+}
+
+auto RamFs::RamFsFileOps::Write(File* file, const void* buf, size_t count)
+    -> Expected<size_t> {
+  if (file == nullptr) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  auto result = PWrite(file, buf, count, file->offset);
+  if (result.has_value()) {
+    file->offset += result.value();
+  }
+  return result;
+}
+
+auto RamFs::RamFsFileOps::PRead(File* file, void* buf, size_t count,
+                                uint64_t offset) -> Expected<size_t> {
   if (file == nullptr || buf == nullptr) {
     return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
@@ -313,26 +407,38 @@ auto RamFs::RamFsFileOps::Read(File* file, void* buf, size_t count)
   RamInode* ram_inode = static_cast<RamInode*>(file->inode->fs_private);
 
   // 计算可读字节数
-  if (file->offset >= file->inode->size) {
+  if (offset >= file->inode->size) {
     return 0;  // EOF
   }
 
-  size_t available = file->inode->size - file->offset;
+  size_t available = file->inode->size - offset;
   size_t to_read = (count < available) ? count : available;
 
-  if (to_read == 0) {
-    return 0;
-  }
+  // 逐页复制数据，空洞读出为 0
+  auto* dst = static_cast<uint8_t*>(buf);
+  size_t done = 0;
+  while (done < to_read) {
+    uint64_t pos = offset + done;
+    size_t page_offset = pos % kPageSize;
+    size_t chunk = kPageSize - page_offset;
+    if (chunk > to_read - done) {
+      chunk = to_read - done;
+    }
 
-  // 复制数据
-  memcpy(buf, static_cast<uint8_t*>(ram_inode->data) + file->offset, to_read);
+    uint8_t* page = fs_->FindPage(ram_inode, pos / kPageSize);
+    if (page == nullptr) {
+      memset(dst + done, 0, chunk);
+    } else {
+      memcpy(dst + done, page + page_offset, chunk);
+    }
+    done += chunk;
+  }
 
-  file->offset += to_read;
   return to_read;
 }
 
-auto RamFs::RamFsFileOps::Write(File* file, const void* buf, size_t count)
-    -> Expected<size_t> {
+auto RamFs::RamFsFileOps::PWrite(File* file, const void* buf, size_t count,
+                                 uint64_t offset) -> Expected<size_t> {
   if (file == nullptr || buf == nullptr) {
     return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
@@ -347,26 +453,40 @@ auto RamFs::RamFsFileOps::Write(File* file, const void* buf, size_t count)
 
   RamInode* ram_inode = static_cast<RamInode*>(file->inode->fs_private);
 
-  // 检查是否需要扩展文件
-  size_t new_size = file->offset + count;
-  if (new_size > ram_inode->capacity) {
-    auto expand_result = fs_->ExpandFile(ram_inode, new_size);
-    if (!expand_result.has_value()) {
-      return std::unexpected(expand_result.error());
-    }
+  uint64_t new_size = offset + count;
+  if (new_size < offset) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
 
-  // 写入数据
-  memcpy(static_cast<uint8_t*>(ram_inode->data) + file->offset, buf, count);
+  // 逐页写入，按需分配页；越过文件末尾留下的空洞不分配页，读出为 0
+  const auto* src = static_cast<const uint8_t*>(buf);
+  size_t done = 0;
+  while (done < count) {
+    uint64_t pos = offset + done;
+    size_t page_offset = pos % kPageSize;
+    size_t chunk = kPageSize - page_offset;
+    if (chunk > count - done) {
+      chunk = count - done;
+    }
 
-  file->offset += count;
+    auto page_result = fs_->GetOrCreatePage(ram_inode, pos / kPageSize);
+    if (!page_result.has_value()) {
+      // 已写入部分数据时返回实际写入的字节数
+      if (done == 0) {
+        return std::unexpected(page_result.error());
+      }
+      break;
+    }
+    memcpy(page_result.value() + page_offset, src + done, chunk);
+    done += chunk;
+  }
 
   // 更新文件大小
-  if (file->offset > file->inode->size) {
-    file->inode->size = file->offset;
+  if (offset + done > file->inode->size) {
+    file->inode->size = offset + done;
   }
 
-  return count;
+  return done;
 }
 
 auto RamFs::RamFsFileOps::Seek(File* file, int64_t offset, SeekWhence whence)
@@ -412,13 +532,27 @@ auto RamFs::RamFsFileOps::Seek(File* file, int64_t offset, SeekWhence whence)
   return new_offset;
 }
 
+auto RamFs::RamFsFileOps::Open(File* file) -> Expected<void> {
+  if (file == nullptr || file->inode == nullptr) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  RamInode* ram_inode = static_cast<RamInode*>(file->inode->fs_private);
+  LockGuard<SpinLock> guard(fs_->alloc_lock_);
+  ++ram_inode->open_count;
+  return {};
+}
+
 auto RamFs::RamFsFileOps::Close(File* file) -> Expected<void> {
   if (file == nullptr) {
     return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
 
-  // ramfs 没有特殊的关闭操作
+  // 已删除的文件在最后一次关闭时释放
   // File 对象由调用者释放
+  if (file->inode != nullptr) {
+    fs_->ReleaseInode(static_cast<RamInode*>(file->inode->fs_private), false);
+  }
   return {};
 }
 
@@ -434,8 +568,6 @@ auto RamFs::RamFsFileOps::ReadDir(File* file, DirEntry* dirent, size_t count)
 
   RamInode* ram_dir = static_cast<RamInode*>(file->inode->fs_private);
 
-  RamDirEntry* entries = static_cast<RamDirEntry*>(ram_dir->data);
-
   size_t read_count = 0;
   size_t offset = file->offset;
 
@@ -460,19 +592,24 @@ auto RamFs::RamFsFileOps::ReadDir(File* file, DirEntry* dirent, size_t count)
     ++offset;
   }
 
-  // 读取实际目录项（跳过 . 和 .. 的偏移）
-  size_t entry_idx = (offset > 2) ? offset - 2 : 0;
-  while (read_count < count && entry_idx < ram_dir->child_count) {
-    dirent[read_count].ino = entries[entry_idx].inode->ino;
-    dirent[read_count].type =
-        static_cast<uint8_t>(entries[entry_idx].inode->type);
-    strncpy(dirent[read_count].name, entries[entry_idx].name,
-            sizeof(dirent[read_count].name));
+  // 偏移 2 之后是槽位下标加 2，目录项的槽位不变，
+  // 读取期间的插入与删除不会使其它目录项被跳过或重复返回
+  size_t slot = (offset > 2) ? offset - 2 : 0;
+  while (read_count < count && slot < ram_dir->slot_used) {
+    RamDirEntry* entry = ram_dir->slots[slot].entry;
+    ++slot;
+    if (entry == nullptr) {
+      continue;
+    }
+    dirent[read_count].ino = entry->inode->ino;
+    dirent[read_count].type = static_cast<uint8_t>(entry->inode->type);
+    strncpy(dirent[read_count].name, entry->name,
+            sizeof(dirent[read_count].name) - 1);
+    dirent[read_count].name[sizeof(dirent[read_count].name) - 1] = '\0';
     ++read_count;
-    ++entry_idx;
   }
 
-  file->offset = offset + read_count;
+  file->offset = (offset >= 2) ? slot + 2 : offset;
   return read_count;
 }
 
@@ -480,15 +617,19 @@ auto RamFs::RamFsFileOps::ReadDir(File* file, DirEntry* dirent, size_t count)
 
 auto RamFs::FindInDirectory(RamInode* dir, const char* name) -> RamDirEntry* {
   if (dir == nullptr || dir->inode.type != FileType::kDirectory ||
-      dir->data == nullptr) {
+      dir->buckets == nullptr) {
     return nullptr;
   }
 
-  RamDirEntry* entries = static_cast<RamDirEntry*>(dir->data);
-  for (size_t i = 0; i < dir->child_count; ++i) {
-    if (strcmp(entries[i].name, name) == 0) {
-      return &entries[i];
+  size_t len = strlen(name);
+  uint32_t hash = HashName(name, len);
+  RamDirEntry* entry = dir->buckets[hash & (dir->bucket_count - 1)];
+  while (entry != nullptr) {
+    if (entry->hash == hash && entry->name_len == len &&
+        memcmp(entry->name, name, len) == 0) {
+      return entry;
     }
+    entry = entry->hash_next;
   }
 
   return nullptr;
@@ -504,36 +645,49 @@ auto RamFs::AddToDirectory(RamInode* dir, const char* name, Inode* inode)
     return std::unexpected(Error(ErrorCode::kFsNotADirectory));
   }
 
+  size_t len = strlen(name);
+  if (len == 0 || len > kMaxNameLen) {
+    return std::unexpected(Error(ErrorCode::kFsInvalidPath));
+  }
+
   // 检查是否已存在
   if (FindInDirectory(dir, name) != nullptr) {
     return std::unexpected(Error(ErrorCode::kFsFileExists));
   }
 
-  // 扩展目录容量
-  size_t current_entries = dir->capacity / sizeof(RamDirEntry);
-  if (dir->child_count >= current_entries) {
-    size_t new_capacity = (current_entries == 0) ? 16 : current_entries * 2;
-    RamDirEntry* new_data = AllocateDirEntries(new_capacity);
-    if (new_data == nullptr) {
-      return std::unexpected(Error(ErrorCode::kOutOfMemory));
-    }
-
-    // 复制旧数据
-    if (dir->data != nullptr) {
-      memcpy(new_data, dir->data, dir->child_count * sizeof(RamDirEntry));
-      // Old allocation stays in pool (bump allocator — no per-entry free)
-    }
+  // 先分配目录项，失败时目录保持不变
+  auto entry = kstd::make_unique<RamDirEntry>();
+  if (!entry) {
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  }
+  entry->name = new char[len + 1];
+  if (entry->name == nullptr) {
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  }
+  memcpy(entry->name, name, len + 1);
+  entry->name_len = len;
+  entry->hash = HashName(name, len);
+  entry->inode = inode;
 
-    dir->data = new_data;
-    dir->capacity = new_capacity * sizeof(RamDirEntry);
+  auto grow_result = GrowBuckets(dir);
+  if (!grow_result.has_value()) {
+    delete[] entry->name;
+    return std::unexpected(grow_result.error());
+  }
+  auto slot_result = AllocateSlot(dir);
+  if (!slot_result.has_value()) {
+    delete[] entry->name;
+    return std::unexpected(slot_result.error());
   }
 
-  // 添加新条目
-  RamDirEntry* entries = static_cast<RamDirEntry*>(dir->data);
-  RamDirEntry* new_entry = &entries[dir->child_count];
-  strncpy(new_entry->name, name, sizeof(new_entry->name) - 1);
-  new_entry->name[sizeof(new_entry->name) - 1] = '\0';
-  new_entry->inode = inode;
+  // 插入散列桶与槽位表
+  RamDirEntry* new_entry = entry.release();
+  new_entry->slot = slot_result.value();
+  RamDirEntry*& bucket =
+      dir->buckets[new_entry->hash & (dir->bucket_count - 1)];
+  new_entry->hash_next = bucket;
+  bucket = new_entry;
+  dir->slots[new_entry->slot].entry = new_entry;
 
   ++dir->child_count;
   ++inode->link_count;
@@ -552,22 +706,123 @@ auto RamFs::RemoveFromDirectory(RamInode* dir, const char* name)
     return std::unexpected(Error(ErrorCode::kFsFileNotFound));
   }
 
-  // 减少链接计数
-  if (entry->inode != nullptr) {
-    --entry->inode->link_count;
+  // 从散列桶中摘除
+  RamDirEntry** link = &dir->buckets[entry->hash & (dir->bucket_count - 1)];
+  while (*link != entry) {
+    link = &(*link)->hash_next;
   }
+  *link = entry->hash_next;
 
-  // 移除条目（将最后一个条目移到此处）
-  RamDirEntry* entries = static_cast<RamDirEntry*>(dir->data);
-  size_t last_idx = dir->child_count - 1;
-  if (entry != &entries[last_idx]) {
-    *entry = entries[last_idx];
-  }
+  // 归还槽位
+  dir->slots[entry->slot].entry = nullptr;
+  dir->slots[entry->slot].next_free = dir->free_slot;
+  dir->free_slot = entry->slot;
 
+  delete[] entry->name;
+  delete entry;
   --dir->child_count;
   return {};
 }
 
+auto RamFs::GrowBuckets(RamInode* dir) -> Expected<void> {
+  // 负载因子不超过 1
+  if (dir->child_count < dir->bucket_count) {
+    return {};
+  }
+
+  uint32_t new_count =
+      (dir->bucket_count == 0) ? kInitialDirSize : dir->bucket_count * 2;
+  auto* new_buckets = new RamDirEntry*[new_count]();
+  if (new_buckets == nullptr) {
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  }
+
+  for (uint32_t i = 0; i < dir->bucket_count; ++i) {
+    RamDirEntry* entry = dir->buckets[i];
+    while (entry != nullptr) {
+      RamDirEntry* next = entry->hash_next;
+      RamDirEntry*& bucket = new_buckets[entry->hash & (new_count - 1)];
+      entry->hash_next = bucket;
+      bucket = entry;
+      entry = next;
+    }
+  }
+
+  delete[] dir->buckets;
+  dir->buckets = new_buckets;
+  dir->bucket_count = new_count;
+  return {};
+}
+
+auto RamFs::AllocateSlot(RamInode* dir) -> Expected<uint32_t> {
+  // 优先复用已释放的槽位
+  if (dir->free_slot != kNoSlot) {
+    uint32_t slot = dir->free_slot;
+    dir->free_slot = dir->slots[slot].next_free;
+    return slot;
+  }
+
+  if (dir->slot_used == dir->slot_capacity) {
+    uint32_t new_capacity =
+        (dir->slot_capacity == 0) ? kInitialDirSize : dir->slot_capacity * 2;
+    auto* new_slots = new DirSlot[new_capacity]();
+    if (new_slots == nullptr) {
+      return std::unexpected(Error(ErrorCode::kOutOfMemory));
+    }
+    if (dir->slots != nullptr) {
+      memcpy(new_slots, dir->slots, dir->slot_used * sizeof(DirSlot));
+    }
+    delete[] dir->slots;
+    dir->slots = new_slots;
+    dir->slot_capacity = new_capacity;
+  }
+
+  return dir->slot_used++;
+}
+
+auto RamFs::ReleaseInode(RamInode* inode, bool unlink) -> void {
+  bool release = false;
+  {
+    // 链接与打开计数在同一把锁下修改，只有一方会看到两者都降为 0
+    LockGuard<SpinLock> guard(alloc_lock_);
+    if (unlink) {
+      --inode->inode.link_count;
+    } else if (inode->open_count == 0) {
+      // 未经 Open 的 File 不持有 inode
+      return;
+    } else {
+      --inode->open_count;
+    }
+    release = inode->inode.link_count == 0 && inode->open_count == 0;
+  }
+
+  if (release) {
+    (void)FreeInode(&inode->inode);
+  }
+}
+
+auto RamFs::ReleaseContents(RamInode* inode) -> void {
+  TrimPages(inode->page_root, inode->page_height, 0, 0);
+  inode->page_height = 0;
+
+  for (uint32_t i = 0; i < inode->slot_used; ++i) {
+    RamDirEntry* entry = inode->slots[i].entry;
+    if (entry != nullptr) {
+      delete[] entry->name;
+      delete entry;
+    }
+  }
+  delete[] inode->slots;
+  delete[] inode->buckets;
+  inode->slots = nullptr;
+  inode->buckets = nullptr;
+  inode->slot_capacity = 0;
+  inode->slot_used = 0;
+  inode->free_slot = kNoSlot;
+  inode->bucket_count = 0;
+  inode->child_count = 0;
+}
+
 auto RamFs::IsDirectoryEmpty(RamInode* dir) -> bool {
   if (dir == nullptr || dir->inode.type != FileType::kDirectory) {
     return true;
@@ -577,59 +832,103 @@ auto RamFs::IsDirectoryEmpty(RamInode* dir) -> bool {
   return dir->child_count == 0;
 }
 
-auto RamFs::ExpandFile(RamInode* inode, size_t new_size) -> Expected<void> {
-  if (inode == nullptr) {
-    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+auto RamFs::AllocatePage() -> void* {
+  void* page = aligned_alloc(kPageSize, kPageSize);
+  if (page != nullptr) {
+    memset(page, 0, kPageSize);
+    used_pages_.fetch_add(1, std::memory_order_relaxed);
   }
+  return page;
+}
 
-  if (new_size <= inode->capacity) {
-    return {};
-  }
+auto RamFs::FreePage(void* page) -> void {
+  aligned_free(page);
+  used_pages_.fetch_sub(1, std::memory_order_relaxed);
+}
 
-  // 计算新容量（按 256 字节对齐）
-  size_t new_capacity = ((new_size + 255) / 256) * 256;
+auto RamFs::FindPage(RamInode* inode, uint64_t index) -> uint8_t* {
+  uint32_t height = inode->page_height;
+  if (height < kMaxPageHeight && (index >> (height * kSlotShift)) != 0) {
+    return nullptr;
+  }
 
-  uint8_t* new_data = static_cast<uint8_t*>(AllocateFileData(new_capacity));
-  if (new_data == nullptr) {
-    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  void* node = inode->page_root;
+  for (uint32_t level = height; level > 0 && node != nullptr; --level) {
+    size_t slot = (index >> ((level - 1) * kSlotShift)) & (kPageSlots - 1);
+    node = static_cast<PageNode*>(node)->slots[slot];
   }
+  return static_cast<uint8_t*>(node);
+}
 
-  // 复制旧数据
-  if (inode->data != nullptr) {
-    memcpy(new_data, inode->data, inode->inode.size);
-    // Old allocation stays in pool (bump allocator — no per-block free)
+auto RamFs::GetOrCreatePage(RamInode* inode, uint64_t index)
+    -> Expected<uint8_t*> {
+  // 增加树高直到能寻址 index，旧根成为新根的第 0 个子节点，无需复制数据
+  while (inode->page_height < kMaxPageHeight &&
+         (index >> (inode->page_height * kSlotShift)) != 0) {
+    if (inode->page_root != nullptr) {
+      auto* node = static_cast<PageNode*>(AllocatePage());
+      if (node == nullptr) {
+        return std::unexpected(Error(ErrorCode::kOutOfMemory));
+      }
+      node->slots[0] = inode->page_root;
+      inode->page_root = node;
+    }
+    ++inode->page_height;
   }
 
-  inode->data = new_data;
-  inode->capacity = new_capacity;
+  void** slot = &inode->page_root;
+  for (uint32_t level = inode->page_height; level > 0; --level) {
+    if (*slot == nullptr) {
+      *slot = AllocatePage();
+      if (*slot == nullptr) {
+        return std::unexpected(Error(ErrorCode::kOutOfMemory));
+      }
+    }
+    size_t index_in_node =
+        (index >> ((level - 1) * kSlotShift)) & (kPageSlots - 1);
+    slot = &static_cast<PageNode*>(*slot)->slots[index_in_node];
+  }
 
-  return {};
+  if (*slot == nullptr) {
+    *slot = AllocatePage();
+    if (*slot == nullptr) {
+      return std::unexpected(Error(ErrorCode::kOutOfMemory));
+    }
+  }
+  return static_cast<uint8_t*>(*slot);
 }
 
-auto RamFs::AllocateFileData(size_t size) -> void* {
-  // Align up to 16 bytes
-  size_t aligned = (size + 15UL) & ~15UL;
-  if (file_data_pool_used_ + aligned > kFileDataPoolSize) {
-    return nullptr;
+auto RamFs::TrimPages(void*& slot, uint32_t level, uint64_t base,
+                      uint64_t start) -> void {
+  if (slot == nullptr) {
+    return;
   }
-  void* ptr = &file_data_pool_[file_data_pool_used_];
-  file_data_pool_used_ += aligned;
-  return ptr;
-}
 
-auto RamFs::AllocateDirEntries(size_t count) -> RamDirEntry* {
-  size_t bytes = count * sizeof(RamDirEntry);
-  // Align up to alignof(RamDirEntry)
-  static constexpr size_t kAlign = alignof(RamDirEntry);
-  size_t aligned = (bytes + kAlign - 1UL) & ~(kAlign - 1UL);
-  if (dir_data_pool_used_ + aligned > kDirDataPoolSize) {
-    return nullptr;
+  if (level == 0) {
+    if (base >= start) {
+      FreePage(slot);
+      slot = nullptr;
+    }
+    return;
+  }
+
+  auto* node = static_cast<PageNode*>(slot);
+  uint64_t span = uint64_t{1} << ((level - 1) * kSlotShift);
+  bool empty = true;
+  for (size_t i = 0; i < kPageSlots; ++i) {
+    uint64_t child_base = base + i * span;
+    if (child_base + span > start) {
+      TrimPages(node->slots[i], level - 1, child_base, start);
+    }
+    if (node->slots[i] != nullptr) {
+      empty = false;
+    }
+  }
+
+  if (empty) {
+    FreePage(slot);
+    slot = nullptr;
   }
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-  auto* ptr =
-      reinterpret_cast<RamDirEntry*>(&dir_data_pool_[dir_data_pool_used_]);
-  dir_data_pool_used_ += aligned;
-  return ptr;
 }
 
 }  // namespace ramfs
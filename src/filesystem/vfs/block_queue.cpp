@@ -0,0 +1,403 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "block_queue.hpp"
+
+#include <cpu_io.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+#include "kernel_log.hpp"
+
+namespace vfs {
+
+namespace {
+
+/// 同步读写在栈上容纳的请求数，更多时在堆上分配
+constexpr size_t kMaxSyncRequests = 16;
+
+/// 结束派发单元中的每个请求，end_io 返回后请求可能已失效
+auto FinishUnit(BlockRequest* request, ErrorCode status) -> void {
+  while (request != nullptr) {
+    BlockRequest* next = request->merge_next;
+    request->status = status;
+    if (request->end_io != nullptr) {
+      request->end_io(request);
+    }
+    request = next;
+  }
+}
+
+/// 结束 DispatchLocked 返回的失败单元
+auto FinishFailed(BlockRequest* failed) -> void {
+  while (failed != nullptr) {
+    BlockRequest* next = failed->next;
+    FinishUnit(failed, failed->driver_status);
+    failed = next;
+  }
+}
+
+/// 能否把 back 接在 front 之后组成一个派发单元
+auto CanMerge(const BlockRequest* front, const BlockRequest* back) -> bool {
+  return front->op == back->op &&
+         front->sector + front->merged_sectors == back->sector &&
+         front->merged_sectors + back->merged_sectors <=
+             BlockQueue::kMaxMergeSectors;
+}
+
+/// 把单元 back 接在单元 front 之后
+auto MergeUnits(BlockRequest* front, BlockRequest* back) -> void {
+  front->merge_tail->merge_next = back;
+  front->merge_tail = back->merge_tail;
+  front->merged_sectors += back->merged_sectors;
+}
+
+}  // namespace
+
+auto EndRequest(BlockRequest* request, ErrorCode status) -> void {
+  if (request->queue != nullptr) {
+    request->queue->Complete(request, status);
+  } else {
+    FinishUnit(request, status);
+  }
+}
+
+auto WaitForIo(BlockDevice* device, Completion& done, uint64_t timeout_ms)
+    -> ErrorCode {
+  bool polled = false;
+  uint64_t waited = 0;
+  while (!done.IsDone()) {
+    if (!device->HasCompletionIrq() || !Completion::CanWait()) {
+      device->PollRequests();
+      continue;
+    }
+    if (!polled) {
+      polled = true;
+      device->PollBeforeSleep(done);
+      continue;
+    }
+    uint64_t slice = BlockWaiter::kTimeoutMs;
+    if (timeout_ms != 0) {
+      if (waited >= timeout_ms) {
+        klog::Warn("WaitForIo: {} I/O not completed in {} ms, giving up",
+                   device->GetName(), timeout_ms);
+        return ErrorCode::kTimeout;
+      }
+      slice = std::min(slice, timeout_ms - waited);
+    }
+    auto wait_result = done.Wait(slice);
+    if (!wait_result.has_value()) {
+      if (wait_result.error().code == ErrorCode::kTimeout) {
+        waited += slice;
+      }
+      klog::Warn("WaitForIo: {} I/O not completed in {} ms, polling",
+                 device->GetName(), slice);
+      device->PollRequests();
+    }
+  }
+  return ErrorCode::kSuccess;
+}
+
+auto BlockWaiter::Wait(BlockDevice* device, uint64_t timeout_ms) -> ErrorCode {
+  // 放弃提交者持有的计数，之后最后一个完成的请求标记完成
+  if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    done_.Complete();
+  }
+  auto wait_status = WaitForIo(device, done_, timeout_ms);
+  if (wait_status != ErrorCode::kSuccess) {
+    return wait_status;
+  }
+  return status_.load(std::memory_order_relaxed);
+}
+
+auto BlockWaiter::EndIo(BlockRequest* request) -> void {
+  auto* waiter = static_cast<BlockWaiter*>(request->private_data);
+  if (request->status != ErrorCode::kSuccess) {
+    auto expected = ErrorCode::kSuccess;
+    waiter->status_.compare_exchange_strong(expected, request->status,
+                                            std::memory_order_relaxed);
+  }
+  if (waiter->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    waiter->done_.Complete();
+  }
+}
+
+BlockQueue::BlockQueue(BlockDevice* device)
+    : device_(device),
+      depth_(device->GetQueueDepth()),
+      hw_queues_(std::clamp(device->GetHwQueueCount(), 1U, kMaxHwQueues)),
+      hw_depth_(std::max(depth_ / hw_queues_, 1U)) {}
+
+auto BlockQueue::InsertLocked(HwContext& context, BlockRequest* request)
+    -> void {
+  BlockRequest** link = &context.pending;
+  BlockRequest* prev = nullptr;
+  while (*link != nullptr && (*link)->sector <= request->sector) {
+    prev = *link;
+    link = &(*link)->next;
+  }
+  BlockRequest* next = *link;
+
+  if (prev != nullptr && CanMerge(prev, request)) {
+    // 接在前一个单元之后，并尝试与后一个单元连成一个
+    MergeUnits(prev, request);
+    ++context.stats.merged;
+    if (next != nullptr && CanMerge(prev, next)) {
+      prev->next = next->next;
+      MergeUnits(prev, next);
+      ++context.stats.merged;
+    }
+    return;
+  }
+
+  if (next != nullptr && CanMerge(request, next)) {
+    // 放在后一个单元之前，取代它在队列中的位置
+    MergeUnits(request, next);
+    request->next = next->next;
+    *link = request;
+    ++context.stats.merged;
+    return;
+  }
+
+  request->next = next;
+  *link = request;
+}
+
+auto BlockQueue::DispatchLocked(HwContext& context) -> BlockRequest* {
+  BlockRequest* failed = nullptr;
+  bool queued = false;
+  while (context.pending != nullptr && context.inflight < hw_depth_) {
+    BlockRequest* unit = context.pending;
+    auto result = device_->QueueRequest(unit);
+    if (!result.has_value() &&
+        result.error().code == ErrorCode::kNoFreeDescriptors &&
+        context.inflight > 0) {
+      // 设备资源暂时不足，等在途请求完成后再派发
+      break;
+    }
+    context.pending = unit->next;
+    unit->next = nullptr;
+    if (!result.has_value()) {
+      unit->driver_status = result.error().code;
+      unit->next = failed;
+      failed = unit;
+      continue;
+    }
+    ++context.inflight;
+    ++context.stats.dispatched;
+    queued = true;
+  }
+  if (queued) {
+    device_->CommitRequests();
+    ++context.stats.kicks;
+  }
+  return failed;
+}
+
+auto BlockQueue::Dispatch(HwContext& context) -> void {
+  BlockRequest* failed = nullptr;
+  {
+    LockGuard<SpinLock> guard(context.lock);
+    failed = DispatchLocked(context);
+  }
+  FinishFailed(failed);
+}
+
+auto BlockQueue::Submit(BlockRequest* request) -> Expected<void> {
+  if (depth_ == 0) {
+    return device_->Submit(request);
+  }
+  if (request == nullptr || request->buffer == nullptr ||
+      request->sector_count == 0) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  request->status = ErrorCode::kSuccess;
+  request->queue = this;
+  request->next = nullptr;
+  request->merge_next = nullptr;
+  request->merge_tail = request;
+  request->merged_sectors = request->sector_count;
+
+  // 请求进入当前核心对应的硬件队列，不与其它核心争用锁
+  const auto index =
+      static_cast<uint32_t>(cpu_io::GetCurrentCoreId() % hw_queues_);
+  request->hw_queue = index;
+  HwContext& context = contexts_[index];
+
+  BlockRequest* failed = nullptr;
+  {
+    LockGuard<SpinLock> guard(context.lock);
+    ++context.stats.submitted;
+    InsertLocked(context, request);
+    if (plug_depth_.load(std::memory_order_acquire) == 0) {
+      failed = DispatchLocked(context);
+    }
+  }
+  FinishFailed(failed);
+  return {};
+}
+
+auto BlockQueue::Complete(BlockRequest* request, ErrorCode status) -> void {
+  // 单元结束后可能失效，先记下它所在的硬件队列
+  HwContext& context = contexts_[request->hw_queue];
+  FinishUnit(request, status);
+
+  BlockRequest* failed = nullptr;
+  {
+    LockGuard<SpinLock> guard(context.lock);
+    --context.inflight;
+    if (plug_depth_.load(std::memory_order_acquire) == 0) {
+      failed = DispatchLocked(context);
+    }
+  }
+  FinishFailed(failed);
+}
+
+auto BlockQueue::Plug() -> void {
+  plug_depth_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+auto BlockQueue::Unplug() -> void {
+  uint32_t depth = plug_depth_.load(std::memory_order_relaxed);
+  do {
+    if (depth == 0) {
+      return;
+    }
+  } while (!plug_depth_.compare_exchange_weak(depth, depth - 1,
+                                              std::memory_order_acq_rel));
+  if (depth != 1) {
+    return;
+  }
+  // Plug 期间各核心暂存的请求都要派发
+  for (uint32_t i = 0; i < hw_queues_; ++i) {
+    Dispatch(contexts_[i]);
+  }
+}
+
+auto BlockQueue::PollRequests() -> void { device_->PollRequests(); }
+
+auto BlockQueue::HasCompletionIrq() const -> bool {
+  return device_->HasCompletionIrq();
+}
+
+auto BlockQueue::PollBeforeSleep(const Completion& done) -> void {
+  device_->PollBeforeSleep(done);
+}
+
+auto BlockQueue::GetQueueDepth() const -> uint32_t { return depth_; }
+
+auto BlockQueue::Transfer(BlockOp op, uint64_t sector_start,
+                          uint32_t sector_count, void* buffer)
+    -> Expected<size_t> {
+  if (buffer == nullptr) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+  auto* data = static_cast<uint8_t*>(buffer);
+  const uint32_t sector_size = device_->GetSectorSize();
+
+  // 全部请求一次提交，由队列按设备深度派发；请求较多时在堆上分配，
+  // 分配失败时分批提交
+  const uint32_t units =
+      (sector_count + kMaxMergeSectors - 1) / kMaxMergeSectors;
+  std::array<BlockRequest, kMaxSyncRequests> local_requests{};
+  BlockRequest* requests = local_requests.data();
+  size_t capacity = local_requests.size();
+  BlockRequest* heap_requests = nullptr;
+  if (units > capacity) {
+    heap_requests = new BlockRequest[units];
+    if (heap_requests != nullptr) {
+      requests = heap_requests;
+      capacity = units;
+    }
+  }
+
+  ErrorCode status = ErrorCode::kSuccess;
+  uint32_t done = 0;
+  while (done < sector_count && status == ErrorCode::kSuccess) {
+    BlockWaiter waiter;
+    ErrorCode submit_status = ErrorCode::kSuccess;
+    {
+      BlockPlug plug(this);
+      for (size_t count = 0; done < sector_count && count < capacity;
+           ++count) {
+        uint32_t sectors = std::min(sector_count - done, kMaxMergeSectors);
+        BlockRequest& request = requests[count];
+        request = BlockRequest{
+            .op = op,
+            .sector = sector_start + done,
+            .sector_count = sectors,
+            .buffer = data + static_cast<size_t>(done) * sector_size,
+            .end_io = BlockWaiter::EndIo,
+            .private_data = &waiter,
+        };
+        waiter.Add();
+        auto result = Submit(&request);
+        if (!result.has_value()) {
+          // 未提交的请求不会完成，由 EndIo 代为结束
+          request.status = result.error().code;
+          BlockWaiter::EndIo(&request);
+          submit_status = result.error().code;
+          break;
+        }
+        done += sectors;
+      }
+    }
+
+    status = waiter.Wait(this);
+    if (status == ErrorCode::kSuccess) {
+      status = submit_status;
+    }
+  }
+  delete[] heap_requests;
+  if (status != ErrorCode::kSuccess) {
+    return std::unexpected(Error(status));
+  }
+  return static_cast<size_t>(sector_count) * sector_size;
+}
+
+auto BlockQueue::ReadSectors(uint64_t sector_start, uint32_t sector_count,
+                             void* buffer) -> Expected<size_t> {
+  if (depth_ == 0) {
+    return device_->ReadSectors(sector_start, sector_count, buffer);
+  }
+  return Transfer(BlockOp::kRead, sector_start, sector_count, buffer);
+}
+
+auto BlockQueue::WriteSectors(uint64_t sector_start, uint32_t sector_count,
+                              const void* buffer) -> Expected<size_t> {
+  if (depth_ == 0) {
+    return device_->WriteSectors(sector_start, sector_count, buffer);
+  }
+  return Transfer(BlockOp::kWrite, sector_start, sector_count,
+                  const_cast<void*>(buffer));
+}
+
+auto BlockQueue::GetSectorSize() const -> uint32_t {
+  return device_->GetSectorSize();
+}
+
+auto BlockQueue::GetSectorCount() const -> uint64_t {
+  return device_->GetSectorCount();
+}
+
+auto BlockQueue::GetName() const -> const char* { return device_->GetName(); }
+
+auto BlockQueue::Flush() -> Expected<void> { return device_->Flush(); }
+
+auto BlockQueue::GetStats() -> BlockQueueStats {
+  BlockQueueStats total;
+  for (uint32_t i = 0; i < hw_queues_; ++i) {
+    LockGuard<SpinLock> guard(contexts_[i].lock);
+    total.submitted += contexts_[i].stats.submitted;
+    total.merged += contexts_[i].stats.merged;
+    total.dispatched += contexts_[i].stats.dispatched;
+    total.kicks += contexts_[i].stats.kicks;
+  }
+  return total;
+}
+
+}  // namespace vfs
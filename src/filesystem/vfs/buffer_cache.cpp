@@ -0,0 +1,467 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "buffer_cache.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "kernel_log.hpp"
+#include "kstd_cstring"
+#include "kstd_memory"
+
+namespace vfs {
+
+namespace {
+
+/// 扇区号的混合因子（黄金分割）
+constexpr uint64_t kSectorMix = 0x9E3779B97F4A7C15ULL;
+
+}  // namespace
+
+BufferCache::BufferCache(BlockDevice* device)
+    : device_(device), sector_size_(device->GetSectorSize()) {}
+
+BufferCache::~BufferCache() {
+  for (Buffer* bucket : buckets_) {
+    while (bucket != nullptr) {
+      Buffer* next = bucket->hash_next;
+      delete[] bucket->data;
+      delete bucket;
+      bucket = next;
+    }
+  }
+  delete[] bounce_;
+  delete[] requests_;
+}
+
+auto BufferCache::GetBucket(uint64_t sector) -> Buffer*& {
+  constexpr int kShift = 64 - std::countr_zero(kBucketCount);
+  return buckets_[(sector * kSectorMix) >> kShift];
+}
+
+auto BufferCache::ListRemove(BufferList& list, Buffer* buffer) -> void {
+  if (buffer->prev != nullptr) {
+    buffer->prev->next = buffer->next;
+  } else {
+    list.head = buffer->next;
+  }
+  if (buffer->next != nullptr) {
+    buffer->next->prev = buffer->prev;
+  } else {
+    list.tail = buffer->prev;
+  }
+  buffer->prev = nullptr;
+  buffer->next = nullptr;
+}
+
+auto BufferCache::ListAppend(BufferList& list, Buffer* buffer) -> void {
+  buffer->prev = list.tail;
+  buffer->next = nullptr;
+  if (list.tail != nullptr) {
+    list.tail->next = buffer;
+  } else {
+    list.head = buffer;
+  }
+  list.tail = buffer;
+}
+
+auto BufferCache::Find(uint64_t sector) -> Buffer* {
+  for (Buffer* buffer = GetBucket(sector); buffer != nullptr;
+       buffer = buffer->hash_next) {
+    if (buffer->sector == sector) {
+      return buffer;
+    }
+  }
+  return nullptr;
+}
+
+auto BufferCache::AllocateLocked(uint64_t sector) -> Buffer* {
+  Buffer* buffer = nullptr;
+  if (count_ < kMaxBuffers) {
+    auto new_buffer = kstd::make_unique<Buffer>();
+    auto* data = new_buffer ? new uint8_t[sector_size_] : nullptr;
+    if (data != nullptr) {
+      new_buffer->data = data;
+      buffer = new_buffer.release();
+      ++count_;
+    }
+  }
+
+  if (buffer == nullptr) {
+    // 达到上限或内存不足时回收最久未使用的干净扇区
+    buffer = clean_.head;
+    if (buffer == nullptr) {
+      return nullptr;
+    }
+    ListRemove(clean_, buffer);
+    Buffer** link = &GetBucket(buffer->sector);
+    while (*link != buffer) {
+      link = &(*link)->hash_next;
+    }
+    *link = buffer->hash_next;
+  }
+
+  buffer->sector = sector;
+  buffer->dirty = false;
+  buffer->writeback = false;
+  Buffer*& bucket = GetBucket(sector);
+  buffer->hash_next = bucket;
+  bucket = buffer;
+  return buffer;
+}
+
+auto BufferCache::MarkDirtyLocked(Buffer* buffer) -> void {
+  if (buffer->dirty) {
+    return;
+  }
+  buffer->dirty = true;
+  buffer->dirty_period = period_;
+  ListAppend(dirty_, buffer);
+  ++dirty_count_;
+}
+
+auto BufferCache::ReadSectors(uint64_t sector_start, uint32_t sector_count,
+                              void* buffer) -> Expected<size_t> {
+  if (buffer == nullptr) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+  auto* out = static_cast<uint8_t*>(buffer);
+  size_t bytes = static_cast<size_t>(sector_count) * sector_size_;
+
+  ReadLockGuard io_guard(io_lock_);
+  {
+    // 全部命中时不访问设备
+    LockGuard<SpinLock> guard(lock_);
+    uint32_t cached = 0;
+    while (cached < sector_count && Find(sector_start + cached) != nullptr) {
+      ++cached;
+    }
+    if (cached == sector_count) {
+      for (uint32_t i = 0; i < sector_count; ++i) {
+        Buffer* cached_buffer = Find(sector_start + i);
+        memcpy(out + i * sector_size_, cached_buffer->data, sector_size_);
+        if (!cached_buffer->dirty && !cached_buffer->writeback) {
+          ListRemove(clean_, cached_buffer);
+          ListAppend(clean_, cached_buffer);
+        }
+      }
+      hits_ += sector_count;
+      return bytes;
+    }
+  }
+
+  auto result = device_->ReadSectors(sector_start, sector_count, buffer);
+  if (!result.has_value()) {
+    return result;
+  }
+
+  // 缓存中的扇区比设备上的新，覆盖读到的数据；小块读取的结果放入缓存
+  LockGuard<SpinLock> guard(lock_);
+  for (uint32_t i = 0; i < sector_count; ++i) {
+    uint8_t* data = out + i * sector_size_;
+    Buffer* cached_buffer = Find(sector_start + i);
+    if (cached_buffer != nullptr) {
+      memcpy(data, cached_buffer->data, sector_size_);
+      ++hits_;
+      continue;
+    }
+    ++misses_;
+    if (sector_count > kMaxCachedReadSectors) {
+      continue;
+    }
+    cached_buffer = AllocateLocked(sector_start + i);
+    if (cached_buffer != nullptr) {
+      memcpy(cached_buffer->data, data, sector_size_);
+      ListAppend(clean_, cached_buffer);
+    }
+  }
+  return bytes;
+}
+
+auto BufferCache::WriteSectors(uint64_t sector_start, uint32_t sector_count,
+                               const void* buffer) -> Expected<size_t> {
+  if (buffer == nullptr) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+  const auto* in = static_cast<const uint8_t*>(buffer);
+
+  bool over_limit = false;
+  // 从第 from 个扇区起写入缓存，返回写入的扇区数
+  auto write_cached = [&](uint32_t from) -> uint32_t {
+    LockGuard<SpinLock> guard(lock_);
+    uint32_t i = from;
+    for (; i < sector_count; ++i) {
+      Buffer* cached_buffer = Find(sector_start + i);
+      if (cached_buffer == nullptr) {
+        cached_buffer = AllocateLocked(sector_start + i);
+        if (cached_buffer == nullptr) {
+          break;
+        }
+      } else if (!cached_buffer->dirty && !cached_buffer->writeback) {
+        ListRemove(clean_, cached_buffer);
+      }
+      memcpy(cached_buffer->data, in + i * sector_size_, sector_size_);
+      MarkDirtyLocked(cached_buffer);
+    }
+    over_limit = dirty_count_ > kDirtyLimit;
+    return i;
+  };
+
+  uint32_t done = write_cached(0);
+  if (done < sector_count) {
+    // 没有可回收的干净扇区：写回后重试
+    auto writeback_result = WriteBack(false);
+    if (!writeback_result.has_value()) {
+      return std::unexpected(writeback_result.error());
+    }
+    done = write_cached(done);
+  }
+
+  if (done < sector_count) {
+    // 内存不足以缓存时直接写入设备，同时更新已缓存的副本
+    WriteLockGuard io_guard(io_lock_);
+    {
+      LockGuard<SpinLock> guard(lock_);
+      for (uint32_t i = done; i < sector_count; ++i) {
+        Buffer* cached_buffer = Find(sector_start + i);
+        if (cached_buffer != nullptr) {
+          memcpy(cached_buffer->data, in + i * sector_size_, sector_size_);
+        }
+      }
+    }
+    auto result = device_->WriteSectors(sector_start + done,
+                                        sector_count - done,
+                                        in + done * sector_size_);
+    if (!result.has_value()) {
+      return std::unexpected(result.error());
+    }
+  } else if (over_limit) {
+    // 脏扇区过多，由写入者分担写回
+    auto writeback_result = WriteBack(false);
+    if (!writeback_result.has_value()) {
+      return std::unexpected(writeback_result.error());
+    }
+  }
+  return static_cast<size_t>(sector_count) * sector_size_;
+}
+
+auto BufferCache::WriteBatch(bool expired_only) -> Expected<size_t> {
+  // 从脏链表头部（最早变脏）开始收集，写回期间扇区不会被回收
+  size_t count = 0;
+  {
+    LockGuard<SpinLock> guard(lock_);
+    while (dirty_.head != nullptr && count < batch_.size()) {
+      Buffer* buffer = dirty_.head;
+      if (expired_only && period_ - buffer->dirty_period < kExpirePeriods) {
+        break;
+      }
+      ListRemove(dirty_, buffer);
+      buffer->dirty = false;
+      buffer->writeback = true;
+      --dirty_count_;
+      batch_[count++] = buffer;
+    }
+  }
+  if (count == 0) {
+    return 0;
+  }
+
+  // 按扇区号排序，相邻扇区合并为一个写请求
+  std::sort(batch_.begin(), batch_.begin() + count,
+            [](const Buffer* lhs, const Buffer* rhs) {
+              return lhs->sector < rhs->sector;
+            });
+  BlockWaiter waiter;
+  size_t request_count = 0;
+  {
+    // 复制当前内容，之后的写入使扇区重新变脏，由下一次写回处理
+    LockGuard<SpinLock> guard(lock_);
+    size_t start = 0;
+    while (start < count) {
+      size_t end = start + 1;
+      while (end < count && end - start < kMaxWriteSectors &&
+             batch_[end]->sector == batch_[end - 1]->sector + 1) {
+        ++end;
+      }
+      for (size_t i = start; i < end; ++i) {
+        memcpy(bounce_ + i * sector_size_, batch_[i]->data, sector_size_);
+      }
+      requests_[request_count++] = BlockRequest{
+          .op = BlockOp::kWrite,
+          .sector = batch_[start]->sector,
+          .sector_count = static_cast<uint32_t>(end - start),
+          .buffer = bounce_ + start * sector_size_,
+          .end_io = BlockWaiter::EndIo,
+          .private_data = &waiter,
+      };
+      start = end;
+    }
+  }
+
+  // 一批写请求同时提交，下层设备可以并行处理并合并
+  {
+    BlockPlug plug(device_);
+    for (size_t i = 0; i < request_count; ++i) {
+      waiter.Add();
+      auto submit_result = device_->Submit(&requests_[i]);
+      if (!submit_result.has_value()) {
+        requests_[i].status = submit_result.error().code;
+        BlockWaiter::EndIo(&requests_[i]);
+      }
+    }
+  }
+  // 各请求的状态分别检查，不需要汇总的错误
+  (void)waiter.Wait(device_);
+
+  const BlockRequest* failed = nullptr;
+  {
+    LockGuard<SpinLock> guard(lock_);
+    for (size_t i = 0; i < request_count; ++i) {
+      const BlockRequest& request = requests_[i];
+      if (request.status == ErrorCode::kSuccess) {
+        ++write_requests_;
+        written_sectors_ += request.sector_count;
+        continue;
+      }
+      // 写入失败的扇区重新记为脏
+      size_t first =
+          (static_cast<uint8_t*>(request.buffer) - bounce_) / sector_size_;
+      for (size_t j = 0; j < request.sector_count; ++j) {
+        MarkDirtyLocked(batch_[first + j]);
+      }
+      if (failed == nullptr) {
+        failed = &request;
+      }
+    }
+
+    // 写回期间没有再次变脏的扇区回到 LRU 链表
+    for (size_t i = 0; i < count; ++i) {
+      Buffer* buffer = batch_[i];
+      buffer->writeback = false;
+      if (!buffer->dirty) {
+        ListAppend(clean_, buffer);
+      }
+    }
+  }
+
+  if (failed != nullptr) {
+    klog::Err("BufferCache: write back {} sectors at {} failed: {}",
+              failed->sector_count, failed->sector,
+              Error(failed->status).message());
+    return std::unexpected(Error(failed->status));
+  }
+  return count;
+}
+
+auto BufferCache::WriteBack(bool expired_only) -> Expected<size_t> {
+  WriteLockGuard io_guard(io_lock_);
+  if (bounce_ == nullptr) {
+    bounce_ = new uint8_t[kWriteBackBatch * sector_size_];
+    if (bounce_ == nullptr) {
+      return std::unexpected(Error(ErrorCode::kOutOfMemory));
+    }
+  }
+  if (requests_ == nullptr) {
+    requests_ = new BlockRequest[kWriteBackBatch];
+    if (requests_ == nullptr) {
+      return std::unexpected(Error(ErrorCode::kOutOfMemory));
+    }
+  }
+
+  // 只写回开始时已有的脏扇区数量，持续的写入不会使写回无法结束
+  size_t limit = 0;
+  {
+    LockGuard<SpinLock> guard(lock_);
+    limit = dirty_count_;
+  }
+  size_t total = 0;
+  while (total < limit) {
+    auto batch_result = WriteBatch(expired_only);
+    if (!batch_result.has_value()) {
+      return std::unexpected(batch_result.error());
+    }
+    if (batch_result.value() == 0) {
+      break;
+    }
+    total += batch_result.value();
+  }
+  return total;
+}
+
+auto BufferCache::GetSectorSize() const -> uint32_t { return sector_size_; }
+
+auto BufferCache::GetSectorCount() const -> uint64_t {
+  return device_->GetSectorCount();
+}
+
+auto BufferCache::GetName() const -> const char* { return device_->GetName(); }
+
+auto BufferCache::Flush() -> Expected<void> {
+  auto writeback_result = WriteBack(false);
+  if (!writeback_result.has_value()) {
+    return std::unexpected(writeback_result.error());
+  }
+  return device_->Flush();
+}
+
+auto BufferCache::Submit(BlockRequest* request) -> Expected<void> {
+  if (request == nullptr || request->buffer == nullptr) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+  if (request->op == BlockOp::kWrite) {
+    return BlockDevice::Submit(request);
+  }
+  // 设备上的数据与缓存一致时不必经过缓存；之后变脏的扇区属于随后的写入，
+  // 由写入者丢弃读到的旧数据
+  {
+    LockGuard<SpinLock> guard(lock_);
+    for (uint32_t i = 0; i < request->sector_count; ++i) {
+      Buffer* cached_buffer = Find(request->sector + i);
+      if (cached_buffer != nullptr &&
+          (cached_buffer->dirty || cached_buffer->writeback)) {
+        return std::unexpected(Error(ErrorCode::kNotSupported));
+      }
+    }
+  }
+  return device_->Submit(request);
+}
+
+auto BufferCache::Plug() -> void { device_->Plug(); }
+
+auto BufferCache::Unplug() -> void { device_->Unplug(); }
+
+auto BufferCache::PollRequests() -> void { device_->PollRequests(); }
+
+auto BufferCache::HasCompletionIrq() const -> bool {
+  return device_->HasCompletionIrq();
+}
+
+auto BufferCache::PollBeforeSleep(const Completion& done) -> void {
+  device_->PollBeforeSleep(done);
+}
+
+auto BufferCache::Tick() -> Expected<size_t> {
+  bool write_all = false;
+  {
+    LockGuard<SpinLock> guard(lock_);
+    ++period_;
+    write_all = dirty_count_ > kDirtyBackground;
+  }
+  return WriteBack(!write_all);
+}
+
+auto BufferCache::GetStats() -> BufferCacheStats {
+  LockGuard<SpinLock> guard(lock_);
+  return BufferCacheStats{
+      .buffers = count_,
+      .dirty = dirty_count_,
+      .hits = hits_,
+      .misses = misses_,
+      .write_requests = write_requests_,
+      .written_sectors = written_sectors_,
+  };
+}
+
+}  // namespace vfs
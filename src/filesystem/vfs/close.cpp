@@ -6,8 +6,6 @@
 
 #include "filesystem.hpp"
 #include "kernel_log.hpp"
-#include "kstd_cstring"
-#include "spinlock.hpp"
 #include "vfs_internal.hpp"
 
 namespace vfs {
@@ -17,7 +15,11 @@ auto Close(File* file) -> Expected<void> {
     return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
 
-  LockGuard<SpinLock> guard(GetVfsState().vfs_lock_);
+  // 仍有其它文件描述符引用时只减少计数
+  if (file->ref_count.fetch_sub(1, std::memory_order_acq_rel) > 1) {
+    return {};
+  }
+
   if (file->ops != nullptr) {
     auto result = file->ops->Close(file);
     if (!result.has_value()) {
@@ -25,6 +27,7 @@ auto Close(File* file) -> Expected<void> {
     }
   }
 
+  PutDentry(file->dentry);
   etl::unique_ptr<File> file_guard(file);
   return {};
 }
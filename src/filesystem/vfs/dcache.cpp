@@ -0,0 +1,445 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include <cstdint>
+
+#include "filesystem.hpp"
+#include "kernel_log.hpp"
+#include "kstd_cstring"
+#include "kstd_memory"
+#include "spinlock.hpp"
+#include "vfs_internal.hpp"
+
+namespace vfs {
+
+namespace {
+
+/// FNV-1a 参数
+constexpr uint32_t kFnvOffsetBasis = 2166136261U;
+constexpr uint32_t kFnvPrime = 16777619U;
+
+/// 父 dentry 地址的混合因子（黄金分割）
+constexpr uint32_t kParentMix = 0x9E3779B1U;
+
+auto GetBucket(const Dentry* parent, uint32_t hash) -> Dentry*& {
+  auto key = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(parent) >> 4);
+  auto index = (hash ^ (key * kParentMix)) & (DentryCache::kBucketCount - 1);
+  return GetVfsState().dcache.buckets[index];
+}
+
+auto LruRemove(Dentry* dentry) -> void {
+  auto& cache = GetVfsState().dcache;
+  if (dentry->lru_prev != nullptr) {
+    dentry->lru_prev->lru_next = dentry->lru_next;
+  } else {
+    cache.lru_head = dentry->lru_next;
+  }
+  if (dentry->lru_next != nullptr) {
+    dentry->lru_next->lru_prev = dentry->lru_prev;
+  } else {
+    cache.lru_tail = dentry->lru_prev;
+  }
+  dentry->lru_prev = nullptr;
+  dentry->lru_next = nullptr;
+  dentry->on_lru = false;
+}
+
+auto LruAppend(Dentry* dentry) -> void {
+  auto& cache = GetVfsState().dcache;
+  dentry->lru_prev = cache.lru_tail;
+  dentry->lru_next = nullptr;
+  if (cache.lru_tail != nullptr) {
+    cache.lru_tail->lru_next = dentry;
+  } else {
+    cache.lru_head = dentry;
+  }
+  cache.lru_tail = dentry;
+  dentry->on_lru = true;
+}
+
+/// 引用计数中表示 dentry 正在被释放的标志
+constexpr uint32_t kDentryDead = 1U << 31;
+
+/**
+ * @brief 将 dentry 移出哈希表与父目录的子节点链表
+ * @note 保留 parent 指针，dentry 释放前仍持有父 dentry 的引用
+ */
+auto Unhash(Dentry* dentry) -> void {
+  auto& cache = GetVfsState().dcache;
+  cache.seq.WriteBegin();
+  Dentry** link = &GetBucket(dentry->parent, dentry->name_hash);
+  while (*link != nullptr && *link != dentry) {
+    link = &(*link)->hash_next;
+  }
+  if (*link == dentry) {
+    *link = dentry->hash_next;
+  }
+
+  if (dentry->prev_sibling != nullptr) {
+    dentry->prev_sibling->next_sibling = dentry->next_sibling;
+  } else {
+    dentry->parent->children = dentry->next_sibling;
+  }
+  if (dentry->next_sibling != nullptr) {
+    dentry->next_sibling->prev_sibling = dentry->prev_sibling;
+  }
+  dentry->hashed = false;
+  cache.seq.WriteEnd();
+
+  // 无锁遍历的读者可能仍在沿 hash_next 前进，保留该指针直到释放
+  dentry->prev_sibling = nullptr;
+  dentry->next_sibling = nullptr;
+  --cache.count;
+}
+
+/**
+ * @brief 释放 dentry 占用的内存
+ * @note 有无锁遍历的读者时放入延迟链表，由之后的释放操作回收
+ */
+auto ReleaseMemory(Dentry* dentry) -> void {
+  auto& cache = GetVfsState().dcache;
+  if (cache.walkers.load(std::memory_order_seq_cst) != 0) {
+    dentry->lru_next = cache.deferred;
+    cache.deferred = dentry;
+    return;
+  }
+
+  delete dentry;
+  while (cache.deferred != nullptr) {
+    Dentry* next = cache.deferred->lru_next;
+    delete cache.deferred;
+    cache.deferred = next;
+  }
+}
+
+/**
+ * @brief 通知文件系统 inode 不再被 dentry 引用
+ * @note 文件系统可能随后复用该 inode，先丢弃其缓存页
+ */
+auto ReleaseInode(Inode* inode) -> void {
+  if (inode == nullptr || inode->fs == nullptr) {
+    return;
+  }
+  InvalidatePageCache(inode);
+  inode->fs->ReleaseInode(inode);
+}
+
+/**
+ * @brief 尝试将无引用的 dentry 标记为正在释放
+ * @return bool 引用计数为 0 且标记成功时返回 true
+ */
+auto TryKill(Dentry* dentry) -> bool {
+  uint32_t expected = 0;
+  return dentry->ref_count.compare_exchange_strong(expected, kDentryDead,
+                                                   std::memory_order_acq_rel);
+}
+
+/**
+ * @brief 释放已移出哈希表且已标记为正在释放的 dentry
+ * @note 父 dentry 因此变为未使用时放入 LRU 链表，
+ *       若父 dentry 也已移出哈希表则一并释放
+ */
+auto FreeDentry(Dentry* dentry) -> void {
+  while (dentry != nullptr) {
+    Dentry* parent = dentry->parent;
+    ReleaseInode(dentry->inode);
+    ReleaseMemory(dentry);
+
+    dentry = nullptr;
+    if (parent == nullptr ||
+        parent->ref_count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      break;
+    }
+    if (parent->hashed) {
+      if (!parent->on_lru) {
+        LruAppend(parent);
+      }
+    } else if (parent->parent != nullptr && TryKill(parent)) {
+      // 挂载根没有父 dentry，由 MountTable 负责释放
+      dentry = parent;
+    }
+  }
+}
+
+auto ShrinkLocked(size_t count) -> size_t {
+  auto& cache = GetVfsState().dcache;
+  size_t freed = 0;
+  // 回收叶子后其父 dentry 可能进入 LRU 尾部，随后也会被回收
+  while (freed < count && cache.lru_head != nullptr) {
+    Dentry* victim = cache.lru_head;
+    LruRemove(victim);
+    // 进入 LRU 后又被引用的 dentry 只移出链表，不回收
+    if (!TryKill(victim)) {
+      continue;
+    }
+    Unhash(victim);
+    FreeDentry(victim);
+    ++freed;
+  }
+  return freed;
+}
+
+}  // namespace
+
+Dentry::~Dentry() {
+  if (name != inline_name) {
+    delete[] name;
+  }
+}
+
+auto HashName(const char* name, size_t len) -> uint32_t {
+  uint32_t hash = kFnvOffsetBasis;
+  for (size_t i = 0; i < len; ++i) {
+    hash ^= static_cast<uint8_t>(name[i]);
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+auto SetDentryName(Dentry* dentry, const char* name, size_t len)
+    -> Expected<void> {
+  char* storage = dentry->inline_name;
+  if (len >= Dentry::kInlineNameSize) {
+    storage = new char[len + 1];
+    if (storage == nullptr) {
+      return std::unexpected(Error(ErrorCode::kOutOfMemory));
+    }
+  }
+
+  if (dentry->name != dentry->inline_name) {
+    delete[] dentry->name;
+  }
+  memcpy(storage, name, len);
+  storage[len] = '\0';
+  dentry->name = storage;
+  dentry->name_len = static_cast<uint32_t>(len);
+  return {};
+}
+
+auto LookupChild(Dentry* parent, const char* name, size_t len, uint32_t hash)
+    -> Dentry* {
+  if (parent == nullptr || name == nullptr) {
+    return nullptr;
+  }
+
+  for (Dentry* dentry = GetBucket(parent, hash); dentry != nullptr;
+       dentry = dentry->hash_next) {
+    if (dentry->parent == parent && dentry->name_hash == hash &&
+        dentry->name_len == len && memcmp(dentry->name, name, len) == 0) {
+      return dentry;
+    }
+  }
+  return nullptr;
+}
+
+auto FindChild(Dentry* parent, const char* name) -> Dentry* {
+  if (parent == nullptr || name == nullptr) {
+    return nullptr;
+  }
+
+  size_t len = strlen(name);
+  Dentry* child = LookupChild(parent, name, len, HashName(name, len));
+  if (child == nullptr || child->inode == nullptr) {
+    return nullptr;
+  }
+  return child;
+}
+
+auto AddChild(Dentry* parent, const char* name, size_t len, uint32_t hash,
+              Inode* inode) -> Expected<Dentry*> {
+  if (parent == nullptr || name == nullptr || len == 0) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  auto& cache = GetVfsState().dcache;
+
+  // 同名负 dentry 直接实例化
+  Dentry* existing = LookupChild(parent, name, len, hash);
+  if (existing != nullptr) {
+    if (existing->inode != nullptr && inode != nullptr &&
+        existing->inode != inode) {
+      // 并发查找同一名称时后完成的一方丢弃自己得到的 inode
+      ReleaseInode(inode);
+    } else if (existing->inode != inode) {
+      cache.seq.WriteBegin();
+      existing->inode = inode;
+      cache.seq.WriteEnd();
+    }
+    return existing;
+  }
+
+  if (cache.count >= DentryCache::kMaxDentries) {
+    ShrinkLocked(DentryCache::kShrinkBatch);
+  }
+
+  auto child = kstd::make_unique<Dentry>();
+  if (!child) {
+    // 回收未使用的 dentry 后重试一次
+    if (ShrinkLocked(DentryCache::kShrinkBatch) != 0) {
+      child = kstd::make_unique<Dentry>();
+    }
+    if (!child) {
+      ReleaseInode(inode);
+      return std::unexpected(Error(ErrorCode::kOutOfMemory));
+    }
+  }
+
+  auto name_result = SetDentryName(child.get(), name, len);
+  if (!name_result.has_value()) {
+    ReleaseInode(inode);
+    return std::unexpected(name_result.error());
+  }
+
+  Dentry* dentry = child.release();
+  dentry->name_hash = hash;
+  dentry->inode = inode;
+  dentry->parent = parent;
+  GetDentry(parent);
+
+  // 新 dentry 完整初始化后才对无锁遍历的读者可见
+  cache.seq.WriteBegin();
+  dentry->next_sibling = parent->children;
+  if (parent->children != nullptr) {
+    parent->children->prev_sibling = dentry;
+  }
+  parent->children = dentry;
+
+  Dentry*& bucket = GetBucket(parent, hash);
+  dentry->hash_next = bucket;
+  bucket = dentry;
+  dentry->hashed = true;
+  cache.seq.WriteEnd();
+  ++cache.count;
+
+  // 新 dentry 尚无引用，进入 LRU
+  LruAppend(dentry);
+  return dentry;
+}
+
+auto RemoveChild(Dentry* parent, Dentry* child) -> void {
+  if (parent == nullptr || child == nullptr || child->parent != parent ||
+      !child->hashed) {
+    return;
+  }
+
+  Unhash(child);
+  if (child->on_lru) {
+    LruRemove(child);
+  }
+  if (TryKill(child)) {
+    FreeDentry(child);
+  }
+}
+
+auto GetDentry(Dentry* dentry) -> void {
+  if (dentry != nullptr) {
+    dentry->ref_count.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+auto TryGetDentry(Dentry* dentry) -> bool {
+  auto count = dentry->ref_count.load(std::memory_order_relaxed);
+  do {
+    if ((count & kDentryDead) != 0) {
+      return false;
+    }
+  } while (!dentry->ref_count.compare_exchange_weak(
+      count, count + 1, std::memory_order_acquire, std::memory_order_relaxed));
+  return true;
+}
+
+auto PutDentryLocked(Dentry* dentry) -> void {
+  if (dentry == nullptr ||
+      dentry->ref_count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  if (dentry->hashed) {
+    if (!dentry->on_lru) {
+      LruAppend(dentry);
+    }
+  } else if (dentry->parent != nullptr && TryKill(dentry)) {
+    FreeDentry(dentry);
+  }
+}
+
+auto PutDentry(Dentry* dentry) -> void {
+  if (dentry == nullptr) {
+    return;
+  }
+
+  // 不会降为 0 时无需加锁
+  auto count = dentry->ref_count.load(std::memory_order_relaxed);
+  while (count > 1) {
+    if (dentry->ref_count.compare_exchange_weak(count, count - 1,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+      return;
+    }
+  }
+
+  LockGuard<SpinLock> guard(GetVfsState().dcache.lock);
+  PutDentryLocked(dentry);
+}
+
+auto PruneDentryTree(Dentry* root) -> void {
+  if (root == nullptr) {
+    return;
+  }
+
+  // 反复找到最深的叶子并移除，直到 root 没有子节点
+  while (root->children != nullptr) {
+    Dentry* leaf = root->children;
+    while (leaf->children != nullptr) {
+      leaf = leaf->children;
+    }
+    if (leaf->ref_count.load(std::memory_order_relaxed) != 0) {
+      klog::Warn("VFS: pruning dentry '{}' still in use", leaf->name);
+    }
+    RemoveChild(leaf->parent, leaf);
+  }
+}
+
+auto IsDentryTreeBusy(Dentry* root) -> bool {
+  // 未使用的 dentry 只被其子 dentry 引用
+  Dentry* dentry = root;
+  while (dentry != nullptr) {
+    uint32_t children = 0;
+    for (Dentry* child = dentry->children; child != nullptr;
+         child = child->next_sibling) {
+      ++children;
+    }
+    if (dentry->ref_count.load(std::memory_order_relaxed) != children) {
+      return true;
+    }
+
+    // 先序遍历
+    if (dentry->children != nullptr) {
+      dentry = dentry->children;
+      continue;
+    }
+    while (dentry != root && dentry->next_sibling == nullptr) {
+      dentry = dentry->parent;
+    }
+    dentry = (dentry == root) ? nullptr : dentry->next_sibling;
+  }
+  return false;
+}
+
+auto DestroyDentryTree(Dentry* root) -> void {
+  if (root == nullptr) {
+    return;
+  }
+  PruneDentryTree(root);
+  ReleaseMemory(root);
+}
+
+auto ShrinkDentryCache(size_t count) -> size_t {
+  auto& cache = GetVfsState().dcache;
+  LockGuard<SpinLock> guard(cache.lock);
+  size_t freed = ShrinkLocked(count);
+  klog::Debug("VFS: dcache shrunk by {}, {} cached", freed, cache.count);
+  return freed;
+}
+
+}  // namespace vfs
@@ -0,0 +1,101 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "vfs.hpp"
+
+namespace vfs {
+
+auto FileOps::Open(File* file) -> Expected<void> {
+  (void)file;
+  return {};
+}
+
+auto FileOps::PRead(File* file, void* buf, size_t count, uint64_t offset)
+    -> Expected<size_t> {
+  if (file == nullptr || buf == nullptr ||
+      offset > static_cast<uint64_t>(INT64_MAX)) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  // 借用共享的偏移量，期间排除同一 File 上的其它读写
+  WriteLockGuard pos_guard(file->pos_lock);
+  auto saved_offset = file->offset;
+  auto seek_result = Seek(file, static_cast<int64_t>(offset), SeekWhence::kSet);
+  if (!seek_result.has_value()) {
+    return std::unexpected(seek_result.error());
+  }
+
+  auto result = Read(file, buf, count);
+  // 恢复原偏移量
+  (void)Seek(file, static_cast<int64_t>(saved_offset), SeekWhence::kSet);
+  return result;
+}
+
+auto FileOps::PWrite(File* file, const void* buf, size_t count,
+                     uint64_t offset) -> Expected<size_t> {
+  if (file == nullptr || buf == nullptr ||
+      offset > static_cast<uint64_t>(INT64_MAX)) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  // 借用共享的偏移量，期间排除同一 File 上的其它读写
+  WriteLockGuard pos_guard(file->pos_lock);
+  auto saved_offset = file->offset;
+  auto seek_result = Seek(file, static_cast<int64_t>(offset), SeekWhence::kSet);
+  if (!seek_result.has_value()) {
+    return std::unexpected(seek_result.error());
+  }
+
+  auto result = Write(file, buf, count);
+  // 恢复原偏移量
+  (void)Seek(file, static_cast<int64_t>(saved_offset), SeekWhence::kSet);
+  return result;
+}
+
+auto FileOps::ReadPage(File* file, void* buf, size_t count, uint64_t offset)
+    -> Expected<size_t> {
+  if (file == nullptr || buf == nullptr ||
+      offset > static_cast<uint64_t>(INT64_MAX)) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  // 调用者已持有偏移量锁
+  auto saved_offset = file->offset;
+  auto seek_result = Seek(file, static_cast<int64_t>(offset), SeekWhence::kSet);
+  if (!seek_result.has_value()) {
+    return std::unexpected(seek_result.error());
+  }
+
+  // 文件系统的单次读取可能不足一页，读满或到达文件末尾为止
+  auto* dst = static_cast<uint8_t*>(buf);
+  size_t done = 0;
+  Expected<size_t> result = done;
+  while (done < count) {
+    auto read_result = Read(file, dst + done, count - done);
+    if (!read_result.has_value()) {
+      if (done == 0) {
+        result = std::unexpected(read_result.error());
+      }
+      break;
+    }
+    if (read_result.value() == 0) {
+      break;
+    }
+    done += read_result.value();
+    result = done;
+  }
+
+  (void)Seek(file, static_cast<int64_t>(saved_offset), SeekWhence::kSet);
+  return result;
+}
+
+auto FileOps::MapExtent(File* file, uint64_t offset, uint64_t count)
+    -> Expected<BlockExtent> {
+  (void)file;
+  (void)offset;
+  (void)count;
+  return std::unexpected(Error(ErrorCode::kNotSupported));
+}
+
+}  // namespace vfs
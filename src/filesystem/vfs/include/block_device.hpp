@@ -4,13 +4,82 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
+#include "completion.hpp"
 #include "expected.hpp"
 
 namespace vfs {
 
+class BlockQueue;
+
+/// @brief 块请求的方向
+enum class BlockOp : uint8_t {
+  kRead,
+  kWrite,
+};
+
+/**
+ * @brief 块请求：一段连续扇区与对应的内存缓冲区
+ * @details 提交者填写前六个字段后通过 BlockDevice::Submit 提交，完成时
+ *          调用 end_io（可能在中断上下文中）。请求在完成前必须保持有效。
+ *          块层可能把扇区相邻的请求合并为一个派发单元交给驱动，单元的
+ *          头部请求通过 merge_next 串起其余请求。
+ */
+struct BlockRequest {
+  /// 读或写
+  BlockOp op{BlockOp::kRead};
+  /// 起始扇区号
+  uint64_t sector{0};
+  /// 扇区数量
+  uint32_t sector_count{0};
+  /// 数据缓冲区，大小为 sector_count * GetSectorSize()
+  void* buffer{nullptr};
+  /// 完成回调，不可休眠
+  void (*end_io)(BlockRequest* request){nullptr};
+  /// 提交者的私有数据
+  void* private_data{nullptr};
+  /// 完成状态，调用 end_io 前设置
+  ErrorCode status{ErrorCode::kSuccess};
+
+  /// @name 块层使用的字段
+  /// @{
+  /// 所属队列，直接提交给驱动时为 nullptr
+  BlockQueue* queue{nullptr};
+  /// 队列中的下一个派发单元
+  BlockRequest* next{nullptr};
+  /// 同一派发单元中的下一个请求
+  BlockRequest* merge_next{nullptr};
+  /// 同一派发单元中的最后一个请求（仅头部有效）
+  BlockRequest* merge_tail{nullptr};
+  /// 派发单元的总扇区数（仅头部有效）
+  uint32_t merged_sectors{0};
+  /// 派发到的硬件队列，见 BlockDevice::GetHwQueueCount
+  uint32_t hw_queue{0};
+  /// @}
+
+  /// @name 驱动使用的字段
+  /// @{
+  /// 已交给设备的请求数
+  uint32_t driver_queued{0};
+  /// 尚未完成的设备请求数
+  uint32_t driver_pending{0};
+  /// 设备请求中的第一个错误
+  ErrorCode driver_status{ErrorCode::kSuccess};
+  /// @}
+};
+
+/**
+ * @brief 结束一个派发单元：设置单元中每个请求的状态并调用其 end_io
+ * @param request 派发单元的头部请求
+ * @param status 完成状态
+ * @note 驱动在设备完成请求后调用，可在中断上下文中调用，调用时不得持有
+ *       驱动自身的锁（所属队列可能在其中派发新的请求）
+ */
+auto EndRequest(BlockRequest* request, ErrorCode status) -> void;
+
 /**
  * @brief 块设备抽象基类
  * @details 所有块设备驱动（virtio-blk、ramdisk 等）必须实现此接口。
@@ -71,6 +140,186 @@ class BlockDevice {
    * @return Expected<void> 成功或错误
    */
   [[nodiscard]] virtual auto Flush() -> Expected<void> { return {}; }
+
+  /// @name 异步接口
+  /// @{
+
+  /**
+   * @brief 提交一个块请求
+   * @param request 请求，完成前必须保持有效
+   * @return Expected<void> 请求无效时返回错误；I/O 错误通过
+   *         request->status 报告
+   * @note 默认实现同步执行请求，返回前调用 end_io
+   */
+  [[nodiscard]] virtual auto Submit(BlockRequest* request) -> Expected<void> {
+    if (request == nullptr || request->buffer == nullptr) {
+      return std::unexpected(Error(ErrorCode::kInvalidArgument));
+    }
+    auto result = (request->op == BlockOp::kRead)
+                      ? ReadSectors(request->sector, request->sector_count,
+                                    request->buffer)
+                      : WriteSectors(request->sector, request->sector_count,
+                                     request->buffer);
+    request->status =
+        result.has_value() ? ErrorCode::kSuccess : result.error().code;
+    if (request->end_io != nullptr) {
+      request->end_io(request);
+    }
+    return {};
+  }
+
+  /// @brief 开始批量提交，之后提交的请求暂不派发
+  virtual auto Plug() -> void {}
+
+  /// @brief 结束批量提交，派发暂存的请求
+  virtual auto Unplug() -> void {}
+
+  /**
+   * @brief 处理已完成的请求
+   * @note 等待请求完成的调用者循环调用，使不依赖中断的设备也能推进
+   */
+  virtual auto PollRequests() -> void {}
+
+  /**
+   * @brief 请求完成是否由中断报告
+   * @return true 时等待请求的任务可以睡眠，否则需要调用 PollRequests
+   */
+  [[nodiscard]] virtual auto HasCompletionIrq() const -> bool {
+    return false;
+  }
+
+  /**
+   * @brief 睡眠等待请求完成前轮询设备
+   * @param done 等待的完成量，轮询期间完成即可返回
+   * @note 设备预计请求很快完成时可先轮询一段时间，省去中断投递与上下文
+   *       切换；默认不轮询
+   */
+  virtual auto PollBeforeSleep([[maybe_unused]] const Completion& done)
+      -> void {}
+
+  /// @}
+
+  /// @name 驱动接口
+  /// @{
+
+  /**
+   * @brief 设备可同时处理的派发单元数
+   * @return 为 0 时设备只支持同步读写
+   */
+  [[nodiscard]] virtual auto GetQueueDepth() const -> uint32_t { return 0; }
+
+  /**
+   * @brief 设备的硬件队列数
+   * @return 至少为 1；队列深度由各硬件队列平分
+   * @note 派发单元的 hw_queue 指明驱动应使用的硬件队列
+   */
+  [[nodiscard]] virtual auto GetHwQueueCount() const -> uint32_t { return 1; }
+
+  /**
+   * @brief 把一个派发单元交给设备，不通知设备
+   * @param request 派发单元的头部请求
+   * @return Expected<void> 设备资源暂时不足时返回 kNoFreeDescriptors
+   * @note 单元完成时驱动调用 EndRequest。设备没有在途请求时驱动必须
+   *       接受任意大小的单元，放不下的部分由驱动在资源释放后继续提交
+   */
+  [[nodiscard]] virtual auto QueueRequest(
+      [[maybe_unused]] BlockRequest* request) -> Expected<void> {
+    return std::unexpected(Error(ErrorCode::kNotSupported));
+  }
+
+  /// @brief 通知设备处理已交给它的请求
+  virtual auto CommitRequests() -> void {}
+
+  /// @}
+};
+
+/**
+ * @brief 等待提交到设备的请求把完成量标记为完成
+ * @param device 请求提交到的块设备
+ * @param done 请求的 end_io 最终完成的完成量
+ * @param timeout_ms 睡眠等待的总毫秒数，为 0 时不超时
+ * @return ErrorCode 完成返回 kSuccess，超时返回 kTimeout
+ * @note 设备通过中断报告完成时先让设备轮询一次，仍未完成再睡眠，每睡眠
+ *       BlockWaiter::kTimeoutMs 轮询一次设备；否则一直轮询设备，不计超时。
+ *       超时不会撤回请求，设备之后仍会写入缓冲区并调用 end_io，只有请求、
+ *       缓冲区与完成量不随调用者返回而释放时才能指定超时
+ */
+[[nodiscard]] auto WaitForIo(BlockDevice* device, Completion& done,
+                             uint64_t timeout_ms = 0) -> ErrorCode;
+
+/**
+ * @brief 同步等待一组块请求完成
+ * @details 提交者把请求的 end_io 设为 EndIo、private_data 指向等待对象，
+ *          每提交一个请求调用一次 Add()，提交完后调用 Wait()。设备通过
+ *          中断报告完成时等待的任务先让设备轮询一次（PollBeforeSleep），
+ *          仍未完成再睡眠，由最后一个完成的请求唤醒；否则轮询设备。
+ */
+class BlockWaiter {
+ public:
+  /// 每次睡眠的时长，到时轮询一次设备，避免中断丢失时永久等待
+  static constexpr uint64_t kTimeoutMs = 1000;
+
+  /**
+   * @brief 登记一个已提交的请求
+   */
+  auto Add() -> void { pending_.fetch_add(1, std::memory_order_relaxed); }
+
+  /**
+   * @brief 等待所有登记的请求完成
+   * @param device 请求提交到的块设备
+   * @param timeout_ms 睡眠等待的总毫秒数，为 0 时不超时
+   * @return ErrorCode 第一个失败请求的状态，超时返回 kTimeout
+   * @warning 请求不能撤回：返回 kTimeout 后设备仍会访问请求与缓冲区并
+   *          调用 EndIo，等待对象、请求与缓冲区必须继续有效，也不能再次
+   *          调用 Wait。内核的同步读写把它们放在栈上，因此不指定超时
+   */
+  [[nodiscard]] auto Wait(BlockDevice* device, uint64_t timeout_ms = 0)
+      -> ErrorCode;
+
+  /**
+   * @brief 请求的完成回调
+   * @param request 已完成的请求
+   */
+  static auto EndIo(BlockRequest* request) -> void;
+
+  /// @name 构造/析构函数
+  /// @{
+  BlockWaiter() = default;
+  BlockWaiter(const BlockWaiter&) = delete;
+  BlockWaiter(BlockWaiter&&) = delete;
+  auto operator=(const BlockWaiter&) -> BlockWaiter& = delete;
+  auto operator=(BlockWaiter&&) -> BlockWaiter& = delete;
+  ~BlockWaiter() = default;
+  /// @}
+
+ private:
+  /// 未完成的请求数，加上 Wait() 之前提交者持有的一个
+  std::atomic<uint32_t> pending_{1};
+  /// 第一个错误
+  std::atomic<ErrorCode> status_{ErrorCode::kSuccess};
+  /// 所有请求完成
+  Completion done_{"block_io"};
+};
+
+/**
+ * @brief 在作用域内批量提交请求
+ * @details 作用域结束时派发期间提交的请求，相邻请求得以合并，设备每批
+ *          只被通知一次
+ */
+class BlockPlug {
+ public:
+  /// @name 构造/析构函数
+  /// @{
+  explicit BlockPlug(BlockDevice* device) : device_(device) { device_->Plug(); }
+  BlockPlug(const BlockPlug&) = delete;
+  BlockPlug(BlockPlug&&) = delete;
+  auto operator=(const BlockPlug&) -> BlockPlug& = delete;
+  auto operator=(BlockPlug&&) -> BlockPlug& = delete;
+  ~BlockPlug() { device_->Unplug(); }
+  /// @}
+
+ private:
+  BlockDevice* device_;
 };
 
 }  // namespace vfs
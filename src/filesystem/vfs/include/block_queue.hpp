@@ -0,0 +1,157 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "block_device.hpp"
+#include "spinlock.hpp"
+
+namespace vfs {
+
+/// @brief 块请求队列统计信息
+struct BlockQueueStats {
+  /// 提交的请求数
+  uint64_t submitted{0};
+  /// 合并次数，每次合并使派发单元减少一个
+  uint64_t merged{0};
+  /// 交给设备的派发单元数
+  uint64_t dispatched{0};
+  /// 通知设备的次数
+  uint64_t kicks{0};
+};
+
+/**
+ * @brief 块请求队列
+ * @details 包装一个支持异步请求的块设备。提交的请求按扇区号排序暂存，
+ *          与相邻的同向请求合并为派发单元，在设备未满
+ *          （少于 GetQueueDepth() 个在途单元）时交给设备，每批派发只通知
+ *          设备一次。设备忙或处于 Plug 期间，新请求留在队列中等待合并。
+ *          同步的 ReadSectors/WriteSectors 经由队列提交并等待完成。
+ *          下层设备不支持异步请求（队列深度为 0）时直接转发。
+ *
+ *          设备有多个硬件队列时，每个硬件队列对应一个独立的软件上下文
+ *          （暂存链表、在途计数、统计与锁），请求进入提交核心对应的上下文，
+ *          只与同一上下文中的请求合并，不同核心之间不争用同一把锁。
+ * @note 队列不保证重叠请求之间的顺序，由提交者保证；
+ *       Plug 作用于整个队列，期间其它任务的请求也会暂存
+ */
+class BlockQueue final : public BlockDevice {
+ public:
+  /// 派发单元的最大扇区数
+  static constexpr uint32_t kMaxMergeSectors = 256;
+  /// 最多使用的硬件队列数
+  static constexpr uint32_t kMaxHwQueues = 8;
+
+  /// @name 构造/析构函数
+  /// @{
+
+  /**
+   * @brief 构造函数
+   * @param device 下层块设备
+   */
+  explicit BlockQueue(BlockDevice* device);
+
+  ~BlockQueue() override = default;
+
+  BlockQueue() = delete;
+  BlockQueue(const BlockQueue&) = delete;
+  BlockQueue(BlockQueue&&) = delete;
+  auto operator=(const BlockQueue&) -> BlockQueue& = delete;
+  auto operator=(BlockQueue&&) -> BlockQueue& = delete;
+
+  /// @}
+
+  /**
+   * @brief 同步读取连续扇区
+   * @param sector_start 起始扇区号
+   * @param sector_count 扇区数量
+   * @param buffer 输出缓冲区
+   * @return Expected<size_t> 读取的字节数
+   * @note 按 kMaxMergeSectors 拆分为多个请求一起提交
+   */
+  [[nodiscard]] auto ReadSectors(uint64_t sector_start, uint32_t sector_count,
+                                 void* buffer) -> Expected<size_t> override;
+
+  /**
+   * @brief 同步写入连续扇区
+   * @param sector_start 起始扇区号
+   * @param sector_count 扇区数量
+   * @param buffer 输入缓冲区
+   * @return Expected<size_t> 写入的字节数
+   */
+  [[nodiscard]] auto WriteSectors(uint64_t sector_start, uint32_t sector_count,
+                                  const void* buffer)
+      -> Expected<size_t> override;
+
+  [[nodiscard]] auto GetSectorSize() const -> uint32_t override;
+  [[nodiscard]] auto GetSectorCount() const -> uint64_t override;
+  [[nodiscard]] auto GetName() const -> const char* override;
+  [[nodiscard]] auto Flush() -> Expected<void> override;
+
+  /**
+   * @brief 提交一个块请求
+   * @param request 请求，完成前必须保持有效
+   * @return Expected<void> 请求无效时返回错误
+   */
+  [[nodiscard]] auto Submit(BlockRequest* request) -> Expected<void> override;
+
+  auto Plug() -> void override;
+  auto Unplug() -> void override;
+  auto PollRequests() -> void override;
+  [[nodiscard]] auto HasCompletionIrq() const -> bool override;
+  auto PollBeforeSleep(const Completion& done) -> void override;
+  [[nodiscard]] auto GetQueueDepth() const -> uint32_t override;
+
+  /**
+   * @brief 派发单元完成，由 EndRequest 调用
+   * @param request 派发单元的头部请求
+   * @param status 完成状态
+   */
+  auto Complete(BlockRequest* request, ErrorCode status) -> void;
+
+  /**
+   * @brief 获取统计信息
+   * @return BlockQueueStats 所有硬件队列的统计信息之和
+   */
+  [[nodiscard]] auto GetStats() -> BlockQueueStats;
+
+ private:
+  /// 一个硬件队列的软件上下文
+  struct HwContext {
+    /// 等待派发的单元，按起始扇区号升序
+    BlockRequest* pending{nullptr};
+    /// 在途的派发单元数
+    uint32_t inflight{0};
+    BlockQueueStats stats;
+    /// 保护以上字段
+    SpinLock lock{"block_queue"};
+  };
+
+  BlockDevice* device_;
+  uint32_t depth_;
+  /// 使用的硬件队列数
+  uint32_t hw_queues_;
+  /// 每个硬件队列的在途单元上限
+  uint32_t hw_depth_;
+  /// Plug 嵌套深度
+  std::atomic<uint32_t> plug_depth_{0};
+  std::array<HwContext, kMaxHwQueues> contexts_{};
+
+  /// 插入请求，能与相邻单元合并时合并
+  auto InsertLocked(HwContext& context, BlockRequest* request) -> void;
+  /// 尽可能派发上下文中等待的单元，返回派发失败的单元链表
+  auto DispatchLocked(HwContext& context) -> BlockRequest*;
+  /// 派发上下文中等待的单元并结束失败的单元
+  auto Dispatch(HwContext& context) -> void;
+  /// 同步读写的共同实现
+  auto Transfer(BlockOp op, uint64_t sector_start, uint32_t sector_count,
+                void* buffer) -> Expected<size_t>;
+};
+
+}  // namespace vfs
@@ -0,0 +1,221 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "block_device.hpp"
+#include "rw_mutex.hpp"
+#include "spinlock.hpp"
+
+namespace vfs {
+
+/// @brief 块缓存统计信息
+struct BufferCacheStats {
+  /// 缓存的扇区数
+  size_t buffers{0};
+  /// 脏扇区数
+  size_t dirty{0};
+  /// 命中次数（按扇区计）
+  uint64_t hits{0};
+  /// 未命中次数（按扇区计）
+  uint64_t misses{0};
+  /// 写回时向设备发出的写请求数
+  uint64_t write_requests{0};
+  /// 写回的扇区数
+  uint64_t written_sectors{0};
+};
+
+/**
+ * @brief 写回式扇区缓存
+ * @details 包装一个块设备。写入只更新缓存中的扇区并记为脏，由冲刷任务按
+ *          脏扇区的存留时间与数量写回；写回时按扇区号排序，相邻的脏扇区
+ *          合并为一次写请求，一批写请求同时提交给下层设备。小块的元数据读取（如 FAT 表）也会被缓存。
+ *          Flush 写回全部脏扇区后刷新下层设备，作为持久化屏障。
+ * @note 并发：缓存元数据受自旋锁保护，设备 I/O 期间不持有自旋锁；
+ *       写回与读取之间由 I/O 读写锁排除，读取不会看到写回途中被回收的扇区
+ */
+class BufferCache final : public BlockDevice {
+ public:
+  /// 缓存的扇区数上限
+  static constexpr size_t kMaxBuffers = 2048;
+  /// 冲刷任务的运行间隔（毫秒）
+  static constexpr uint64_t kFlushIntervalMs = 500;
+  /// 脏扇区经过该数量的冲刷周期后写回
+  static constexpr uint32_t kExpirePeriods = 6;
+  /// 脏扇区超过该数量时冲刷任务不等待过期，全部写回
+  static constexpr size_t kDirtyBackground = kMaxBuffers / 4;
+  /// 脏扇区超过该数量时由写入者同步写回
+  static constexpr size_t kDirtyLimit = kMaxBuffers / 2;
+  /// 合并写请求的最大扇区数
+  static constexpr uint32_t kMaxWriteSectors = 128;
+  /// 一批写回的最大扇区数，一批的写请求同时提交给下层设备
+  static constexpr size_t kWriteBackBatch = 512;
+  /// 不超过该扇区数的读取结果放入缓存，更大的读取（文件数据）直接经过
+  static constexpr uint32_t kMaxCachedReadSectors = 8;
+
+  /// @name 构造/析构函数
+  /// @{
+
+  /**
+   * @brief 构造函数
+   * @param device 下层块设备
+   */
+  explicit BufferCache(BlockDevice* device);
+
+  /**
+   * @brief 析构函数，释放所有缓存的扇区
+   * @pre 已调用 Flush，否则未写回的数据丢失
+   */
+  ~BufferCache() override;
+
+  BufferCache() = delete;
+  BufferCache(const BufferCache&) = delete;
+  BufferCache(BufferCache&&) = delete;
+  auto operator=(const BufferCache&) -> BufferCache& = delete;
+  auto operator=(BufferCache&&) -> BufferCache& = delete;
+
+  /// @}
+
+  /**
+   * @brief 读取连续扇区，缓存中的扇区（包括未写回的）优先
+   * @param sector_start 起始扇区号
+   * @param sector_count 扇区数量
+   * @param buffer 输出缓冲区
+   * @return Expected<size_t> 读取的字节数
+   */
+  [[nodiscard]] auto ReadSectors(uint64_t sector_start, uint32_t sector_count,
+                                 void* buffer) -> Expected<size_t> override;
+
+  /**
+   * @brief 写入连续扇区，数据留在缓存中由冲刷任务写回
+   * @param sector_start 起始扇区号
+   * @param sector_count 扇区数量
+   * @param buffer 输入缓冲区
+   * @return Expected<size_t> 写入的字节数
+   * @note 脏扇区超过 kDirtyLimit 时在返回前同步写回；缓存无法容纳时
+   *       直接写入设备
+   */
+  [[nodiscard]] auto WriteSectors(uint64_t sector_start, uint32_t sector_count,
+                                  const void* buffer)
+      -> Expected<size_t> override;
+
+  [[nodiscard]] auto GetSectorSize() const -> uint32_t override;
+  [[nodiscard]] auto GetSectorCount() const -> uint64_t override;
+  [[nodiscard]] auto GetName() const -> const char* override;
+
+  /**
+   * @brief 写回全部脏扇区并刷新下层设备
+   * @return Expected<void> 成功或错误
+   * @post 返回成功时此前完成的写入均已到达下层设备并被刷新
+   */
+  [[nodiscard]] auto Flush() -> Expected<void> override;
+
+  /**
+   * @brief 提交一个块请求
+   * @param request 请求，完成前必须保持有效
+   * @return Expected<void> 请求无效时返回错误；读取范围内有脏扇区或正在
+   *         写回的扇区时返回 kNotSupported，调用者改用 ReadSectors
+   * @note 读请求直接异步提交给下层设备，结果不放入缓存；写请求同步写入
+   *       缓存，返回前调用 end_io
+   */
+  [[nodiscard]] auto Submit(BlockRequest* request) -> Expected<void> override;
+
+  auto Plug() -> void override;
+  auto Unplug() -> void override;
+  auto PollRequests() -> void override;
+  [[nodiscard]] auto HasCompletionIrq() const -> bool override;
+  auto PollBeforeSleep(const Completion& done) -> void override;
+
+  /**
+   * @brief 冲刷任务的周期回调，每 kFlushIntervalMs 调用一次
+   * @return Expected<size_t> 写回的扇区数
+   * @note 写回存留超过 kExpirePeriods 个周期的脏扇区；
+   *       脏扇区超过 kDirtyBackground 时全部写回
+   */
+  auto Tick() -> Expected<size_t>;
+
+  /**
+   * @brief 获取统计信息
+   * @return BufferCacheStats 统计信息快照
+   */
+  [[nodiscard]] auto GetStats() -> BufferCacheStats;
+
+ private:
+  /// @brief 缓存的一个扇区
+  struct Buffer {
+    /// 扇区号
+    uint64_t sector;
+    /// 扇区数据
+    uint8_t* data;
+    /// 变脏时的冲刷周期
+    uint64_t dirty_period;
+    /// 同一哈希桶中的下一项
+    Buffer* hash_next;
+    /// 所在链表的指针：脏扇区位于脏链表，干净扇区位于 LRU 链表，
+    /// 写回途中未再次变脏的扇区不在任何链表
+    Buffer* prev;
+    Buffer* next;
+    /// 是否为脏
+    bool dirty;
+    /// 是否正在写回，期间不会被回收
+    bool writeback;
+  };
+
+  /// @brief 双向链表
+  struct BufferList {
+    Buffer* head = nullptr;
+    Buffer* tail = nullptr;
+  };
+
+  /// 哈希桶数量（2 的幂）
+  static constexpr size_t kBucketCount = 1024;
+
+  BlockDevice* device_;
+  uint32_t sector_size_;
+
+  std::array<Buffer*, kBucketCount> buckets_{};
+  /// 干净扇区的 LRU 链表，头部最久未使用
+  BufferList clean_;
+  /// 脏扇区链表，按变脏的先后排列
+  BufferList dirty_;
+  size_t count_{0};
+  size_t dirty_count_{0};
+  /// 冲刷周期计数
+  uint64_t period_{0};
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+  uint64_t write_requests_{0};
+  uint64_t written_sectors_{0};
+  /// 保护以上字段与扇区内容
+  SpinLock lock_{"buffer_cache"};
+
+  /// 写回时收集的扇区，受 io_lock_ 的写锁保护
+  std::array<Buffer*, kWriteBackBatch> batch_{};
+  /// 一批写回的中转缓冲区，按 batch_ 的顺序存放，受 io_lock_ 的写锁保护
+  uint8_t* bounce_{nullptr};
+  /// 一批写回的写请求，受 io_lock_ 的写锁保护
+  BlockRequest* requests_{nullptr};
+  /// 读取持共享锁，写回持独占锁
+  RwMutex io_lock_{"buffer_cache_io"};
+
+  /// 查找扇区
+  auto Find(uint64_t sector) -> Buffer*;
+  /// 为扇区取得一个缓存项：新分配或回收最久未使用的干净扇区
+  auto AllocateLocked(uint64_t sector) -> Buffer*;
+  /// 标记为脏并移到脏链表末尾（已为脏时不移动）
+  auto MarkDirtyLocked(Buffer* buffer) -> void;
+  /// 写回脏扇区，@p expired_only 为 true 时只写回过期的
+  auto WriteBack(bool expired_only) -> Expected<size_t>;
+  /// 写回一批扇区：收集、排序并提交写请求，等待全部完成
+  auto WriteBatch(bool expired_only) -> Expected<size_t>;
+  static auto ListRemove(BufferList& list, Buffer* buffer) -> void;
+  static auto ListAppend(BufferList& list, Buffer* buffer) -> void;
+  auto GetBucket(uint64_t sector) -> Buffer*&;
+};
+
+}  // namespace vfs
@@ -61,12 +61,30 @@ class FileSystem {
    */
   [[nodiscard]] virtual auto FreeInode(Inode* inode) -> Expected<void> = 0;
 
+  /**
+   * @brief 引用 inode 的 dentry 被释放（dcache 回收、删除或卸载）
+   * @param inode 不再被任何 dentry 引用的 inode
+   * @note 默认不做任何事，适用于 inode 由自身目录结构持有的文件系统；
+   *       每次 InodeOps::Lookup 都分配新 inode 的文件系统需在此归还，
+   *       否则回收后重新查找会耗尽 inode。VFS 已丢弃其缓存页。
+   *       调用时持有 dcache 自旋锁，不能睡眠
+   */
+  virtual auto ReleaseInode(Inode* /*inode*/) -> void {}
+
   /**
    * @brief 获取文件系统的文件操作接口
    * @return FileOps* 文件操作接口指针
    * @note 用于创建 File 对象时设置 ops
    */
   [[nodiscard]] virtual auto GetFileOps() -> FileOps* = 0;
+
+  /**
+   * @brief 文件数据是否经由 VFS 页缓存读取
+   * @return bool 默认 false；块设备上的文件系统返回 true
+   * @note 返回 true 的文件系统由 FileOps::ReadPage 填充缓存页，
+   *       释放 inode 前需调用 InvalidatePageCache
+   */
+  [[nodiscard]] virtual auto UsesPageCache() const -> bool { return false; }
 };
 
 }  // namespace vfs
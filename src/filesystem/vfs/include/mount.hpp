@@ -4,18 +4,22 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+
 #include "filesystem.hpp"
 
 namespace vfs {
 
 /**
  * @brief 挂载点
- * @details 将一个文件系统的根 inode 关联到目录树中的某个 dentry 上
+ * @details 将一个文件系统的根 inode 关联到目录树中的某个 dentry 上。
+ *          发布后只读，卸载后在没有无锁路径解析的读者时释放。
  */
 struct MountPoint {
   /// 挂载路径（如 "/mnt/disk"）
   const char* mount_path{nullptr};
-  /// 挂载点在父文件系统中的 dentry
+  /// 挂载点在父文件系统中的 dentry（根挂载为 nullptr），挂载期间持有其引用
   Dentry* mount_dentry{nullptr};
   /// 挂载的文件系统实例
   FileSystem* filesystem{nullptr};
@@ -28,8 +32,14 @@ struct MountPoint {
   /// 是否处于活动状态
   bool active{false};
 };
+
 /**
  * @brief 挂载表管理器
+ * @details 挂载表以只读快照的形式发布。挂载与卸载在 VFS 锁下复制当前快照、
+ *          修改副本后替换快照指针，路径解析无需加锁即可读取快照；
+ *          旧快照与已卸载的挂载点在没有无锁路径解析的读者时释放。
+ *          挂载点 dentry 设置 Dentry::mounted 标志，路径解析只对设置了
+ *          该标志的 dentry 通过 LookupMounted 以 O(1) 散列查找挂载点。
  */
 class MountTable {
  public:
@@ -43,7 +53,7 @@ class MountTable {
   MountTable(MountTable&&) = delete;
   auto operator=(const MountTable&) -> MountTable& = delete;
   auto operator=(MountTable&&) -> MountTable& = delete;
-  ~MountTable() = default;
+  ~MountTable();
   /// @}
 
   /**
@@ -52,7 +62,7 @@ class MountTable {
    * @param fs 文件系统实例
    * @param device 块设备（可为 nullptr）
    * @return Expected<void>
-   * @pre path 必须是已存在的目录
+   * @pre path 为 "/" 或已存在的目录
    * @post 后续对 path 下路径的访问将被重定向到新文件系统
    */
   [[nodiscard]] auto Mount(const char* path, FileSystem* fs,
@@ -61,7 +71,7 @@ class MountTable {
   /**
    * @brief 卸载指定路径的文件系统
    * @param path 挂载点路径
-   * @return Expected<void>
+   * @return Expected<void> 仍有文件打开时返回 kFsUnmountFailed
    */
   [[nodiscard]] auto Unmount(const char* path) -> Expected<void>;
 
@@ -69,9 +79,26 @@ class MountTable {
    * @brief 根据路径查找对应的挂载点
    * @param path 文件路径
    * @return MountPoint* 最长前缀匹配的挂载点，未找到返回 nullptr
+   * @note 逐个比较挂载路径，路径解析使用 LookupMounted
    */
   [[nodiscard]] auto Lookup(const char* path) -> MountPoint*;
 
+  /**
+   * @brief 查找挂载在 dentry 上的文件系统
+   * @param dentry 设置了 Dentry::mounted 标志的 dentry
+   * @return MountPoint* 挂载点，未挂载时返回 nullptr
+   * @note 无锁，调用者持有 dcache 锁或处于无锁路径解析中
+   */
+  [[nodiscard]] auto LookupMounted(const Dentry* dentry) const -> MountPoint*;
+
+  /**
+   * @brief 查找以 dentry 为根的挂载点
+   * @param root 挂载的文件系统的根 dentry
+   * @return MountPoint* 挂载点，不是挂载根时返回 nullptr
+   * @note 用于跨越挂载根解析 ".."，要求同 LookupMounted
+   */
+  [[nodiscard]] auto LookupRoot(const Dentry* root) const -> MountPoint*;
+
   /**
    * @brief 获取指定挂载点的根 dentry
    * @param mp 挂载点
@@ -94,9 +121,59 @@ class MountTable {
   [[nodiscard]] auto GetRootMount() -> MountPoint*;
 
  private:
-  MountPoint mounts_[kMaxMounts]{};
-  size_t mount_count_{0};
-  MountPoint* root_mount_{nullptr};
+  /// 挂载点散列表大小（2 的幂，不小于 kMaxMounts 的两倍）
+  static constexpr size_t kHashSize = 32;
+
+  /// @brief 挂载表快照，发布后只读
+  struct Snapshot {
+    /// 活动的挂载点
+    std::array<MountPoint*, kMaxMounts> mounts{};
+    /// 挂载点数量
+    size_t count{0};
+    /// 以挂载点 dentry 为键的开放寻址散列表
+    std::array<MountPoint*, kHashSize> by_dentry{};
+    /// 根挂载点
+    MountPoint* root{nullptr};
+    /// 替换本快照时被卸载的挂载点，与本快照一起释放
+    MountPoint* dropped{nullptr};
+    /// 等待释放的快照链表
+    Snapshot* retired_next{nullptr};
+  };
+
+  /**
+   * @brief 计算 dentry 在散列表中的起始槽位
+   */
+  [[nodiscard]] static auto HashDentry(const Dentry* dentry) -> size_t;
+
+  /**
+   * @brief 按挂载路径精确查找活动的挂载点
+   * @pre 持有 VFS 锁
+   */
+  [[nodiscard]] auto FindActive(const char* path) -> MountPoint*;
+
+  /**
+   * @brief 以 mounts 为内容填充快照，重建散列表
+   */
+  static auto BuildSnapshot(Snapshot* snapshot) -> void;
+
+  /**
+   * @brief 发布新快照并回收旧快照
+   * @param snapshot 新快照
+   * @param dropped 被卸载的挂载点，可为 nullptr
+   * @pre 持有 VFS 锁与 dcache 锁
+   */
+  auto Publish(Snapshot* snapshot, MountPoint* dropped) -> void;
+
+  /**
+   * @brief 没有无锁路径解析的读者时释放等待释放的快照
+   * @pre 持有 VFS 锁
+   */
+  auto ReclaimRetired() -> void;
+
+  /// 当前快照，路径解析无锁读取
+  std::atomic<Snapshot*> current_{nullptr};
+  /// 已被替换、等待读者退出后释放的快照
+  Snapshot* retired_{nullptr};
 };
 
 /**
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <atomic>
+
+#include "rw_mutex.hpp"
 #include "vfs_types.hpp"
 
 namespace vfs {
@@ -31,17 +34,35 @@ struct Inode {
 
   /// 文件操作接口
   InodeOps* ops{nullptr};
+
+  /// 读写锁：读文件与目录查找持共享锁，写文件与修改目录持独占锁
+  RwMutex lock{"inode"};
 };
 
 /**
  * @brief Dentry — 目录项缓存（路径名 ↔ Inode 的映射）
  * @details Dentry 构成一棵树，反映目录层次结构。
- *          支持路径查找加速。
+ *          所有非根 dentry 按 (父 dentry, 名称哈希) 挂入全局 dcache，
+ *          路径解析每级只需一次哈希查找。inode 为 nullptr 的负 dentry
+ *          缓存"不存在"的查找结果。引用计数为 0 的 dentry 位于 LRU 链表，
+ *          内存紧张时被回收。
+ * @note 并发：结构字段受 dcache 锁保护，哈希表与树的修改同时递增
+ *       dcache 序号，路径解析可无锁遍历后校验序号。引用计数可无锁增加，
+ *       降为 0 只在持有 dcache 锁时发生。
  */
 struct Dentry {
-  /// 文件/目录名
-  char name[256]{};
-  /// 关联的 inode
+  /// 内联存储的名称长度上限（含 '\0'），更长的名称单独分配
+  static constexpr size_t kInlineNameSize = 32;
+
+  /// 短名称的内联存储
+  char inline_name[kInlineNameSize]{};
+  /// 文件/目录名，指向 inline_name 或单独分配的长名称
+  char* name{inline_name};
+  /// 名称长度（不含 '\0'）
+  uint32_t name_len{0};
+  /// 名称哈希，由 HashName 计算
+  uint32_t name_hash{0};
+  /// 关联的 inode，nullptr 表示负 dentry
   Inode* inode{nullptr};
   /// 父目录项
   Dentry* parent{nullptr};
@@ -49,8 +70,52 @@ struct Dentry {
   Dentry* children{nullptr};
   /// 兄弟目录项（同一父目录下）
   Dentry* next_sibling{nullptr};
+  /// 前一个兄弟目录项
+  Dentry* prev_sibling{nullptr};
+  /// dcache 哈希桶中的下一项
+  Dentry* hash_next{nullptr};
+  /// LRU 链表前驱
+  Dentry* lru_prev{nullptr};
+  /// LRU 链表后继
+  Dentry* lru_next{nullptr};
+  /// 引用计数：每个子 dentry、打开的 File 与 Lookup 的调用者各持有一个
+  std::atomic<uint32_t> ref_count{0};
+  /// 是否位于 dcache 哈希表中
+  bool hashed{false};
+  /// 是否位于 LRU 链表（获得引用时不立即移出，由回收时跳过）
+  bool on_lru{false};
+  /// 是否有文件系统挂载在此 dentry 上，由 MountTable 在 dcache 锁下修改，
+  /// 路径解析只对设置了该标志的 dentry 查询挂载表
+  std::atomic<bool> mounted{false};
   /// 文件系统私有数据
   void* fs_private{nullptr};
+
+  /// @name 构造/析构函数
+  /// @{
+  Dentry() = default;
+  Dentry(const Dentry&) = delete;
+  Dentry(Dentry&&) = delete;
+  auto operator=(const Dentry&) -> Dentry& = delete;
+  auto operator=(Dentry&&) -> Dentry& = delete;
+  ~Dentry();
+  /// @}
+};
+
+/**
+ * @brief 打开文件的顺序预读状态
+ * @details 顺序读取时预读窗口逐次加倍，窗口内已读入但在使用前被回收的页
+ *          使窗口减半，随机读取清空窗口。窗口中第一个"异步"页带有标记，
+ *          读到它时在调用者消费其余页之前读入下一窗口。
+ */
+struct ReadaheadState {
+  /// 当前窗口的起始页号
+  uint64_t start{0};
+  /// 窗口页数，0 表示没有窗口
+  uint32_t size{0};
+  /// 窗口末尾的异步部分页数
+  uint32_t async_size{0};
+  /// 上一次读取的页号，初值加 1 回绕为 0，使从文件开头的读取视为顺序读
+  uint64_t prev_index{UINT64_MAX};
 };
 
 /**
@@ -67,9 +132,18 @@ struct File {
   uint64_t offset{0};
   /// 打开标志 (OpenFlags)
   OpenFlags flags{OpenFlags::kOReadOnly};
+  /// 引用计数，Dup 和 fork 复制的文件描述符共享同一个 File
+  std::atomic<uint32_t> ref_count{1};
 
   /// 文件操作接口
   FileOps* ops{nullptr};
+
+  /// 顺序预读状态，受偏移量锁保护（仅使用页缓存的文件系统）
+  ReadaheadState readahead{};
+
+  /// 偏移量锁，串行化共享同一 File 的读写与 Seek（只使用写锁，
+  /// 在 inode 锁之后获取）
+  RwMutex pos_lock{"file_pos"};
 };
 
 /**
@@ -86,11 +160,19 @@ struct File {
  * @param path 绝对路径（以 / 开头）
  * @return Expected<Dentry*> 找到的 dentry 或错误
  * @pre path != nullptr && path[0] == '/'
- * @note 线程安全：是，内部使用 MountTable 锁
+ * @post 成功时返回的 dentry 持有一个引用，使用完毕后调用 PutDentry()
+ * @note 线程安全：是。先无锁遍历 dcache 并用序号校验，
+ *       未命中或校验失败时逐级加锁解析，访问文件系统时持有目录 inode 的共享锁
  * @note 会自动跨越挂载点解析路径
  */
 [[nodiscard]] auto Lookup(const char* path) -> Expected<Dentry*>;
 
+/**
+ * @brief 释放 dentry 的一个引用
+ * @param dentry Lookup() 返回的 dentry，可为 nullptr
+ */
+auto PutDentry(Dentry* dentry) -> void;
+
 /**
  * @brief 打开文件
  * @param path 文件路径
@@ -108,7 +190,7 @@ struct File {
  * @param file 文件对象
  * @return Expected<void> 成功或错误
  * @pre file != nullptr
- * @note 会调用文件系统特定的 close 回调
+ * @note 仅在最后一个引用释放时调用文件系统特定的 close 回调并释放 File
  * @note 关闭后 File 指针失效，不应再使用
  */
 [[nodiscard]] auto Close(File* file) -> Expected<void>;
@@ -139,6 +221,47 @@ struct File {
 [[nodiscard]] auto Write(File* file, const void* buf, size_t count)
     -> Expected<size_t>;
 
+/**
+ * @brief 从指定位置读取数据
+ * @param file 文件对象
+ * @param buf 输出缓冲区
+ * @param count 最大读取字节数
+ * @param offset 读取位置
+ * @return Expected<size_t> 实际读取的字节数或错误
+ * @pre file != nullptr && buf != nullptr
+ * @note 不使用也不改变 file->offset，共享 File 的任务可以并发按位置读取
+ */
+[[nodiscard]] auto PRead(File* file, void* buf, size_t count, uint64_t offset)
+    -> Expected<size_t>;
+
+/**
+ * @brief 查找文件中从 offset 开始的数据在块设备上的位置
+ * @param file 文件对象
+ * @param offset 起始位置，按扇区对齐
+ * @param count 希望映射的字节数
+ * @return Expected<BlockExtent> 从 offset 开始连续存放的一段，可能短于
+ *         count；offset 不在文件内时返回 kInvalidArgument，文件系统不支持
+ *         时返回 kNotSupported
+ * @pre file != nullptr
+ * @note 供绕过页缓存直接向块设备提交读请求的调用者使用。返回时已释放
+ *       inode 锁，读取期间文件被并发截断或改写时读到的数据未定义
+ */
+[[nodiscard]] auto MapExtent(File* file, uint64_t offset, uint64_t count)
+    -> Expected<BlockExtent>;
+
+/**
+ * @brief 向指定位置写入数据
+ * @param file 文件对象
+ * @param buf 输入缓冲区
+ * @param count 要写入的字节数
+ * @param offset 写入位置
+ * @return Expected<size_t> 实际写入的字节数或错误
+ * @pre file != nullptr && buf != nullptr
+ * @note 不使用也不改变 file->offset，会更新 file->inode->size
+ */
+[[nodiscard]] auto PWrite(File* file, const void* buf, size_t count,
+                          uint64_t offset) -> Expected<size_t>;
+
 /**
  * @brief 调整文件偏移量
  * @param file 文件对象
@@ -204,4 +327,59 @@ struct File {
  */
 [[nodiscard]] auto GetRootDentry() -> Dentry*;
 
+/**
+ * @brief 回收 dcache 中未使用的 dentry
+ * @param count 最多回收的数量
+ * @return size_t 实际回收的数量
+ * @note 按 LRU 顺序回收引用计数为 0 的 dentry（包括负 dentry），
+ *       供内存紧张时调用
+ */
+auto ShrinkDentryCache(size_t count) -> size_t;
+
+/// @brief 页缓存统计信息
+struct PageCacheStats {
+  /// 缓存的页数
+  size_t pages{0};
+  /// 命中次数（按页计）
+  uint64_t hits{0};
+  /// 未命中次数（按页计）
+  uint64_t misses{0};
+  /// 因容量或内存不足被回收的页数
+  uint64_t evictions{0};
+  /// 预读读入的页数（不含触发预读的页）
+  uint64_t readahead{0};
+};
+
+/**
+ * @brief 使 inode 在指定范围内的缓存页失效
+ * @param inode 文件 inode
+ * @param offset 起始位置
+ * @param length 范围长度，默认到文件末尾
+ * @note 文件系统不使用页缓存时无操作；写入、截断与删除文件后由 VFS 调用，
+ *       绕过 VFS 修改文件数据的文件系统需自行调用
+ */
+auto InvalidatePageCache(Inode* inode, uint64_t offset = 0,
+                         uint64_t length = UINT64_MAX) -> void;
+
+/**
+ * @brief 使文件系统的全部缓存页失效
+ * @param fs 文件系统
+ * @note 卸载文件系统前调用
+ */
+auto InvalidateFsPageCache(FileSystem* fs) -> void;
+
+/**
+ * @brief 回收页缓存中的页
+ * @param count 最多回收的数量
+ * @return size_t 实际回收的数量
+ * @note 按 LRU 顺序回收，供内存紧张时调用
+ */
+auto ShrinkPageCache(size_t count) -> size_t;
+
+/**
+ * @brief 获取页缓存统计信息
+ * @return PageCacheStats 统计信息快照
+ */
+[[nodiscard]] auto GetPageCacheStats() -> PageCacheStats;
+
 }  // namespace vfs
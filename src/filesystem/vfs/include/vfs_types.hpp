@@ -17,6 +17,7 @@ struct Dentry;
 struct File;
 struct FileSystem;
 class MountTable;
+class BlockDevice;
 
 /// 文件类型
 enum class FileType : uint8_t {
@@ -177,6 +178,16 @@ struct DirEntry {
   char name[256]{};
 };
 
+/// @brief 文件中一段数据在块设备上的连续位置（用于页缓存异步预读）
+struct BlockExtent {
+  /// 数据所在的块设备
+  BlockDevice* device{nullptr};
+  /// 起始扇区号
+  uint64_t sector{0};
+  /// 从起始扇区开始连续存放的字节数
+  uint64_t bytes{0};
+};
+
 /// @brief File 操作接口
 class FileOps {
  public:
@@ -215,6 +226,70 @@ class FileOps {
   virtual auto Seek(File* file, int64_t offset, SeekWhence whence)
       -> Expected<uint64_t> = 0;
 
+  /**
+   * @brief 从指定位置读取数据，不改变文件偏移量
+   * @param file 文件对象
+   * @param buf 输出缓冲区
+   * @param count 最大读取字节数
+   * @param offset 读取位置
+   * @return Expected<size_t> 实际读取的字节数或错误
+   * @pre file != nullptr && buf != nullptr
+   * @note 默认实现持有 File 的偏移量锁，通过 Seek + Read 完成并恢复
+   *       偏移量，能直接按位置访问数据的文件系统应当重写
+   */
+  virtual auto PRead(File* file, void* buf, size_t count, uint64_t offset)
+      -> Expected<size_t>;
+
+  /**
+   * @brief 向指定位置写入数据，不改变文件偏移量
+   * @param file 文件对象
+   * @param buf 输入缓冲区
+   * @param count 要写入的字节数
+   * @param offset 写入位置
+   * @return Expected<size_t> 实际写入的字节数或错误
+   * @pre file != nullptr && buf != nullptr
+   * @note 默认实现同 PRead
+   */
+  virtual auto PWrite(File* file, const void* buf, size_t count,
+                      uint64_t offset) -> Expected<size_t>;
+
+  /**
+   * @brief 为页缓存读取连续的一页或多页数据
+   * @param file 文件对象
+   * @param buf 页缓冲区
+   * @param count 读取字节数，预读时可达数十页
+   * @param offset 起始位置
+   * @return Expected<size_t> 实际读取的字节数，不足 count 表示到达文件末尾
+   * @pre 调用者持有 inode 的共享锁与 File 的偏移量锁
+   * @note 默认实现同 PRead 但不再获取偏移量锁，仅由 VFS 页缓存调用
+   */
+  virtual auto ReadPage(File* file, void* buf, size_t count, uint64_t offset)
+      -> Expected<size_t>;
+
+  /**
+   * @brief 查找从 offset 开始的数据在块设备上的位置
+   * @param file 文件对象
+   * @param offset 起始位置，按扇区对齐
+   * @param count 希望映射的字节数
+   * @return Expected<BlockExtent> 从 offset 开始连续存放的一段，可能短于
+   *         count；不支持时返回 kNotSupported
+   * @pre 调用者持有 inode 的共享锁，offset < inode->size
+   * @note 页缓存据此直接向设备提交预读请求，完成前不等待。返回前文件系统
+   *       需把尚未交给块设备的数据写出，使设备读取与 ReadPage 结果一致。
+   *       默认返回 kNotSupported，页缓存改用 ReadPage 同步读取
+   */
+  virtual auto MapExtent(File* file, uint64_t offset, uint64_t count)
+      -> Expected<BlockExtent>;
+
+  /**
+   * @brief 打开文件后的回调
+   * @param file 已填好 inode 与 dentry 的文件对象
+   * @return Expected<void> 失败时 VFS 放弃打开
+   * @pre file != nullptr
+   * @note 默认实现无操作，需要跟踪打开状态的文件系统重写，与 Close 配对
+   */
+  virtual auto Open(File* file) -> Expected<void>;
+
   /**
    * @brief 关闭文件
    * @param file 文件对象
@@ -5,69 +5,187 @@
 #include "filesystem.hpp"
 #include "kernel_log.hpp"
 #include "kstd_cstring"
-#include "kstd_memory"
 #include "spinlock.hpp"
 #include "vfs_internal.hpp"
 
 namespace vfs {
 
-auto Lookup(const char* path) -> Expected<Dentry*> {
-  if (!GetVfsState().initialized) {
-    return std::unexpected(Error(ErrorCode::kFsNotMounted));
-  }
+namespace {
 
-  if (path == nullptr || path[0] != '/') {
-    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+/**
+ * @brief 无锁遍历期间登记为读者，期间被移除的 dentry 延迟释放
+ */
+class WalkGuard {
+ public:
+  /// @name 构造/析构函数
+  /// @{
+  WalkGuard() {
+    GetVfsState().dcache.walkers.fetch_add(1, std::memory_order_seq_cst);
+  }
+  WalkGuard(const WalkGuard&) = delete;
+  WalkGuard(WalkGuard&&) = delete;
+  auto operator=(const WalkGuard&) -> WalkGuard& = delete;
+  auto operator=(WalkGuard&&) -> WalkGuard& = delete;
+  ~WalkGuard() {
+    GetVfsState().dcache.walkers.fetch_sub(1, std::memory_order_seq_cst);
   }
+  /// @}
+};
 
-  // 注意：Lookup 是内部函数，由持锁的上层 VFS 函数（Open/MkDir 等）调用，
-  // 此处不需要额外加锁，否则会导致 SpinLock 递归死锁。
-  // 空路径或根目录
-  if (path[0] == '/' && (path[1] == '\0' || path[1] == '/')) {
-    if (GetVfsState().root_dentry == nullptr) {
-      return std::unexpected(Error(ErrorCode::kFsNotMounted));
+/**
+ * @brief 跨越挂载在 dentry 上的文件系统
+ * @param current 当前 dentry
+ * @return Dentry* 最上层挂载的文件系统的根，没有挂载时返回 current
+ * @note 只对设置了 mounted 标志的 dentry 查询挂载表；调用者持有 dcache 锁
+ *       或处于序号校验的无锁遍历中
+ */
+auto FollowMount(Dentry* current) -> Dentry* {
+  while (current->mounted.load(std::memory_order_acquire)) {
+    MountPoint* mp = GetVfsState().mount_table->LookupMounted(current);
+    if (mp == nullptr || mp->root_dentry == nullptr) {
+      break;
     }
-    return GetVfsState().root_dentry;
+    current = mp->root_dentry;
   }
+  return current;
+}
 
-  // 查找路径对应的挂载点
-  MountPoint* mp = GetVfsState().mount_table->Lookup(path);
-  if (mp == nullptr || mp->root_dentry == nullptr) {
-    return std::unexpected(Error(ErrorCode::kFsNotMounted));
+/**
+ * @brief 解析 ".."
+ * @param current 当前 dentry
+ * @return Dentry* 父目录；位于挂载根时为挂载点的父目录，位于全局根时为自身
+ * @note 要求同 FollowMount
+ */
+auto FollowDotDot(Dentry* current) -> Dentry* {
+  // 挂载根没有父 dentry，回到挂载点所在的文件系统
+  while (current->parent == nullptr) {
+    MountPoint* mp = GetVfsState().mount_table->LookupRoot(current);
+    if (mp == nullptr || mp->mount_dentry == nullptr) {
+      return current;
+    }
+    current = mp->mount_dentry;
   }
+  return current->parent;
+}
+
+/**
+ * @brief 无锁路径解析
+ * @return Expected<Dentry*> 持有引用的 dentry；确定不存在时返回
+ *         kFsFileNotFound；需要加锁重试时返回 nullptr
+ */
+auto LookupFast(const char* path) -> Expected<Dentry*> {
+  auto& cache = GetVfsState().dcache;
+  WalkGuard walk;
+  uint32_t seq = cache.seq.ReadBegin();
 
-  // 从挂载点根开始解析路径
-  Dentry* current = mp->root_dentry;
+  // 从全局根开始，挂载点由 dentry 的 mounted 标志识别
+  Dentry* current = GetVfsState().root_dentry;
+  if (current == nullptr) {
+    return nullptr;
+  }
   const char* p = SkipLeadingSlashes(path);
 
-  // 如果挂载路径不是根，需要跳过挂载路径部分
-  if (mp->mount_path != nullptr && strcmp(mp->mount_path, "/") != 0) {
-    const char* mount_path = SkipLeadingSlashes(mp->mount_path);
-    while (*mount_path != '\0') {
-      char component[256];
-      size_t len = CopyPathComponent(mount_path, component, sizeof(component));
-      if (len == 0) {
-        break;
+  char component[256];
+  while (*p != '\0') {
+    Inode* inode = current->inode;
+    if (inode == nullptr || inode->type != FileType::kDirectory) {
+      return nullptr;
+    }
+
+    size_t len = CopyPathComponent(p, component, sizeof(component));
+    if (len == 0) {
+      break;
+    }
+    p += len;
+    p = SkipLeadingSlashes(p);
+
+    if (strcmp(component, ".") == 0) {
+      continue;
+    }
+    if (strcmp(component, "..") == 0) {
+      current = FollowDotDot(current);
+      continue;
+    }
+
+    Dentry* child =
+        LookupChild(current, component, len, HashName(component, len));
+    if (child == nullptr) {
+      return nullptr;
+    }
+    if (child->inode == nullptr) {
+      // 负 dentry：确认期间没有修改后即可判定不存在
+      if (cache.seq.ReadRetry(seq)) {
+        return nullptr;
       }
-      mount_path += len;
-      mount_path = SkipLeadingSlashes(mount_path);
+      return std::unexpected(Error(ErrorCode::kFsFileNotFound));
+    }
+
+    current = FollowMount(child);
+  }
+
+  // 先获得引用再校验，校验通过说明获得引用时 dentry 仍在 dcache 中
+  if (!TryGetDentry(current)) {
+    return nullptr;
+  }
+  if (cache.seq.ReadRetry(seq)) {
+    PutDentry(current);
+    return nullptr;
+  }
+  return current;
+}
 
-      // 跳过挂载路径的组件
-      len = CopyPathComponent(p, component, sizeof(component));
-      if (len == 0) {
-        break;
+/**
+ * @brief 解析一个路径组件
+ * @param parent 持有引用的父 dentry
+ * @param name 组件名
+ * @param len 组件长度
+ * @return Expected<Dentry*> 持有引用的正 dentry
+ */
+auto LookupComponent(Dentry* parent, const char* name, size_t len)
+    -> Expected<Dentry*> {
+  auto& cache = GetVfsState().dcache;
+  {
+    LockGuard<SpinLock> guard(cache.lock);
+    Dentry* child = LookupChild(parent, name, len, HashName(name, len));
+    if (child != nullptr) {
+      if (child->inode == nullptr) {
+        return std::unexpected(Error(ErrorCode::kFsFileNotFound));
       }
-      p += len;
-      p = SkipLeadingSlashes(p);
+      GetDentry(child);
+      return child;
     }
   }
 
+  // 未命中时访问文件系统，持有目录的共享锁以排除并发的创建与删除
+  ReadLockGuard dir_guard(parent->inode->lock);
+  return LookupComponentLocked(parent, name);
+}
+
+/**
+ * @brief 加锁路径解析
+ * @return Expected<Dentry*> 持有引用的 dentry
+ * @note 只在操作 dcache 时短暂持有 dcache 锁，访问文件系统时不持有
+ */
+auto LookupSlow(const char* path) -> Expected<Dentry*> {
+  auto& cache = GetVfsState().dcache;
+  Dentry* current = nullptr;
+  {
+    LockGuard<SpinLock> guard(cache.lock);
+    current = GetVfsState().root_dentry;
+    if (current == nullptr) {
+      return std::unexpected(Error(ErrorCode::kFsNotMounted));
+    }
+    GetDentry(current);
+  }
+  const char* p = SkipLeadingSlashes(path);
+
   // 逐级解析路径组件
   char component[256];
   while (*p != '\0') {
     // 检查当前 dentry 是否是目录
     if (current->inode == nullptr ||
         current->inode->type != FileType::kDirectory) {
+      PutDentry(current);
       return std::unexpected(Error(ErrorCode::kFsNotADirectory));
     }
 
@@ -83,57 +201,103 @@ auto Lookup(const char* path) -> Expected<Dentry*> {
     if (strcmp(component, ".") == 0) {
       continue;
     }
+
+    Dentry* next = nullptr;
     if (strcmp(component, "..") == 0) {
-      if (current->parent != nullptr) {
-        current = current->parent;
+      // 子 dentry 与挂载点持有父 dentry 的引用，父 dentry 此时不会被释放
+      LockGuard<SpinLock> guard(cache.lock);
+      next = FollowDotDot(current);
+      GetDentry(next);
+    } else {
+      if (current->inode->ops == nullptr) {
+        PutDentry(current);
+        return std::unexpected(Error(ErrorCode::kFsFileNotFound));
       }
-      continue;
+      auto result = LookupComponent(current, component, len);
+      if (!result.has_value()) {
+        PutDentry(current);
+        return std::unexpected(result.error());
+      }
+      next = result.value();
     }
+    PutDentry(current);
+    current = next;
 
-    // 在子节点中查找
-    Dentry* child = FindChild(current, component);
-    if (child == nullptr) {
-      // 尝试通过 inode ops 查找
-      if (current->inode->ops != nullptr) {
-        auto result = current->inode->ops->Lookup(current->inode, component);
-        if (!result.has_value()) {
-          return std::unexpected(Error(ErrorCode::kFsFileNotFound));
-        }
-
-        // 创建新的 dentry
-        auto new_child = kstd::make_unique<Dentry>();
-        if (!new_child) {
-          return std::unexpected(Error(ErrorCode::kOutOfMemory));
-        }
-
-        strncpy(new_child->name, component, sizeof(new_child->name) - 1);
-        new_child->name[sizeof(new_child->name) - 1] = '\0';
-        new_child->inode = result.value();
-        child = new_child.get();
-        AddChild(current, new_child.release());
-      } else {
-        return std::unexpected(Error(ErrorCode::kFsFileNotFound));
+    // 检查是否遇到挂载点
+    if (current->mounted.load(std::memory_order_acquire)) {
+      LockGuard<SpinLock> guard(cache.lock);
+      Dentry* mounted = FollowMount(current);
+      if (mounted != current) {
+        GetDentry(mounted);
+        PutDentryLocked(current);
+        current = mounted;
       }
     }
+  }
 
-    current = child;
+  return current;
+}
 
-    // 检查是否遇到挂载点
-    if (current->inode != nullptr) {
-      // 检查是否有文件系统挂载在此 dentry 上
-      for (size_t i = 0; i < MountTable::kMaxMounts; ++i) {
-        MountPoint* next_mp = GetVfsState().mount_table->Lookup(p);
-        if (next_mp != nullptr && next_mp != mp &&
-            next_mp->mount_dentry == current) {
-          mp = next_mp;
-          current = next_mp->root_dentry;
-          break;
-        }
+}  // namespace
+
+auto LookupComponentLocked(Dentry* parent, const char* name)
+    -> Expected<Dentry*> {
+  auto& cache = GetVfsState().dcache;
+  size_t len = strlen(name);
+  uint32_t hash = HashName(name, len);
+  Inode* dir = parent->inode;
+
+  {
+    // 其它任务可能在等锁期间完成了同一查找
+    LockGuard<SpinLock> guard(cache.lock);
+    Dentry* child = LookupChild(parent, name, len, hash);
+    if (child != nullptr) {
+      if (child->inode == nullptr) {
+        return std::unexpected(Error(ErrorCode::kFsFileNotFound));
       }
+      GetDentry(child);
+      return child;
     }
   }
 
-  return current;
+  if (dir == nullptr || dir->ops == nullptr) {
+    return std::unexpected(Error(ErrorCode::kFsFileNotFound));
+  }
+
+  auto result = dir->ops->Lookup(dir, name);
+
+  LockGuard<SpinLock> guard(cache.lock);
+  if (!result.has_value()) {
+    // 缓存负 dentry，后续对同一名称的查找无需再访问文件系统
+    if (result.error().code == ErrorCode::kFsFileNotFound) {
+      (void)AddChild(parent, name, len, hash, nullptr);
+    }
+    return std::unexpected(Error(ErrorCode::kFsFileNotFound));
+  }
+
+  auto add_result = AddChild(parent, name, len, hash, result.value());
+  if (!add_result.has_value()) {
+    return std::unexpected(add_result.error());
+  }
+  GetDentry(add_result.value());
+  return add_result.value();
+}
+
+auto Lookup(const char* path) -> Expected<Dentry*> {
+  if (!GetVfsState().initialized) {
+    return std::unexpected(Error(ErrorCode::kFsNotMounted));
+  }
+
+  if (path == nullptr || path[0] != '/') {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  // 路径上的 dentry 都已缓存且没有并发修改时，无需加锁
+  auto result = LookupFast(path);
+  if (!result.has_value() || result.value() != nullptr) {
+    return result;
+  }
+  return LookupSlow(path);
 }
 
 }  // namespace vfs
@@ -5,35 +5,61 @@
 #include "filesystem.hpp"
 #include "kernel_log.hpp"
 #include "kstd_cstring"
-#include "kstd_memory"
 #include "spinlock.hpp"
 #include "vfs_internal.hpp"
 
 namespace vfs {
 
+namespace {
+
+/**
+ * @brief 在已加写锁的父目录中创建子目录
+ */
+auto MkDirLocked(Dentry* parent_dentry, const char* dir_name)
+    -> Expected<void> {
+  // 检查目录是否已存在
+  auto existing = LookupComponentLocked(parent_dentry, dir_name);
+  if (existing.has_value()) {
+    PutDentry(existing.value());
+    return std::unexpected(Error(ErrorCode::kFsFileExists));
+  }
+  if (existing.error().code != ErrorCode::kFsFileNotFound) {
+    return std::unexpected(existing.error());
+  }
+
+  // 创建目录
+  Inode* dir = parent_dentry->inode;
+  if (dir->ops == nullptr) {
+    return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
+  }
+
+  auto result = dir->ops->Mkdir(dir, dir_name);
+  if (!result.has_value()) {
+    return std::unexpected(result.error());
+  }
+
+  // 创建 dentry
+  LockGuard<SpinLock> guard(GetVfsState().dcache.lock);
+  size_t len = strlen(dir_name);
+  auto add_result = AddChild(parent_dentry, dir_name, len,
+                             HashName(dir_name, len), result.value());
+  if (!add_result.has_value()) {
+    return std::unexpected(add_result.error());
+  }
+  return {};
+}
+
+}  // namespace
+
 auto MkDir(const char* path) -> Expected<void> {
   if (path == nullptr) {
     return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
 
-  LockGuard<SpinLock> guard(GetVfsState().vfs_lock_);
   // 解析父目录路径和目录名
   char parent_path[512];
   char dir_name[256];
-  const char* last_slash = strrchr(path, '/');
-  if (last_slash == nullptr || last_slash == path) {
-    strncpy(parent_path, "/", sizeof(parent_path));
-    strncpy(dir_name, path[0] == '/' ? path + 1 : path, sizeof(dir_name));
-  } else {
-    size_t parent_len = last_slash - path;
-    if (parent_len >= sizeof(parent_path)) {
-      parent_len = sizeof(parent_path) - 1;
-    }
-    strncpy(parent_path, path, parent_len);
-    parent_path[parent_len] = '\0';
-    strncpy(dir_name, last_slash + 1, sizeof(dir_name));
-  }
-  dir_name[sizeof(dir_name) - 1] = '\0';
+  SplitPath(path, parent_path, dir_name);
 
   // 查找父目录
   auto parent_result = Lookup(parent_path);
@@ -44,35 +70,20 @@ auto MkDir(const char* path) -> Expected<void> {
   Dentry* parent_dentry = parent_result.value();
   if (parent_dentry->inode == nullptr ||
       parent_dentry->inode->type != FileType::kDirectory) {
+    PutDentry(parent_dentry);
     return std::unexpected(Error(ErrorCode::kFsNotADirectory));
   }
 
-  // 检查目录是否已存在
-  if (FindChild(parent_dentry, dir_name) != nullptr) {
-    return std::unexpected(Error(ErrorCode::kFsFileExists));
+  Expected<void> result;
+  {
+    WriteLockGuard dir_guard(parent_dentry->inode->lock);
+    result = MkDirLocked(parent_dentry, dir_name);
   }
-
-  // 创建目录
-  if (parent_dentry->inode->ops == nullptr) {
-    return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
-  }
-
-  auto result =
-      parent_dentry->inode->ops->Mkdir(parent_dentry->inode, dir_name);
+  PutDentry(parent_dentry);
   if (!result.has_value()) {
-    return std::unexpected(result.error());
+    return result;
   }
 
-  // 创建 dentry
-  auto new_dentry = kstd::make_unique<Dentry>();
-  if (!new_dentry) {
-    return std::unexpected(Error(ErrorCode::kOutOfMemory));
-  }
-
-  strncpy(new_dentry->name, dir_name, sizeof(new_dentry->name) - 1);
-  new_dentry->inode = result.value();
-  AddChild(parent_dentry, new_dentry.release());
-
   klog::Debug("VFS: created directory '{}'", path);
   return {};
 }
@@ -4,6 +4,9 @@
 
 #include "mount.hpp"
 
+#include <bit>
+#include <cstdint>
+
 #include "kernel_log.hpp"
 #include "kstd_cstring"
 #include "kstd_memory"
@@ -13,94 +16,145 @@
 
 namespace vfs {
 
+MountTable::~MountTable() {
+  Snapshot* snapshot = current_.load(std::memory_order_relaxed);
+  if (snapshot != nullptr) {
+    for (size_t i = 0; i < snapshot->count; ++i) {
+      delete snapshot->mounts[i];
+    }
+    delete snapshot;
+  }
+  while (retired_ != nullptr) {
+    Snapshot* next = retired_->retired_next;
+    delete retired_->dropped;
+    delete retired_;
+    retired_ = next;
+  }
+}
+
 auto MountTable::Mount(const char* path, FileSystem* fs, BlockDevice* device)
     -> Expected<void> {
   if (path == nullptr || fs == nullptr) {
     return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
 
-  LockGuard<SpinLock> guard(GetVfsState().vfs_lock_);
-  // 检查挂载点数量
-  if (mount_count_ >= kMaxMounts) {
-    return std::unexpected(Error(ErrorCode::kFsMountFailed));
-  }
-
   // 规范化路径（确保以 / 开头）
   if (path[0] != '/') {
     return std::unexpected(Error(ErrorCode::kFsInvalidPath));
   }
 
-  // 检查路径是否已被挂载
-  for (size_t i = 0; i < mount_count_; ++i) {
-    if (mounts_[i].active && strcmp(mounts_[i].mount_path, path) == 0) {
+  {
+    LockGuard<SpinLock> guard(GetVfsState().vfs_lock_);
+    // 检查挂载点数量
+    Snapshot* snapshot = current_.load(std::memory_order_relaxed);
+    if (snapshot != nullptr && snapshot->count >= kMaxMounts) {
+      return std::unexpected(Error(ErrorCode::kFsMountFailed));
+    }
+
+    // 检查路径是否已被挂载
+    if (FindActive(path) != nullptr) {
       return std::unexpected(Error(ErrorCode::kFsAlreadyMounted));
     }
   }
 
-  // 挂载文件系统
+  // 查找挂载点 dentry（非根挂载），挂载期间持有其引用使其不被回收
+  Dentry* mount_dentry = nullptr;
+  if (strcmp(path, "/") != 0) {
+    auto lookup_result = vfs::Lookup(path);
+    if (!lookup_result.has_value()) {
+      return std::unexpected(lookup_result.error());
+    }
+    mount_dentry = lookup_result.value();
+    if (mount_dentry->inode == nullptr ||
+        mount_dentry->inode->type != FileType::kDirectory) {
+      PutDentry(mount_dentry);
+      return std::unexpected(Error(ErrorCode::kFsNotADirectory));
+    }
+  }
+
+  // 挂载文件系统（可能访问块设备，不持有自旋锁）
   auto mount_result = fs->Mount(device);
   if (!mount_result.has_value()) {
     klog::Err("MountTable: failed to mount filesystem '{}': {}", fs->GetName(),
               mount_result.error().message());
+    PutDentry(mount_dentry);
     return std::unexpected(Error(ErrorCode::kFsMountFailed));
   }
 
   Inode* root_inode = mount_result.value();
   if (root_inode == nullptr || root_inode->type != FileType::kDirectory) {
+    PutDentry(mount_dentry);
     return std::unexpected(Error(ErrorCode::kFsCorrupted));
   }
 
-  // 为根 inode 创建 dentry
+  // 为根 inode 创建 dentry，并预先分配挂载点与新快照
   auto root_dentry_ptr = kstd::make_unique<Dentry>();
-  if (!root_dentry_ptr) {
-    fs->Unmount();
+  auto mount_point = kstd::make_unique<MountPoint>();
+  auto snapshot = kstd::make_unique<Snapshot>();
+  if (!root_dentry_ptr || !mount_point || !snapshot) {
+    (void)fs->Unmount();
+    PutDentry(mount_dentry);
     return std::unexpected(Error(ErrorCode::kOutOfMemory));
   }
 
   root_dentry_ptr->inode = root_inode;
-  strncpy(root_dentry_ptr->name, "/", sizeof(root_dentry_ptr->name));
-
-  // 查找挂载点 dentry（如果是非根挂载）
-  Dentry* mount_dentry = nullptr;
-  if (strcmp(path, "/") != 0) {
-    // 需要找到父文件系统中对应的 dentry
-    // 这里简化处理，实际应该通过 VFS Lookup 找到
-    // 暂时设置为 nullptr，表示根挂载
-  }
+  (void)SetDentryName(root_dentry_ptr.get(), "/", 1);
+
+  mount_point->mount_path = path;
+  mount_point->mount_dentry = mount_dentry;
+  mount_point->filesystem = fs;
+  mount_point->device = device;
+  mount_point->root_inode = root_inode;
+  mount_point->root_dentry = root_dentry_ptr.get();
+  mount_point->active = true;
+
+  bool published = false;
+  {
+    LockGuard<SpinLock> guard(GetVfsState().vfs_lock_);
+    Snapshot* old = current_.load(std::memory_order_relaxed);
+    // 挂载期间其它任务可能已挂载到同一路径或同一 dentry
+    if (FindActive(path) == nullptr &&
+        (old == nullptr || old->count < kMaxMounts) &&
+        (mount_dentry == nullptr ||
+         !mount_dentry->mounted.load(std::memory_order_relaxed))) {
+      if (old != nullptr) {
+        snapshot->mounts = old->mounts;
+        snapshot->count = old->count;
+      }
+      snapshot->mounts[snapshot->count++] = mount_point.get();
+      BuildSnapshot(snapshot.get());
+
+      // 修改序号使并发的无锁路径解析重试
+      auto& cache = GetVfsState().dcache;
+      {
+        LockGuard<SpinLock> cache_guard(cache.lock);
+        cache.seq.WriteBegin();
+        if (mount_dentry != nullptr) {
+          mount_dentry->mounted.store(true, std::memory_order_release);
+        }
+        Publish(snapshot.release(), nullptr);
 
-  // 找到空闲挂载点槽位
-  size_t slot = 0;
-  for (; slot < kMaxMounts; ++slot) {
-    if (!mounts_[slot].active) {
-      break;
+        // 如果是根挂载，更新 VFS 根 dentry
+        if (mount_dentry == nullptr) {
+          extern void SetRootDentry(Dentry*);
+          SetRootDentry(mount_point->root_dentry);
+        }
+        cache.seq.WriteEnd();
+      }
+      root_dentry_ptr.release();
+      mount_point.release();
+      ReclaimRetired();
+      published = true;
     }
   }
 
-  if (slot >= kMaxMounts) {
-    // root_dentry_ptr 自动释放（RAII）
-    fs->Unmount();
+  if (!published) {
+    // root_dentry_ptr 等自动释放（RAII）
+    (void)fs->Unmount();
+    PutDentry(mount_dentry);
     return std::unexpected(Error(ErrorCode::kFsMountFailed));
   }
 
-  // 填充挂载点信息
-  mounts_[slot].mount_path = path;
-  mounts_[slot].mount_dentry = mount_dentry;
-  mounts_[slot].filesystem = fs;
-  mounts_[slot].device = device;
-  mounts_[slot].root_inode = root_inode;
-  mounts_[slot].root_dentry = root_dentry_ptr.release();
-  mounts_[slot].active = true;
-
-  ++mount_count_;
-
-  // 如果是根挂载，设置 root_mount_
-  if (strcmp(path, "/") == 0) {
-    root_mount_ = &mounts_[slot];
-    // 更新 VFS 根 dentry
-    extern void SetRootDentry(Dentry*);
-    SetRootDentry(mounts_[slot].root_dentry);
-  }
-
   klog::Info("MountTable: mounted '{}' on '{}'", fs->GetName(), path);
   return {};
 }
@@ -110,45 +164,72 @@ auto MountTable::Unmount(const char* path) -> Expected<void> {
     return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
 
-  // 查找挂载点
-  MountPoint* mp = nullptr;
-  size_t mp_index = 0;
-  for (size_t i = 0; i < kMaxMounts; ++i) {
-    if (mounts_[i].active && strcmp(mounts_[i].mount_path, path) == 0) {
-      mp = &mounts_[i];
-      mp_index = i;
-      break;
-    }
+  auto snapshot = kstd::make_unique<Snapshot>();
+  if (!snapshot) {
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
   }
 
-  if (mp == nullptr) {
-    return std::unexpected(Error(ErrorCode::kFsNotMounted));
-  }
+  FileSystem* fs = nullptr;
+  Dentry* mount_dentry = nullptr;
+  {
+    LockGuard<SpinLock> guard(GetVfsState().vfs_lock_);
+    {
+      auto& cache = GetVfsState().dcache;
+      LockGuard<SpinLock> cache_guard(cache.lock);
+      // 查找挂载点
+      MountPoint* mp = FindActive(path);
+      if (mp == nullptr) {
+        return std::unexpected(Error(ErrorCode::kFsNotMounted));
+      }
 
-  // 卸载文件系统
-  auto result = mp->filesystem->Unmount();
-  if (!result.has_value()) {
-    return std::unexpected(result.error());
-  }
+      // 仍有打开的文件、进行中的路径解析或挂载在其中的文件系统时不能卸载
+      if (IsDentryTreeBusy(mp->root_dentry)) {
+        return std::unexpected(Error(ErrorCode::kFsUnmountFailed));
+      }
 
-  // 清理挂载点（RAII）
-  etl::unique_ptr<Dentry> root_guard(mp->root_dentry);
+      // 新快照不含该挂载点
+      Snapshot* old = current_.load(std::memory_order_relaxed);
+      for (size_t i = 0; i < old->count; ++i) {
+        if (old->mounts[i] != mp) {
+          snapshot->mounts[snapshot->count++] = old->mounts[i];
+        }
+      }
+      BuildSnapshot(snapshot.get());
+
+      // 先从挂载表中移除，再释放该文件系统在 dcache 中的所有 dentry；
+      // 挂载点本身在读者退出后随旧快照释放
+      fs = mp->filesystem;
+      mount_dentry = mp->mount_dentry;
+      cache.seq.WriteBegin();
+      if (mount_dentry != nullptr) {
+        mount_dentry->mounted.store(false, std::memory_order_relaxed);
+      }
+      Publish(snapshot.release(), mp);
+
+      // 如果是根挂载，清除 VFS 根 dentry
+      if (mount_dentry == nullptr) {
+        extern void SetRootDentry(Dentry*);
+        SetRootDentry(nullptr);
+      }
+      cache.seq.WriteEnd();
+
+      DestroyDentryTree(mp->root_dentry);
+    }
+    ReclaimRetired();
+  }
 
-  mp->active = false;
-  mp->mount_path = nullptr;
-  mp->mount_dentry = nullptr;
-  mp->filesystem = nullptr;
-  mp->device = nullptr;
-  mp->root_inode = nullptr;
-  mp->root_dentry = nullptr;
+  // 释放挂载点 dentry 的引用
+  PutDentry(mount_dentry);
 
-  --mount_count_;
+  // 丢弃该文件系统的缓存页，之后其 inode 不再有效
+  InvalidateFsPageCache(fs);
 
-  // 如果是根挂载，清除 root_mount_
-  if (root_mount_ == &mounts_[mp_index]) {
-    root_mount_ = nullptr;
-    extern void SetRootDentry(Dentry*);
-    SetRootDentry(nullptr);
+  // 卸载文件系统（可能回写块设备，不持有自旋锁）
+  auto result = fs->Unmount();
+  if (!result.has_value()) {
+    klog::Err("MountTable: failed to unmount '{}': {}", path,
+              result.error().message());
+    return std::unexpected(result.error());
   }
 
   klog::Info("MountTable: unmounted '{}'", path);
@@ -160,19 +241,17 @@ auto MountTable::Lookup(const char* path) -> MountPoint* {
     return nullptr;
   }
 
+  Snapshot* snapshot = current_.load(std::memory_order_acquire);
+  if (snapshot == nullptr) {
+    return nullptr;
+  }
+
   MountPoint* best_match = nullptr;
   size_t best_match_len = 0;
 
-  for (size_t i = 0; i < kMaxMounts; ++i) {
-    if (!mounts_[i].active) {
-      continue;
-    }
-
-    const char* mp_path = mounts_[i].mount_path;
-    if (mp_path == nullptr) {
-      continue;
-    }
-
+  for (size_t i = 0; i < snapshot->count; ++i) {
+    MountPoint* mount = snapshot->mounts[i];
+    const char* mp_path = mount->mount_path;
     size_t mp_len = strlen(mp_path);
 
     // 检查路径是否以挂载路径开头
@@ -183,7 +262,7 @@ auto MountTable::Lookup(const char* path) -> MountPoint* {
           (mp_len == 1 && mp_path[0] == '/')) {
         // 选择最长的匹配
         if (mp_len > best_match_len) {
-          best_match = &mounts_[i];
+          best_match = mount;
           best_match_len = mp_len;
         }
       }
@@ -193,6 +272,41 @@ auto MountTable::Lookup(const char* path) -> MountPoint* {
   return best_match;
 }
 
+auto MountTable::LookupMounted(const Dentry* dentry) const -> MountPoint* {
+  Snapshot* snapshot = current_.load(std::memory_order_acquire);
+  if (snapshot == nullptr || dentry == nullptr) {
+    return nullptr;
+  }
+
+  // 线性探测，遇到空槽位说明不存在
+  size_t slot = HashDentry(dentry);
+  for (size_t i = 0; i < kHashSize; ++i) {
+    MountPoint* mount = snapshot->by_dentry[slot];
+    if (mount == nullptr) {
+      return nullptr;
+    }
+    if (mount->mount_dentry == dentry) {
+      return mount;
+    }
+    slot = (slot + 1) & (kHashSize - 1);
+  }
+  return nullptr;
+}
+
+auto MountTable::LookupRoot(const Dentry* root) const -> MountPoint* {
+  Snapshot* snapshot = current_.load(std::memory_order_acquire);
+  if (snapshot == nullptr || root == nullptr) {
+    return nullptr;
+  }
+
+  for (size_t i = 0; i < snapshot->count; ++i) {
+    if (snapshot->mounts[i]->root_dentry == root) {
+      return snapshot->mounts[i];
+    }
+  }
+  return nullptr;
+}
+
 auto MountTable::GetRootDentry(MountPoint* mp) -> Dentry* {
   if (mp == nullptr || !mp->active) {
     return nullptr;
@@ -204,18 +318,76 @@ auto MountTable::IsMountPoint(const char* path) -> bool {
   if (path == nullptr) {
     return false;
   }
+  return FindActive(path) != nullptr;
+}
+
+auto MountTable::FindActive(const char* path) -> MountPoint* {
+  Snapshot* snapshot = current_.load(std::memory_order_acquire);
+  if (snapshot == nullptr) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < snapshot->count; ++i) {
+    if (strcmp(snapshot->mounts[i]->mount_path, path) == 0) {
+      return snapshot->mounts[i];
+    }
+  }
+  return nullptr;
+}
 
-  for (size_t i = 0; i < kMaxMounts; ++i) {
-    if (mounts_[i].active && mounts_[i].mount_path != nullptr &&
-        strcmp(mounts_[i].mount_path, path) == 0) {
-      return true;
+auto MountTable::GetRootMount() -> MountPoint* {
+  Snapshot* snapshot = current_.load(std::memory_order_acquire);
+  return (snapshot != nullptr) ? snapshot->root : nullptr;
+}
+
+auto MountTable::HashDentry(const Dentry* dentry) -> size_t {
+  // Fibonacci 散列，取乘积的高位
+  auto key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(dentry));
+  return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >>
+                             (64 - std::countr_zero(kHashSize)));
+}
+
+auto MountTable::BuildSnapshot(Snapshot* snapshot) -> void {
+  snapshot->by_dentry.fill(nullptr);
+  snapshot->root = nullptr;
+  for (size_t i = 0; i < snapshot->count; ++i) {
+    MountPoint* mount = snapshot->mounts[i];
+    if (mount->mount_dentry == nullptr) {
+      snapshot->root = mount;
+      continue;
+    }
+    size_t slot = HashDentry(mount->mount_dentry);
+    while (snapshot->by_dentry[slot] != nullptr) {
+      slot = (slot + 1) & (kHashSize - 1);
     }
+    snapshot->by_dentry[slot] = mount;
   }
+}
 
-  return false;
+auto MountTable::Publish(Snapshot* snapshot, MountPoint* dropped) -> void {
+  // 与无锁路径解析登记读者的顺序一致，ReclaimRetired 看到没有读者时，
+  // 之后开始的读者只能读到新快照
+  Snapshot* old = current_.exchange(snapshot, std::memory_order_seq_cst);
+  if (old == nullptr) {
+    delete dropped;
+    return;
+  }
+  old->dropped = dropped;
+  old->retired_next = retired_;
+  retired_ = old;
 }
 
-auto MountTable::GetRootMount() -> MountPoint* { return root_mount_; }
+auto MountTable::ReclaimRetired() -> void {
+  // 有读者时留到下一次挂载或卸载再释放
+  if (GetVfsState().dcache.walkers.load(std::memory_order_seq_cst) != 0) {
+    return;
+  }
+  while (retired_ != nullptr) {
+    Snapshot* next = retired_->retired_next;
+    delete retired_->dropped;
+    delete retired_;
+    retired_ = next;
+  }
+}
 
 auto GetMountTable() -> MountTable& {
   static MountTable instance;
@@ -11,6 +11,51 @@
 
 namespace vfs {
 
+namespace {
+
+/**
+ * @brief 在父目录中创建普通文件
+ * @param parent_dentry 持有引用的父目录 dentry
+ * @param file_name 文件名
+ * @return Expected<Dentry*> 持有引用的 dentry，文件已存在时返回已有的 dentry
+ */
+auto CreateFile(Dentry* parent_dentry, const char* file_name)
+    -> Expected<Dentry*> {
+  Inode* dir = parent_dentry->inode;
+  if (dir == nullptr || dir->type != FileType::kDirectory) {
+    return std::unexpected(Error(ErrorCode::kFsNotADirectory));
+  }
+  if (dir->ops == nullptr) {
+    return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
+  }
+
+  // 持有父目录的写锁，其它任务可能已在等锁期间创建了同名文件
+  WriteLockGuard dir_guard(dir->lock);
+  auto existing = LookupComponentLocked(parent_dentry, file_name);
+  if (existing.has_value() ||
+      existing.error().code != ErrorCode::kFsFileNotFound) {
+    return existing;
+  }
+
+  auto create_result = dir->ops->Create(dir, file_name, FileType::kRegular);
+  if (!create_result.has_value()) {
+    return std::unexpected(create_result.error());
+  }
+
+  // 创建 dentry（实例化查找失败时留下的负 dentry）
+  LockGuard<SpinLock> guard(GetVfsState().dcache.lock);
+  size_t len = strlen(file_name);
+  auto add_result = AddChild(parent_dentry, file_name, len,
+                             HashName(file_name, len), create_result.value());
+  if (!add_result.has_value()) {
+    return std::unexpected(add_result.error());
+  }
+  GetDentry(add_result.value());
+  return add_result.value();
+}
+
+}  // namespace
+
 auto Open(const char* path, OpenFlags flags) -> Expected<File*> {
   if (!GetVfsState().initialized) {
     return std::unexpected(Error(ErrorCode::kFsNotMounted));
@@ -20,7 +65,6 @@ auto Open(const char* path, OpenFlags flags) -> Expected<File*> {
     return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
 
-  LockGuard<SpinLock> guard(GetVfsState().vfs_lock_);
   // 查找或创建 dentry
   auto lookup_result = Lookup(path);
   Dentry* dentry = nullptr;
@@ -31,24 +75,10 @@ auto Open(const char* path, OpenFlags flags) -> Expected<File*> {
       return std::unexpected(lookup_result.error());
     }
 
-    // 创建新文件
     // 找到父目录路径
     char parent_path[512];
     char file_name[256];
-    const char* last_slash = strrchr(path, '/');
-    if (last_slash == nullptr || last_slash == path) {
-      strncpy(parent_path, "/", sizeof(parent_path));
-      strncpy(file_name, path[0] == '/' ? path + 1 : path, sizeof(file_name));
-    } else {
-      size_t parent_len = last_slash - path;
-      if (parent_len >= sizeof(parent_path)) {
-        parent_len = sizeof(parent_path) - 1;
-      }
-      strncpy(parent_path, path, parent_len);
-      parent_path[parent_len] = '\0';
-      strncpy(file_name, last_slash + 1, sizeof(file_name));
-    }
-    file_name[sizeof(file_name) - 1] = '\0';
+    SplitPath(path, parent_path, file_name);
 
     // 查找父目录
     auto parent_result = Lookup(parent_path);
@@ -57,54 +87,37 @@ auto Open(const char* path, OpenFlags flags) -> Expected<File*> {
     }
 
     Dentry* parent_dentry = parent_result.value();
-    if (parent_dentry->inode == nullptr ||
-        parent_dentry->inode->type != FileType::kDirectory) {
-      return std::unexpected(Error(ErrorCode::kFsNotADirectory));
-    }
-
-    // 创建文件
-    if (parent_dentry->inode->ops == nullptr) {
-      return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
-    }
-
-    auto create_result = parent_dentry->inode->ops->Create(
-        parent_dentry->inode, file_name, FileType::kRegular);
+    auto create_result = CreateFile(parent_dentry, file_name);
+    PutDentry(parent_dentry);
     if (!create_result.has_value()) {
       return std::unexpected(create_result.error());
     }
-
-    // 创建 dentry
-    auto new_dentry = kstd::make_unique<Dentry>();
-    if (!new_dentry) {
-      return std::unexpected(Error(ErrorCode::kOutOfMemory));
-    }
-
-    strncpy(new_dentry->name, file_name, sizeof(new_dentry->name) - 1);
-    new_dentry->name[sizeof(new_dentry->name) - 1] = '\0';
-    new_dentry->inode = create_result.value();
-    dentry = new_dentry.get();
-    AddChild(parent_dentry, new_dentry.release());
+    dentry = create_result.value();
   } else {
     dentry = lookup_result.value();
   }
 
   if (dentry == nullptr || dentry->inode == nullptr) {
+    PutDentry(dentry);
     return std::unexpected(Error(ErrorCode::kFsCorrupted));
   }
 
   // 检查打开模式
   if ((flags & OpenFlags::kODirectory) != 0U &&
       dentry->inode->type != FileType::kDirectory) {
+    PutDentry(dentry);
     return std::unexpected(Error(ErrorCode::kFsNotADirectory));
   }
 
   // 创建 File 对象
   auto new_file = kstd::make_unique<File>();
   if (!new_file) {
+    PutDentry(dentry);
     return std::unexpected(Error(ErrorCode::kOutOfMemory));
   }
-  File* file = new_file.release();
+  File* file = new_file.get();
 
+  // File 接管路径解析得到的 dentry 引用
   file->inode = dentry->inode;
   file->dentry = dentry;
   file->offset = 0;
@@ -115,16 +128,25 @@ auto Open(const char* path, OpenFlags flags) -> Expected<File*> {
     file->ops = file->inode->fs->GetFileOps();
   }
 
+  if (file->ops != nullptr) {
+    auto open_result = file->ops->Open(file);
+    if (!open_result.has_value()) {
+      PutDentry(dentry);
+      return std::unexpected(open_result.error());
+    }
+  }
+
   // 处理 O_TRUNC
   if ((flags & OpenFlags::kOTruncate) != 0U &&
       dentry->inode->type == FileType::kRegular) {
     // 截断文件，由具体文件系统处理
-    // 这里不直接操作，而是通过后续的 write 来处理
+    // 这里不直接操作，而是通过后续的 write 来处理；缓存的旧内容失效
+    InvalidatePageCache(dentry->inode);
   }
 
   klog::Debug("VFS: opened '{}', flags={:#x}", path,
               static_cast<uint32_t>(flags));
-  return file;
+  return new_file.release();
 }
 
 }  // namespace vfs
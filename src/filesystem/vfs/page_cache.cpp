@@ -0,0 +1,714 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "block_device.hpp"
+#include "filesystem.hpp"
+#include "kernel_log.hpp"
+#include "kstd_cstring"
+#include "kstd_memory"
+#include "sk_stdlib.h"
+#include "spinlock.hpp"
+#include "vfs_internal.hpp"
+
+namespace vfs {
+
+/**
+ * @brief 一页的异步读入
+ * @details 预读为每个未缓存的页提交一个块请求，相邻页的请求由块队列合并
+ *          为一次设备请求。页以加锁状态（CachedPage::io 非空）挂入缓存，
+ *          请求完成时解锁；读到加锁页的读者持有引用并等待 done
+ */
+struct PageIo {
+  BlockRequest request;
+  /// 读入的页
+  CachedPage* page{nullptr};
+  /// 请求提交到的块设备，等待者经由它轮询
+  BlockDevice* device{nullptr};
+  /// 页中文件数据的字节数
+  size_t valid{0};
+  /// 页在读入完成前被移出缓存，完成时释放
+  bool removed{false};
+  /// 请求本身与等待的读者各持一个引用，受页缓存锁保护
+  uint32_t refs{1};
+  /// 读入完成
+  Completion done{"page_io"};
+};
+
+namespace {
+
+constexpr size_t kPageSize = PageCache::kPageSize;
+
+/// inode 地址与页号的混合因子（黄金分割）
+constexpr uint64_t kKeyMix = 0x9E3779B97F4A7C15ULL;
+/// 取混合结果的高位作为桶号
+constexpr int kBucketShift = 64 - std::countr_zero(PageCache::kBucketCount);
+/// 表示不设置预读标记
+constexpr uint64_t kNoPage = UINT64_MAX;
+
+auto GetBucket(const Inode* inode, uint64_t index) -> CachedPage*& {
+  auto key = (reinterpret_cast<uintptr_t>(inode) >> 4) + index;
+  return GetVfsState().page_cache.buckets[(key * kKeyMix) >> kBucketShift];
+}
+
+auto FindPage(const Inode* inode, uint64_t index) -> CachedPage* {
+  for (CachedPage* page = GetBucket(inode, index); page != nullptr;
+       page = page->hash_next) {
+    if (page->inode == inode && page->index == index) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto LruRemove(CachedPage* page) -> void {
+  auto& cache = GetVfsState().page_cache;
+  if (page->lru_prev != nullptr) {
+    page->lru_prev->lru_next = page->lru_next;
+  } else {
+    cache.lru_head = page->lru_next;
+  }
+  if (page->lru_next != nullptr) {
+    page->lru_next->lru_prev = page->lru_prev;
+  } else {
+    cache.lru_tail = page->lru_prev;
+  }
+  page->lru_prev = nullptr;
+  page->lru_next = nullptr;
+}
+
+auto LruAppend(CachedPage* page) -> void {
+  auto& cache = GetVfsState().page_cache;
+  page->lru_prev = cache.lru_tail;
+  page->lru_next = nullptr;
+  if (cache.lru_tail != nullptr) {
+    cache.lru_tail->lru_next = page;
+  } else {
+    cache.lru_head = page;
+  }
+  cache.lru_tail = page;
+}
+
+auto FreePage(CachedPage* page) -> void {
+  aligned_free(page->data);
+  delete page;
+}
+
+/**
+ * @brief 将页从哈希表与 LRU 链表中移除并释放
+ * @pre 持有页缓存锁
+ */
+auto RemovePage(CachedPage* page) -> void {
+  auto& cache = GetVfsState().page_cache;
+  CachedPage** link = &GetBucket(page->inode, page->index);
+  while (*link != page) {
+    link = &(*link)->hash_next;
+  }
+  *link = page->hash_next;
+  LruRemove(page);
+  --cache.count;
+  if (page->io != nullptr) {
+    // 设备仍在写入页数据，由 EndPageIo 释放
+    page->io->removed = true;
+    return;
+  }
+  FreePage(page);
+}
+
+/**
+ * @brief 按 LRU 顺序回收页，跳过正在读入的页
+ * @pre 持有页缓存锁
+ */
+auto ShrinkLocked(size_t count) -> size_t {
+  auto& cache = GetVfsState().page_cache;
+  size_t freed = 0;
+  CachedPage* page = cache.lru_head;
+  while (freed < count && page != nullptr) {
+    CachedPage* next = page->lru_next;
+    if (page->io == nullptr) {
+      RemovePage(page);
+      ++freed;
+    }
+    page = next;
+  }
+  cache.evictions += freed;
+  return freed;
+}
+
+/**
+ * @brief 分配一个未挂入缓存的页，内存不足时先回收缓存再重试
+ * @return CachedPage* 新页，仍然失败时返回 nullptr
+ */
+auto AllocatePage() -> CachedPage* {
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    auto page = kstd::make_unique<CachedPage>();
+    void* data = page ? aligned_alloc(kPageSize, kPageSize) : nullptr;
+    if (data != nullptr) {
+      page->data = static_cast<uint8_t*>(data);
+      return page.release();
+    }
+    auto& cache = GetVfsState().page_cache;
+    LockGuard<SpinLock> guard(cache.lock);
+    if (ShrinkLocked(PageCache::kShrinkBatch) == 0) {
+      break;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * @brief 将已填充的页挂入缓存，替换同一页的旧副本
+ * @pre 持有页缓存锁
+ */
+auto InsertLocked(CachedPage* page) -> void {
+  auto& cache = GetVfsState().page_cache;
+  // 并发的读者可能已填充同一页，或旧副本是不完整的末尾页
+  CachedPage* stale = FindPage(page->inode, page->index);
+  if (stale != nullptr) {
+    RemovePage(stale);
+  }
+  if (cache.count >= PageCache::kMaxPages) {
+    (void)ShrinkLocked(PageCache::kShrinkBatch);
+  }
+  CachedPage*& bucket = GetBucket(page->inode, page->index);
+  page->hash_next = bucket;
+  bucket = page;
+  LruAppend(page);
+  ++cache.count;
+}
+
+/**
+ * @brief 以一次 ReadPage 读取连续的 @p count 页并挂入缓存
+ * @return Expected<size_t> 挂入的页数，少于 count 表示到达文件末尾或内存不足
+ */
+auto ReadRun(File* file, uint64_t index, size_t count) -> Expected<size_t> {
+  Inode* inode = file->inode;
+  uint64_t offset = index * kPageSize;
+  auto bytes = static_cast<size_t>(
+      std::min<uint64_t>(count * kPageSize, inode->size - offset));
+
+  // 多页经中转缓冲区读取，使文件系统能合并为一次多扇区请求
+  uint8_t* bounce = nullptr;
+  if (count > 1) {
+    bounce = static_cast<uint8_t*>(aligned_alloc(kPageSize, count * kPageSize));
+    if (bounce == nullptr) {
+      return ReadRun(file, index, 1);
+    }
+  }
+
+  CachedPage* first = nullptr;
+  if (bounce == nullptr) {
+    first = AllocatePage();
+    if (first == nullptr) {
+      return 0;
+    }
+  }
+
+  auto read_result =
+      file->ops->ReadPage(file, bounce != nullptr ? bounce : first->data,
+                          bytes, offset);
+  if (!read_result.has_value()) {
+    if (first != nullptr) {
+      FreePage(first);
+    }
+    aligned_free(bounce);
+    return std::unexpected(read_result.error());
+  }
+  size_t read_bytes = read_result.value();
+
+  auto& cache = GetVfsState().page_cache;
+  size_t inserted = 0;
+  for (size_t i = 0; i * kPageSize < read_bytes; ++i) {
+    CachedPage* page = first != nullptr ? first : AllocatePage();
+    first = nullptr;
+    if (page == nullptr) {
+      break;
+    }
+    size_t valid = std::min(kPageSize, read_bytes - i * kPageSize);
+    if (bounce != nullptr) {
+      memcpy(page->data, bounce + i * kPageSize, valid);
+    }
+    page->inode = inode;
+    page->index = index + i;
+    page->valid = valid;
+    LockGuard<SpinLock> guard(cache.lock);
+    InsertLocked(page);
+    ++inserted;
+  }
+  if (first != nullptr) {
+    FreePage(first);
+  }
+  aligned_free(bounce);
+  return inserted;
+}
+
+/**
+ * @brief 页读入请求的完成回调，可能在中断上下文中调用
+ * @details 成功时解锁页，失败时将页移出缓存，随后唤醒等待的读者
+ */
+auto EndPageIo(BlockRequest* request) -> void {
+  auto* io = static_cast<PageIo*>(request->private_data);
+  CachedPage* page = io->page;
+  auto& cache = GetVfsState().page_cache;
+  bool last = false;
+  {
+    LockGuard<SpinLock> guard(cache.lock);
+    page->io = nullptr;
+    if (io->removed) {
+      FreePage(page);
+    } else if (request->status != ErrorCode::kSuccess) {
+      RemovePage(page);
+    } else {
+      page->valid = io->valid;
+    }
+    last = --io->refs == 0;
+    // 在锁内唤醒：超时放弃等待的读者可能随后释放 io
+    if (!last) {
+      io->done.Complete();
+    }
+  }
+  // 有读者等待时由最后一个读者释放
+  if (last) {
+    delete io;
+  }
+}
+
+/**
+ * @brief 等待加锁页读入完成并放弃引用
+ * @param io 调用者在页缓存锁下取得了其引用
+ * @return ErrorCode 超过 PageCache::kIoTimeoutMs 未完成时返回 kTimeout，
+ *         请求仍持有自己的引用，完成时照常解锁页
+ */
+auto WaitPageIo(PageIo* io) -> ErrorCode {
+  auto status = WaitForIo(io->device, io->done, PageCache::kIoTimeoutMs);
+  auto& cache = GetVfsState().page_cache;
+  bool last = false;
+  {
+    LockGuard<SpinLock> guard(cache.lock);
+    last = --io->refs == 0;
+  }
+  if (last) {
+    delete io;
+  }
+  return status;
+}
+
+/**
+ * @brief 为连续的 @p count 页各提交一个读请求，不等待完成
+ * @details 页以加锁状态挂入缓存，由 EndPageIo 解锁。全部页映射完后在
+ *          Plug 期间一起提交，相邻的页由块队列合并为一次设备请求
+ * @return Expected<size_t> 挂入的页数，少于 count 表示数据不再连续或内存
+ *         不足；文件系统不能映射到块设备或设备不能异步读取时返回
+ *         kNotSupported
+ */
+auto SubmitRun(File* file, uint64_t index, size_t count) -> Expected<size_t> {
+  auto& cache = GetVfsState().page_cache;
+  Inode* inode = file->inode;
+  count = std::min<size_t>(count, PageCache::kMaxReadahead);
+  std::array<PageIo*, PageCache::kMaxReadahead> ios{};
+  size_t queued = 0;
+  BlockDevice* device = nullptr;
+  BlockExtent extent{};
+  uint64_t extent_offset = 0;
+
+  // 映射可能经文件系统同步读取元数据，在 Plug 之前完成
+  size_t handled = 0;
+  for (; handled < count; ++handled) {
+    uint64_t offset = (index + handled) * kPageSize;
+    auto valid = static_cast<size_t>(
+        std::min<uint64_t>(kPageSize, inode->size - offset));
+    if (offset + valid > extent_offset + extent.bytes) {
+      auto map_result = file->ops->MapExtent(
+          file, offset,
+          std::min<uint64_t>((count - handled) * kPageSize,
+                             inode->size - offset));
+      if (!map_result.has_value()) {
+        if (device == nullptr) {
+          return std::unexpected(map_result.error());
+        }
+        break;
+      }
+      extent = map_result.value();
+      extent_offset = offset;
+      // 页跨越两段不连续的数据（如簇小于页）时由调用者同步读取
+      if (extent.bytes < valid ||
+          (device != nullptr && extent.device != device)) {
+        if (device == nullptr) {
+          return std::unexpected(Error(ErrorCode::kNotSupported));
+        }
+        break;
+      }
+      device = extent.device;
+    }
+
+    CachedPage* page = AllocatePage();
+    auto io = kstd::make_unique<PageIo>();
+    if (page == nullptr || !io) {
+      if (page != nullptr) {
+        FreePage(page);
+      }
+      break;
+    }
+    const uint32_t sector_size = device->GetSectorSize();
+    io->request = BlockRequest{
+        .op = BlockOp::kRead,
+        .sector = extent.sector + (offset - extent_offset) / sector_size,
+        .sector_count =
+            static_cast<uint32_t>((valid + sector_size - 1) / sector_size),
+        .buffer = page->data,
+        .end_io = EndPageIo,
+        .private_data = io.get(),
+    };
+    io->page = page;
+    io->device = device;
+    io->valid = valid;
+    page->inode = inode;
+    page->index = index + handled;
+    page->io = io.get();
+    {
+      LockGuard<SpinLock> guard(cache.lock);
+      // 并发的读者已读入或正在读入该页
+      if (FindPage(inode, page->index) != nullptr) {
+        FreePage(page);
+        continue;
+      }
+      InsertLocked(page);
+    }
+    ios[queued++] = io.release();
+  }
+
+  size_t submitted = 0;
+  ErrorCode submit_status = ErrorCode::kSuccess;
+  if (queued > 0) {
+    BlockPlug plug(device);
+    for (; submitted < queued; ++submitted) {
+      auto submit_result = device->Submit(&ios[submitted]->request);
+      if (!submit_result.has_value()) {
+        submit_status = submit_result.error().code;
+        break;
+      }
+    }
+  }
+  // 未提交的请求不会完成，由 EndPageIo 代为结束并把页移出缓存
+  for (size_t i = submitted; i < queued; ++i) {
+    ios[i]->request.status = submit_status;
+    EndPageIo(&ios[i]->request);
+  }
+  if (submit_status != ErrorCode::kSuccess) {
+    if (submitted == 0) {
+      return std::unexpected(Error(submit_status));
+    }
+    return submitted;
+  }
+  return handled;
+}
+
+/**
+ * @brief 读入 [first, first + count) 中未缓存的页
+ * @param mark 读到该页时触发下一窗口的预读，kNoPage 表示不设置
+ * @return Expected<size_t> 读入的页数
+ */
+auto FillRange(File* file, uint64_t first, size_t count, uint64_t mark)
+    -> Expected<size_t> {
+  auto& cache = GetVfsState().page_cache;
+  Inode* inode = file->inode;
+  uint64_t end = std::min(first + count,
+                          (inode->size + kPageSize - 1) / kPageSize);
+
+  size_t filled = 0;
+  uint64_t index = first;
+  while (index < end) {
+    // 跳过已缓存的页，找出下一段连续的未缓存页
+    uint64_t run_end = 0;
+    {
+      LockGuard<SpinLock> guard(cache.lock);
+      while (index < end && FindPage(inode, index) != nullptr) {
+        ++index;
+      }
+      run_end = index;
+      while (run_end < end && FindPage(inode, run_end) == nullptr) {
+        ++run_end;
+      }
+    }
+    if (index == end) {
+      break;
+    }
+
+    // 能映射到块设备时异步读入，否则经 ReadPage 同步读入
+    auto run_result = SubmitRun(file, index, run_end - index);
+    if (!run_result.has_value() &&
+        run_result.error().code == ErrorCode::kNotSupported) {
+      run_result = ReadRun(file, index, run_end - index);
+    }
+    if (!run_result.has_value()) {
+      if (filled > 0) {
+        break;
+      }
+      return std::unexpected(run_result.error());
+    }
+    filled += run_result.value();
+    if (run_result.value() < run_end - index) {
+      break;
+    }
+    index = run_end;
+  }
+
+  if (mark != kNoPage) {
+    LockGuard<SpinLock> guard(cache.lock);
+    CachedPage* page = FindPage(inode, mark);
+    if (page != nullptr) {
+      page->readahead_mark = true;
+    }
+  }
+  return filled;
+}
+
+/**
+ * @brief 根据 File 的预读状态读入从 @p index 开始的页
+ * @param file 文件对象
+ * @param index 未命中的页号，或带预读标记的页号
+ * @param wanted 本次请求从 index 起还需要的页数
+ * @param async 是否由预读标记触发
+ * @return Expected<size_t> 读入的页数
+ */
+auto Readahead(File* file, uint64_t index, uint64_t wanted, bool async)
+    -> Expected<size_t> {
+  auto& ra = file->readahead;
+  auto grow = [](uint32_t size) {
+    return std::min(size * 2, PageCache::kMaxReadahead);
+  };
+
+  if (async) {
+    // 顺序流读到了异步部分，在调用者消费其余页之前读入下一窗口
+    if (ra.size != 0 && index >= ra.start && index < ra.start + ra.size) {
+      ra.start += ra.size;
+    } else {
+      ra.start = index + 1;
+    }
+    ra.size = ra.size == 0 ? PageCache::kMinReadahead : grow(ra.size);
+    ra.async_size = ra.size;
+  } else if (index == ra.prev_index + 1 || index == ra.prev_index) {
+    if (ra.size != 0 && index >= ra.start && index < ra.start + ra.size) {
+      // 窗口内的页在使用前被回收，缩小窗口以减轻内存压力
+      ra.size = std::max(ra.size / 2, PageCache::kMinReadahead);
+    } else if (ra.size == 0) {
+      ra.size = static_cast<uint32_t>(
+          std::clamp<uint64_t>(wanted * 2, PageCache::kMinReadahead,
+                               PageCache::kMaxReadahead));
+    } else {
+      ra.size = grow(ra.size);
+    }
+    ra.start = index;
+    ra.async_size = ra.size / 2;
+  } else {
+    // 随机读取：只读入请求的页并清空窗口
+    ra.size = 0;
+    ra.async_size = 0;
+    return FillRange(file, index,
+                     std::min<uint64_t>(wanted, PageCache::kMaxReadahead),
+                     kNoPage);
+  }
+
+  auto result = FillRange(file, ra.start, ra.size,
+                          ra.start + ra.size - ra.async_size);
+  if (result.has_value() && result.value() > 0) {
+    auto& cache = GetVfsState().page_cache;
+    LockGuard<SpinLock> guard(cache.lock);
+    cache.readahead += async ? result.value() : result.value() - 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+auto UsesPageCache(const Inode* inode) -> bool {
+  return inode != nullptr && inode->fs != nullptr &&
+         inode->fs->UsesPageCache();
+}
+
+auto PageCacheRead(File* file, void* buf, size_t count, uint64_t offset)
+    -> Expected<size_t> {
+  auto& cache = GetVfsState().page_cache;
+  Inode* inode = file->inode;
+  auto* out = static_cast<uint8_t*>(buf);
+  if (count == 0) {
+    return 0;
+  }
+  uint64_t last_index = (offset + count - 1) / kPageSize;
+
+  size_t done = 0;
+  bool filled = false;
+  while (done < count) {
+    uint64_t pos = offset + done;
+    if (pos >= inode->size) {
+      break;
+    }
+    uint64_t index = pos / kPageSize;
+    auto in_page = static_cast<size_t>(pos % kPageSize);
+    size_t chunk = static_cast<size_t>(std::min<uint64_t>(
+        {count - done, kPageSize - in_page, inode->size - pos}));
+
+    bool hit = false;
+    bool mark = false;
+    size_t copied = 0;
+    PageIo* io = nullptr;
+    {
+      LockGuard<SpinLock> guard(cache.lock);
+      CachedPage* page = FindPage(inode, index);
+      if (page != nullptr && page->io != nullptr) {
+        // 页正在读入，持有引用以便解锁后等待
+        io = page->io;
+        ++io->refs;
+      } else if (page != nullptr) {
+        hit = true;
+        copied = page->valid > in_page ? page->valid - in_page : 0;
+        copied = std::min(copied, chunk);
+        memcpy(out + done, page->data + in_page, copied);
+        LruRemove(page);
+        LruAppend(page);
+        mark = page->readahead_mark;
+        page->readahead_mark = false;
+        // 刚为本次未命中读入的页不计为命中
+        if (!filled) {
+          ++cache.hits;
+        }
+      } else if (!filled) {
+        ++cache.misses;
+      }
+    }
+
+    if (io != nullptr) {
+      auto wait_status = WaitPageIo(io);
+      if (wait_status != ErrorCode::kSuccess) {
+        if (done > 0) {
+          break;
+        }
+        return std::unexpected(Error(wait_status));
+      }
+      continue;
+    }
+
+    if (hit) {
+      done += copied;
+      file->readahead.prev_index = index;
+      filled = false;
+      if (mark) {
+        // 预读失败不影响本次读取
+        (void)Readahead(file, index, last_index - index, true);
+      }
+      if (copied < chunk) {
+        break;
+      }
+      continue;
+    }
+
+    if (!filled) {
+      auto fill_result =
+          Readahead(file, index, last_index - index + 1, false);
+      if (!fill_result.has_value()) {
+        if (done > 0) {
+          break;
+        }
+        return std::unexpected(fill_result.error());
+      }
+      filled = true;
+      if (fill_result.value() > 0) {
+        continue;
+      }
+    }
+
+    // 无法缓存（内存不足或读入后立即被回收）时直接读入调用者的缓冲区
+    auto read_result = file->ops->ReadPage(file, out + done, chunk, pos);
+    if (!read_result.has_value()) {
+      if (done > 0) {
+        break;
+      }
+      return std::unexpected(read_result.error());
+    }
+    done += read_result.value();
+    file->readahead.prev_index = index;
+    filled = false;
+    if (read_result.value() < chunk) {
+      break;
+    }
+  }
+  return done;
+}
+
+auto InvalidatePageCache(Inode* inode, uint64_t offset, uint64_t length)
+    -> void {
+  if (!UsesPageCache(inode) || length == 0) {
+    return;
+  }
+  auto& cache = GetVfsState().page_cache;
+  uint64_t first = offset / kPageSize;
+  uint64_t last = length > UINT64_MAX - offset
+                      ? UINT64_MAX / kPageSize
+                      : (offset + length - 1) / kPageSize;
+
+  LockGuard<SpinLock> guard(cache.lock);
+  if (cache.count == 0) {
+    return;
+  }
+  // 范围内的页数少于缓存页数时逐页查找，否则遍历 LRU 链表
+  if (last - first < cache.count) {
+    for (uint64_t index = first; index <= last; ++index) {
+      CachedPage* page = FindPage(inode, index);
+      if (page != nullptr) {
+        RemovePage(page);
+      }
+    }
+    return;
+  }
+  CachedPage* page = cache.lru_head;
+  while (page != nullptr) {
+    CachedPage* next = page->lru_next;
+    if (page->inode == inode && page->index >= first && page->index <= last) {
+      RemovePage(page);
+    }
+    page = next;
+  }
+}
+
+auto InvalidateFsPageCache(FileSystem* fs) -> void {
+  if (fs == nullptr || !fs->UsesPageCache()) {
+    return;
+  }
+  auto& cache = GetVfsState().page_cache;
+  LockGuard<SpinLock> guard(cache.lock);
+  CachedPage* page = cache.lru_head;
+  while (page != nullptr) {
+    CachedPage* next = page->lru_next;
+    if (page->inode->fs == fs) {
+      RemovePage(page);
+    }
+    page = next;
+  }
+}
+
+auto ShrinkPageCache(size_t count) -> size_t {
+  auto& cache = GetVfsState().page_cache;
+  LockGuard<SpinLock> guard(cache.lock);
+  size_t freed = ShrinkLocked(count);
+  klog::Debug("VFS: page cache shrunk by {}, {} cached", freed, cache.count);
+  return freed;
+}
+
+auto GetPageCacheStats() -> PageCacheStats {
+  auto& cache = GetVfsState().page_cache;
+  LockGuard<SpinLock> guard(cache.lock);
+  return PageCacheStats{
+      .pages = cache.count,
+      .hits = cache.hits,
+      .misses = cache.misses,
+      .evictions = cache.evictions,
+      .readahead = cache.readahead,
+  };
+}
+
+}  // namespace vfs
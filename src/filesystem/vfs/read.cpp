@@ -5,7 +5,6 @@
 #include "filesystem.hpp"
 #include "kernel_log.hpp"
 #include "kstd_cstring"
-#include "spinlock.hpp"
 #include "vfs_internal.hpp"
 
 namespace vfs {
@@ -15,12 +14,65 @@ auto Read(File* file, void* buf, size_t count) -> Expected<size_t> {
     return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
 
-  LockGuard<SpinLock> guard(GetVfsState().vfs_lock_);
   if (file->ops == nullptr) {
     return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
   }
 
-  return file->ops->Read(file, buf, count);
+  // 读同一文件的任务可以并行，只有共享 File 时才串行化偏移量
+  InodeLockGuard inode_guard(file->inode, false);
+  WriteLockGuard pos_guard(file->pos_lock);
+  if (!UsesPageCache(file->inode)) {
+    return file->ops->Read(file, buf, count);
+  }
+
+  uint64_t offset = file->offset;
+  auto result = PageCacheRead(file, buf, count, offset);
+  if (result.has_value() && result.value() > 0) {
+    // 命中时文件系统未参与，同步其维护的读写位置
+    auto seek_result = file->ops->Seek(
+        file, static_cast<int64_t>(offset + result.value()), SeekWhence::kSet);
+    if (!seek_result.has_value()) {
+      return std::unexpected(seek_result.error());
+    }
+  }
+  return result;
+}
+
+auto PRead(File* file, void* buf, size_t count, uint64_t offset)
+    -> Expected<size_t> {
+  if (file == nullptr || buf == nullptr) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  if (file->ops == nullptr) {
+    return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
+  }
+
+  InodeLockGuard inode_guard(file->inode, false);
+  if (!UsesPageCache(file->inode)) {
+    return file->ops->PRead(file, buf, count, offset);
+  }
+
+  // 未命中时 ReadPage 借用共享的偏移量
+  WriteLockGuard pos_guard(file->pos_lock);
+  return PageCacheRead(file, buf, count, offset);
+}
+
+auto MapExtent(File* file, uint64_t offset, uint64_t count)
+    -> Expected<BlockExtent> {
+  if (file == nullptr || count == 0) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  if (file->ops == nullptr) {
+    return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
+  }
+
+  InodeLockGuard inode_guard(file->inode, false);
+  if (offset >= file->inode->size) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+  return file->ops->MapExtent(file, offset, count);
 }
 
 }  // namespace vfs
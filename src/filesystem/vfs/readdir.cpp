@@ -5,7 +5,6 @@
 #include "filesystem.hpp"
 #include "kernel_log.hpp"
 #include "kstd_cstring"
-#include "spinlock.hpp"
 #include "vfs_internal.hpp"
 
 namespace vfs {
@@ -15,7 +14,6 @@ auto ReadDir(File* file, DirEntry* dirent, size_t count) -> Expected<size_t> {
     return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
 
-  LockGuard<SpinLock> guard(GetVfsState().vfs_lock_);
   if (file->inode == nullptr || file->inode->type != FileType::kDirectory) {
     return std::unexpected(Error(ErrorCode::kFsNotADirectory));
   }
@@ -24,6 +22,8 @@ auto ReadDir(File* file, DirEntry* dirent, size_t count) -> Expected<size_t> {
     return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
   }
 
+  InodeLockGuard inode_guard(file->inode, false);
+  WriteLockGuard pos_guard(file->pos_lock);
   return file->ops->ReadDir(file, dirent, count);
 }
 }  // namespace vfs
@@ -2,8 +2,6 @@
  * @copyright Copyright The SimpleKernel Contributors
  */
 
-#include <etl/memory.h>
-
 #include "filesystem.hpp"
 #include "kernel_log.hpp"
 #include "kstd_cstring"
@@ -12,29 +10,82 @@
 
 namespace vfs {
 
+namespace {
+
+/**
+ * @brief 检查目录是否为空（负 dentry 不算）
+ */
+auto HasPositiveChild(Dentry* dentry) -> bool {
+  LockGuard<SpinLock> guard(GetVfsState().dcache.lock);
+  for (Dentry* child = dentry->children; child != nullptr;
+       child = child->next_sibling) {
+    if (child->inode != nullptr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief 在已加写锁的父目录中删除子目录
+ */
+auto RmDirLocked(Dentry* parent_dentry, const char* dir_name)
+    -> Expected<void> {
+  // 查找目标目录
+  auto target_result = LookupComponentLocked(parent_dentry, dir_name);
+  if (!target_result.has_value()) {
+    return std::unexpected(target_result.error());
+  }
+  Dentry* target_dentry = target_result.value();
+
+  if (target_dentry->inode->type != FileType::kDirectory) {
+    PutDentry(target_dentry);
+    return std::unexpected(Error(ErrorCode::kFsNotADirectory));
+  }
+
+  // 挂载点在卸载前不能删除
+  if (target_dentry->mounted.load(std::memory_order_acquire)) {
+    PutDentry(target_dentry);
+    return std::unexpected(Error(ErrorCode::kDeviceBusy));
+  }
+
+  // 按父目录到子目录的顺序加锁，排除在目标目录中的并发创建
+  Expected<void> result;
+  {
+    WriteLockGuard target_guard(target_dentry->inode->lock);
+    Inode* dir = parent_dentry->inode;
+    if (HasPositiveChild(target_dentry)) {
+      result = std::unexpected(Error(ErrorCode::kFsNotEmpty));
+    } else if (dir->ops == nullptr) {
+      result = std::unexpected(Error(ErrorCode::kDeviceNotSupported));
+    } else {
+      result = dir->ops->Rmdir(dir, dir_name);
+    }
+  }
+  if (!result.has_value()) {
+    PutDentry(target_dentry);
+    return result;
+  }
+
+  // 释放其下的负 dentry，再从父目录中移除
+  LockGuard<SpinLock> guard(GetVfsState().dcache.lock);
+  PruneDentryTree(target_dentry);
+  RemoveChild(parent_dentry, target_dentry);
+  PutDentryLocked(target_dentry);
+  return {};
+}
+
+}  // namespace
+
 auto RmDir(const char* path) -> Expected<void> {
   if (path == nullptr) {
     return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
 
-  LockGuard<SpinLock> guard(GetVfsState().vfs_lock_);
   // 解析父目录路径和目录名
   char parent_path[512];
   char dir_name[256];
-  const char* last_slash = strrchr(path, '/');
-  if (last_slash == nullptr || last_slash == path) {
-    strncpy(parent_path, "/", sizeof(parent_path));
-    strncpy(dir_name, path[0] == '/' ? path + 1 : path, sizeof(dir_name));
-  } else {
-    size_t parent_len = last_slash - path;
-    if (parent_len >= sizeof(parent_path)) {
-      parent_len = sizeof(parent_path) - 1;
-    }
-    strncpy(parent_path, path, parent_len);
-    parent_path[parent_len] = '\0';
-    strncpy(dir_name, last_slash + 1, sizeof(dir_name));
-  }
-  dir_name[sizeof(dir_name) - 1] = '\0';
+  SplitPath(path, parent_path, dir_name);
 
   // 查找父目录
   auto parent_result = Lookup(parent_path);
@@ -44,40 +95,20 @@ auto RmDir(const char* path) -> Expected<void> {
 
   Dentry* parent_dentry = parent_result.value();
   if (parent_dentry->inode == nullptr) {
+    PutDentry(parent_dentry);
     return std::unexpected(Error(ErrorCode::kFsCorrupted));
   }
 
-  // 查找目标目录
-  Dentry* target_dentry = FindChild(parent_dentry, dir_name);
-  if (target_dentry == nullptr) {
-    return std::unexpected(Error(ErrorCode::kFsFileNotFound));
-  }
-
-  if (target_dentry->inode == nullptr ||
-      target_dentry->inode->type != FileType::kDirectory) {
-    return std::unexpected(Error(ErrorCode::kFsNotADirectory));
-  }
-
-  // 检查目录是否为空
-  if (target_dentry->children != nullptr) {
-    return std::unexpected(Error(ErrorCode::kFsNotEmpty));
+  Expected<void> result;
+  {
+    WriteLockGuard dir_guard(parent_dentry->inode->lock);
+    result = RmDirLocked(parent_dentry, dir_name);
   }
-
-  // 删除目录
-  if (parent_dentry->inode->ops == nullptr) {
-    return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
-  }
-
-  auto result =
-      parent_dentry->inode->ops->Rmdir(parent_dentry->inode, dir_name);
+  PutDentry(parent_dentry);
   if (!result.has_value()) {
-    return std::unexpected(result.error());
+    return result;
   }
 
-  // 从父目录中移除 dentry
-  RemoveChild(parent_dentry, target_dentry);
-  etl::unique_ptr<Dentry> dentry_guard(target_dentry);
-
   klog::Debug("VFS: removed directory '{}'", path);
   return {};
 }
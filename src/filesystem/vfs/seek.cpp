@@ -5,7 +5,6 @@
 #include "filesystem.hpp"
 #include "kernel_log.hpp"
 #include "kstd_cstring"
-#include "spinlock.hpp"
 #include "vfs_internal.hpp"
 
 namespace vfs {
@@ -15,7 +14,9 @@ auto Seek(File* file, int64_t offset, SeekWhence whence) -> Expected<uint64_t> {
     return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
 
-  LockGuard<SpinLock> guard(GetVfsState().vfs_lock_);
+  // kEnd 需要读取文件大小
+  InodeLockGuard inode_guard(file->inode, false);
+  WriteLockGuard pos_guard(file->pos_lock);
   if (file->ops != nullptr) {
     return file->ops->Seek(file, offset, whence);
   }
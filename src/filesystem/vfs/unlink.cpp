@@ -2,8 +2,6 @@
  * @copyright Copyright The SimpleKernel Contributors
  */
 
-#include <etl/memory.h>
-
 #include "filesystem.hpp"
 #include "kernel_log.hpp"
 #include "kstd_cstring"
@@ -12,29 +10,59 @@
 
 namespace vfs {
 
+namespace {
+
+/**
+ * @brief 在已加写锁的父目录中删除文件
+ */
+auto UnlinkLocked(Dentry* parent_dentry, const char* file_name)
+    -> Expected<void> {
+  // 查找目标文件
+  auto target_result = LookupComponentLocked(parent_dentry, file_name);
+  if (!target_result.has_value()) {
+    return std::unexpected(target_result.error());
+  }
+  Dentry* target_dentry = target_result.value();
+
+  // 不能删除目录
+  if (target_dentry->inode->type == FileType::kDirectory) {
+    PutDentry(target_dentry);
+    return std::unexpected(Error(ErrorCode::kFsIsADirectory));
+  }
+
+  // 删除文件
+  Inode* dir = parent_dentry->inode;
+  if (dir->ops == nullptr) {
+    PutDentry(target_dentry);
+    return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
+  }
+
+  // 删除后文件系统可能释放并复用该 inode，先丢弃其缓存页
+  InvalidatePageCache(target_dentry->inode);
+  auto result = dir->ops->Unlink(dir, file_name);
+  if (!result.has_value()) {
+    PutDentry(target_dentry);
+    return std::unexpected(result.error());
+  }
+
+  // 从父目录中移除 dentry，仍被打开的文件引用时延迟到关闭后释放
+  LockGuard<SpinLock> guard(GetVfsState().dcache.lock);
+  RemoveChild(parent_dentry, target_dentry);
+  PutDentryLocked(target_dentry);
+  return {};
+}
+
+}  // namespace
+
 auto Unlink(const char* path) -> Expected<void> {
   if (path == nullptr) {
     return std::unexpected(Error(ErrorCode::kInvalidArgument));
   }
 
-  LockGuard<SpinLock> guard(GetVfsState().vfs_lock_);
   // 解析父目录路径和文件名
   char parent_path[512];
   char file_name[256];
-  const char* last_slash = strrchr(path, '/');
-  if (last_slash == nullptr || last_slash == path) {
-    strncpy(parent_path, "/", sizeof(parent_path));
-    strncpy(file_name, path[0] == '/' ? path + 1 : path, sizeof(file_name));
-  } else {
-    size_t parent_len = last_slash - path;
-    if (parent_len >= sizeof(parent_path)) {
-      parent_len = sizeof(parent_path) - 1;
-    }
-    strncpy(parent_path, path, parent_len);
-    parent_path[parent_len] = '\0';
-    strncpy(file_name, last_slash + 1, sizeof(file_name));
-  }
-  file_name[sizeof(file_name) - 1] = '\0';
+  SplitPath(path, parent_path, file_name);
 
   // 查找父目录
   auto parent_result = Lookup(parent_path);
@@ -44,39 +72,20 @@ auto Unlink(const char* path) -> Expected<void> {
 
   Dentry* parent_dentry = parent_result.value();
   if (parent_dentry->inode == nullptr) {
+    PutDentry(parent_dentry);
     return std::unexpected(Error(ErrorCode::kFsCorrupted));
   }
 
-  // 查找目标文件
-  Dentry* target_dentry = FindChild(parent_dentry, file_name);
-  if (target_dentry == nullptr) {
-    return std::unexpected(Error(ErrorCode::kFsFileNotFound));
+  Expected<void> result;
+  {
+    WriteLockGuard dir_guard(parent_dentry->inode->lock);
+    result = UnlinkLocked(parent_dentry, file_name);
   }
-
-  if (target_dentry->inode == nullptr) {
-    return std::unexpected(Error(ErrorCode::kFsCorrupted));
-  }
-
-  // 不能删除目录
-  if (target_dentry->inode->type == FileType::kDirectory) {
-    return std::unexpected(Error(ErrorCode::kFsIsADirectory));
-  }
-
-  // 删除文件
-  if (parent_dentry->inode->ops == nullptr) {
-    return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
-  }
-
-  auto result =
-      parent_dentry->inode->ops->Unlink(parent_dentry->inode, file_name);
+  PutDentry(parent_dentry);
   if (!result.has_value()) {
-    return std::unexpected(result.error());
+    return result;
   }
 
-  // 从父目录中移除 dentry
-  RemoveChild(parent_dentry, target_dentry);
-  etl::unique_ptr<Dentry> dentry_guard(target_dentry);
-
   klog::Debug("VFS: unlinked '{}'", path);
   return {};
 }
@@ -35,46 +35,22 @@ auto CopyPathComponent(const char* src, char* dst, size_t dst_size) -> size_t {
   return i;
 }
 
-auto FindChild(Dentry* parent, const char* name) -> Dentry* {
-  if (parent == nullptr || name == nullptr) {
-    return nullptr;
-  }
-
-  Dentry* child = parent->children;
-  while (child != nullptr) {
-    if (strcmp(child->name, name) == 0) {
-      return child;
-    }
-    child = child->next_sibling;
-  }
-  return nullptr;
-}
-
-auto AddChild(Dentry* parent, Dentry* child) -> void {
-  if (parent == nullptr || child == nullptr) {
-    return;
-  }
-
-  child->parent = parent;
-  child->next_sibling = parent->children;
-  parent->children = child;
-}
-
-auto RemoveChild(Dentry* parent, Dentry* child) -> void {
-  if (parent == nullptr || child == nullptr) {
-    return;
-  }
-
-  Dentry** current = &parent->children;
-  while (*current != nullptr) {
-    if (*current == child) {
-      *current = child->next_sibling;
-      child->parent = nullptr;
-      child->next_sibling = nullptr;
-      return;
+auto SplitPath(const char* path, char (&parent_path)[512], char (&name)[256])
+    -> void {
+  const char* last_slash = strrchr(path, '/');
+  if (last_slash == nullptr || last_slash == path) {
+    strncpy(parent_path, "/", sizeof(parent_path));
+    strncpy(name, path[0] == '/' ? path + 1 : path, sizeof(name));
+  } else {
+    size_t parent_len = last_slash - path;
+    if (parent_len >= sizeof(parent_path)) {
+      parent_len = sizeof(parent_path) - 1;
     }
-    current = &(*current)->next_sibling;
+    strncpy(parent_path, path, parent_len);
+    parent_path[parent_len] = '\0';
+    strncpy(name, last_slash + 1, sizeof(name));
   }
+  name[sizeof(name) - 1] = '\0';
 }
 
 auto Init() -> Expected<void> {
@@ -4,23 +4,173 @@
 
 #pragma once
 
+#include <cpu_io.h>
+
+#include <array>
+#include <atomic>
+
 #include "mount.hpp"
+#include "seqcount.hpp"
 #include "spinlock.hpp"
 #include "vfs.hpp"
 
 namespace vfs {
 
+/// @brief 全局目录项缓存
+struct DentryCache {
+  /// 哈希桶数量（2 的幂）
+  static constexpr size_t kBucketCount = 1024;
+  /// dentry 总数上限，超过后按 LRU 回收
+  static constexpr size_t kMaxDentries = 4096;
+  /// 每次超限时回收的数量
+  static constexpr size_t kShrinkBatch = 64;
+
+  /// 以 (父 dentry, 名称哈希) 索引的哈希桶
+  std::array<Dentry*, kBucketCount> buckets{};
+  /// 未使用 dentry 的 LRU 链表，头部最久未使用
+  Dentry* lru_head = nullptr;
+  Dentry* lru_tail = nullptr;
+  /// 哈希表中的 dentry 数量
+  size_t count = 0;
+  /// 无锁遍历期间待释放的 dentry（经 lru_next 链接）
+  Dentry* deferred = nullptr;
+  /// 正在无锁遍历的读者数，不为 0 时 dentry 延迟释放
+  std::atomic<uint32_t> walkers{0};
+  /// 哈希表、目录树与挂载表的修改序号
+  SeqCount seq;
+  /// 保护以上字段及 dentry 的链表字段，持有期间不做 I/O
+  SpinLock lock{"dcache"};
+};
+
+struct PageIo;
+
+/// @brief 页缓存中的一页文件数据
+struct CachedPage {
+  /// 所属 inode
+  Inode* inode;
+  /// 页号（文件偏移 / 页大小）
+  uint64_t index;
+  /// 页数据
+  uint8_t* data;
+  /// 页内有效字节数，文件末尾所在页小于页大小
+  size_t valid;
+  /// 预读标记，读到该页时触发下一窗口的预读
+  bool readahead_mark;
+  /// 正在从块设备读入时指向其请求，此时页内容尚不可用
+  PageIo* io;
+  /// 同一哈希桶中的下一页
+  CachedPage* hash_next;
+  /// LRU 链表指针
+  CachedPage* lru_prev;
+  CachedPage* lru_next;
+};
+
+/// @brief 全局页缓存，由所有使用页缓存的文件系统共享
+struct PageCache {
+  /// 页大小
+  static constexpr size_t kPageSize = cpu_io::virtual_memory::kPageSize;
+  /// 哈希桶数量（2 的幂）
+  static constexpr size_t kBucketCount = 1024;
+  /// 缓存页数上限，超过后按 LRU 回收
+  static constexpr size_t kMaxPages = 4096;
+  /// 每次超限或分配失败时回收的数量
+  static constexpr size_t kShrinkBatch = 64;
+  /// 预读窗口的最小与最大页数
+  static constexpr uint32_t kMinReadahead = 4;
+  static constexpr uint32_t kMaxReadahead = 32;
+  /// 读者等待页读入的最长毫秒数，超时后放弃等待，页仍由请求完成时解锁
+  static constexpr uint64_t kIoTimeoutMs = 30000;
+
+  /// 以 (inode, 页号) 索引的哈希桶
+  std::array<CachedPage*, kBucketCount> buckets{};
+  /// LRU 链表，头部最久未使用
+  CachedPage* lru_head = nullptr;
+  CachedPage* lru_tail = nullptr;
+  /// 缓存的页数
+  size_t count = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  uint64_t readahead = 0;
+  /// 保护以上字段与页内容，持有期间不做 I/O
+  SpinLock lock{"page_cache"};
+};
+
 /// @brief VFS 全局状态结构体
 struct VfsState {
   bool initialized = false;
   MountTable* mount_table = nullptr;
   Dentry* root_dentry = nullptr;
+  DentryCache dcache;
+  PageCache page_cache;
+  /// 串行化挂载与卸载，文件读写与路径解析不使用
   SpinLock vfs_lock_{"vfs"};
 };
 
 // 获取 VFS 状态
 [[nodiscard]] auto GetVfsState() -> VfsState&;
 
+/**
+ * @brief 按需持有 inode 锁的守卫，inode 为 nullptr 时不加锁
+ */
+class InodeLockGuard {
+ public:
+  /// @name 构造/析构函数
+  /// @{
+  InodeLockGuard(Inode* inode, bool exclusive)
+      : inode_(inode), exclusive_(exclusive) {
+    if (inode_ == nullptr) {
+      return;
+    }
+    if (exclusive_) {
+      inode_->lock.WriteLock();
+    } else {
+      inode_->lock.ReadLock();
+    }
+  }
+  InodeLockGuard() = delete;
+  InodeLockGuard(const InodeLockGuard&) = delete;
+  InodeLockGuard(InodeLockGuard&&) = delete;
+  auto operator=(const InodeLockGuard&) -> InodeLockGuard& = delete;
+  auto operator=(InodeLockGuard&&) -> InodeLockGuard& = delete;
+  ~InodeLockGuard() {
+    if (inode_ == nullptr) {
+      return;
+    }
+    if (exclusive_) {
+      inode_->lock.WriteUnlock();
+    } else {
+      inode_->lock.ReadUnlock();
+    }
+  }
+  /// @}
+
+ private:
+  Inode* inode_;
+  bool exclusive_;
+};
+
+/**
+ * @brief inode 所在的文件系统是否使用页缓存
+ */
+[[nodiscard]] auto UsesPageCache(const Inode* inode) -> bool;
+
+/**
+ * @brief 经页缓存读取文件数据
+ * @param file 文件对象，其文件系统使用页缓存
+ * @param buf 输出缓冲区
+ * @param count 最大读取字节数
+ * @param offset 读取位置
+ * @return Expected<size_t> 实际读取的字节数或错误
+ * @pre 调用者持有 inode 的共享锁与 File 的偏移量锁
+ * @note 命中时只复制内存；未命中时读取整页后缓存，顺序读取时按 File 的
+ *       预读状态一并读入后续页。文件系统支持 FileOps::MapExtent 时预读
+ *       窗口异步提交给块设备，只等待需要的页，否则经 FileOps::ReadPage
+ *       同步读取
+ */
+[[nodiscard]] auto PageCacheRead(File* file, void* buf, size_t count,
+                                 uint64_t offset) -> Expected<size_t>;
+
 /**
  * @brief 跳过路径中的前导斜杠
  * @param path 输入路径
@@ -38,19 +188,115 @@ struct VfsState {
 [[nodiscard]] auto CopyPathComponent(const char* src, char* dst,
                                      size_t dst_size) -> size_t;
 
+/**
+ * @brief 将路径拆分为父目录路径与最后一个组件
+ * @param path 路径
+ * @param parent_path 父目录路径缓冲区（512 字节）
+ * @param name 最后一个组件缓冲区（256 字节）
+ */
+auto SplitPath(const char* path, char (&parent_path)[512], char (&name)[256])
+    -> void;
+
+/**
+ * @brief 计算路径组件的名称哈希
+ * @param name 名称
+ * @param len 名称长度
+ * @return uint32_t 哈希值
+ */
+[[nodiscard]] auto HashName(const char* name, size_t len) -> uint32_t;
+
+/**
+ * @brief 在 dcache 中查找子 dentry
+ * @param parent 父 dentry
+ * @param name 名称
+ * @param len 名称长度
+ * @param hash 名称哈希（HashName 的结果）
+ * @return Dentry* 命中的 dentry（可能是负 dentry），未命中返回 nullptr
+ * @note 持有 dcache 锁时调用；无锁遍历中调用时结果需经序号校验
+ */
+[[nodiscard]] auto LookupChild(Dentry* parent, const char* name, size_t len,
+                               uint32_t hash) -> Dentry*;
+
 /**
  * @brief 在 dentry 的子节点中查找指定名称
+ * @return Dentry* 正 dentry，不存在或为负 dentry 时返回 nullptr
+ * @pre 持有 dcache 锁
  */
 [[nodiscard]] auto FindChild(Dentry* parent, const char* name) -> Dentry*;
 
 /**
- * @brief 添加子 dentry
+ * @brief 添加子 dentry 并挂入 dcache
+ * @param parent 父 dentry
+ * @param name 名称
+ * @param len 名称长度
+ * @param hash 名称哈希
+ * @param inode 关联的 inode，nullptr 表示创建负 dentry
+ * @return Expected<Dentry*> 新的或被复用的 dentry（不增加引用）
+ * @pre 持有 dcache 锁，且 parent 持有引用
+ * @note 已存在同名负 dentry 时直接将其实例化；已存在引用其它 inode 的
+ *       正 dentry 或失败时，通过 FileSystem::ReleaseInode 归还 inode
  */
-auto AddChild(Dentry* parent, Dentry* child) -> void;
+[[nodiscard]] auto AddChild(Dentry* parent, const char* name, size_t len,
+                            uint32_t hash, Inode* inode) -> Expected<Dentry*>;
 
 /**
- * @brief 从父 dentry 中移除子 dentry
+ * @brief 从父 dentry 与 dcache 中移除子 dentry
+ * @pre 持有 dcache 锁
+ * @note 无引用时立即释放，否则在最后一个引用释放时释放
  */
 auto RemoveChild(Dentry* parent, Dentry* child) -> void;
 
+/**
+ * @brief 增加 dentry 的引用计数
+ * @pre 调用者已持有该 dentry 的引用，或持有 dcache 锁且 dentry 在哈希表中
+ */
+auto GetDentry(Dentry* dentry) -> void;
+
+/**
+ * @brief 无锁遍历中尝试获得 dentry 的引用
+ * @return bool dentry 正在被释放时返回 false
+ */
+[[nodiscard]] auto TryGetDentry(Dentry* dentry) -> bool;
+
+/**
+ * @brief 持有 dcache 锁时释放 dentry 的一个引用
+ * @note 降为 0 时放入 LRU 链表；已移出 dcache 的 dentry 直接释放
+ */
+auto PutDentryLocked(Dentry* dentry) -> void;
+
+/**
+ * @brief 释放以 root 为根的整棵 dentry 子树（不含 root 本身）
+ * @pre 持有 dcache 锁，子树中的 dentry 没有被打开的文件引用
+ */
+auto PruneDentryTree(Dentry* root) -> void;
+
+/**
+ * @brief 检查 dentry 树中是否有被打开的文件或路径解析引用的 dentry
+ * @pre 持有 dcache 锁
+ */
+[[nodiscard]] auto IsDentryTreeBusy(Dentry* root) -> bool;
+
+/**
+ * @brief 释放挂载根及其整棵子树
+ * @pre 持有 dcache 锁，且 IsDentryTreeBusy(root) 为 false
+ */
+auto DestroyDentryTree(Dentry* root) -> void;
+
+/**
+ * @brief 设置 dentry 名称
+ * @return Expected<void> 长名称分配失败时返回 kOutOfMemory
+ */
+[[nodiscard]] auto SetDentryName(Dentry* dentry, const char* name, size_t len)
+    -> Expected<void>;
+
+/**
+ * @brief 在已加锁的目录中解析一个路径组件
+ * @param parent 父 dentry，调用者持有其引用与其 inode 锁（共享或独占）
+ * @param name 以 '\0' 结尾的组件名
+ * @return Expected<Dentry*> 持有引用的正 dentry；不存在时返回 kFsFileNotFound
+ *         并缓存负 dentry
+ */
+[[nodiscard]] auto LookupComponentLocked(Dentry* parent, const char* name)
+    -> Expected<Dentry*>;
+
 }  // namespace vfs
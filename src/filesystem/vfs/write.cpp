@@ -5,7 +5,6 @@
 #include "filesystem.hpp"
 #include "kernel_log.hpp"
 #include "kstd_cstring"
-#include "spinlock.hpp"
 #include "vfs_internal.hpp"
 
 namespace vfs {
@@ -16,7 +15,6 @@ auto Write(File* file, const void* buf, size_t count) -> Expected<size_t> {
   }
 
   // 检查写入权限
-  LockGuard<SpinLock> guard(GetVfsState().vfs_lock_);
   if ((file->flags & OpenFlags::kOWriteOnly) == 0U &&
       (file->flags & OpenFlags::kOReadWrite) == 0U) {
     return std::unexpected(Error(ErrorCode::kFsPermissionDenied));
@@ -26,7 +24,38 @@ auto Write(File* file, const void* buf, size_t count) -> Expected<size_t> {
     return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
   }
 
-  return file->ops->Write(file, buf, count);
+  InodeLockGuard inode_guard(file->inode, true);
+  WriteLockGuard pos_guard(file->pos_lock);
+  auto result = file->ops->Write(file, buf, count);
+  if (result.has_value()) {
+    InvalidatePageCache(file->inode, file->offset - result.value(),
+                        result.value());
+  }
+  return result;
+}
+
+auto PWrite(File* file, const void* buf, size_t count, uint64_t offset)
+    -> Expected<size_t> {
+  if (file == nullptr || buf == nullptr) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  // 检查写入权限
+  if ((file->flags & OpenFlags::kOWriteOnly) == 0U &&
+      (file->flags & OpenFlags::kOReadWrite) == 0U) {
+    return std::unexpected(Error(ErrorCode::kFsPermissionDenied));
+  }
+
+  if (file->ops == nullptr) {
+    return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
+  }
+
+  InodeLockGuard inode_guard(file->inode, true);
+  auto result = file->ops->PWrite(file, buf, count, offset);
+  if (result.has_value()) {
+    InvalidatePageCache(file->inode, offset, result.value());
+  }
+  return result;
 }
 
 }  // namespace vfs
@@ -0,0 +1,87 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "expected.hpp"
+#include "resource_id.hpp"
+
+/**
+ * @brief 完成量（可休眠）
+ *
+ * 一个任务等待某个事件（如一次设备 I/O）完成：
+ * - Wait() 在事件完成前阻塞当前任务，可指定超时
+ * - Complete() 标记完成并唤醒等待的任务，可在中断处理程序中调用；
+ *   标记完成后不再访问完成量，等待者返回后即可销毁它
+ * - 完成后保持完成状态，直到 Reset()
+ *
+ * @note 使用限制：
+ * 1. Wait() 可能阻塞：不能在持有自旋锁时或中断处理程序中调用
+ * 2. 没有当前任务时（如调度器启动前）Wait() 立即返回，由调用者轮询
+ */
+class Completion {
+ public:
+  /// 完成量的名称
+  const char* name{"unnamed_completion"};
+
+  /**
+   * @brief 标记完成并唤醒等待的任务
+   */
+  auto Complete() -> void;
+
+  /**
+   * @brief 等待完成
+   * @param timeout_ms 超时毫秒数，为 0 时不超时
+   * @return Expected<void> 超时返回 kTimeout，不能阻塞时返回
+   *         kNotSupported
+   */
+  [[nodiscard]] auto Wait(uint64_t timeout_ms = 0) -> Expected<void>;
+
+  /**
+   * @brief 是否已完成
+   * @return true 已完成
+   */
+  [[nodiscard]] auto IsDone() const -> bool {
+    return done_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief 清除完成状态以便复用
+   * @pre 没有任务在等待
+   */
+  auto Reset() -> void { done_.store(false, std::memory_order_relaxed); }
+
+  /**
+   * @brief 当前上下文能否阻塞等待
+   * @return true 有当前任务且中断已开启
+   */
+  [[nodiscard]] static auto CanWait() -> bool;
+
+  /// @name 构造/析构函数
+  /// @{
+  explicit Completion(const char* _name)
+      : name(_name),
+        resource_id_(ResourceType::kIoComplete,
+                     reinterpret_cast<uint64_t>(this)) {}
+  Completion()
+      : resource_id_(ResourceType::kIoComplete,
+                     reinterpret_cast<uint64_t>(this)) {}
+
+  Completion(const Completion&) = delete;
+  Completion(Completion&&) = delete;
+  auto operator=(const Completion&) -> Completion& = delete;
+  auto operator=(Completion&&) -> Completion& = delete;
+  ~Completion() = default;
+  /// @}
+
+ protected:
+  /// 是否已完成
+  std::atomic<bool> done_{false};
+
+  /// 资源 ID，用于任务阻塞队列
+  ResourceId resource_id_{};
+};
@@ -33,6 +33,7 @@ enum class ErrorCode : uint64_t {
   kVmUnmapFailed = 0x402,
   kVmInvalidPageTable = 0x403,
   kVmPageNotMapped = 0x404,
+  kVmPageAlreadyMapped = 0x405,
   // IPI 相关错误 (0x500 - 0x5FF)
   kIpiTargetOutOfRange = 0x500,
   kIpiSendFailed = 0x501,
@@ -53,6 +54,9 @@ enum class ErrorCode : uint64_t {
   kTaskKernelStackAllocationFailed = 0x705,
   kTaskNoChildFound = 0x706,
   kTaskInvalidPid = 0x707,
+  kTaskInvalidSchedAttr = 0x708,
+  kTaskDeadlineAdmissionFailed = 0x709,
+  kTaskInvalidAffinity = 0x70A,
   // Device 相关错误 (0x800 - 0x8FF)
   kDeviceNotFound = 0x800,
   kDeviceAlreadyOpen = 0x801,
@@ -131,6 +135,7 @@ enum class ErrorCode : uint64_t {
   // 通用错误 (0xF00 - 0xFFF)
   kInvalidArgument = 0xF00,
   kOutOfMemory = 0xF01,
+  kBadAddress = 0xF02,
 };
 
 /// 获取错误码对应的错误信息
@@ -176,6 +181,8 @@ constexpr auto GetErrorMessage(ErrorCode code) -> const char* {
       return "Invalid page table";
     case ErrorCode::kVmPageNotMapped:
       return "Page not mapped";
+    case ErrorCode::kVmPageAlreadyMapped:
+      return "Page already mapped";
     case ErrorCode::kIpiTargetOutOfRange:
       return "IPI target CPU mask out of range";
     case ErrorCode::kIpiSendFailed:
@@ -210,6 +217,12 @@ constexpr auto GetErrorMessage(ErrorCode code) -> const char* {
       return "No child process found";
     case ErrorCode::kTaskInvalidPid:
       return "Invalid PID";
+    case ErrorCode::kTaskInvalidSchedAttr:
+      return "Invalid scheduling attributes";
+    case ErrorCode::kTaskDeadlineAdmissionFailed:
+      return "Deadline bandwidth admission failed";
+    case ErrorCode::kTaskInvalidAffinity:
+      return "No online core in affinity mask";
     case ErrorCode::kDeviceNotFound:
       return "Device not found";
     case ErrorCode::kDeviceAlreadyOpen:
@@ -322,6 +335,8 @@ constexpr auto GetErrorMessage(ErrorCode code) -> const char* {
       return "Invalid argument";
     case ErrorCode::kOutOfMemory:
       return "Out of memory";
+    case ErrorCode::kBadAddress:
+      return "Bad address";
     default:
       return "Unknown error";
   }
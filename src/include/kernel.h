@@ -32,6 +32,10 @@ auto MemoryInitSMP() -> void;
 
 /// @brief 设备子系统初始化
 auto DeviceInit() -> void;
+/// @brief 启动设备的后台任务（网络接收轮询），需在任务管理器初始化之后
+auto DeviceStartTasks() -> void;
 
 /// @brief 文件系统初始化
 auto FileSystemInit() -> void;
+/// @brief 启动文件系统的后台任务（块缓存冲刷），需在任务管理器初始化之后
+auto FileSystemStartTasks() -> void;
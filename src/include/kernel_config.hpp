@@ -37,4 +37,10 @@ inline constexpr size_t kMaxInterruptThreadsBuckets = 64;
 inline constexpr size_t kTickObservers = 8;
 /// 最大 panic 观察者数
 inline constexpr size_t kPanicObservers = 4;
+
+/// virtio-blk 同步读写在睡眠前先轮询完成（混合轮询），以 CPU 换取延迟
+inline constexpr bool kVirtioBlkHybridPoll = false;
+/// virtio-blk 设备提供 VIRTIO_F_RING_PACKED 时使用 packed virtqueue，
+/// build_riscv64 预设给 QEMU 的 virtio-blk-device 加了 packed=on
+inline constexpr bool kVirtioBlkPackedRing = true;
 }  // namespace kernel::config
@@ -26,11 +26,20 @@ struct PerCpu {
 
   /// 当前运行的任务
   TaskControlBlock* running_task{nullptr};
+  /// 正在换出的任务，切换完成后由 FinishSwitch 清除其 on_cpu
+  TaskControlBlock* prev_task{nullptr};
   /// 空闲任务
   TaskControlBlock* idle_task{nullptr};
   /// 调度数据 (RunQueue) 指针
   CpuSchedData* sched_data{nullptr};
 
+  /// FPU 寄存器中保存的是哪个任务的状态 (nullptr 表示不属于任何任务)
+  TaskControlBlock* fpu_owner{nullptr};
+  /// KernelFpuBegin 嵌套深度
+  size_t kernel_fpu_depth{0};
+  /// 最外层 KernelFpuBegin 之前的中断状态
+  bool kernel_fpu_intr{false};
+
   /// @name 构造/析构函数
   /// @{
   explicit PerCpu(size_t id) : core_id(id) {}
@@ -0,0 +1,144 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "resource_id.hpp"
+
+/**
+ * @brief 读写锁（可休眠）
+ *
+ * 实现基于任务调度的读写锁：
+ * - 多个读者可以同时持有锁，写者独占
+ * - 有写者等待时新的读者不再进入，避免写者饥饿
+ * - 锁不可用时当前任务阻塞，释放时唤醒等待的任务
+ * - 没有当前任务时（如调度器启动前）退化为自旋等待
+ *
+ * @note 使用限制：
+ * 1. 不可重入：同一任务不能递归获取，读锁也不行（写者等待时会死锁）
+ * 2. 可能阻塞：不能在持有自旋锁时或中断处理程序中获取
+ * 3. 不跟踪所有者：由调用者保证加锁与解锁配对
+ */
+class RwMutex {
+ public:
+  /// 锁的名称
+  const char* name{"unnamed_rw_mutex"};
+
+  /**
+   * @brief 获取读锁（共享）
+   */
+  auto ReadLock() -> void;
+
+  /**
+   * @brief 释放读锁
+   */
+  auto ReadUnlock() -> void;
+
+  /**
+   * @brief 获取写锁（独占）
+   */
+  auto WriteLock() -> void;
+
+  /**
+   * @brief 释放写锁
+   */
+  auto WriteUnlock() -> void;
+
+  /**
+   * @brief 检查是否有写者持有锁
+   * @return true 写锁被持有
+   */
+  [[nodiscard]] auto IsWriteLocked() const -> bool {
+    return (state_.load(std::memory_order_acquire) & kWriter) != 0;
+  }
+
+  /// @name 构造/析构函数
+  /// @{
+  explicit RwMutex(const char* _name)
+      : name(_name),
+        resource_id_(ResourceType::kMutex, reinterpret_cast<uint64_t>(this)) {}
+  RwMutex()
+      : resource_id_(ResourceType::kMutex, reinterpret_cast<uint64_t>(this)) {}
+
+  RwMutex(const RwMutex&) = delete;
+  RwMutex(RwMutex&&) = delete;
+  auto operator=(const RwMutex&) -> RwMutex& = delete;
+  auto operator=(RwMutex&&) -> RwMutex& = delete;
+  ~RwMutex() = default;
+  /// @}
+
+ protected:
+  /// 写者持有锁
+  static constexpr uint32_t kWriter = 1U << 31;
+  /// 有写者在等待
+  static constexpr uint32_t kWriterWaiting = 1U << 30;
+  /// 读者计数掩码
+  static constexpr uint32_t kReaderMask = kWriterWaiting - 1;
+
+  /// 锁状态：高两位为写者标志，其余位为读者数
+  std::atomic<uint32_t> state_{0};
+
+  /// 阻塞在此锁上的任务数，为 0 时释放锁无需唤醒
+  std::atomic<uint32_t> waiters_{0};
+
+  /// 资源 ID，用于任务阻塞队列
+  ResourceId resource_id_{};
+
+  /**
+   * @brief 等待锁状态变化
+   * @param mask 需要等待清除的状态位
+   * @note 持有调度锁时再次检查状态，mask 位已清除时不阻塞
+   */
+  auto Wait(uint32_t mask) -> void;
+
+  /**
+   * @brief 唤醒等待此锁的任务（如果有）
+   */
+  auto WakeWaiters() -> void;
+};
+
+/**
+ * @brief RAII 风格的读锁守卫
+ */
+class ReadLockGuard {
+ public:
+  /// @name 构造/析构函数
+  /// @{
+  explicit ReadLockGuard(RwMutex& mutex) : mutex_(mutex) { mutex_.ReadLock(); }
+  ReadLockGuard() = delete;
+  ReadLockGuard(const ReadLockGuard&) = delete;
+  ReadLockGuard(ReadLockGuard&&) = delete;
+  auto operator=(const ReadLockGuard&) -> ReadLockGuard& = delete;
+  auto operator=(ReadLockGuard&&) -> ReadLockGuard& = delete;
+  ~ReadLockGuard() { mutex_.ReadUnlock(); }
+  /// @}
+
+ private:
+  RwMutex& mutex_;
+};
+
+/**
+ * @brief RAII 风格的写锁守卫
+ */
+class WriteLockGuard {
+ public:
+  /// @name 构造/析构函数
+  /// @{
+  explicit WriteLockGuard(RwMutex& mutex) : mutex_(mutex) {
+    mutex_.WriteLock();
+  }
+  WriteLockGuard() = delete;
+  WriteLockGuard(const WriteLockGuard&) = delete;
+  WriteLockGuard(WriteLockGuard&&) = delete;
+  auto operator=(const WriteLockGuard&) -> WriteLockGuard& = delete;
+  auto operator=(WriteLockGuard&&) -> WriteLockGuard& = delete;
+  ~WriteLockGuard() { mutex_.WriteUnlock(); }
+  /// @}
+
+ private:
+  RwMutex& mutex_;
+};
@@ -0,0 +1,79 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+#include <cpu_io.h>
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief 序号计数器（seqcount）
+ *
+ * 读者无锁读取共享数据，读完后检查序号是否变化，变化则重试：
+ * @code
+ * uint32_t seq;
+ * do {
+ *   seq = counter.ReadBegin();
+ *   // 读取共享数据
+ * } while (counter.ReadRetry(seq));
+ * @endcode
+ *
+ * @note 使用限制：
+ * 1. 写者之间必须由外部的锁互斥
+ * 2. 读者可能读到不一致的中间状态，校验通过前不能依赖读到的数据
+ */
+class SeqCount {
+ public:
+  /**
+   * @brief 开始读
+   * @return uint32_t 读开始时的序号，写者进行中时自旋等待
+   */
+  [[nodiscard]] auto ReadBegin() const -> uint32_t {
+    while (true) {
+      auto seq = seq_.load(std::memory_order_acquire);
+      if ((seq & 1) == 0) {
+        return seq;
+      }
+      cpu_io::Pause();
+    }
+  }
+
+  /**
+   * @brief 检查读期间是否发生了写
+   * @param start ReadBegin 的返回值
+   * @return true 需要重试
+   */
+  [[nodiscard]] auto ReadRetry(uint32_t start) const -> bool {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return seq_.load(std::memory_order_relaxed) != start;
+  }
+
+  /**
+   * @brief 开始写，序号变为奇数
+   */
+  auto WriteBegin() -> void {
+    seq_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  /**
+   * @brief 结束写，序号变为偶数
+   */
+  auto WriteEnd() -> void { seq_.fetch_add(1, std::memory_order_release); }
+
+  /// @name 构造/析构函数
+  /// @{
+  SeqCount() = default;
+  SeqCount(const SeqCount&) = delete;
+  SeqCount(SeqCount&&) = delete;
+  auto operator=(const SeqCount&) -> SeqCount& = delete;
+  auto operator=(SeqCount&&) -> SeqCount& = delete;
+  ~SeqCount() = default;
+  /// @}
+
+ private:
+  std::atomic<uint32_t> seq_{0};
+};
@@ -12,7 +12,15 @@
 // 参考 Linux 系统调用号
 #if defined(__riscv) || defined(__aarch64__)
 // RISC-V 64 和 AArch64 使用 asm-generic 编号
+inline constexpr uint64_t kSyscallOpenat = 56;
+inline constexpr uint64_t kSyscallClose = 57;
+inline constexpr uint64_t kSyscallLseek = 62;
+inline constexpr uint64_t kSyscallRead = 63;
 inline constexpr uint64_t kSyscallWrite = 64;
+inline constexpr uint64_t kSyscallReadv = 65;
+inline constexpr uint64_t kSyscallWritev = 66;
+inline constexpr uint64_t kSyscallPread64 = 67;
+inline constexpr uint64_t kSyscallPwrite64 = 68;
 inline constexpr uint64_t kSyscallExit = 93;
 inline constexpr uint64_t kSyscallYield = 124;
 inline constexpr uint64_t kSyscallClone = 220;
@@ -20,9 +28,20 @@ inline constexpr uint64_t kSyscallGettid = 178;
 inline constexpr uint64_t kSyscallFutex = 98;
 inline constexpr uint64_t kSyscallSetTidAddress = 96;
 inline constexpr uint64_t kSyscallFork = 1220;
+inline constexpr uint64_t kSyscallSchedSetattr = 274;
+inline constexpr uint64_t kSyscallRingSetup = 425;
+inline constexpr uint64_t kSyscallRingEnter = 426;
 #elif defined(__x86_64__)
 // x86_64 使用自己的编号
+inline constexpr uint64_t kSyscallRead = 0;
 inline constexpr uint64_t kSyscallWrite = 1;
+inline constexpr uint64_t kSyscallClose = 3;
+inline constexpr uint64_t kSyscallLseek = 8;
+inline constexpr uint64_t kSyscallPread64 = 17;
+inline constexpr uint64_t kSyscallPwrite64 = 18;
+inline constexpr uint64_t kSyscallReadv = 19;
+inline constexpr uint64_t kSyscallWritev = 20;
+inline constexpr uint64_t kSyscallOpenat = 257;
 inline constexpr uint64_t kSyscallExit = 60;
 inline constexpr uint64_t kSyscallYield = 24;
 inline constexpr uint64_t kSyscallClone = 56;
@@ -30,15 +49,117 @@ inline constexpr uint64_t kSyscallGettid = 186;
 inline constexpr uint64_t kSyscallFutex = 202;
 inline constexpr uint64_t kSyscallSetTidAddress = 218;
 inline constexpr uint64_t kSyscallFork = 57;
+inline constexpr uint64_t kSyscallSchedSetattr = 314;
+inline constexpr uint64_t kSyscallRingSetup = 425;
+inline constexpr uint64_t kSyscallRingEnter = 426;
 #else
 #error "Unsupported architecture for syscall numbers"
 #endif
 
+/// openat 的 dirfd，表示相对当前工作目录 (与 Linux AT_FDCWD 一致)
+inline constexpr int kAtFdCwd = -100;
+
+/// readv/writev 最多接受的 iovec 数
+inline constexpr int kIovMax = 64;
+
+/**
+ * @brief readv/writev 的分散/聚集缓冲区 (与 Linux struct iovec 布局一致)
+ */
+struct UserIoVec {
+  /// 用户缓冲区地址
+  void* base;
+  /// 缓冲区长度
+  size_t len;
+};
+
+/// sched_setattr 调度策略 (与 Linux SCHED_* 取值一致)
+inline constexpr uint32_t kSchedNormal = 0;
+inline constexpr uint32_t kSchedFifo = 1;
+inline constexpr uint32_t kSchedRr = 2;
+inline constexpr uint32_t kSchedIdle = 5;
+inline constexpr uint32_t kSchedDeadline = 6;
+
+/**
+ * @brief sched_setattr 的用户态参数 (与 Linux struct sched_attr 布局一致)
+ * @note 时间参数单位为纳秒
+ */
+struct UserSchedAttr {
+  /// 结构体大小
+  uint32_t size;
+  /// 调度策略 (kSched*)
+  uint32_t sched_policy;
+  /// 调度标志 (暂未使用)
+  uint64_t sched_flags;
+  /// nice 值 (kSchedNormal/kSchedIdle)
+  int32_t sched_nice;
+  /// 实时优先级 1-99，数值越大优先级越高 (kSchedFifo/kSchedRr)
+  uint32_t sched_priority;
+  /// 每周期运行预算 (kSchedDeadline)
+  uint64_t sched_runtime;
+  /// 相对截止时间 (kSchedDeadline)
+  uint64_t sched_deadline;
+  /// 周期 (kSchedDeadline)
+  uint64_t sched_period;
+};
+
+/**
+ * @brief ring_setup 的参数
+ */
+struct SyscallRingParams {
+  /// [in] 共享区在用户空间的映射地址 (页对齐，内核线程忽略)
+  uint64_t user_addr;
+  /// [out] 共享区地址 (SyscallRingHeader 所在位置)
+  uint64_t ring_addr;
+  /// [out] 共享区大小 (字节)
+  uint64_t ring_size;
+  /// [out] SQ 表项数
+  uint32_t sq_entries;
+  /// [out] CQ 表项数
+  uint32_t cq_entries;
+};
+
 // 由各个架构实现
 auto Syscall(uint64_t cause, cpu_io::TrapContext* context) -> void;
 
 auto syscall_dispatcher(int64_t syscall_id, uint64_t args[6]) -> int;
 
+/**
+ * @brief 打开文件
+ * @param dirfd 相对路径的基准目录，仅支持 kAtFdCwd
+ * @param pathname 文件路径
+ * @param flags 打开标志 (与 Linux O_* 取值一致)
+ * @param mode 创建文件时的权限 (暂未使用)
+ * @return 成功返回新的文件描述符，失败返回负数
+ * @note 没有工作目录的概念，相对路径按根目录解析
+ */
+[[nodiscard]] auto sys_openat(int dirfd, const char* pathname, int flags,
+                              int mode) -> int;
+
+/**
+ * @brief 关闭文件描述符
+ * @param fd 文件描述符
+ * @return 成功返回 0，失败返回负数
+ */
+[[nodiscard]] auto sys_close(int fd) -> int;
+
+/**
+ * @brief 调整文件偏移量
+ * @param fd 文件描述符
+ * @param offset 偏移量
+ * @param whence 基准位置 (0: 开头，1: 当前位置，2: 末尾)
+ * @return 成功返回新的偏移量，失败返回负数
+ */
+[[nodiscard]] auto sys_lseek(int fd, int64_t offset, int whence) -> int64_t;
+
+/**
+ * @brief 从文件描述符读取数据
+ * @param fd 文件描述符
+ * @param buf 数据缓冲区
+ * @param len 最大读取长度
+ * @return 实际读取的字节数，到达文件末尾返回 0，失败返回负数
+ */
+[[nodiscard]] auto sys_read(int fd, char* buf, size_t len) -> int;
+
 /**
  * @brief 向文件描述符写入数据
  * @param fd 文件描述符
@@ -46,9 +167,54 @@ auto syscall_dispatcher(int64_t syscall_id, uint64_t args[6]) -> int;
  * @param len 数据长度
  * @return 成功写入的字节数，失败返回负数
  * @note 使用场景：标准输出、日志输出等
+ * @note fd 1/2 未关联文件时输出到控制台
  */
 [[nodiscard]] auto sys_write(int fd, const char* buf, size_t len) -> int;
 
+/**
+ * @brief 从指定位置读取数据，不改变文件偏移量
+ * @param fd 文件描述符
+ * @param buf 数据缓冲区
+ * @param len 最大读取长度
+ * @param offset 读取位置
+ * @return 实际读取的字节数，失败返回负数
+ * @note 使用场景：多个线程共享同一个 fd 并发读取不同位置
+ */
+[[nodiscard]] auto sys_pread64(int fd, char* buf, size_t len, int64_t offset)
+    -> int;
+
+/**
+ * @brief 向指定位置写入数据，不改变文件偏移量
+ * @param fd 文件描述符
+ * @param buf 数据缓冲区
+ * @param len 数据长度
+ * @param offset 写入位置
+ * @return 实际写入的字节数，失败返回负数
+ */
+[[nodiscard]] auto sys_pwrite64(int fd, const char* buf, size_t len,
+                                int64_t offset) -> int;
+
+/**
+ * @brief 分散读：依次填满多个缓冲区
+ * @param fd 文件描述符
+ * @param iov 缓冲区数组
+ * @param iovcnt 缓冲区个数，最大 kIovMax
+ * @return 实际读取的总字节数，失败返回负数
+ * @details 多个小缓冲区合并为一次文件读取，不必逐个陷入或 seek
+ */
+[[nodiscard]] auto sys_readv(int fd, const UserIoVec* iov, int iovcnt) -> int;
+
+/**
+ * @brief 聚集写：依次写出多个缓冲区
+ * @param fd 文件描述符
+ * @param iov 缓冲区数组
+ * @param iovcnt 缓冲区个数，最大 kIovMax
+ * @return 实际写入的总字节数，失败返回负数
+ * @details 多个小缓冲区合并为一次文件写入，写入内容在文件中连续
+ */
+[[nodiscard]] auto sys_writev(int fd, const UserIoVec* iov, int iovcnt)
+    -> int;
+
 /**
  * @brief 退出当前进程或线程
  * @param code 退出码
@@ -177,3 +343,45 @@ auto sys_exit(int code) -> int;
  */
 [[nodiscard]] auto sys_sched_setaffinity(int pid, size_t cpusetsize,
                                          const uint64_t* mask) -> int;
+
+/**
+ * @brief 设置线程的调度策略与参数
+ * @param pid 线程ID（0 表示当前线程）
+ * @param attr 调度属性
+ * @param flags 保留，必须为 0
+ * @return 成功返回 0，失败返回负数
+ * @note 使用场景：
+ *       - 周期性控制回路 (kSchedDeadline，带宽准入失败时返回错误)
+ *       - 实时任务调度 (kSchedFifo/kSchedRr)
+ */
+[[nodiscard]] auto sys_sched_setattr(int pid, const UserSchedAttr* attr,
+                                     uint32_t flags) -> int;
+
+/**
+ * @brief 为当前任务创建批量系统调用环
+ * @param entries 期望的 SQ 表项数 (向上取整为 2 的幂，最大
+ * SyscallRing::kMaxEntries)
+ * @param params 映射地址与返回的环参数
+ * @return 成功返回 0，参数非法、已存在环或映射失败返回负数
+ * @note 使用场景：
+ *       - 大量小的 write/yield 等调用，一次陷入提交多个请求
+ * @details 共享区布局见 SyscallRingHeader，每个任务最多一个环，
+ *          任务退出时释放，clone 不继承
+ */
+[[nodiscard]] auto sys_ring_setup(uint32_t entries, SyscallRingParams* params)
+    -> int;
+
+/**
+ * @brief 执行系统调用环中的请求
+ * @param to_submit 最多执行的提交表项数
+ * @param min_complete 返回前 CQ 中至少要有的完成表项数，没有未完成的
+ * 请求时不再等待
+ * @return 成功返回实际取出的提交表项数，没有环时返回负数
+ * @details 每个表项的 opcode 为系统调用号，结果按 user_data 写入 CQ。
+ *          按扇区对齐且位于文件中一段连续数据内的 pread64 直接提交给
+ *          块设备，由设备完成时写入结果，其余请求同步执行。
+ *          exit/clone/fork 以及环本身的调用依赖陷入上下文，
+ *          不能通过环提交，其结果为 -1
+ */
+[[nodiscard]] auto sys_ring_enter(uint32_t to_submit, uint32_t min_complete)
+    -> int;
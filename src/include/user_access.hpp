@@ -0,0 +1,61 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "expected.hpp"
+
+/**
+ * @brief 异常修复表项，由 user_copy.S 写入 __ex_table 段
+ */
+struct ExceptionTableEntry {
+  /// 可能缺页的访存指令地址
+  uint64_t insn;
+  /// 缺页时跳转的地址
+  uint64_t fixup;
+};
+
+/**
+ * @brief 查找访存指令对应的修复地址
+ * @param pc 触发异常的指令地址
+ * @return uint64_t 修复地址，不在修复表中时返回 0
+ * @note 由各架构的缺页处理函数调用，命中时将返回地址改为修复地址，
+ * 访问用户内存的缺页因此变为错误返回而不是内核崩溃
+ */
+[[nodiscard]] auto SearchExceptionTable(uint64_t pc) -> uint64_t;
+
+/**
+ * @brief 从用户内存拷贝到内核
+ * @param dst 内核目的地址
+ * @param user_src 用户源地址
+ * @param len 字节数
+ * @return Expected<void> 地址非法或访问缺页时返回 kBadAddress
+ */
+[[nodiscard]] auto CopyFromUser(void* dst, const void* user_src, size_t len)
+    -> Expected<void>;
+
+/**
+ * @brief 从内核拷贝到用户内存
+ * @param user_dst 用户目的地址
+ * @param src 内核源地址
+ * @param len 字节数
+ * @return Expected<void> 地址非法或访问缺页时返回 kBadAddress
+ */
+[[nodiscard]] auto CopyToUser(void* user_dst, const void* src, size_t len)
+    -> Expected<void>;
+
+/**
+ * @brief 从用户内存拷贝以 '\0' 结尾的字符串
+ * @param dst 内核目的缓冲区，结果总是以 '\0' 结尾
+ * @param user_src 用户字符串地址
+ * @param size dst 的大小
+ * @return Expected<size_t> 字符串长度 (不含 '\0')；
+ * 地址非法或访问缺页时返回 kBadAddress，字符串过长时返回 kInvalidArgument
+ * @note 按页拷贝，不会读取字符串所在页之后的页
+ */
+[[nodiscard]] auto StrnCpyFromUser(char* dst, const char* user_src,
+                                   size_t size) -> Expected<size_t>;
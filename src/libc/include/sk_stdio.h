@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -11,6 +13,9 @@ extern "C" {
 // 底层字符输出原语，由各架构的 early_console.cpp 实现
 void etl_putchar(int c);
 
+// 整块输出，由各架构的 early_console.cpp 实现
+void console_write(const char* buf, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
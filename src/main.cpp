@@ -157,11 +157,17 @@ auto main(int argc, const char** argv) -> int {
   InterruptInit(argc, argv);
   // 设备管理器初始化
   DeviceInit();
+  // 设备中断初始化
+  DeviceInterruptInit();
   // 文件系统初始化
   FileSystemInit();
   // 初始化任务管理器 (设置主线程)
   TaskManagerSingleton::create();
   TaskManagerSingleton::instance().InitCurrentCore();
+  // 启动设备后台任务
+  DeviceStartTasks();
+  // 启动文件系统后台任务
+  FileSystemStartTasks();
 
   // 唤醒其余 core
   WakeUpOtherCores();
@@ -84,6 +84,18 @@ class VirtualMemory {
   [[nodiscard]] auto GetMapping(void* page_dir, void* virtual_addr)
       -> Expected<void*>;
 
+  /**
+   * @brief 检查地址范围内的每一页是否都映射为用户可访问
+   * @param page_dir 页表目录
+   * @param virtual_addr 起始虚拟地址
+   * @param size 字节数
+   * @param writable 是否要求用户可写
+   * @return bool 所有页都有效且带有用户访问权限 (writable 时还要求可写)
+   * 时返回 true
+   */
+  [[nodiscard]] auto IsUserAccessible(void* page_dir, const void* virtual_addr,
+                                      size_t size, bool writable) -> bool;
+
   /**
    * @brief 回收页表，释放所有映射和子页表
    * @param page_dir 要回收的页表目录
@@ -157,6 +157,51 @@ auto VirtualMemory::GetMapping(void* page_dir, void* virtual_addr)
       cpu_io::virtual_memory::PageTableEntryToPhysical(*pte));
 }
 
+auto VirtualMemory::IsUserAccessible(void* page_dir, const void* virtual_addr,
+                                     size_t size, bool writable) -> bool {
+  assert(page_dir != nullptr && "IsUserAccessible: page_dir is null");
+
+  auto start = reinterpret_cast<uint64_t>(virtual_addr);
+  if (start + size < start) {
+    return false;
+  }
+
+  // 各架构表示用户权限与只读的位不同，由权限组合之差得到
+  auto user_bits =
+      cpu_io::virtual_memory::GetUserPagePermissions(false, false, false) &
+      ~cpu_io::virtual_memory::GetKernelPagePermissions(false, false, false);
+  auto read_write =
+      cpu_io::virtual_memory::GetUserPagePermissions(true, true, false);
+  auto read_only =
+      cpu_io::virtual_memory::GetUserPagePermissions(true, false, false);
+  uint64_t required = user_bits;
+  uint64_t forbidden = 0;
+  if (writable) {
+    required |= read_write & ~read_only;
+    forbidden = read_only & ~read_write;
+  }
+
+  auto end = start + size;
+  for (auto page = cpu_io::virtual_memory::PageAlign(start); page < end;
+       page += cpu_io::virtual_memory::kPageSize) {
+    auto pte_result =
+        FindPageTableEntry(page_dir, reinterpret_cast<void*>(page), false);
+    if (!pte_result.has_value()) {
+      return false;
+    }
+    auto pte = *pte_result.value();
+    if (!cpu_io::virtual_memory::IsPageTableEntryValid(pte) ||
+        (pte & required) != required || (pte & forbidden) != 0) {
+      return false;
+    }
+    // 最后一页时避免 page 回绕
+    if (end - page <= cpu_io::virtual_memory::kPageSize) {
+      break;
+    }
+  }
+  return true;
+}
+
 auto VirtualMemory::DestroyPageDirectory(void* page_dir, bool free_pages)
     -> void {
   if (page_dir == nullptr) {
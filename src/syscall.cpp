@@ -4,18 +4,466 @@
 
 #include "syscall.hpp"
 
+#include <cpu_io.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <climits>
+
+#include "block_device.hpp"
+#include "deadline_scheduler.hpp"
+#include "file_descriptor.hpp"
 #include "kernel.h"
 #include "kernel_log.hpp"
+#include "kstd_memory"
+#include "sk_stdio.h"
+#include "syscall_ring.hpp"
 #include "task_manager.hpp"
+#include "user_access.hpp"
+#include "vdso.hpp"
+#include "vfs.hpp"
+#include "virtual_memory.hpp"
+
+namespace {
+
+/// 文件读写经内核中转的最大块大小，每块只调用一次文件系统
+constexpr size_t kIoChunkSize = 4 * cpu_io::virtual_memory::kPageSize;
+
+/// 控制台输出经内核栈中转的块大小
+constexpr size_t kConsoleChunkSize = 512;
+
+/// 单次读写的最大字节数，保证结果可以用 int 返回
+constexpr size_t kMaxIoCount = INT_MAX;
+
+/// 系统调用环中异步 pread 拆分出的最大块请求数 (每页一个)，超出时同步执行
+constexpr size_t kRingReadMaxRequests = 16;
+
+/// 路径的最大长度 (含 '\0')
+constexpr size_t kPathMax = 512;
+
+/// openat 支持的打开标志
+constexpr uint32_t kOpenFlagsMask =
+    static_cast<uint32_t>(vfs::OpenFlags::kOWriteOnly) |
+    static_cast<uint32_t>(vfs::OpenFlags::kOReadWrite) |
+    static_cast<uint32_t>(vfs::OpenFlags::kOCreate) |
+    static_cast<uint32_t>(vfs::OpenFlags::kOTruncate) |
+    static_cast<uint32_t>(vfs::OpenFlags::kOAppend) |
+    static_cast<uint32_t>(vfs::OpenFlags::kODirectory);
+
+/**
+ * @brief 获取当前任务 fd 对应的 File 并持有一个引用
+ * @param fd 文件描述符
+ * @return vfs::File* 无效 fd 返回 nullptr，使用完毕后调用 vfs::Close 释放
+ */
+auto AcquireFile(int fd) -> vfs::File* {
+  auto* current = TaskManagerSingleton::instance().GetCurrentTask();
+  if (!current || !current->fd_table) {
+    return nullptr;
+  }
+  return current->fd_table->Acquire(fd);
+}
+
+/**
+ * @brief 释放 AcquireFile 获取的引用
+ * @param file 文件对象
+ */
+auto ReleaseFile(vfs::File* file) -> void {
+  vfs::Close(file).or_else([](auto&& err) {
+    klog::Warn("[Syscall] failed to release file: {}", err.message());
+    return Expected<void>{};
+  });
+}
+
+/**
+ * @brief 在 iovec 数组中顺序推进的拷贝位置
+ */
+struct IoVecCursor {
+  /// 内核中的 iovec 副本
+  const UserIoVec* iov;
+  /// 当前段
+  int index;
+  /// 当前段内已拷贝的字节数
+  size_t offset;
+};
+
+/**
+ * @brief 在 iovec 描述的用户缓冲区与内核块之间拷贝
+ * @param cursor 拷贝位置，完成后向后推进 len 字节
+ * @param chunk 内核块
+ * @param len 字节数，不超过 iovec 剩余的总长度
+ * @param to_user true 表示从 chunk 拷贝到用户缓冲区
+ * @return bool 用户缓冲区非法时返回 false
+ */
+auto CopyIoVec(IoVecCursor& cursor, char* chunk, size_t len, bool to_user)
+    -> bool {
+  size_t copied = 0;
+  while (copied < len) {
+    const auto& seg = cursor.iov[cursor.index];
+    auto size = std::min(len - copied, seg.len - cursor.offset);
+    auto* user = static_cast<char*>(seg.base) + cursor.offset;
+    auto result = to_user ? CopyToUser(user, chunk + copied, size)
+                          : CopyFromUser(chunk + copied, user, size);
+    if (!result) {
+      return false;
+    }
+    copied += size;
+    cursor.offset += size;
+    if (cursor.offset == seg.len) {
+      ++cursor.index;
+      cursor.offset = 0;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 计算 iovec 的总长度
+ * @param iov 内核中的 iovec 副本
+ * @param iovcnt 段数
+ * @param total 输出总长度
+ * @return bool 总长度超过 kMaxIoCount 时返回 false
+ */
+auto IoVecLength(const UserIoVec* iov, int iovcnt, size_t& total) -> bool {
+  total = 0;
+  for (int i = 0; i < iovcnt; ++i) {
+    if (iov[i].len > kMaxIoCount - total) {
+      return false;
+    }
+    total += iov[i].len;
+  }
+  return true;
+}
+
+/**
+ * @brief 分配文件读写的中转缓冲区
+ * @param total 本次读写的总字节数
+ * @param size 输出缓冲区大小，不超过 kIoChunkSize
+ * @return etl::unique_ptr<char[]> 分配失败时为空
+ * @note 内核栈只有 kDefaultKernelStackSize，按页中转的缓冲区从堆上分配
+ */
+auto AllocateIoChunk(size_t total, size_t& size) -> etl::unique_ptr<char[]> {
+  size = std::min(total, kIoChunkSize);
+  return etl::unique_ptr<char[]>(new char[size]);
+}
+
+/**
+ * @brief 从文件读取到 iovec 描述的用户缓冲区
+ * @param file 文件对象
+ * @param iov 内核中的 iovec 副本
+ * @param iovcnt 段数
+ * @param pos 读取位置，小于 0 时使用并推进文件偏移量
+ * @return int 实际读取的总字节数，没有读到任何数据就出错时返回 -1
+ * @details 按 kIoChunkSize 中转，每块只调用一次文件系统，
+ *          多个小缓冲区因此合并为一次读取。FileOps 只读写内核缓冲区，
+ *          用户内存需经 CopyToUser 访问，因此不把 iovec 直接交给文件系统
+ * @note 块拷贝到用户缓冲区失败时把文件偏移量退回该块之前，偏移量与返回的
+ *       字节数保持一致，未返回的数据不会丢失
+ */
+auto ReadToIoVec(vfs::File* file, const UserIoVec* iov, int iovcnt,
+                 int64_t pos) -> int {
+  size_t total = 0;
+  if (!IoVecLength(iov, iovcnt, total)) {
+    return -1;
+  }
+
+  if (total == 0) {
+    return 0;
+  }
+  size_t chunk_size = 0;
+  auto chunk = AllocateIoChunk(total, chunk_size);
+  if (!chunk) {
+    return -1;
+  }
+
+  IoVecCursor cursor{iov, 0, 0};
+  size_t done = 0;
+  while (done < total) {
+    auto size = std::min(total - done, chunk_size);
+    auto result = pos < 0 ? vfs::Read(file, chunk.get(), size)
+                          : vfs::PRead(file, chunk.get(), size,
+                                       static_cast<uint64_t>(pos) + done);
+    if (!result) {
+      return done == 0 ? -1 : static_cast<int>(done);
+    }
+    if (!CopyIoVec(cursor, chunk.get(), *result, true)) {
+      if (pos < 0) {
+        vfs::Seek(file, -static_cast<int64_t>(*result), vfs::SeekWhence::kCur)
+            .or_else([](auto&& err) {
+              klog::Warn("[Syscall] failed to rewind file: {}",
+                         err.message());
+              return Expected<uint64_t>{};
+            });
+      }
+      return done == 0 ? -1 : static_cast<int>(done);
+    }
+    done += *result;
+    if (*result < size) {
+      break;
+    }
+  }
+  return static_cast<int>(done);
+}
+
+/**
+ * @brief 将 iovec 描述的用户缓冲区写入文件
+ * @param file 文件对象
+ * @param iov 内核中的 iovec 副本
+ * @param iovcnt 段数
+ * @param pos 写入位置，小于 0 时使用并推进文件偏移量
+ * @return int 实际写入的总字节数，没有写入任何数据就出错时返回 -1
+ */
+auto WriteFromIoVec(vfs::File* file, const UserIoVec* iov, int iovcnt,
+                    int64_t pos) -> int {
+  size_t total = 0;
+  if (!IoVecLength(iov, iovcnt, total)) {
+    return -1;
+  }
+
+  if (total == 0) {
+    return 0;
+  }
+  size_t chunk_size = 0;
+  auto chunk = AllocateIoChunk(total, chunk_size);
+  if (!chunk) {
+    return -1;
+  }
+
+  IoVecCursor cursor{iov, 0, 0};
+  size_t done = 0;
+  while (done < total) {
+    auto size = std::min(total - done, chunk_size);
+    if (!CopyIoVec(cursor, chunk.get(), size, false)) {
+      return done == 0 ? -1 : static_cast<int>(done);
+    }
+    auto result = pos < 0 ? vfs::Write(file, chunk.get(), size)
+                          : vfs::PWrite(file, chunk.get(), size,
+                                        static_cast<uint64_t>(pos) + done);
+    if (!result) {
+      return done == 0 ? -1 : static_cast<int>(done);
+    }
+    done += *result;
+    if (*result < size) {
+      break;
+    }
+  }
+  return static_cast<int>(done);
+}
+
+/**
+ * @brief 系统调用环中一次直接提交给块设备的 pread
+ * @note 最后一个完成的请求写入完成表项并释放本对象
+ */
+struct RingRead {
+  /// 所属的系统调用环
+  SyscallRing* ring;
+  /// 提交表项的 user_data
+  uint64_t user_data;
+  /// 全部成功时的返回值
+  int64_t bytes;
+  /// 尚未完成的请求数
+  std::atomic<uint32_t> pending;
+  /// 第一个失败请求的状态
+  std::atomic<ErrorCode> status;
+  /// 按用户页拆分的块请求
+  std::array<vfs::BlockRequest, kRingReadMaxRequests> requests;
+};
+
+/**
+ * @brief RingRead 中块请求的完成回调
+ * @param request 完成的请求
+ */
+auto EndRingRead(vfs::BlockRequest* request) -> void {
+  auto* read = static_cast<RingRead*>(request->private_data);
+  if (request->status != ErrorCode::kSuccess) {
+    auto expected = ErrorCode::kSuccess;
+    read->status.compare_exchange_strong(expected, request->status,
+                                         std::memory_order_relaxed);
+  }
+  if (read->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    auto ok = read->status.load(std::memory_order_relaxed) ==
+              ErrorCode::kSuccess;
+    read->ring->PostAsyncCompletion(read->user_data, ok ? read->bytes : -1);
+    delete read;
+  }
+}
+
+/**
+ * @brief 把系统调用环中的 pread 直接提交给块设备
+ * @param ring 当前任务的系统调用环
+ * @param sqe 提交表项，参数同 sys_pread64
+ * @return bool 已提交，完成表项由请求的 end_io 写入；返回 false 时由
+ * 调用者同步执行
+ * @note 只处理按扇区对齐、完整位于文件中一段连续数据内的读取。用户缓冲区
+ * 逐页换算为物理地址 (内核恒等映射) 作为请求的缓冲区，设备直接写入用户页；
+ * 完成表项写入前用户不得解除缓冲区的映射，任务退出时 SyscallRing 的
+ * 析构函数等待请求完成后才释放页表
+ */
+auto SubmitRingRead(SyscallRing* ring, const SyscallSqe& sqe) -> bool {
+  constexpr size_t kPageSize = cpu_io::virtual_memory::kPageSize;
+  auto addr = static_cast<uintptr_t>(sqe.args[1]);
+  auto len = static_cast<size_t>(sqe.args[2]);
+  auto offset = static_cast<int64_t>(sqe.args[3]);
+  if (addr == 0 || len == 0 || len > kRingReadMaxRequests * kPageSize ||
+      offset < 0) {
+    return false;
+  }
+
+  auto* file = AcquireFile(static_cast<int>(sqe.args[0]));
+  if (!file) {
+    return false;
+  }
+  auto extent = vfs::MapExtent(file, static_cast<uint64_t>(offset), len);
+  ReleaseFile(file);
+  // 读到文件末尾或跨越不连续的数据时需要文件系统处理
+  if (!extent.has_value() || extent->bytes < len) {
+    return false;
+  }
+  auto* device = extent->device;
+  auto sector_size = device->GetSectorSize();
+  if (static_cast<uint64_t>(offset) % sector_size != 0 ||
+      len % sector_size != 0 || addr % sector_size != 0) {
+    return false;
+  }
+
+  // 内核线程没有用户页表，缓冲区即内核地址
+  auto* page_table =
+      TaskManagerSingleton::instance().GetCurrentTask()->page_table;
+  auto& vm = VirtualMemorySingleton::instance();
+  if (page_table &&
+      (addr + len < addr || addr + len > kVvarUserAddr ||
+       !vm.IsUserAccessible(page_table, reinterpret_cast<void*>(addr), len,
+                            true))) {
+    return false;
+  }
+
+  auto read = kstd::make_unique<RingRead>();
+  if (!read) {
+    return false;
+  }
+  size_t count = 0;
+  for (size_t done = 0; done < len; ++count) {
+    if (count == read->requests.size()) {
+      return false;
+    }
+    auto user = addr + done;
+    auto chunk = std::min(len - done, kPageSize - user % kPageSize);
+    auto* buffer = reinterpret_cast<uint8_t*>(user);
+    if (page_table) {
+      auto page = vm.GetMapping(
+          page_table, reinterpret_cast<void*>(
+                          cpu_io::virtual_memory::PageAlign(user)));
+      if (!page.has_value()) {
+        return false;
+      }
+      buffer = static_cast<uint8_t*>(page.value()) + user % kPageSize;
+    }
+    read->requests[count] = vfs::BlockRequest{
+        .op = vfs::BlockOp::kRead,
+        .sector = extent->sector + done / sector_size,
+        .sector_count = static_cast<uint32_t>(chunk / sector_size),
+        .buffer = buffer,
+        .end_io = EndRingRead,
+        .private_data = read.get(),
+    };
+    done += chunk;
+  }
+
+  if (!ring->BeginAsync(device)) {
+    return false;
+  }
+  read->ring = ring;
+  read->user_data = sqe.user_data;
+  read->bytes = static_cast<int64_t>(len);
+  read->pending.store(static_cast<uint32_t>(count), std::memory_order_relaxed);
+  read->status.store(ErrorCode::kSuccess, std::memory_order_relaxed);
+
+  // 最后一个请求完成后 RingRead 即被释放，之后不再访问已结束的请求
+  auto* requests = read.release()->requests.data();
+  size_t submitted = 0;
+  ErrorCode submit_status = ErrorCode::kSuccess;
+  {
+    vfs::BlockPlug plug(device);
+    for (; submitted < count; ++submitted) {
+      auto submit_result = device->Submit(&requests[submitted]);
+      if (!submit_result.has_value()) {
+        submit_status = submit_result.error().code;
+        break;
+      }
+    }
+  }
+  // 未提交的请求不会完成，由 EndRingRead 代为结束
+  for (size_t i = submitted; i < count; ++i) {
+    requests[i].status = submit_status;
+    EndRingRead(&requests[i]);
+  }
+  return true;
+}
+
+/**
+ * @brief 将用户的 iovec 数组拷贝到内核
+ * @param dst 内核缓冲区，至少 kIovMax 项
+ * @param iov 用户 iovec 数组
+ * @param iovcnt 段数
+ * @return bool 段数非法或用户地址非法时返回 false
+ */
+auto CopyIoVecFromUser(UserIoVec* dst, const UserIoVec* iov, int iovcnt)
+    -> bool {
+  if (iovcnt < 0 || iovcnt > kIovMax) {
+    return false;
+  }
+  return CopyFromUser(dst, iov, sizeof(UserIoVec) * iovcnt).has_value();
+}
+
+}  // namespace
 
 auto syscall_dispatcher(int64_t syscall_id, uint64_t args[6]) -> int {
   int64_t ret = 0;
   switch (syscall_id) {
+    case kSyscallOpenat:
+      ret = sys_openat(static_cast<int>(args[0]),
+                       reinterpret_cast<const char*>(args[1]),
+                       static_cast<int>(args[2]), static_cast<int>(args[3]));
+      break;
+    case kSyscallClose:
+      ret = sys_close(static_cast<int>(args[0]));
+      break;
+    case kSyscallLseek:
+      ret = sys_lseek(static_cast<int>(args[0]), static_cast<int64_t>(args[1]),
+                      static_cast<int>(args[2]));
+      break;
+    case kSyscallRead:
+      ret = sys_read(static_cast<int>(args[0]),
+                     reinterpret_cast<char*>(args[1]),
+                     static_cast<size_t>(args[2]));
+      break;
     case kSyscallWrite:
       ret = sys_write(static_cast<int>(args[0]),
                       reinterpret_cast<const char*>(args[1]),
                       static_cast<size_t>(args[2]));
       break;
+    case kSyscallPread64:
+      ret = sys_pread64(static_cast<int>(args[0]),
+                        reinterpret_cast<char*>(args[1]),
+                        static_cast<size_t>(args[2]),
+                        static_cast<int64_t>(args[3]));
+      break;
+    case kSyscallPwrite64:
+      ret = sys_pwrite64(static_cast<int>(args[0]),
+                         reinterpret_cast<const char*>(args[1]),
+                         static_cast<size_t>(args[2]),
+                         static_cast<int64_t>(args[3]));
+      break;
+    case kSyscallReadv:
+      ret = sys_readv(static_cast<int>(args[0]),
+                      reinterpret_cast<const UserIoVec*>(args[1]),
+                      static_cast<int>(args[2]));
+      break;
+    case kSyscallWritev:
+      ret = sys_writev(static_cast<int>(args[0]),
+                       reinterpret_cast<const UserIoVec*>(args[1]),
+                       static_cast<int>(args[2]));
+      break;
     case kSyscallExit:
       ret = sys_exit(static_cast<int>(args[0]));
       break;
@@ -43,6 +491,19 @@ auto syscall_dispatcher(int64_t syscall_id, uint64_t args[6]) -> int {
           static_cast<int>(args[2]), reinterpret_cast<const void*>(args[3]),
           reinterpret_cast<int*>(args[4]), static_cast<int>(args[5]));
       break;
+    case kSyscallSchedSetattr:
+      ret = sys_sched_setattr(static_cast<int>(args[0]),
+                              reinterpret_cast<const UserSchedAttr*>(args[1]),
+                              static_cast<uint32_t>(args[2]));
+      break;
+    case kSyscallRingSetup:
+      ret = sys_ring_setup(static_cast<uint32_t>(args[0]),
+                           reinterpret_cast<SyscallRingParams*>(args[1]));
+      break;
+    case kSyscallRingEnter:
+      ret = sys_ring_enter(static_cast<uint32_t>(args[0]),
+                           static_cast<uint32_t>(args[1]));
+      break;
     default:
       klog::Err("[Syscall] Unknown syscall id: {}", syscall_id);
       ret = -1;
@@ -51,16 +512,168 @@ auto syscall_dispatcher(int64_t syscall_id, uint64_t args[6]) -> int {
   return ret;
 }
 
+[[nodiscard]] auto sys_openat(int dirfd, const char* pathname, int flags,
+                              [[maybe_unused]] int mode) -> int {
+  auto* current = TaskManagerSingleton::instance().GetCurrentTask();
+  if (!current) {
+    return -1;
+  }
+
+  // 没有工作目录，相对 kAtFdCwd 的路径按根目录解析
+  char path[kPathMax];
+  path[0] = '/';
+  auto len = StrnCpyFromUser(path + 1, pathname, sizeof(path) - 1);
+  if (!len || *len == 0) {
+    return -1;
+  }
+  const char* abs_path = path[1] == '/' ? path + 1 : path;
+  if (abs_path == path && dirfd != kAtFdCwd) {
+    klog::Err("[Syscall] sys_openat: dirfd {} not supported", dirfd);
+    return -1;
+  }
+
+  auto* fd_table = current->GetFdTable();
+  if (!fd_table) {
+    return -1;
+  }
+
+  auto open_flags = static_cast<vfs::OpenFlags>(static_cast<uint32_t>(flags) &
+                                                kOpenFlagsMask);
+  auto file = vfs::Open(abs_path, open_flags);
+  if (!file) {
+    klog::Debug("[Syscall] sys_openat: open {} failed: {}", abs_path,
+                file.error().message());
+    return -1;
+  }
+
+  auto fd = fd_table->Alloc(*file);
+  if (!fd) {
+    ReleaseFile(*file);
+    return -1;
+  }
+  return *fd;
+}
+
+[[nodiscard]] auto sys_close(int fd) -> int {
+  auto* current = TaskManagerSingleton::instance().GetCurrentTask();
+  if (!current || !current->fd_table) {
+    return -1;
+  }
+  return current->fd_table->Close(fd).has_value() ? 0 : -1;
+}
+
+[[nodiscard]] auto sys_lseek(int fd, int64_t offset, int whence) -> int64_t {
+  if (whence < static_cast<int>(vfs::SeekWhence::kSet) ||
+      whence > static_cast<int>(vfs::SeekWhence::kEnd)) {
+    return -1;
+  }
+
+  auto* file = AcquireFile(fd);
+  if (!file) {
+    return -1;
+  }
+  auto result = vfs::Seek(file, offset, static_cast<vfs::SeekWhence>(whence));
+  ReleaseFile(file);
+  return result ? static_cast<int64_t>(*result) : -1;
+}
+
+[[nodiscard]] auto sys_read(int fd, char* buf, size_t len) -> int {
+  auto* file = AcquireFile(fd);
+  if (!file) {
+    return -1;
+  }
+  UserIoVec iov{buf, std::min(len, kMaxIoCount)};
+  auto ret = ReadToIoVec(file, &iov, 1, -1);
+  ReleaseFile(file);
+  return ret;
+}
+
 [[nodiscard]] auto sys_write(int fd, const char* buf, size_t len) -> int {
-  // 简单实现：仅支持向标准输出(1)和错误输出(2)打印
-  if (fd == 1 || fd == 2) {
-    /// @todo应该检查 buf 是否在用户空间合法范围内
-    for (size_t i = 0; i < len; ++i) {
-      etl_putchar(buf[i]);
+  // 关联了文件的 fd 写入文件
+  if (auto* file = AcquireFile(fd)) {
+    UserIoVec iov{const_cast<char*>(buf), std::min(len, kMaxIoCount)};
+    auto ret = WriteFromIoVec(file, &iov, 1, -1);
+    ReleaseFile(file);
+    return ret;
+  }
+
+  // 否则仅支持向标准输出(1)和错误输出(2)打印
+  if (fd != 1 && fd != 2) {
+    return -1;
+  }
+
+  // 按块拷贝到内核后整块交给控制台，用户缓冲区非法时返回错误而不是崩溃
+  len = std::min(len, kMaxIoCount);
+  char chunk[kConsoleChunkSize];
+  size_t written = 0;
+  while (written < len) {
+    auto size = std::min(len - written, kConsoleChunkSize);
+    if (!CopyFromUser(chunk, buf + written, size)) {
+      return written == 0 ? -1 : static_cast<int>(written);
     }
-    return static_cast<int>(len);
+    console_write(chunk, size);
+    written += size;
   }
-  return -1;
+  return static_cast<int>(len);
+}
+
+[[nodiscard]] auto sys_pread64(int fd, char* buf, size_t len, int64_t offset)
+    -> int {
+  if (offset < 0) {
+    return -1;
+  }
+  auto* file = AcquireFile(fd);
+  if (!file) {
+    return -1;
+  }
+  UserIoVec iov{buf, std::min(len, kMaxIoCount)};
+  auto ret = ReadToIoVec(file, &iov, 1, offset);
+  ReleaseFile(file);
+  return ret;
+}
+
+[[nodiscard]] auto sys_pwrite64(int fd, const char* buf, size_t len,
+                                int64_t offset) -> int {
+  if (offset < 0) {
+    return -1;
+  }
+  auto* file = AcquireFile(fd);
+  if (!file) {
+    return -1;
+  }
+  UserIoVec iov{const_cast<char*>(buf), std::min(len, kMaxIoCount)};
+  auto ret = WriteFromIoVec(file, &iov, 1, offset);
+  ReleaseFile(file);
+  return ret;
+}
+
+[[nodiscard]] auto sys_readv(int fd, const UserIoVec* iov, int iovcnt) -> int {
+  UserIoVec kernel_iov[kIovMax];
+  if (!CopyIoVecFromUser(kernel_iov, iov, iovcnt)) {
+    return -1;
+  }
+  auto* file = AcquireFile(fd);
+  if (!file) {
+    return -1;
+  }
+  auto ret = ReadToIoVec(file, kernel_iov, iovcnt, -1);
+  ReleaseFile(file);
+  return ret;
+}
+
+[[nodiscard]] auto sys_writev(int fd, const UserIoVec* iov, int iovcnt)
+    -> int {
+  UserIoVec kernel_iov[kIovMax];
+  if (!CopyIoVecFromUser(kernel_iov, iov, iovcnt)) {
+    return -1;
+  }
+  auto* file = AcquireFile(fd);
+  if (!file) {
+    return -1;
+  }
+  auto ret = WriteFromIoVec(file, kernel_iov, iovcnt, -1);
+  ReleaseFile(file);
+  return ret;
 }
 
 auto sys_exit(int code) -> int {
@@ -190,7 +803,11 @@ auto sys_exit(int code) -> int {
                   val);
 
       // 简化实现：直接检查值并阻塞
-      if (*uaddr == val) {
+      int current_val = 0;
+      if (!CopyFromUser(&current_val, uaddr, sizeof(current_val))) {
+        return -1;
+      }
+      if (current_val == val) {
         // 使用 Futex 类型的资源 ID，地址作为标识
         ResourceId futex_id(ResourceType::kFutex,
                             reinterpret_cast<uintptr_t>(uaddr));
@@ -253,7 +870,10 @@ auto sys_exit(int code) -> int {
     return -1;
   }
 
-  *mask = target->cpu_affinity;
+  uint64_t affinity = target->cpu_affinity;
+  if (!CopyToUser(mask, &affinity, sizeof(affinity))) {
+    return -1;
+  }
   return 0;
 }
 
@@ -282,12 +902,186 @@ auto sys_exit(int code) -> int {
     return -1;
   }
 
-  target->cpu_affinity = *mask;
+  uint64_t affinity = 0;
+  if (!CopyFromUser(&affinity, mask, sizeof(affinity))) {
+    return -1;
+  }
+
+  // 不再允许的核心上的任务会被迁移到允许的核心
+  auto result = task_manager.SetAffinity(target, CpuAffinity(affinity));
+  if (!result) {
+    klog::Err("[Syscall] sys_sched_setaffinity: {}", result.error().message());
+    return -1;
+  }
 
   klog::Debug("[Syscall] Set CPU affinity for task {} to {:#x}", target->pid,
-              *mask);
+              affinity);
 
-  /// @todo 如果当前任务不在允许的 CPU 上运行，应该触发迁移
+  return 0;
+}
+
+[[nodiscard]] auto sys_sched_setattr(int pid, const UserSchedAttr* attr,
+                                     uint32_t flags) -> int {
+  if (flags != 0) {
+    return -1;
+  }
+
+  UserSchedAttr user_attr{};
+  if (!CopyFromUser(&user_attr, attr, sizeof(user_attr))) {
+    return -1;
+  }
+
+  auto& task_manager = TaskManagerSingleton::instance();
+
+  TaskControlBlock* target;
+  if (pid == 0) {
+    target = task_manager.GetCurrentTask();
+  } else {
+    // 查找指定 PID 的任务
+    target = task_manager.FindTask(static_cast<Pid>(pid));
+    if (!target) {
+      klog::Err("[Syscall] sys_sched_setattr: Task {} not found", pid);
+      return -1;
+    }
+  }
+
+  if (!target) {
+    return -1;
+  }
+
+  // 纳秒转换为 tick (向上取整，保证预算不为 0)；先拆分整秒避免乘法溢出，
+  // 结果饱和到 DeadlineScheduler::kMaxTicks
+  static constexpr uint64_t kNanosecondsPerSecond = 1000000000;
+  auto ns_to_ticks = [](uint64_t ns) -> uint64_t {
+    uint64_t seconds = ns / kNanosecondsPerSecond;
+    if (seconds > DeadlineScheduler::kMaxTicks / SIMPLEKERNEL_TICK) {
+      return DeadlineScheduler::kMaxTicks;
+    }
+    uint64_t ticks = seconds * SIMPLEKERNEL_TICK +
+                     ((ns % kNanosecondsPerSecond) * SIMPLEKERNEL_TICK +
+                      kNanosecondsPerSecond - 1) /
+                         kNanosecondsPerSecond;
+    return std::min(ticks, DeadlineScheduler::kMaxTicks);
+  };
+
+  SchedAttr sched_attr{};
+  switch (user_attr.sched_policy) {
+    case kSchedDeadline:
+      sched_attr.policy = SchedPolicy::kDeadline;
+      sched_attr.runtime = ns_to_ticks(user_attr.sched_runtime);
+      sched_attr.deadline = ns_to_ticks(user_attr.sched_deadline);
+      sched_attr.period = ns_to_ticks(user_attr.sched_period);
+      break;
+    case kSchedFifo:
+    case kSchedRr:
+      if (user_attr.sched_priority < 1 || user_attr.sched_priority > 99) {
+        return -1;
+      }
+      // Linux 实时优先级数值越大越高，内核优先级数值越小越高
+      sched_attr.policy = SchedPolicy::kRealTime;
+      sched_attr.priority = 99 - static_cast<int>(user_attr.sched_priority);
+      break;
+    case kSchedNormal:
+      sched_attr.policy = SchedPolicy::kNormal;
+      sched_attr.priority = std::max(0, 10 + user_attr.sched_nice);
+      break;
+    case kSchedIdle:
+      sched_attr.policy = SchedPolicy::kIdle;
+      break;
+    default:
+      klog::Err("[Syscall] sys_sched_setattr: Unknown policy {}",
+                user_attr.sched_policy);
+      return -1;
+  }
 
+  auto result = task_manager.SetSchedAttr(target, sched_attr);
+  if (!result.has_value()) {
+    klog::Err("[Syscall] sys_sched_setattr failed: {}",
+              result.error().message());
+    return -1;
+  }
+
+  klog::Debug("[Syscall] Set sched attr for task {}: policy={}", target->pid,
+              user_attr.sched_policy);
   return 0;
 }
+
+[[nodiscard]] auto sys_ring_setup(uint32_t entries, SyscallRingParams* params)
+    -> int {
+  auto* current = TaskManagerSingleton::instance().GetCurrentTask();
+  SyscallRingParams ring_params{};
+  if (!current || !CopyFromUser(&ring_params, params, sizeof(ring_params))) {
+    return -1;
+  }
+  if (current->syscall_ring) {
+    klog::Err("[Syscall] sys_ring_setup: task {} already has a ring",
+              current->pid);
+    return -1;
+  }
+
+  auto ring_ptr = kstd::make_unique<SyscallRing>(entries);
+  if (!ring_ptr || !ring_ptr->IsValid()) {
+    klog::Err("[Syscall] sys_ring_setup: failed to allocate ring");
+    return -1;
+  }
+
+  // 用户任务将共享区映射到指定地址，内核线程直接使用内核地址
+  if (current->page_table) {
+    auto result = ring_ptr->MapTo(current->page_table, ring_params.user_addr);
+    if (!result) {
+      klog::Err("[Syscall] sys_ring_setup: map to {:#x} failed: {}",
+                ring_params.user_addr, result.error().message());
+      return -1;
+    }
+  }
+
+  ring_params.ring_addr = ring_ptr->GetUserAddress();
+  ring_params.ring_size = ring_ptr->GetSize();
+  ring_params.sq_entries = ring_ptr->GetSqEntries();
+  ring_params.cq_entries = ring_ptr->GetCqEntries();
+  if (!CopyToUser(params, &ring_params, sizeof(ring_params))) {
+    return -1;
+  }
+
+  current->syscall_ring = ring_ptr.release();
+  return 0;
+}
+
+[[nodiscard]] auto sys_ring_enter(uint32_t to_submit, uint32_t min_complete)
+    -> int {
+  auto* current = TaskManagerSingleton::instance().GetCurrentTask();
+  if (!current || !current->syscall_ring) {
+    return -1;
+  }
+  auto* ring = current->syscall_ring;
+
+  int submitted = 0;
+  SyscallSqe sqe{};
+  while (static_cast<uint32_t>(submitted) < to_submit &&
+         ring->PopSubmission(sqe)) {
+    ++submitted;
+    if (sqe.opcode == kSyscallPread64 && SubmitRingRead(ring, sqe)) {
+      continue;
+    }
+    int64_t result = -1;
+    switch (sqe.opcode) {
+      // 这些调用依赖陷入上下文或会重入环，不能批量提交
+      case kSyscallExit:
+      case kSyscallClone:
+      case kSyscallFork:
+      case kSyscallRingSetup:
+      case kSyscallRingEnter:
+        klog::Warn("[Syscall] sys_ring_enter: opcode {} not allowed",
+                   sqe.opcode);
+        break;
+      default:
+        result = syscall_dispatcher(static_cast<int64_t>(sqe.opcode),
+                                    sqe.args);
+        break;
+    }
+    ring->PostCompletion(sqe.user_data, result);
+  }
+
+  ring->WaitCompletions(min_complete);
+  return submitted;
+}
@@ -2,6 +2,7 @@
  * @copyright Copyright The SimpleKernel Contributors
  */
 
+#include <algorithm>
 #include <cassert>
 
 #include "kernel_log.hpp"
@@ -9,6 +10,9 @@
 #include "task_manager.hpp"
 #include "task_messages.hpp"
 
+/// 每秒的毫秒数
+static constexpr uint64_t kMillisecondsPerSecond = 1000;
+
 auto TaskManager::Block(ResourceId resource_id) -> void {
   auto& cpu_sched = GetCurrentCpuSched();
 
@@ -46,3 +50,78 @@ auto TaskManager::Block(ResourceId resource_id) -> void {
 
   // 任务被唤醒后会从这里继续执行
 }
+
+auto TaskManager::BlockUntil(ResourceId resource_id,
+                             const std::atomic<bool>& condition,
+                             uint64_t timeout_ms) -> bool {
+  return BlockUntilReady(
+      resource_id,
+      [](const void* arg) {
+        return static_cast<const std::atomic<bool>*>(arg)->load(
+            std::memory_order_seq_cst);
+      },
+      &condition, timeout_ms);
+}
+
+auto TaskManager::BlockUntil(ResourceId resource_id,
+                             const std::atomic<uint32_t>& state, uint32_t mask,
+                             uint64_t timeout_ms) -> bool {
+  // 捕获列表为空的 lambda 才能转换为函数指针，mask 与状态字一并传入
+  struct Arg {
+    const std::atomic<uint32_t>* state;
+    uint32_t mask;
+  } arg{&state, mask};
+  return BlockUntilReady(
+      resource_id,
+      [](const void* raw) {
+        const auto* wait = static_cast<const Arg*>(raw);
+        return (wait->state->load(std::memory_order_seq_cst) & wait->mask) ==
+               0;
+      },
+      &arg, timeout_ms);
+}
+
+auto TaskManager::BlockUntilReady(ResourceId resource_id,
+                                  bool (*ready)(const void*), const void* arg,
+                                  uint64_t timeout_ms) -> bool {
+  auto& cpu_sched = GetCurrentCpuSched();
+
+  auto* current = GetCurrentTask();
+  assert(current != nullptr && "BlockUntil: No current task to block");
+  assert(current->GetStatus() == TaskStatus::kRunning &&
+         "BlockUntil: current task status must be kRunning");
+
+  {
+    LockGuard<SpinLock> lock_guard(cpu_sched.lock);
+
+    // 唤醒方设置条件后才获取调度锁，在锁内检查即可避免丢失唤醒
+    if (ready(arg)) {
+      return true;
+    }
+
+    auto& list = cpu_sched.blocked_tasks[resource_id];
+    if (list.full() ||
+        (timeout_ms != 0 && cpu_sched.timed_blocked_tasks.full())) {
+      klog::Err("BlockUntil: blocked queue full, cannot block task {}",
+                current->pid);
+      return false;
+    }
+
+    if (timeout_ms != 0) {
+      // 至少等待一个 tick
+      uint64_t timeout_ticks = std::max<uint64_t>(
+          1, (timeout_ms * SIMPLEKERNEL_TICK) / kMillisecondsPerSecond);
+      current->sched_info.wake_tick = cpu_sched.local_tick + timeout_ticks;
+      cpu_sched.timed_blocked_tasks.push_back(current);
+    }
+
+    current->fsm.Receive(MsgBlock{resource_id});
+    current->blocked_on = resource_id;
+    list.push_back(current);
+  }
+
+  Schedule();
+
+  // 被唤醒或超时后从这里继续执行
+  return ready(arg);
+}
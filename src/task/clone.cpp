@@ -7,6 +7,7 @@
 #include "kernel_log.hpp"
 #include "kstd_cstring"
 #include "sk_stdlib.h"
+#include "syscall_ring.hpp"
 #include "task_manager.hpp"
 #include "virtual_memory.hpp"
 
@@ -54,6 +55,11 @@ auto TaskManager::Clone(uint64_t flags, void* user_stack, int* parent_tid,
   child->policy = parent->policy;
   child->sched_info = parent->sched_info;
 
+  // deadline 带宽不继承，子任务需通过 sched_setattr 重新准入
+  if (child->policy == SchedPolicy::kDeadline) {
+    child->policy = SchedPolicy::kNormal;
+  }
+
   // 设置父进程 ID
   if (flags & clone_flag::kParent) {
     // 保持与父进程相同的父进程
@@ -94,11 +100,26 @@ auto TaskManager::Clone(uint64_t flags, void* user_stack, int* parent_tid,
   child->clone_flags = CloneFlags(flags);
 
   // 处理文件描述符表 (kCloneFiles)
-  /// @todo 当前未实现文件系统，此标志暂时仅记录
   if (flags & clone_flag::kFiles) {
-    klog::Debug("Clone: sharing file descriptor table (not implemented)");
-  } else {
-    klog::Debug("Clone: copying file descriptor table (not implemented)");
+    // 共享同一张表，父任务尚无表时先创建，保证之后打开的文件对双方可见
+    auto* fd_table = parent->GetFdTable();
+    if (!fd_table) {
+      klog::Err("Clone: Failed to allocate file descriptor table");
+      return std::unexpected(Error(ErrorCode::kOutOfMemory));
+    }
+    fd_table->Ref();
+    child->fd_table = fd_table;
+    klog::Debug("Clone: sharing file descriptor table");
+  } else if (parent->fd_table) {
+    // 复制表项，同号 fd 指向同一个 File，与 fork 一样共享文件偏移量
+    auto result = parent->fd_table->Clone();
+    if (!result.has_value()) {
+      klog::Err("Clone: Failed to copy file descriptor table: {}",
+                result.error().message());
+      return std::unexpected(result.error());
+    }
+    child->fd_table = result.value();
+    klog::Debug("Clone: copied file descriptor table");
   }
 
   // 处理信号处理器 (kCloneSighand)
@@ -145,6 +166,19 @@ auto TaskManager::Clone(uint64_t flags, void* user_stack, int* parent_tid,
       klog::Debug("Clone: cloned page table from {:#x} to {:#x}",
                   reinterpret_cast<uintptr_t>(parent->page_table),
                   reinterpret_cast<uintptr_t>(child->page_table));
+      // 系统调用环属于父进程，不能出现在子进程的地址空间中
+      if (parent->syscall_ring &&
+          parent->syscall_ring->GetPageTable() == parent->page_table) {
+        parent->syscall_ring->UnmapFrom(child->page_table);
+      }
+      // 复制出的 vvar 映射可能指向副本，重新映射到共享的 vvar 页
+      if (vdso_.IsValid()) {
+        Vdso::UnmapFrom(child->page_table);
+        vdso_.MapTo(child->page_table).or_else([](auto&& err) {
+          klog::Warn("Clone: failed to map vvar page: {}", err.message());
+          return Expected<void>{};
+        });
+      }
     } else {
       // 父进程没有页表（内核线程），子进程也不需要
       child->page_table = nullptr;
@@ -0,0 +1,41 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "completion.hpp"
+
+#include <cpu_io.h>
+
+#include "kernel_log.hpp"
+#include "task_manager.hpp"
+
+auto Completion::Complete() -> void {
+  // 等待者看到完成后可能立即销毁完成量，先复制资源 ID
+  auto resource_id = resource_id_;
+  done_.store(true, std::memory_order_seq_cst);
+  // 任务管理器创建前没有可唤醒的任务
+  if (TaskManagerSingleton::is_valid()) {
+    TaskManagerSingleton::instance().Wakeup(resource_id);
+  }
+}
+
+auto Completion::Wait(uint64_t timeout_ms) -> Expected<void> {
+  if (IsDone()) {
+    return {};
+  }
+  if (!CanWait()) {
+    return std::unexpected(Error(ErrorCode::kNotSupported));
+  }
+
+  if (!TaskManagerSingleton::instance().BlockUntil(resource_id_, done_,
+                                                   timeout_ms)) {
+    klog::Debug("Completion::Wait: '{}' timed out", name);
+    return std::unexpected(Error(ErrorCode::kTimeout));
+  }
+  return {};
+}
+
+auto Completion::CanWait() -> bool {
+  return cpu_io::GetInterruptStatus() && TaskManagerSingleton::is_valid() &&
+         TaskManagerSingleton::instance().GetCurrentTask() != nullptr;
+}
@@ -36,6 +36,13 @@ auto TaskManager::Exit(int exit_code) -> void {
     // 从线程组中移除
     current->LeaveThreadGroup();
 
+    // 归还 deadline 任务占用的带宽
+    ReleaseDeadline(cpu_sched, current);
+
+    // 退出的任务不再需要保存 FPU 状态，清除其最后加载 FPU 的核心上的
+    // 持有者 (不一定是本核心)
+    ReleaseFpu(current);
+
     // 将子进程过继给 init 进程 (仅当是进程时)
     if (is_group_leader) {
       ReparentChildren(current);
@@ -61,8 +68,8 @@ auto TaskManager::Exit(int exit_code) -> void {
       // 没有父进程，直接退出并释放资源
       // Transition: kRunning -> kExited
       current->fsm.Receive(MsgExit{exit_code, false});
-      // No parent to call wait(), reap immediately to free TCB + stack
-      ReapTask(current);
+      // 没有父进程调用 wait()，仍在使用本任务的内核栈，
+      // 切换完成后由 FinishSwitch 回收 TCB 与内核栈
     }
   }
 
@@ -0,0 +1,125 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include <cpu_io.h>
+
+#include <atomic>
+#include <cassert>
+
+#include "arch.h"
+#include "kernel_fpu.hpp"
+#include "per_cpu.hpp"
+#include "task_manager.hpp"
+
+namespace {
+
+/**
+ * @brief 以原子方式访问核心的 fpu_owner
+ *
+ * 持有者核心之外，任务在其他核心加载 FPU 状态或退出时也会清除该字段
+ */
+auto FpuOwner(per_cpu::PerCpu& cpu_data) -> std::atomic_ref<TaskControlBlock*> {
+  return std::atomic_ref<TaskControlBlock*>(cpu_data.fpu_owner);
+}
+
+/**
+ * @brief 任务不再是 core_id 上的 FPU 持有者 (该核心已换了持有者时不做任何事)
+ * @param task 任务控制块指针
+ * @param core_id 任务上次加载 FPU 状态的核心
+ */
+auto DropFpuOwner(TaskControlBlock* task, size_t core_id) -> void {
+  if (core_id >= SIMPLEKERNEL_MAX_CORE_COUNT) {
+    return;
+  }
+  auto* expected = task;
+  FpuOwner(per_cpu::PerCpuArraySingleton::instance()[core_id])
+      .compare_exchange_strong(expected, nullptr, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+auto TaskManager::HandleFpuTrap() -> void {
+  auto& cpu_data = per_cpu::GetCurrentCore();
+  auto* current = cpu_data.running_task;
+
+  FpuEnable();
+  if (!current) {
+    // 调度尚未开始
+    return;
+  }
+
+  // 上一个持有者的状态已在其换出时保存，直接覆盖寄存器
+  if (!current->fpu_used) {
+    FpuInitState(&current->fpu_state);
+    current->fpu_used = true;
+  }
+  FpuRestore(&current->fpu_state);
+  // 任务最多是一个核心 (fpu_cpu) 上的持有者：迁移前所在核心的寄存器
+  // 已在换出时保存，不再代表它的状态
+  if (current->fpu_cpu != cpu_data.core_id) {
+    DropFpuOwner(current, current->fpu_cpu);
+  }
+  FpuOwner(cpu_data).store(current, std::memory_order_relaxed);
+  current->fpu_cpu = cpu_data.core_id;
+}
+
+auto TaskManager::ReleaseFpu(TaskControlBlock* task) -> void {
+  // 任务可能在其他核心上加载过 FPU 状态后迁移到本核心退出，
+  // 必须在 TCB 释放前清除那个核心的 fpu_owner
+  DropFpuOwner(task, task->fpu_cpu);
+  task->fpu_cpu = SIMPLEKERNEL_MAX_CORE_COUNT;
+}
+
+auto TaskManager::SwitchFpu(TaskControlBlock* prev, TaskControlBlock* next)
+    -> void {
+  auto& cpu_data = per_cpu::GetCurrentCore();
+
+  auto* owner = FpuOwner(cpu_data).load(std::memory_order_relaxed);
+
+  // 持有者运行期间 FPU 处于启用状态，可能已修改寄存器，换出时保存
+  if (owner == prev) {
+    FpuSave(&prev->fpu_state);
+  }
+
+  // 寄存器中仍是 next 的状态 (期间没有其他任务使用 FPU，也没有迁移到
+  // 其他核心后又迁回) 时不需要重新加载
+  if (owner == next && next->fpu_cpu == cpu_data.core_id) {
+    FpuEnable();
+  } else {
+    FpuDisable();
+  }
+}
+
+auto KernelFpuBegin() -> void {
+  auto intr_enable = cpu_io::GetInterruptStatus();
+  cpu_io::DisableInterrupt();
+
+  auto& cpu_data = per_cpu::GetCurrentCore();
+  if (cpu_data.kernel_fpu_depth++ > 0) {
+    return;
+  }
+  cpu_data.kernel_fpu_intr = intr_enable;
+
+  // 当前任务持有 FPU 时先保存其状态，其他持有者已在换出时保存
+  auto* owner = FpuOwner(cpu_data).exchange(nullptr, std::memory_order_relaxed);
+  if (owner && owner == cpu_data.running_task) {
+    FpuSave(&owner->fpu_state);
+  }
+  FpuEnable();
+}
+
+auto KernelFpuEnd() -> void {
+  auto& cpu_data = per_cpu::GetCurrentCore();
+  assert(cpu_data.kernel_fpu_depth > 0 &&
+         "KernelFpuEnd: unbalanced KernelFpuBegin/KernelFpuEnd");
+  if (--cpu_data.kernel_fpu_depth > 0) {
+    return;
+  }
+
+  // 寄存器已被内核使用，任务下一次使用 FPU 时陷入并重新加载
+  FpuDisable();
+  if (cpu_data.kernel_fpu_intr) {
+    cpu_io::EnableInterrupt();
+  }
+}
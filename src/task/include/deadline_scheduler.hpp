@@ -0,0 +1,468 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "scheduler_base.hpp"
+#include "task_control_block.hpp"
+
+/**
+ * @brief EDF (Earliest Deadline First) 截止时间调度器
+ *
+ * 参考 Linux SCHED_DEADLINE，每个任务带有 (runtime, deadline, period) 参数：
+ * - 就绪任务按绝对截止时间组织在侵入式斜堆 (DeadlineLink) 中，
+ *   入队/出队 O(log n) (均摊)，选择 O(1)
+ * - 恒定带宽服务器 (CBS)：任务在每个周期内最多运行 runtime 个 tick，
+ *   预算耗尽后被节流，直到下个周期开始时补充预算。节流任务复用
+ *   DeadlineLink 挂在侵入式链表上，没有容量上限
+ * - 唤醒时若剩余预算会超出分配的带宽，则重新设置截止时间 (CBS 唤醒规则)
+ * - 当有更早截止时间的任务就绪时，在 OnTick 中抢占当前任务
+ *
+ * @note 带宽准入控制由 TaskManager 基于 CpuSchedData::dl_bandwidth 完成，
+ *       本调度器只负责已准入任务的排序与节流
+ */
+class DeadlineScheduler : public SchedulerBase {
+ public:
+  /// 带宽定点数精度 (1.0 == 1 << kBandwidthShift)
+  static constexpr uint64_t kBandwidthShift = 20;
+  /// 带宽 1.0 (单核全部 CPU 时间)
+  static constexpr uint64_t kBandwidthUnit = 1ULL << kBandwidthShift;
+  /// 单核允许分配给 deadline 任务的最大带宽 (95%)
+  static constexpr uint64_t kMaxBandwidth = kBandwidthUnit * 95 / 100;
+  /// runtime/deadline/period 的上限 (ticks)，保证带宽定点数与截止时间
+  /// 相加不溢出；两个 tick 数的乘积仍可能超出 64 位，需用 128 位计算
+  static constexpr uint64_t kMaxTicks = UINT64_MAX >> (kBandwidthShift + 1);
+
+  /**
+   * @brief 计算任务带宽 runtime / period (定点数)
+   * @param runtime 每周期运行预算
+   * @param period 周期
+   * @return uint64_t 带宽，period 为 0 时返回 0
+   */
+  [[nodiscard]] static constexpr auto ToBandwidth(uint64_t runtime,
+                                                  uint64_t period)
+      -> uint64_t {
+    return period == 0 ? 0 : (runtime << kBandwidthShift) / period;
+  }
+
+  /**
+   * @brief 将任务加入就绪树
+   * @param task 任务控制块指针
+   *
+   * 新任务或被唤醒的任务应用 CBS 唤醒规则：截止时间已过，或剩余预算在
+   * 剩余时间内会超出 runtime/deadline 的带宽时，以当前时间为起点开始新的
+   * 周期。被抢占后重新入队的任务保持原有截止时间与预算。
+   * 处于节流状态的任务加入节流队列，等待 OnClockTick 补充预算。
+   */
+  auto Enqueue(TaskControlBlock* task) -> void override {
+    if (!task) {
+      return;
+    }
+
+    bool is_requeue = (task == requeue_);
+    requeue_ = nullptr;
+
+    auto& dl = task->sched_data.dl;
+    if (dl.throttled && NextActivation(task) <= now_) {
+      // 节流期间睡眠，唤醒时已进入下个周期
+      Replenish(task);
+    }
+    if (dl.throttled) {
+      PushThrottled(task);
+      return;
+    }
+
+    // 乘积可达 kMaxTicks^2，超出 64 位
+    bool overflow =
+        now_ >= dl.abs_deadline ||
+        static_cast<unsigned __int128>(dl.runtime_remaining) * dl.deadline >
+            static_cast<unsigned __int128>(dl.abs_deadline - now_) *
+                dl.runtime;
+    if (!is_requeue && overflow) {
+      dl.abs_deadline = now_ + dl.deadline;
+      dl.runtime_remaining = dl.runtime;
+    }
+
+    Insert(task);
+    stats_.total_enqueues++;
+  }
+
+  /**
+   * @brief 从就绪树或节流队列中移除指定任务
+   * @param task 要移除的任务控制块指针
+   */
+  auto Dequeue(TaskControlBlock* task) -> void override {
+    if (!task) {
+      return;
+    }
+
+    if (task->sched_data.dl.throttled) {
+      if (IsThrottledQueued(task)) {
+        UnlinkThrottled(task);
+        stats_.total_dequeues++;
+      }
+      return;
+    }
+
+    auto* link = static_cast<DeadlineLink*>(task);
+    if (link != root_ && link->etl_parent == nullptr) {
+      // 不在就绪树中
+      return;
+    }
+    Remove(link);
+    stats_.total_dequeues++;
+  }
+
+  /**
+   * @brief 选择绝对截止时间最早的任务
+   * @return TaskControlBlock* 下一个任务，如果队列为空则返回 nullptr
+   */
+  [[nodiscard]] auto PickNext() -> TaskControlBlock* override {
+    if (!root_) {
+      return nullptr;
+    }
+    auto* next = static_cast<TaskControlBlock*>(root_);
+    Remove(root_);
+    stats_.total_picks++;
+    return next;
+  }
+
+  /**
+   * @brief 获取就绪任务数量 (不含节流中的任务)
+   * @return size_t 就绪树中的任务数量
+   */
+  [[nodiscard]] auto GetQueueSize() const -> size_t override {
+    return ready_count_;
+  }
+
+  /**
+   * @brief 判断就绪树是否为空
+   * @return bool 没有可运行的任务返回 true
+   */
+  [[nodiscard]] auto IsEmpty() const -> bool override {
+    return root_ == nullptr;
+  }
+
+  /**
+   * @brief 消耗当前任务的预算，并检查 EDF 抢占
+   * @param current 当前运行的任务
+   * @return bool 预算耗尽或有更早截止时间的任务就绪时返回 true
+   */
+  [[nodiscard]] auto OnTick(TaskControlBlock* current) -> bool override {
+    if (!current) {
+      return false;
+    }
+
+    auto& dl = current->sched_data.dl;
+    if (dl.runtime_remaining > 0) {
+      dl.runtime_remaining--;
+    }
+    if (dl.runtime_remaining == 0) {
+      // 预算耗尽：节流到下个周期
+      dl.throttled = true;
+      stats_dl_.total_throttles++;
+      return true;
+    }
+
+    if (root_ && Earlier(root_, current)) {
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief 推进调度器时钟，补充到期的节流任务
+   * @param now 当前核心的 tick 计数
+   * @return bool 有任务重新变为就绪时返回 true
+   */
+  [[nodiscard]] auto OnClockTick(uint64_t now) -> bool override {
+    now_ = now;
+
+    bool replenished = false;
+    for (auto* link = throttled_head_; link;) {
+      auto* task = static_cast<TaskControlBlock*>(link);
+      link = link->etl_right;
+      if (NextActivation(task) > now_) {
+        continue;
+      }
+      UnlinkThrottled(task);
+      Replenish(task);
+      Insert(task);
+      stats_.total_enqueues++;
+      replenished = true;
+    }
+    return replenished;
+  }
+
+  /**
+   * @brief 时间片耗尽处理
+   * @param task 被抢占的任务
+   * @return bool 节流中的任务返回 false (已转入节流队列)，否则返回 true
+   *
+   * 返回 true 时记录该任务，紧随其后的 Enqueue 视为重新入队而非唤醒。
+   */
+  [[nodiscard]] auto OnTimeSliceExpired(TaskControlBlock* task)
+      -> bool override {
+    if (task && task->sched_data.dl.throttled) {
+      PushThrottled(task);
+      return false;
+    }
+    requeue_ = task;
+    return true;
+  }
+
+  /**
+   * @brief 任务被抢占时调用
+   * @param task 被抢占的任务
+   */
+  auto OnPreempted([[maybe_unused]] TaskControlBlock* task) -> void override {
+    stats_.total_preemptions++;
+  }
+
+  /**
+   * @brief 任务开始运行时以剩余预算作为时间片
+   * @param task 即将运行的任务
+   */
+  auto OnScheduled(TaskControlBlock* task) -> void override {
+    if (task && task->sched_data.dl.runtime_remaining > 0) {
+      task->sched_info.time_slice_remaining =
+          task->sched_data.dl.runtime_remaining;
+    }
+  }
+
+  /**
+   * @brief 获取节流中的任务数量
+   * @return size_t 等待补充预算的任务数量
+   */
+  [[nodiscard]] auto GetThrottledCount() const -> size_t {
+    return throttled_count_;
+  }
+
+  /**
+   * @brief 获取节流次数
+   * @return size_t 预算耗尽被节流的总次数
+   */
+  [[nodiscard]] auto GetThrottles() const -> size_t {
+    return stats_dl_.total_throttles;
+  }
+
+  /**
+   * @brief 获取调度器当前时钟
+   * @return uint64_t 最近一次 OnClockTick 的 tick 值
+   */
+  [[nodiscard]] auto GetClock() const -> uint64_t { return now_; }
+
+  /**
+   * @brief 重置统计信息
+   */
+  auto ResetStats() -> void override {
+    SchedulerBase::ResetStats();
+    stats_dl_ = {};
+  }
+
+  /// @name 构造/析构函数
+  /// @{
+  DeadlineScheduler() { name = "Deadline"; }
+  DeadlineScheduler(const DeadlineScheduler&) = delete;
+  DeadlineScheduler(DeadlineScheduler&&) = delete;
+  auto operator=(const DeadlineScheduler&) -> DeadlineScheduler& = delete;
+  auto operator=(DeadlineScheduler&&) -> DeadlineScheduler& = delete;
+  ~DeadlineScheduler() override = default;
+  /// @}
+
+ private:
+  /**
+   * @brief Deadline 额外统计
+   */
+  struct DeadlineStats {
+    /// 总节流次数
+    size_t total_throttles{0};
+  };
+
+  /**
+   * @brief 比较两个节点的绝对截止时间 (相同时按 PID 排序，保证确定性)
+   * @param a 第一个节点
+   * @param b 第二个节点
+   * @return bool a 的截止时间早于 b 返回 true
+   */
+  [[nodiscard]] static auto Earlier(const DeadlineLink* a,
+                                    const DeadlineLink* b) -> bool {
+    const auto* ta = static_cast<const TaskControlBlock*>(a);
+    const auto* tb = static_cast<const TaskControlBlock*>(b);
+    if (ta->sched_data.dl.abs_deadline != tb->sched_data.dl.abs_deadline) {
+      return ta->sched_data.dl.abs_deadline < tb->sched_data.dl.abs_deadline;
+    }
+    return ta->pid < tb->pid;
+  }
+
+  /**
+   * @brief 计算下个周期的起点 (本周期起点 + period)
+   * @param task 任务控制块指针
+   * @return uint64_t 下个周期开始的 tick
+   */
+  [[nodiscard]] static auto NextActivation(const TaskControlBlock* task)
+      -> uint64_t {
+    const auto& dl = task->sched_data.dl;
+    return dl.abs_deadline - dl.deadline + dl.period;
+  }
+
+  /**
+   * @brief 解除节流，进入下个周期并补充预算
+   * @param task 任务控制块指针
+   */
+  auto Replenish(TaskControlBlock* task) const -> void {
+    auto& dl = task->sched_data.dl;
+    dl.throttled = false;
+    dl.abs_deadline = NextActivation(task) + dl.deadline;
+    if (dl.abs_deadline <= now_) {
+      // 已错过整个周期，从当前时间重新开始
+      dl.abs_deadline = now_ + dl.deadline;
+    }
+    dl.runtime_remaining = dl.runtime;
+  }
+
+  /**
+   * @brief 判断节流任务是否挂在节流链表上
+   * @param task 任务控制块指针 (dl.throttled 已置位)
+   * @return bool 在节流链表中返回 true
+   */
+  [[nodiscard]] auto IsThrottledQueued(const TaskControlBlock* task) const
+      -> bool {
+    const auto* link = static_cast<const DeadlineLink*>(task);
+    return link == throttled_head_ || link->etl_left != nullptr;
+  }
+
+  /**
+   * @brief 将任务挂到节流链表头部 (etl_left 为前驱，etl_right 为后继)
+   * @param task 任务控制块指针
+   */
+  auto PushThrottled(TaskControlBlock* task) -> void {
+    if (IsThrottledQueued(task)) {
+      return;
+    }
+    auto* link = static_cast<DeadlineLink*>(task);
+    link->clear();
+    link->etl_right = throttled_head_;
+    if (throttled_head_) {
+      throttled_head_->etl_left = link;
+    }
+    throttled_head_ = link;
+    throttled_count_++;
+  }
+
+  /**
+   * @brief 将任务从节流链表中摘下
+   * @param task 任务控制块指针 (必须在节流链表中)
+   */
+  auto UnlinkThrottled(TaskControlBlock* task) -> void {
+    auto* link = static_cast<DeadlineLink*>(task);
+    if (link->etl_left) {
+      link->etl_left->etl_right = link->etl_right;
+    } else {
+      throttled_head_ = link->etl_right;
+    }
+    if (link->etl_right) {
+      link->etl_right->etl_left = link->etl_left;
+    }
+    link->clear();
+    throttled_count_--;
+  }
+
+  /**
+   * @brief 合并两棵斜堆，返回新的根 (根的 etl_parent 由调用者设置)
+   * @param a 第一棵斜堆
+   * @param b 第二棵斜堆
+   * @return DeadlineLink* 合并后的根
+   * @note 自顶向下迭代：沿两棵树的右链依次取截止时间较早的节点，
+   *       交换其左右子树后把后续合并结果挂为左子树。右链最坏为 O(n)，
+   *       递归实现会在持有调度器锁时耗尽内核栈
+   */
+  static auto Merge(DeadlineLink* a, DeadlineLink* b) -> DeadlineLink* {
+    DeadlineLink* root = nullptr;
+    DeadlineLink* tail = nullptr;
+    while (a && b) {
+      if (Earlier(b, a)) {
+        std::swap(a, b);
+      }
+      auto* next = a->etl_right;
+      a->etl_right = a->etl_left;
+      a->etl_left = nullptr;
+      if (tail) {
+        tail->etl_left = a;
+        a->etl_parent = tail;
+      } else {
+        root = a;
+      }
+      tail = a;
+      a = next;
+    }
+    auto* rest = a ? a : b;
+    if (!tail) {
+      return rest;
+    }
+    tail->etl_left = rest;
+    if (rest) {
+      rest->etl_parent = tail;
+    }
+    return root;
+  }
+
+  /**
+   * @brief 插入节点
+   * @param task 要插入的任务
+   */
+  auto Insert(TaskControlBlock* task) -> void {
+    auto* link = static_cast<DeadlineLink*>(task);
+    link->clear();
+    root_ = Merge(root_, link);
+    root_->etl_parent = nullptr;
+    ready_count_++;
+  }
+
+  /**
+   * @brief 移除树中任意节点：合并其子树并挂回原位置
+   * @param link 要移除的节点
+   */
+  auto Remove(DeadlineLink* link) -> void {
+    auto* parent = link->etl_parent;
+    auto* merged = Merge(link->etl_left, link->etl_right);
+    if (merged) {
+      merged->etl_parent = parent;
+    }
+    if (!parent) {
+      root_ = merged;
+    } else if (parent->etl_left == link) {
+      parent->etl_left = merged;
+    } else {
+      parent->etl_right = merged;
+    }
+    link->clear();
+    ready_count_--;
+  }
+
+  /// 就绪斜堆的根 (绝对截止时间最早的任务)
+  DeadlineLink* root_{nullptr};
+
+  /// 就绪任务数量
+  size_t ready_count_{0};
+
+  /// 节流链表头 (预算耗尽，等待下个周期)
+  DeadlineLink* throttled_head_{nullptr};
+
+  /// 节流任务数量
+  size_t throttled_count_{0};
+
+  /// 调度器时钟 (tick)
+  uint64_t now_{0};
+
+  /// 被抢占后即将重新入队的任务 (Enqueue 时不应用 CBS 唤醒规则)
+  TaskControlBlock* requeue_{nullptr};
+
+  /// Deadline 额外统计
+  DeadlineStats stats_dl_{};
+};
@@ -4,33 +4,53 @@
 
 #pragma once
 
-#include <etl/list.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 
-#include "kernel_config.hpp"
-#include "kernel_log.hpp"
 #include "scheduler_base.hpp"
 #include "task_control_block.hpp"
 
 /**
- * @brief 先来先服务 (FIFO) 调度器
+ * @brief 先来先服务 (FIFO) 实时调度器
  *
  * FIFO 调度器特点：
- * - 先进先出，适合对延迟敏感的实时任务
- * - 不可抢占，任务运行直到主动让出 CPU
- * - O(1) 时间复杂度
+ * - kPriorityLevels 个优先级级别，每个级别一个先进先出的侵入式链表
+ *   (RtRunQueueLink)，同级任务按到达顺序运行
+ * - 非空级别位图 + find-first-set 选出最高优先级，入队/出队/选择均为 O(1)
+ * - 更高优先级的任务就绪时，在 OnTick 中抢占当前任务
+ * - 任务的优先级取 SchedInfo::priority (数字越小优先级越高)，
+ *   超出范围的值归入最低级别
  */
 class FifoScheduler : public SchedulerBase {
  public:
+  /// 优先级级别数量 (0 = 最高)
+  static constexpr size_t kPriorityLevels = 100;
+
+  /**
+   * @brief 将优先级映射为就绪队列级别
+   * @param priority 任务优先级
+   * @return uint8_t 级别，范围 [0, kPriorityLevels)
+   */
+  [[nodiscard]] static constexpr auto ToLevel(int priority) -> uint8_t {
+    if (priority < 0) {
+      return 0;
+    }
+    if (priority >= static_cast<int>(kPriorityLevels)) {
+      return kPriorityLevels - 1;
+    }
+    return static_cast<uint8_t>(priority);
+  }
+
   /**
-   * @brief 将任务加入就绪队列尾部
+   * @brief 将任务加入其优先级级别的队列尾部
    * @param task 要加入的任务
    */
   auto Enqueue(TaskControlBlock* task) -> void override {
-    if (ready_queue_.full()) {
-      klog::Err("FifoScheduler::Enqueue: ready_queue full, dropping task");
+    if (!task || task->sched_data.rt.queued) {
       return;
     }
-    ready_queue_.push_back(task);
+    PushBack(task, ToLevel(task->sched_info.priority));
     stats_.total_enqueues++;
   }
 
@@ -39,20 +59,24 @@ class FifoScheduler : public SchedulerBase {
    * @param task 要移除的任务
    */
   auto Dequeue(TaskControlBlock* task) -> void override {
-    ready_queue_.remove(task);
+    if (!task || !task->sched_data.rt.queued) {
+      return;
+    }
+    Unlink(task);
     stats_.total_dequeues++;
   }
 
   /**
-   * @brief 选择下一个要运行的任务（队列头部）
+   * @brief 选择最高优先级级别的队首任务
    * @return 下一个任务，如果队列为空则返回 nullptr
    */
   [[nodiscard]] auto PickNext() -> TaskControlBlock* override {
-    if (ready_queue_.empty()) {
+    auto level = HighestLevel();
+    if (level >= kPriorityLevels) {
       return nullptr;
     }
-    TaskControlBlock* next = ready_queue_.front();
-    ready_queue_.pop_front();
+    auto* next = static_cast<TaskControlBlock*>(heads_[level]);
+    Unlink(next);
     stats_.total_picks++;
     return next;
   }
@@ -62,7 +86,7 @@ class FifoScheduler : public SchedulerBase {
    * @return 队列中的任务数量
    */
   [[nodiscard]] auto GetQueueSize() const -> size_t override {
-    return ready_queue_.size();
+    return task_count_;
   }
 
   /**
@@ -70,20 +94,71 @@ class FifoScheduler : public SchedulerBase {
    * @return 队列为空返回 true，否则返回 false
    */
   [[nodiscard]] auto IsEmpty() const -> bool override {
-    return ready_queue_.empty();
+    return task_count_ == 0;
+  }
+
+  /**
+   * @brief 检查是否有更高优先级的任务就绪
+   * @param current 当前运行的任务
+   * @return bool 有更高优先级的任务就绪时返回 true
+   */
+  [[nodiscard]] auto OnTick(TaskControlBlock* current) -> bool override {
+    if (!current) {
+      return false;
+    }
+    return HighestLevel() < ToLevel(current->sched_info.priority);
   }
 
   /**
    * @brief 任务被抢占时调用
-   *
-   * FIFO 是不可抢占调度器，但如果外部强制抢占，则需要统计
-   *
    * @param task 被抢占的任务
    */
   auto OnPreempted([[maybe_unused]] TaskControlBlock* task) -> void override {
     stats_.total_preemptions++;
   }
 
+  /**
+   * @brief 优先级继承：提升任务优先级，已就绪的任务移动到新级别
+   * @param task 需要提升优先级的任务
+   * @param new_priority 继承的优先级
+   */
+  auto BoostPriority(TaskControlBlock* task, int new_priority)
+      -> void override {
+    if (!task || new_priority >= task->sched_info.priority) {
+      return;
+    }
+    task->sched_info.inherited_priority = new_priority;
+    SetPriority(task, new_priority);
+  }
+
+  /**
+   * @brief 恢复任务的基础优先级
+   * @param task 需要恢复优先级的任务
+   */
+  auto RestorePriority(TaskControlBlock* task) -> void override {
+    if (!task) {
+      return;
+    }
+    task->sched_info.inherited_priority = 0;
+    SetPriority(task, task->sched_info.base_priority);
+  }
+
+  /**
+   * @brief 获取指定级别的就绪任务数
+   * @param level 优先级级别
+   * @return size_t 该级别队列中的任务数量
+   */
+  [[nodiscard]] auto GetLevelSize(uint8_t level) const -> size_t {
+    if (level >= kPriorityLevels) {
+      return 0;
+    }
+    size_t count = 0;
+    for (const auto* link = heads_[level]; link; link = link->etl_next) {
+      ++count;
+    }
+    return count;
+  }
+
   /// @name 构造/析构函数
   /// @{
   FifoScheduler() { name = "FIFO"; }
@@ -95,6 +170,97 @@ class FifoScheduler : public SchedulerBase {
   /// @}
 
  private:
-  /// 就绪队列 (先进先出，固定容量)
-  etl::list<TaskControlBlock*, kernel::config::kMaxReadyTasks> ready_queue_;
+  /// 位图字宽
+  static constexpr size_t kBitsPerWord = 64;
+  /// 位图字数
+  static constexpr size_t kBitmapWords =
+      (kPriorityLevels + kBitsPerWord - 1) / kBitsPerWord;
+
+  static_assert(kPriorityLevels <= UINT8_MAX, "level is stored in uint8_t");
+
+  /**
+   * @brief 查找最高优先级的非空级别
+   * @return size_t 级别，全部为空时返回 kPriorityLevels
+   */
+  [[nodiscard]] auto HighestLevel() const -> size_t {
+    for (size_t word = 0; word < kBitmapWords; ++word) {
+      if (bitmap_[word] != 0) {
+        return word * kBitsPerWord +
+               static_cast<size_t>(__builtin_ctzll(bitmap_[word]));
+      }
+    }
+    return kPriorityLevels;
+  }
+
+  /**
+   * @brief 将任务挂到指定级别的队列尾部
+   * @param task 任务控制块指针
+   * @param level 优先级级别
+   */
+  auto PushBack(TaskControlBlock* task, uint8_t level) -> void {
+    auto* link = static_cast<RtRunQueueLink*>(task);
+    link->etl_previous = tails_[level];
+    link->etl_next = nullptr;
+    if (tails_[level]) {
+      tails_[level]->etl_next = link;
+    } else {
+      heads_[level] = link;
+      bitmap_[level / kBitsPerWord] |= 1ULL << (level % kBitsPerWord);
+    }
+    tails_[level] = link;
+    task->sched_data.rt.level = level;
+    task->sched_data.rt.queued = true;
+    ++task_count_;
+  }
+
+  /**
+   * @brief 将任务从其所在级别的队列中摘下
+   * @param task 任务控制块指针 (必须在队列中)
+   */
+  auto Unlink(TaskControlBlock* task) -> void {
+    auto* link = static_cast<RtRunQueueLink*>(task);
+    auto level = task->sched_data.rt.level;
+    if (link->etl_previous) {
+      link->etl_previous->etl_next = link->etl_next;
+    } else {
+      heads_[level] = link->etl_next;
+    }
+    if (link->etl_next) {
+      link->etl_next->etl_previous = link->etl_previous;
+    } else {
+      tails_[level] = link->etl_previous;
+    }
+    if (!heads_[level]) {
+      bitmap_[level / kBitsPerWord] &= ~(1ULL << (level % kBitsPerWord));
+    }
+    link->etl_previous = nullptr;
+    link->etl_next = nullptr;
+    task->sched_data.rt.queued = false;
+    --task_count_;
+  }
+
+  /**
+   * @brief 修改任务优先级，已就绪的任务移动到新级别的队列尾部
+   * @param task 任务控制块指针
+   * @param priority 新的优先级
+   */
+  auto SetPriority(TaskControlBlock* task, int priority) -> void {
+    task->sched_info.priority = priority;
+    if (task->sched_data.rt.queued &&
+        task->sched_data.rt.level != ToLevel(priority)) {
+      Unlink(task);
+      PushBack(task, ToLevel(priority));
+    }
+  }
+
+  /// 每个级别的队首
+  std::array<RtRunQueueLink*, kPriorityLevels> heads_{};
+  /// 每个级别的队尾
+  std::array<RtRunQueueLink*, kPriorityLevels> tails_{};
+
+  /// 非空级别位图 (bit i 置位表示级别 i 有就绪任务)
+  std::array<uint64_t, kBitmapWords> bitmap_{};
+
+  /// 所有级别的任务总数
+  size_t task_count_{0};
 };
@@ -0,0 +1,43 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+/**
+ * @brief 开始在内核中使用 FPU/SIMD 指令
+ *
+ * 关闭中断 (禁止抢占)，保存当前任务的 FPU 状态并启用 FPU。
+ * 可以嵌套，只有最外层调用生效
+ *
+ * @note 在 KernelFpuEnd 之前不能睡眠或调度
+ */
+auto KernelFpuBegin() -> void;
+
+/**
+ * @brief 结束在内核中使用 FPU/SIMD 指令
+ *
+ * 禁用 FPU，使任务下一次使用 FPU 时重新加载自己的状态，并恢复中断状态
+ *
+ * @pre 与 KernelFpuBegin 成对调用
+ */
+auto KernelFpuEnd() -> void;
+
+/**
+ * @brief RAII 风格的内核 FPU 守卫
+ *
+ * 构造时调用 KernelFpuBegin，析构时调用 KernelFpuEnd，
+ * 用于在 memcpy/校验和等内核函数中安全地使用 SIMD 指令
+ */
+class KernelFpuGuard {
+ public:
+  /// @name 构造/析构函数
+  /// @{
+  KernelFpuGuard() { KernelFpuBegin(); }
+  KernelFpuGuard(const KernelFpuGuard&) = delete;
+  KernelFpuGuard(KernelFpuGuard&&) = delete;
+  auto operator=(const KernelFpuGuard&) -> KernelFpuGuard& = delete;
+  auto operator=(KernelFpuGuard&&) -> KernelFpuGuard& = delete;
+  ~KernelFpuGuard() { KernelFpuEnd(); }
+  /// @}
+};
@@ -0,0 +1,364 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "scheduler_base.hpp"
+#include "task_control_block.hpp"
+
+/**
+ * @brief MLFQ (Multi-Level Feedback Queue) 调度器
+ *
+ * 多级反馈队列调度器，根据任务的运行行为自动调整其优先级级别。
+ *
+ * 特点：
+ * - 每个级别一个侵入式就绪队列 (RtRunQueueLink)，通过位图 +
+ *   find-first-set 以 O(1) 选出最高级别，入队/出队均为 O(1)
+ * - 级别越低时间片越长：交互式/IO 密集型任务留在高级别，获得低延迟
+ * - 任务在当前级别用完配额后降级 (累计计算，主动让出也无法规避降级)
+ * - 周期性优先级提升 (由 OnTick 驱动)，防止低级别任务饥饿；提升时阻塞的
+ *   任务在下次入队时按提升代数补做提升
+ * - 高级别任务就绪时，在 OnTick 中抢占低级别的当前任务
+ */
+class MlfqScheduler : public SchedulerBase {
+ public:
+  /// 级别数量 (0 = 最高)
+  static constexpr uint8_t kLevelCount = 8;
+
+  /// 最高级别的时间片 (ticks)，每降一级翻倍
+  static constexpr uint32_t kBaseQuantum = 2;
+
+  /// 优先级提升周期 (ticks)
+  static constexpr uint64_t kBoostInterval = 200;
+
+  static_assert(kLevelCount <= 32, "ready_bitmap_ is 32 bits wide");
+
+  /**
+   * @brief 获取指定级别的时间片
+   * @param level 优先级级别
+   * @return uint32_t 该级别的时间片 (ticks)
+   */
+  [[nodiscard]] static constexpr auto GetQuantum(uint8_t level) -> uint32_t {
+    return kBaseQuantum << level;
+  }
+
+  /**
+   * @brief 将任务加入其当前级别的就绪队列尾部
+   * @param task 任务控制块指针
+   *
+   * 新任务 (sched_data 清零) 从最高级别开始。任务阻塞期间发生过优先级
+   * 提升时，入队前先提升到最高级别。
+   */
+  auto Enqueue(TaskControlBlock* task) -> void override {
+    if (!task || task->sched_data.mlfq.queued) {
+      return;
+    }
+
+    auto& mlfq = task->sched_data.mlfq;
+    if (mlfq.boost_epoch != boost_epoch_) {
+      mlfq.level = 0;
+      mlfq.ticks_used = 0;
+      mlfq.boost_epoch = boost_epoch_;
+    }
+    if (mlfq.level >= kLevelCount) {
+      mlfq.level = kLevelCount - 1;
+    }
+
+    PushBack(task, mlfq.level);
+    stats_.total_enqueues++;
+  }
+
+  /**
+   * @brief 从就绪队列中移除指定任务
+   * @param task 要移除的任务控制块指针
+   */
+  auto Dequeue(TaskControlBlock* task) -> void override {
+    if (!task || !task->sched_data.mlfq.queued) {
+      return;
+    }
+    Unlink(task);
+    stats_.total_dequeues++;
+  }
+
+  /**
+   * @brief 选择最高非空级别的队首任务
+   * @return TaskControlBlock* 下一个任务，如果队列为空则返回 nullptr
+   */
+  [[nodiscard]] auto PickNext() -> TaskControlBlock* override {
+    if (ready_bitmap_ == 0) {
+      return nullptr;
+    }
+
+    auto level = static_cast<uint8_t>(__builtin_ctz(ready_bitmap_));
+    auto* next = static_cast<TaskControlBlock*>(heads_[level]);
+    Unlink(next);
+    stats_.total_picks++;
+    return next;
+  }
+
+  /**
+   * @brief 获取就绪队列大小
+   * @return size_t 所有级别的任务总数
+   */
+  [[nodiscard]] auto GetQueueSize() const -> size_t override {
+    return task_count_;
+  }
+
+  /**
+   * @brief 判断队列是否为空
+   * @return bool 队列为空返回 true
+   */
+  [[nodiscard]] auto IsEmpty() const -> bool override {
+    return ready_bitmap_ == 0;
+  }
+
+  /**
+   * @brief 每个 tick 更新配额使用量，并驱动周期性优先级提升
+   * @param current 当前运行的任务
+   * @return bool 返回 true 表示需要抢占当前任务
+   *
+   * 以下情况需要抢占：
+   * 1. 当前任务用完本级别配额
+   * 2. 有更高级别的任务就绪
+   */
+  [[nodiscard]] auto OnTick(TaskControlBlock* current) -> bool override {
+    if (!current) {
+      return false;
+    }
+
+    if (++ticks_since_boost_ >= kBoostInterval) {
+      ticks_since_boost_ = 0;
+      BoostAll();
+      current->sched_data.mlfq.level = 0;
+      current->sched_data.mlfq.ticks_used = 0;
+      current->sched_data.mlfq.boost_epoch = boost_epoch_;
+      return false;
+    }
+
+    auto& mlfq = current->sched_data.mlfq;
+    mlfq.ticks_used++;
+    if (mlfq.ticks_used >= GetQuantum(mlfq.level)) {
+      return true;
+    }
+
+    // 有更高级别的任务就绪时抢占
+    if (ready_bitmap_ != 0 &&
+        static_cast<uint8_t>(__builtin_ctz(ready_bitmap_)) < mlfq.level) {
+      return true;
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief 时间片耗尽处理：配额用完则降级
+   * @param task 时间片耗尽 (或被抢占/主动让出) 的任务
+   * @return bool 始终返回 true，任务需要重新入队
+   *
+   * 配额在同一级别内跨多次调度累计，只有用完时才降级并清零。
+   */
+  [[nodiscard]] auto OnTimeSliceExpired(TaskControlBlock* task)
+      -> bool override {
+    if (!task) {
+      return true;
+    }
+
+    auto& mlfq = task->sched_data.mlfq;
+    if (mlfq.level < kLevelCount &&
+        mlfq.ticks_used >= GetQuantum(mlfq.level)) {
+      if (mlfq.level + 1 < kLevelCount) {
+        mlfq.level++;
+        stats_mlfq_.total_demotions++;
+      }
+      mlfq.ticks_used = 0;
+    }
+    return true;
+  }
+
+  /**
+   * @brief 任务被抢占时调用
+   * @param task 被抢占的任务
+   */
+  auto OnPreempted([[maybe_unused]] TaskControlBlock* task) -> void override {
+    stats_.total_preemptions++;
+  }
+
+  /**
+   * @brief 任务开始运行时设置本级别剩余配额作为时间片
+   * @param task 即将运行的任务
+   */
+  auto OnScheduled(TaskControlBlock* task) -> void override {
+    if (!task) {
+      return;
+    }
+    auto& mlfq = task->sched_data.mlfq;
+    auto quantum = GetQuantum(mlfq.level < kLevelCount ? mlfq.level
+                                                       : kLevelCount - 1);
+    task->sched_info.time_slice_remaining =
+        mlfq.ticks_used < quantum ? quantum - mlfq.ticks_used : 1;
+  }
+
+  /**
+   * @brief 获取指定级别的就绪任务数
+   * @param level 优先级级别
+   * @return size_t 该级别队列中的任务数量
+   */
+  [[nodiscard]] auto GetLevelSize(uint8_t level) const -> size_t {
+    if (level >= kLevelCount) {
+      return 0;
+    }
+    size_t count = 0;
+    for (const auto* link = heads_[level]; link; link = link->etl_next) {
+      ++count;
+    }
+    return count;
+  }
+
+  /**
+   * @brief 获取降级次数
+   * @return size_t 因配额耗尽而降级的总次数
+   */
+  [[nodiscard]] auto GetDemotions() const -> size_t {
+    return stats_mlfq_.total_demotions;
+  }
+
+  /**
+   * @brief 获取优先级提升次数
+   * @return size_t 已执行的全局提升次数
+   */
+  [[nodiscard]] auto GetBoosts() const -> size_t {
+    return stats_mlfq_.total_boosts;
+  }
+
+  /**
+   * @brief 重置统计信息
+   */
+  auto ResetStats() -> void override {
+    SchedulerBase::ResetStats();
+    stats_mlfq_ = {};
+  }
+
+  /// @name 构造/析构函数
+  /// @{
+  MlfqScheduler() { name = "MLFQ"; }
+  MlfqScheduler(const MlfqScheduler&) = delete;
+  MlfqScheduler(MlfqScheduler&&) = delete;
+  auto operator=(const MlfqScheduler&) -> MlfqScheduler& = delete;
+  auto operator=(MlfqScheduler&&) -> MlfqScheduler& = delete;
+  ~MlfqScheduler() override = default;
+  /// @}
+
+ private:
+  /**
+   * @brief MLFQ 额外统计
+   */
+  struct MlfqStats {
+    /// 总降级次数
+    size_t total_demotions{0};
+    /// 总提升次数
+    size_t total_boosts{0};
+  };
+
+  /**
+   * @brief 将任务挂到指定级别的队列尾部
+   * @param task 任务控制块指针
+   * @param level 优先级级别
+   */
+  auto PushBack(TaskControlBlock* task, uint8_t level) -> void {
+    auto* link = static_cast<RtRunQueueLink*>(task);
+    link->etl_previous = tails_[level];
+    link->etl_next = nullptr;
+    if (tails_[level]) {
+      tails_[level]->etl_next = link;
+    } else {
+      heads_[level] = link;
+      ready_bitmap_ |= (1U << level);
+    }
+    tails_[level] = link;
+    task->sched_data.mlfq.queued = true;
+    ++task_count_;
+  }
+
+  /**
+   * @brief 将任务从其所在级别的队列中摘下
+   * @param task 任务控制块指针 (必须在队列中)
+   */
+  auto Unlink(TaskControlBlock* task) -> void {
+    auto* link = static_cast<RtRunQueueLink*>(task);
+    auto level = task->sched_data.mlfq.level;
+    if (link->etl_previous) {
+      link->etl_previous->etl_next = link->etl_next;
+    } else {
+      heads_[level] = link->etl_next;
+    }
+    if (link->etl_next) {
+      link->etl_next->etl_previous = link->etl_previous;
+    } else {
+      tails_[level] = link->etl_previous;
+    }
+    if (!heads_[level]) {
+      ready_bitmap_ &= ~(1U << level);
+    }
+    link->etl_previous = nullptr;
+    link->etl_next = nullptr;
+    task->sched_data.mlfq.queued = false;
+    --task_count_;
+  }
+
+  /**
+   * @brief 将所有低级别任务提升到最高级别 (保持相对顺序)
+   *
+   * 就绪任务按级别顺序拼接到最高级别队列尾部；不在队列中的任务
+   * (运行中或阻塞) 由提升代数在下次入队时补做提升。
+   */
+  auto BoostAll() -> void {
+    ++boost_epoch_;
+    for (uint8_t level = 1; level < kLevelCount; ++level) {
+      if (!heads_[level]) {
+        continue;
+      }
+      if (tails_[0]) {
+        tails_[0]->etl_next = heads_[level];
+        heads_[level]->etl_previous = tails_[0];
+      } else {
+        heads_[0] = heads_[level];
+      }
+      tails_[0] = tails_[level];
+      heads_[level] = nullptr;
+      tails_[level] = nullptr;
+    }
+    for (auto* link = heads_[0]; link; link = link->etl_next) {
+      auto& mlfq = static_cast<TaskControlBlock*>(link)->sched_data.mlfq;
+      mlfq.level = 0;
+      mlfq.ticks_used = 0;
+      mlfq.boost_epoch = boost_epoch_;
+    }
+    ready_bitmap_ = heads_[0] ? 1U : 0;
+    stats_mlfq_.total_boosts++;
+  }
+
+  /// 每个级别的队首
+  std::array<RtRunQueueLink*, kLevelCount> heads_{};
+  /// 每个级别的队尾
+  std::array<RtRunQueueLink*, kLevelCount> tails_{};
+
+  /// 非空级别位图 (bit i 置位表示级别 i 有就绪任务)
+  uint32_t ready_bitmap_{0};
+
+  /// 所有级别的任务总数
+  size_t task_count_{0};
+
+  /// 距离上次优先级提升经过的 tick 数
+  uint64_t ticks_since_boost_{0};
+
+  /// 优先级提升代数，任务记录的代数落后时在入队时提升
+  uint32_t boost_epoch_{0};
+
+  /// MLFQ 额外统计
+  MlfqStats stats_mlfq_{};
+};
@@ -76,6 +76,21 @@ class SchedulerBase {
     return false;
   }
 
+  /**
+   * @brief 时钟推进：每个时钟中断时对核心上的所有调度器调用
+   *
+   * 与 OnTick 不同，无论当前任务属于哪个调度器都会调用，
+   * 用于基于时间的状态维护（如 Deadline 调度器补充节流任务的预算）
+   *
+   * @param now 当前核心的 tick 计数
+   * @return true 表示有任务重新变为就绪
+   * @return false 表示就绪状态没有变化
+   */
+  [[nodiscard]] virtual auto OnClockTick([[maybe_unused]] uint64_t now)
+      -> bool {
+    return false;
+  }
+
   /**
    * @brief 时间片耗尽处理：当任务时间片用完时调用
    *
@@ -0,0 +1,266 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "completion.hpp"
+#include "expected.hpp"
+#include "io_buffer.hpp"
+#include "spinlock.hpp"
+
+namespace vfs {
+class BlockDevice;
+}  // namespace vfs
+
+/**
+ * @brief 系统调用环的共享区头部 (用户态与内核共享的布局)
+ *
+ * 共享区依次为：头部、提交队列 (SQ)、完成队列 (CQ)，偏移量由内核填写。
+ * - SQ: 用户态写入表项后推进 sq_tail，内核消费后推进 sq_head
+ * - CQ: 内核写入表项后推进 cq_tail，用户态消费后推进 cq_head
+ * head/tail 为自由递增的计数，下标为 计数 & (entries - 1)
+ */
+struct SyscallRingHeader {
+  /// SQ 消费位置 (内核写)
+  std::atomic<uint32_t> sq_head;
+  /// SQ 生产位置 (用户写)
+  std::atomic<uint32_t> sq_tail;
+  /// CQ 消费位置 (用户写)
+  std::atomic<uint32_t> cq_head;
+  /// CQ 生产位置 (内核写)
+  std::atomic<uint32_t> cq_tail;
+  /// SQ 表项数 (2 的幂)
+  uint32_t sq_entries;
+  /// CQ 表项数 (2 的幂)
+  uint32_t cq_entries;
+  /// SQ 数组相对共享区起始的字节偏移
+  uint32_t sq_offset;
+  /// CQ 数组相对共享区起始的字节偏移
+  uint32_t cq_offset;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "ring indices are shared with user space");
+
+/**
+ * @brief 提交队列表项：一次系统调用
+ */
+struct SyscallSqe {
+  /// 系统调用号 (kSyscall*)
+  uint64_t opcode;
+  /// 系统调用参数
+  uint64_t args[6];
+  /// 用户数据，原样写回对应的完成表项
+  uint64_t user_data;
+};
+
+/**
+ * @brief 完成队列表项：一次系统调用的结果
+ */
+struct SyscallCqe {
+  /// 提交表项的 user_data
+  uint64_t user_data;
+  /// 系统调用返回值
+  int64_t result;
+};
+
+/**
+ * @brief 每个任务的批量系统调用环 (类似 io_uring)
+ *
+ * 用户态在 SQ 中写入多个请求，通过一次 ring_enter 陷入内核批量执行，
+ * 结果写入 CQ，从而分摊每次陷入的开销。
+ *
+ * - 每个取出的提交表项都预留一个 CQ 位置，CQ 不会溢出
+ * - 能直接交给块设备的请求 (见 sys_ring_enter) 异步执行，由请求的
+ *   end_io 写入结果；其余请求在 ring_enter 中同步执行
+ * - 同一时刻的异步请求都提交到同一个块设备，等待时只需推进该设备
+ * - 内核只信任自己保存的 head/tail 与容量，共享区中用户可写的字段
+ *   仅作为输入并做范围检查
+ */
+class SyscallRing {
+ public:
+  /// 最大 SQ 表项数
+  static constexpr uint32_t kMaxEntries = 256;
+
+  /**
+   * @brief 检查共享区是否分配成功
+   * @return bool 有效返回 true
+   */
+  [[nodiscard]] auto IsValid() const -> bool { return header_ != nullptr; }
+
+  /**
+   * @brief 获取共享区头部 (内核地址)
+   * @return SyscallRingHeader* 头部指针
+   */
+  [[nodiscard]] auto GetHeader() const -> SyscallRingHeader* {
+    return header_;
+  }
+
+  /**
+   * @brief 获取共享区大小
+   * @return size_t 字节数 (页对齐)
+   */
+  [[nodiscard]] auto GetSize() const -> size_t {
+    return buffer_.GetBuffer().size();
+  }
+
+  /**
+   * @brief 获取 SQ 表项数
+   * @return uint32_t 表项数
+   */
+  [[nodiscard]] auto GetSqEntries() const -> uint32_t { return sq_mask_ + 1; }
+
+  /**
+   * @brief 获取 CQ 表项数
+   * @return uint32_t 表项数
+   */
+  [[nodiscard]] auto GetCqEntries() const -> uint32_t { return cq_mask_ + 1; }
+
+  /**
+   * @brief 将共享区映射到用户页表
+   * @param page_table 用户页表
+   * @param user_addr 用户虚拟地址 (页对齐)
+   * @return Expected<void> 地址非法或映射失败时返回错误，
+   * 范围超出用户地址空间时返回 kBadAddress，
+   * 范围内已有映射时返回 kVmPageAlreadyMapped
+   * @post 失败时不留下部分映射，也不改动已有的映射
+   */
+  [[nodiscard]] auto MapTo(uint64_t* page_table, uintptr_t user_addr)
+      -> Expected<void>;
+
+  /**
+   * @brief 从页表中移除共享区的映射
+   * @param page_table 页表 (可以是 fork 复制出的页表)
+   * @note 共享区的物理页由本对象释放，销毁页表前必须先移除映射
+   */
+  auto UnmapFrom(uint64_t* page_table) const -> void;
+
+  /**
+   * @brief 获取共享区在用户空间的地址
+   * @return uintptr_t 已映射时返回用户地址，否则返回内核地址
+   */
+  [[nodiscard]] auto GetUserAddress() const -> uintptr_t;
+
+  /**
+   * @brief 获取映射共享区的用户页表
+   * @return uint64_t* 未映射时返回 nullptr
+   */
+  [[nodiscard]] auto GetPageTable() const -> uint64_t* { return page_table_; }
+
+  /**
+   * @brief 取出一个提交表项，并为其预留一个 CQ 位置
+   * @param sqe 输出，表项的拷贝 (之后用户态修改共享区不会影响内核)
+   * @return bool SQ 为空或 CQ 没有空闲位置时返回 false
+   */
+  [[nodiscard]] auto PopSubmission(SyscallSqe& sqe) -> bool;
+
+  /**
+   * @brief 写入一个完成表项
+   * @param user_data 对应提交表项的 user_data
+   * @param result 系统调用返回值
+   * @pre 已通过 PopSubmission 预留位置
+   */
+  auto PostCompletion(uint64_t user_data, int64_t result) -> void;
+
+  /**
+   * @brief 登记一个提交给块设备、由 end_io 写入结果的请求
+   * @param device 请求提交到的块设备
+   * @return bool 还有提交到其它设备的请求未完成时返回 false，调用者
+   * 改为同步执行该请求
+   * @pre 已通过 PopSubmission 预留位置
+   */
+  [[nodiscard]] auto BeginAsync(vfs::BlockDevice* device) -> bool;
+
+  /**
+   * @brief 写入 BeginAsync 登记的请求的完成表项并唤醒等待者
+   * @param user_data 对应提交表项的 user_data
+   * @param result 系统调用返回值
+   * @note 可在中断上下文中调用
+   */
+  auto PostAsyncCompletion(uint64_t user_data, int64_t result) -> void;
+
+  /**
+   * @brief 等待 CQ 中至少有 min_complete 个未消费的表项
+   * @param min_complete 期望的表项数
+   * @note 没有未完成的异步请求时立即返回，即使表项数不足
+   */
+  auto WaitCompletions(uint32_t min_complete) -> void;
+
+  /**
+   * @brief 获取 CQ 中尚未被用户态消费的表项数
+   * @return uint32_t 表项数
+   */
+  [[nodiscard]] auto GetCompletionCount() const -> uint32_t;
+
+  /**
+   * @brief 获取已提交但尚未完成的请求数
+   * @return uint32_t 请求数
+   */
+  [[nodiscard]] auto GetInflightCount() const -> uint32_t;
+
+  /// @name 构造/析构函数
+  /// @{
+
+  /**
+   * @brief 构造函数
+   * @param entries 期望的 SQ 表项数，向上取整为 2 的幂并限制在
+   * [1, kMaxEntries]，CQ 表项数为其两倍
+   * @post 分配失败时 IsValid() 返回 false
+   */
+  explicit SyscallRing(uint32_t entries);
+
+  SyscallRing(const SyscallRing&) = delete;
+  SyscallRing(SyscallRing&&) = delete;
+  auto operator=(const SyscallRing&) -> SyscallRing& = delete;
+  auto operator=(SyscallRing&&) -> SyscallRing& = delete;
+  /// 等待所有异步请求完成后释放共享区
+  ~SyscallRing();
+  /// @}
+
+ private:
+  /**
+   * @brief 等待异步请求完成
+   * @param min_complete CQ 中达到该表项数即返回
+   * @param drain 为 true 时忽略 min_complete，等待所有异步请求完成
+   */
+  auto WaitAsync(uint32_t min_complete, bool drain) -> void;
+
+  /// 共享区
+  IoBuffer buffer_;
+  /// 共享区头部
+  SyscallRingHeader* header_{nullptr};
+  /// SQ 数组
+  SyscallSqe* sq_{nullptr};
+  /// CQ 数组
+  SyscallCqe* cq_{nullptr};
+
+  /// SQ 下标掩码 (内核私有副本)
+  uint32_t sq_mask_{0};
+  /// CQ 下标掩码 (内核私有副本)
+  uint32_t cq_mask_{0};
+  /// SQ 消费位置 (内核私有副本)
+  uint32_t sq_head_{0};
+  /// CQ 生产位置 (内核私有副本)
+  uint32_t cq_tail_{0};
+  /// 已预留 CQ 位置但尚未完成的请求数
+  uint32_t inflight_{0};
+  /// 其中由块设备异步完成的请求数
+  uint32_t async_inflight_{0};
+  /// 异步请求提交到的块设备
+  vfs::BlockDevice* io_device_{nullptr};
+  /// 异步请求写入完成表项时标记完成
+  Completion cq_ready_{"syscall_ring"};
+
+  /// 映射共享区的用户页表
+  uint64_t* page_table_{nullptr};
+  /// 共享区的用户地址
+  uintptr_t user_addr_{0};
+
+  /// 保护内核侧的 head/tail
+  mutable SpinLock lock_{"syscall_ring"};
+};
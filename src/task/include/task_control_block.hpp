@@ -9,13 +9,17 @@
 #include <etl/intrusive_links.h>
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
+#include "arch.h"
 #include "file_descriptor.hpp"
 #include "resource_id.hpp"
 #include "task_fsm.hpp"
 
+class SyscallRing;
+
 /// 进程 ID 类型
 using Pid = size_t;
 
@@ -59,23 +63,49 @@ namespace TaskStatus = TaskStatusId;
  * @brief 调度策略
  */
 enum class SchedPolicy : uint8_t {
-  /// 实时任务 (最高优先级)
-  kRealTime = 0,
+  /// 截止时间任务 (EDF，最高优先级)
+  kDeadline = 0,
+  /// 实时任务
+  kRealTime = 1,
   /// 普通任务
-  kNormal = 1,
+  kNormal = 2,
   /// 空闲任务 (最低优先级)
-  kIdle = 2,
+  kIdle = 3,
   /// 策略数量
   kPolicyCount
 };
 
+/**
+ * @brief 调度属性 (sched_setattr 的内核表示，时间单位为 tick)
+ */
+struct SchedAttr {
+  /// 调度策略
+  SchedPolicy policy{SchedPolicy::kNormal};
+  /// 优先级 (数字越小优先级越高，kDeadline 不使用)
+  int priority{10};
+  /// 每周期运行预算 (仅 kDeadline)
+  uint64_t runtime{0};
+  /// 相对截止时间 (仅 kDeadline)
+  uint64_t deadline{0};
+  /// 周期 (仅 kDeadline)
+  uint64_t period{0};
+};
+
 /// 线程组侵入式链表节点类型
 using ThreadGroupLink = etl::bidirectional_link<0>;
 
+/// 截止时间调度器侵入式树节点类型
+using DeadlineLink = etl::tree_link<1>;
+
+/// 多级就绪队列侵入式链表节点类型 (FIFO 与 MLFQ 共用)
+using RtRunQueueLink = etl::bidirectional_link<2>;
+
 /**
  * @brief 任务控制块，管理进程/线程的核心数据结构
  */
-struct TaskControlBlock : public ThreadGroupLink {
+struct TaskControlBlock : public ThreadGroupLink,
+                          public DeadlineLink,
+                          public RtRunQueueLink {
   /// 默认内核栈大小 (16 KB)
   static constexpr size_t kDefaultKernelStackSize = 16 * 1024;
 
@@ -173,7 +203,37 @@ struct TaskControlBlock : public ThreadGroupLink {
     struct {
       /// 优先级级别 (0 = 最高)
       uint8_t level;
+      /// 在当前级别已消耗的 tick 数 (跨多次调度累计)
+      uint32_t ticks_used;
+      /// 是否在就绪队列中
+      bool queued;
+      /// 最近一次生效的优先级提升代数
+      uint32_t boost_epoch;
     } mlfq;
+
+    /// 实时调度器数据
+    struct {
+      /// 所在就绪队列的优先级级别 (入队时由优先级确定)
+      uint8_t level;
+      /// 是否在就绪队列中
+      bool queued;
+    } rt;
+
+    /// Deadline 调度器数据
+    struct {
+      /// 每周期运行预算 (ticks)
+      uint64_t runtime;
+      /// 相对截止时间 (ticks)
+      uint64_t deadline;
+      /// 周期 (ticks)
+      uint64_t period;
+      /// 当前绝对截止时间 (ticks)
+      uint64_t abs_deadline;
+      /// 本周期剩余预算 (ticks)
+      uint64_t runtime_remaining;
+      /// 预算耗尽，等待下个周期补充
+      bool throttled;
+    } dl;
   } sched_data{};
 
   /// 内核栈
@@ -186,9 +246,23 @@ struct TaskControlBlock : public ThreadGroupLink {
   /// 页表
   uint64_t* page_table{nullptr};
 
+  /// FPU/SIMD 状态保存区 (惰性切换，仅在任务使用过 FPU 后有效)
+  FpuState fpu_state{};
+  /// 是否使用过 FPU，首次使用时初始化 fpu_state
+  bool fpu_used{false};
+  /// 最后一次在哪个核心上加载 FPU 状态 (用于判断核心寄存器是否仍有效)
+  size_t fpu_cpu{SIMPLEKERNEL_MAX_CORE_COUNT};
+
   /// CPU 亲和性位掩码
   CpuAffinity cpu_affinity{UINT64_MAX};
 
+  /// 所在核心 ID (所属 CpuSchedData 的索引)
+  size_t cpu_id{0};
+
+  /// 被选中运行后置位，换出并在 switch_to 中保存上下文后清除；
+  /// 迁移到其他核心或释放 TCB 前必须等待其清除
+  std::atomic<bool> on_cpu{false};
+
   /// 等待的资源 ID
   ResourceId blocked_on{};
 
@@ -199,9 +273,12 @@ struct TaskControlBlock : public ThreadGroupLink {
 
   /// @todo 优先级继承相关
 
-  /// 文件描述符表
+  /// 文件描述符表 (首次使用时创建，带 kFiles 的 clone 共享同一张表)
   filesystem::FileDescriptorTable* fd_table{nullptr};
 
+  /// 批量系统调用环 (sys_ring_setup 创建，不被 clone 继承)
+  SyscallRing* syscall_ring{nullptr};
+
   /**
    * @brief 获取当前任务状态
    * @return etl::fsm_state_id_t 当前任务状态 ID
@@ -243,6 +320,13 @@ struct TaskControlBlock : public ThreadGroupLink {
     return other && (tgid == other->tgid) && (tgid != 0);
   }
 
+  /**
+   * @brief 获取文件描述符表，不存在时创建
+   * @return filesystem::FileDescriptorTable* 文件描述符表，内存不足时为 nullptr
+   * @note 只应由任务自身（系统调用或 clone 时的父任务）调用
+   */
+  [[nodiscard]] auto GetFdTable() -> filesystem::FileDescriptorTable*;
+
   /// @name 构造/析构函数
   /// @{
   /**
@@ -14,6 +14,7 @@
 
 #include <MPMCQueue.hpp>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
@@ -26,6 +27,7 @@
 #include "scheduler_base.hpp"
 #include "spinlock.hpp"
 #include "task_control_block.hpp"
+#include "vdso.hpp"
 
 /**
  * @brief 每个核心的调度数据 (RunQueue)
@@ -53,6 +55,10 @@ struct CpuSchedData {
       kernel::config::kMaxBlockedGroupsBuckets>
       blocked_tasks;
 
+  /// 带超时的阻塞任务 (超时 tick 记录在 sched_info.wake_tick)
+  etl::vector<TaskControlBlock*, kernel::config::kMaxSleepingTasks>
+      timed_blocked_tasks;
+
   /// Per-CPU tick 计数 (每个核心独立计时)
   uint64_t local_tick{0};
 
@@ -62,6 +68,13 @@ struct CpuSchedData {
   /// 本核心的总调度次数
   uint64_t total_schedules{0};
 
+  /// 已分配给 deadline 任务的带宽 (DeadlineScheduler::ToBandwidth 定点数)
+  uint64_t dl_bandwidth{0};
+
+  /// 等待迁移到其他核心的任务 (上下文保存后由 DrainMigrations 处理)
+  etl::vector<TaskControlBlock*, kernel::config::kMaxReadyTasks>
+      pending_migrations;
+
   /// @name 构造/析构函数
   /// @{
   CpuSchedData() = default;
@@ -136,6 +149,31 @@ class TaskManager {
    */
   auto Block(ResourceId resource_id) -> void;
 
+  /**
+   * @brief 阻塞当前任务，直到条件满足或超时
+   * @param resource_id 等待的资源 ID
+   * @param condition 唤醒条件，持有调度锁时检查，已满足时不阻塞
+   * @param timeout_ms 超时毫秒数，为 0 时不超时
+   * @return bool 返回时条件是否满足
+   * @note 唤醒方先设置条件再调用 Wakeup，不会丢失唤醒
+   */
+  [[nodiscard]] auto BlockUntil(ResourceId resource_id,
+                                const std::atomic<bool>& condition,
+                                uint64_t timeout_ms) -> bool;
+
+  /**
+   * @brief 阻塞当前任务，直到状态字中指定的位全部清除或超时
+   * @param resource_id 等待的资源 ID
+   * @param state 状态字，持有调度锁时检查，mask 位已清除时不阻塞
+   * @param mask 等待清除的状态位
+   * @param timeout_ms 超时毫秒数，为 0 时不超时
+   * @return bool 返回时 mask 位是否已全部清除
+   * @note 唤醒方先清除状态位再调用 Wakeup，不会丢失唤醒
+   */
+  [[nodiscard]] auto BlockUntil(ResourceId resource_id,
+                                const std::atomic<uint32_t>& state,
+                                uint32_t mask, uint64_t timeout_ms) -> bool;
+
   /**
    * @brief 唤醒等待指定资源的所有任务
    * @param resource_id 资源 ID
@@ -174,6 +212,65 @@ class TaskManager {
   [[nodiscard]] auto Wait(Pid pid, int* status, bool no_hang = false,
                           bool untraced = false) -> Expected<Pid>;
 
+  /**
+   * @brief 设置任务的调度属性 (sched_setattr)
+   *
+   * 切换到 kDeadline 时对任务所在核心做带宽准入控制：
+   * 已分配带宽 + runtime/period 不得超过 DeadlineScheduler::kMaxBandwidth。
+   * 就绪状态的任务会从原调度器移到新调度器。
+   *
+   * @param task 目标任务
+   * @param attr 新的调度属性 (时间单位为 tick)
+   * @return Expected<void> 参数非法或准入失败时返回错误
+   */
+  [[nodiscard]] auto SetSchedAttr(TaskControlBlock* task,
+                                  const SchedAttr& attr) -> Expected<void>;
+
+  /**
+   * @brief 设置任务的 CPU 亲和性，必要时立即迁移任务
+   *
+   * - 就绪任务：从原核心的调度器摘下，加入负载最低的允许核心
+   * - 在其他核心上运行的任务：向该核心发送 IPI，由其在调度时迁出
+   * - 当前任务：立即调度，在上下文保存后迁出
+   * - 睡眠/阻塞的任务：唤醒后由原核心在调度时迁出
+   *
+   * @param task 目标任务
+   * @param affinity 新的亲和性掩码
+   * @return Expected<void> 掩码中没有在线核心时返回错误
+   * @note 可能触发调度，不能在中断上下文中调用
+   */
+  [[nodiscard]] auto SetAffinity(TaskControlBlock* task, CpuAffinity affinity)
+      -> Expected<void>;
+
+  /**
+   * @brief 迁移 IPI 处理：迁出本核心待迁移的任务，
+   * 当前任务不再允许在本核心运行时重新调度
+   * @note 由各架构的 IPI 中断处理函数调用
+   */
+  auto HandleMigrateIpi() -> void;
+
+  /**
+   * @brief FPU 陷入处理：为当前任务加载其 FPU 状态 (首次使用时初始化)
+   * @note 由各架构禁用 FPU 后的首次 FPU/SIMD 指令陷入处理函数调用
+   */
+  auto HandleFpuTrap() -> void;
+
+  /**
+   * @brief 任务退出时放弃 FPU 所有权
+   *
+   * 清除任务最后加载 FPU 状态的核心 (fpu_cpu) 上的 fpu_owner，
+   * 该核心可能不是当前核心
+   *
+   * @param task 退出的任务
+   */
+  auto ReleaseFpu(TaskControlBlock* task) -> void;
+
+  /**
+   * @brief 完成任务切换：清除换出任务的 on_cpu，回收没有父进程的退出任务
+   * @note 在 switch_to 返回后、或新任务从 kernel_thread_entry 开始运行时调用
+   */
+  auto FinishSwitch() -> void;
+
   /**
    * @brief 按 PID 查找任务
    * @param pid 进程 ID
@@ -181,6 +278,12 @@ class TaskManager {
    */
   [[nodiscard]] auto FindTask(Pid pid) -> TaskControlBlock*;
 
+  /**
+   * @brief 获取 vDSO/vvar 页
+   * @return const Vdso& vDSO 管理对象
+   */
+  [[nodiscard]] auto GetVdso() const -> const Vdso& { return vdso_; }
+
   /// @name 构造/析构函数
   /// @{
   TaskManager() = default;
@@ -242,6 +345,9 @@ class TaskManager {
   /// PID 分配器
   std::atomic<size_t> pid_allocator_{1};
 
+  /// 映射到所有用户地址空间的 vvar 页
+  Vdso vdso_;
+
   /**
    * @brief 分配新的 PID
    * @return size_t 新的 PID
@@ -253,6 +359,116 @@ class TaskManager {
    */
   auto Balance() -> void;
 
+  /**
+   * @brief 判断核心是否已初始化调度数据
+   * @param core_id 核心 ID
+   * @return bool 已调用过 InitCurrentCore 返回 true
+   */
+  [[nodiscard]] auto IsCoreOnline(size_t core_id) const -> bool {
+    return core_id < SIMPLEKERNEL_MAX_CORE_COUNT &&
+           cpu_schedulers_[core_id]
+               .schedulers[static_cast<uint8_t>(SchedPolicy::kNormal)];
+  }
+
+  /**
+   * @brief 判断任务是否允许在指定核心上运行
+   * @param task 任务控制块指针
+   * @param core_id 核心 ID
+   * @return bool 亲和性掩码包含该核心返回 true
+   */
+  [[nodiscard]] static auto IsAllowedOn(const TaskControlBlock* task,
+                                        size_t core_id) -> bool {
+    return core_id < 64 && (task->cpu_affinity.value() & (1ULL << core_id));
+  }
+
+  /**
+   * @brief 判断任务是否需要从指定核心迁出 (idle 任务固定在其核心)
+   * @param task 任务控制块指针
+   * @param core_id 核心 ID
+   * @return bool 非 idle 任务且亲和性不包含该核心时返回 true
+   */
+  [[nodiscard]] static auto NeedMigrate(const TaskControlBlock* task,
+                                        size_t core_id) -> bool {
+    return task->policy != SchedPolicy::kIdle && !IsAllowedOn(task, core_id);
+  }
+
+  /**
+   * @brief 获取核心负载 (就绪任务数 + 正在运行的非 idle 任务)
+   * @param core_id 核心 ID
+   * @return size_t 负载值
+   * @note 不加锁读取，结果仅作为放置决策的参考
+   */
+  [[nodiscard]] auto GetCoreLoad(size_t core_id) const -> size_t;
+
+  /**
+   * @brief 选择任务允许运行的负载最低的在线核心 (相同负载优先当前核心)
+   * @param task 任务控制块指针
+   * @return size_t 核心 ID，没有可用核心时返回 SIMPLEKERNEL_MAX_CORE_COUNT
+   */
+  [[nodiscard]] auto SelectCore(const TaskControlBlock* task) const -> size_t;
+
+  /**
+   * @brief 将不在任何队列中的就绪任务加入指定核心
+   * @param task 任务控制块指针
+   * @param core_id 目标核心 ID
+   */
+  auto AttachTask(TaskControlBlock* task, size_t core_id) -> void;
+
+  /**
+   * @brief 将任务加入本核心的待迁移列表 (调用者持有 cpu_sched.lock)
+   * @param cpu_sched 任务所在核心的调度数据
+   * @param task 已从调度器摘下的就绪任务
+   */
+  auto QueueMigration(CpuSchedData& cpu_sched, TaskControlBlock* task) -> void;
+
+  /**
+   * @brief 将本核心待迁移的任务加入各自的目标核心
+   * @param cpu_sched 本核心的调度数据 (调用者不能持有其锁)
+   */
+  auto DrainMigrations(CpuSchedData& cpu_sched) -> void;
+
+  /**
+   * @brief 任务切换时的惰性 FPU 处理
+   *
+   * 换出的任务持有 FPU 时保存其状态，换入的任务的状态仍在本核心寄存器中时
+   * 直接启用 FPU，否则禁用 FPU，等待其首次使用时陷入再恢复
+   *
+   * @param prev 换出的任务
+   * @param next 换入的任务
+   */
+  auto SwitchFpu(TaskControlBlock* prev, TaskControlBlock* next) -> void;
+
+  /**
+   * @brief 为 deadline 任务在核心上做带宽准入 (调用者持有 cpu_sched.lock)
+   * @param cpu_sched 目标核心的调度数据
+   * @param task deadline 任务
+   * @return bool 准入成功返回 true，并计入该核心的带宽
+   */
+  [[nodiscard]] static auto AdmitDeadline(CpuSchedData& cpu_sched,
+                                          const TaskControlBlock* task)
+      -> bool;
+
+  /**
+   * @brief 归还 deadline 任务占用的带宽 (调用者持有 cpu_sched.lock)
+   * @param cpu_sched 任务所在核心的调度数据
+   * @param task 任务，非 deadline 任务时不做任何事
+   */
+  static auto ReleaseDeadline(CpuSchedData& cpu_sched,
+                              const TaskControlBlock* task) -> void;
+
+  /**
+   * @brief BlockUntil 的公共实现
+   * @param resource_id 等待的资源 ID
+   * @param ready 唤醒条件，持有调度锁时以 arg 调用
+   * @param arg 传给 ready 的参数
+   * @param timeout_ms 超时毫秒数，为 0 时不超时
+   * @return bool 返回时条件是否满足
+   */
+  [[nodiscard]] auto BlockUntilReady(ResourceId resource_id,
+                                     bool (*ready)(const void*),
+                                     const void* arg, uint64_t timeout_ms)
+      -> bool;
+
   /**
    * @brief 获取当前核心的调度数据
    * @return CpuSchedData& 当前核心的调度数据引用
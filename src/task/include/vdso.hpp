@@ -0,0 +1,218 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "expected.hpp"
+
+struct TaskControlBlock;
+
+/**
+ * @brief vvar 页在用户空间的地址
+ * @note 位于 sv39 用户地址空间 (256 GB) 的末尾，x86_64/aarch64 同样可用
+ */
+inline constexpr uintptr_t kVvarUserAddr = 0x3FFFFFE000;
+
+/**
+ * @brief 每个核心的 vvar 数据，由该核心在任务切换时更新
+ * @note 用户态通过各架构的核心 ID 寄存器 (见 VdsoArchInit) 选择表项
+ */
+struct alignas(64) VdsoCoreData {
+  /// 顺序锁计数，奇数表示正在更新
+  std::atomic<uint32_t> seq;
+  /// 核心 ID
+  uint32_t core_id;
+  /// 该核心上正在运行的任务的线程 ID
+  uint64_t tid;
+  /// 该核心上正在运行的任务的线程组 ID
+  uint64_t tgid;
+};
+
+/**
+ * @brief vvar 页的布局 (只读映射到用户空间)
+ *
+ * 时钟部分由启动核在 TickUpdate 中更新，单调时钟按如下方式计算：
+ * ns = ns_last + ((counter - counter_last) * mult >> shift)
+ * 其中 counter 为 ReadTimestamp() 对应的硬件计数器
+ */
+struct VdsoData {
+  /// 时钟部分的顺序锁计数，奇数表示正在更新
+  std::atomic<uint32_t> seq;
+  /// 在线核心数
+  uint32_t core_count;
+  /// 硬件计数器频率 (Hz)，为 0 表示未校准，只能使用 ns_last
+  uint64_t counter_freq;
+  /// 上次更新时的计数器值
+  uint64_t counter_last;
+  /// 上次更新时的单调时钟 (纳秒)
+  uint64_t ns_last;
+  /// 计数器到纳秒的乘数
+  uint32_t mult;
+  /// 计数器到纳秒的移位
+  uint32_t shift;
+  /// 每个核心的数据
+  std::array<VdsoCoreData, SIMPLEKERNEL_MAX_CORE_COUNT> cores;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "vvar sequence counters are read from user space");
+
+/**
+ * @brief vDSO/vvar 管理
+ *
+ * 内核维护一个 vvar 页，只读映射到每个用户地址空间的 kVvarUserAddr，
+ * 用户态不陷入内核即可读取单调时钟、当前核心与线程 ID。
+ * 写入方使用顺序锁，读取方在计数为奇数或前后不一致时重试。
+ */
+class Vdso {
+ public:
+  /// 每秒纳秒数
+  static constexpr uint64_t kNanosecondsPerSecond = 1000000000;
+
+  /**
+   * @brief 分配 vvar 页并根据计数器频率计算换算参数
+   * @param counter_freq 硬件计数器频率 (Hz)，未知时为 0
+   * @param clock_core 负责更新时钟的核心 (启动核)
+   * @return Expected<void> 分配失败时返回错误
+   * @note 只由启动核调用一次
+   */
+  [[nodiscard]] auto Init(uint64_t counter_freq, size_t clock_core)
+      -> Expected<void>;
+
+  /**
+   * @brief 检查 vvar 页是否已分配
+   * @return bool 已分配返回 true
+   */
+  [[nodiscard]] auto IsValid() const -> bool { return data_ != nullptr; }
+
+  /**
+   * @brief 获取 vvar 页 (内核地址)
+   * @return const VdsoData* 未初始化时返回 nullptr
+   */
+  [[nodiscard]] auto GetData() const -> const VdsoData* { return data_; }
+
+  /**
+   * @brief 登记当前核心，并允许用户态读取计数器与核心 ID
+   * @param core_id 当前核心 ID
+   */
+  auto InitCore(size_t core_id) -> void;
+
+  /**
+   * @brief 更新单调时钟 (由 TickUpdate 调用)
+   * @param core_id 当前核心 ID，只有负责时钟的核心会更新
+   * @param tick 当前核心的 tick 计数
+   */
+  auto UpdateClock(size_t core_id, uint64_t tick) -> void;
+
+  /**
+   * @brief 更新核心上正在运行的任务 (任务切换时调用)
+   * @param core_id 当前核心 ID
+   * @param task 即将运行的任务
+   */
+  auto UpdateCore(size_t core_id, const TaskControlBlock* task) -> void;
+
+  /**
+   * @brief 将 vvar 页只读映射到用户页表
+   * @param page_table 用户页表
+   * @return Expected<void> 映射失败时返回错误
+   */
+  [[nodiscard]] auto MapTo(uint64_t* page_table) const -> Expected<void>;
+
+  /**
+   * @brief 从页表中移除 vvar 页的映射
+   * @param page_table 用户页表
+   * @note vvar 页不属于任何任务，释放页表的物理页前必须先移除映射
+   */
+  static auto UnmapFrom(uint64_t* page_table) -> void;
+
+  /**
+   * @brief 按用户态的方式读取单调时钟
+   * @param data vvar 页
+   * @param read_counter 读取硬件计数器的函数
+   * @return uint64_t 自启动以来的纳秒数
+   */
+  [[nodiscard]] static auto ReadClockNs(const VdsoData& data,
+                                        uint64_t (*read_counter)())
+      -> uint64_t {
+    while (true) {
+      auto seq = data.seq.load(std::memory_order_acquire);
+      if (seq & 1) {
+        continue;
+      }
+      auto ns = data.ns_last;
+      if (data.counter_freq != 0) {
+        ns += ((read_counter() - data.counter_last) * data.mult) >>
+              data.shift;
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (data.seq.load(std::memory_order_relaxed) == seq) {
+        return ns;
+      }
+    }
+  }
+
+  /**
+   * @brief 按用户态的方式读取核心上正在运行的任务
+   * @param data vvar 页
+   * @param core_id 核心 ID
+   * @param tid 输出，线程 ID
+   * @param tgid 输出，线程组 ID
+   */
+  static auto ReadCore(const VdsoData& data, size_t core_id, uint64_t& tid,
+                       uint64_t& tgid) -> void {
+    const auto& core = data.cores[core_id];
+    while (true) {
+      auto seq = core.seq.load(std::memory_order_acquire);
+      if (seq & 1) {
+        continue;
+      }
+      tid = core.tid;
+      tgid = core.tgid;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (core.seq.load(std::memory_order_relaxed) == seq) {
+        return;
+      }
+    }
+  }
+
+  /// @name 构造/析构函数
+  /// @{
+  Vdso() = default;
+  Vdso(const Vdso&) = delete;
+  Vdso(Vdso&&) = delete;
+  auto operator=(const Vdso&) -> Vdso& = delete;
+  auto operator=(Vdso&&) -> Vdso& = delete;
+  ~Vdso() = default;
+  /// @}
+
+ private:
+  /**
+   * @brief 开始写入：计数变为奇数
+   * @param seq 顺序锁计数
+   */
+  static auto WriteBegin(std::atomic<uint32_t>& seq) -> void {
+    seq.store(seq.load(std::memory_order_relaxed) + 1,
+              std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  /**
+   * @brief 结束写入：计数变为偶数
+   * @param seq 顺序锁计数
+   */
+  static auto WriteEnd(std::atomic<uint32_t>& seq) -> void {
+    seq.store(seq.load(std::memory_order_relaxed) + 1,
+              std::memory_order_release);
+  }
+
+  /// vvar 页
+  VdsoData* data_{nullptr};
+  /// 负责更新时钟的核心
+  size_t clock_core_{0};
+};
@@ -0,0 +1,250 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include <cpu_io.h>
+
+#include <initializer_list>
+#include <limits>
+
+#include "arch.h"
+#include "deadline_scheduler.hpp"
+#include "kernel_log.hpp"
+#include "per_cpu.hpp"
+#include "task_manager.hpp"
+
+auto TaskManager::SetAffinity(TaskControlBlock* task, CpuAffinity affinity)
+    -> Expected<void> {
+  // idle 任务固定在其所在核心
+  if (!task || task->policy == SchedPolicy::kIdle) {
+    return std::unexpected(Error(ErrorCode::kTaskInvalidAffinity));
+  }
+
+  // 掩码中至少要有一个在线核心
+  bool has_online_core = false;
+  for (size_t core_id = 0; core_id < SIMPLEKERNEL_MAX_CORE_COUNT; ++core_id) {
+    if (IsCoreOnline(core_id) && core_id < 64 &&
+        (affinity.value() & (1ULL << core_id))) {
+      has_online_core = true;
+      break;
+    }
+  }
+  if (!has_online_core) {
+    return std::unexpected(Error(ErrorCode::kTaskInvalidAffinity));
+  }
+
+  task->cpu_affinity = affinity;
+
+  auto current_core = cpu_io::GetCurrentCoreId();
+  bool detached = false;
+  bool need_schedule = false;
+  bool need_ipi = false;
+  size_t source = 0;
+
+  while (true) {
+    source = task->cpu_id;
+    // 正在迁移中的任务会在加入目标核心时按新的掩码选择核心
+    if (source >= SIMPLEKERNEL_MAX_CORE_COUNT || IsAllowedOn(task, source)) {
+      return {};
+    }
+
+    auto& cpu_sched = cpu_schedulers_[source];
+    LockGuard<SpinLock> lock_guard(cpu_sched.lock);
+    if (task->cpu_id != source) {
+      // 加锁前任务已被迁移，重新检查
+      continue;
+    }
+
+    switch (task->GetStatus()) {
+      case TaskStatus::kReady: {
+        auto* scheduler =
+            cpu_sched.schedulers[static_cast<uint8_t>(task->policy)].get();
+        if (scheduler) {
+          scheduler->Dequeue(task);
+        }
+        ReleaseDeadline(cpu_sched, task);
+        task->cpu_id = SIMPLEKERNEL_MAX_CORE_COUNT;
+        detached = true;
+        break;
+      }
+      case TaskStatus::kRunning:
+        // 运行中的任务只能由其所在核心在保存上下文后迁出
+        need_schedule = (source == current_core);
+        need_ipi = (source != current_core);
+        break;
+      default:
+        // 睡眠/阻塞的任务被唤醒后，由所在核心在调度时迁出
+        break;
+    }
+    break;
+  }
+
+  if (detached) {
+    // 源核心可能刚把任务放回就绪队列、尚未在 switch_to 中保存其上下文，
+    // 等待切换完成后再加入目标核心
+    while (task->on_cpu.load(std::memory_order_acquire)) {
+      cpu_io::Pause();
+    }
+    auto target = SelectCore(task);
+    AttachTask(task, target < SIMPLEKERNEL_MAX_CORE_COUNT ? target : source);
+    klog::Debug("SetAffinity: migrated pid={} from core {} to core {}",
+                task->pid, source, task->cpu_id);
+  }
+
+  if (need_ipi) {
+    // 发送失败时由目标核心的下一次 TickUpdate 发现并迁出
+    SendIpi(1ULL << source).or_else([source](auto&& err) {
+      klog::Warn("SetAffinity: IPI to core {} failed: {}", source,
+                 err.message());
+      return Expected<void>{};
+    });
+  }
+
+  if (need_schedule) {
+    Schedule();
+  }
+
+  return {};
+}
+
+auto TaskManager::HandleMigrateIpi() -> void {
+  auto core_id = cpu_io::GetCurrentCoreId();
+  if (!IsCoreOnline(core_id)) {
+    return;
+  }
+
+  DrainMigrations(cpu_schedulers_[core_id]);
+
+  auto* current = GetCurrentTask();
+  if (current && current->GetStatus() == TaskStatus::kRunning &&
+      NeedMigrate(current, core_id)) {
+    Schedule();
+  }
+}
+
+auto TaskManager::GetCoreLoad(size_t core_id) const -> size_t {
+  const auto& cpu_sched = cpu_schedulers_[core_id];
+  size_t load = 0;
+  for (size_t i = 0; i < cpu_sched.schedulers.size(); ++i) {
+    const auto& scheduler = cpu_sched.schedulers[i];
+    if (scheduler && i != static_cast<size_t>(SchedPolicy::kIdle)) {
+      load += scheduler->GetQueueSize();
+    }
+  }
+
+  const auto* running =
+      per_cpu::PerCpuArraySingleton::instance()[core_id].running_task;
+  if (running && running->policy != SchedPolicy::kIdle) {
+    ++load;
+  }
+  return load;
+}
+
+auto TaskManager::SelectCore(const TaskControlBlock* task) const -> size_t {
+  auto current_core = cpu_io::GetCurrentCoreId();
+  uint64_t bandwidth = 0;
+  if (task->policy == SchedPolicy::kDeadline) {
+    bandwidth = DeadlineScheduler::ToBandwidth(task->sched_data.dl.runtime,
+                                               task->sched_data.dl.period);
+  }
+
+  // 第一轮跳过带宽不足的核心，deadline 任务都放不下时再忽略带宽
+  for (bool check_bandwidth : {true, false}) {
+    size_t best_core = SIMPLEKERNEL_MAX_CORE_COUNT;
+    auto best_load = std::numeric_limits<size_t>::max();
+    for (size_t core_id = 0; core_id < SIMPLEKERNEL_MAX_CORE_COUNT;
+         ++core_id) {
+      if (!IsCoreOnline(core_id) || !IsAllowedOn(task, core_id)) {
+        continue;
+      }
+      if (check_bandwidth && bandwidth != 0 &&
+          cpu_schedulers_[core_id].dl_bandwidth + bandwidth >
+              DeadlineScheduler::kMaxBandwidth) {
+        continue;
+      }
+      auto load = GetCoreLoad(core_id);
+      if (load < best_load || (load == best_load && core_id == current_core)) {
+        best_core = core_id;
+        best_load = load;
+      }
+    }
+    if (best_core < SIMPLEKERNEL_MAX_CORE_COUNT || bandwidth == 0) {
+      return best_core;
+    }
+  }
+  return SIMPLEKERNEL_MAX_CORE_COUNT;
+}
+
+auto TaskManager::AttachTask(TaskControlBlock* task, size_t core_id) -> void {
+  auto& cpu_sched = cpu_schedulers_[core_id];
+  LockGuard<SpinLock> lock_guard(cpu_sched.lock);
+
+  task->cpu_id = core_id;
+
+  // deadline 任务需要通过目标核心的带宽准入，失败则降级为普通任务
+  if (task->policy == SchedPolicy::kDeadline &&
+      !AdmitDeadline(cpu_sched, task)) {
+    klog::Warn("AttachTask: deadline admission failed (pid={}, core={}), "
+               "use kNormal",
+               task->pid, core_id);
+    task->policy = SchedPolicy::kNormal;
+    task->sched_data = {};
+  }
+
+  if (task->policy < SchedPolicy::kPolicyCount) {
+    auto* scheduler =
+        cpu_sched.schedulers[static_cast<uint8_t>(task->policy)].get();
+    if (scheduler) {
+      scheduler->Enqueue(task);
+    }
+  }
+}
+
+auto TaskManager::QueueMigration(CpuSchedData& cpu_sched,
+                                 TaskControlBlock* task) -> void {
+  if (cpu_sched.pending_migrations.full()) {
+    // 放回本核心，下次调度时再尝试迁移
+    klog::Warn("QueueMigration: pending list full, keep pid={} on core {}",
+               task->pid, task->cpu_id);
+    auto* scheduler =
+        cpu_sched.schedulers[static_cast<uint8_t>(task->policy)].get();
+    if (scheduler) {
+      scheduler->Enqueue(task);
+    }
+    return;
+  }
+
+  ReleaseDeadline(cpu_sched, task);
+  task->cpu_id = SIMPLEKERNEL_MAX_CORE_COUNT;
+  cpu_sched.pending_migrations.push_back(task);
+}
+
+auto TaskManager::DrainMigrations(CpuSchedData& cpu_sched) -> void {
+  auto current_core = cpu_io::GetCurrentCoreId();
+
+  // 每次只在持有本核心锁时取出一个任务，加入目标核心时不持有本核心的锁，
+  // 避免同时持有两个核心的锁
+  while (true) {
+    TaskControlBlock* task = nullptr;
+    {
+      LockGuard<SpinLock> lock_guard(cpu_sched.lock);
+      if (cpu_sched.pending_migrations.empty()) {
+        return;
+      }
+      task = cpu_sched.pending_migrations.back();
+      // 在切换完成前被中断 (如迁移 IPI) 时，上下文尚未保存，下次再处理
+      if (task->on_cpu.load(std::memory_order_acquire)) {
+        return;
+      }
+      cpu_sched.pending_migrations.pop_back();
+    }
+
+    auto target = SelectCore(task);
+    if (target >= SIMPLEKERNEL_MAX_CORE_COUNT) {
+      klog::Warn("DrainMigrations: no allowed core for pid={}, keep on core {}",
+                 task->pid, current_core);
+      target = current_core;
+    }
+    AttachTask(task, target);
+  }
+}
@@ -0,0 +1,84 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "rw_mutex.hpp"
+
+#include <cpu_io.h>
+
+#include "kernel_log.hpp"
+#include "task_manager.hpp"
+
+auto RwMutex::ReadLock() -> void {
+  auto state = state_.load(std::memory_order_relaxed);
+  while (true) {
+    if ((state & (kWriter | kWriterWaiting)) != 0) {
+      Wait(kWriter | kWriterWaiting);
+      state = state_.load(std::memory_order_relaxed);
+      continue;
+    }
+    if (state_.compare_exchange_weak(state, state + 1,
+                                     std::memory_order_acquire,
+                                     std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+auto RwMutex::ReadUnlock() -> void {
+  // 与等待者对 waiters_ 的登记构成 Dekker 式同步，需要 seq_cst
+  auto prev = state_.fetch_sub(1, std::memory_order_seq_cst);
+  // 最后一个读者离开时唤醒等待的写者
+  if ((prev & kReaderMask) == 1) {
+    WakeWaiters();
+  }
+}
+
+auto RwMutex::WriteLock() -> void {
+  auto state = state_.load(std::memory_order_relaxed);
+  while (true) {
+    if ((state & ~kWriterWaiting) == 0) {
+      // 获取成功时清除等待标志，其余等待的写者会重新设置
+      if (state_.compare_exchange_weak(state, kWriter,
+                                       std::memory_order_acquire,
+                                       std::memory_order_relaxed)) {
+        return;
+      }
+      continue;
+    }
+    if ((state & kWriterWaiting) == 0 &&
+        !state_.compare_exchange_weak(state, state | kWriterWaiting,
+                                      std::memory_order_relaxed,
+                                      std::memory_order_relaxed)) {
+      continue;
+    }
+    Wait(~kWriterWaiting);
+    state = state_.load(std::memory_order_relaxed);
+  }
+}
+
+auto RwMutex::WriteUnlock() -> void {
+  state_.fetch_and(~kWriter, std::memory_order_seq_cst);
+  WakeWaiters();
+}
+
+auto RwMutex::Wait(uint32_t mask) -> void {
+  auto& task_manager = TaskManagerSingleton::instance();
+  if (task_manager.GetCurrentTask() == nullptr) {
+    cpu_io::Pause();
+    return;
+  }
+
+  // 先登记为等待者，释放者清除状态位后看到计数才会唤醒；状态位在持有
+  // 调度锁时再次检查，释放者清除状态位后才获取调度锁，不会丢失唤醒
+  waiters_.fetch_add(1, std::memory_order_seq_cst);
+  klog::Debug("RwMutex::Wait: waiting on '{}'", name);
+  (void)task_manager.BlockUntil(resource_id_, state_, mask, 0);
+  waiters_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+auto RwMutex::WakeWaiters() -> void {
+  if (waiters_.load(std::memory_order_seq_cst) != 0) {
+    TaskManagerSingleton::instance().Wakeup(resource_id_);
+  }
+}
@@ -0,0 +1,106 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "deadline_scheduler.hpp"
+#include "kernel_log.hpp"
+#include "task_manager.hpp"
+
+auto TaskManager::SetSchedAttr(TaskControlBlock* task, const SchedAttr& attr)
+    -> Expected<void> {
+  if (!task || attr.policy >= SchedPolicy::kPolicyCount) {
+    return std::unexpected(Error(ErrorCode::kTaskInvalidSchedAttr));
+  }
+
+  // 与 Linux 一致：period 为 0 时视为等于 deadline
+  auto period = attr.period == 0 ? attr.deadline : attr.period;
+  if (attr.policy == SchedPolicy::kDeadline &&
+      (attr.runtime == 0 || attr.runtime > attr.deadline ||
+       attr.deadline > period || period > DeadlineScheduler::kMaxTicks)) {
+    return std::unexpected(Error(ErrorCode::kTaskInvalidSchedAttr));
+  }
+
+  // 正在迁移的任务不属于任何核心，无法做带宽准入
+  if (task->cpu_id >= SIMPLEKERNEL_MAX_CORE_COUNT) {
+    return std::unexpected(Error(ErrorCode::kTaskInvalidSchedAttr));
+  }
+
+  auto& cpu_sched = cpu_schedulers_[task->cpu_id];
+  LockGuard<SpinLock> lock_guard(cpu_sched.lock);
+
+  // 带宽准入：先扣除任务原有的带宽，再加上新的带宽
+  uint64_t old_bandwidth = 0;
+  if (task->policy == SchedPolicy::kDeadline) {
+    old_bandwidth = DeadlineScheduler::ToBandwidth(task->sched_data.dl.runtime,
+                                                   task->sched_data.dl.period);
+  }
+  uint64_t new_bandwidth = 0;
+  if (attr.policy == SchedPolicy::kDeadline) {
+    new_bandwidth = DeadlineScheduler::ToBandwidth(attr.runtime, period);
+    if (cpu_sched.dl_bandwidth - old_bandwidth + new_bandwidth >
+        DeadlineScheduler::kMaxBandwidth) {
+      klog::Debug("SetSchedAttr: admission failed (pid={}, core={})",
+                  task->pid, task->cpu_id);
+      return std::unexpected(Error(ErrorCode::kTaskDeadlineAdmissionFailed));
+    }
+  }
+  cpu_sched.dl_bandwidth =
+      cpu_sched.dl_bandwidth - old_bandwidth + new_bandwidth;
+
+  // 就绪任务需要在调度器之间迁移，运行中的任务在下次 Schedule() 时生效
+  bool is_ready = task->GetStatus() == TaskStatus::kReady;
+  auto* old_scheduler =
+      cpu_sched.schedulers[static_cast<uint8_t>(task->policy)].get();
+  if (is_ready && old_scheduler) {
+    old_scheduler->Dequeue(task);
+  }
+
+  if (task->policy != attr.policy) {
+    task->sched_data = {};
+  }
+  task->policy = attr.policy;
+
+  if (attr.policy == SchedPolicy::kDeadline) {
+    // 从当前时刻开始第一个周期
+    auto& dl = task->sched_data.dl;
+    dl.runtime = attr.runtime;
+    dl.deadline = attr.deadline;
+    dl.period = period;
+    dl.abs_deadline = cpu_sched.local_tick + attr.deadline;
+    dl.runtime_remaining = attr.runtime;
+    dl.throttled = false;
+  } else {
+    task->sched_info.priority = attr.priority;
+    task->sched_info.base_priority = attr.priority;
+  }
+
+  auto* new_scheduler =
+      cpu_sched.schedulers[static_cast<uint8_t>(task->policy)].get();
+  if (is_ready && new_scheduler) {
+    new_scheduler->Enqueue(task);
+  }
+
+  return {};
+}
+
+auto TaskManager::AdmitDeadline(CpuSchedData& cpu_sched,
+                                const TaskControlBlock* task) -> bool {
+  const auto& dl = task->sched_data.dl;
+  auto bandwidth = DeadlineScheduler::ToBandwidth(dl.runtime, dl.period);
+  if (dl.runtime == 0 ||
+      cpu_sched.dl_bandwidth + bandwidth > DeadlineScheduler::kMaxBandwidth) {
+    return false;
+  }
+  cpu_sched.dl_bandwidth += bandwidth;
+  return true;
+}
+
+auto TaskManager::ReleaseDeadline(CpuSchedData& cpu_sched,
+                                  const TaskControlBlock* task) -> void {
+  if (task->policy != SchedPolicy::kDeadline) {
+    return;
+  }
+  const auto& dl = task->sched_data.dl;
+  cpu_sched.dl_bandwidth -=
+      DeadlineScheduler::ToBandwidth(dl.runtime, dl.period);
+}
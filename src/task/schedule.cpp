@@ -5,6 +5,7 @@
 #include <cpu_io.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <memory>
 #include <new>
@@ -24,7 +25,12 @@
 #include "virtual_memory.hpp"
 
 auto TaskManager::Schedule() -> void {
+  auto core_id = cpu_io::GetCurrentCoreId();
   auto& cpu_sched = GetCurrentCpuSched();
+
+  // 上一次调度中换出的任务已保存上下文，可以加入其他核心
+  DrainMigrations(cpu_sched);
+
   cpu_sched.lock.Lock().or_else([](auto&& err) {
     klog::Err("Schedule: Failed to acquire lock: {}", err.message());
     while (true) {
@@ -45,29 +51,46 @@ auto TaskManager::Schedule() -> void {
 
     if (scheduler) {
       scheduler->OnPreempted(current);
-      // 调度器决定如何处理被抢占的任务
-      // 大多数情况下需要重新入队，除非是特殊策略
-      if (scheduler->OnTimeSliceExpired(current)) {
+      if (NeedMigrate(current, core_id)) {
+        // 亲和性已不包含本核心，切换后由本核心迁出
+        QueueMigration(cpu_sched, current);
+      } else if (scheduler->OnTimeSliceExpired(current)) {
+        // 调度器决定如何处理被抢占的任务
+        // 大多数情况下需要重新入队，除非是特殊策略
         scheduler->Enqueue(current);
       }
     }
   }
 
-  // 选择下一个任务 (按策略优先级: RealTime > Normal > Idle)
+  // 选择下一个任务 (按策略优先级: Deadline > RealTime > Normal > Idle)
+  // 不允许在本核心运行的任务 (被唤醒后亲和性已改变) 加入待迁移列表
   TaskControlBlock* next = nullptr;
   for (auto& scheduler : cpu_sched.schedulers) {
-    if (scheduler && !scheduler->IsEmpty()) {
-      next = scheduler->PickNext();
-      if (next) {
+    if (!scheduler) {
+      continue;
+    }
+    for (auto count = scheduler->GetQueueSize(); count > 0 && !next;
+         --count) {
+      auto* task = scheduler->PickNext();
+      if (!task) {
         break;
       }
+      if (NeedMigrate(task, core_id)) {
+        QueueMigration(cpu_sched, task);
+      } else {
+        next = task;
+      }
+    }
+    if (next) {
+      break;
     }
   }
 
   // 如果没有任务可运行
   if (!next) {
     // 如果当前任务仍然可以运行，继续运行它
-    if (current->GetStatus() == TaskStatus::kReady) {
+    if (current->GetStatus() == TaskStatus::kReady &&
+        !NeedMigrate(current, core_id)) {
       next = current;
     } else {
       // 否则统计空闲时间并返回
@@ -90,6 +113,7 @@ auto TaskManager::Schedule() -> void {
          "Schedule: next task must be kReady or kIdle policy");
 
   next->fsm.Receive(MsgSchedule{});
+  next->on_cpu.store(true, std::memory_order_relaxed);
   // 重置时间片（对于 RR 和 FIFO 有效，CFS 使用 vruntime 不依赖此字段）
   next->sched_info.time_slice_remaining = next->sched_info.time_slice_default;
   next->sched_info.context_switches++;
@@ -104,6 +128,8 @@ auto TaskManager::Schedule() -> void {
 
   // 更新 per-CPU running_task
   per_cpu::GetCurrentCore().running_task = next;
+  // 用户态通过 vvar 页读取当前任务的 ID
+  vdso_.UpdateCore(core_id, next);
 
   cpu_sched.lock.UnLock().or_else([](auto&& err) {
     klog::Err("Schedule: Failed to release lock: {}", err.message());
@@ -115,6 +141,31 @@ auto TaskManager::Schedule() -> void {
 
   // 上下文切换
   if (current != next) {
+    SwitchFpu(current, next);
+    // 释放锁后 current 已在就绪队列或待迁移列表中，在 switch_to 保存其
+    // 上下文之前，其他核心不能运行它
+    per_cpu::GetCurrentCore().prev_task = current;
     switch_to(&current->task_context, &next->task_context);
+    FinishSwitch();
+  }
+}
+
+auto TaskManager::FinishSwitch() -> void {
+  auto& cpu_data = per_cpu::GetCurrentCore();
+  auto* prev = cpu_data.prev_task;
+  cpu_data.prev_task = nullptr;
+  if (!prev) {
+    return;
+  }
+
+  // 没有父进程的任务退出时无人回收，已离开其内核栈，可以释放
+  if (prev->GetStatus() == TaskStatus::kExited) {
+    ReapTask(prev);
+    return;
   }
+  prev->on_cpu.store(false, std::memory_order_release);
+}
+
+extern "C" auto finish_task_switch() -> void {
+  TaskManagerSingleton::instance().FinishSwitch();
 }
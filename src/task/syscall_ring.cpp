@@ -0,0 +1,233 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "syscall_ring.hpp"
+
+#include <cpu_io.h>
+
+#include <algorithm>
+#include <bit>
+
+#include "block_device.hpp"
+#include "kernel_log.hpp"
+#include "kstd_cstring"
+#include "vdso.hpp"
+#include "virtual_memory.hpp"
+
+namespace {
+
+/// 共享区内各部分的对齐
+constexpr size_t kRingAlign = 64;
+
+constexpr auto AlignUp(size_t value, size_t align) -> size_t {
+  return (value + align - 1) & ~(align - 1);
+}
+
+}  // namespace
+
+SyscallRing::SyscallRing(uint32_t entries) {
+  if (entries == 0) {
+    entries = 1;
+  }
+  if (entries > kMaxEntries) {
+    entries = kMaxEntries;
+  }
+  auto sq_entries = std::bit_ceil(entries);
+  auto cq_entries = sq_entries * 2;
+
+  auto sq_offset = AlignUp(sizeof(SyscallRingHeader), kRingAlign);
+  auto cq_offset =
+      AlignUp(sq_offset + sq_entries * sizeof(SyscallSqe), kRingAlign);
+  auto size = cpu_io::virtual_memory::PageAlignUp(
+      cq_offset + cq_entries * sizeof(SyscallCqe));
+
+  buffer_ = IoBuffer(size, cpu_io::virtual_memory::kPageSize);
+  if (!buffer_.IsValid()) {
+    klog::Err("SyscallRing: failed to allocate {} bytes", size);
+    return;
+  }
+
+  auto* base = buffer_.GetBuffer().data();
+  kstd::memset(base, 0, size);
+
+  header_ = reinterpret_cast<SyscallRingHeader*>(base);
+  sq_ = reinterpret_cast<SyscallSqe*>(base + sq_offset);
+  cq_ = reinterpret_cast<SyscallCqe*>(base + cq_offset);
+  sq_mask_ = sq_entries - 1;
+  cq_mask_ = cq_entries - 1;
+
+  header_->sq_entries = sq_entries;
+  header_->cq_entries = cq_entries;
+  header_->sq_offset = static_cast<uint32_t>(sq_offset);
+  header_->cq_offset = static_cast<uint32_t>(cq_offset);
+}
+
+SyscallRing::~SyscallRing() {
+  // 设备仍会写入请求的缓冲区并通过 end_io 访问本对象
+  WaitAsync(0, true);
+  if (page_table_) {
+    UnmapFrom(page_table_);
+    page_table_ = nullptr;
+  }
+}
+
+auto SyscallRing::MapTo(uint64_t* page_table, uintptr_t user_addr)
+    -> Expected<void> {
+  if (!IsValid() || !page_table || page_table_ || user_addr == 0 ||
+      user_addr != cpu_io::virtual_memory::PageAlign(user_addr)) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+  // 共享区必须完整位于 vvar 页之下的用户地址空间
+  if (user_addr >= kVvarUserAddr || GetSize() > kVvarUserAddr - user_addr) {
+    return std::unexpected(Error(ErrorCode::kBadAddress));
+  }
+
+  auto& vm = VirtualMemorySingleton::instance();
+  // MapPage 会覆盖已有的映射，失败回滚时又会解除原有的映射，
+  // 因此只接受完全未映射的地址范围
+  for (size_t offset = 0; offset < GetSize();
+       offset += cpu_io::virtual_memory::kPageSize) {
+    if (vm.GetMapping(page_table,
+                      reinterpret_cast<void*>(user_addr + offset))) {
+      return std::unexpected(Error(ErrorCode::kVmPageAlreadyMapped));
+    }
+  }
+
+  auto flags =
+      cpu_io::virtual_memory::GetUserPagePermissions(true, true, false);
+  auto* base = buffer_.GetBuffer().data();
+  for (size_t offset = 0; offset < GetSize();
+       offset += cpu_io::virtual_memory::kPageSize) {
+    auto result = vm.MapPage(page_table,
+                             reinterpret_cast<void*>(user_addr + offset),
+                             base + offset, flags);
+    if (!result) {
+      // 回滚已建立的映射
+      for (size_t mapped = 0; mapped < offset;
+           mapped += cpu_io::virtual_memory::kPageSize) {
+        (void)vm.UnmapPage(page_table,
+                           reinterpret_cast<void*>(user_addr + mapped));
+      }
+      return std::unexpected(result.error());
+    }
+  }
+
+  page_table_ = page_table;
+  user_addr_ = user_addr;
+  return {};
+}
+
+auto SyscallRing::UnmapFrom(uint64_t* page_table) const -> void {
+  if (!page_table || user_addr_ == 0) {
+    return;
+  }
+  auto& vm = VirtualMemorySingleton::instance();
+  for (size_t offset = 0; offset < GetSize();
+       offset += cpu_io::virtual_memory::kPageSize) {
+    vm.UnmapPage(page_table, reinterpret_cast<void*>(user_addr_ + offset))
+        .or_else([](auto&& err) {
+          klog::Warn("SyscallRing: unmap failed: {}", err.message());
+          return Expected<void>{};
+        });
+  }
+}
+
+auto SyscallRing::GetUserAddress() const -> uintptr_t {
+  if (page_table_) {
+    return user_addr_;
+  }
+  return reinterpret_cast<uintptr_t>(header_);
+}
+
+auto SyscallRing::PopSubmission(SyscallSqe& sqe) -> bool {
+  LockGuard<SpinLock> lock_guard(lock_);
+
+  auto sq_tail = header_->sq_tail.load(std::memory_order_acquire);
+  auto pending = sq_tail - sq_head_;
+  if (pending == 0 || pending > sq_mask_ + 1) {
+    // 空队列，或用户态写入了非法的 sq_tail
+    return false;
+  }
+
+  // 每个取出的请求都预留一个 CQ 位置
+  auto cq_used = cq_tail_ - header_->cq_head.load(std::memory_order_acquire);
+  if (cq_used > cq_mask_ + 1 || cq_used + inflight_ > cq_mask_) {
+    return false;
+  }
+
+  sqe = sq_[sq_head_ & sq_mask_];
+  ++sq_head_;
+  ++inflight_;
+  header_->sq_head.store(sq_head_, std::memory_order_release);
+  return true;
+}
+
+auto SyscallRing::PostCompletion(uint64_t user_data, int64_t result) -> void {
+  LockGuard<SpinLock> lock_guard(lock_);
+  if (inflight_ == 0) {
+    klog::Err("SyscallRing: completion without submission");
+    return;
+  }
+  cq_[cq_tail_ & cq_mask_] = {.user_data = user_data, .result = result};
+  ++cq_tail_;
+  --inflight_;
+  header_->cq_tail.store(cq_tail_, std::memory_order_release);
+}
+
+auto SyscallRing::BeginAsync(vfs::BlockDevice* device) -> bool {
+  LockGuard<SpinLock> lock_guard(lock_);
+  if (async_inflight_ != 0 && io_device_ != device) {
+    return false;
+  }
+  io_device_ = device;
+  ++async_inflight_;
+  return true;
+}
+
+auto SyscallRing::PostAsyncCompletion(uint64_t user_data, int64_t result)
+    -> void {
+  LockGuard<SpinLock> lock_guard(lock_);
+  if (inflight_ == 0 || async_inflight_ == 0) {
+    klog::Err("SyscallRing: async completion without submission");
+    return;
+  }
+  cq_[cq_tail_ & cq_mask_] = {.user_data = user_data, .result = result};
+  ++cq_tail_;
+  --inflight_;
+  --async_inflight_;
+  header_->cq_tail.store(cq_tail_, std::memory_order_release);
+  // 在锁内唤醒：等待者确认请求全部完成后可能立即销毁本对象
+  cq_ready_.Complete();
+}
+
+auto SyscallRing::WaitCompletions(uint32_t min_complete) -> void {
+  WaitAsync(std::min(min_complete, cq_mask_ + 1), false);
+}
+
+auto SyscallRing::WaitAsync(uint32_t min_complete, bool drain) -> void {
+  while (true) {
+    vfs::BlockDevice* device = nullptr;
+    {
+      LockGuard<SpinLock> lock_guard(lock_);
+      // 先清除完成状态再检查条件，之后写入的表项会重新标记完成
+      cq_ready_.Reset();
+      if (async_inflight_ == 0 ||
+          (!drain && GetCompletionCount() >= min_complete)) {
+        return;
+      }
+      device = io_device_;
+    }
+    (void)vfs::WaitForIo(device, cq_ready_);
+  }
+}
+
+auto SyscallRing::GetCompletionCount() const -> uint32_t {
+  return header_->cq_tail.load(std::memory_order_acquire) -
+         header_->cq_head.load(std::memory_order_acquire);
+}
+
+auto SyscallRing::GetInflightCount() const -> uint32_t {
+  LockGuard<SpinLock> lock_guard(lock_);
+  return inflight_;
+}
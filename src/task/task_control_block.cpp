@@ -13,7 +13,10 @@
 #include "kernel.h"
 #include "kernel_log.hpp"
 #include "kstd_cstring"
+#include "kstd_memory"
 #include "sk_stdlib.h"
+#include "syscall_ring.hpp"
+#include "vdso.hpp"
 #include "virtual_memory.hpp"
 
 namespace {
@@ -112,14 +115,14 @@ auto TaskControlBlock::GetThreadGroupSize() const -> size_t {
   size_t count = 1;
 
   // 向前遍历至链表头
-  const ThreadGroupLink* curr = etl_previous;
+  const ThreadGroupLink* curr = ThreadGroupLink::etl_previous;
   while (curr) {
     ++count;
     curr = curr->etl_previous;
   }
 
   // 向后遍历至链表尾
-  curr = etl_next;
+  curr = ThreadGroupLink::etl_next;
   while (curr) {
     ++count;
     curr = curr->etl_next;
@@ -128,6 +131,13 @@ auto TaskControlBlock::GetThreadGroupSize() const -> size_t {
   return count;
 }
 
+auto TaskControlBlock::GetFdTable() -> filesystem::FileDescriptorTable* {
+  if (!fd_table) {
+    fd_table = kstd::make_unique<filesystem::FileDescriptorTable>().release();
+  }
+  return fd_table;
+}
+
 TaskControlBlock::TaskControlBlock(const char* _name, int priority,
                                    ThreadEntry entry, void* arg)
     : name(_name) {
@@ -185,10 +195,25 @@ TaskControlBlock::~TaskControlBlock() {
     kernel_stack = nullptr;
   }
 
+  // 最后一个共享者退出时关闭所有文件
+  if (fd_table && fd_table->Unref()) {
+    fd_table->CloseFiles();
+    delete fd_table;
+  }
+  fd_table = nullptr;
+
+  // 释放系统调用环，其物理页不属于页表，需要在销毁页表前解除映射
+  delete syscall_ring;
+  syscall_ring = nullptr;
+
   // 释放页表（如果有用户空间页表）
   if (page_table) {
     // 如果是私有页表（非共享），需要释放物理页
     auto should_free_pages = !(clone_flags & clone_flag::kVm);
+    // vvar 页由所有地址空间共享，不能随私有页表一起释放
+    if (should_free_pages) {
+      Vdso::UnmapFrom(page_table);
+    }
     VirtualMemorySingleton::instance().DestroyPageDirectory(page_table,
                                                             should_free_pages);
     page_table = nullptr;
@@ -14,6 +14,7 @@
 #include <new>
 
 #include "basic_info.hpp"
+#include "deadline_scheduler.hpp"
 #include "fifo_scheduler.hpp"
 #include "idle_scheduler.hpp"
 #include "kernel_config.hpp"
@@ -43,6 +44,8 @@ auto TaskManager::InitCurrentCore() -> void {
   LockGuard lock_guard{cpu_sched.lock};
 
   if (!cpu_sched.schedulers[static_cast<uint8_t>(SchedPolicy::kNormal)]) {
+    cpu_sched.schedulers[static_cast<uint8_t>(SchedPolicy::kDeadline)] =
+        kstd::make_unique<DeadlineScheduler>();
     cpu_sched.schedulers[static_cast<uint8_t>(SchedPolicy::kRealTime)] =
         kstd::make_unique<FifoScheduler>();
     cpu_sched.schedulers[static_cast<uint8_t>(SchedPolicy::kNormal)] =
@@ -69,6 +72,8 @@ auto TaskManager::InitCurrentCore() -> void {
   // kReady -> kRunning
   boot_task->fsm.Receive(MsgSchedule{});
   boot_task->policy = SchedPolicy::kIdle;
+  boot_task->cpu_id = core_id;
+  boot_task->on_cpu.store(true, std::memory_order_relaxed);
   cpu_data.running_task = boot_task;
 
   // 创建独立的 Idle 线程
@@ -81,6 +86,7 @@ auto TaskManager::InitCurrentCore() -> void {
   // kUnInit -> kReady
   idle_task->fsm.Receive(MsgSchedule{});
   idle_task->policy = SchedPolicy::kIdle;
+  idle_task->cpu_id = core_id;
 
   // 将 idle 任务加入 Idle 调度器
   if (cpu_sched.schedulers[static_cast<uint8_t>(SchedPolicy::kIdle)]) {
@@ -89,6 +95,18 @@ auto TaskManager::InitCurrentCore() -> void {
   }
 
   cpu_data.idle_task = idle_task;
+
+  // 首个初始化的核心 (启动核) 分配 vvar 页并负责更新时钟
+  if (!vdso_.IsValid()) {
+    vdso_.Init(BasicInfoSingleton::instance().interval, core_id)
+        .or_else([](auto&& err) {
+          klog::Err("InitCurrentCore: failed to init vDSO: {}",
+                    err.message());
+          return Expected<void>{};
+        });
+  }
+  vdso_.InitCore(core_id);
+  vdso_.UpdateCore(core_id, boot_task);
 }
 
 auto TaskManager::AddTask(TaskControlBlock* task) -> void {
@@ -120,43 +138,16 @@ auto TaskManager::AddTask(TaskControlBlock* task) -> void {
   // Transition: kUnInit -> kReady
   task->fsm.Receive(MsgSchedule{});
 
-  // 简单的负载均衡：如果指定了亲和性，放入对应核心，否则放入当前核心
-  // 更复杂的逻辑可以是：寻找最空闲的核心
-  size_t target_core = cpu_io::GetCurrentCoreId();
-
-  if (task->cpu_affinity.value() != UINT64_MAX) {
-    // 寻找第一个允许的核心
-    for (size_t core_id = 0; core_id < SIMPLEKERNEL_MAX_CORE_COUNT; ++core_id) {
-      if (task->cpu_affinity.value() & (1UL << core_id)) {
-        target_core = core_id;
-        break;
-      }
-    }
-  }
-
-  auto& cpu_sched = cpu_schedulers_[target_core];
-
-  {
-    LockGuard<SpinLock> lock_guard(cpu_sched.lock);
-    if (task->policy < SchedPolicy::kPolicyCount) {
-      if (cpu_sched.schedulers[static_cast<uint8_t>(task->policy)]) {
-        cpu_sched.schedulers[static_cast<uint8_t>(task->policy)]->Enqueue(task);
-      }
-    }
+  // 放入允许运行的负载最低的核心，没有可用核心时放入当前核心
+  auto target_core = SelectCore(task);
+  if (target_core >= SIMPLEKERNEL_MAX_CORE_COUNT) {
+    target_core = cpu_io::GetCurrentCoreId();
   }
+  AttachTask(task, target_core);
 
-  // 如果是当前核心，且添加了比当前任务优先级更高的任务，触发抢占
-  if (target_core == cpu_io::GetCurrentCoreId()) {
-    auto& cpu_data = per_cpu::GetCurrentCore();
-    TaskControlBlock* current = cpu_data.running_task;
-    // 如果当前是 idle 任务，或新任务的策略优先级更高，触发调度
-    if (current == cpu_data.idle_task ||
-        (current && task->policy < current->policy)) {
-      // 注意：这里不能直接调用 Schedule()，因为可能在中断上下文中
-      // 实际应该设置一个 need_resched 标志，在中断返回前检查
-      // 为简化，这里暂时不做抢占，只在时间片耗尽时调度
-    }
-  }
+  // 这里不能直接调用 Schedule()，因为可能在中断上下文中
+  // 新任务的策略优先级 (或同策略内的优先级) 更高时，由下一次 TickUpdate()
+  // 检测到并抢占当前任务
 }
 
 auto TaskManager::AllocatePid() -> size_t {
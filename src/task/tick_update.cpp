@@ -2,13 +2,19 @@
  * @copyright Copyright The SimpleKernel Contributors
  */
 
+#include <cpu_io.h>
+
 #include "kernel_log.hpp"
 #include "task_manager.hpp"
 #include "task_messages.hpp"
 
 auto TaskManager::TickUpdate() -> void {
+  auto core_id = cpu_io::GetCurrentCoreId();
   auto& cpu_sched = GetCurrentCpuSched();
 
+  // 迁出上一次调度中换出的任务 (IPI 不可用时也能在一个 tick 内完成迁移)
+  DrainMigrations(cpu_sched);
+
   bool need_preempt = false;
 
   {
@@ -17,8 +23,20 @@ auto TaskManager::TickUpdate() -> void {
     // 递增本核心的 tick 计数
     cpu_sched.local_tick++;
 
+    // 负责时钟的核心更新 vvar 页中的单调时钟
+    vdso_.UpdateClock(core_id, cpu_sched.local_tick);
+
     auto* current = GetCurrentTask();
 
+    // 推进所有调度器的时钟，策略优先级更高的任务重新就绪时抢占当前任务
+    for (size_t i = 0; i < cpu_sched.schedulers.size(); ++i) {
+      auto& scheduler = cpu_sched.schedulers[i];
+      if (scheduler && scheduler->OnClockTick(cpu_sched.local_tick) &&
+          current && i < static_cast<size_t>(current->policy)) {
+        need_preempt = true;
+      }
+    }
+
     // 唤醒睡眠队列中到时间的任务
     while (!cpu_sched.sleeping_tasks.empty()) {
       auto* task = cpu_sched.sleeping_tasks.top();
@@ -41,6 +59,35 @@ auto TaskManager::TickUpdate() -> void {
       }
     }
 
+    // 唤醒等待超时的阻塞任务
+    auto& timed = cpu_sched.timed_blocked_tasks;
+    for (auto it = timed.begin(); it != timed.end();) {
+      auto* task = *it;
+      if (task->sched_info.wake_tick > cpu_sched.local_tick) {
+        ++it;
+        continue;
+      }
+      it = timed.erase(it);
+
+      // 从所等待资源的阻塞队列中移除
+      auto blocked = cpu_sched.blocked_tasks.find(task->blocked_on);
+      if (blocked != cpu_sched.blocked_tasks.end()) {
+        blocked->second.remove(task);
+        if (blocked->second.empty()) {
+          cpu_sched.blocked_tasks.erase(blocked);
+        }
+      }
+
+      task->fsm.Receive(MsgWakeup{});
+      task->blocked_on = ResourceId{};
+
+      auto* scheduler =
+          cpu_sched.schedulers[static_cast<uint8_t>(task->policy)].get();
+      if (scheduler) {
+        scheduler->Enqueue(task);
+      }
+    }
+
     // 更新当前任务的统计信息
     if (current && current->GetStatus() == TaskStatus::kRunning) {
       // 更新总运行时间
@@ -57,7 +104,21 @@ auto TaskManager::TickUpdate() -> void {
 
       if (scheduler) {
         // 调度器可能基于自己的策略决定是否抢占
-        need_preempt = scheduler->OnTick(current);
+        need_preempt = scheduler->OnTick(current) || need_preempt;
+      }
+
+      // 策略优先级更高的调度器有就绪任务 (被唤醒或新加入) 时抢占
+      for (size_t i = 0; i < static_cast<size_t>(current->policy); ++i) {
+        auto& higher = cpu_sched.schedulers[i];
+        if (higher && !higher->IsEmpty()) {
+          need_preempt = true;
+          break;
+        }
+      }
+
+      // 亲和性已不包含本核心，换出后迁移到其他核心
+      if (NeedMigrate(current, core_id)) {
+        need_preempt = true;
       }
 
       // 检查时间片是否耗尽（对于基于时间片的调度器）
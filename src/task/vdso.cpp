@@ -0,0 +1,117 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "vdso.hpp"
+
+#include <cpu_io.h>
+
+#include "arch.h"
+#include "kernel_log.hpp"
+#include "kstd_cstring"
+#include "sk_stdlib.h"
+#include "task_control_block.hpp"
+#include "virtual_memory.hpp"
+
+static_assert(sizeof(VdsoData) <= cpu_io::virtual_memory::kPageSize,
+              "VdsoData must fit in one page");
+
+auto Vdso::Init(uint64_t counter_freq, size_t clock_core) -> Expected<void> {
+  if (data_) {
+    return {};
+  }
+
+  auto* page = aligned_alloc(cpu_io::virtual_memory::kPageSize,
+                             cpu_io::virtual_memory::kPageSize);
+  if (!page) {
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  }
+  kstd::memset(page, 0, cpu_io::virtual_memory::kPageSize);
+  data_ = static_cast<VdsoData*>(page);
+
+  // mult 取 32 位内能表示的最大精度，一个 tick 内的计数差乘 mult 不会溢出
+  if (counter_freq != 0) {
+    uint32_t shift = 32;
+    auto mult = (kNanosecondsPerSecond << shift) / counter_freq;
+    while (mult > UINT32_MAX && shift > 0) {
+      --shift;
+      mult = (kNanosecondsPerSecond << shift) / counter_freq;
+    }
+    data_->mult = static_cast<uint32_t>(mult);
+    data_->shift = shift;
+  }
+  data_->counter_freq = counter_freq;
+  clock_core_ = clock_core;
+  data_->counter_last = ReadTimestamp();
+
+  klog::Info("Vdso: counter {} Hz, mult {}, shift {}", counter_freq,
+             data_->mult, data_->shift);
+  return {};
+}
+
+auto Vdso::InitCore(size_t core_id) -> void {
+  if (!data_ || core_id >= data_->cores.size()) {
+    return;
+  }
+
+  auto& core = data_->cores[core_id];
+  WriteBegin(core.seq);
+  core.core_id = static_cast<uint32_t>(core_id);
+  WriteEnd(core.seq);
+
+  WriteBegin(data_->seq);
+  ++data_->core_count;
+  WriteEnd(data_->seq);
+
+  VdsoArchInit(core_id);
+}
+
+auto Vdso::UpdateClock(size_t core_id, uint64_t tick) -> void {
+  if (!data_ || core_id != clock_core_) {
+    return;
+  }
+
+  auto counter = ReadTimestamp();
+  WriteBegin(data_->seq);
+  if (data_->counter_freq != 0) {
+    data_->ns_last +=
+        ((counter - data_->counter_last) * data_->mult) >> data_->shift;
+  } else {
+    // 计数器频率未知，退化为 tick 精度
+    data_->ns_last = tick * kNanosecondsPerSecond / SIMPLEKERNEL_TICK;
+  }
+  data_->counter_last = counter;
+  WriteEnd(data_->seq);
+}
+
+auto Vdso::UpdateCore(size_t core_id, const TaskControlBlock* task) -> void {
+  if (!data_ || !task || core_id >= data_->cores.size()) {
+    return;
+  }
+
+  auto& core = data_->cores[core_id];
+  WriteBegin(core.seq);
+  core.tid = task->pid;
+  core.tgid = task->tgid;
+  WriteEnd(core.seq);
+}
+
+auto Vdso::MapTo(uint64_t* page_table) const -> Expected<void> {
+  if (!data_ || !page_table) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+
+  return VirtualMemorySingleton::instance().MapPage(
+      page_table, reinterpret_cast<void*>(kVvarUserAddr), data_,
+      cpu_io::virtual_memory::GetUserPagePermissions(true, false, false));
+}
+
+auto Vdso::UnmapFrom(uint64_t* page_table) -> void {
+  if (!page_table) {
+    return;
+  }
+
+  // 未映射 vvar 页的页表 (如内核线程) 返回错误，忽略即可
+  (void)VirtualMemorySingleton::instance().UnmapPage(
+      page_table, reinterpret_cast<void*>(kVvarUserAddr));
+}
@@ -2,6 +2,9 @@
  * @copyright Copyright The SimpleKernel Contributors
  */
 
+#include <cpu_io.h>
+
+#include <atomic>
 #include <cassert>
 
 #include "expected.hpp"
@@ -81,6 +84,11 @@ auto TaskManager::Wait(Pid pid, int* status, bool no_hang, bool untraced)
         *status = target->exit_code;
       }
 
+      // 子进程可能刚在其他核心上退出、尚未离开其内核栈
+      while (target->on_cpu.load(std::memory_order_acquire)) {
+        cpu_io::Pause();
+      }
+
       // 清理僵尸进程
       {
         LockGuard lock_guard(task_table_lock_);
@@ -10,14 +10,63 @@
 #include "task_messages.hpp"
 
 auto TaskManager::Wakeup(ResourceId resource_id) -> void {
-  auto& cpu_sched = GetCurrentCpuSched();
+  size_t wakeup_count = 0;
+
+  // 任务阻塞在其所在核心上，等待同一资源的任务可能分布在多个核心
+  // 逐个核心加锁，不同时持有两个核心的锁
+  for (size_t core_id = 0; core_id < SIMPLEKERNEL_MAX_CORE_COUNT; ++core_id) {
+    if (!IsCoreOnline(core_id)) {
+      continue;
+    }
+    auto& cpu_sched = cpu_schedulers_[core_id];
+    LockGuard<SpinLock> lock_guard(cpu_sched.lock);
+
+    // 查找等待该资源的任务列表
+    auto it = cpu_sched.blocked_tasks.find(resource_id);
+    if (it == cpu_sched.blocked_tasks.end()) {
+      continue;
+    }
+
+    // 唤醒所有等待该资源的任务
+    auto& waiting_tasks = it->second;
+
+    while (!waiting_tasks.empty()) {
+      auto* task = waiting_tasks.front();
+      waiting_tasks.pop_front();
+
+      assert(task->GetStatus() == TaskStatus::kBlocked &&
+             "Wakeup: task status must be kBlocked");
+      assert(task->blocked_on == resource_id &&
+             "Wakeup: task blocked_on must match resource_id");
+
+      // 带超时的任务已被唤醒，不再等待超时
+      auto& timed = cpu_sched.timed_blocked_tasks;
+      for (auto timed_it = timed.begin(); timed_it != timed.end();
+           ++timed_it) {
+        if (*timed_it == task) {
+          timed.erase(timed_it);
+          break;
+        }
+      }
 
-  LockGuard<SpinLock> lock_guard(cpu_sched.lock);
+      // 将任务标记为就绪
+      task->fsm.Receive(MsgWakeup{});
+      task->blocked_on = ResourceId{};
 
-  // 查找等待该资源的任务列表
-  auto it = cpu_sched.blocked_tasks.find(resource_id);
+      // 将任务重新加入所在核心对应调度器的就绪队列
+      // 亲和性已不包含该核心时，由该核心在调度时迁出
+      auto* scheduler =
+          cpu_sched.schedulers[static_cast<uint8_t>(task->policy)].get();
+      assert(scheduler != nullptr && "Wakeup: scheduler must not be null");
+      scheduler->Enqueue(task);
+      wakeup_count++;
+    }
 
-  if (it == cpu_sched.blocked_tasks.end()) {
+    // 移除空的资源队列
+    cpu_sched.blocked_tasks.erase(resource_id);
+  }
+
+  if (wakeup_count == 0) {
     // 没有任务等待该资源
     klog::Debug("Wakeup: No tasks waiting on resource={}, data={:#x}",
                 resource_id.GetTypeName(),
@@ -25,34 +74,6 @@ auto TaskManager::Wakeup(ResourceId resource_id) -> void {
     return;
   }
 
-  // 唤醒所有等待该资源的任务
-  auto& waiting_tasks = it->second;
-  size_t wakeup_count = 0;
-
-  while (!waiting_tasks.empty()) {
-    auto* task = waiting_tasks.front();
-    waiting_tasks.pop_front();
-
-    assert(task->GetStatus() == TaskStatus::kBlocked &&
-           "Wakeup: task status must be kBlocked");
-    assert(task->blocked_on == resource_id &&
-           "Wakeup: task blocked_on must match resource_id");
-
-    // 将任务标记为就绪
-    task->fsm.Receive(MsgWakeup{});
-    task->blocked_on = ResourceId{};
-
-    // 将任务重新加入对应调度器的就绪队列
-    auto* scheduler =
-        cpu_sched.schedulers[static_cast<uint8_t>(task->policy)].get();
-    assert(scheduler != nullptr && "Wakeup: scheduler must not be null");
-    scheduler->Enqueue(task);
-    wakeup_count++;
-  }
-
-  // 移除空的资源队列
-  cpu_sched.blocked_tasks.erase(resource_id);
-
   klog::Debug("Wakeup: Woke up {} tasks from resource={}, data={:#x}",
               wakeup_count, resource_id.GetTypeName(),
               static_cast<uint64_t>(resource_id.GetData()));
@@ -0,0 +1,125 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "user_access.hpp"
+
+#include <cpu_io.h>
+
+#include <algorithm>
+
+#include "arch.h"
+#include "task_manager.hpp"
+#include "vdso.hpp"
+#include "virtual_memory.hpp"
+
+/// 异常修复表的起止地址，由链接器提供
+extern "C" const ExceptionTableEntry __start___ex_table[];
+extern "C" const ExceptionTableEntry __stop___ex_table[];
+
+namespace {
+
+/**
+ * @brief 检查地址范围是否可以交给 copy_user
+ * @param addr 起始地址
+ * @param len 字节数
+ * @param writable 内核是否要写入该范围
+ * @return bool 地址非空、不回绕，且 (对用户任务) 每一页都映射为
+ * 用户可访问时返回 true
+ * @note 内核与用户共用低地址空间：用户任务的地址必须位于 vvar 页及其之下，
+ * 并在其页表中带有用户权限，不能借系统调用访问内核内存；内核线程没有
+ * 用户地址空间，传入的是内核缓冲区，只依赖缺页修复
+ */
+auto IsValidRange(const void* addr, size_t len, bool writable) -> bool {
+  auto start = reinterpret_cast<uintptr_t>(addr);
+  if (start == 0 || start + len < start) {
+    return false;
+  }
+
+  auto* current = TaskManagerSingleton::instance().GetCurrentTask();
+  if (!current || !current->page_table) {
+    return true;
+  }
+  if (start + len > kVvarUserAddr + cpu_io::virtual_memory::kPageSize) {
+    return false;
+  }
+  return VirtualMemorySingleton::instance().IsUserAccessible(
+      current->page_table, addr, len, writable);
+}
+
+}  // namespace
+
+auto SearchExceptionTable(uint64_t pc) -> uint64_t {
+  // 表项只来自 user_copy.S，数量很少，线性查找即可
+  for (const auto* entry = __start___ex_table; entry < __stop___ex_table;
+       ++entry) {
+    if (entry->insn == pc) {
+      return entry->fixup;
+    }
+  }
+  return 0;
+}
+
+auto CopyFromUser(void* dst, const void* user_src, size_t len)
+    -> Expected<void> {
+  if (len == 0) {
+    return {};
+  }
+  if (!dst || !IsValidRange(user_src, len, false)) {
+    return std::unexpected(Error(ErrorCode::kBadAddress));
+  }
+  if (copy_user(dst, user_src, len) != 0) {
+    return std::unexpected(Error(ErrorCode::kBadAddress));
+  }
+  return {};
+}
+
+auto CopyToUser(void* user_dst, const void* src, size_t len)
+    -> Expected<void> {
+  if (len == 0) {
+    return {};
+  }
+  if (!src || !IsValidRange(user_dst, len, true)) {
+    return std::unexpected(Error(ErrorCode::kBadAddress));
+  }
+  if (copy_user(user_dst, src, len) != 0) {
+    return std::unexpected(Error(ErrorCode::kBadAddress));
+  }
+  return {};
+}
+
+auto StrnCpyFromUser(char* dst, const char* user_src, size_t size)
+    -> Expected<size_t> {
+  if (!dst || size == 0) {
+    return std::unexpected(Error(ErrorCode::kInvalidArgument));
+  }
+  if (!user_src) {
+    return std::unexpected(Error(ErrorCode::kBadAddress));
+  }
+
+  size_t copied = 0;
+  while (copied < size) {
+    // 每次最多拷贝到当前页末尾，字符串结束后不会访问下一页
+    auto addr = reinterpret_cast<uintptr_t>(user_src + copied);
+    auto page_left = cpu_io::virtual_memory::kPageSize -
+                     (addr & (cpu_io::virtual_memory::kPageSize - 1));
+    auto chunk = std::min(size - copied, page_left);
+    // 逐页检查，短字符串之后未映射的页不影响结果
+    auto left = IsValidRange(user_src + copied, chunk, false)
+                    ? copy_user(dst + copied, user_src + copied, chunk)
+                    : chunk;
+
+    for (auto end = copied + chunk - left; copied < end; ++copied) {
+      if (dst[copied] == '\0') {
+        return copied;
+      }
+    }
+    if (left != 0) {
+      dst[copied] = '\0';
+      return std::unexpected(Error(ErrorCode::kBadAddress));
+    }
+  }
+
+  dst[size - 1] = '\0';
+  return std::unexpected(Error(ErrorCode::kInvalidArgument));
+}
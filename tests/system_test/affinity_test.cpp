@@ -0,0 +1,216 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include <cpu_io.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "per_cpu.hpp"
+#include "sk_stdio.h"
+#include "syscall.hpp"
+#include "system_test.h"
+#include "task_control_block.hpp"
+#include "task_manager.hpp"
+
+namespace {
+
+/// 跨核迁移测试的往返次数
+constexpr size_t kMigrationRounds = 64;
+
+/// 等待工作任务出现在目标核心上的最长时间 (ms)
+constexpr uint64_t kMigrationTimeoutMs = 1000;
+
+std::atomic<bool> g_migrate_stop{false};
+std::atomic<bool> g_migrate_exited{false};
+std::atomic<bool> g_migrate_corrupted{false};
+std::atomic<size_t> g_migrate_core{SIMPLEKERNEL_MAX_CORE_COUNT};
+std::atomic<uint64_t> g_migrate_iterations{0};
+
+/**
+ * @brief 不断让出 CPU 的工作任务，大部分时间处于就绪状态
+ *
+ * 栈上的计数器跨越每次换出与迁移；若任务在其他核心上从尚未保存的
+ * 上下文恢复，计数器会与全局计数不一致。
+ */
+void migrate_worker(void*) {
+  uint64_t local = 0;
+  while (!g_migrate_stop.load()) {
+    g_migrate_core.store(cpu_io::GetCurrentCoreId());
+    ++local;
+    if (g_migrate_iterations.fetch_add(1) + 1 != local) {
+      g_migrate_corrupted = true;
+    }
+    (void)sys_yield();
+  }
+  g_migrate_exited = true;
+  sys_exit(0);
+}
+
+auto test_affinity_invalid_mask() -> bool {
+  sk_printf("Running test_affinity_invalid_mask...\n");
+
+  auto& task_manager = TaskManagerSingleton::instance();
+  auto core_id = cpu_io::GetCurrentCoreId();
+
+  TaskControlBlock task("AffinityInvalid", 10, nullptr, nullptr);
+  task.cpu_id = core_id;
+
+  // 空掩码中没有在线核心
+  auto result = task_manager.SetAffinity(&task, CpuAffinity(0));
+  EXPECT_FALSE(result.has_value(), "Empty mask should be rejected");
+  EXPECT_EQ(static_cast<uint64_t>(result.error().code),
+            static_cast<uint64_t>(ErrorCode::kTaskInvalidAffinity),
+            "Error should be kTaskInvalidAffinity");
+  EXPECT_EQ(task.cpu_affinity.value(), UINT64_MAX,
+            "Rejected mask should not be applied");
+
+  // idle 任务固定在其所在核心
+  auto* idle_task = per_cpu::GetCurrentCore().idle_task;
+  result = task_manager.SetAffinity(idle_task, CpuAffinity(1ULL << core_id));
+  EXPECT_FALSE(result.has_value(), "Idle task affinity should be rejected");
+
+  sk_printf("test_affinity_invalid_mask passed\n");
+  return true;
+}
+
+auto test_affinity_keep_core() -> bool {
+  sk_printf("Running test_affinity_keep_core...\n");
+
+  auto& task_manager = TaskManagerSingleton::instance();
+  auto core_id = cpu_io::GetCurrentCoreId();
+
+  TaskControlBlock task("AffinityKeep", 10, nullptr, nullptr);
+  task.cpu_id = core_id;
+
+  // 新掩码仍包含所在核心，任务不需要迁移
+  auto result = task_manager.SetAffinity(&task, CpuAffinity(1ULL << core_id));
+  EXPECT_TRUE(result.has_value(), "Mask with current core should succeed");
+  EXPECT_EQ(task.cpu_affinity.value(), 1ULL << core_id,
+            "Affinity should be updated");
+  EXPECT_EQ(task.cpu_id, core_id, "Task should stay on its core");
+
+  // 掩码中的离线核心被忽略，只要包含一个在线核心即可
+  result = task_manager.SetAffinity(&task, CpuAffinity(UINT64_MAX));
+  EXPECT_TRUE(result.has_value(), "Full mask should succeed");
+  EXPECT_EQ(task.cpu_id, core_id, "Task should stay on its core");
+
+  sk_printf("test_affinity_keep_core passed\n");
+  return true;
+}
+
+auto test_affinity_syscall() -> bool {
+  sk_printf("Running test_affinity_syscall...\n");
+
+  auto& task_manager = TaskManagerSingleton::instance();
+  auto* current = task_manager.GetCurrentTask();
+  auto core_id = cpu_io::GetCurrentCoreId();
+  auto old_mask = current->cpu_affinity.value();
+
+  uint64_t mask = 1ULL << core_id;
+  EXPECT_EQ(sys_sched_setaffinity(0, sizeof(mask), &mask), 0,
+            "Pinning to current core should succeed");
+  EXPECT_EQ(current->cpu_affinity.value(), mask, "Affinity should be updated");
+  EXPECT_EQ(current->cpu_id, core_id, "Current task should not migrate");
+
+  uint64_t empty = 0;
+  EXPECT_EQ(sys_sched_setaffinity(0, sizeof(empty), &empty), -1,
+            "Empty mask should fail");
+  EXPECT_EQ(current->cpu_affinity.value(), mask,
+            "Failed call should keep the old mask");
+
+  EXPECT_EQ(sys_sched_setaffinity(0, sizeof(old_mask), &old_mask), 0,
+            "Restore original affinity");
+
+  sk_printf("test_affinity_syscall passed\n");
+  return true;
+}
+
+auto test_affinity_cross_core_migration() -> bool {
+  sk_printf("Running test_affinity_cross_core_migration...\n");
+
+  auto& task_manager = TaskManagerSingleton::instance();
+  auto core_a = cpu_io::GetCurrentCoreId();
+  size_t core_b = SIMPLEKERNEL_MAX_CORE_COUNT;
+  for (size_t core_id = 0; core_id < SIMPLEKERNEL_MAX_CORE_COUNT; ++core_id) {
+    if (core_id != core_a && task_manager.IsCoreOnline(core_id)) {
+      core_b = core_id;
+      break;
+    }
+  }
+  if (core_b >= SIMPLEKERNEL_MAX_CORE_COUNT) {
+    sk_printf("test_affinity_cross_core_migration: SKIP (single core)\n");
+    return true;
+  }
+
+  g_migrate_stop = false;
+  g_migrate_exited = false;
+  g_migrate_corrupted = false;
+  g_migrate_core = SIMPLEKERNEL_MAX_CORE_COUNT;
+  g_migrate_iterations = 0;
+
+  auto* worker = new TaskControlBlock("MigrateWorker", 10, migrate_worker,
+                                      nullptr);
+  task_manager.AddTask(worker);
+
+  // 在两个核心之间来回迁移；工作任务频繁让出，迁移多数发生在它位于
+  // 远端核心就绪队列中 (可能刚被换出) 的时候
+  for (size_t round = 0; round < kMigrationRounds; ++round) {
+    auto target = (round % 2 == 0) ? core_b : core_a;
+    auto result = task_manager.SetAffinity(worker, CpuAffinity(1ULL << target));
+    EXPECT_TRUE(result.has_value(), "SetAffinity should succeed");
+
+    uint64_t waited = 0;
+    while (g_migrate_core.load() != target && waited < kMigrationTimeoutMs) {
+      (void)sys_sleep(1);
+      ++waited;
+    }
+    EXPECT_EQ(g_migrate_core.load(), target,
+              "Worker should run on the target core");
+    EXPECT_FALSE(g_migrate_corrupted.load(),
+                 "Worker should resume from its saved context");
+  }
+
+  auto iterations = g_migrate_iterations.load();
+  g_migrate_stop = true;
+  for (uint64_t waited = 0;
+       !g_migrate_exited.load() && waited < kMigrationTimeoutMs; ++waited) {
+    (void)sys_sleep(1);
+  }
+  EXPECT_TRUE(g_migrate_exited.load(), "Worker should exit");
+  EXPECT_GE(iterations, kMigrationRounds, "Worker should keep running");
+  EXPECT_FALSE(g_migrate_corrupted.load(),
+               "Worker should resume from its saved context");
+
+  sk_printf("test_affinity_cross_core_migration: %lu migrations, %lu yields\n",
+            static_cast<unsigned long>(kMigrationRounds),
+            static_cast<unsigned long>(iterations));
+  sk_printf("test_affinity_cross_core_migration passed\n");
+  return true;
+}
+
+}  // namespace
+
+auto affinity_test() -> bool {
+  sk_printf("\n=== CPU Affinity System Tests ===\n");
+
+  if (!test_affinity_invalid_mask()) {
+    return false;
+  }
+
+  if (!test_affinity_keep_core()) {
+    return false;
+  }
+
+  if (!test_affinity_syscall()) {
+    return false;
+  }
+
+  if (!test_affinity_cross_core_migration()) {
+    return false;
+  }
+
+  sk_printf("=== All CPU Affinity Tests Passed ===\n\n");
+  return true;
+}
@@ -0,0 +1,76 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "completion.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+#include "kstd_cstdio"
+#include "syscall.hpp"
+#include "system_test.h"
+#include "task_control_block.hpp"
+#include "task_manager.hpp"
+
+namespace {
+
+Completion g_completion("completion_test");
+std::atomic<bool> g_completer_ran{false};
+
+void completer_func(void*) {
+  sys_sleep(50);
+  g_completer_ran = true;
+  g_completion.Complete();
+  sys_exit(0);
+}
+
+auto test_complete_before_wait() -> bool {
+  sk_printf("Running test_complete_before_wait...\n");
+  Completion completion("early");
+  completion.Complete();
+  EXPECT_TRUE(completion.IsDone(), "Completion should be done");
+  EXPECT_TRUE(completion.Wait().has_value(), "Wait should return at once");
+  completion.Reset();
+  EXPECT_FALSE(completion.IsDone(), "Reset should clear the state");
+  return true;
+}
+
+auto test_wait_timeout() -> bool {
+  sk_printf("Running test_wait_timeout...\n");
+  Completion completion("timeout");
+  auto result = completion.Wait(20);
+  EXPECT_FALSE(result.has_value(), "Wait should time out");
+  EXPECT_EQ(result.error().code, ErrorCode::kTimeout, "Error is kTimeout");
+  return true;
+}
+
+auto test_wakeup_by_other_task() -> bool {
+  sk_printf("Running test_wakeup_by_other_task...\n");
+  g_completion.Reset();
+  g_completer_ran = false;
+  auto* task = new TaskControlBlock("Completer", 10, completer_func, nullptr);
+  TaskManagerSingleton::instance().AddTask(task);
+
+  EXPECT_TRUE(g_completion.Wait(5000).has_value(),
+              "Waiter should be woken by Complete");
+  EXPECT_TRUE(g_completer_ran.load(), "Completer should have run first");
+  return true;
+}
+
+}  // namespace
+
+auto completion_test() -> bool {
+  sk_printf("completion_test: start\n");
+  if (!test_complete_before_wait()) {
+    return false;
+  }
+  if (!test_wait_timeout()) {
+    return false;
+  }
+  if (!test_wakeup_by_other_task()) {
+    return false;
+  }
+  sk_printf("completion_test: PASS\n");
+  return true;
+}
@@ -0,0 +1,482 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "deadline_scheduler.hpp"
+
+#include <cpu_io.h>
+
+#include <cstdint>
+
+#include "kernel_config.hpp"
+#include "rr_scheduler.hpp"
+#include "sk_stdio.h"
+#include "system_test.h"
+#include "task_control_block.hpp"
+#include "task_manager.hpp"
+#include "task_messages.hpp"
+
+namespace {
+
+/**
+ * @brief 设置 deadline 参数 (与 TaskManager::SetSchedAttr 一致，未开始周期)
+ */
+auto SetDeadlineParams(TaskControlBlock& task, uint64_t runtime,
+                       uint64_t deadline, uint64_t period) -> void {
+  task.policy = SchedPolicy::kDeadline;
+  task.sched_data = {};
+  task.sched_data.dl.runtime = runtime;
+  task.sched_data.dl.deadline = deadline;
+  task.sched_data.dl.period = period;
+}
+
+auto test_deadline_edf_ordering() -> bool {
+  sk_printf("Running test_deadline_edf_ordering...\n");
+
+  DeadlineScheduler scheduler;
+  EXPECT_EQ(scheduler.name[0], 'D', "Scheduler name should start with D");
+
+  TaskControlBlock late("Late", 1, nullptr, nullptr);
+  late.pid = 1;
+  SetDeadlineParams(late, 2, 30, 30);
+  TaskControlBlock early("Early", 1, nullptr, nullptr);
+  early.pid = 2;
+  SetDeadlineParams(early, 2, 10, 10);
+  TaskControlBlock mid("Mid", 1, nullptr, nullptr);
+  mid.pid = 3;
+  SetDeadlineParams(mid, 2, 20, 20);
+
+  EXPECT_TRUE(scheduler.IsEmpty(), "Scheduler should be empty initially");
+  EXPECT_EQ(scheduler.PickNext(), nullptr,
+            "PickNext should return nullptr for empty queue");
+
+  scheduler.Enqueue(&late);
+  scheduler.Enqueue(&early);
+  scheduler.Enqueue(&mid);
+  EXPECT_EQ(scheduler.GetQueueSize(), 3, "Queue size should be 3");
+  EXPECT_EQ(early.sched_data.dl.abs_deadline, 10,
+            "Absolute deadline should be now + deadline");
+  EXPECT_EQ(early.sched_data.dl.runtime_remaining, 2,
+            "New task should get full budget");
+
+  EXPECT_EQ(scheduler.PickNext(), &early, "Earliest deadline first");
+  EXPECT_EQ(scheduler.PickNext(), &mid, "Then mid");
+  EXPECT_EQ(scheduler.PickNext(), &late, "Then late");
+  EXPECT_TRUE(scheduler.IsEmpty(), "Scheduler should be empty");
+
+  sk_printf("test_deadline_edf_ordering passed\n");
+  return true;
+}
+
+auto test_deadline_dequeue() -> bool {
+  sk_printf("Running test_deadline_dequeue...\n");
+
+  DeadlineScheduler scheduler;
+  static constexpr size_t kTaskCount = 8;
+  TaskControlBlock* tasks[kTaskCount];
+  for (size_t i = 0; i < kTaskCount; ++i) {
+    tasks[i] = new TaskControlBlock("Dl", 1, nullptr, nullptr);
+    tasks[i]->pid = i + 1;
+    // 截止时间乱序：7, 14, 21, 28, 35, 42, 49, 56 按 (i * 3) % 8 排列
+    SetDeadlineParams(*tasks[i], 1, 7 * ((i * 3) % kTaskCount + 1), 100);
+    scheduler.Enqueue(tasks[i]);
+  }
+
+  // 移除树中间的节点，以及重复移除
+  scheduler.Dequeue(tasks[2]);
+  scheduler.Dequeue(tasks[5]);
+  scheduler.Dequeue(tasks[5]);
+  EXPECT_EQ(scheduler.GetQueueSize(), kTaskCount - 2,
+            "Queue size should drop by 2");
+  EXPECT_EQ(scheduler.GetStats().total_dequeues, 2,
+            "Duplicate dequeue should be ignored");
+
+  uint64_t last_deadline = 0;
+  size_t picked = 0;
+  while (auto* task = scheduler.PickNext()) {
+    EXPECT_TRUE(task != tasks[2] && task != tasks[5],
+                "Dequeued task should not be picked");
+    EXPECT_GE(task->sched_data.dl.abs_deadline, last_deadline,
+              "Picks should be in deadline order");
+    last_deadline = task->sched_data.dl.abs_deadline;
+    picked++;
+  }
+  EXPECT_EQ(picked, kTaskCount - 2, "All remaining tasks should be picked");
+
+  for (auto* task : tasks) {
+    delete task;
+  }
+
+  sk_printf("test_deadline_dequeue passed\n");
+  return true;
+}
+
+auto test_deadline_cbs_throttle() -> bool {
+  sk_printf("Running test_deadline_cbs_throttle...\n");
+
+  DeadlineScheduler scheduler;
+  TaskControlBlock task("Task", 1, nullptr, nullptr);
+  SetDeadlineParams(task, 2, 5, 5);
+
+  scheduler.Enqueue(&task);
+  EXPECT_EQ(scheduler.PickNext(), &task, "Task should be picked");
+  scheduler.OnScheduled(&task);
+  EXPECT_EQ(task.sched_info.time_slice_remaining, 2,
+            "Time slice should equal remaining budget");
+
+  EXPECT_FALSE(scheduler.OnTick(&task), "Budget not exhausted yet");
+  EXPECT_TRUE(scheduler.OnTick(&task), "Budget exhausted, should preempt");
+  EXPECT_TRUE(task.sched_data.dl.throttled, "Task should be throttled");
+  EXPECT_EQ(scheduler.GetThrottles(), 1, "Throttle count should be 1");
+
+  scheduler.OnPreempted(&task);
+  EXPECT_FALSE(scheduler.OnTimeSliceExpired(&task),
+               "Throttled task should not be re-enqueued");
+  EXPECT_EQ(scheduler.GetThrottledCount(), 1, "Task should wait for refill");
+  EXPECT_TRUE(scheduler.IsEmpty(), "Ready tree should be empty");
+
+  // 下个周期开始 (tick 5) 前不会补充预算
+  for (uint64_t now = 1; now < 5; ++now) {
+    EXPECT_FALSE(scheduler.OnClockTick(now), "No refill before next period");
+  }
+  EXPECT_TRUE(scheduler.OnClockTick(5), "Budget should be refilled at tick 5");
+  EXPECT_FALSE(task.sched_data.dl.throttled, "Task should be unthrottled");
+  EXPECT_EQ(task.sched_data.dl.runtime_remaining, 2, "Budget refilled");
+  EXPECT_EQ(task.sched_data.dl.abs_deadline, 10, "Deadline advanced");
+  EXPECT_EQ(scheduler.PickNext(), &task, "Task should be ready again");
+
+  sk_printf("test_deadline_cbs_throttle passed\n");
+  return true;
+}
+
+auto test_deadline_many_throttled() -> bool {
+  sk_printf("Running test_deadline_many_throttled...\n");
+
+  // 节流任务数不受就绪队列容量限制，全部在下个周期补充预算
+  DeadlineScheduler scheduler;
+  static constexpr size_t kTaskCount = kernel::config::kMaxReadyTasks * 2;
+  TaskControlBlock* tasks[kTaskCount];
+  for (size_t i = 0; i < kTaskCount; ++i) {
+    tasks[i] = new TaskControlBlock("Dl", 1, nullptr, nullptr);
+    tasks[i]->pid = i + 1;
+    SetDeadlineParams(*tasks[i], 1, 10, 10);
+    scheduler.Enqueue(tasks[i]);
+  }
+  while (auto* task = scheduler.PickNext()) {
+    EXPECT_TRUE(scheduler.OnTick(task), "Budget exhausted, should preempt");
+    EXPECT_FALSE(scheduler.OnTimeSliceExpired(task),
+                 "Throttled task should not be re-enqueued");
+  }
+  EXPECT_EQ(scheduler.GetThrottledCount(), kTaskCount,
+            "All tasks should be throttled");
+
+  // 从链表中间移除一个节流任务
+  scheduler.Dequeue(tasks[kTaskCount / 2]);
+  EXPECT_EQ(scheduler.GetThrottledCount(), kTaskCount - 1,
+            "Dequeued task should leave the throttled list");
+
+  EXPECT_TRUE(scheduler.OnClockTick(10), "Budgets should be refilled");
+  EXPECT_EQ(scheduler.GetThrottledCount(), 0, "No task should stay throttled");
+  EXPECT_EQ(scheduler.GetQueueSize(), kTaskCount - 1,
+            "All remaining tasks should be ready");
+
+  for (auto* task : tasks) {
+    delete task;
+  }
+
+  sk_printf("test_deadline_many_throttled passed\n");
+  return true;
+}
+
+auto test_deadline_preemption() -> bool {
+  sk_printf("Running test_deadline_preemption...\n");
+
+  DeadlineScheduler scheduler;
+  TaskControlBlock current("Current", 1, nullptr, nullptr);
+  current.pid = 1;
+  SetDeadlineParams(current, 10, 50, 50);
+  TaskControlBlock urgent("Urgent", 1, nullptr, nullptr);
+  urgent.pid = 2;
+  SetDeadlineParams(urgent, 2, 10, 10);
+
+  scheduler.Enqueue(&current);
+  EXPECT_EQ(scheduler.PickNext(), &current, "Current should be picked");
+  EXPECT_FALSE(scheduler.OnTick(&current), "No earlier task ready");
+
+  scheduler.Enqueue(&urgent);
+  EXPECT_TRUE(scheduler.OnTick(&current),
+              "Earlier deadline should preempt current task");
+
+  // 被抢占后重新入队，保持原有截止时间与预算
+  scheduler.OnPreempted(&current);
+  EXPECT_TRUE(scheduler.OnTimeSliceExpired(&current),
+              "Preempted task should be re-enqueued");
+  scheduler.Enqueue(&current);
+  EXPECT_EQ(current.sched_data.dl.abs_deadline, 50,
+            "Requeue should keep the deadline");
+  EXPECT_EQ(current.sched_data.dl.runtime_remaining, 8,
+            "Requeue should keep the remaining budget");
+  EXPECT_EQ(scheduler.PickNext(), &urgent, "Urgent task runs first");
+
+  sk_printf("test_deadline_preemption passed\n");
+  return true;
+}
+
+/**
+ * @brief 周期性 deadline 任务与计算密集型普通任务混合负载
+ *
+ * 三个周期任务 (利用率 0.4 + 0.2 + 0.15) 每个周期开始时释放一个作业，
+ * 作业完成后睡眠到下个周期；一个 deadline 任务持续超支 (预算 0.15)，
+ * 由 CBS 节流；三个普通任务持续占用 CPU。
+ * 模拟过程与 TickUpdate()/Schedule() 的调用顺序一致，
+ * 统计周期任务的作业截止时间错过次数。
+ */
+auto test_deadline_under_load() -> bool {
+  sk_printf("Running test_deadline_under_load...\n");
+
+  struct Periodic {
+    uint64_t work;
+    uint64_t deadline;
+    uint64_t period;
+  };
+  static constexpr Periodic kPeriodic[] = {{2, 5, 5}, {2, 8, 10}, {3, 20, 20}};
+  static constexpr size_t kPeriodicCount = sizeof(kPeriodic) / sizeof(Periodic);
+  static constexpr size_t kNormalCount = 3;
+  static constexpr uint64_t kTotalTicks = 2000;
+
+  DeadlineScheduler dl_scheduler;
+  RoundRobinScheduler rr_scheduler;
+
+  TaskControlBlock* periodic[kPeriodicCount];
+  uint64_t next_release[kPeriodicCount]{};
+  uint64_t job_deadline[kPeriodicCount]{};
+  uint64_t work_left[kPeriodicCount]{};
+  bool job_active[kPeriodicCount]{};
+  for (size_t i = 0; i < kPeriodicCount; ++i) {
+    periodic[i] = new TaskControlBlock("Periodic", 1, nullptr, nullptr);
+    periodic[i]->pid = i + 1;
+    SetDeadlineParams(*periodic[i], kPeriodic[i].work, kPeriodic[i].deadline,
+                      kPeriodic[i].period);
+  }
+
+  // 超支任务：预算 3/20，但需要无限 CPU 时间
+  TaskControlBlock hog("Hog", 1, nullptr, nullptr);
+  hog.pid = kPeriodicCount + 1;
+  SetDeadlineParams(hog, 3, 20, 20);
+  dl_scheduler.Enqueue(&hog);
+
+  TaskControlBlock* normal[kNormalCount];
+  for (size_t i = 0; i < kNormalCount; ++i) {
+    normal[i] = new TaskControlBlock("Normal", 10, nullptr, nullptr);
+    rr_scheduler.Enqueue(normal[i]);
+  }
+
+  auto periodic_index = [&](TaskControlBlock* task) -> size_t {
+    for (size_t i = 0; i < kPeriodicCount; ++i) {
+      if (periodic[i] == task) {
+        return i;
+      }
+    }
+    return kPeriodicCount;
+  };
+
+  TaskControlBlock* current = nullptr;
+  bool current_is_dl = false;
+  uint64_t jobs = 0;
+  uint64_t misses = 0;
+  uint64_t hog_ticks = 0;
+  uint64_t normal_ticks = 0;
+
+  auto requeue = [&]() {
+    auto& scheduler = current_is_dl
+                          ? static_cast<SchedulerBase&>(dl_scheduler)
+                          : static_cast<SchedulerBase&>(rr_scheduler);
+    scheduler.OnPreempted(current);
+    if (scheduler.OnTimeSliceExpired(current)) {
+      scheduler.Enqueue(current);
+    }
+    current = nullptr;
+  };
+
+  for (uint64_t tick = 0; tick < kTotalTicks; ++tick) {
+    // TickUpdate: 推进时钟并补充节流任务
+    bool need_preempt = dl_scheduler.OnClockTick(tick);
+
+    // 释放新作业 (相当于从睡眠中唤醒)
+    for (size_t i = 0; i < kPeriodicCount; ++i) {
+      if (!job_active[i] && next_release[i] <= tick) {
+        job_active[i] = true;
+        work_left[i] = kPeriodic[i].work;
+        job_deadline[i] = next_release[i] + kPeriodic[i].deadline;
+        next_release[i] += kPeriodic[i].period;
+        dl_scheduler.Enqueue(periodic[i]);
+        need_preempt = true;
+      }
+    }
+
+    if (current && need_preempt && !current_is_dl) {
+      requeue();
+    }
+
+    // Schedule: Deadline > Normal
+    if (current == nullptr) {
+      current = dl_scheduler.PickNext();
+      current_is_dl = current != nullptr;
+      if (!current) {
+        current = rr_scheduler.PickNext();
+      }
+      if (!current) {
+        continue;
+      }
+      current->sched_info.time_slice_remaining =
+          current->sched_info.time_slice_default;
+      (current_is_dl ? static_cast<SchedulerBase&>(dl_scheduler)
+                     : static_cast<SchedulerBase&>(rr_scheduler))
+          .OnScheduled(current);
+    }
+
+    // 运行一个 tick
+    if (current->sched_info.time_slice_remaining > 0) {
+      current->sched_info.time_slice_remaining--;
+    }
+    bool slice_expired = current_is_dl ? dl_scheduler.OnTick(current)
+                                       : rr_scheduler.OnTick(current);
+    if (current->sched_info.time_slice_remaining == 0) {
+      slice_expired = true;
+    }
+
+    auto idx = periodic_index(current);
+    if (idx < kPeriodicCount) {
+      if (--work_left[idx] == 0) {
+        // 作业完成，在 tick 结束时检查截止时间，然后睡眠到下个周期
+        jobs++;
+        if (tick + 1 > job_deadline[idx]) {
+          misses++;
+        }
+        job_active[idx] = false;
+        current = nullptr;
+        continue;
+      }
+    } else if (current == &hog) {
+      hog_ticks++;
+    } else {
+      normal_ticks++;
+    }
+
+    if (slice_expired) {
+      requeue();
+    }
+  }
+
+  sk_printf("  jobs=%lu misses=%lu throttles=%lu hog=%lu normal=%lu\n",
+            static_cast<unsigned long>(jobs),
+            static_cast<unsigned long>(misses),
+            static_cast<unsigned long>(dl_scheduler.GetThrottles()),
+            static_cast<unsigned long>(hog_ticks),
+            static_cast<unsigned long>(normal_ticks));
+
+  EXPECT_GT(jobs, 0, "Periodic jobs should have run");
+  EXPECT_EQ(misses, 0, "No periodic job should miss its deadline");
+  EXPECT_GT(dl_scheduler.GetThrottles(), 0, "Overrunning task is throttled");
+  EXPECT_LT(hog_ticks, kTotalTicks * 3 / 20 + 3,
+            "Overrunning task is limited to its bandwidth");
+  EXPECT_GT(normal_ticks, 0, "Normal tasks should not starve");
+
+  for (size_t i = 0; i < kPeriodicCount; ++i) {
+    dl_scheduler.Dequeue(periodic[i]);
+    delete periodic[i];
+  }
+  for (size_t i = 0; i < kNormalCount; ++i) {
+    rr_scheduler.Dequeue(normal[i]);
+    delete normal[i];
+  }
+  dl_scheduler.Dequeue(&hog);
+
+  sk_printf("test_deadline_under_load passed\n");
+  return true;
+}
+
+auto test_deadline_admission_control() -> bool {
+  sk_printf("Running test_deadline_admission_control...\n");
+
+  auto& task_manager = TaskManagerSingleton::instance();
+
+  TaskControlBlock task1("Admit1", 10, nullptr, nullptr);
+  task1.cpu_id = cpu_io::GetCurrentCoreId();
+  TaskControlBlock task2("Admit2", 10, nullptr, nullptr);
+  task2.cpu_id = cpu_io::GetCurrentCoreId();
+
+  SchedAttr half{SchedPolicy::kDeadline, 0, 5, 10, 10};
+  SchedAttr normal{};
+
+  // 非法参数：runtime > deadline
+  SchedAttr invalid{SchedPolicy::kDeadline, 0, 10, 5, 10};
+  auto result = task_manager.SetSchedAttr(&task1, invalid);
+  EXPECT_FALSE(result.has_value(), "runtime > deadline should be rejected");
+  EXPECT_EQ(static_cast<uint64_t>(result.error().code),
+            static_cast<uint64_t>(ErrorCode::kTaskInvalidSchedAttr),
+            "Error should be kTaskInvalidSchedAttr");
+
+  result = task_manager.SetSchedAttr(&task1, half);
+  EXPECT_TRUE(result.has_value(), "First 50% task should be admitted");
+  EXPECT_TRUE(task1.policy == SchedPolicy::kDeadline,
+              "Policy should be kDeadline");
+
+  // 50% + 50% 超过 95% 上限
+  result = task_manager.SetSchedAttr(&task2, half);
+  EXPECT_FALSE(result.has_value(), "Second 50% task should be rejected");
+  EXPECT_EQ(static_cast<uint64_t>(result.error().code),
+            static_cast<uint64_t>(ErrorCode::kTaskDeadlineAdmissionFailed),
+            "Error should be kTaskDeadlineAdmissionFailed");
+  EXPECT_TRUE(task2.policy == SchedPolicy::kNormal,
+              "Rejected task should keep its policy");
+
+  // 释放 task1 的带宽后 task2 可以准入
+  result = task_manager.SetSchedAttr(&task1, normal);
+  EXPECT_TRUE(result.has_value(), "Switching back to kNormal should succeed");
+  result = task_manager.SetSchedAttr(&task2, half);
+  EXPECT_TRUE(result.has_value(), "Second task should now be admitted");
+
+  result = task_manager.SetSchedAttr(&task2, normal);
+  EXPECT_TRUE(result.has_value(), "Restore task2 to kNormal");
+
+  sk_printf("test_deadline_admission_control passed\n");
+  return true;
+}
+
+}  // namespace
+
+auto deadline_scheduler_test() -> bool {
+  sk_printf("\n=== Deadline Scheduler System Tests ===\n");
+
+  if (!test_deadline_edf_ordering()) {
+    return false;
+  }
+
+  if (!test_deadline_dequeue()) {
+    return false;
+  }
+
+  if (!test_deadline_cbs_throttle()) {
+    return false;
+  }
+
+  if (!test_deadline_many_throttled()) {
+    return false;
+  }
+
+  if (!test_deadline_preemption()) {
+    return false;
+  }
+
+  if (!test_deadline_under_load()) {
+    return false;
+  }
+
+  if (!test_deadline_admission_control()) {
+    return false;
+  }
+
+  sk_printf("=== All Deadline Scheduler Tests Passed ===\n\n");
+  return true;
+}
@@ -11,7 +11,11 @@
 #include "kstd_cstdio"
 #include "kstd_cstring"
 #include "mount.hpp"
+#include "sk_stdlib.h"
+#include "syscall.hpp"
+#include "syscall_ring.hpp"
 #include "system_test.h"
+#include "task_manager.hpp"
 #include "vfs.hpp"
 
 auto fatfs_system_test() -> bool {
@@ -130,22 +134,23 @@ auto fatfs_system_test() -> bool {
   }
 
   // T6: Unmount and remount — verify persistence
+  // Go through the mount table so cached dentries of the old mount (and the
+  // FatFS inodes they hold) are dropped before the inode pool is reset.
   {
-    auto unmount_result = fat_fs.Unmount();
+    // virtio-blk negotiates VIRTIO_BLK_F_FLUSH; a flush must round-trip
+    EXPECT_TRUE(blk->Flush().has_value(),
+                "fatfs_system_test: virtio-blk flush failed");
+
+    auto unmount_result = vfs::GetMountTable().Unmount("/mnt/fat");
     EXPECT_TRUE(unmount_result.has_value(),
-                "fatfs_system_test: FatFsFileSystem::Unmount failed");
+                "fatfs_system_test: vfs unmount of /mnt/fat failed");
     sk_printf("fatfs_system_test: unmounted ok\n");
 
-    // Remount
-    auto remount_result = fat_fs.Mount(blk);
-    EXPECT_TRUE(remount_result.has_value(),
-                "fatfs_system_test: remount failed");
-    sk_printf("fatfs_system_test: remounted ok\n");
-
-    // Re-wire VFS mount
+    // Remount (MountTable::Mount calls FatFsFileSystem::Mount)
     auto vfs_remount = vfs::GetMountTable().Mount("/mnt/fat", &fat_fs, blk);
     EXPECT_TRUE(vfs_remount.has_value(),
                 "fatfs_system_test: vfs remount failed");
+    sk_printf("fatfs_system_test: remounted ok\n");
 
     // Verify test.txt persisted
     auto file_result = vfs::Open("/mnt/fat/test.txt", vfs::kOReadOnly);
@@ -164,6 +169,119 @@ auto fatfs_system_test() -> bool {
     }
   }
 
+  // T7: Two Files on one inode share a FIL; offsets and PRead stay apart
+  {
+    auto first = vfs::Open("/mnt/fat/test.txt", vfs::kOReadOnly);
+    auto second = vfs::Open("/mnt/fat/test.txt", vfs::kOReadOnly);
+    EXPECT_TRUE(first.has_value() && second.has_value(),
+                "fatfs_system_test: reopen test.txt failed");
+    char head[6] = {};
+    char tail[6] = {};
+    char other[6] = {};
+    auto head_result = vfs::Read(first.value(), head, 5);
+    auto pread_result = vfs::PRead(second.value(), other, 5, 7);
+    auto tail_result = vfs::Read(first.value(), tail, 5);
+    EXPECT_TRUE(head_result.has_value() && pread_result.has_value() &&
+                    tail_result.has_value(),
+                "fatfs_system_test: interleaved reads failed");
+    EXPECT_EQ(memcmp(head, "Hello", 5), 0,
+              "fatfs_system_test: first read mismatch");
+    EXPECT_EQ(memcmp(other, "FatFS", 5), 0,
+              "fatfs_system_test: pread mismatch");
+    EXPECT_EQ(memcmp(tail, ", Fat", 5), 0,
+              "fatfs_system_test: pread moved another file's offset");
+    EXPECT_EQ(second.value()->offset, 0UL,
+              "fatfs_system_test: pread changed the file offset");
+    vfs::Close(second.value());
+    vfs::Close(first.value());
+  }
+
+  // T8: Evicting a cached dentry returns its FatFS inode to the pool, so
+  // lookups keep working after more evictions than the pool has slots
+  {
+    constexpr size_t kCycles = 2 * fatfs::FatFsFileSystem::kMaxInodes;
+    size_t done = 0;
+    for (; done < kCycles; ++done) {
+      auto lookup_result = vfs::Lookup("/mnt/fat/test.txt");
+      if (!lookup_result.has_value()) {
+        break;
+      }
+      vfs::PutDentry(lookup_result.value());
+      (void)vfs::ShrinkDentryCache(SIZE_MAX);
+    }
+    EXPECT_EQ(done, kCycles,
+              "fatfs_system_test: lookup failed after dcache evictions");
+  }
+
+  // T9: Sector-aligned preads submitted through the syscall ring go to the
+  // block device and post their completion from end_io; unaligned ones run
+  // synchronously. min_complete makes ring_enter wait for both.
+  {
+    constexpr size_t kLen = 8192;
+    auto* data = static_cast<uint8_t*>(aligned_alloc(4096, kLen));
+    auto* out = static_cast<uint8_t*>(aligned_alloc(4096, kLen));
+    EXPECT_TRUE(data != nullptr && out != nullptr,
+                "fatfs_system_test: ring buffer allocation failed");
+    for (size_t i = 0; i < kLen; ++i) {
+      data[i] = static_cast<uint8_t>(i * 7);
+    }
+    auto file_result =
+        vfs::Open("/mnt/fat/ring.bin", vfs::kOCreate | vfs::kOReadWrite);
+    EXPECT_TRUE(file_result.has_value(),
+                "fatfs_system_test: open /mnt/fat/ring.bin failed");
+    auto write_result = vfs::Write(file_result.value(), data, kLen);
+    EXPECT_TRUE(write_result.has_value() && write_result.value() == kLen,
+                "fatfs_system_test: write ring.bin failed");
+    vfs::Close(file_result.value());
+
+    int fd = sys_openat(kAtFdCwd, "/mnt/fat/ring.bin", 0, 0);
+    EXPECT_GE(fd, 0, "fatfs_system_test: openat ring.bin failed");
+    SyscallRingParams params{};
+    EXPECT_EQ(sys_ring_setup(4, &params), 0,
+              "fatfs_system_test: ring setup failed");
+    auto* header = reinterpret_cast<SyscallRingHeader*>(params.ring_addr);
+    auto* sq = reinterpret_cast<SyscallSqe*>(params.ring_addr +
+                                             header->sq_offset);
+    auto* cq = reinterpret_cast<SyscallCqe*>(params.ring_addr +
+                                             header->cq_offset);
+    auto fd_arg = static_cast<uint64_t>(fd);
+    auto out_arg = reinterpret_cast<uint64_t>(out);
+    sq[0] = {.opcode = kSyscallPread64,
+             .args = {fd_arg, out_arg, kLen - 512, 512, 0, 0},
+             .user_data = 1};
+    sq[1] = {.opcode = kSyscallPread64,
+             .args = {fd_arg, out_arg + kLen - 512, 100, 1, 0, 0},
+             .user_data = 2};
+    header->sq_tail.store(2, std::memory_order_release);
+    EXPECT_EQ(sys_ring_enter(2, 2), 2,
+              "fatfs_system_test: ring_enter should consume both preads");
+    EXPECT_EQ(header->cq_tail.load(std::memory_order_acquire), 2U,
+              "fatfs_system_test: min_complete should wait for both");
+
+    for (uint32_t i = 0; i < 2; ++i) {
+      const auto& cqe = cq[i];
+      if (cqe.user_data == 1) {
+        EXPECT_EQ(cqe.result, static_cast<int64_t>(kLen - 512),
+                  "fatfs_system_test: aligned ring pread length");
+        EXPECT_EQ(memcmp(out, data + 512, kLen - 512), 0,
+                  "fatfs_system_test: aligned ring pread data mismatch");
+      } else {
+        EXPECT_EQ(cqe.result, 100,
+                  "fatfs_system_test: unaligned ring pread length");
+        EXPECT_EQ(memcmp(out + kLen - 512, data + 1, 100), 0,
+                  "fatfs_system_test: unaligned ring pread data mismatch");
+      }
+    }
+    header->cq_head.store(2, std::memory_order_release);
+
+    auto* current = TaskManagerSingleton::instance().GetCurrentTask();
+    delete current->syscall_ring;
+    current->syscall_ring = nullptr;
+    EXPECT_EQ(sys_close(fd), 0, "fatfs_system_test: close ring.bin failed");
+    free(out);
+    free(data);
+  }
+
   sk_printf("fatfs_system_test: all tests passed\n");
   return true;
 }
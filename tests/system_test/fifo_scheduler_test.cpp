@@ -312,6 +312,139 @@ auto test_fifo_robustness() -> bool {
   return true;
 }
 
+auto test_fifo_priority_levels() -> bool {
+  sk_printf("Running test_fifo_priority_levels...\n");
+
+  FifoScheduler scheduler;
+
+  TaskControlBlock low("Low", 90, nullptr, nullptr);
+  TaskControlBlock high1("High1", 5, nullptr, nullptr);
+  TaskControlBlock mid("Mid", 50, nullptr, nullptr);
+  TaskControlBlock high2("High2", 5, nullptr, nullptr);
+  // 超出范围的优先级归入最低级别
+  TaskControlBlock lowest("Lowest", 1000, nullptr, nullptr);
+
+  scheduler.Enqueue(&lowest);
+  scheduler.Enqueue(&low);
+  scheduler.Enqueue(&high1);
+  scheduler.Enqueue(&mid);
+  scheduler.Enqueue(&high2);
+
+  EXPECT_EQ(scheduler.GetQueueSize(), 5, "Queue size should be 5");
+  EXPECT_EQ(scheduler.GetLevelSize(5), 2, "Level 5 should hold 2 tasks");
+  EXPECT_EQ(scheduler.GetLevelSize(FifoScheduler::kPriorityLevels - 1), 1,
+            "Out-of-range priority should map to the lowest level");
+
+  // 高优先级先运行，同级别按到达顺序
+  EXPECT_EQ(scheduler.PickNext(), &high1, "First pick should be high1");
+  EXPECT_EQ(scheduler.PickNext(), &high2, "Second pick should be high2");
+  EXPECT_EQ(scheduler.PickNext(), &mid, "Third pick should be mid");
+  EXPECT_EQ(scheduler.PickNext(), &low, "Fourth pick should be low");
+  EXPECT_EQ(scheduler.PickNext(), &lowest, "Fifth pick should be lowest");
+  EXPECT_TRUE(scheduler.IsEmpty(), "Scheduler should be empty");
+
+  sk_printf("test_fifo_priority_levels passed\n");
+  return true;
+}
+
+auto test_fifo_all_levels() -> bool {
+  sk_printf("Running test_fifo_all_levels...\n");
+
+  FifoScheduler scheduler;
+  constexpr size_t kTaskCount = FifoScheduler::kPriorityLevels;
+  TaskControlBlock* tasks[kTaskCount];
+
+  // 逆序入队，覆盖位图的每一个字
+  for (size_t i = 0; i < kTaskCount; ++i) {
+    auto priority = static_cast<int>(kTaskCount - 1 - i);
+    tasks[i] = new TaskControlBlock("Task", priority, nullptr, nullptr);
+    scheduler.Enqueue(tasks[i]);
+  }
+
+  // 移除位于不同位图字的级别
+  scheduler.Dequeue(tasks[kTaskCount - 1]);
+  scheduler.Dequeue(tasks[kTaskCount - 1 - 64]);
+  EXPECT_EQ(scheduler.GetQueueSize(), kTaskCount - 2,
+            "Queue size should drop by 2");
+
+  int last_priority = -1;
+  size_t picked = 0;
+  while (auto* task = scheduler.PickNext()) {
+    auto priority = task->sched_info.priority;
+    EXPECT_GT(priority, last_priority,
+              "Tasks should be picked in priority order");
+    EXPECT_TRUE(priority != 0 && priority != 64,
+                "Dequeued levels should not be picked");
+    last_priority = priority;
+    picked++;
+  }
+  EXPECT_EQ(picked, kTaskCount - 2, "All remaining tasks should be picked");
+
+  for (size_t i = 0; i < kTaskCount; ++i) {
+    delete tasks[i];
+  }
+
+  sk_printf("test_fifo_all_levels passed\n");
+  return true;
+}
+
+auto test_fifo_preemption() -> bool {
+  sk_printf("Running test_fifo_preemption...\n");
+
+  FifoScheduler scheduler;
+
+  TaskControlBlock current("Current", 20, nullptr, nullptr);
+  TaskControlBlock same("Same", 20, nullptr, nullptr);
+  TaskControlBlock lower("Lower", 30, nullptr, nullptr);
+  TaskControlBlock higher("Higher", 10, nullptr, nullptr);
+
+  scheduler.Enqueue(&same);
+  scheduler.Enqueue(&lower);
+  EXPECT_FALSE(scheduler.OnTick(&current),
+               "Same or lower priority should not preempt");
+
+  scheduler.Enqueue(&higher);
+  EXPECT_TRUE(scheduler.OnTick(&current),
+              "Higher priority task should preempt current");
+
+  sk_printf("test_fifo_preemption passed\n");
+  return true;
+}
+
+auto test_fifo_priority_inheritance() -> bool {
+  sk_printf("Running test_fifo_priority_inheritance...\n");
+
+  FifoScheduler scheduler;
+
+  TaskControlBlock holder("Holder", 40, nullptr, nullptr);
+  TaskControlBlock other("Other", 20, nullptr, nullptr);
+
+  scheduler.Enqueue(&other);
+  scheduler.Enqueue(&holder);
+
+  // 提升后在就绪队列中移动到新级别
+  scheduler.BoostPriority(&holder, 10);
+  EXPECT_EQ(holder.sched_info.priority, 10, "Priority should be boosted");
+  EXPECT_EQ(scheduler.GetLevelSize(40), 0, "Old level should be empty");
+  EXPECT_EQ(scheduler.GetLevelSize(10), 1, "New level should hold holder");
+
+  // 更低的继承优先级不会降低当前优先级
+  scheduler.BoostPriority(&holder, 30);
+  EXPECT_EQ(holder.sched_info.priority, 10, "Boost should never lower");
+
+  EXPECT_EQ(scheduler.PickNext(), &holder, "Boosted task runs first");
+
+  scheduler.Enqueue(&holder);
+  scheduler.RestorePriority(&holder);
+  EXPECT_EQ(holder.sched_info.priority, 40, "Priority should be restored");
+  EXPECT_EQ(scheduler.GetLevelSize(40), 1, "Holder should be back at 40");
+  EXPECT_EQ(scheduler.PickNext(), &other, "Other runs before holder");
+  EXPECT_EQ(scheduler.PickNext(), &holder, "Holder runs last");
+
+  sk_printf("test_fifo_priority_inheritance passed\n");
+  return true;
+}
+
 }  // namespace
 
 auto fifo_scheduler_test() -> bool {
@@ -349,6 +482,22 @@ auto fifo_scheduler_test() -> bool {
     return false;
   }
 
+  if (!test_fifo_priority_levels()) {
+    return false;
+  }
+
+  if (!test_fifo_all_levels()) {
+    return false;
+  }
+
+  if (!test_fifo_preemption()) {
+    return false;
+  }
+
+  if (!test_fifo_priority_inheritance()) {
+    return false;
+  }
+
   sk_printf("=== All FIFO Scheduler Tests Passed ===\n\n");
   return true;
 }
@@ -0,0 +1,258 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "arch.h"
+#include "kstd_cstring"
+#include "sk_stdio.h"
+#include "syscall.hpp"
+#include "system_test.h"
+#include "task_manager.hpp"
+
+namespace {
+
+/// 与 Linux O_* 取值一致的打开标志
+constexpr int kOReadWrite = 0x0002;
+constexpr int kOCreate = 0x0040;
+
+/// lseek 的基准位置
+constexpr int kSeekSet = 0;
+constexpr int kSeekCur = 1;
+constexpr int kSeekEnd = 2;
+
+/// 基准测试的记录数与记录长度
+constexpr int kBenchRecords = 32;
+constexpr size_t kRecordSize = 16;
+
+auto OpenTestFile(const char* path) -> int {
+  return sys_openat(kAtFdCwd, path, kOCreate | kOReadWrite, 0644);
+}
+
+auto test_open_close() -> bool {
+  sk_printf("Running test_open_close...\n");
+
+  int fd = OpenTestFile("/file_syscall.txt");
+  EXPECT_GE(fd, 3, "openat should skip the standard fds");
+
+  // 相对路径按根目录解析
+  int rel_fd = sys_openat(kAtFdCwd, "file_syscall.txt", kOReadWrite, 0);
+  EXPECT_GE(rel_fd, 3, "Relative path should resolve from root");
+  EXPECT_NE(rel_fd, fd, "Each open should get a new fd");
+
+  EXPECT_EQ(sys_openat(fd, "file_syscall.txt", kOReadWrite, 0), -1,
+            "dirfd other than AT_FDCWD should fail");
+  EXPECT_EQ(sys_openat(kAtFdCwd, "/no_such_file", kOReadWrite, 0), -1,
+            "Opening a missing file without O_CREAT should fail");
+
+  EXPECT_EQ(sys_close(rel_fd), 0, "close should succeed");
+  EXPECT_EQ(sys_close(fd), 0, "close should succeed");
+  EXPECT_EQ(sys_close(fd), -1, "Closing twice should fail");
+  EXPECT_EQ(sys_read(fd, nullptr, 0), -1, "Closed fd should be invalid");
+
+  sk_printf("test_open_close passed\n");
+  return true;
+}
+
+auto test_read_write_seek() -> bool {
+  sk_printf("Running test_read_write_seek...\n");
+
+  int fd = OpenTestFile("/file_rw.txt");
+  EXPECT_GE(fd, 3, "openat should succeed");
+
+  static const char kData[] = "0123456789";
+  EXPECT_EQ(sys_write(fd, kData, 10), 10, "write should write all bytes");
+  EXPECT_EQ(sys_lseek(fd, 0, kSeekCur), 10, "Offset should follow write");
+
+  char buf[16] = {};
+  EXPECT_EQ(sys_lseek(fd, 0, kSeekSet), 0, "lseek to start");
+  EXPECT_EQ(sys_read(fd, buf, sizeof(buf)), 10, "read should stop at EOF");
+  EXPECT_EQ(kstd::memcmp(buf, kData, 10), 0, "read content mismatch");
+  EXPECT_EQ(sys_read(fd, buf, sizeof(buf)), 0, "read at EOF returns 0");
+
+  EXPECT_EQ(sys_lseek(fd, -3, kSeekEnd), 7, "lseek from end");
+  EXPECT_EQ(sys_read(fd, buf, 3), 3, "read the tail");
+  EXPECT_EQ(kstd::memcmp(buf, "789", 3), 0, "tail content mismatch");
+  EXPECT_EQ(sys_lseek(fd, 0, 3), -1, "Unknown whence should fail");
+
+  EXPECT_EQ(sys_close(fd), 0, "close should succeed");
+
+  sk_printf("test_read_write_seek passed\n");
+  return true;
+}
+
+auto test_positional() -> bool {
+  sk_printf("Running test_positional...\n");
+
+  int fd = OpenTestFile("/file_pos.txt");
+  EXPECT_GE(fd, 3, "openat should succeed");
+  EXPECT_EQ(sys_write(fd, "0123456789", 10), 10, "write should succeed");
+
+  // pread/pwrite 不使用也不改变文件偏移量
+  EXPECT_EQ(sys_lseek(fd, 4, kSeekSet), 4, "lseek should succeed");
+  EXPECT_EQ(sys_pwrite64(fd, "AB", 2, 2), 2, "pwrite should succeed");
+  char buf[8] = {};
+  EXPECT_EQ(sys_pread64(fd, buf, 5, 0), 5, "pread should succeed");
+  EXPECT_EQ(kstd::memcmp(buf, "01AB4", 5), 0, "pread content mismatch");
+  EXPECT_EQ(sys_lseek(fd, 0, kSeekCur), 4, "Offset should be unchanged");
+  EXPECT_EQ(sys_pread64(fd, buf, 4, 100), 0, "pread past EOF returns 0");
+  EXPECT_EQ(sys_pread64(fd, buf, 4, -1), -1, "Negative offset should fail");
+
+  EXPECT_EQ(sys_close(fd), 0, "close should succeed");
+
+  sk_printf("test_positional passed\n");
+  return true;
+}
+
+auto test_vectored() -> bool {
+  sk_printf("Running test_vectored...\n");
+
+  int fd = OpenTestFile("/file_vec.txt");
+  EXPECT_GE(fd, 3, "openat should succeed");
+
+  char head[] = "head:";
+  char body[] = "scatter-gather";
+  char tail[] = ";";
+  UserIoVec out[4] = {{head, 5}, {nullptr, 0}, {body, 14}, {tail, 1}};
+  EXPECT_EQ(sys_writev(fd, out, 4), 20, "writev should write all segments");
+
+  char first[3] = {};
+  char second[32] = {};
+  UserIoVec in[2] = {{first, sizeof(first)}, {second, sizeof(second)}};
+  EXPECT_EQ(sys_lseek(fd, 0, kSeekSet), 0, "lseek should succeed");
+  EXPECT_EQ(sys_readv(fd, in, 2), 20, "readv should read the whole file");
+  EXPECT_EQ(kstd::memcmp(first, "hea", 3), 0, "First segment mismatch");
+  EXPECT_EQ(kstd::memcmp(second, "d:scatter-gather;", 17), 0,
+            "Second segment mismatch");
+
+#if defined(__riscv) || defined(__aarch64__)
+  // 拷贝到用户缓冲区失败时退回偏移量，未返回的数据仍可再次读取
+  UserIoVec bad[2] = {{first, sizeof(first)},
+                      {reinterpret_cast<void*>(0x3FFFF00000), 8}};
+  EXPECT_EQ(sys_lseek(fd, 0, kSeekSet), 0, "lseek should succeed");
+  EXPECT_EQ(sys_readv(fd, bad, 2), -1, "readv to unmapped memory fails");
+  EXPECT_EQ(sys_lseek(fd, 0, kSeekCur), 0, "Failed readv should rewind");
+#endif
+
+  EXPECT_EQ(sys_readv(fd, in, -1), -1, "Negative iovcnt should fail");
+  EXPECT_EQ(sys_writev(fd, out, kIovMax + 1), -1,
+            "Too many segments should fail");
+
+  EXPECT_EQ(sys_close(fd), 0, "close should succeed");
+
+  sk_printf("test_vectored passed\n");
+  return true;
+}
+
+auto test_fd_table_clone() -> bool {
+  sk_printf("Running test_fd_table_clone...\n");
+
+  auto* current = TaskManagerSingleton::instance().GetCurrentTask();
+  EXPECT_TRUE(current != nullptr, "Should have a current task");
+
+  int fd = OpenTestFile("/file_clone.txt");
+  EXPECT_GE(fd, 3, "openat should succeed");
+
+  // 不带 kFiles 的 clone 复制表项，同号 fd 共享 File 与偏移量
+  auto result = current->fd_table->Clone();
+  EXPECT_TRUE(result.has_value(), "Clone should succeed");
+  auto* copy = result.value();
+  EXPECT_TRUE(copy->Get(fd) == current->fd_table->Get(fd),
+              "Copied fd should refer to the same file");
+
+  EXPECT_EQ(sys_write(fd, "abc", 3), 3, "write should succeed");
+  EXPECT_EQ(copy->Get(fd)->offset, static_cast<uint64_t>(3),
+            "Offset should be shared");
+
+  // 原表关闭后，副本中的 File 仍然有效
+  EXPECT_EQ(sys_close(fd), 0, "close should succeed");
+  EXPECT_TRUE(copy->Get(fd) != nullptr, "Copy should keep its reference");
+  copy->CloseFiles();
+  EXPECT_EQ(copy->GetOpenCount(), 0, "All files should be closed");
+  delete copy;
+
+  sk_printf("test_fd_table_clone passed\n");
+  return true;
+}
+
+auto test_vectored_benchmark() -> bool {
+  sk_printf("Running test_vectored_benchmark...\n");
+
+  int fd = OpenTestFile("/file_bench.txt");
+  EXPECT_GE(fd, 3, "openat should succeed");
+
+  static char records[kBenchRecords][kRecordSize];
+  UserIoVec iov[kBenchRecords];
+  for (int i = 0; i < kBenchRecords; ++i) {
+    kstd::memset(records[i], 'a' + i % 26, kRecordSize);
+    iov[i] = {records[i], kRecordSize};
+  }
+
+  // 逐条 write 与一次 writev 的耗时对比
+  auto start = ReadTimestamp();
+  for (int i = 0; i < kBenchRecords; ++i) {
+    EXPECT_EQ(sys_write(fd, records[i], kRecordSize),
+              static_cast<int>(kRecordSize), "write should succeed");
+  }
+  auto write_cost = ReadTimestamp() - start;
+
+  start = ReadTimestamp();
+  EXPECT_EQ(sys_writev(fd, iov, kBenchRecords),
+            static_cast<int>(kBenchRecords * kRecordSize),
+            "writev should succeed");
+  auto writev_cost = ReadTimestamp() - start;
+
+  // 两种方式写出的内容相同
+  char buf[kRecordSize];
+  EXPECT_EQ(sys_pread64(fd, buf, kRecordSize,
+                        (kBenchRecords + 1) * kRecordSize),
+            static_cast<int>(kRecordSize), "pread should succeed");
+  EXPECT_EQ(kstd::memcmp(buf, records[1], kRecordSize), 0,
+            "writev content mismatch");
+
+  sk_printf("file write benchmark (%d x %lu bytes): write %lu ticks, "
+            "writev %lu ticks\n",
+            kBenchRecords, static_cast<unsigned long>(kRecordSize),
+            static_cast<unsigned long>(write_cost),
+            static_cast<unsigned long>(writev_cost));
+
+  EXPECT_EQ(sys_close(fd), 0, "close should succeed");
+
+  sk_printf("test_vectored_benchmark passed\n");
+  return true;
+}
+
+}  // namespace
+
+auto file_syscall_test() -> bool {
+  sk_printf("\n=== File Syscall System Tests ===\n");
+
+  if (!test_open_close()) {
+    return false;
+  }
+
+  if (!test_read_write_seek()) {
+    return false;
+  }
+
+  if (!test_positional()) {
+    return false;
+  }
+
+  if (!test_vectored()) {
+    return false;
+  }
+
+  if (!test_fd_table_clone()) {
+    return false;
+  }
+
+  if (!test_vectored_benchmark()) {
+    return false;
+  }
+
+  sk_printf("=== All File Syscall Tests Passed ===\n\n");
+  return true;
+}
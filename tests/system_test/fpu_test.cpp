@@ -0,0 +1,164 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include <cpu_io.h>
+
+#include <cstdint>
+
+#include "arch.h"
+#include "kernel_fpu.hpp"
+#include "per_cpu.hpp"
+#include "sk_stdio.h"
+#include "system_test.h"
+#include "task_manager.hpp"
+
+namespace {
+
+auto test_kernel_fpu_nesting() -> bool {
+  sk_printf("Running test_kernel_fpu_nesting...\n");
+
+  auto& cpu_data = per_cpu::GetCurrentCore();
+  auto intr_before = cpu_io::GetInterruptStatus();
+
+  {
+    KernelFpuGuard outer;
+    EXPECT_EQ(cpu_data.kernel_fpu_depth, 1, "Depth should be 1");
+    EXPECT_FALSE(cpu_io::GetInterruptStatus(),
+                 "Interrupts should be disabled inside KernelFpu section");
+    EXPECT_TRUE(cpu_data.fpu_owner == nullptr,
+                "No task should own the FPU inside KernelFpu section");
+    {
+      KernelFpuGuard inner;
+      EXPECT_EQ(cpu_data.kernel_fpu_depth, 2, "Depth should be 2");
+    }
+    EXPECT_EQ(cpu_data.kernel_fpu_depth, 1, "Inner end should keep section");
+    EXPECT_FALSE(cpu_io::GetInterruptStatus(),
+                 "Inner end should not enable interrupts");
+  }
+
+  EXPECT_EQ(cpu_data.kernel_fpu_depth, 0, "Depth should be 0");
+  EXPECT_EQ(cpu_io::GetInterruptStatus(), intr_before,
+            "Interrupt state should be restored");
+
+  sk_printf("test_kernel_fpu_nesting passed\n");
+  return true;
+}
+
+auto test_fpu_save_restore() -> bool {
+  sk_printf("Running test_fpu_save_restore...\n");
+
+  FpuState initial;
+  FpuState first;
+  FpuState second;
+  FpuInitState(&initial);
+
+  {
+    KernelFpuGuard guard;
+    // 加载初始状态后保存两次，结果应一致
+    FpuRestore(&initial);
+    FpuSave(&first);
+    FpuRestore(&first);
+    FpuSave(&second);
+  }
+
+  for (size_t i = 0; i < kFpuStateSize; ++i) {
+    EXPECT_EQ(first.data[i], second.data[i], "FPU state should round-trip");
+  }
+
+  sk_printf("test_fpu_save_restore passed\n");
+  return true;
+}
+
+auto test_fpu_trap_loads_state() -> bool {
+  sk_printf("Running test_fpu_trap_loads_state...\n");
+
+  auto& task_manager = TaskManagerSingleton::instance();
+  auto& cpu_data = per_cpu::GetCurrentCore();
+  auto* current = task_manager.GetCurrentTask();
+
+  // 模拟首次使用 FPU 时的陷入
+  task_manager.HandleFpuTrap();
+  EXPECT_TRUE(current->fpu_used, "Trap should mark the task as FPU user");
+  EXPECT_TRUE(cpu_data.fpu_owner == current, "Current task should own FPU");
+  EXPECT_EQ(current->fpu_cpu, cpu_data.core_id, "fpu_cpu should be this core");
+
+  // 内核使用 FPU 时保存任务的状态并放弃所有权，之后任务需要重新加载
+  {
+    KernelFpuGuard guard;
+    EXPECT_TRUE(cpu_data.fpu_owner == nullptr,
+                "KernelFpuBegin should drop FPU ownership");
+  }
+  EXPECT_TRUE(cpu_data.fpu_owner == nullptr,
+              "Task should reload FPU state after KernelFpuEnd");
+
+  sk_printf("test_fpu_trap_loads_state passed\n");
+  return true;
+}
+
+auto test_fpu_release_on_exit() -> bool {
+  sk_printf("Running test_fpu_release_on_exit...\n");
+
+  auto& task_manager = TaskManagerSingleton::instance();
+  auto& cpu_data = per_cpu::GetCurrentCore();
+  TaskControlBlock exiting("FpuExiting", 10, nullptr, nullptr);
+  TaskControlBlock other("FpuOther", 10, nullptr, nullptr);
+
+  // 关中断，避免调度时看到伪造的持有者
+  auto intr_before = cpu_io::GetInterruptStatus();
+  cpu_io::DisableInterrupt();
+  auto* saved_owner = cpu_data.fpu_owner;
+
+  // 退出的任务是其 fpu_cpu 上的持有者：清除
+  cpu_data.fpu_owner = &exiting;
+  exiting.fpu_cpu = cpu_data.core_id;
+  task_manager.ReleaseFpu(&exiting);
+  auto* owner_after_release = cpu_data.fpu_owner;
+  auto fpu_cpu_after_release = exiting.fpu_cpu;
+
+  // 该核心已换了持有者：保持不变
+  cpu_data.fpu_owner = &other;
+  exiting.fpu_cpu = cpu_data.core_id;
+  task_manager.ReleaseFpu(&exiting);
+  auto* owner_after_skip = cpu_data.fpu_owner;
+
+  cpu_data.fpu_owner = saved_owner;
+  if (intr_before) {
+    cpu_io::EnableInterrupt();
+  }
+
+  EXPECT_TRUE(owner_after_release == nullptr,
+              "Exiting task should no longer own the FPU");
+  EXPECT_EQ(fpu_cpu_after_release, SIMPLEKERNEL_MAX_CORE_COUNT,
+            "fpu_cpu should be reset");
+  EXPECT_TRUE(owner_after_skip == &other,
+              "Another task's ownership should be kept");
+
+  sk_printf("test_fpu_release_on_exit passed\n");
+  return true;
+}
+
+}  // namespace
+
+auto fpu_test() -> bool {
+  sk_printf("\n=== FPU System Tests ===\n");
+
+  if (!test_kernel_fpu_nesting()) {
+    return false;
+  }
+
+  if (!test_fpu_save_restore()) {
+    return false;
+  }
+
+  if (!test_fpu_trap_loads_state()) {
+    return false;
+  }
+
+  if (!test_fpu_release_on_exit()) {
+    return false;
+  }
+
+  sk_printf("=== All FPU Tests Passed ===\n\n");
+  return true;
+}
@@ -27,7 +27,7 @@ struct test_case {
   bool is_smp_test = false;
 };
 
-std::array<test_case, 18> test_cases = {
+std::array<test_case, 28> test_cases = {
     test_case{"ctor_dtor_test", ctor_dtor_test, false},
     test_case{"spinlock_test", spinlock_test, true},
     test_case{"memory_test", memory_test, false},
@@ -37,13 +37,23 @@ std::array<test_case, 18> test_cases = {
     test_case{"rr_scheduler_test", rr_scheduler_test, false},
     test_case{"cfs_scheduler_test", cfs_scheduler_test, false},
     test_case{"idle_scheduler_test", idle_scheduler_test, false},
+    test_case{"mlfq_scheduler_test", mlfq_scheduler_test, false},
+    test_case{"deadline_scheduler_test", deadline_scheduler_test, false},
+    test_case{"affinity_test", affinity_test, false},
+    test_case{"fpu_test", fpu_test, false},
+    test_case{"syscall_ring_test", syscall_ring_test, false},
+    test_case{"vdso_test", vdso_test, false},
+    test_case{"user_access_test", user_access_test, false},
     test_case{"thread_group_system_test", thread_group_system_test, false},
     test_case{"wait_system_test", wait_system_test, false},
     test_case{"clone_system_test", clone_system_test, false},
     test_case{"exit_system_test", exit_system_test, false},
     test_case{"ramfs_system_test", ramfs_system_test, false},
+    test_case{"file_syscall_test", file_syscall_test, false},
     test_case{"fatfs_system_test", fatfs_system_test, false},
+    test_case{"virtio_net_test", virtio_net_test, false},
     test_case{"mutex_test", mutex_test, false},
+    test_case{"completion_test", completion_test, false},
     test_case{"kernel_task_test", kernel_task_test, false},
     test_case{"user_task_test", user_task_test, false}};
 
@@ -118,6 +128,9 @@ auto main(int argc, const char** argv) -> int {
   // 设备管理器初始化
   DeviceInit();
 
+  // 设备中断初始化
+  DeviceInterruptInit();
+
   // 文件系统初始化
   FileSystemInit();
 
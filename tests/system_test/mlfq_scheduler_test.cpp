@@ -0,0 +1,373 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "mlfq_scheduler.hpp"
+
+#include <cstdint>
+
+#include "rr_scheduler.hpp"
+#include "sk_stdio.h"
+#include "system_test.h"
+#include "task_control_block.hpp"
+#include "task_messages.hpp"
+
+namespace {
+
+auto test_mlfq_basic_functionality() -> bool {
+  sk_printf("Running test_mlfq_basic_functionality...\n");
+
+  MlfqScheduler scheduler;
+
+  EXPECT_EQ(scheduler.name[0], 'M', "Scheduler name should start with M");
+
+  TaskControlBlock task1("Task1", 1, nullptr, nullptr);
+  task1.fsm.Receive(MsgSchedule{});
+  TaskControlBlock task2("Task2", 2, nullptr, nullptr);
+  task2.fsm.Receive(MsgSchedule{});
+
+  EXPECT_TRUE(scheduler.IsEmpty(), "Scheduler should be empty initially");
+  EXPECT_EQ(scheduler.PickNext(), nullptr,
+            "PickNext should return nullptr for empty queue");
+
+  scheduler.Enqueue(&task1);
+  scheduler.Enqueue(&task2);
+  EXPECT_EQ(scheduler.GetQueueSize(), 2, "Queue size should be 2");
+  EXPECT_EQ(task1.sched_data.mlfq.level, 0, "New task should start at level 0");
+
+  EXPECT_EQ(scheduler.PickNext(), &task1, "First pick should be task1");
+  EXPECT_EQ(scheduler.PickNext(), &task2, "Second pick should be task2");
+  EXPECT_TRUE(scheduler.IsEmpty(), "Scheduler should be empty");
+
+  sk_printf("test_mlfq_basic_functionality passed\n");
+  return true;
+}
+
+auto test_mlfq_level_ordering() -> bool {
+  sk_printf("Running test_mlfq_level_ordering...\n");
+
+  MlfqScheduler scheduler;
+
+  TaskControlBlock low("Low", 1, nullptr, nullptr);
+  low.sched_data.mlfq.level = 5;
+  TaskControlBlock mid("Mid", 1, nullptr, nullptr);
+  mid.sched_data.mlfq.level = 2;
+  TaskControlBlock high("High", 1, nullptr, nullptr);
+  high.sched_data.mlfq.level = 0;
+
+  scheduler.Enqueue(&low);
+  scheduler.Enqueue(&mid);
+  scheduler.Enqueue(&high);
+
+  EXPECT_EQ(scheduler.GetLevelSize(5), 1, "Level 5 should hold one task");
+  EXPECT_EQ(scheduler.PickNext(), &high, "Level 0 task should be picked first");
+  EXPECT_EQ(scheduler.PickNext(), &mid, "Level 2 task should be picked next");
+  EXPECT_EQ(scheduler.PickNext(), &low, "Level 5 task should be picked last");
+
+  // 越界级别被钳制到最低级别
+  TaskControlBlock bogus("Bogus", 1, nullptr, nullptr);
+  bogus.sched_data.mlfq.level = 200;
+  scheduler.Enqueue(&bogus);
+  EXPECT_EQ(bogus.sched_data.mlfq.level, MlfqScheduler::kLevelCount - 1,
+            "Out of range level should be clamped");
+  scheduler.Dequeue(&bogus);
+  EXPECT_TRUE(scheduler.IsEmpty(), "Scheduler should be empty");
+
+  sk_printf("test_mlfq_level_ordering passed\n");
+  return true;
+}
+
+auto test_mlfq_demotion() -> bool {
+  sk_printf("Running test_mlfq_demotion...\n");
+
+  MlfqScheduler scheduler;
+
+  TaskControlBlock task("Task", 1, nullptr, nullptr);
+  scheduler.Enqueue(&task);
+  EXPECT_EQ(scheduler.PickNext(), &task, "Should pick task");
+  scheduler.OnScheduled(&task);
+  EXPECT_EQ(task.sched_info.time_slice_remaining, MlfqScheduler::GetQuantum(0),
+            "Time slice should match level 0 quantum");
+
+  // 用完 level 0 的配额
+  bool need_resched = false;
+  for (uint32_t i = 0; i < MlfqScheduler::GetQuantum(0); ++i) {
+    need_resched = scheduler.OnTick(&task);
+  }
+  EXPECT_TRUE(need_resched, "OnTick should request resched on quantum expiry");
+
+  EXPECT_TRUE(scheduler.OnTimeSliceExpired(&task),
+              "OnTimeSliceExpired should request requeue");
+  EXPECT_EQ(task.sched_data.mlfq.level, 1, "Task should be demoted to level 1");
+  EXPECT_EQ(task.sched_data.mlfq.ticks_used, 0,
+            "Quantum usage should reset after demotion");
+  EXPECT_EQ(scheduler.GetDemotions(), 1, "Demotion count should be 1");
+
+  // 主动让出 (配额未用完) 不降级，但累计的使用量保留
+  scheduler.OnScheduled(&task);
+  EXPECT_FALSE(scheduler.OnTick(&task), "One tick should not expire level 1");
+  EXPECT_TRUE(scheduler.OnTimeSliceExpired(&task), "Yield should requeue");
+  EXPECT_EQ(task.sched_data.mlfq.level, 1, "Yield should not demote");
+  EXPECT_EQ(task.sched_data.mlfq.ticks_used, 1,
+            "Quantum usage should accumulate across yields");
+
+  scheduler.OnScheduled(&task);
+  EXPECT_EQ(task.sched_info.time_slice_remaining,
+            MlfqScheduler::GetQuantum(1) - 1,
+            "Time slice should be the remaining quantum");
+
+  // 最低级别不再降级
+  task.sched_data.mlfq.level = MlfqScheduler::kLevelCount - 1;
+  task.sched_data.mlfq.ticks_used =
+      MlfqScheduler::GetQuantum(MlfqScheduler::kLevelCount - 1);
+  EXPECT_TRUE(scheduler.OnTimeSliceExpired(&task), "Should requeue");
+  EXPECT_EQ(task.sched_data.mlfq.level, MlfqScheduler::kLevelCount - 1,
+            "Lowest level task should stay at lowest level");
+
+  sk_printf("test_mlfq_demotion passed\n");
+  return true;
+}
+
+auto test_mlfq_preemption() -> bool {
+  sk_printf("Running test_mlfq_preemption...\n");
+
+  MlfqScheduler scheduler;
+
+  TaskControlBlock batch("Batch", 1, nullptr, nullptr);
+  batch.sched_data.mlfq.level = 4;
+  TaskControlBlock interactive("Interactive", 1, nullptr, nullptr);
+
+  EXPECT_FALSE(scheduler.OnTick(&batch),
+               "No preemption without higher level tasks");
+
+  scheduler.Enqueue(&interactive);
+  EXPECT_TRUE(scheduler.OnTick(&batch),
+              "Higher level ready task should preempt current");
+
+  sk_printf("test_mlfq_preemption passed\n");
+  return true;
+}
+
+auto test_mlfq_boost() -> bool {
+  sk_printf("Running test_mlfq_boost...\n");
+
+  MlfqScheduler scheduler;
+
+  TaskControlBlock current("Current", 1, nullptr, nullptr);
+  current.sched_data.mlfq.level = MlfqScheduler::kLevelCount - 1;
+  TaskControlBlock starved1("Starved1", 1, nullptr, nullptr);
+  starved1.sched_data.mlfq.level = 6;
+  TaskControlBlock starved2("Starved2", 1, nullptr, nullptr);
+  starved2.sched_data.mlfq.level = 3;
+
+  scheduler.Enqueue(&starved1);
+  scheduler.Enqueue(&starved2);
+
+  for (uint64_t i = 0; i < MlfqScheduler::kBoostInterval; ++i) {
+    (void)scheduler.OnTick(&current);
+    current.sched_data.mlfq.ticks_used = 0;
+  }
+
+  EXPECT_EQ(scheduler.GetBoosts(), 1, "Boost should happen once");
+  EXPECT_EQ(current.sched_data.mlfq.level, 0, "Current task should be boosted");
+  EXPECT_EQ(starved1.sched_data.mlfq.level, 0, "Starved1 should be boosted");
+  EXPECT_EQ(starved2.sched_data.mlfq.level, 0, "Starved2 should be boosted");
+  EXPECT_EQ(scheduler.GetLevelSize(0), 2, "All tasks should be at level 0");
+  EXPECT_EQ(scheduler.GetQueueSize(), 2, "Queue size should be unchanged");
+
+  // 提升保持低级别之间的相对顺序：先高级别，后低级别
+  EXPECT_EQ(scheduler.PickNext(), &starved2, "Level 3 task should come first");
+  EXPECT_EQ(scheduler.PickNext(), &starved1, "Level 6 task should come next");
+
+  sk_printf("test_mlfq_boost passed\n");
+  return true;
+}
+
+auto test_mlfq_dequeue_and_stats() -> bool {
+  sk_printf("Running test_mlfq_dequeue_and_stats...\n");
+
+  MlfqScheduler scheduler;
+
+  TaskControlBlock task1("Task1", 1, nullptr, nullptr);
+  TaskControlBlock task2("Task2", 1, nullptr, nullptr);
+  task2.sched_data.mlfq.level = 3;
+
+  scheduler.Enqueue(&task1);
+  scheduler.Enqueue(&task2);
+  scheduler.Dequeue(&task2);
+  EXPECT_EQ(scheduler.GetQueueSize(), 1, "Queue size should be 1");
+  EXPECT_EQ(scheduler.GetLevelSize(3), 0, "Level 3 should be empty");
+
+  // 重复移除不应崩溃
+  scheduler.Dequeue(&task2);
+  scheduler.OnPreempted(&task1);
+
+  auto stats = scheduler.GetStats();
+  EXPECT_EQ(stats.total_enqueues, 2, "Enqueues should be 2");
+  EXPECT_EQ(stats.total_dequeues, 1, "Dequeues should be 1");
+  EXPECT_EQ(stats.total_preemptions, 1, "Preemptions should be 1");
+
+  scheduler.ResetStats();
+  stats = scheduler.GetStats();
+  EXPECT_EQ(stats.total_enqueues, 0, "Enqueues should be 0 after reset");
+  EXPECT_EQ(scheduler.GetDemotions(), 0, "Demotions should be 0 after reset");
+
+  sk_printf("test_mlfq_dequeue_and_stats passed\n");
+  return true;
+}
+
+/**
+ * @brief 模拟混合负载，返回交互式任务从唤醒到被调度的平均延迟 (ticks)
+ *
+ * kCpuBound 个计算密集型任务一直运行；kInteractive 个交互式任务每次运行
+ * 1 tick 后阻塞 kSleepTicks。模拟过程与 Schedule()/TickUpdate() 的调用
+ * 顺序一致。
+ */
+template <typename Scheduler>
+auto SimulateMixedWorkload(Scheduler& scheduler) -> uint64_t {
+  static constexpr size_t kCpuBound = 4;
+  static constexpr size_t kInteractive = 2;
+  static constexpr size_t kTaskCount = kCpuBound + kInteractive;
+  static constexpr uint64_t kSleepTicks = 20;
+  static constexpr uint64_t kTotalTicks = 5000;
+
+  TaskControlBlock* tasks[kTaskCount];
+  uint64_t wake_tick[kTaskCount]{};
+  uint64_t sleep_until[kTaskCount]{};
+  bool sleeping[kTaskCount]{};
+
+  for (size_t i = 0; i < kTaskCount; ++i) {
+    tasks[i] = new TaskControlBlock("Sim", 10, nullptr, nullptr);
+    scheduler.Enqueue(tasks[i]);
+  }
+
+  auto index_of = [&](TaskControlBlock* task) -> size_t {
+    for (size_t i = 0; i < kTaskCount; ++i) {
+      if (tasks[i] == task) {
+        return i;
+      }
+    }
+    return kTaskCount;
+  };
+
+  TaskControlBlock* current = nullptr;
+  uint64_t total_latency = 0;
+  uint64_t wakeups = 0;
+
+  for (uint64_t tick = 0; tick < kTotalTicks; ++tick) {
+    // 唤醒到期的交互式任务
+    for (size_t i = kCpuBound; i < kTaskCount; ++i) {
+      if (sleeping[i] && sleep_until[i] <= tick) {
+        sleeping[i] = false;
+        wake_tick[i] = tick;
+        scheduler.Enqueue(tasks[i]);
+      }
+    }
+
+    if (current == nullptr) {
+      current = scheduler.PickNext();
+      if (current == nullptr) {
+        continue;
+      }
+      current->sched_info.time_slice_remaining =
+          current->sched_info.time_slice_default;
+      scheduler.OnScheduled(current);
+      auto idx = index_of(current);
+      if (idx >= kCpuBound) {
+        total_latency += tick - wake_tick[idx];
+        wakeups++;
+      }
+    }
+
+    // 运行一个 tick
+    if (current->sched_info.time_slice_remaining > 0) {
+      current->sched_info.time_slice_remaining--;
+    }
+    bool need_preempt = scheduler.OnTick(current);
+    if (!need_preempt && current->sched_info.time_slice_remaining == 0) {
+      need_preempt = true;
+    }
+
+    auto idx = index_of(current);
+    if (idx >= kCpuBound) {
+      // 交互式任务运行 1 tick 后阻塞 (不重新入队)
+      sleeping[idx] = true;
+      sleep_until[idx] = tick + kSleepTicks;
+      current = nullptr;
+    } else if (need_preempt) {
+      scheduler.OnPreempted(current);
+      if (scheduler.OnTimeSliceExpired(current)) {
+        scheduler.Enqueue(current);
+      }
+      current = nullptr;
+    }
+  }
+
+  for (size_t i = 0; i < kTaskCount; ++i) {
+    scheduler.Dequeue(tasks[i]);
+    delete tasks[i];
+  }
+
+  return wakeups > 0 ? total_latency / wakeups : 0;
+}
+
+auto test_mlfq_mixed_workload_latency() -> bool {
+  sk_printf("Running test_mlfq_mixed_workload_latency...\n");
+
+  RoundRobinScheduler rr;
+  MlfqScheduler mlfq;
+
+  auto rr_latency = SimulateMixedWorkload(rr);
+  auto mlfq_latency = SimulateMixedWorkload(mlfq);
+
+  sk_printf("  interactive wakeup latency: RR=%lu ticks, MLFQ=%lu ticks\n",
+            static_cast<unsigned long>(rr_latency),
+            static_cast<unsigned long>(mlfq_latency));
+  sk_printf("  MLFQ demotions=%lu boosts=%lu\n",
+            static_cast<unsigned long>(mlfq.GetDemotions()),
+            static_cast<unsigned long>(mlfq.GetBoosts()));
+
+  EXPECT_LT(mlfq_latency, rr_latency,
+            "MLFQ should give interactive tasks lower latency than RR");
+  EXPECT_GT(mlfq.GetBoosts(), 0, "Boost should happen during simulation");
+
+  sk_printf("test_mlfq_mixed_workload_latency passed\n");
+  return true;
+}
+
+}  // namespace
+
+auto mlfq_scheduler_test() -> bool {
+  sk_printf("\n=== MLFQ Scheduler System Tests ===\n");
+
+  if (!test_mlfq_basic_functionality()) {
+    return false;
+  }
+
+  if (!test_mlfq_level_ordering()) {
+    return false;
+  }
+
+  if (!test_mlfq_demotion()) {
+    return false;
+  }
+
+  if (!test_mlfq_preemption()) {
+    return false;
+  }
+
+  if (!test_mlfq_boost()) {
+    return false;
+  }
+
+  if (!test_mlfq_dequeue_and_stats()) {
+    return false;
+  }
+
+  if (!test_mlfq_mixed_workload_latency()) {
+    return false;
+  }
+
+  sk_printf("=== All MLFQ Scheduler Tests Passed ===\n\n");
+  return true;
+}
@@ -0,0 +1,278 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "arch.h"
+#include "kstd_cstring"
+#include "sk_stdio.h"
+#include "sk_stdlib.h"
+#include "syscall.hpp"
+#include "syscall_ring.hpp"
+#include "system_test.h"
+#include "task_manager.hpp"
+#include "vdso.hpp"
+#include "virtual_memory.hpp"
+
+namespace {
+
+/// 基准测试的请求数
+constexpr uint32_t kBenchOps = 128;
+
+/**
+ * @brief 以用户态的方式访问共享区
+ */
+struct RingView {
+  SyscallRingHeader* header;
+  SyscallSqe* sq;
+  SyscallCqe* cq;
+
+  explicit RingView(const SyscallRingParams& params)
+      : header(reinterpret_cast<SyscallRingHeader*>(params.ring_addr)),
+        sq(reinterpret_cast<SyscallSqe*>(params.ring_addr +
+                                         header->sq_offset)),
+        cq(reinterpret_cast<SyscallCqe*>(params.ring_addr +
+                                         header->cq_offset)) {}
+
+  auto Submit(uint64_t opcode, uint64_t user_data, uint64_t arg0 = 0,
+              uint64_t arg1 = 0, uint64_t arg2 = 0) -> void {
+    auto tail = header->sq_tail.load(std::memory_order_relaxed);
+    auto& sqe = sq[tail & (header->sq_entries - 1)];
+    sqe = {.opcode = opcode,
+           .args = {arg0, arg1, arg2, 0, 0, 0},
+           .user_data = user_data};
+    header->sq_tail.store(tail + 1, std::memory_order_release);
+  }
+
+  auto Reap(SyscallCqe& cqe) -> bool {
+    auto head = header->cq_head.load(std::memory_order_relaxed);
+    if (head == header->cq_tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    cqe = cq[head & (header->cq_entries - 1)];
+    header->cq_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+};
+
+/**
+ * @brief 释放当前任务的系统调用环，以便后续测试重新创建
+ */
+auto ReleaseRing() -> void {
+  auto* current = TaskManagerSingleton::instance().GetCurrentTask();
+  delete current->syscall_ring;
+  current->syscall_ring = nullptr;
+}
+
+auto test_ring_batch() -> bool {
+  sk_printf("Running test_ring_batch...\n");
+
+  auto* current = TaskManagerSingleton::instance().GetCurrentTask();
+  SyscallRingParams params{};
+  EXPECT_EQ(sys_ring_setup(10, &params), 0, "Ring setup should succeed");
+  EXPECT_EQ(params.sq_entries, 16, "SQ entries should round up to 16");
+  EXPECT_EQ(params.cq_entries, 32, "CQ should be twice the SQ");
+  EXPECT_EQ(sys_ring_setup(10, &params), -1, "Second setup should fail");
+
+  RingView ring(params);
+  static const char kMessage[] = "ring write\n";
+  ring.Submit(kSyscallGettid, 1);
+  ring.Submit(kSyscallWrite, 2, 1, reinterpret_cast<uint64_t>(kMessage),
+              sizeof(kMessage) - 1);
+  ring.Submit(kSyscallWrite, 3, 99, reinterpret_cast<uint64_t>(kMessage),
+              sizeof(kMessage) - 1);
+
+  // 一次调用执行全部请求
+  EXPECT_EQ(sys_ring_enter(8, 3), 3, "All three entries should be consumed");
+
+  SyscallCqe cqe{};
+  EXPECT_TRUE(ring.Reap(cqe), "First completion");
+  EXPECT_EQ(cqe.user_data, 1, "Completions keep submission order");
+  EXPECT_EQ(cqe.result, static_cast<int64_t>(current->pid),
+            "gettid result should be the pid");
+  EXPECT_TRUE(ring.Reap(cqe), "Second completion");
+  EXPECT_EQ(cqe.user_data, 2, "Completions keep submission order");
+  EXPECT_EQ(cqe.result, static_cast<int64_t>(sizeof(kMessage) - 1),
+            "write should return length");
+  EXPECT_TRUE(ring.Reap(cqe), "Third completion");
+  EXPECT_EQ(cqe.user_data, 3, "Completions keep submission order");
+  EXPECT_EQ(cqe.result, -1, "write to invalid fd should fail");
+  EXPECT_FALSE(ring.Reap(cqe), "CQ should be empty");
+
+  ReleaseRing();
+  sk_printf("test_ring_batch passed\n");
+  return true;
+}
+
+auto test_ring_rejects() -> bool {
+  sk_printf("Running test_ring_rejects...\n");
+
+  EXPECT_EQ(sys_ring_enter(1, 0), -1, "Enter without ring should fail");
+
+  SyscallRingParams params{};
+  EXPECT_EQ(sys_ring_setup(4, &params), 0, "Ring setup should succeed");
+  RingView ring(params);
+
+  // 依赖陷入上下文的调用不能批量提交
+  ring.Submit(kSyscallExit, 7);
+  ring.Submit(kSyscallRingEnter, 8);
+  EXPECT_EQ(sys_ring_enter(2, 2), 2, "Entries should be consumed");
+  SyscallCqe cqe{};
+  EXPECT_TRUE(ring.Reap(cqe), "Exit completion");
+  EXPECT_EQ(cqe.result, -1, "exit should be rejected");
+  EXPECT_TRUE(ring.Reap(cqe), "Enter completion");
+  EXPECT_EQ(cqe.result, -1, "Nested enter should be rejected");
+
+  // 非法的 sq_tail 不会让内核越界读取
+  ring.header->sq_tail.store(ring.header->sq_head.load() + 1000);
+  EXPECT_EQ(sys_ring_enter(16, 0), 0, "Corrupted tail should be ignored");
+  ring.header->sq_tail.store(ring.header->sq_head.load());
+
+  // CQ 没有空位时停止取出提交表项
+  for (uint32_t i = 0; i < params.cq_entries; ++i) {
+    ring.Submit(kSyscallGettid, i);
+    if ((i + 1) % params.sq_entries == 0) {
+      EXPECT_EQ(sys_ring_enter(params.sq_entries, 0),
+                static_cast<int>(params.sq_entries), "Batch should fit");
+    }
+  }
+  ring.Submit(kSyscallGettid, 100);
+  EXPECT_EQ(sys_ring_enter(1, 0), 0, "Full CQ should stop submission");
+  EXPECT_TRUE(ring.Reap(cqe), "Reap one completion");
+  EXPECT_EQ(sys_ring_enter(1, 0), 1, "Freed slot should allow submission");
+
+  ReleaseRing();
+  sk_printf("test_ring_rejects passed\n");
+  return true;
+}
+
+auto test_ring_map_checks() -> bool {
+  sk_printf("Running test_ring_map_checks...\n");
+
+  constexpr auto kPageSize = cpu_io::virtual_memory::kPageSize;
+  constexpr uintptr_t kRingAddr = 0x10000000;
+  auto& vm = VirtualMemorySingleton::instance();
+  auto* page_table =
+      static_cast<uint64_t*>(aligned_alloc(kPageSize, kPageSize));
+  EXPECT_TRUE(page_table != nullptr, "Page table allocation");
+  kstd::memset(page_table, 0, kPageSize);
+
+  {
+    // 环析构时解除映射，必须先于页表销毁；共享区跨多个页
+    SyscallRing ring(SyscallRing::kMaxEntries);
+    EXPECT_TRUE(ring.IsValid(), "Ring allocation");
+
+    // 超出用户地址空间 (与 vvar 页重叠) 的地址被拒绝
+    auto result = ring.MapTo(page_table, kVvarUserAddr);
+    EXPECT_FALSE(result.has_value(), "Ring over vvar page should fail");
+    EXPECT_EQ(result.error().code, ErrorCode::kBadAddress,
+              "Out of range address should report kBadAddress");
+    result = ring.MapTo(page_table, kVvarUserAddr - ring.GetSize() +
+                                        kPageSize);
+    EXPECT_FALSE(result.has_value(), "Ring crossing vvar page should fail");
+
+    // 已有映射的地址被拒绝，原有映射保持不变
+    auto* busy =
+        reinterpret_cast<void*>(kRingAddr + ring.GetSize() - kPageSize);
+    auto* busy_phys = reinterpret_cast<void*>(0x91000000);
+    EXPECT_TRUE(vm.MapPage(page_table, busy, busy_phys,
+                           cpu_io::virtual_memory::GetUserPagePermissions())
+                    .has_value(),
+                "Map existing page");
+    result = ring.MapTo(page_table, kRingAddr);
+    EXPECT_FALSE(result.has_value(), "Ring over mapped page should fail");
+    EXPECT_EQ(result.error().code, ErrorCode::kVmPageAlreadyMapped,
+              "Mapped page should report kVmPageAlreadyMapped");
+    auto mapping = vm.GetMapping(page_table, busy);
+    EXPECT_TRUE(mapping.has_value() && *mapping == busy_phys,
+                "Existing mapping should be kept");
+    EXPECT_FALSE(
+        vm.GetMapping(page_table, reinterpret_cast<void*>(kRingAddr))
+            .has_value(),
+        "No partial mapping should be left");
+
+    (void)vm.UnmapPage(page_table, busy);
+    EXPECT_TRUE(ring.MapTo(page_table, kRingAddr).has_value(),
+                "Ring over free range should map");
+  }
+
+  EXPECT_FALSE(
+      vm.GetMapping(page_table, reinterpret_cast<void*>(kRingAddr))
+          .has_value(),
+      "Ring destructor should unmap");
+  vm.DestroyPageDirectory(page_table, false);
+  sk_printf("test_ring_map_checks passed\n");
+  return true;
+}
+
+auto test_ring_benchmark() -> bool {
+  sk_printf("Running test_ring_benchmark...\n");
+
+  // 测试在内核线程中直接调用入口函数，不经过陷入：只比较内核侧逐个分发与
+  // 批量执行的开销，陷入本身的开销不在测量范围内
+
+  // 逐个系统调用：每个请求一次分发
+  uint64_t args[6] = {};
+  auto start = ReadTimestamp();
+  for (uint32_t i = 0; i < kBenchOps; ++i) {
+    syscall_dispatcher(static_cast<int64_t>(kSyscallGettid), args);
+  }
+  auto single_cost = ReadTimestamp() - start;
+
+  // 系统调用环：全部请求一次提交
+  SyscallRingParams params{};
+  EXPECT_EQ(sys_ring_setup(kBenchOps, &params), 0,
+            "Ring setup should succeed");
+  RingView ring(params);
+  start = ReadTimestamp();
+  for (uint32_t i = 0; i < kBenchOps; ++i) {
+    ring.Submit(kSyscallGettid, i);
+  }
+  auto submitted = sys_ring_enter(kBenchOps, kBenchOps);
+  SyscallCqe cqe{};
+  uint32_t reaped = 0;
+  while (ring.Reap(cqe)) {
+    ++reaped;
+  }
+  auto ring_cost = ReadTimestamp() - start;
+
+  EXPECT_EQ(submitted, static_cast<int>(kBenchOps), "All entries submitted");
+  EXPECT_EQ(reaped, kBenchOps, "All completions reaped");
+
+  sk_printf(
+      "syscall ring benchmark (%u x gettid, no traps measured): "
+      "dispatch %lu ticks, ring %lu ticks\n",
+      kBenchOps, static_cast<unsigned long>(single_cost),
+      static_cast<unsigned long>(ring_cost));
+
+  ReleaseRing();
+  sk_printf("test_ring_benchmark passed\n");
+  return true;
+}
+
+}  // namespace
+
+auto syscall_ring_test() -> bool {
+  sk_printf("\n=== Syscall Ring System Tests ===\n");
+
+  if (!test_ring_batch()) {
+    return false;
+  }
+
+  if (!test_ring_rejects()) {
+    return false;
+  }
+
+  if (!test_ring_map_checks()) {
+    return false;
+  }
+
+  if (!test_ring_benchmark()) {
+    return false;
+  }
+
+  sk_printf("=== All Syscall Ring Tests Passed ===\n\n");
+  return true;
+}
@@ -144,16 +144,26 @@ auto fifo_scheduler_test() -> bool;
 auto rr_scheduler_test() -> bool;
 auto cfs_scheduler_test() -> bool;
 auto idle_scheduler_test() -> bool;
+auto mlfq_scheduler_test() -> bool;
+auto deadline_scheduler_test() -> bool;
+auto affinity_test() -> bool;
+auto fpu_test() -> bool;
+auto syscall_ring_test() -> bool;
+auto vdso_test() -> bool;
+auto user_access_test() -> bool;
 auto thread_group_system_test() -> bool;
 auto wait_system_test() -> bool;
 auto clone_system_test() -> bool;
 auto exit_system_test() -> bool;
 auto ramfs_system_test() -> bool;
+auto file_syscall_test() -> bool;
 auto fatfs_system_test() -> bool;
+auto virtio_net_test() -> bool;
 auto memory_test() -> bool;
 auto kernel_task_test() -> bool;
 auto user_task_test() -> bool;
 
 auto mutex_test() -> bool;
+auto completion_test() -> bool;
 
 #endif /* SIMPLEKERNEL_TESTS_SYSTEM_TEST_SYSTEM_TEST_H_ */
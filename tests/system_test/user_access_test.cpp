@@ -0,0 +1,234 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "user_access.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "arch.h"
+#include "kstd_cstring"
+#include "sk_stdio.h"
+#include "sk_stdlib.h"
+#include "syscall.hpp"
+#include "system_test.h"
+#include "task_manager.hpp"
+#include "virtual_memory.hpp"
+
+namespace {
+
+/// 测试缓冲区大小
+constexpr size_t kBufferSize = 300;
+
+/// 基准测试的输出长度
+constexpr size_t kBenchBytes = 256;
+
+/// 内核页表中未映射的地址
+const auto* const kUnmappedAddr = reinterpret_cast<const char*>(0x3FFFF00000);
+
+auto test_copy_round_trip() -> bool {
+  sk_printf("Running test_copy_round_trip...\n");
+
+  uint8_t src[kBufferSize];
+  uint8_t dst[kBufferSize + 8];
+  for (size_t i = 0; i < kBufferSize; ++i) {
+    src[i] = static_cast<uint8_t>(i * 7 + 1);
+  }
+
+  // 对齐与不对齐的地址分别走按字与按字节的路径
+  for (size_t offset : {0UL, 3UL}) {
+    kstd::memset(dst, 0, sizeof(dst));
+    EXPECT_TRUE(CopyFromUser(dst + offset, src, kBufferSize).has_value(),
+                "CopyFromUser should succeed");
+    EXPECT_EQ(kstd::memcmp(dst + offset, src, kBufferSize), 0,
+              "CopyFromUser should copy every byte");
+
+    kstd::memset(dst, 0, sizeof(dst));
+    EXPECT_TRUE(CopyToUser(dst + offset, src, kBufferSize).has_value(),
+                "CopyToUser should succeed");
+    EXPECT_EQ(kstd::memcmp(dst + offset, src, kBufferSize), 0,
+              "CopyToUser should copy every byte");
+  }
+
+  EXPECT_TRUE(CopyFromUser(dst, src, 0).has_value(),
+              "Zero length copy should succeed");
+  EXPECT_FALSE(CopyFromUser(dst, nullptr, 4).has_value(),
+               "Null source should fail");
+
+  sk_printf("test_copy_round_trip passed\n");
+  return true;
+}
+
+auto test_strncpy_from_user() -> bool {
+  sk_printf("Running test_strncpy_from_user...\n");
+
+  static const char kString[] = "simple kernel";
+  char dst[32];
+
+  auto result = StrnCpyFromUser(dst, kString, sizeof(dst));
+  EXPECT_TRUE(result.has_value(), "StrnCpyFromUser should succeed");
+  EXPECT_EQ(*result, sizeof(kString) - 1, "Length should exclude NUL");
+  EXPECT_EQ(kstd::strcmp(dst, kString), 0, "String should be copied");
+
+  // 缓冲区放不下时返回错误，结果仍以 '\0' 结尾
+  result = StrnCpyFromUser(dst, kString, 4);
+  EXPECT_FALSE(result.has_value(), "Too long string should fail");
+  EXPECT_EQ(kstd::strlen(dst), 3, "Truncated result should end with NUL");
+
+  sk_printf("test_strncpy_from_user passed\n");
+  return true;
+}
+
+auto test_copy_fault() -> bool {
+  sk_printf("Running test_copy_fault...\n");
+
+#if defined(__riscv) || defined(__aarch64__)
+  // 缺页经修复表返回错误，而不是进入缺页处理的死循环
+  char dst[16];
+  auto result = CopyFromUser(dst, kUnmappedAddr, sizeof(dst));
+  EXPECT_FALSE(result.has_value(), "Copy from unmapped memory should fail");
+  EXPECT_EQ(result.error().code, ErrorCode::kBadAddress,
+            "Fault should report kBadAddress");
+  EXPECT_FALSE(CopyToUser(const_cast<char*>(kUnmappedAddr), dst, sizeof(dst))
+                   .has_value(),
+               "Copy to unmapped memory should fail");
+  EXPECT_FALSE(StrnCpyFromUser(dst, kUnmappedAddr, sizeof(dst)).has_value(),
+               "String copy from unmapped memory should fail");
+  EXPECT_EQ(sys_write(1, kUnmappedAddr, 8), -1,
+            "sys_write with unmapped buffer should fail");
+#else
+  (void)kUnmappedAddr;
+  sk_printf("test_copy_fault skipped: no page fault fixup on this arch\n");
+#endif
+
+  sk_printf("test_copy_fault passed\n");
+  return true;
+}
+
+auto test_user_range_check() -> bool {
+  sk_printf("Running test_user_range_check...\n");
+
+  constexpr auto kPageSize = cpu_io::virtual_memory::kPageSize;
+  auto& vm = VirtualMemorySingleton::instance();
+  auto* current = TaskManagerSingleton::instance().GetCurrentTask();
+  EXPECT_TRUE(current != nullptr && current->page_table == nullptr,
+              "Test should run in a kernel thread");
+
+  auto* page_table =
+      static_cast<uint64_t*>(aligned_alloc(kPageSize, kPageSize));
+  auto* page = static_cast<uint8_t*>(aligned_alloc(kPageSize, kPageSize));
+  EXPECT_TRUE(page_table != nullptr && page != nullptr, "Allocation");
+  kstd::memset(page_table, 0, kPageSize);
+  kstd::memset(page, 0x5A, kPageSize);
+
+  // 假装当前任务是用户任务：内核恒等映射下，用户页表中同地址的映射
+  // 与实际访问的是同一物理页
+  current->page_table = page_table;
+  uint8_t buf[16] = {};
+  auto result = CopyFromUser(buf, page, sizeof(buf));
+  EXPECT_FALSE(result.has_value(),
+               "Address not mapped for the user task should fail");
+  EXPECT_EQ(result.error().code, ErrorCode::kBadAddress,
+            "Unmapped user address should report kBadAddress");
+  EXPECT_FALSE(CopyFromUser(buf, buf + 1, 4).has_value(),
+               "Kernel stack should not be reachable as user memory");
+
+  (void)vm.MapPage(page_table, page, page,
+                   cpu_io::virtual_memory::GetUserPagePermissions(true, false,
+                                                                  false));
+  EXPECT_TRUE(CopyFromUser(buf, page, sizeof(buf)).has_value(),
+              "User readable page should be readable");
+  EXPECT_EQ(buf[0], 0x5A, "Copied data");
+  EXPECT_FALSE(CopyToUser(page, buf, sizeof(buf)).has_value(),
+               "Read-only user page should not be writable");
+  EXPECT_FALSE(CopyFromUser(buf, page + kPageSize - 8, sizeof(buf))
+                   .has_value(),
+               "Range running into an unmapped page should fail");
+  char str[8];
+  kstd::memcpy(page + kPageSize - 4, "abc", 4);
+  auto len = StrnCpyFromUser(str, reinterpret_cast<char*>(page) +
+                                      kPageSize - 4, sizeof(str));
+  EXPECT_TRUE(len.has_value() && *len == 3,
+              "String ending before an unmapped page should be copied");
+
+  (void)vm.UnmapPage(page_table, page);
+  (void)vm.MapPage(page_table, page, page,
+                   cpu_io::virtual_memory::GetUserPagePermissions(true, true,
+                                                                  false));
+  EXPECT_TRUE(CopyToUser(page, buf, sizeof(buf)).has_value(),
+              "Writable user page should be writable");
+  current->page_table = nullptr;
+
+  (void)vm.UnmapPage(page_table, page);
+  vm.DestroyPageDirectory(page_table, false);
+  aligned_free(page);
+  sk_printf("test_user_range_check passed\n");
+  return true;
+}
+
+auto test_sys_write() -> bool {
+  sk_printf("Running test_sys_write...\n");
+
+  static const char kMessage[] = "sys_write whole buffer\n";
+  EXPECT_EQ(sys_write(1, kMessage, sizeof(kMessage) - 1),
+            static_cast<int>(sizeof(kMessage) - 1),
+            "sys_write should return length");
+  EXPECT_EQ(sys_write(1, nullptr, 4), -1, "Null buffer should fail");
+  EXPECT_EQ(sys_write(5, kMessage, 4), -1, "Unsupported fd should fail");
+
+  // 逐字符输出与整块输出的耗时对比
+  char line[kBenchBytes];
+  kstd::memset(line, '-', sizeof(line));
+  line[kBenchBytes - 1] = '\n';
+
+  auto start = ReadTimestamp();
+  for (size_t i = 0; i < kBenchBytes; ++i) {
+    etl_putchar(line[i]);
+  }
+  auto putchar_cost = ReadTimestamp() - start;
+
+  start = ReadTimestamp();
+  EXPECT_EQ(sys_write(1, line, kBenchBytes), static_cast<int>(kBenchBytes),
+            "sys_write should write the whole line");
+  auto write_cost = ReadTimestamp() - start;
+
+  sk_printf("sys_write benchmark (%lu bytes): putchar %lu ticks, "
+            "sys_write %lu ticks\n",
+            static_cast<unsigned long>(kBenchBytes),
+            static_cast<unsigned long>(putchar_cost),
+            static_cast<unsigned long>(write_cost));
+
+  sk_printf("test_sys_write passed\n");
+  return true;
+}
+
+}  // namespace
+
+auto user_access_test() -> bool {
+  sk_printf("\n=== User Access System Tests ===\n");
+
+  if (!test_copy_round_trip()) {
+    return false;
+  }
+
+  if (!test_strncpy_from_user()) {
+    return false;
+  }
+
+  if (!test_copy_fault()) {
+    return false;
+  }
+
+  if (!test_user_range_check()) {
+    return false;
+  }
+
+  if (!test_sys_write()) {
+    return false;
+  }
+
+  sk_printf("=== All User Access Tests Passed ===\n\n");
+  return true;
+}
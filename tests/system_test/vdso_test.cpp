@@ -0,0 +1,165 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include <cpu_io.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "arch.h"
+#include "kstd_cstring"
+#include "sk_stdio.h"
+#include "sk_stdlib.h"
+#include "syscall.hpp"
+#include "system_test.h"
+#include "task_manager.hpp"
+#include "vdso.hpp"
+#include "virtual_memory.hpp"
+
+namespace {
+
+/// 基准测试的读取次数
+constexpr uint32_t kBenchOps = 128;
+
+/// 时钟测试的睡眠时间 (毫秒)
+constexpr uint64_t kSleepMs = 50;
+
+auto test_vdso_identity() -> bool {
+  sk_printf("Running test_vdso_identity...\n");
+
+  auto& task_manager = TaskManagerSingleton::instance();
+  const auto* data = task_manager.GetVdso().GetData();
+  EXPECT_TRUE(data != nullptr, "vvar page should be allocated");
+
+  auto core_id = cpu_io::GetCurrentCoreId();
+  auto* current = task_manager.GetCurrentTask();
+  EXPECT_GT(data->core_count, 0, "At least one core should be registered");
+  EXPECT_EQ(data->cores[core_id].core_id, core_id,
+            "Core entry should hold its core id");
+
+  uint64_t tid = 0;
+  uint64_t tgid = 0;
+  Vdso::ReadCore(*data, core_id, tid, tgid);
+  EXPECT_EQ(tid, current->pid, "vvar tid should match current task");
+  EXPECT_EQ(tgid, current->tgid, "vvar tgid should match current task");
+
+  sk_printf("test_vdso_identity passed\n");
+  return true;
+}
+
+auto test_vdso_clock() -> bool {
+  sk_printf("Running test_vdso_clock...\n");
+
+  auto& task_manager = TaskManagerSingleton::instance();
+  const auto* data = task_manager.GetVdso().GetData();
+  EXPECT_TRUE(data != nullptr, "vvar page should be allocated");
+
+  auto start = Vdso::ReadClockNs(*data, ReadTimestamp);
+  task_manager.Sleep(kSleepMs);
+  auto end = Vdso::ReadClockNs(*data, ReadTimestamp);
+  EXPECT_GT(end, start, "Monotonic clock should advance");
+
+  // 睡眠至少 kSleepMs 毫秒，允许一个 tick 的误差
+  auto elapsed_ms = (end - start) / 1000000;
+  EXPECT_GE(elapsed_ms + 1000 / SIMPLEKERNEL_TICK, kSleepMs,
+            "Clock should cover the sleep duration");
+
+  sk_printf("vdso clock: slept %lu ms, measured %lu ms (counter %lu Hz)\n",
+            static_cast<unsigned long>(kSleepMs),
+            static_cast<unsigned long>(elapsed_ms),
+            static_cast<unsigned long>(data->counter_freq));
+
+  sk_printf("test_vdso_clock passed\n");
+  return true;
+}
+
+auto test_vdso_mapping() -> bool {
+  sk_printf("Running test_vdso_mapping...\n");
+
+  auto& vm = VirtualMemorySingleton::instance();
+  const auto& vdso = TaskManagerSingleton::instance().GetVdso();
+
+  auto* page_dir = static_cast<uint64_t*>(aligned_alloc(
+      cpu_io::virtual_memory::kPageSize, cpu_io::virtual_memory::kPageSize));
+  EXPECT_TRUE(page_dir != nullptr, "Page directory allocation failed");
+  kstd::memset(page_dir, 0, cpu_io::virtual_memory::kPageSize);
+
+  EXPECT_TRUE(vdso.MapTo(page_dir).has_value(), "vvar map should succeed");
+  auto* vvar_addr = reinterpret_cast<void*>(kVvarUserAddr);
+  auto mapping = vm.GetMapping(page_dir, vvar_addr);
+  EXPECT_TRUE(mapping.has_value(), "vvar page should be mapped");
+  EXPECT_EQ(*mapping, static_cast<const void*>(vdso.GetData()),
+            "vvar mapping should point to the shared page");
+
+  // 销毁页表时不能释放共享的 vvar 页
+  Vdso::UnmapFrom(page_dir);
+  mapping = vm.GetMapping(page_dir, vvar_addr);
+  EXPECT_FALSE(mapping.has_value(), "vvar page should be unmapped");
+  vm.DestroyPageDirectory(page_dir, false);
+
+  sk_printf("test_vdso_mapping passed\n");
+  return true;
+}
+
+auto test_vdso_benchmark() -> bool {
+  sk_printf("Running test_vdso_benchmark...\n");
+
+  const auto* data = TaskManagerSingleton::instance().GetVdso().GetData();
+  EXPECT_TRUE(data != nullptr, "vvar page should be allocated");
+
+  // 系统调用：每次读取一次分发 (用户态时每次读取一次陷入)
+  uint64_t args[6] = {};
+  int syscall_tid = 0;
+  auto start = ReadTimestamp();
+  for (uint32_t i = 0; i < kBenchOps; ++i) {
+    syscall_tid =
+        syscall_dispatcher(static_cast<int64_t>(kSyscallGettid), args);
+  }
+  auto syscall_cost = ReadTimestamp() - start;
+
+  // vvar 页：直接读取共享内存
+  uint64_t tid = 0;
+  uint64_t tgid = 0;
+  auto core_id = cpu_io::GetCurrentCoreId();
+  start = ReadTimestamp();
+  for (uint32_t i = 0; i < kBenchOps; ++i) {
+    Vdso::ReadCore(*data, core_id, tid, tgid);
+  }
+  auto vdso_cost = ReadTimestamp() - start;
+
+  EXPECT_EQ(tid, static_cast<uint64_t>(syscall_tid),
+            "vvar tid should match gettid");
+
+  sk_printf("vdso benchmark (%u x gettid): syscall %lu ticks, vvar %lu ticks\n",
+            kBenchOps, static_cast<unsigned long>(syscall_cost),
+            static_cast<unsigned long>(vdso_cost));
+
+  sk_printf("test_vdso_benchmark passed\n");
+  return true;
+}
+
+}  // namespace
+
+auto vdso_test() -> bool {
+  sk_printf("\n=== vDSO System Tests ===\n");
+
+  if (!test_vdso_identity()) {
+    return false;
+  }
+
+  if (!test_vdso_clock()) {
+    return false;
+  }
+
+  if (!test_vdso_mapping()) {
+    return false;
+  }
+
+  if (!test_vdso_benchmark()) {
+    return false;
+  }
+
+  sk_printf("=== All vDSO Tests Passed ===\n\n");
+  return true;
+}
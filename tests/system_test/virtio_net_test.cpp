@@ -0,0 +1,236 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "arch.h"
+#include "io_buffer.hpp"
+#include "kstd_cstdio"
+#include "kstd_cstring"
+#include "system_test.h"
+#include "task_manager.hpp"
+#include "vdso.hpp"
+#include "virtio/virtio_driver.hpp"
+
+namespace {
+
+using NetDevice = VirtioDriver::NetDevice;
+
+/// 每轮在途的 ARP 请求数
+constexpr size_t kBatch = 32;
+
+/// 轮数
+constexpr size_t kRounds = 64;
+
+/// 每轮等待应答的超时时间 (纳秒)
+constexpr uint64_t kRoundTimeoutNs = 1000000000;
+
+/// ARP 请求帧长度（以太网最短帧，不含 FCS）
+constexpr size_t kFrameSize = 60;
+
+/// QEMU user 网络中客户机与网关的 IPv4 地址
+constexpr std::array<uint8_t, 4> kGuestIp = {10, 0, 2, 15};
+constexpr std::array<uint8_t, 4> kGatewayIp = {10, 0, 2, 2};
+
+/// 以太网与 ARP 字段偏移
+constexpr size_t kEthDst = 0;
+constexpr size_t kEthSrc = 6;
+constexpr size_t kEthType = 12;
+constexpr size_t kArpOp = 20;
+constexpr size_t kArpSha = 22;
+constexpr size_t kArpSpa = 28;
+constexpr size_t kArpTha = 32;
+constexpr size_t kArpTpa = 38;
+constexpr size_t kArpSize = 42;
+
+/**
+ * @brief 构造查询网关 MAC 地址的 ARP 请求
+ */
+auto BuildArpRequest(uint8_t* frame, const std::array<uint8_t, 6>& mac)
+    -> void {
+  static constexpr uint8_t kArpHeader[] = {
+      0x08, 0x06,  // EtherType: ARP
+      0x00, 0x01,  // 硬件类型: 以太网
+      0x08, 0x00,  // 协议类型: IPv4
+      6,    4,     // 硬件/协议地址长度
+      0x00, 0x01,  // 操作: 请求
+  };
+  kstd::memset(frame, 0, kFrameSize);
+  kstd::memset(frame + kEthDst, 0xFF, mac.size());
+  kstd::memcpy(frame + kEthSrc, mac.data(), mac.size());
+  kstd::memcpy(frame + kEthType, kArpHeader, sizeof(kArpHeader));
+  kstd::memcpy(frame + kArpSha, mac.data(), mac.size());
+  kstd::memcpy(frame + kArpSpa, kGuestIp.data(), kGuestIp.size());
+  kstd::memcpy(frame + kArpTpa, kGatewayIp.data(), kGatewayIp.size());
+}
+
+/**
+ * @brief 是否为网关发给本机的 ARP 应答
+ */
+auto IsArpReplyFromGateway(const virtio::net::RxPacket& packet,
+                           const std::array<uint8_t, 6>& mac) -> bool {
+  if (packet.segment_count == 0 || packet.segments[0].len < kArpSize) {
+    return false;
+  }
+  const uint8_t* frame = packet.segments[0].data;
+  return kstd::memcmp(frame + kEthDst, mac.data(), mac.size()) == 0 &&
+         frame[kEthType] == 0x08 && frame[kEthType + 1] == 0x06 &&
+         frame[kArpOp] == 0x00 && frame[kArpOp + 1] == 0x02 &&
+         kstd::memcmp(frame + kArpSpa, kGatewayIp.data(), kGatewayIp.size()) ==
+             0 &&
+         kstd::memcmp(frame + kArpTha, mac.data(), mac.size()) == 0 &&
+         kstd::memcmp(frame + kArpTpa, kGuestIp.data(), kGuestIp.size()) == 0;
+}
+
+/// 接收轮询任务交来的报文统计
+struct RxContext {
+  std::array<uint8_t, 6> mac{};
+  std::atomic<size_t> replies{0};
+};
+
+/**
+ * @brief 接收回调：统计网关的 ARP 应答
+ */
+auto CountArpReply(size_t /*index*/, const virtio::net::RxPacket& packet,
+                   void* arg) -> void {
+  auto* context = static_cast<RxContext*>(arg);
+  if (IsArpReplyFromGateway(packet, context->mac)) {
+    context->replies.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace
+
+auto virtio_net_test() -> bool {
+  sk_printf("virtio_net_test: start\n");
+
+  auto& driver = VirtioDriverSingleton::instance();
+  NetDevice* net = driver.GetNetDevice();
+  if (net == nullptr) {
+    sk_printf(
+        "virtio_net_test: SKIP \xe2\x80\x94 no virtio-net device "
+        "available\n");
+    return true;  // Graceful skip, not a failure
+  }
+
+  // T1: 配置空间与特性协商
+  auto config = net->ReadConfig();
+  EXPECT_TRUE(net->HasFeature(virtio::net::NetFeatureBit::kMac),
+              "virtio_net_test: VIRTIO_NET_F_MAC not negotiated");
+  EXPECT_TRUE(net->IsLinkUp(), "virtio_net_test: link is down");
+  sk_printf(
+      "virtio_net_test: mac %02x:%02x:%02x:%02x:%02x:%02x, csum %d/%d, "
+      "tso %d/%d, mrg_rxbuf %d\n",
+      config.mac[0], config.mac[1], config.mac[2], config.mac[3],
+      config.mac[4], config.mac[5],
+      net->HasFeature(virtio::net::NetFeatureBit::kCsum),
+      net->HasFeature(virtio::net::NetFeatureBit::kGuestCsum),
+      net->HasFeature(virtio::net::NetFeatureBit::kHostTso4),
+      net->HasFeature(virtio::net::NetFeatureBit::kGuestTso4),
+      net->HasFeature(virtio::net::NetFeatureBit::kMrgRxbuf));
+
+  // 未协商的卸载请求应被拒绝，而不是交给设备
+  if (!net->HasFeature(virtio::net::NetFeatureBit::kHostTso4)) {
+    virtio::net::NetHdr tso{};
+    tso.flags = std::to_underlying(virtio::net::NetHdrFlags::kNeedsCsum);
+    tso.gso_type = std::to_underlying(virtio::net::NetGsoType::kTcpv4);
+    tso.gso_size = 1448;
+    tso.hdr_len = 54;
+    tso.csum_start = 34;
+    tso.csum_offset = 16;
+    virtio::IoVec dummy{0, kFrameSize};
+    bool rejected = false;
+    driver.WithNetDevice(0, [&](NetDevice& dev) {
+      auto result = dev.Transmit(&dummy, 1, &tso);
+      rejected = !result && result.error().code == ErrorCode::kNotSupported;
+    });
+    EXPECT_TRUE(rejected, "virtio_net_test: TSO without HOST_TSO4 accepted");
+  }
+
+  // T2: ARP 往返——QEMU user 网络的网关 10.0.2.2 应答每个请求
+  IoBuffer frame_buffer(kFrameSize);
+  EXPECT_TRUE(frame_buffer.IsValid(),
+              "virtio_net_test: frame buffer allocation failed");
+  auto frame_dma = frame_buffer.ToDmaRegion();
+  BuildArpRequest(frame_dma.Data(), config.mac);
+  // 同一个帧可以同时在途多次，设备只读
+  virtio::IoVec frame_iov{frame_dma.phys, kFrameSize};
+
+  const auto* vdso_data = TaskManagerSingleton::instance().GetVdso().GetData();
+  EXPECT_TRUE(vdso_data != nullptr, "virtio_net_test: vvar page missing");
+
+  // 应答由接收轮询任务交给回调：中断唤醒任务，未接入中断时任务定期轮询
+  static RxContext rx_context;
+  rx_context.mac = config.mac;
+  rx_context.replies.store(0, std::memory_order_relaxed);
+  driver.SetNetRxHandler(CountArpReply, &rx_context);
+  EXPECT_TRUE(driver.StartNetPoll().has_value(),
+              "virtio_net_test: failed to start the rx poll task");
+  auto& task_manager = TaskManagerSingleton::instance();
+
+  size_t sent = 0;
+  size_t tx_full = 0;
+
+  auto start = Vdso::ReadClockNs(*vdso_data, ReadTimestamp);
+  for (size_t round = 0; round < kRounds; ++round) {
+    driver.WithNetDevice(0, [&](NetDevice& dev) {
+      dev.ReclaimTx();
+      for (size_t i = 0; i < kBatch; ++i) {
+        if (dev.Transmit(&frame_iov, 1)) {
+          ++sent;
+        } else {
+          ++tx_full;
+        }
+      }
+      // 一批只通知设备一次
+      dev.FlushTx();
+    });
+
+    // 让出 CPU，等待接收轮询任务处理应答
+    auto deadline =
+        Vdso::ReadClockNs(*vdso_data, ReadTimestamp) + kRoundTimeoutNs;
+    while (rx_context.replies.load(std::memory_order_relaxed) < sent &&
+           Vdso::ReadClockNs(*vdso_data, ReadTimestamp) < deadline) {
+      task_manager.Schedule();
+    }
+  }
+  auto elapsed_ns = Vdso::ReadClockNs(*vdso_data, ReadTimestamp) - start;
+  size_t replies = rx_context.replies.load(std::memory_order_relaxed);
+  driver.SetNetRxHandler(nullptr, nullptr);
+
+  driver.WithNetDevice(0, [](NetDevice& dev) { dev.ReclaimTx(); });
+  auto stats = net->GetStats();
+
+  EXPECT_EQ(tx_full, 0UL, "virtio_net_test: tx ring unexpectedly full");
+  EXPECT_EQ(sent, kBatch * kRounds, "virtio_net_test: not all frames queued");
+  EXPECT_EQ(replies, sent, "virtio_net_test: missing ARP replies");
+  EXPECT_EQ(stats.tx_packets, sent,
+            "virtio_net_test: not all transmitted frames reclaimed");
+  EXPECT_EQ(stats.rx_dropped, 0UL, "virtio_net_test: rx packets dropped");
+  EXPECT_GT(stats.rx_polls, 0UL, "virtio_net_test: rx poll task never ran");
+  EXPECT_GT(elapsed_ns, 0UL, "virtio_net_test: clock did not advance");
+
+  uint64_t pps = replies * 1000000000ULL / elapsed_ns;
+  sk_printf(
+      "virtio_net_test: %lu round trips in %lu us, %lu pps "
+      "(%lu packets/s through the device)\n",
+      static_cast<unsigned long>(replies),
+      static_cast<unsigned long>(elapsed_ns / 1000),
+      static_cast<unsigned long>(pps), static_cast<unsigned long>(pps * 2));
+  sk_printf(
+      "virtio_net_test: interrupts %lu, rx polls %lu, rearms %lu "
+      "(races %lu), kicks elided %lu\n",
+      static_cast<unsigned long>(stats.interrupts_handled),
+      static_cast<unsigned long>(stats.rx_polls),
+      static_cast<unsigned long>(stats.rx_rearms),
+      static_cast<unsigned long>(stats.rx_rearm_races),
+      static_cast<unsigned long>(stats.kicks_elided));
+
+  sk_printf("virtio_net_test: PASS\n");
+  return true;
+}
@@ -0,0 +1,282 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ * @brief 块请求队列单元测试
+ */
+
+#include "block_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "test_environment_state.hpp"
+
+using namespace vfs;
+
+namespace {
+
+// 异步内存块设备：派发单元留在 queued 中，由测试决定何时完成
+class AsyncMemDevice : public BlockDevice {
+ public:
+  static constexpr uint32_t kSectorSize = 512;
+  static constexpr uint64_t kSectorCount = 4096;
+
+  std::vector<uint8_t> storage =
+      std::vector<uint8_t>(kSectorSize * kSectorCount);
+  std::vector<BlockRequest*> queued;
+  uint32_t depth = 64;
+  uint32_t hw_queues = 1;
+  /// 设备资源，每个派发单元占用一个
+  uint32_t free_slots = 64;
+  size_t kicks = 0;
+
+  auto ReadSectors(uint64_t sector_start, uint32_t sector_count, void* buffer)
+      -> Expected<size_t> override {
+    memcpy(buffer, storage.data() + sector_start * kSectorSize,
+           sector_count * kSectorSize);
+    return static_cast<size_t>(sector_count) * kSectorSize;
+  }
+
+  auto WriteSectors(uint64_t sector_start, uint32_t sector_count,
+                    const void* buffer) -> Expected<size_t> override {
+    memcpy(storage.data() + sector_start * kSectorSize, buffer,
+           sector_count * kSectorSize);
+    return static_cast<size_t>(sector_count) * kSectorSize;
+  }
+
+  [[nodiscard]] auto GetSectorSize() const -> uint32_t override {
+    return kSectorSize;
+  }
+  [[nodiscard]] auto GetSectorCount() const -> uint64_t override {
+    return kSectorCount;
+  }
+  [[nodiscard]] auto GetName() const -> const char* override {
+    return "asyncmem";
+  }
+  [[nodiscard]] auto GetQueueDepth() const -> uint32_t override {
+    return depth;
+  }
+  [[nodiscard]] auto GetHwQueueCount() const -> uint32_t override {
+    return hw_queues;
+  }
+
+  auto QueueRequest(BlockRequest* request) -> Expected<void> override {
+    if (free_slots == 0) {
+      return std::unexpected(Error(ErrorCode::kNoFreeDescriptors));
+    }
+    --free_slots;
+    queued.push_back(request);
+    return {};
+  }
+
+  auto CommitRequests() -> void override { ++kicks; }
+
+  auto PollRequests() -> void override {
+    while (!queued.empty()) {
+      CompleteOldest();
+    }
+  }
+
+  // 执行最早派发的单元并结束它
+  auto CompleteOldest() -> void {
+    BlockRequest* unit = queued.front();
+    queued.erase(queued.begin());
+    ++free_slots;
+    uint64_t sector = unit->sector;
+    for (BlockRequest* r = unit; r != nullptr; r = r->merge_next) {
+      if (r->op == BlockOp::kRead) {
+        (void)ReadSectors(sector, r->sector_count, r->buffer);
+      } else {
+        (void)WriteSectors(sector, r->sector_count, r->buffer);
+      }
+      sector += r->sector_count;
+    }
+    EndRequest(unit, ErrorCode::kSuccess);
+  }
+};
+
+auto CountEndIo(BlockRequest* request) -> void {
+  ++*static_cast<int*>(request->private_data);
+}
+
+}  // namespace
+
+class BlockQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    env_state_.InitializeCores(2);
+    env_state_.SetCurrentThreadEnvironment();
+    env_state_.BindThreadToCore(std::this_thread::get_id(), 0);
+  }
+
+  void TearDown() override { env_state_.ClearCurrentThreadEnvironment(); }
+
+  test_env::TestEnvironmentState env_state_;
+  AsyncMemDevice device_;
+};
+
+// Plug 期间提交的相邻请求合并为一个派发单元，设备只被通知一次
+TEST_F(BlockQueueTest, PluggedAdjacentRequestsMerge) {
+  BlockQueue queue(&device_);
+  constexpr int kRequests = 8;
+  std::vector<uint8_t> data(kRequests * AsyncMemDevice::kSectorSize);
+  std::vector<BlockRequest> requests(kRequests);
+  int completed = 0;
+  {
+    BlockPlug plug(&queue);
+    // 乱序提交，覆盖前向与后向合并
+    for (int i : {3, 4, 2, 7, 0, 1, 6, 5}) {
+      memset(data.data() + i * AsyncMemDevice::kSectorSize, i + 1,
+             AsyncMemDevice::kSectorSize);
+      requests[i] = BlockRequest{
+          .op = BlockOp::kWrite,
+          .sector = 10 + static_cast<uint64_t>(i),
+          .sector_count = 1,
+          .buffer = data.data() + i * AsyncMemDevice::kSectorSize,
+          .end_io = CountEndIo,
+          .private_data = &completed,
+      };
+      ASSERT_TRUE(queue.Submit(&requests[i]).has_value());
+    }
+    EXPECT_TRUE(device_.queued.empty());
+  }
+
+  ASSERT_EQ(device_.queued.size(), 1);
+  EXPECT_EQ(device_.kicks, 1);
+  EXPECT_EQ(device_.queued.front()->sector, 10);
+  EXPECT_EQ(device_.queued.front()->merged_sectors, kRequests);
+  EXPECT_EQ(queue.GetStats().merged, kRequests - 1);
+
+  device_.PollRequests();
+  EXPECT_EQ(completed, kRequests);
+  for (int i = 0; i < kRequests; ++i) {
+    EXPECT_EQ(device_.storage[(10 + i) * AsyncMemDevice::kSectorSize], i + 1);
+  }
+}
+
+// 在途单元数不超过设备的队列深度，完成后继续派发
+TEST_F(BlockQueueTest, DispatchRespectsQueueDepth) {
+  device_.depth = 4;
+  BlockQueue queue(&device_);
+  constexpr int kRequests = 6;
+  std::vector<uint8_t> data(AsyncMemDevice::kSectorSize);
+  std::vector<BlockRequest> requests(kRequests);
+  int completed = 0;
+  for (int i = 0; i < kRequests; ++i) {
+    requests[i] = BlockRequest{
+        .op = BlockOp::kRead,
+        .sector = static_cast<uint64_t>(i) * 10,
+        .sector_count = 1,
+        .buffer = data.data(),
+        .end_io = CountEndIo,
+        .private_data = &completed,
+    };
+    ASSERT_TRUE(queue.Submit(&requests[i]).has_value());
+  }
+  EXPECT_EQ(device_.queued.size(), 4);
+
+  device_.CompleteOldest();
+  EXPECT_EQ(completed, 1);
+  EXPECT_EQ(device_.queued.size(), 4);
+
+  device_.PollRequests();
+  EXPECT_EQ(completed, kRequests);
+  EXPECT_EQ(queue.GetStats().dispatched, kRequests);
+}
+
+// 设备资源不足时请求留在队列中，在途请求完成后重试
+TEST_F(BlockQueueTest, DeviceBusyRetriesAfterCompletion) {
+  device_.free_slots = 2;
+  BlockQueue queue(&device_);
+  constexpr int kRequests = 5;
+  std::vector<uint8_t> data(AsyncMemDevice::kSectorSize);
+  std::vector<BlockRequest> requests(kRequests);
+  int completed = 0;
+  for (int i = 0; i < kRequests; ++i) {
+    requests[i] = BlockRequest{
+        .op = BlockOp::kRead,
+        .sector = static_cast<uint64_t>(i) * 10,
+        .sector_count = 1,
+        .buffer = data.data(),
+        .end_io = CountEndIo,
+        .private_data = &completed,
+    };
+    ASSERT_TRUE(queue.Submit(&requests[i]).has_value());
+  }
+  EXPECT_EQ(device_.queued.size(), 2);
+
+  device_.PollRequests();
+  EXPECT_EQ(completed, kRequests);
+  for (const auto& request : requests) {
+    EXPECT_EQ(request.status, ErrorCode::kSuccess);
+  }
+}
+
+// 同步读写经由队列提交，大块读写拆分为多个请求
+TEST_F(BlockQueueTest, SyncReadWriteThroughQueue) {
+  BlockQueue queue(&device_);
+  constexpr uint32_t kSectors = BlockQueue::kMaxMergeSectors * 2 + 88;
+  std::vector<uint8_t> data(kSectors * AsyncMemDevice::kSectorSize);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+  ASSERT_EQ(queue.WriteSectors(100, kSectors, data.data()).value(),
+            data.size());
+  EXPECT_EQ(memcmp(device_.storage.data() + 100 * AsyncMemDevice::kSectorSize,
+                   data.data(), data.size()),
+            0);
+  EXPECT_EQ(queue.GetStats().submitted, 3);
+
+  std::vector<uint8_t> out(data.size());
+  ASSERT_EQ(queue.ReadSectors(100, kSectors, out.data()).value(), out.size());
+  EXPECT_EQ(out, data);
+}
+
+// 每个硬件队列独立暂存、合并与计算在途深度，请求进入提交核心对应的队列
+TEST_F(BlockQueueTest, PerHwQueueContexts) {
+  device_.depth = 4;
+  device_.hw_queues = 2;
+  BlockQueue queue(&device_);
+  std::vector<uint8_t> data(AsyncMemDevice::kSectorSize);
+  std::vector<BlockRequest> requests(4);
+  int completed = 0;
+  auto make_request = [&](uint64_t sector) {
+    return BlockRequest{
+        .op = BlockOp::kRead,
+        .sector = sector,
+        .sector_count = 1,
+        .buffer = data.data(),
+        .end_io = CountEndIo,
+        .private_data = &completed,
+    };
+  };
+
+  // 核心 0 的队列深度为 2，第三个请求留在核心 0 的队列中
+  for (int i = 0; i < 3; ++i) {
+    requests[i] = make_request(static_cast<uint64_t>(i) * 10);
+    ASSERT_TRUE(queue.Submit(&requests[i]).has_value());
+  }
+  ASSERT_EQ(device_.queued.size(), 2);
+  EXPECT_EQ(requests[0].hw_queue, 0);
+
+  // 核心 1 的请求与核心 0 暂存的请求相邻，但不合并，且不受核心 0 深度限制
+  env_state_.BindThreadToCore(std::this_thread::get_id(), 1);
+  requests[3] = make_request(21);
+  ASSERT_TRUE(queue.Submit(&requests[3]).has_value());
+  ASSERT_EQ(device_.queued.size(), 3);
+  EXPECT_EQ(device_.queued.back(), &requests[3]);
+  EXPECT_EQ(requests[3].hw_queue, 1);
+  EXPECT_EQ(queue.GetStats().merged, 0);
+
+  // 核心 0 的单元完成后派发核心 0 暂存的请求
+  device_.CompleteOldest();
+  ASSERT_EQ(device_.queued.size(), 3);
+  EXPECT_EQ(device_.queued.back(), &requests[2]);
+
+  device_.PollRequests();
+  EXPECT_EQ(completed, 4);
+  auto stats = queue.GetStats();
+  EXPECT_EQ(stats.submitted, 4);
+  EXPECT_EQ(stats.dispatched, 4);
+}
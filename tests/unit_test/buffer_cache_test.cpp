@@ -0,0 +1,221 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ * @brief 写回块缓存单元测试
+ */
+
+#include "buffer_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "test_environment_state.hpp"
+
+using namespace vfs;
+
+namespace {
+
+// 内存块设备，记录设备请求
+class MemBlockDevice : public BlockDevice {
+ public:
+  static constexpr uint32_t kSectorSize = 512;
+  static constexpr uint64_t kSectorCount = 8192;
+
+  std::vector<uint8_t> storage =
+      std::vector<uint8_t>(kSectorSize * kSectorCount);
+  size_t read_requests = 0;
+  size_t write_requests = 0;
+  size_t written_sectors = 0;
+  size_t flushes = 0;
+  bool fail_writes = false;
+
+  auto ReadSectors(uint64_t sector_start, uint32_t sector_count, void* buffer)
+      -> Expected<size_t> override {
+    ++read_requests;
+    memcpy(buffer, storage.data() + sector_start * kSectorSize,
+           sector_count * kSectorSize);
+    return static_cast<size_t>(sector_count) * kSectorSize;
+  }
+
+  auto WriteSectors(uint64_t sector_start, uint32_t sector_count,
+                    const void* buffer) -> Expected<size_t> override {
+    if (fail_writes) {
+      return std::unexpected(Error(ErrorCode::kBlkWriteFailed));
+    }
+    ++write_requests;
+    written_sectors += sector_count;
+    memcpy(storage.data() + sector_start * kSectorSize, buffer,
+           sector_count * kSectorSize);
+    return static_cast<size_t>(sector_count) * kSectorSize;
+  }
+
+  [[nodiscard]] auto GetSectorSize() const -> uint32_t override {
+    return kSectorSize;
+  }
+  [[nodiscard]] auto GetSectorCount() const -> uint64_t override {
+    return kSectorCount;
+  }
+  [[nodiscard]] auto GetName() const -> const char* override {
+    return "memblk";
+  }
+  auto Flush() -> Expected<void> override {
+    ++flushes;
+    return {};
+  }
+};
+
+auto FillSector(uint8_t value) -> std::vector<uint8_t> {
+  return std::vector<uint8_t>(MemBlockDevice::kSectorSize, value);
+}
+
+}  // namespace
+
+class BufferCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    env_state_.InitializeCores(1);
+    env_state_.SetCurrentThreadEnvironment();
+    env_state_.BindThreadToCore(std::this_thread::get_id(), 0);
+  }
+
+  void TearDown() override { env_state_.ClearCurrentThreadEnvironment(); }
+
+  test_env::TestEnvironmentState env_state_;
+  MemBlockDevice device_;
+};
+
+// 写入留在缓存中，Flush 后到达设备
+TEST_F(BufferCacheTest, WriteIsAbsorbedUntilFlush) {
+  BufferCache cache(&device_);
+  auto data = FillSector(0xab);
+  ASSERT_TRUE(cache.WriteSectors(5, 1, data.data()).has_value());
+  EXPECT_EQ(device_.write_requests, 0);
+  EXPECT_EQ(cache.GetStats().dirty, 1);
+
+  // 读取看到未写回的数据
+  auto buf = FillSector(0);
+  ASSERT_TRUE(cache.ReadSectors(5, 1, buf.data()).has_value());
+  EXPECT_EQ(buf, data);
+
+  ASSERT_TRUE(cache.Flush().has_value());
+  EXPECT_EQ(device_.write_requests, 1);
+  EXPECT_EQ(device_.flushes, 1);
+  EXPECT_EQ(cache.GetStats().dirty, 0);
+  EXPECT_EQ(memcmp(device_.storage.data() + 5 * MemBlockDevice::kSectorSize,
+                   data.data(), data.size()),
+            0);
+}
+
+// 相邻的脏扇区合并为一次写请求，同一扇区的重复写入只写回一次
+TEST_F(BufferCacheTest, AdjacentSectorsCoalesced) {
+  BufferCache cache(&device_);
+  for (uint64_t sector = 19; sector >= 10; --sector) {
+    auto data = FillSector(static_cast<uint8_t>(sector));
+    ASSERT_TRUE(cache.WriteSectors(sector, 1, data.data()).has_value());
+  }
+  for (int i = 0; i < 100; ++i) {
+    auto data = FillSector(static_cast<uint8_t>(i));
+    ASSERT_TRUE(cache.WriteSectors(30, 1, data.data()).has_value());
+  }
+
+  ASSERT_TRUE(cache.Flush().has_value());
+  EXPECT_EQ(device_.write_requests, 2);
+  EXPECT_EQ(device_.written_sectors, 11);
+  EXPECT_EQ(device_.storage[30 * MemBlockDevice::kSectorSize], 99);
+  EXPECT_EQ(device_.storage[15 * MemBlockDevice::kSectorSize], 15);
+}
+
+// 冲刷周期只写回过期的脏扇区
+TEST_F(BufferCacheTest, TickWritesExpiredSectors) {
+  BufferCache cache(&device_);
+  auto data = FillSector(0x11);
+  ASSERT_TRUE(cache.WriteSectors(1, 1, data.data()).has_value());
+
+  for (uint32_t i = 0; i + 1 < BufferCache::kExpirePeriods; ++i) {
+    ASSERT_EQ(cache.Tick().value(), 0);
+  }
+  EXPECT_EQ(device_.write_requests, 0);
+  ASSERT_EQ(cache.Tick().value(), 1);
+  EXPECT_EQ(device_.write_requests, 1);
+  EXPECT_EQ(cache.GetStats().dirty, 0);
+}
+
+// 脏扇区超过上限时写入者同步写回
+TEST_F(BufferCacheTest, DirtyLimitTriggersWriteBack) {
+  BufferCache cache(&device_);
+  auto data = FillSector(0x22);
+  for (uint64_t sector = 0; sector <= BufferCache::kDirtyLimit; ++sector) {
+    ASSERT_TRUE(cache.WriteSectors(sector, 1, data.data()).has_value());
+  }
+  EXPECT_EQ(cache.GetStats().dirty, 0);
+  EXPECT_EQ(device_.written_sectors, BufferCache::kDirtyLimit + 1);
+  // 连续扇区按 kMaxWriteSectors 合并
+  EXPECT_LE(device_.write_requests,
+            (BufferCache::kDirtyLimit / BufferCache::kMaxWriteSectors) + 1);
+}
+
+// 小块读取被缓存，大块读取直接经过
+TEST_F(BufferCacheTest, SmallReadsAreCached) {
+  BufferCache cache(&device_);
+  device_.storage[7 * MemBlockDevice::kSectorSize] = 0x77;
+  auto buf = FillSector(0);
+  ASSERT_TRUE(cache.ReadSectors(7, 1, buf.data()).has_value());
+  ASSERT_TRUE(cache.ReadSectors(7, 1, buf.data()).has_value());
+  EXPECT_EQ(device_.read_requests, 1);
+  EXPECT_EQ(buf[0], 0x77);
+
+  std::vector<uint8_t> large((BufferCache::kMaxCachedReadSectors + 1) *
+                             MemBlockDevice::kSectorSize);
+  ASSERT_TRUE(cache
+                  .ReadSectors(100, BufferCache::kMaxCachedReadSectors + 1,
+                               large.data())
+                  .has_value());
+  EXPECT_EQ(cache.GetStats().buffers, 1);
+}
+
+// 写回失败的扇区仍为脏，设备恢复后可再次写回
+TEST_F(BufferCacheTest, FailedWriteBackStaysDirty) {
+  BufferCache cache(&device_);
+  auto data = FillSector(0x33);
+  ASSERT_TRUE(cache.WriteSectors(3, 1, data.data()).has_value());
+
+  device_.fail_writes = true;
+  EXPECT_FALSE(cache.Flush().has_value());
+  EXPECT_EQ(cache.GetStats().dirty, 1);
+
+  device_.fail_writes = false;
+  ASSERT_TRUE(cache.Flush().has_value());
+  EXPECT_EQ(cache.GetStats().dirty, 0);
+  EXPECT_EQ(device_.storage[3 * MemBlockDevice::kSectorSize], 0x33);
+}
+
+// 异步读请求绕过缓存直接交给设备，范围内有脏扇区时拒绝
+TEST_F(BufferCacheTest, SubmitReadBypassesCleanRange) {
+  BufferCache cache(&device_);
+  device_.storage[20 * MemBlockDevice::kSectorSize] = 0x20;
+  auto buf = FillSector(0);
+  bool ended = false;
+  BlockRequest request{
+      .op = BlockOp::kRead,
+      .sector = 20,
+      .sector_count = 1,
+      .buffer = buf.data(),
+      .end_io = [](BlockRequest* done) {
+        *static_cast<bool*>(done->private_data) = true;
+      },
+      .private_data = &ended,
+  };
+  ASSERT_TRUE(cache.Submit(&request).has_value());
+  EXPECT_TRUE(ended);
+  EXPECT_EQ(buf[0], 0x20);
+  EXPECT_EQ(cache.GetStats().buffers, 0);
+
+  // 设备上的数据比缓存旧，由调用者改用 ReadSectors
+  auto data = FillSector(0x21);
+  ASSERT_TRUE(cache.WriteSectors(21, 1, data.data()).has_value());
+  request.sector = 21;
+  auto result = cache.Submit(&request);
+  ASSERT_FALSE(result.has_value());
+  EXPECT_EQ(result.error().code, ErrorCode::kNotSupported);
+}
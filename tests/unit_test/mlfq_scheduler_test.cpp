@@ -0,0 +1,170 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ */
+
+#include "mlfq_scheduler.hpp"
+
+#include <gtest/gtest.h>
+
+#include "task_control_block.hpp"
+
+// 测试基本入队出队与空队列行为
+TEST(MlfqSchedulerTest, BasicEnqueuePick) {
+  MlfqScheduler scheduler;
+  EXPECT_STREQ(scheduler.name, "MLFQ");
+
+  TaskControlBlock task1("Task1", 1, nullptr, nullptr);
+  TaskControlBlock task2("Task2", 2, nullptr, nullptr);
+
+  EXPECT_TRUE(scheduler.IsEmpty());
+  EXPECT_EQ(scheduler.PickNext(), nullptr);
+
+  scheduler.Enqueue(&task1);
+  scheduler.Enqueue(&task2);
+  EXPECT_EQ(scheduler.GetQueueSize(), 2);
+  EXPECT_EQ(task1.sched_data.mlfq.level, 0);
+
+  EXPECT_EQ(scheduler.PickNext(), &task1);
+  EXPECT_EQ(scheduler.PickNext(), &task2);
+  EXPECT_TRUE(scheduler.IsEmpty());
+}
+
+// 测试高级别任务总是先被选中
+TEST(MlfqSchedulerTest, HigherLevelPickedFirst) {
+  MlfqScheduler scheduler;
+
+  TaskControlBlock low("Low", 1, nullptr, nullptr);
+  low.sched_data.mlfq.level = 7;
+  TaskControlBlock mid("Mid", 1, nullptr, nullptr);
+  mid.sched_data.mlfq.level = 3;
+  TaskControlBlock high("High", 1, nullptr, nullptr);
+
+  scheduler.Enqueue(&low);
+  scheduler.Enqueue(&mid);
+  scheduler.Enqueue(&high);
+
+  EXPECT_EQ(scheduler.PickNext(), &high);
+  EXPECT_EQ(scheduler.PickNext(), &mid);
+  EXPECT_EQ(scheduler.PickNext(), &low);
+  EXPECT_EQ(scheduler.PickNext(), nullptr);
+}
+
+// 测试配额耗尽后降级，主动让出不降级
+TEST(MlfqSchedulerTest, DemotionOnQuantumExpiry) {
+  MlfqScheduler scheduler;
+  TaskControlBlock task("Task", 1, nullptr, nullptr);
+
+  scheduler.OnScheduled(&task);
+  EXPECT_EQ(task.sched_info.time_slice_remaining,
+            MlfqScheduler::GetQuantum(0));
+
+  EXPECT_FALSE(scheduler.OnTick(&task));
+  EXPECT_TRUE(scheduler.OnTick(&task));
+  EXPECT_TRUE(scheduler.OnTimeSliceExpired(&task));
+  EXPECT_EQ(task.sched_data.mlfq.level, 1);
+  EXPECT_EQ(scheduler.GetDemotions(), 1);
+
+  // 未用完配额时让出，级别与累计用量保持不变
+  EXPECT_FALSE(scheduler.OnTick(&task));
+  EXPECT_TRUE(scheduler.OnTimeSliceExpired(&task));
+  EXPECT_EQ(task.sched_data.mlfq.level, 1);
+  EXPECT_EQ(task.sched_data.mlfq.ticks_used, 1);
+}
+
+// 测试高级别任务就绪时抢占当前任务
+TEST(MlfqSchedulerTest, PreemptByHigherLevel) {
+  MlfqScheduler scheduler;
+  TaskControlBlock batch("Batch", 1, nullptr, nullptr);
+  batch.sched_data.mlfq.level = 5;
+  TaskControlBlock interactive("Interactive", 1, nullptr, nullptr);
+
+  EXPECT_FALSE(scheduler.OnTick(&batch));
+  scheduler.Enqueue(&interactive);
+  EXPECT_TRUE(scheduler.OnTick(&batch));
+}
+
+// 测试周期性优先级提升
+TEST(MlfqSchedulerTest, PeriodicBoost) {
+  MlfqScheduler scheduler;
+  TaskControlBlock current("Current", 1, nullptr, nullptr);
+  current.sched_data.mlfq.level = MlfqScheduler::kLevelCount - 1;
+  TaskControlBlock starved("Starved", 1, nullptr, nullptr);
+  starved.sched_data.mlfq.level = 6;
+  scheduler.Enqueue(&starved);
+
+  for (uint64_t i = 0; i < MlfqScheduler::kBoostInterval; ++i) {
+    (void)scheduler.OnTick(&current);
+    current.sched_data.mlfq.ticks_used = 0;
+  }
+
+  EXPECT_EQ(scheduler.GetBoosts(), 1);
+  EXPECT_EQ(current.sched_data.mlfq.level, 0);
+  EXPECT_EQ(starved.sched_data.mlfq.level, 0);
+  EXPECT_EQ(scheduler.GetLevelSize(0), 1);
+  EXPECT_EQ(scheduler.GetLevelSize(6), 0);
+  EXPECT_EQ(scheduler.PickNext(), &starved);
+}
+
+// 测试 Dequeue 维护位图
+TEST(MlfqSchedulerTest, DequeueClearsBitmap) {
+  MlfqScheduler scheduler;
+  TaskControlBlock task1("Task1", 1, nullptr, nullptr);
+  task1.sched_data.mlfq.level = 2;
+  TaskControlBlock task2("Task2", 1, nullptr, nullptr);
+  task2.sched_data.mlfq.level = 4;
+
+  scheduler.Enqueue(&task1);
+  scheduler.Enqueue(&task2);
+  scheduler.Dequeue(&task1);
+  scheduler.Dequeue(&task1);
+
+  EXPECT_EQ(scheduler.GetQueueSize(), 1);
+  EXPECT_EQ(scheduler.GetStats().total_dequeues, 1);
+  EXPECT_EQ(scheduler.PickNext(), &task2);
+  EXPECT_TRUE(scheduler.IsEmpty());
+}
+
+// 测试从级别中间移除任务，不影响前后任务的顺序
+TEST(MlfqSchedulerTest, DequeueFromMiddle) {
+  MlfqScheduler scheduler;
+  TaskControlBlock task1("Task1", 1, nullptr, nullptr);
+  TaskControlBlock task2("Task2", 1, nullptr, nullptr);
+  TaskControlBlock task3("Task3", 1, nullptr, nullptr);
+
+  scheduler.Enqueue(&task1);
+  scheduler.Enqueue(&task2);
+  scheduler.Enqueue(&task3);
+  scheduler.Dequeue(&task2);
+
+  EXPECT_EQ(scheduler.GetLevelSize(0), 2);
+  EXPECT_EQ(scheduler.PickNext(), &task1);
+  EXPECT_EQ(scheduler.PickNext(), &task3);
+  EXPECT_TRUE(scheduler.IsEmpty());
+}
+
+// 测试提升时阻塞的任务在唤醒入队时补做提升
+TEST(MlfqSchedulerTest, BlockedTaskBoostedOnWakeup) {
+  MlfqScheduler scheduler;
+  TaskControlBlock current("Current", 1, nullptr, nullptr);
+  TaskControlBlock blocked("Blocked", 1, nullptr, nullptr);
+  blocked.sched_data.mlfq.level = 5;
+  blocked.sched_data.mlfq.ticks_used = 3;
+
+  for (uint64_t i = 0; i < MlfqScheduler::kBoostInterval; ++i) {
+    (void)scheduler.OnTick(&current);
+    current.sched_data.mlfq.ticks_used = 0;
+  }
+  EXPECT_EQ(scheduler.GetBoosts(), 1);
+
+  // 唤醒后从最高级别开始，配额清零
+  scheduler.Enqueue(&blocked);
+  EXPECT_EQ(blocked.sched_data.mlfq.level, 0);
+  EXPECT_EQ(blocked.sched_data.mlfq.ticks_used, 0);
+  EXPECT_EQ(scheduler.GetLevelSize(0), 1);
+
+  // 同一代内再次降级后入队不会被重复提升
+  EXPECT_EQ(scheduler.PickNext(), &blocked);
+  blocked.sched_data.mlfq.level = 2;
+  scheduler.Enqueue(&blocked);
+  EXPECT_EQ(blocked.sched_data.mlfq.level, 2);
+}
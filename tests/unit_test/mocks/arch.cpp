@@ -5,10 +5,12 @@
 #include <cassert>
 #include <cstring>
 
+#include "arch.h"
 #include "cpu_io.h"
 #include "per_cpu.hpp"
 #include "task_manager.hpp"
 #include "test_environment_state.hpp"
+#include "user_access.hpp"
 
 extern "C" {
 
@@ -45,8 +47,31 @@ void kernel_thread_entry() {}
 void trap_return(void*) {}
 void trap_entry() {}
 
+// 主机上不会发生用户内存缺页，直接拷贝
+size_t copy_user(void* dst, const void* src, size_t len) {
+  memcpy(dst, src, len);
+  return 0;
+}
+
 }  // extern "C"
 
+/// 主机上没有 user_copy.S，提供一个空表项使 __ex_table 段存在
+[[gnu::used, gnu::section("__ex_table")]] ExceptionTableEntry
+    mock_ex_table_entry{};
+
+auto SendIpi([[maybe_unused]] uint64_t target_cpu_mask) -> Expected<void> {
+  return {};
+}
+
+auto FpuInit() -> void {}
+auto FpuEnable() -> void {}
+auto FpuDisable() -> void {}
+auto FpuSave([[maybe_unused]] FpuState* state) -> void {}
+auto FpuRestore([[maybe_unused]] const FpuState* state) -> void {}
+auto FpuInitState(FpuState* state) -> void { *state = {}; }
+auto ReadTimestamp() -> uint64_t { return 0; }
+auto VdsoArchInit([[maybe_unused]] size_t core_id) -> void {}
+
 void InitTaskContext(cpu_io::CalleeSavedContext* task_context,
                      void (*entry)(void*), void* arg, uint64_t stack_top) {
   // 清零上下文
@@ -76,6 +101,9 @@ void InitTaskContext(cpu_io::CalleeSavedContext* task_context,
 #include <stdio.h>
 
 extern "C" void etl_putchar(int c) { putchar(c); }
+extern "C" void console_write(const char* buf, size_t len) {
+  fwrite(buf, 1, len, stdout);
+}
 
 #undef sk_printf
 extern "C" int sk_printf(const char* format, ...) {
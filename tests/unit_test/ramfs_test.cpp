@@ -7,6 +7,9 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <format>
+#include <iostream>
 #include <vector>
 
 #include "test_environment_state.hpp"
@@ -281,6 +284,217 @@ TEST_F(RamFsTest, UnlinkNonExistent) {
   EXPECT_FALSE(unlink_result.has_value());
 }
 
+// 测试越过文件末尾写入留下的空洞
+TEST_F(RamFsTest, SparseWrite) {
+  Inode* root = ramfs_.GetRootInode();
+  ASSERT_NE(root, nullptr);
+
+  auto create_result =
+      root->ops->Create(root, "sparse.bin", FileType::kRegular);
+  ASSERT_TRUE(create_result.has_value());
+
+  File file;
+  file.inode = create_result.value();
+  file.ops = ramfs_.GetFileOps();
+
+  // 只分配末尾所在的页，空洞读出为 0
+  constexpr uint64_t kOffset = 1024UL * 1024UL * 1024UL;
+  auto write_result = file.ops->PWrite(&file, "end", 3, kOffset);
+  ASSERT_TRUE(write_result.has_value());
+  EXPECT_EQ(file.inode->size, kOffset + 3);
+
+  char buf[8] = {1, 1, 1, 1, 1, 1, 1, 1};
+  auto read_result = file.ops->PRead(&file, buf, 4, 4096);
+  ASSERT_TRUE(read_result.has_value());
+  EXPECT_EQ(read_result.value(), 4u);
+  EXPECT_EQ(buf[0], 0);
+  EXPECT_EQ(buf[3], 0);
+
+  read_result = file.ops->PRead(&file, buf, sizeof(buf), kOffset);
+  ASSERT_TRUE(read_result.has_value());
+  EXPECT_EQ(read_result.value(), 3u);
+  EXPECT_EQ(memcmp(buf, "end", 3), 0);
+}
+
+// 测试截断与删除释放数据页
+TEST_F(RamFsTest, TruncateAndUnlinkFreePages) {
+  Inode* root = ramfs_.GetRootInode();
+  ASSERT_NE(root, nullptr);
+  size_t base_pages = ramfs_.GetUsedPages();
+
+  auto create_result = root->ops->Create(root, "pages.bin", FileType::kRegular);
+  ASSERT_TRUE(create_result.has_value());
+
+  File file;
+  file.inode = create_result.value();
+  file.ops = ramfs_.GetFileOps();
+
+  std::vector<uint8_t> data(4 * 4096 + 100, 0xAB);
+  auto write_result = file.ops->Write(&file, data.data(), data.size());
+  ASSERT_TRUE(write_result.has_value());
+  EXPECT_GT(ramfs_.GetUsedPages(), base_pages + 4);
+
+  // 截断到一页半，之后的页被释放，尾部读出为 0
+  EXPECT_TRUE(ramfs_.Truncate(file.inode, 4096 + 2048).has_value());
+  size_t truncated_pages = ramfs_.GetUsedPages();
+  EXPECT_LT(truncated_pages, base_pages + 5);
+  EXPECT_TRUE(ramfs_.Truncate(file.inode, 4096 * 2).has_value());
+  uint8_t tail = 0xFF;
+  auto read_result = file.ops->PRead(&file, &tail, 1, 4096 + 2048);
+  ASSERT_TRUE(read_result.has_value());
+  EXPECT_EQ(tail, 0);
+
+  // 删除后释放所有页
+  EXPECT_TRUE(root->ops->Unlink(root, "pages.bin").has_value());
+  EXPECT_EQ(ramfs_.GetUsedPages(), base_pages);
+}
+
+// 追加写吞吐量：增长不复制已有数据，耗时与文件大小成线性关系
+TEST_F(RamFsTest, AppendThroughput) {
+  Inode* root = ramfs_.GetRootInode();
+  ASSERT_NE(root, nullptr);
+
+  auto create_result =
+      root->ops->Create(root, "append.bin", FileType::kRegular);
+  ASSERT_TRUE(create_result.has_value());
+
+  File file;
+  file.inode = create_result.value();
+  file.ops = ramfs_.GetFileOps();
+
+  // 超过原先 1 MiB 静态池的上限
+  constexpr size_t kChunkSize = 512;
+  constexpr size_t kTotalSize = 8UL * 1024UL * 1024UL;
+  std::vector<uint8_t> chunk(kChunkSize);
+  for (size_t i = 0; i < kChunkSize; ++i) {
+    chunk[i] = static_cast<uint8_t>(i);
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t written = 0; written < kTotalSize; written += kChunkSize) {
+    auto write_result = file.ops->Write(&file, chunk.data(), kChunkSize);
+    ASSERT_TRUE(write_result.has_value());
+    ASSERT_EQ(write_result.value(), kChunkSize);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  auto duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+  EXPECT_EQ(file.inode->size, kTotalSize);
+  std::vector<uint8_t> buf(kChunkSize);
+  auto read_result =
+      file.ops->PRead(&file, buf.data(), kChunkSize, kTotalSize - kChunkSize);
+  ASSERT_TRUE(read_result.has_value());
+  EXPECT_EQ(buf, chunk);
+
+  std::cout << std::format(
+      "RamFs append: {} bytes in {}-byte chunks in {} microseconds "
+      "({} pages)\n",
+      kTotalSize, kChunkSize, duration.count(), ramfs_.GetUsedPages());
+
+  EXPECT_LT(duration.count(), 1000000);  // 少于1秒
+}
+
+// 测试遍历目录期间删除目录项不影响其余目录项
+TEST_F(RamFsTest, ReadDirStableAcrossRemove) {
+  Inode* root = ramfs_.GetRootInode();
+  ASSERT_NE(root, nullptr);
+
+  constexpr int kFileCount = 64;
+  char name[32];
+  for (int i = 0; i < kFileCount; ++i) {
+    snprintf(name, sizeof(name), "f%d", i);
+    ASSERT_TRUE(root->ops->Create(root, name, FileType::kRegular).has_value());
+  }
+
+  File dir_file;
+  dir_file.inode = root;
+  dir_file.offset = 0;
+  dir_file.ops = ramfs_.GetFileOps();
+
+  // 读取 . 、.. 与前 8 项
+  DirEntry entries[10];
+  auto readdir_result = dir_file.ops->ReadDir(&dir_file, entries, 10);
+  ASSERT_TRUE(readdir_result.has_value());
+  ASSERT_EQ(readdir_result.value(), 10u);
+
+  // 删除已读取的一项和尚未读取的一项，再新建一项复用空闲槽位
+  EXPECT_TRUE(root->ops->Unlink(root, entries[2].name).has_value());
+  EXPECT_TRUE(root->ops->Unlink(root, "f40").has_value());
+  ASSERT_TRUE(root->ops->Create(root, "new", FileType::kRegular).has_value());
+
+  std::vector<bool> seen(kFileCount, false);
+  for (size_t i = 2; i < 10; ++i) {
+    seen[atoi(entries[i].name + 1)] = true;
+  }
+  size_t total = 8;
+  while (true) {
+    readdir_result = dir_file.ops->ReadDir(&dir_file, entries, 10);
+    ASSERT_TRUE(readdir_result.has_value());
+    if (readdir_result.value() == 0) {
+      break;
+    }
+    for (size_t i = 0; i < readdir_result.value(); ++i) {
+      // 遍历期间新建的目录项可能返回也可能不返回
+      if (strcmp(entries[i].name, "new") == 0) {
+        continue;
+      }
+      int idx = atoi(entries[i].name + 1);
+      EXPECT_FALSE(seen[idx]);
+      seen[idx] = true;
+      ++total;
+    }
+  }
+
+  // 除被删除的未读项外，每一项恰好返回一次
+  EXPECT_EQ(total, static_cast<size_t>(kFileCount - 1));
+  EXPECT_FALSE(seen[40]);
+}
+
+// 大目录的创建与查找吞吐量：散列索引使单次操作与目录大小无关
+TEST_F(RamFsTest, LargeDirectoryThroughput) {
+  Inode* root = ramfs_.GetRootInode();
+  ASSERT_NE(root, nullptr);
+
+  // 超过静态 inode 表的大小
+  constexpr int kFileCount = 10000;
+  char name[32];
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < kFileCount; ++i) {
+    snprintf(name, sizeof(name), "file_%d", i);
+    ASSERT_TRUE(root->ops->Create(root, name, FileType::kRegular).has_value());
+  }
+  auto created = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < kFileCount; ++i) {
+    snprintf(name, sizeof(name), "file_%d", i);
+    ASSERT_TRUE(root->ops->Lookup(root, name).has_value());
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  auto create_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(created - start);
+  auto lookup_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - created);
+  std::cout << std::format(
+      "RamFs directory: {} creates in {} microseconds, "
+      "{} lookups in {} microseconds\n",
+      kFileCount, create_us.count(), kFileCount, lookup_us.count());
+
+  // 删除一半后槽位被复用
+  for (int i = 0; i < kFileCount; i += 2) {
+    snprintf(name, sizeof(name), "file_%d", i);
+    EXPECT_TRUE(root->ops->Unlink(root, name).has_value());
+  }
+  EXPECT_FALSE(root->ops->Lookup(root, "file_0").has_value());
+  EXPECT_TRUE(root->ops->Lookup(root, "file_1").has_value());
+  EXPECT_TRUE(
+      root->ops->Create(root, "file_0", FileType::kRegular).has_value());
+
+  EXPECT_LT(create_us.count(), 1000000);  // 少于1秒
+  EXPECT_LT(lookup_us.count(), 1000000);  // 少于1秒
+}
+
 // 测试 Sync（ramfs 应该立即返回成功）
 TEST_F(RamFsTest, Sync) {
   auto sync_result = ramfs_.Sync();
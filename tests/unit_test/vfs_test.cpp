@@ -7,9 +7,19 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <vector>
+
 #include "file_descriptor.hpp"
 #include "filesystem.hpp"
 #include "mount.hpp"
+#include "ramfs.hpp"
 #include "test_environment_state.hpp"
 
 using namespace filesystem;
@@ -33,6 +43,122 @@ class MockFileOps : public FileOps {
   }
 };
 
+// 使用页缓存的 ramfs，模拟块设备上的文件系统
+class CachedRamFs : public ramfs::RamFs {
+ public:
+  [[nodiscard]] auto UsesPageCache() const -> bool override { return true; }
+};
+
+// 请求暂存到 PollRequests 时才完成的块设备，模拟异步完成
+class DeferredDisk : public BlockDevice {
+ public:
+  static constexpr uint32_t kSectorSize = 512;
+
+  std::vector<uint8_t> image;
+  std::vector<BlockRequest*> pending;
+  size_t submitted = 0;
+
+  explicit DeferredDisk(size_t sectors) : image(sectors * kSectorSize) {}
+
+  auto ReadSectors(uint64_t sector, uint32_t count, void* buffer)
+      -> Expected<size_t> override {
+    memcpy(buffer, image.data() + sector * kSectorSize, count * kSectorSize);
+    return count * kSectorSize;
+  }
+  auto WriteSectors(uint64_t sector, uint32_t count, const void* buffer)
+      -> Expected<size_t> override {
+    memcpy(image.data() + sector * kSectorSize, buffer, count * kSectorSize);
+    return count * kSectorSize;
+  }
+  [[nodiscard]] auto GetSectorSize() const -> uint32_t override {
+    return kSectorSize;
+  }
+  [[nodiscard]] auto GetSectorCount() const -> uint64_t override {
+    return image.size() / kSectorSize;
+  }
+  [[nodiscard]] auto GetName() const -> const char* override {
+    return "deferred";
+  }
+  auto Submit(BlockRequest* request) -> Expected<void> override {
+    pending.push_back(request);
+    ++submitted;
+    return {};
+  }
+  auto PollRequests() -> void override {
+    auto done = std::move(pending);
+    pending.clear();
+    for (BlockRequest* request : done) {
+      (void)ReadSectors(request->sector, request->sector_count,
+                        request->buffer);
+      EndRequest(request, ErrorCode::kSuccess);
+    }
+  }
+};
+
+// 文件数据同时线性存放在 DeferredDisk 上的 ramfs，支持 MapExtent
+class MappedRamFs : public CachedRamFs {
+ public:
+  static constexpr uint64_t kFirstSector = 8;
+
+  class MappedFileOps : public FileOps {
+   public:
+    MappedFileOps(FileOps* inner, DeferredDisk* disk)
+        : inner_(inner), disk_(disk) {}
+    auto Read(File* file, void* buf, size_t count)
+        -> Expected<size_t> override {
+      return inner_->Read(file, buf, count);
+    }
+    auto Write(File* file, const void* buf, size_t count)
+        -> Expected<size_t> override {
+      return inner_->Write(file, buf, count);
+    }
+    auto Seek(File* file, int64_t offset, SeekWhence whence)
+        -> Expected<uint64_t> override {
+      return inner_->Seek(file, offset, whence);
+    }
+    auto PRead(File* file, void* buf, size_t count, uint64_t offset)
+        -> Expected<size_t> override {
+      return inner_->PRead(file, buf, count, offset);
+    }
+    auto PWrite(File* file, const void* buf, size_t count, uint64_t offset)
+        -> Expected<size_t> override {
+      return inner_->PWrite(file, buf, count, offset);
+    }
+    auto Open(File* file) -> Expected<void> override {
+      return inner_->Open(file);
+    }
+    auto Close(File* file) -> Expected<void> override {
+      return inner_->Close(file);
+    }
+    auto ReadDir(File* file, DirEntry* dirent, size_t count)
+        -> Expected<size_t> override {
+      return inner_->ReadDir(file, dirent, count);
+    }
+    auto MapExtent(File* file, uint64_t offset, uint64_t count)
+        -> Expected<BlockExtent> override {
+      ++maps;
+      return BlockExtent{
+          .device = disk_,
+          .sector = kFirstSector + offset / DeferredDisk::kSectorSize,
+          .bytes = std::min(count, file->inode->size - offset),
+      };
+    }
+
+    size_t maps = 0;
+
+   private:
+    FileOps* inner_;
+    DeferredDisk* disk_;
+  };
+
+  explicit MappedRamFs(DeferredDisk* disk)
+      : file_ops(ramfs::RamFs::GetFileOps(), disk) {}
+
+  auto GetFileOps() -> FileOps* override { return &file_ops; }
+
+  MappedFileOps file_ops;
+};
+
 // Mock file system for testing
 class MockFs : public FileSystem {
  public:
@@ -79,6 +205,76 @@ class MockFs : public FileSystem {
   auto GetFileOps() -> FileOps* override { return &mock_file_ops_; }
 };
 
+// 每次 Lookup 都分配新 inode 的文件系统（类似 FatFS），inode 池容量有限
+class PooledLookupFs : public FileSystem {
+ public:
+  static constexpr size_t kPoolSize = 256;
+
+  class PooledInodeOps : public InodeOps {
+   public:
+    explicit PooledInodeOps(PooledLookupFs* fs) : fs_(fs) {}
+    auto Lookup(Inode*, const char* name) -> Expected<Inode*> override {
+      if (strcmp(name, "file") != 0) {
+        return std::unexpected(Error(ErrorCode::kFsFileNotFound));
+      }
+      for (size_t i = 0; i < kPoolSize; ++i) {
+        if (!fs_->used[i]) {
+          fs_->used[i] = true;
+          fs_->pool[i].type = FileType::kRegular;
+          fs_->pool[i].fs = fs_;
+          fs_->pool[i].ops = this;
+          return &fs_->pool[i];
+        }
+      }
+      return std::unexpected(Error(ErrorCode::kOutOfMemory));
+    }
+    auto Create(Inode*, const char*, FileType) -> Expected<Inode*> override {
+      return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
+    }
+    auto Unlink(Inode*, const char*) -> Expected<void> override {
+      return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
+    }
+    auto Mkdir(Inode*, const char*) -> Expected<Inode*> override {
+      return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
+    }
+    auto Rmdir(Inode*, const char*) -> Expected<void> override {
+      return std::unexpected(Error(ErrorCode::kDeviceNotSupported));
+    }
+
+   private:
+    PooledLookupFs* fs_;
+  };
+
+  std::array<Inode, kPoolSize> pool{};
+  std::array<bool, kPoolSize> used{};
+  size_t released = 0;
+  Inode root_inode;
+  PooledInodeOps inode_ops{this};
+  MockFileOps file_ops;
+
+  PooledLookupFs() {
+    root_inode.type = FileType::kDirectory;
+    root_inode.fs = this;
+    root_inode.ops = &inode_ops;
+  }
+
+  [[nodiscard]] auto GetName() const -> const char* override {
+    return "pooledfs";
+  }
+  auto Mount(BlockDevice*) -> Expected<Inode*> override { return &root_inode; }
+  auto Unmount() -> Expected<void> override { return {}; }
+  auto Sync() -> Expected<void> override { return {}; }
+  auto AllocateInode() -> Expected<Inode*> override {
+    return std::unexpected(Error(ErrorCode::kOutOfMemory));
+  }
+  auto FreeInode(Inode*) -> Expected<void> override { return {}; }
+  auto ReleaseInode(Inode* inode) -> void override {
+    used[static_cast<size_t>(inode - pool.data())] = false;
+    ++released;
+  }
+  auto GetFileOps() -> FileOps* override { return &file_ops; }
+};
+
 // VFS 基础测试
 class VfsTest : public ::testing::Test {
  protected:
@@ -250,6 +446,54 @@ TEST_F(VfsTest, LookupRoot) {
   auto lookup_result = vfs::Lookup("/");
   EXPECT_TRUE(lookup_result.has_value());
   EXPECT_NE(lookup_result.value(), nullptr);
+
+  // 返回的 dentry 持有引用，释放前不能卸载
+  auto unmount_result = mount_table.Unmount("/");
+  EXPECT_FALSE(unmount_result.has_value());
+  vfs::PutDentry(lookup_result.value());
+  unmount_result = mount_table.Unmount("/");
+  EXPECT_TRUE(unmount_result.has_value());
+}
+
+// 测试跨越挂载点的路径解析
+TEST_F(VfsTest, MountCrossing) {
+  auto root_fs = std::make_unique<ramfs::RamFs>();
+  auto sub_fs = std::make_unique<ramfs::RamFs>();
+  auto& mount_table = GetMountTable();
+
+  ASSERT_TRUE(mount_table.Mount("/", root_fs.get(), nullptr).has_value());
+
+  // 挂载点必须是已存在的目录
+  EXPECT_FALSE(mount_table.Mount("/mnt", sub_fs.get(), nullptr).has_value());
+  ASSERT_TRUE(vfs::MkDir("/mnt").has_value());
+  ASSERT_TRUE(mount_table.Mount("/mnt", sub_fs.get(), nullptr).has_value());
+  ASSERT_TRUE(vfs::MkDir("/mnt/sub").has_value());
+
+  auto lookup_result = vfs::Lookup("/mnt/sub");
+  ASSERT_TRUE(lookup_result.has_value());
+  EXPECT_EQ(lookup_result.value()->inode->fs, sub_fs.get());
+  vfs::PutDentry(lookup_result.value());
+
+  // ".." 从挂载根回到挂载点的父目录
+  lookup_result = vfs::Lookup("/mnt/..");
+  ASSERT_TRUE(lookup_result.has_value());
+  EXPECT_EQ(lookup_result.value(), vfs::GetRootDentry());
+  vfs::PutDentry(lookup_result.value());
+
+  lookup_result = vfs::Lookup("/mnt/sub/../../mnt/sub");
+  ASSERT_TRUE(lookup_result.has_value());
+  EXPECT_EQ(lookup_result.value()->inode->fs, sub_fs.get());
+  vfs::PutDentry(lookup_result.value());
+
+  // 挂载点不能删除，子挂载卸载前父文件系统不能卸载
+  EXPECT_FALSE(vfs::RmDir("/mnt").has_value());
+  EXPECT_FALSE(mount_table.Unmount("/").has_value());
+  EXPECT_TRUE(mount_table.Unmount("/mnt").has_value());
+
+  // 卸载后 /mnt 回到父文件系统中的空目录
+  EXPECT_FALSE(vfs::Lookup("/mnt/sub").has_value());
+  EXPECT_TRUE(vfs::RmDir("/mnt").has_value());
+  EXPECT_TRUE(mount_table.Unmount("/").has_value());
 }
 
 TEST_F(VfsTest, LookupInvalidPaths) {
@@ -301,13 +545,305 @@ TEST(InodeStructTest, InodeDefaults) {
 TEST(DentryStructTest, DentryDefaults) {
   Dentry dentry;
   EXPECT_EQ(dentry.name[0], '\0');
+  EXPECT_EQ(dentry.name, dentry.inline_name);
+  EXPECT_EQ(dentry.name_len, 0);
   EXPECT_EQ(dentry.inode, nullptr);
   EXPECT_EQ(dentry.parent, nullptr);
   EXPECT_EQ(dentry.children, nullptr);
   EXPECT_EQ(dentry.next_sibling, nullptr);
+  EXPECT_EQ(dentry.prev_sibling, nullptr);
+  EXPECT_EQ(dentry.hash_next, nullptr);
+  EXPECT_EQ(dentry.ref_count.load(), 0);
+  EXPECT_FALSE(dentry.hashed);
+  EXPECT_FALSE(dentry.on_lru);
+  EXPECT_FALSE(dentry.mounted.load());
   EXPECT_EQ(dentry.fs_private, nullptr);
 }
 
+// dcache 回收测试
+TEST_F(VfsTest, ShrinkEmptyDentryCache) {
+  // 没有未使用的 dentry 时不回收任何内容
+  EXPECT_EQ(vfs::ShrinkDentryCache(0), 0);
+}
+
+// dcache 回收正 dentry 时归还 inode，反复回收与查找不会耗尽 inode 池
+TEST_F(VfsTest, EvictedDentryReleasesInode) {
+  auto fs = std::make_unique<PooledLookupFs>();
+  auto& mount_table = GetMountTable();
+  ASSERT_TRUE(mount_table.Mount("/", fs.get(), nullptr).has_value());
+
+  constexpr size_t kCycles = 2 * PooledLookupFs::kPoolSize;
+  for (size_t i = 0; i < kCycles; ++i) {
+    auto lookup_result = vfs::Lookup("/file");
+    ASSERT_TRUE(lookup_result.has_value()) << "cycle " << i;
+    vfs::PutDentry(lookup_result.value());
+    ASSERT_EQ(vfs::ShrinkDentryCache(1), 1) << "cycle " << i;
+  }
+  EXPECT_EQ(fs->released, kCycles);
+  EXPECT_TRUE(std::ranges::none_of(fs->used, [](bool used) { return used; }));
+
+  // 卸载时释放仍在缓存中的 dentry 同样归还 inode
+  auto lookup_result = vfs::Lookup("/file");
+  ASSERT_TRUE(lookup_result.has_value());
+  vfs::PutDentry(lookup_result.value());
+  EXPECT_TRUE(mount_table.Unmount("/").has_value());
+  EXPECT_EQ(fs->released, kCycles + 1);
+}
+
+// 页缓存测试：首次读取未命中，再次读取命中且内容一致
+TEST_F(VfsTest, PageCacheHitAfterMiss) {
+  auto fs = std::make_unique<CachedRamFs>();
+  auto& mount_table = GetMountTable();
+  ASSERT_TRUE(mount_table.Mount("/", fs.get(), nullptr).has_value());
+
+  auto open_result = vfs::Open("/cached", kOCreate | kOReadWrite);
+  ASSERT_TRUE(open_result.has_value());
+  File* file = open_result.value();
+
+  // 三个整页加一个不完整的末尾页
+  constexpr size_t kPageSize = 4096;
+  constexpr size_t kFileSize = 3 * kPageSize + 100;
+  std::vector<uint8_t> data(kFileSize);
+  for (size_t i = 0; i < kFileSize; ++i) {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+  ASSERT_EQ(vfs::PWrite(file, data.data(), kFileSize, 0).value(), kFileSize);
+
+  auto before = vfs::GetPageCacheStats();
+  std::vector<uint8_t> buf(kFileSize);
+  ASSERT_EQ(vfs::PRead(file, buf.data(), kFileSize, 0).value(), kFileSize);
+  EXPECT_EQ(buf, data);
+  // 第一页未命中，其余页由预读一并读入
+  auto after_miss = vfs::GetPageCacheStats();
+  EXPECT_EQ(after_miss.misses - before.misses, 1);
+  EXPECT_EQ(after_miss.readahead - before.readahead, 3);
+  EXPECT_EQ(after_miss.pages - before.pages, 4);
+
+  std::ranges::fill(buf, 0);
+  ASSERT_EQ(vfs::PRead(file, buf.data(), kFileSize, 0).value(), kFileSize);
+  EXPECT_EQ(buf, data);
+  auto after_hit = vfs::GetPageCacheStats();
+  EXPECT_EQ(after_hit.hits - after_miss.hits, 4);
+  EXPECT_EQ(after_hit.misses, after_miss.misses);
+
+  // 顺序读取命中缓存时同样推进文件偏移量，读到末尾返回 0
+  ASSERT_EQ(vfs::Read(file, buf.data(), kPageSize + 1).value(), kPageSize + 1);
+  EXPECT_EQ(buf[kPageSize], data[kPageSize]);
+  EXPECT_EQ(vfs::Seek(file, 0, SeekWhence::kCur).value(), kPageSize + 1);
+  ASSERT_TRUE(vfs::Seek(file, 0, SeekWhence::kEnd).has_value());
+  EXPECT_EQ(vfs::Read(file, buf.data(), 1).value(), 0);
+
+  // 删除文件后其缓存页被丢弃
+  EXPECT_TRUE(vfs::Close(file).has_value());
+  EXPECT_TRUE(vfs::Unlink("/cached").has_value());
+  EXPECT_EQ(vfs::GetPageCacheStats().pages, before.pages);
+  EXPECT_TRUE(mount_table.Unmount("/").has_value());
+}
+
+// 预读测试：顺序读取只在第一页未命中，窗口逐次扩大
+TEST_F(VfsTest, SequentialReadahead) {
+  auto fs = std::make_unique<CachedRamFs>();
+  auto& mount_table = GetMountTable();
+  ASSERT_TRUE(mount_table.Mount("/", fs.get(), nullptr).has_value());
+
+  auto open_result = vfs::Open("/stream", kOCreate | kOReadWrite);
+  ASSERT_TRUE(open_result.has_value());
+  File* file = open_result.value();
+
+  constexpr size_t kPageSize = 4096;
+  constexpr size_t kPages = 64;
+  std::vector<uint8_t> data(kPages * kPageSize);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i / kPageSize);
+  }
+  ASSERT_EQ(vfs::PWrite(file, data.data(), data.size(), 0).value(),
+            data.size());
+
+  auto before = vfs::GetPageCacheStats();
+  std::vector<uint8_t> buf(kPageSize);
+  for (size_t page = 0; page < kPages; ++page) {
+    ASSERT_EQ(vfs::Read(file, buf.data(), kPageSize).value(), kPageSize);
+    EXPECT_EQ(buf[0], static_cast<uint8_t>(page));
+  }
+  auto after = vfs::GetPageCacheStats();
+  EXPECT_EQ(after.misses - before.misses, 1);
+  EXPECT_EQ(after.readahead - before.readahead, kPages - 1);
+  EXPECT_EQ(after.hits - before.hits, kPages - 1);
+
+  EXPECT_TRUE(vfs::Close(file).has_value());
+  EXPECT_TRUE(mount_table.Unmount("/").has_value());
+}
+
+// 预读测试：随机读取不预读
+TEST_F(VfsTest, RandomReadDoesNotPrefetch) {
+  auto fs = std::make_unique<CachedRamFs>();
+  auto& mount_table = GetMountTable();
+  ASSERT_TRUE(mount_table.Mount("/", fs.get(), nullptr).has_value());
+
+  auto open_result = vfs::Open("/random", kOCreate | kOReadWrite);
+  ASSERT_TRUE(open_result.has_value());
+  File* file = open_result.value();
+
+  constexpr size_t kPageSize = 4096;
+  constexpr size_t kPages = 16;
+  std::vector<uint8_t> data(kPages * kPageSize, 0x3c);
+  ASSERT_EQ(vfs::PWrite(file, data.data(), data.size(), 0).value(),
+            data.size());
+
+  // 倒序读取每页
+  auto before = vfs::GetPageCacheStats();
+  uint8_t byte = 0;
+  for (size_t page = kPages; page > 0; --page) {
+    ASSERT_EQ(vfs::PRead(file, &byte, 1, (page - 1) * kPageSize).value(), 1);
+    EXPECT_EQ(byte, 0x3c);
+  }
+  auto after = vfs::GetPageCacheStats();
+  EXPECT_EQ(after.misses - before.misses, kPages);
+  EXPECT_EQ(after.readahead, before.readahead);
+  EXPECT_EQ(after.pages - before.pages, kPages);
+
+  EXPECT_TRUE(vfs::Close(file).has_value());
+  EXPECT_TRUE(mount_table.Unmount("/").has_value());
+}
+
+// 页缓存测试：写入使覆盖的缓存页失效
+TEST_F(VfsTest, PageCacheWriteInvalidates) {
+  auto fs = std::make_unique<CachedRamFs>();
+  auto& mount_table = GetMountTable();
+  ASSERT_TRUE(mount_table.Mount("/", fs.get(), nullptr).has_value());
+
+  auto open_result = vfs::Open("/cached", kOCreate | kOReadWrite);
+  ASSERT_TRUE(open_result.has_value());
+  File* file = open_result.value();
+
+  ASSERT_EQ(vfs::Write(file, "hello world", 11).value(), 11);
+  char buf[32] = {};
+  ASSERT_EQ(vfs::PRead(file, buf, sizeof(buf), 0).value(), 11);
+  EXPECT_EQ(memcmp(buf, "hello world", 11), 0);
+
+  // 覆盖写与追加写之后读到新内容
+  ASSERT_EQ(vfs::PWrite(file, "HELLO", 5, 0).value(), 5);
+  ASSERT_EQ(vfs::Write(file, "!!", 2).value(), 2);
+  ASSERT_EQ(vfs::PRead(file, buf, sizeof(buf), 0).value(), 13);
+  EXPECT_EQ(memcmp(buf, "HELLO world!!", 13), 0);
+
+  // 主动回收后重新从文件系统读取
+  EXPECT_GT(vfs::ShrinkPageCache(1024), 0);
+  ASSERT_EQ(vfs::PRead(file, buf, sizeof(buf), 6).value(), 7);
+  EXPECT_EQ(memcmp(buf, "world!!", 7), 0);
+
+  EXPECT_TRUE(vfs::Close(file).has_value());
+  EXPECT_TRUE(mount_table.Unmount("/").has_value());
+  EXPECT_EQ(vfs::GetPageCacheStats().pages, 0);
+}
+
+// 预读测试：窗口异步提交给块设备，读者只等待需要的页
+TEST_F(VfsTest, AsyncReadaheadThroughBlockDevice) {
+  constexpr size_t kPageSize = 4096;
+  constexpr size_t kPages = 32;
+  DeferredDisk disk(MappedRamFs::kFirstSector +
+                    kPages * kPageSize / DeferredDisk::kSectorSize);
+  auto fs = std::make_unique<MappedRamFs>(&disk);
+  auto& mount_table = GetMountTable();
+  ASSERT_TRUE(mount_table.Mount("/", fs.get(), nullptr).has_value());
+
+  auto open_result = vfs::Open("/async", kOCreate | kOReadWrite);
+  ASSERT_TRUE(open_result.has_value());
+  File* file = open_result.value();
+
+  std::vector<uint8_t> data(kPages * kPageSize);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i / kPageSize + 1);
+  }
+  ASSERT_EQ(vfs::PWrite(file, data.data(), data.size(), 0).value(),
+            data.size());
+  std::ranges::copy(data, disk.image.begin() +
+                              MappedRamFs::kFirstSector *
+                                  DeferredDisk::kSectorSize);
+
+  // 顺序读取：每页只从设备读一次，读到预读标记时下一窗口留在设备上
+  auto before = vfs::GetPageCacheStats();
+  std::vector<uint8_t> buf(kPageSize);
+  bool saw_inflight = false;
+  for (size_t page = 0; page < kPages; ++page) {
+    ASSERT_EQ(vfs::Read(file, buf.data(), kPageSize).value(), kPageSize);
+    EXPECT_EQ(buf[0], static_cast<uint8_t>(page + 1));
+    EXPECT_EQ(buf[kPageSize - 1], static_cast<uint8_t>(page + 1));
+    saw_inflight = saw_inflight || !disk.pending.empty();
+  }
+  auto after = vfs::GetPageCacheStats();
+  EXPECT_TRUE(saw_inflight);
+  EXPECT_EQ(disk.submitted, kPages);
+  EXPECT_GT(fs->file_ops.maps, 0U);
+  EXPECT_EQ(after.misses - before.misses, 1);
+  EXPECT_EQ(after.hits - before.hits, kPages - 1);
+
+  // 读入途中删除文件：页在完成时释放而不是挂入缓存
+  EXPECT_TRUE(vfs::Close(file).has_value());
+  ASSERT_GE(vfs::ShrinkPageCache(SIZE_MAX), kPages);
+  open_result = vfs::Open("/async", kOReadOnly);
+  ASSERT_TRUE(open_result.has_value());
+  file = open_result.value();
+  for (size_t page = 0; disk.pending.empty() && page < kPages; ++page) {
+    ASSERT_EQ(vfs::Read(file, buf.data(), kPageSize).value(), kPageSize);
+  }
+  EXPECT_FALSE(disk.pending.empty());
+  EXPECT_TRUE(vfs::Close(file).has_value());
+  EXPECT_TRUE(vfs::Unlink("/async").has_value());
+  disk.PollRequests();
+  EXPECT_EQ(vfs::GetPageCacheStats().pages, 0);
+  EXPECT_TRUE(mount_table.Unmount("/").has_value());
+}
+
+// 页缓存测试：热文件的读取吞吐量
+TEST_F(VfsTest, PageCacheHotReadThroughput) {
+  auto fs = std::make_unique<CachedRamFs>();
+  auto& mount_table = GetMountTable();
+  ASSERT_TRUE(mount_table.Mount("/", fs.get(), nullptr).has_value());
+
+  auto open_result = vfs::Open("/hot", kOCreate | kOReadWrite);
+  ASSERT_TRUE(open_result.has_value());
+  File* file = open_result.value();
+
+  constexpr size_t kFileSize = 4UL * 1024UL * 1024UL;
+  constexpr size_t kChunkSize = 64UL * 1024UL;
+  constexpr int kRounds = 16;
+  std::vector<uint8_t> data(kFileSize, 0x5a);
+  ASSERT_EQ(vfs::PWrite(file, data.data(), kFileSize, 0).value(), kFileSize);
+
+  std::vector<uint8_t> buf(kChunkSize);
+  // 预热缓存
+  for (size_t offset = 0; offset < kFileSize; offset += kChunkSize) {
+    ASSERT_EQ(vfs::PRead(file, buf.data(), kChunkSize, offset).value(),
+              kChunkSize);
+  }
+
+  auto before = vfs::GetPageCacheStats();
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int round = 0; round < kRounds; ++round) {
+    for (size_t offset = 0; offset < kFileSize; offset += kChunkSize) {
+      ASSERT_EQ(vfs::PRead(file, buf.data(), kChunkSize, offset).value(),
+                kChunkSize);
+    }
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  auto after = vfs::GetPageCacheStats();
+  auto duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+  EXPECT_EQ(after.misses, before.misses);
+  EXPECT_EQ(buf, std::vector<uint8_t>(kChunkSize, 0x5a));
+  std::cout << std::format(
+      "Page cache hot read: {} bytes in {}-byte chunks in {} microseconds "
+      "({} hits)\n",
+      kFileSize * kRounds, kChunkSize, duration.count(),
+      after.hits - before.hits);
+
+  EXPECT_LT(duration.count(), 1000000);  // 少于1秒
+  EXPECT_TRUE(vfs::Close(file).has_value());
+  EXPECT_TRUE(mount_table.Unmount("/").has_value());
+}
+
 // OpenFlags 测试
 TEST(OpenFlagsTest, FlagValues) {
   EXPECT_EQ(kOReadOnly, 0x0000u);
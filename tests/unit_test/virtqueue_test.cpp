@@ -0,0 +1,615 @@
+/**
+ * @copyright Copyright The SimpleKernel Contributors
+ * @brief Split/Packed Virtqueue 单元测试
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "io_buffer.hpp"
+#include "virtio/virt_queue/packed.hpp"
+#include "virtio/virt_queue/split.hpp"
+
+using namespace virtio;
+
+namespace {
+
+using PackedFlags = PackedVirtqueue::DescFlags;
+constexpr uint16_t kAvail = std::to_underlying(PackedFlags::kDescFAvail);
+constexpr uint16_t kUsed = std::to_underlying(PackedFlags::kDescFUsed);
+constexpr uint16_t kNext = std::to_underlying(PackedFlags::kDescFNext);
+constexpr uint16_t kWrite = std::to_underlying(PackedFlags::kDescFWrite);
+
+// 页对齐、已清零的 DMA 内存
+class DmaMemory {
+ public:
+  explicit DmaMemory(size_t size)
+      : size_((size + 4095) & ~size_t{4095}),
+        data_(static_cast<uint8_t*>(std::aligned_alloc(4096, size_))) {
+    memset(data_, 0, size_);
+  }
+  ~DmaMemory() { std::free(data_); }
+  DmaMemory(const DmaMemory&) = delete;
+  auto operator=(const DmaMemory&) -> DmaMemory& = delete;
+
+  [[nodiscard]] auto Region() const -> DmaRegion {
+    return {.virt = data_,
+            .phys = reinterpret_cast<uintptr_t>(data_),
+            .size = size_};
+  }
+
+ private:
+  size_t size_;
+  uint8_t* data_;
+};
+
+// 记录设备一次请求访问的 cache line
+class LineCounter {
+ public:
+  auto Touch(const volatile void* addr, size_t len) -> void {
+    auto begin = reinterpret_cast<uintptr_t>(addr) / 64;
+    auto end = (reinterpret_cast<uintptr_t>(addr) + len - 1) / 64;
+    for (auto line = begin; line <= end; ++line) {
+      lines_.insert(line);
+    }
+  }
+  auto Flush() -> void {
+    total_ += lines_.size();
+    lines_.clear();
+  }
+  [[nodiscard]] auto Total() const -> size_t { return total_; }
+
+ private:
+  std::unordered_set<uintptr_t> lines_;
+  size_t total_{0};
+};
+
+// Packed virtqueue 的设备端模型
+class PackedDevice {
+ public:
+  PackedDevice(const DmaRegion& dma, uint16_t size)
+      : desc_(reinterpret_cast<volatile PackedVirtqueue::Desc*>(dma.Data())),
+        size_(size) {
+    size_t event_off = AlignUp(sizeof(PackedVirtqueue::Desc) * size,
+                               PackedVirtqueue::EventSuppress::kAlign);
+    driver_event_ = reinterpret_cast<volatile PackedVirtqueue::EventSuppress*>(
+        dma.Data() + event_off);
+    device_event_ = driver_event_ + 1;
+  }
+
+  // 下一个位置是否有可用描述符
+  [[nodiscard]] auto HasAvail() const -> bool {
+    uint16_t flags = desc_[next_].flags;
+    return ((flags & kAvail) != 0) == wrap_ && ((flags & kUsed) != 0) != wrap_;
+  }
+
+  // 取出一条链，返回缓冲区 ID、描述符数和可写字节数
+  auto Take(LineCounter* counter = nullptr) -> std::pair<uint16_t, uint16_t> {
+    uint16_t idx = next_;
+    uint16_t num = 0;
+    uint16_t id = 0;
+    while (true) {
+      if (counter != nullptr) {
+        counter->Touch(&desc_[idx], sizeof(PackedVirtqueue::Desc));
+      }
+      uint16_t flags = desc_[idx].flags;
+      id = desc_[idx].id;
+      ++num;
+      if (++idx == size_) {
+        idx = 0;
+        wrap_ = !wrap_;
+      }
+      if ((flags & kNext) == 0) {
+        break;
+      }
+    }
+    next_ = idx;
+    return {id, num};
+  }
+
+  // 在 pos 处写回已用描述符，随后跳过 num 个位置
+  auto Complete(uint16_t id, uint32_t len, uint16_t num,
+                LineCounter* counter = nullptr) -> void {
+    if (counter != nullptr) {
+      counter->Touch(&desc_[used_], sizeof(PackedVirtqueue::Desc));
+    }
+    desc_[used_].id = id;
+    desc_[used_].len = len;
+    desc_[used_].flags = used_wrap_ ? (kAvail | kUsed) : 0;
+    used_ = static_cast<uint16_t>(used_ + num);
+    if (used_ >= size_) {
+      used_ = static_cast<uint16_t>(used_ - size_);
+      used_wrap_ = !used_wrap_;
+    }
+  }
+
+  // 跳过 num 个位置但不写回（VIRTIO_F_IN_ORDER 批量完成）
+  auto Skip(uint16_t num) -> void {
+    used_ = static_cast<uint16_t>(used_ + num);
+    if (used_ >= size_) {
+      used_ = static_cast<uint16_t>(used_ - size_);
+      used_wrap_ = !used_wrap_;
+    }
+  }
+
+  [[nodiscard]] auto DriverEvent() const
+      -> volatile PackedVirtqueue::EventSuppress* {
+    return driver_event_;
+  }
+  [[nodiscard]] auto DeviceEvent() const
+      -> volatile PackedVirtqueue::EventSuppress* {
+    return device_event_;
+  }
+
+ private:
+  volatile PackedVirtqueue::Desc* desc_;
+  volatile PackedVirtqueue::EventSuppress* driver_event_{nullptr};
+  volatile PackedVirtqueue::EventSuppress* device_event_{nullptr};
+  uint16_t size_;
+  uint16_t next_{0};
+  uint16_t used_{0};
+  bool wrap_{true};
+  bool used_wrap_{true};
+};
+
+// Split virtqueue 的设备端模型
+class SplitDevice {
+ public:
+  SplitDevice(const DmaRegion& dma, uint16_t size) : size_(size) {
+    auto* base = dma.Data();
+    desc_ = reinterpret_cast<volatile SplitVirtqueue::Desc*>(base);
+    size_t avail_off = sizeof(SplitVirtqueue::Desc) * size;
+    avail_ = reinterpret_cast<volatile uint16_t*>(base + avail_off);
+    size_t used_off = AlignUp(avail_off + sizeof(uint16_t) * (3 + size), 4);
+    used_ = reinterpret_cast<volatile uint16_t*>(base + used_off);
+  }
+
+  [[nodiscard]] auto HasAvail() const -> bool { return next_ != avail_[1]; }
+
+  auto Take(LineCounter* counter = nullptr) -> std::pair<uint16_t, uint16_t> {
+    if (counter != nullptr) {
+      counter->Touch(&avail_[1], sizeof(uint16_t));
+      counter->Touch(&avail_[2 + next_ % size_], sizeof(uint16_t));
+    }
+    uint16_t head = avail_[2 + next_ % size_];
+    ++next_;
+    uint16_t idx = head;
+    uint16_t num = 1;
+    while (true) {
+      if (counter != nullptr) {
+        counter->Touch(&desc_[idx], sizeof(SplitVirtqueue::Desc));
+      }
+      if ((desc_[idx].flags & kNext) == 0) {
+        break;
+      }
+      idx = desc_[idx].next;
+      ++num;
+    }
+    return {head, num};
+  }
+
+  auto Complete(uint16_t head, uint32_t len, LineCounter* counter = nullptr)
+      -> void {
+    uint16_t used_idx = used_[1];
+    auto* ring =
+        reinterpret_cast<volatile SplitVirtqueue::UsedElem*>(used_ + 2);
+    if (counter != nullptr) {
+      counter->Touch(&ring[used_idx % size_], sizeof(SplitVirtqueue::UsedElem));
+      counter->Touch(&used_[1], sizeof(uint16_t));
+    }
+    ring[used_idx % size_].id = head;
+    ring[used_idx % size_].len = len;
+    used_[1] = static_cast<uint16_t>(used_idx + 1);
+  }
+
+ private:
+  volatile SplitVirtqueue::Desc* desc_;
+  volatile uint16_t* avail_;
+  volatile uint16_t* used_;
+  uint16_t size_;
+  uint16_t next_{0};
+};
+
+// virtio-blk 风格的请求：请求头（只读）+ 数据与状态字节（可写）
+constexpr IoVec kReadable[] = {{0x1000, 16}};
+constexpr IoVec kWritable[] = {{0x2000, 4096}, {0x3000, 1}};
+
+}  // namespace
+
+TEST(PackedVirtqueueTest, CalcSizeCoversRingAndEventAreas) {
+  EXPECT_GE(PackedVirtqueue::CalcSize(128), 128 * 16 + 8);
+  DmaMemory mem(PackedVirtqueue::CalcSize(128));
+  PackedVirtqueue vq(mem.Region(), 128, true);
+  ASSERT_TRUE(vq.IsValid());
+  EXPECT_EQ(vq.Size(), 128);
+  EXPECT_EQ(vq.NumFree(), 128);
+  EXPECT_EQ(vq.DescPhys(), mem.Region().phys);
+  EXPECT_EQ(vq.AvailPhys(), mem.Region().phys + 128 * 16);
+  EXPECT_EQ(vq.UsedPhys(), vq.AvailPhys() + 4);
+}
+
+TEST(PackedVirtqueueTest, RejectsTooSmallRegion) {
+  DmaMemory mem(4096);
+  auto region = mem.Region();
+  region.size = 64;
+  PackedVirtqueue vq(region, 128, true);
+  EXPECT_FALSE(vq.IsValid());
+}
+
+TEST(PackedVirtqueueTest, SubmitChainWritesContiguousDescriptors) {
+  DmaMemory mem(PackedVirtqueue::CalcSize(8));
+  PackedVirtqueue vq(mem.Region(), 8, true);
+  auto id = vq.SubmitChain(kReadable, 1, kWritable, 2);
+  ASSERT_TRUE(id.has_value());
+  EXPECT_EQ(vq.NumFree(), 5);
+
+  auto* desc = reinterpret_cast<PackedVirtqueue::Desc*>(mem.Region().Data());
+  EXPECT_EQ(desc[0].addr, 0x1000u);
+  EXPECT_EQ(desc[0].flags, kAvail | kNext);
+  EXPECT_EQ(desc[1].flags, kAvail | kNext | kWrite);
+  EXPECT_EQ(desc[2].flags, kAvail | kWrite);
+  EXPECT_EQ(desc[2].id, *id);
+  EXPECT_FALSE(vq.HasUsed());
+
+  PackedDevice dev(mem.Region(), 8);
+  ASSERT_TRUE(dev.HasAvail());
+  auto [dev_id, num] = dev.Take();
+  EXPECT_EQ(dev_id, *id);
+  EXPECT_EQ(num, 3);
+  dev.Complete(dev_id, 4097, num);
+
+  ASSERT_TRUE(vq.HasUsed());
+  auto elem = vq.PopUsed();
+  ASSERT_TRUE(elem.has_value());
+  EXPECT_EQ(elem->id, *id);
+  EXPECT_EQ(elem->len, 4097u);
+  EXPECT_TRUE(vq.FreeChain(*id).has_value());
+  EXPECT_EQ(vq.NumFree(), 8);
+  EXPECT_FALSE(vq.HasUsed());
+}
+
+TEST(PackedVirtqueueTest, WrapCountersToggleAcrossRing) {
+  DmaMemory mem(PackedVirtqueue::CalcSize(8));
+  PackedVirtqueue vq(mem.Region(), 8, true);
+  PackedDevice dev(mem.Region(), 8);
+  auto* desc = reinterpret_cast<PackedVirtqueue::Desc*>(mem.Region().Data());
+
+  // 3 个描述符的链在 8 项的环上反复回绕
+  for (int round = 0; round < 20; ++round) {
+    auto id = vq.SubmitChain(kReadable, 1, kWritable, 2);
+    ASSERT_TRUE(id.has_value()) << round;
+    auto [dev_id, num] = dev.Take();
+    ASSERT_EQ(dev_id, *id);
+    dev.Complete(dev_id, static_cast<uint32_t>(round), num);
+    auto elem = vq.PopUsed();
+    ASSERT_TRUE(elem.has_value()) << round;
+    EXPECT_EQ(elem->id, *id);
+    EXPECT_EQ(elem->len, static_cast<uint32_t>(round));
+    ASSERT_TRUE(vq.FreeChain(elem->id).has_value());
+  }
+  EXPECT_EQ(vq.NumFree(), 8);
+
+  // 60 个描述符之后驱动处于第 8 圈，回绕计数器为 0：可用描述符 USED=1
+  auto id = vq.SubmitChain(kReadable, 1, nullptr, 0);
+  ASSERT_TRUE(id.has_value());
+  EXPECT_EQ(desc[60 % 8].flags, kUsed);
+}
+
+TEST(PackedVirtqueueTest, OutOfOrderCompletion) {
+  DmaMemory mem(PackedVirtqueue::CalcSize(16));
+  PackedVirtqueue vq(mem.Region(), 16, true);
+  PackedDevice dev(mem.Region(), 16);
+
+  auto first = vq.SubmitChain(kReadable, 1, kWritable, 2);
+  auto second = vq.SubmitChain(kReadable, 1, kWritable, 1);
+  ASSERT_TRUE(first.has_value() && second.has_value());
+  EXPECT_NE(*first, *second);
+  auto [id0, num0] = dev.Take();
+  auto [id1, num1] = dev.Take();
+
+  dev.Complete(id1, 1, num1);
+  dev.Complete(id0, 2, num0);
+
+  auto elem = vq.PopUsed();
+  ASSERT_TRUE(elem.has_value());
+  EXPECT_EQ(elem->id, *second);
+  ASSERT_TRUE(vq.FreeChain(elem->id).has_value());
+  elem = vq.PopUsed();
+  ASSERT_TRUE(elem.has_value());
+  EXPECT_EQ(elem->id, *first);
+  ASSERT_TRUE(vq.FreeChain(elem->id).has_value());
+  EXPECT_FALSE(vq.HasUsed());
+  EXPECT_EQ(vq.NumFree(), 16);
+}
+
+TEST(PackedVirtqueueTest, InOrderBatchReturnsEveryBuffer) {
+  DmaMemory mem(PackedVirtqueue::CalcSize(16));
+  PackedVirtqueue vq(mem.Region(), 16, true, true);
+  PackedDevice dev(mem.Region(), 16);
+
+  std::vector<uint16_t> ids;
+  for (int i = 0; i < 3; ++i) {
+    auto id = vq.SubmitChain(kReadable, 1, kWritable, 2);
+    ASSERT_TRUE(id.has_value());
+    ids.push_back(*id);
+  }
+  uint16_t total = 0;
+  uint16_t last = 0;
+  for (int i = 0; i < 3; ++i) {
+    auto [id, num] = dev.Take();
+    total = static_cast<uint16_t>(total + num);
+    last = id;
+  }
+  // 设备只为整批写回一个已用描述符
+  dev.Complete(last, 512, total);
+
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(vq.HasUsed());
+    auto elem = vq.PopUsed();
+    ASSERT_TRUE(elem.has_value());
+    EXPECT_EQ(elem->id, ids[i]);
+    EXPECT_EQ(elem->len, i == 2 ? 512u : 0u);
+    ASSERT_TRUE(vq.FreeChain(elem->id).has_value());
+  }
+  EXPECT_FALSE(vq.HasUsed());
+
+  // 批次之后继续单个完成
+  auto id = vq.SubmitChain(kReadable, 1, nullptr, 0);
+  ASSERT_TRUE(id.has_value());
+  auto [dev_id, num] = dev.Take();
+  dev.Complete(dev_id, 0, num);
+  auto elem = vq.PopUsed();
+  ASSERT_TRUE(elem.has_value());
+  EXPECT_EQ(elem->id, *id);
+}
+
+TEST(PackedVirtqueueTest, KickPrepareFollowsDeviceEventSuppression) {
+  DmaMemory mem(PackedVirtqueue::CalcSize(8));
+  PackedVirtqueue vq(mem.Region(), 8, true);
+  PackedDevice dev(mem.Region(), 8);
+  auto* event = dev.DeviceEvent();
+  using Flags = PackedVirtqueue::EventFlags;
+
+  ASSERT_TRUE(vq.SubmitChain(kReadable, 1, nullptr, 0).has_value());
+  EXPECT_TRUE(vq.KickPrepare());
+
+  event->flags = std::to_underlying(Flags::kDisable);
+  ASSERT_TRUE(vq.SubmitChain(kReadable, 1, nullptr, 0).has_value());
+  EXPECT_FALSE(vq.KickPrepare());
+
+  // 设备要求处理到位置 3 时才通知：提交位置 2 不通知，位置 3 通知
+  event->off_wrap = 0x8000 | 3;
+  event->flags = std::to_underlying(Flags::kDesc);
+  ASSERT_TRUE(vq.SubmitChain(kReadable, 1, nullptr, 0).has_value());
+  EXPECT_FALSE(vq.KickPrepare());
+  ASSERT_TRUE(vq.SubmitChain(kReadable, 1, nullptr, 0).has_value());
+  EXPECT_TRUE(vq.KickPrepare());
+}
+
+TEST(PackedVirtqueueTest, SetUsedNotifyWritesDriverEvent) {
+  DmaMemory mem(PackedVirtqueue::CalcSize(8));
+  PackedDevice dev(mem.Region(), 8);
+  auto* event = dev.DriverEvent();
+  using Flags = PackedVirtqueue::EventFlags;
+
+  PackedVirtqueue vq(mem.Region(), 8, true);
+  vq.SetUsedNotify(false);
+  EXPECT_EQ(static_cast<uint16_t>(event->flags),
+            std::to_underlying(Flags::kDisable));
+  vq.SetUsedNotify(true);
+  EXPECT_EQ(static_cast<uint16_t>(event->flags),
+            std::to_underlying(Flags::kDesc));
+  EXPECT_EQ(static_cast<uint16_t>(event->off_wrap), 0x8000);
+
+  PackedVirtqueue plain(mem.Region(), 8, false);
+  plain.SetUsedNotify(true);
+  EXPECT_EQ(static_cast<uint16_t>(event->flags),
+            std::to_underlying(Flags::kEnable));
+}
+
+TEST(SplitVirtqueueTest, KickPrepareFollowsAvailEvent) {
+  DmaMemory mem(SplitVirtqueue::CalcSize(8));
+  SplitVirtqueue vq(mem.Region(), 8, true);
+  ASSERT_TRUE(vq.IsValid());
+
+  // avail_event = 0：第一次提交越过 0，需要通知
+  ASSERT_TRUE(vq.SubmitChain(kReadable, 1, nullptr, 0).has_value());
+  EXPECT_TRUE(vq.KickPrepare());
+  ASSERT_TRUE(vq.SubmitChain(kReadable, 1, nullptr, 0).has_value());
+  EXPECT_FALSE(vq.KickPrepare());
+  *vq.UsedAvailEvent() = 2;
+  ASSERT_TRUE(vq.SubmitChain(kReadable, 1, nullptr, 0).has_value());
+  EXPECT_TRUE(vq.KickPrepare());
+}
+
+TEST(SplitVirtqueueTest, SetUsedNotifyMovesUsedEvent) {
+  DmaMemory mem(SplitVirtqueue::CalcSize(8));
+  SplitVirtqueue vq(mem.Region(), 8, true);
+  vq.SetUsedNotify(false);
+  EXPECT_EQ(*vq.AvailUsedEvent(), 0x8000);
+  vq.SetUsedNotify(true);
+  EXPECT_EQ(*vq.AvailUsedEvent(), 0);
+}
+
+// 两种布局在相同请求模式下的对比：设备每个请求访问的 cache line 数与
+// 驱动+设备模型的往返耗时
+TEST(PackedVirtqueueTest, BenchmarkAgainstSplit) {
+  constexpr uint16_t kQueueSize = 128;
+  constexpr int kBatch = 16;
+  constexpr int kRounds = 20000;
+  constexpr size_t kRequests = static_cast<size_t>(kBatch) * kRounds;
+
+  auto run = [&](auto& vq, auto& dev, LineCounter* counter) {
+    std::vector<uint16_t> ids(kBatch);
+    for (int round = 0; round < kRounds; ++round) {
+      for (int i = 0; i < kBatch; ++i) {
+        auto id = vq.SubmitChain(kReadable, 1, kWritable, 2);
+        ASSERT_TRUE(id.has_value());
+      }
+      (void)vq.KickPrepare();
+      for (int i = 0; i < kBatch; ++i) {
+        ASSERT_TRUE(dev.HasAvail());
+        auto [id, num] = dev.Take(counter);
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(dev)>,
+                                     PackedDevice>) {
+          dev.Complete(id, 4097, num, counter);
+        } else {
+          dev.Complete(id, 4097, counter);
+        }
+        if (counter != nullptr) {
+          counter->Flush();
+        }
+      }
+      int reaped = 0;
+      while (vq.HasUsed()) {
+        auto elem = vq.PopUsed();
+        ASSERT_TRUE(elem.has_value());
+        ASSERT_TRUE(vq.FreeChain(static_cast<uint16_t>(elem->id)).has_value());
+        ++reaped;
+      }
+      ASSERT_EQ(reaped, kBatch);
+      vq.SetUsedNotify(true);
+    }
+  };
+
+  DmaMemory split_mem(SplitVirtqueue::CalcSize(kQueueSize));
+  DmaMemory packed_mem(PackedVirtqueue::CalcSize(kQueueSize));
+
+  LineCounter split_lines;
+  LineCounter packed_lines;
+  {
+    SplitVirtqueue vq(split_mem.Region(), kQueueSize, true);
+    SplitDevice dev(split_mem.Region(), kQueueSize);
+    run(vq, dev, &split_lines);
+  }
+  {
+    PackedVirtqueue vq(packed_mem.Region(), kQueueSize, true);
+    PackedDevice dev(packed_mem.Region(), kQueueSize);
+    run(vq, dev, &packed_lines);
+  }
+
+  DmaMemory split_mem2(SplitVirtqueue::CalcSize(kQueueSize));
+  DmaMemory packed_mem2(PackedVirtqueue::CalcSize(kQueueSize));
+  SplitVirtqueue split_vq(split_mem2.Region(), kQueueSize, true);
+  SplitDevice split_dev(split_mem2.Region(), kQueueSize);
+  PackedVirtqueue packed_vq(packed_mem2.Region(), kQueueSize, true);
+  PackedDevice packed_dev(packed_mem2.Region(), kQueueSize);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  run(split_vq, split_dev, nullptr);
+  auto mid = std::chrono::high_resolution_clock::now();
+  run(packed_vq, packed_dev, nullptr);
+  auto end = std::chrono::high_resolution_clock::now();
+  auto split_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(mid - start);
+  auto packed_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - mid);
+
+  std::cout << std::format(
+      "Virtqueue round trip ({} requests, batch {}): split {} ns/req, "
+      "{:.2f} lines/req; packed {} ns/req, {:.2f} lines/req\n",
+      kRequests, kBatch, split_ns.count() / kRequests,
+      static_cast<double>(split_lines.Total()) / kRequests,
+      packed_ns.count() / kRequests,
+      static_cast<double>(packed_lines.Total()) / kRequests);
+
+  // 耗时受宿主机负载影响，只断言确定性的 cache line 数
+  EXPECT_LT(packed_lines.Total(), split_lines.Total());
+}
+
+TEST(SplitVirtqueueTest, SubmitIndirectUsesOneRingDescriptor) {
+  DmaMemory mem(SplitVirtqueue::CalcSize(8));
+  DmaMemory table_mem(sizeof(SplitVirtqueue::Desc) * 8);
+  SplitVirtqueue vq(mem.Region(), 8, true);
+  SplitDevice dev(mem.Region(), 8);
+  auto table = table_mem.Region();
+
+  auto head = vq.SubmitIndirect(kReadable, 1, kWritable, 2, table);
+  ASSERT_TRUE(head.has_value());
+  EXPECT_EQ(vq.NumFree(), 7);
+
+  auto* desc = reinterpret_cast<SplitVirtqueue::Desc*>(mem.Region().Data());
+  EXPECT_EQ(desc[*head].addr, table.phys);
+  EXPECT_EQ(desc[*head].len, 3 * sizeof(SplitVirtqueue::Desc));
+  EXPECT_EQ(desc[*head].flags,
+            std::to_underlying(SplitVirtqueue::DescFlags::kDescFIndirect));
+
+  auto* entries = reinterpret_cast<SplitVirtqueue::Desc*>(table.Data());
+  EXPECT_EQ(entries[0].addr, 0x1000u);
+  EXPECT_EQ(entries[0].flags, kNext);
+  EXPECT_EQ(entries[0].next, 1);
+  EXPECT_EQ(entries[1].flags, kNext | kWrite);
+  EXPECT_EQ(entries[1].next, 2);
+  EXPECT_EQ(entries[2].addr, 0x3000u);
+  EXPECT_EQ(entries[2].flags, kWrite);
+
+  ASSERT_TRUE(dev.HasAvail());
+  auto [dev_head, num] = dev.Take();
+  EXPECT_EQ(dev_head, *head);
+  EXPECT_EQ(num, 1);
+  dev.Complete(dev_head, 4097);
+  auto elem = vq.PopUsed();
+  ASSERT_TRUE(elem.has_value());
+  ASSERT_TRUE(vq.FreeChain(static_cast<uint16_t>(elem->id)).has_value());
+  EXPECT_EQ(vq.NumFree(), 8);
+
+  // 表放不下时拒绝提交
+  table.size = sizeof(SplitVirtqueue::Desc) * 2;
+  EXPECT_FALSE(vq.SubmitIndirect(kReadable, 1, kWritable, 2, table));
+  EXPECT_EQ(vq.NumFree(), 8);
+}
+
+TEST(PackedVirtqueueTest, SubmitIndirectUsesOneRingDescriptor) {
+  DmaMemory mem(PackedVirtqueue::CalcSize(4));
+  DmaMemory table_mem(sizeof(PackedVirtqueue::Desc) * 8 * 4);
+  PackedVirtqueue vq(mem.Region(), 4, true);
+  PackedDevice dev(mem.Region(), 4);
+  auto* desc = reinterpret_cast<PackedVirtqueue::Desc*>(mem.Region().Data());
+  constexpr uint16_t kIndirect =
+      std::to_underlying(PackedFlags::kDescFIndirect);
+
+  // 4 项的环上同时提交 4 个各含 3 个缓冲区的请求
+  std::vector<uint16_t> ids;
+  for (size_t i = 0; i < 4; ++i) {
+    auto table = table_mem.Region().SubRegion(
+        i * sizeof(PackedVirtqueue::Desc) * 8,
+        sizeof(PackedVirtqueue::Desc) * 8);
+    ASSERT_TRUE(table.has_value());
+    auto id = vq.SubmitIndirect(kReadable, 1, kWritable, 2, *table);
+    ASSERT_TRUE(id.has_value());
+    ids.push_back(*id);
+    EXPECT_EQ(desc[i].addr, table->phys);
+    EXPECT_EQ(desc[i].len, 3 * sizeof(PackedVirtqueue::Desc));
+    EXPECT_EQ(desc[i].flags, kAvail | kIndirect);
+
+    auto* entries = reinterpret_cast<PackedVirtqueue::Desc*>(table->Data());
+    EXPECT_EQ(entries[0].flags, 0);
+    EXPECT_EQ(entries[1].flags, kWrite);
+    EXPECT_EQ(entries[2].addr, 0x3000u);
+    EXPECT_EQ(entries[2].flags, kWrite);
+  }
+  EXPECT_EQ(vq.NumFree(), 0);
+
+  for (auto id : ids) {
+    auto [dev_id, num] = dev.Take();
+    EXPECT_EQ(dev_id, id);
+    EXPECT_EQ(num, 1);
+    dev.Complete(dev_id, 1, num);
+  }
+  for (auto id : ids) {
+    auto elem = vq.PopUsed();
+    ASSERT_TRUE(elem.has_value());
+    EXPECT_EQ(elem->id, id);
+    ASSERT_TRUE(vq.FreeChain(id).has_value());
+  }
+  EXPECT_EQ(vq.NumFree(), 4);
+}
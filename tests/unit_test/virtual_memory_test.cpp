@@ -204,6 +204,52 @@ TEST_F(VirtualMemoryTest, MapMultiplePages) {
   }
 }
 
+TEST_F(VirtualMemoryTest, IsUserAccessible) {
+  VirtualMemory vm;
+
+  auto* page_dir = aligned_alloc(cpu_io::virtual_memory::kPageSize,
+                                 cpu_io::virtual_memory::kPageSize);
+  ASSERT_NE(page_dir, nullptr);
+  std::memset(page_dir, 0, cpu_io::virtual_memory::kPageSize);
+
+  constexpr uintptr_t kBase = 0x10000;
+  constexpr auto kPage = cpu_io::virtual_memory::kPageSize;
+  // 用户只读页、用户可写页、内核页各一页，之后一页未映射
+  ASSERT_TRUE(vm.MapPage(page_dir, reinterpret_cast<void*>(kBase),
+                         reinterpret_cast<void*>(0x80000000),
+                         cpu_io::virtual_memory::GetUserPagePermissions(
+                             true, false, false))
+                  .has_value());
+  ASSERT_TRUE(vm.MapPage(page_dir, reinterpret_cast<void*>(kBase + kPage),
+                         reinterpret_cast<void*>(0x80001000),
+                         cpu_io::virtual_memory::GetUserPagePermissions(
+                             true, true, false))
+                  .has_value());
+  ASSERT_TRUE(vm.MapPage(page_dir, reinterpret_cast<void*>(kBase + 2 * kPage),
+                         reinterpret_cast<void*>(0x80002000),
+                         cpu_io::virtual_memory::GetKernelPagePermissions(
+                             true, true, false))
+                  .has_value());
+
+  auto* base = reinterpret_cast<void*>(kBase);
+  auto* writable = reinterpret_cast<void*>(kBase + kPage);
+  EXPECT_TRUE(vm.IsUserAccessible(page_dir, base, 2 * kPage, false));
+  EXPECT_FALSE(vm.IsUserAccessible(page_dir, base, 2 * kPage, true));
+  EXPECT_TRUE(vm.IsUserAccessible(page_dir, writable, kPage, true));
+  // 跨入内核页或未映射页
+  EXPECT_FALSE(vm.IsUserAccessible(page_dir, writable, kPage + 1, false));
+  EXPECT_FALSE(vm.IsUserAccessible(
+      page_dir, reinterpret_cast<void*>(kBase + 3 * kPage), 1, false));
+  // 不跨页的小范围只检查所在页
+  EXPECT_TRUE(vm.IsUserAccessible(
+      page_dir, reinterpret_cast<void*>(kBase + kPage - 8), 16, false));
+  EXPECT_TRUE(vm.IsUserAccessible(page_dir, base, 0, true));
+  // 回绕
+  EXPECT_FALSE(vm.IsUserAccessible(page_dir, writable, SIZE_MAX, false));
+
+  vm.DestroyPageDirectory(page_dir, false);
+}
+
 TEST_F(VirtualMemoryTest, RemapPage) {
   VirtualMemory vm;
 